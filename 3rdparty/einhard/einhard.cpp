@@ -206,6 +206,17 @@ void UnconditionalOutput::checkColorReset()
 	}
 }
 
+namespace
+{
+	// The installed output hook, or nullptr for direct writes.
+	OutputHook outputHook = nullptr;
+}
+
+void setOutputHook( OutputHook hook )
+{
+	outputHook = hook;
+}
+
 void UnconditionalOutput::doCleanup(std::FILE *outfile) noexcept
 {
 	*out << '\n';
@@ -223,6 +234,11 @@ void UnconditionalOutput::doCleanup(std::FILE *outfile) noexcept
 		start = pos;
 	}
 	s2.append( s, start, pos - start );
+	if( outputHook != nullptr )
+	{
+		outputHook( s2.c_str(), s2.size(), outfile );
+		return;
+	}
 	std::fwrite( s2.c_str(), s2.size(), 1, outfile );
 	std::fflush( outfile );  // FIXME: don't want to flush too often, what's the right logic here?
 }
@@ -134,6 +134,19 @@ namespace einhard
 	 */
 	LogLevel getLogLevel( const std::string &level );
 
+	/**
+	 * Type of a hook that receives the fully formatted log records instead
+	 * of the default fwrite/fflush to the output file. The hook is invoked
+	 * on the thread that produced the record and must not throw.
+	 */
+	using OutputHook = void ( * )( const char *data, std::size_t size, std::FILE *outfile );
+
+	/**
+	 * Install \p hook for all output of all loggers; a nullptr restores the
+	 * default direct writes. Not thread safe; install before logging starts.
+	 */
+	void setOutputHook( OutputHook hook );
+
 	template <LogLevel> const char *colorForLogLevel() noexcept;
 
 	/**
@@ -0,0 +1,98 @@
+#!/bin/bash
+
+fail() {
+  echo "$*" >&2
+  exit 1
+}
+
+if [[ "$#" -ne 1 ]]; then
+    echo "Executing the SMASH performance regression matrix"
+    echo "-------------------------------------------------"
+    echo "Note: Prepare the build directory yourself. "
+    echo "Clean it and compile the SMASH version you"
+    echo "want to benchmark."
+    echo
+    echo "All workloads run with pinned random seeds, so two runs"
+    echo "of the same code do the same work and differences in the"
+    echo "results come from the code, not from the sampled events."
+    echo
+    echo "Usage: $0 PREPARED_BUILD_DIR"
+    exit 1
+fi
+
+type /usr/bin/time >/dev/null 2>&1 || fail "Failed to find /usr/bin/time (needed for wall time and RSS)."
+type uname         >/dev/null 2>&1 || fail "Failed to find uname."
+
+BUILD_DIR=$1
+SCRIPTPATH="$( cd "$(dirname "$0")" ; pwd )"
+SMASH_ROOT="${SCRIPTPATH}/../.."
+CONFIGS_DIR="${SCRIPTPATH}/configs"
+N_RUNS=3
+
+cd $BUILD_DIR
+
+SMASH_VER_NUM=$(./smash -v | grep -E 'SMASH-')
+RESULTS_FILE=${SCRIPTPATH}/regression-results-${SMASH_VER_NUM}.csv
+
+echo "Running regression matrix for ${SMASH_VER_NUM} ..."
+
+# CSV header; one line per run so that fluctuations stay visible.
+echo "# ${SMASH_VER_NUM} on $(uname -a)" > ${RESULTS_FILE}
+echo "workload,run,wall_seconds,max_rss_kb,events_per_hour" >> ${RESULTS_FILE}
+
+# Run one workload N_RUNS times and append the measurements to the CSV.
+#
+# Arguments: workload name, number of events in the config, config
+# directory below configs/, decaymodes directory, particles directory and
+# optionally an extra '-c' config override.
+regression_run() {
+  NAME=$1
+  NEVENTS=$2
+  YAML_DIR=$3
+  DECAYM_DIR=$4
+  PART_DIR=$5
+  CONFIG_OPT=$6
+  echo "   Started workload ${NAME} ..."
+  for RUN in $(seq 1 ${N_RUNS}); do
+    OUT_DIR=$(mktemp -d)
+    TIME_FILE=$(mktemp)
+    if [ -n "$CONFIG_OPT" ]
+    then
+      /usr/bin/time -f '%e %M' -o ${TIME_FILE} \
+        ./smash \
+        -i ${CONFIGS_DIR}/${YAML_DIR}/config.yaml \
+        -d ${CONFIGS_DIR}/${DECAYM_DIR}/decaymodes.txt \
+        -p ${CONFIGS_DIR}/${PART_DIR}/particles.txt \
+        -c "$CONFIG_OPT" \
+        -o ${OUT_DIR} -f \
+        > /dev/null 2>&1 || fail "Workload ${NAME} failed."
+    else
+      /usr/bin/time -f '%e %M' -o ${TIME_FILE} \
+        ./smash \
+        -i ${CONFIGS_DIR}/${YAML_DIR}/config.yaml \
+        -d ${CONFIGS_DIR}/${DECAYM_DIR}/decaymodes.txt \
+        -p ${CONFIGS_DIR}/${PART_DIR}/particles.txt \
+        -o ${OUT_DIR} -f \
+        > /dev/null 2>&1 || fail "Workload ${NAME} failed."
+    fi
+    WALL=$(awk '{print $1}' ${TIME_FILE})
+    RSS=$(awk '{print $2}' ${TIME_FILE})
+    EVENTS_PER_HOUR=$(awk -v n=${NEVENTS} -v t=${WALL} \
+                      'BEGIN { printf "%.1f", 3600.0 * n / t }')
+    echo "${NAME},${RUN},${WALL},${RSS},${EVENTS_PER_HOUR}" >> ${RESULTS_FILE}
+    echo "      run ${RUN}: ${WALL} s, ${RSS} kB RSS, ${EVENTS_PER_HOUR} events/h"
+    rm -rf ${OUT_DIR} ${TIME_FILE}
+  done
+}
+
+# Defaults
+PART_DEF="."
+DECAYM_DEF="."
+
+regression_run auau_7.7_cascade 5 regression/auau_7.7 $DECAYM_DEF $PART_DEF
+regression_run box_potentials 2 regression/box_potentials box box
+regression_run pp_strings 500 regression/pp_strings $DECAYM_DEF $PART_DEF
+regression_run afterburner 10 regression/afterburner $DECAYM_DEF $PART_DEF \
+  "Modi: { List: { File_Directory: \"${SMASH_ROOT}/input/list\" } }"
+
+echo "Done. Results written to ${RESULTS_FILE}"
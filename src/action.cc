@@ -11,18 +11,28 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <cstddef>
+#include <memory>
 #include <sstream>
 
 #include "smash/angles.h"
 #include "smash/constants.h"
 #include "smash/kinematics.h"
 #include "smash/logging.h"
+#include "smash/memorypool.h"
 #include "smash/pauliblocking.h"
 #include "smash/potential_globals.h"
 #include "smash/processbranch.h"
 #include "smash/quantumnumbers.h"
 
 namespace smash {
+
+void *Action::operator new(std::size_t size) {
+  return memory_pool::allocate(size);
+}
+
+void Action::operator delete(void *ptr) { memory_pool::deallocate(ptr); }
+
 /// Destructor
 Action::~Action() = default;
 
@@ -32,6 +42,14 @@ bool Action::is_valid(const Particles &particles) const {
       [&particles](const ParticleData &p) { return particles.is_valid(p); });
 }
 
+void Action::prefetch_incoming(const Particles &particles) const {
+  for (const ParticleData &p : incoming_particles_) {
+    particles.prefetch(p);
+    // ParticleType overloads operator&, so get the plain address explicitly
+    SMASH_PREFETCH(std::addressof(p.type()));
+  }
+}
+
 bool Action::is_pauli_blocked(const Particles &particles,
                               const PauliBlocker &p_bl) const {
   // Wall-crossing actions should never be blocked: currently
@@ -65,6 +83,16 @@ void Action::update_incoming(const Particles &particles) {
   }
 }
 
+void Action::propagate_incoming_to_execution_time() {
+  for (ParticleData &p : incoming_particles_) {
+    const double dt = time_of_execution_ - p.position().x0();
+    assert(dt >= 0.);
+    FourVector position = p.position() + FourVector(0.0, p.velocity() * dt);
+    position.set_x0(time_of_execution_);
+    p.set_4position(position);
+  }
+}
+
 FourVector Action::get_interaction_point() const {
   // Estimate for the interaction point in the calculational frame
   FourVector interaction_point = FourVector(0., 0., 0., 0.);
@@ -95,11 +123,23 @@ void Action::perform(Particles *particles, uint32_t id_process) {
   assert(id_process != 0);
   const auto &log = logger<LogArea::Action>();
 
-  for (ParticleData &p : outgoing_particles_) {
-    // store the history info
-    if (process_type_ != ProcessType::Wall) {
-      p.set_history(p.get_history().collisions_per_particle + 1, id_process,
-                    process_type_, time_of_execution_, incoming_particles_);
+  /* The outgoing particles stay in the ensemble of the incoming ones; the
+   * collision finder never pairs particles of different ensembles, so the
+   * first incoming particle speaks for all of them. */
+  const int ensemble = incoming_particles_[0].ensemble();
+  if (ensemble != 0) {
+    for (ParticleData &p : outgoing_particles_) {
+      p.set_ensemble(ensemble);
+    }
+  }
+
+  if (ParticleData::history_enabled_) {
+    for (ParticleData &p : outgoing_particles_) {
+      // store the history info
+      if (process_type_ != ProcessType::Wall) {
+        p.set_history(p.get_history().collisions_per_particle + 1, id_process,
+                      process_type_, time_of_execution_, incoming_particles_);
+      }
     }
   }
 
@@ -194,11 +234,12 @@ void Action::sample_angles(std::pair<double, double> masses,
              " m_b: ", masses.second);
   }
   /* Here we assume an isotropic angular distribution. */
-  Angles phitheta;
-  phitheta.distribute_isotropically();
+  const ThreeVector dir = random::isotropic_unit_vector();
 
-  p_a->set_4momentum(masses.first, phitheta.threevec() * pcm);
-  p_b->set_4momentum(masses.second, -phitheta.threevec() * pcm);
+  const auto momenta =
+      two_body_momenta(kinetic_energy_cm, masses.first, dir * pcm);
+  p_a->set_4momentum(momenta.first);
+  p_b->set_4momentum(momenta.second);
   /* Debug message is printed before boost, so that p_a and p_b are
    * the momenta in the center of mass frame and thus opposite to
    * each other.*/
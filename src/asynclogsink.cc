@@ -0,0 +1,217 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/asynclogsink.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <einhard.hpp>
+
+namespace smash {
+
+namespace {
+
+/// One formatted record waiting to be written.
+struct LogRecord {
+  /// The bytes to write; in structured mode one JSON line.
+  std::string text;
+  /// The destination the record was logged to (stdout or stderr).
+  std::FILE *stream;
+};
+
+/**
+ * Maximum number of queued records. Beyond this the flusher is considered
+ * overloaded and further records are dropped (and counted) instead of
+ * blocking the producer.
+ */
+constexpr std::size_t max_queued_records = 8192;
+
+/// Protects queue and running.
+std::mutex mutex;
+/// Signals the flusher that records arrived or shutdown was requested.
+std::condition_variable condition;
+/// The queued records, oldest first.
+std::deque<LogRecord> queue;
+/// Whether the flusher thread runs; cleared to make it exit.
+bool running = false;
+/// The flusher thread; joined in shutdown.
+std::thread flusher;
+/// Whether records are written as JSON lines.
+bool structured_mode = false;
+/// Number of records dropped because the queue was full.
+std::atomic<uint64_t> dropped_records{0};
+/// The run id reported in structured records.
+std::atomic<int64_t> current_run_id{-1};
+/// The event number reported in structured records.
+std::atomic<int> current_event{-1};
+
+/**
+ * Escape \p text for use inside a JSON string literal.
+ *
+ * \param[in] text The raw record text.
+ * \return the escaped text.
+ */
+std::string escape_json(const std::string &text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (const char c : text) {
+    switch (c) {
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      case '\t':
+        escaped += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x",
+                        static_cast<unsigned>(c));
+          escaped += buffer;
+        } else {
+          escaped += c;
+        }
+    }
+  }
+  return escaped;
+}
+
+/**
+ * Write one record to its destination.
+ *
+ * \param[in] record The record to write.
+ */
+void write_record(const LogRecord &record) {
+  std::fwrite(record.text.c_str(), record.text.size(), 1, record.stream);
+  std::fflush(record.stream);
+}
+
+/// The loop run by the flusher thread.
+void flush_loop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (running || !queue.empty()) {
+    if (queue.empty()) {
+      condition.wait(lock);
+      continue;
+    }
+    LogRecord record = std::move(queue.front());
+    queue.pop_front();
+    /* The slow part happens without the lock, so producers stay free to
+     * enqueue (or to drop) while the flusher waits for the file system. */
+    lock.unlock();
+    write_record(record);
+    lock.lock();
+  }
+}
+
+/**
+ * The hook installed into einhard: formats the final record and enqueues
+ * it, dropping when the queue is full. Runs on the producing thread and
+ * never blocks on I/O.
+ *
+ * \param[in] data The formatted record text.
+ * \param[in] size Number of bytes of the record.
+ * \param[in] stream The destination the record was logged to.
+ */
+void enqueue_record(const char *data, std::size_t size, std::FILE *stream) {
+  std::string text;
+  if (structured_mode) {
+    /* The trailing newline of the plain record becomes the line separator
+     * of the JSON-lines stream. */
+    std::string message(data, size);
+    while (!message.empty() && message.back() == '\n') {
+      message.pop_back();
+    }
+    text = "{\"run\":" + std::to_string(current_run_id.load()) +
+           ",\"event\":" + std::to_string(current_event.load()) +
+           ",\"msg\":\"" + escape_json(message) + "\"}\n";
+  } else {
+    text.assign(data, size);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running) {
+      /* Between hook removal and thread teardown: write directly. */
+      write_record(LogRecord{std::move(text), stream});
+      return;
+    }
+    if (queue.size() >= max_queued_records) {
+      dropped_records.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    queue.push_back(LogRecord{std::move(text), stream});
+  }
+  condition.notify_one();
+}
+
+}  // unnamed namespace
+
+void AsyncLogSink::install(bool structured) {
+  structured_mode = structured;
+  running = true;
+  flusher = std::thread(flush_loop);
+  einhard::setOutputHook(enqueue_record);
+}
+
+void AsyncLogSink::shutdown() {
+  if (!flusher.joinable()) {
+    return;
+  }
+  einhard::setOutputHook(nullptr);
+  const uint64_t lost = dropped_records.load();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (lost > 0) {
+      const std::string report =
+          structured_mode
+              ? "{\"run\":" + std::to_string(current_run_id.load()) +
+                    ",\"event\":" + std::to_string(current_event.load()) +
+                    ",\"dropped\":" + std::to_string(lost) + "}\n"
+              : "Async log sink dropped " + std::to_string(lost) +
+                    " records under overload.\n";
+      queue.push_back(LogRecord{report, stderr});
+    }
+    running = false;
+  }
+  condition.notify_one();
+  flusher.join();
+}
+
+void AsyncLogSink::drop_after_fork() {
+  if (!flusher.joinable()) {
+    return;
+  }
+  einhard::setOutputHook(nullptr);
+  /* The flusher thread only exists in the parent; abandon the thread
+   * handle and the inherited queue without touching either. */
+  flusher.detach();
+  running = false;
+  queue.clear();
+}
+
+void AsyncLogSink::set_run_id(int64_t run_id) { current_run_id = run_id; }
+
+void AsyncLogSink::set_event(int event) { current_event = event; }
+
+uint64_t AsyncLogSink::dropped() { return dropped_records.load(); }
+
+}  // namespace smash
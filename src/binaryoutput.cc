@@ -9,6 +9,10 @@
 
 #include "smash/binaryoutput.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
 #include <string>
 
 #include <boost/filesystem.hpp>
@@ -17,6 +21,7 @@
 #include "smash/clock.h"
 #include "smash/config.h"
 #include "smash/particles.h"
+#include "smash/pdgcode_constants.h"
 
 namespace smash {
 
@@ -34,6 +39,12 @@ namespace smash {
  * specification is stricter. The types used for the output are 4 bytes signed
  * integers, 8 bytes doubles and 1 byte chars.
  *
+ * The binary output can optionally be streamed through a gzip compressor
+ * by requesting the "Binary_Compressed" format (requires SMASH to be built
+ * with zlib support). The files then carry the additional extension ".gz",
+ * can be unpacked with standard tools and contain the identical block
+ * structure with the format version bumped to 7.
+ *
  * As for OSCAR ASCII output there are two kinds of binary output:
  * particles and collisions.
  * The specifics for both particles and collisions output are the following:\n
@@ -111,15 +122,75 @@ namespace smash {
  * \ref output_content_specific_options_ "content-specific output options".
  *
  * See also \ref collisions_output_in_box_modus_.
+ *
+ * Compact photons output
+ * ----------------------
+ * Requesting the "Binary_Compact" format for the \key Photons content
+ * writes the \c photons_compact.bin file instead of full interaction
+ * blocks. It starts with the standard header and contains one 'g' block
+ * per event followed by the event end line:
+ * \code
+ * char uint32_t
+ * 'g'  n_photons
+ * \endcode
+ * followed by \c n_photons photon records
+ * \code
+ *    double        4*double      4*double
+ *    weight        t x y z       p0 px py pz
+ * \endcode
+ * Fractional photons with identical production point and momentum are
+ * merged into a single record with their weights summed, and the records
+ * of an event are sorted by their kinematics.
+ *
+ * Provenance output
+ * -----------------
+ * Requesting the "Binary_Provenance" format for the \key Collisions
+ * content writes the \c provenance.bin file, which contains only the
+ * interaction graph of every event: one node per performed process and
+ * the edges connecting producing to consuming processes. It starts with
+ * the standard header and contains one 'v' block per event followed by
+ * the event end line:
+ * \code
+ * char uint32_t
+ * 'v'  n_nodes
+ * \endcode
+ * followed by \c n_nodes node records. All node fields are
+ * variable-length unsigned integers ("varints": 7 payload bits per byte,
+ * least significant group first, the high bit flags a continuation byte);
+ * signed values are zigzag-mapped (0, -1, 1, -2, ... to 0, 1, 2, 3, ...)
+ * before encoding. A node reads
+ * \code
+ * varint           varint       varint     varint varint
+ * process_id_delta process_type time_delta nin    nout
+ * \endcode
+ * followed by \c nin pairs (particle_id, origin_distance) for the
+ * incoming particles and \c nout particle ids for the outgoing ones. The
+ * process id is delta-encoded against the previous node, the time is
+ * quantized to 1e-3 fm and delta-encoded, and origin_distance is the
+ * difference between the process id of this node and the one of the
+ * process that produced the incoming particle; an origin id of 0 marks an
+ * initial-state particle. Wall crossings are not written, they do not
+ * change the ancestry. Ancestry chains that are normally reconstructed by
+ * post-processing the full collision history can be read off this graph
+ * directly, at a small fraction of the file size.
  **/
 
 BinaryOutputBase::BinaryOutputBase(const bf::path &path,
                                    const std::string &mode,
                                    const std::string &name,
-                                   bool extended_format)
-    : OutputInterface(name), file_{path, mode}, extended_(extended_format) {
-  std::fwrite("SMSH", 4, 1, file_.get());  // magic number
-  write(format_version_);                  // file format version number
+                                   bool extended_format, bool compressed)
+    : OutputInterface(name),
+      file_{path, mode},
+      writer_(file_.get(), compressed),
+      extended_(extended_format) {
+  if (compressed) {
+    /* Readers detect the compression by the gzip container magic already;
+     * the bumped version inside confirms the file was written by the
+     * compressing writer. */
+    format_version_ = 7;
+  }
+  writer_.append("SMSH", 4);  // magic number
+  write(format_version_);  // file format version number
   std::uint16_t format_variant = static_cast<uint16_t>(extended_);
   write(format_variant);
   write(VERSION_MAJOR);  // SMASH version
@@ -128,39 +199,53 @@ BinaryOutputBase::BinaryOutputBase(const bf::path &path,
 // write functions:
 void BinaryOutputBase::write(const std::string &s) {
   const auto size = boost::numeric_cast<uint32_t>(s.size());
-  std::fwrite(&size, sizeof(std::uint32_t), 1, file_.get());
-  std::fwrite(s.c_str(), s.size(), 1, file_.get());
+  writer_.append(&size, sizeof(std::uint32_t));
+  writer_.append(s.c_str(), s.size());
 }
 
-void BinaryOutputBase::write(const double x) {
-  std::fwrite(&x, sizeof(x), 1, file_.get());
-}
+void BinaryOutputBase::write(const double x) { writer_.append(&x, sizeof(x)); }
 
 void BinaryOutputBase::write(const FourVector &v) {
-  std::fwrite(v.begin(), sizeof(*v.begin()), 4, file_.get());
+  writer_.append(v.begin(), 4 * sizeof(*v.begin()));
 }
 
 void BinaryOutputBase::write(const Particles &particles) {
-  for (const auto &p : particles) {
-    write_particledata(p);
+  /* One tight loop per block layout: the extended-format flag is constant
+   * for the lifetime of the output, so it is tested once per block instead
+   * of once per particle. */
+  if (extended_) {
+    for (const auto &p : particles) {
+      write_particledata<true>(p);
+    }
+  } else {
+    for (const auto &p : particles) {
+      write_particledata<false>(p);
+    }
   }
 }
 
 void BinaryOutputBase::write(const ParticleList &particles) {
-  for (const auto &p : particles) {
-    write_particledata(p);
+  if (extended_) {
+    for (const auto &p : particles) {
+      write_particledata<true>(p);
+    }
+  } else {
+    for (const auto &p : particles) {
+      write_particledata<false>(p);
+    }
   }
 }
 
+template <bool Extended>
 void BinaryOutputBase::write_particledata(const ParticleData &p) {
   write(p.position());
-  double mass = p.effective_mass();
-  std::fwrite(&mass, sizeof(mass), 1, file_.get());
+  const double mass = p.effective_mass();
+  writer_.append(&mass, sizeof(mass));
   write(p.momentum());
   write(p.pdgcode().get_decimal());
   write(p.id());
   write(p.type().charge());
-  if (extended_) {
+  if (Extended) {
     const auto history = p.get_history();
     write(history.collisions_per_particle);
     write(p.formation_time());
@@ -173,19 +258,40 @@ void BinaryOutputBase::write_particledata(const ParticleData &p) {
   }
 }
 
+template void BinaryOutputBase::write_particledata<true>(const ParticleData &);
+template void BinaryOutputBase::write_particledata<false>(const ParticleData &);
+
 BinaryOutputCollisions::BinaryOutputCollisions(const bf::path &path,
                                                std::string name,
-                                               const OutputParameters &out_par)
+                                               const OutputParameters &out_par,
+                                               bool compressed)
     : BinaryOutputBase(
-          path / ((name == "Collisions" ? "collisions_binary" : name) + ".bin"),
-          "wb", name, out_par.get_coll_extended(name)),
-      print_start_end_(out_par.coll_printstartend) {}
+          out_par.shard_path(
+              path, (name == "Collisions" ? "collisions_binary" : name) +
+                        (compressed ? ".bin.gz" : ".bin")),
+          "wb", name, out_par.get_coll_extended(name), compressed),
+      print_start_end_(out_par.coll_printstartend),
+      /* The content filters only apply to the collisions content; the
+       * dilepton and photon outputs reuse this class and write everything. */
+      process_filter_(name == "Collisions" ? out_par.coll_process_filter
+                                           : std::set<int>{}),
+      sqrts_filter_(name == "Collisions"
+                        ? out_par.coll_sqrts_filter
+                        : std::array<double, 2>{
+                              {0., std::numeric_limits<double>::infinity()}}),
+      elastic_prescale_(name == "Collisions" ? out_par.coll_elastic_prescale
+                                             : 1) {
+  if (name == "Collisions" && out_par.coll_buffer_limit > 0) {
+    writer_.limit_buffer(static_cast<std::size_t>(out_par.coll_buffer_limit)
+                         << 20);
+  }
+}
 
 void BinaryOutputCollisions::at_eventstart(const Particles &particles,
                                            const int) {
   char pchar = 'p';
   if (print_start_end_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
+    writer_.append(&pchar, sizeof(char));
     write(particles.size());
     write(particles);
   }
@@ -196,52 +302,249 @@ void BinaryOutputCollisions::at_eventend(const Particles &particles,
                                          double impact_parameter) {
   char pchar = 'p';
   if (print_start_end_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
+    writer_.append(&pchar, sizeof(char));
     write(particles.size());
     write(particles);
   }
 
   // Event end line
   char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
+  writer_.append(&fchar, sizeof(char));
   write(event_number);
   write(impact_parameter);
 
-  // Flush to disk
-  std::fflush(file_.get());
+  // Hand the event over to the writer thread
+  writer_.flush();
 }
 
 void BinaryOutputCollisions::at_interaction(const Action &action,
                                             const double density) {
+  const ProcessType process_type = action.get_type();
+  if (!process_filter_.empty() &&
+      process_filter_.count(static_cast<int>(process_type)) == 0) {
+    return;
+  }
+  if (sqrts_filter_[0] > 0. ||
+      sqrts_filter_[1] < std::numeric_limits<double>::infinity()) {
+    const double sqrts = action.sqrt_s();
+    if (sqrts < sqrts_filter_[0] || sqrts > sqrts_filter_[1]) {
+      return;
+    }
+  }
+  /* The prescale counts deterministically instead of sampling, so it does
+   * not disturb the random number stream of the simulation. */
+  if (elastic_prescale_ > 1 && process_type == ProcessType::Elastic &&
+      elastic_count_++ % elastic_prescale_ != 0) {
+    return;
+  }
   char ichar = 'i';
-  std::fwrite(&ichar, sizeof(char), 1, file_.get());
+  writer_.append(&ichar, sizeof(char));
   write(action.incoming_particles().size());
   write(action.outgoing_particles().size());
-  std::fwrite(&density, sizeof(double), 1, file_.get());
+  writer_.append(&density, sizeof(double));
   const double weight = action.get_total_weight();
-  std::fwrite(&weight, sizeof(double), 1, file_.get());
+  writer_.append(&weight, sizeof(double));
   const double partial_weight = action.get_partial_weight();
-  std::fwrite(&partial_weight, sizeof(double), 1, file_.get());
-  const auto type = static_cast<uint32_t>(action.get_type());
-  std::fwrite(&type, sizeof(uint32_t), 1, file_.get());
+  writer_.append(&partial_weight, sizeof(double));
+  const auto type = static_cast<uint32_t>(process_type);
+  writer_.append(&type, sizeof(uint32_t));
   write(action.incoming_particles());
   write(action.outgoing_particles());
 }
 
+BinaryOutputPhotons::BinaryOutputPhotons(const bf::path &path,
+                                         std::string name,
+                                         const OutputParameters &out_par)
+    : BinaryOutputBase(out_par.shard_path(path, "photons_compact.bin"), "wb",
+                       name, false) {}
+
+void BinaryOutputPhotons::at_eventstart(const Particles &, const int) {
+  records_.clear();
+}
+
+void BinaryOutputPhotons::at_eventend(const Particles &, const int event_number,
+                                      double impact_parameter) {
+  /* Compact the event: fractional photons with bitwise identical
+   * kinematics carry no extra information, their weights simply add up.
+   * Sorting brings them next to each other (and makes the file layout
+   * independent of the buffering order). */
+  auto as_key = [](const PhotonRecord &r) {
+    return std::array<double, 8>{{r.position.x0(), r.position.x1(),
+                                  r.position.x2(), r.position.x3(),
+                                  r.momentum.x0(), r.momentum.x1(),
+                                  r.momentum.x2(), r.momentum.x3()}};
+  };
+  std::sort(records_.begin(), records_.end(),
+            [&as_key](const PhotonRecord &a, const PhotonRecord &b) {
+              return as_key(a) < as_key(b);
+            });
+  size_t n_unique = 0;
+  for (size_t i = 0; i < records_.size(); i++) {
+    if (n_unique > 0 &&
+        as_key(records_[n_unique - 1]) == as_key(records_[i])) {
+      records_[n_unique - 1].weight += records_[i].weight;
+    } else {
+      records_[n_unique++] = records_[i];
+    }
+  }
+  records_.resize(n_unique);
+
+  char gchar = 'g';
+  writer_.append(&gchar, sizeof(char));
+  write(records_.size());
+  for (const PhotonRecord &record : records_) {
+    write(record.weight);
+    write(record.position);
+    write(record.momentum);
+  }
+  records_.clear();
+
+  // Event end line
+  char fchar = 'f';
+  writer_.append(&fchar, sizeof(char));
+  write(event_number);
+  write(impact_parameter);
+
+  // Hand the event over to the writer thread
+  writer_.flush();
+}
+
+void BinaryOutputPhotons::at_interaction(const Action &action, const double) {
+  const double weight = action.get_total_weight();
+  for (const ParticleData &p : action.outgoing_particles()) {
+    if (p.pdgcode() == pdg::photon) {
+      records_.push_back({p.position(), p.momentum(), weight});
+    }
+  }
+}
+
+BinaryOutputProvenance::BinaryOutputProvenance(const bf::path &path,
+                                               std::string name,
+                                               const OutputParameters &out_par)
+    : BinaryOutputBase(out_par.shard_path(path, "provenance.bin"), "wb", name,
+                       false) {}
+
+void BinaryOutputProvenance::append_varint(uint64_t x) {
+  while (x >= 0x80u) {
+    buffer_.push_back(static_cast<uint8_t>(x) | 0x80u);
+    x >>= 7;
+  }
+  buffer_.push_back(static_cast<uint8_t>(x));
+}
+
+void BinaryOutputProvenance::at_eventstart(const Particles &, const int) {
+  buffer_.clear();
+  n_nodes_ = 0;
+  previous_process_id_ = 0;
+  previous_quantized_time_ = 0;
+}
+
+void BinaryOutputProvenance::at_interaction(const Action &action,
+                                            const double) {
+  const ParticleList &outgoing = action.outgoing_particles();
+  /* Wall crossings carry the particle through unchanged (and do not store
+   * a process id in the history), so they add nothing to the ancestry. */
+  if (outgoing.empty() || action.get_type() == ProcessType::Wall) {
+    return;
+  }
+  /* The process id was assigned when the action was performed and is
+   * stored in the history of its outgoing particles. */
+  const uint32_t process_id = outgoing.front().get_history().id_process;
+  append_varint(zigzag(static_cast<int64_t>(process_id) -
+                       static_cast<int64_t>(previous_process_id_)));
+  previous_process_id_ = process_id;
+  append_varint(static_cast<uint64_t>(action.get_type()));
+  /* The performed processes arrive time-ordered, so quantizing the time
+   * to 1e-3 fm and delta-encoding it keeps the field to a byte or two. */
+  const int64_t quantized_time =
+      static_cast<int64_t>(std::llround(action.time_of_execution() * 1e3));
+  append_varint(zigzag(quantized_time - previous_quantized_time_));
+  previous_quantized_time_ = quantized_time;
+  const ParticleList &incoming = action.incoming_particles();
+  append_varint(incoming.size());
+  append_varint(outgoing.size());
+  for (const ParticleData &p : incoming) {
+    append_varint(static_cast<uint64_t>(p.id()));
+    /* The edge to the producing process, encoded as the distance to this
+     * node; it is small for short-lived intermediaries. An origin id of 0
+     * marks an initial-state particle. */
+    const uint32_t origin = p.get_history().id_process;
+    append_varint(zigzag(static_cast<int64_t>(process_id) -
+                         static_cast<int64_t>(origin)));
+  }
+  for (const ParticleData &p : outgoing) {
+    append_varint(static_cast<uint64_t>(p.id()));
+  }
+  n_nodes_++;
+}
+
+void BinaryOutputProvenance::at_eventend(const Particles &,
+                                         const int event_number,
+                                         double impact_parameter) {
+  char vchar = 'v';
+  writer_.append(&vchar, sizeof(char));
+  write(n_nodes_);
+  if (!buffer_.empty()) {
+    writer_.append(buffer_.data(), buffer_.size());
+  }
+  buffer_.clear();
+  n_nodes_ = 0;
+
+  // Event end line
+  char fchar = 'f';
+  writer_.append(&fchar, sizeof(char));
+  write(event_number);
+  write(impact_parameter);
+
+  // Hand the event over to the writer thread
+  writer_.flush();
+}
+
 BinaryOutputParticles::BinaryOutputParticles(const bf::path &path,
                                              std::string name,
-                                             const OutputParameters &out_par)
-    : BinaryOutputBase(path / "particles_binary.bin", "wb", name,
-                       out_par.part_extended),
-      only_final_(out_par.part_only_final) {}
+                                             const OutputParameters &out_par,
+                                             bool compressed)
+    : BinaryOutputBase(
+          out_par.shard_path(path, compressed ? "particles_binary.bin.gz"
+                                              : "particles_binary.bin"),
+          "wb", name, out_par.part_extended, compressed),
+      only_final_(out_par.part_only_final),
+      out_par_(out_par) {}
+
+void BinaryOutputParticles::write_filtered_block(const Particles &particles) {
+  if (!out_par_.part_filtering) {
+    write(particles.size());
+    write(particles);
+    return;
+  }
+  size_t count = 0;
+  for (const ParticleData &p : particles) {
+    if (out_par_.passes_filter(p)) {
+      count++;
+    }
+  }
+  write(count);
+  if (is_extended()) {
+    for (const ParticleData &p : particles) {
+      if (out_par_.passes_filter(p)) {
+        write_particledata<true>(p);
+      }
+    }
+  } else {
+    for (const ParticleData &p : particles) {
+      if (out_par_.passes_filter(p)) {
+        write_particledata<false>(p);
+      }
+    }
+  }
+}
 
 void BinaryOutputParticles::at_eventstart(const Particles &particles,
                                           const int) {
   char pchar = 'p';
   if (!only_final_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
-    write(particles);
+    writer_.append(&pchar, sizeof(char));
+    write_filtered_block(particles);
   }
 }
 
@@ -249,18 +552,17 @@ void BinaryOutputParticles::at_eventend(const Particles &particles,
                                         const int event_number,
                                         double impact_parameter) {
   char pchar = 'p';
-  std::fwrite(&pchar, sizeof(char), 1, file_.get());
-  write(particles.size());
-  write(particles);
+  writer_.append(&pchar, sizeof(char));
+  write_filtered_block(particles);
 
   // Event end line
   char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
+  writer_.append(&fchar, sizeof(char));
   write(event_number);
   write(impact_parameter);
 
-  // Flush to disk
-  std::fflush(file_.get());
+  // Hand the event over to the writer thread
+  writer_.flush();
 }
 
 void BinaryOutputParticles::at_intermediate_time(const Particles &particles,
@@ -268,9 +570,8 @@ void BinaryOutputParticles::at_intermediate_time(const Particles &particles,
                                                  const DensityParameters &) {
   char pchar = 'p';
   if (!only_final_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
-    write(particles);
+    writer_.append(&pchar, sizeof(char));
+    write_filtered_block(particles);
   }
 }
 
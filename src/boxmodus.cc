@@ -217,7 +217,18 @@ double BoxModus::initial_conditions(Particles *particles,
     } else {
       /* thermal momentum according Maxwell-Boltzmann distribution */
       mass = HadronGasEos::sample_mass_thermal(data.type(), 1.0 / T);
-      momentum_radial = sample_momenta_from_thermal(T, mass);
+      if (data.type().is_stable()) {
+        /* The mass of a stable species is fixed, so its momenta can be
+         * drawn from a per-species inverse-CDF table instead of the
+         * rejection loop. */
+        ThermalMomentumSampler &sampler = thermal_samplers_[data.pdgcode()];
+        if (!sampler.is_tabulated_for(mass, T)) {
+          sampler = ThermalMomentumSampler(mass, T);
+        }
+        momentum_radial = sampler.sample();
+      } else {
+        momentum_radial = sample_momenta_from_thermal(T, mass);
+      }
     }
     phitheta.distribute_isotropically();
     log.debug(data.type().name(), "(id ", data.id(), ") radial momentum ",
@@ -0,0 +1,257 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/checkpoint.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "smash/config.h"
+#include "smash/particletype.h"
+#include "smash/pdgcode.h"
+
+namespace smash {
+
+namespace {
+
+/// Format version of the checkpoint file
+constexpr uint16_t checkpoint_version = 1;
+/// Format variant distinguishing checkpoints from other binary files
+constexpr uint16_t checkpoint_variant = 5;
+
+/**
+ * Write \p value to \p out in its raw binary representation.
+ *
+ * \param[in] out The stream to write to.
+ * \param[in] value The value to write.
+ */
+template <typename T>
+void write_value(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/**
+ * Read a value of type T from \p in.
+ *
+ * \param[in] in The stream to read from.
+ * \return The read value.
+ * \throw runtime_error if the stream does not hold enough data.
+ */
+template <typename T>
+T read_value(std::istream &in) {
+  T value;
+  in.read(reinterpret_cast<char *>(&value), sizeof(value));
+  if (!in) {
+    throw std::runtime_error("Corrupted checkpoint file.");
+  }
+  return value;
+}
+
+/**
+ * Write one particle to \p out.
+ *
+ * \param[in] out The stream to write to.
+ * \param[in] p The particle to write.
+ */
+void write_particle(std::ostream &out, const ParticleData &p) {
+  write_value<int32_t>(out, p.id());
+  write_value<uint32_t>(out, p.pdgcode().dump());
+  write_value<double>(out, p.momentum().x0());
+  write_value<double>(out, p.momentum().x1());
+  write_value<double>(out, p.momentum().x2());
+  write_value<double>(out, p.momentum().x3());
+  write_value<double>(out, p.position().x0());
+  write_value<double>(out, p.position().x1());
+  write_value<double>(out, p.position().x2());
+  write_value<double>(out, p.position().x3());
+  write_value<double>(out, p.begin_formation_time());
+  write_value<double>(out, p.formation_time());
+  write_value<double>(out, p.initial_xsec_scaling_factor());
+  const HistoryData h = p.get_history();
+  write_value<int32_t>(out, h.collisions_per_particle);
+  write_value<uint32_t>(out, h.id_process);
+  write_value<int32_t>(out, static_cast<int32_t>(h.process_type));
+  write_value<double>(out, h.time_last_collision);
+  write_value<uint32_t>(out, h.p1.dump());
+  write_value<uint32_t>(out, h.p2.dump());
+}
+
+/**
+ * Read one particle back from \p in.
+ *
+ * \param[in] in The stream to read from.
+ * \return The restored particle.
+ */
+ParticleData read_particle(std::istream &in) {
+  const auto id = read_value<int32_t>(in);
+  const PdgCode pdg(read_value<uint32_t>(in));
+  ParticleData p(ParticleType::find(pdg), id);
+  const auto E = read_value<double>(in);
+  const auto px = read_value<double>(in);
+  const auto py = read_value<double>(in);
+  const auto pz = read_value<double>(in);
+  p.set_4momentum(FourVector(E, px, py, pz));
+  const auto t = read_value<double>(in);
+  const auto x = read_value<double>(in);
+  const auto y = read_value<double>(in);
+  const auto z = read_value<double>(in);
+  p.set_4position(FourVector(t, x, y, z));
+  const auto begin_form_time = read_value<double>(in);
+  const auto form_time = read_value<double>(in);
+  p.set_slow_formation_times(begin_form_time, form_time);
+  p.set_cross_section_scaling_factor(read_value<double>(in));
+  HistoryData h;
+  h.collisions_per_particle = read_value<int32_t>(in);
+  h.id_process = read_value<uint32_t>(in);
+  h.process_type = static_cast<ProcessType>(read_value<int32_t>(in));
+  h.time_last_collision = read_value<double>(in);
+  h.p1 = PdgCode(read_value<uint32_t>(in));
+  h.p2 = PdgCode(read_value<uint32_t>(in));
+  p.set_history(h);
+  return p;
+}
+
+}  // unnamed namespace
+
+void write_checkpoint(const bf::path &file, const CheckpointState &state) {
+  const bf::path tmp_path =
+      bf::unique_path(file.string() + ".%%%%-%%%%");
+  {
+    bf::ofstream out(tmp_path, std::ios::binary);
+    out.write("SMSH", 4);
+    write_value<uint16_t>(out, checkpoint_version);
+    write_value<uint16_t>(out, checkpoint_variant);
+    const std::string version(VERSION_MAJOR);
+    write_value<uint32_t>(out, version.size());
+    out.write(version.c_str(), version.size());
+
+    write_value<int32_t>(out, state.event_number);
+    write_value<Clock::State>(out, state.labclock);
+    write_value<Clock::State>(out, state.outputclock);
+    write_value<random::Engine::State>(out, state.engine);
+    write_value<uint64_t>(out, state.interactions_total);
+    write_value<uint64_t>(out, state.previous_interactions_total);
+    write_value<uint64_t>(out, state.wall_actions_total);
+    write_value<uint64_t>(out, state.previous_wall_actions_total);
+    write_value<uint64_t>(out, state.total_pauli_blocked);
+    write_value<uint64_t>(out, state.intermediate_output_count);
+    write_value<uint64_t>(out, state.density_triggers_fired);
+
+    const QuantumNumbers &q = state.conserved_initial;
+    write_value<double>(out, q.momentum().x0());
+    write_value<double>(out, q.momentum().x1());
+    write_value<double>(out, q.momentum().x2());
+    write_value<double>(out, q.momentum().x3());
+    write_value<int32_t>(out, q.charge());
+    write_value<int32_t>(out, q.isospin3());
+    write_value<int32_t>(out, q.strangeness());
+    write_value<int32_t>(out, q.charmness());
+    write_value<int32_t>(out, q.bottomness());
+    write_value<int32_t>(out, q.baryon_number());
+
+    write_value<uint32_t>(out, state.particles.size());
+    for (const ParticleData &p : state.particles) {
+      write_particle(out, p);
+    }
+    write_value<uint32_t>(out, state.beam_momentum.size());
+    for (const FourVector &mom : state.beam_momentum) {
+      write_value<double>(out, mom.x0());
+      write_value<double>(out, mom.x1());
+      write_value<double>(out, mom.x2());
+      write_value<double>(out, mom.x3());
+    }
+    write_value<uint32_t>(out, state.nucleon_has_interacted.size());
+    for (const bool interacted : state.nucleon_has_interacted) {
+      write_value<uint8_t>(out, interacted ? 1 : 0);
+    }
+    if (!out) {
+      throw std::runtime_error("Failed to write checkpoint file " +
+                               file.string());
+    }
+  }
+  /* Renaming is atomic, so a preemption during the write leaves the previous
+   * checkpoint intact. */
+  bf::rename(tmp_path, file);
+}
+
+CheckpointState read_checkpoint(const bf::path &file) {
+  bf::ifstream in(file, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Cannot open checkpoint file " + file.string());
+  }
+  char magic[4];
+  in.read(magic, 4);
+  if (!in || std::memcmp(magic, "SMSH", 4) != 0 ||
+      read_value<uint16_t>(in) != checkpoint_version ||
+      read_value<uint16_t>(in) != checkpoint_variant) {
+    throw std::runtime_error(file.string() +
+                             " is not a SMASH checkpoint file.");
+  }
+  const auto version_length = read_value<uint32_t>(in);
+  std::string version(version_length, '\0');
+  in.read(&version[0], version_length);
+  if (!in || version != VERSION_MAJOR) {
+    throw std::runtime_error("Checkpoint file " + file.string() +
+                             " was written by SMASH " + version +
+                             ", resuming requires the same version.");
+  }
+
+  CheckpointState state;
+  state.event_number = read_value<int32_t>(in);
+  state.labclock = read_value<Clock::State>(in);
+  state.outputclock = read_value<Clock::State>(in);
+  state.engine = read_value<random::Engine::State>(in);
+  state.interactions_total = read_value<uint64_t>(in);
+  state.previous_interactions_total = read_value<uint64_t>(in);
+  state.wall_actions_total = read_value<uint64_t>(in);
+  state.previous_wall_actions_total = read_value<uint64_t>(in);
+  state.total_pauli_blocked = read_value<uint64_t>(in);
+  state.intermediate_output_count = read_value<uint64_t>(in);
+  state.density_triggers_fired = read_value<uint64_t>(in);
+
+  const auto E = read_value<double>(in);
+  const auto px = read_value<double>(in);
+  const auto py = read_value<double>(in);
+  const auto pz = read_value<double>(in);
+  const auto charge = read_value<int32_t>(in);
+  const auto isospin3 = read_value<int32_t>(in);
+  const auto strangeness = read_value<int32_t>(in);
+  const auto charmness = read_value<int32_t>(in);
+  const auto bottomness = read_value<int32_t>(in);
+  const auto baryon_number = read_value<int32_t>(in);
+  state.conserved_initial =
+      QuantumNumbers(FourVector(E, px, py, pz), charge, isospin3, strangeness,
+                     charmness, bottomness, baryon_number);
+
+  const auto n_particles = read_value<uint32_t>(in);
+  state.particles.reserve(n_particles);
+  for (uint32_t i = 0; i < n_particles; i++) {
+    state.particles.push_back(read_particle(in));
+  }
+  const auto n_beam = read_value<uint32_t>(in);
+  state.beam_momentum.reserve(n_beam);
+  for (uint32_t i = 0; i < n_beam; i++) {
+    const auto E_beam = read_value<double>(in);
+    const auto px_beam = read_value<double>(in);
+    const auto py_beam = read_value<double>(in);
+    const auto pz_beam = read_value<double>(in);
+    state.beam_momentum.emplace_back(E_beam, px_beam, py_beam, pz_beam);
+  }
+  const auto n_nucleons = read_value<uint32_t>(in);
+  state.nucleon_has_interacted.reserve(n_nucleons);
+  for (uint32_t i = 0; i < n_nucleons; i++) {
+    state.nucleon_has_interacted.push_back(read_value<uint8_t>(in) != 0);
+  }
+  return state;
+}
+
+}  // namespace smash
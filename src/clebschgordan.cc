@@ -8,14 +8,23 @@
 #include "smash/clebschgordan.h"
 
 #include <gsl/gsl_sf_coupling.h>
+#include <cassert>
+#include <cmath>
 #include <numeric>
+#include <vector>
 #include "smash/constants.h"
 #include "smash/logging.h"
 
 namespace smash {
 
-double clebsch_gordan(const int j_a, const int j_b, const int j_c,
-                      const int m_a, const int m_b, const int m_c) {
+namespace {
+
+/**
+ * Evaluate the Clebsch-Gordan coefficient from the Wigner 3-j symbol of
+ * GSL, see \ref clebsch_gordan for the convention.
+ */
+double clebsch_gordan_exact(const int j_a, const int j_b, const int j_c,
+                            const int m_a, const int m_b, const int m_c) {
   const double wigner_3j = gsl_sf_coupling_3j(j_a, j_b, j_c, m_a, m_b, -m_c);
   if (std::abs(wigner_3j) < really_small) {
     return 0.;
@@ -34,6 +43,75 @@ double clebsch_gordan(const int j_a, const int j_b, const int j_c,
   return result;
 }
 
+/**
+ * Maximum doubled angular momentum of the incoming particles that the
+ * precomputed table covers. The isospins appearing in SMASH are at most
+ * 3/2 (doubled: 3), so every isospin Clebsch-Gordan coefficient is served
+ * from the table; only exotic arguments fall back to GSL.
+ */
+constexpr int cg_table_j_max = 3;
+/// Number of tabulated doubled angular momenta of one incoming particle
+constexpr int cg_table_j_dim = cg_table_j_max + 1;
+/// Number of tabulated doubled angular momenta of the coupled state
+constexpr int cg_table_j_c_dim = 2 * cg_table_j_max + 1;
+/// Number of tabulated doubled magnetic quantum numbers per particle
+constexpr int cg_table_m_dim = 2 * cg_table_j_max + 1;
+
+/**
+ * \return The dense table index of the given quantum numbers.
+ * m_c is not part of the key: the coefficient vanishes unless
+ * \f$ m_c = m_a + m_b \f$, which the caller has checked.
+ */
+inline size_t cg_table_index(const int j_a, const int j_b, const int j_c,
+                             const int m_a, const int m_b) {
+  return (((j_a * cg_table_j_dim + j_b) * cg_table_j_c_dim + j_c) *
+              cg_table_m_dim +
+          (m_a + cg_table_j_max)) *
+             cg_table_m_dim +
+         (m_b + cg_table_j_max);
+}
+
+/// Fill the dense coefficient table, evaluating each entry once with GSL.
+std::vector<double> make_clebsch_gordan_table() {
+  std::vector<double> table(cg_table_j_dim * cg_table_j_dim *
+                                cg_table_j_c_dim * cg_table_m_dim *
+                                cg_table_m_dim,
+                            0.);
+  for (int j_a = 0; j_a <= cg_table_j_max; j_a++) {
+    for (int j_b = 0; j_b <= cg_table_j_max; j_b++) {
+      for (int j_c = 0; j_c <= 2 * cg_table_j_max; j_c++) {
+        for (int m_a = -j_a; m_a <= j_a; m_a += 2) {
+          for (int m_b = -j_b; m_b <= j_b; m_b += 2) {
+            table[cg_table_index(j_a, j_b, j_c, m_a, m_b)] =
+                clebsch_gordan_exact(j_a, j_b, j_c, m_a, m_b, m_a + m_b);
+          }
+        }
+      }
+    }
+  }
+  return table;
+}
+
+}  // unnamed namespace
+
+double clebsch_gordan(const int j_a, const int j_b, const int j_c,
+                      const int m_a, const int m_b, const int m_c) {
+  if (j_a <= cg_table_j_max && j_b <= cg_table_j_max &&
+      j_c <= 2 * cg_table_j_max && j_a >= 0 && j_b >= 0 && j_c >= 0 &&
+      std::abs(m_a) <= j_a && std::abs(m_b) <= j_b) {
+    if (m_c != m_a + m_b) {
+      // The coefficient vanishes unless the projections add up.
+      return 0.;
+    }
+    /* The table is built once on the first call; afterwards every lookup
+     * is a single indexed load, without GSL calls in the cross-section
+     * hot path. */
+    static const std::vector<double> table = make_clebsch_gordan_table();
+    return table[cg_table_index(j_a, j_b, j_c, m_a, m_b)];
+  }
+  return clebsch_gordan_exact(j_a, j_b, j_c, m_a, m_b, m_c);
+}
+
 /**
  * Calculate isospin Clebsch-Gordan coefficient for two particles p_a and p_b
  * coupling to a total isospin \see clebsch_gordan for details (I_tot, I_z).
@@ -75,6 +75,28 @@ namespace smash {
  * \li \key true - First collisions within the same nucleus allowed
  * \li \key false - First collisions within the same nucleus forbidden
  *
+ * \key Spectator_Suppression (bool, optional, default = false) \n
+ * Enables a fast path for spectators: nucleons that have not collided by
+ * the time the nuclei have passed through each other are frozen, i.e.
+ * excluded from the collision-search grid while they keep free-streaming
+ * with exact straight-line positions. A frozen nucleon is put back into
+ * the search as soon as the cloud of interacting particles comes within
+ * interaction range, so stray late interactions are still found. This
+ * helps minimum-bias runs with a fixed timestep, where events at a large
+ * impact parameter are dominated by spectator bookkeeping. The suppression
+ * assumes that spectators free-stream: it requires
+ * \key Collisions_Within_Nucleus: false and is most effective when the
+ * beam velocity dominates the Fermi motion.
+ *
+ * \key Initial_Ensemble_Size (int, optional, default = 0) \n
+ * If positive, this many nucleon configurations (positions and, if Fermi
+ * motion is on, Fermi momenta) are sampled once per nucleus at startup.
+ * Each event then reuses a random member of this ensemble with a fresh
+ * random rotation instead of sampling the nuclei from scratch, which
+ * speeds up the event initialization considerably. Statistically
+ * independent initial states require an ensemble that is large compared
+ * to the number of events; not supported for deformed nuclei.
+ *
  * To further configure the projectile, target and the impact parameter, see \n
  * \li \subpage projectile_and_target
  * \li \subpage input_impact_parameter_
@@ -267,6 +289,16 @@ ColliderModus::ColliderModus(Configuration modus_config,
     cll_in_nucleus_ = modus_cfg.take({"Collisions_Within_Nucleus"});
   }
 
+  // Get the option for the spectator fast path.
+  spectator_suppression_ = modus_cfg.take({"Spectator_Suppression"}, false);
+  if (spectator_suppression_ && cll_in_nucleus_) {
+    logger<LogArea::Collider>().warn(
+        "Spectator_Suppression assumes that spectators free-stream, which "
+        "Collisions_Within_Nucleus contradicts; the suppression is "
+        "disabled.");
+    spectator_suppression_ = false;
+  }
+
   // Set up the projectile nucleus
   Configuration proj_cfg = modus_cfg["Projectile"];
   if (proj_cfg.has_value({"Deformed"})) {
@@ -418,6 +450,16 @@ ColliderModus::ColliderModus(Configuration modus_config,
     // initial_z_displacement_ away from origin)
     initial_z_displacement_ /= 2.0;
   }
+
+  // Optionally pre-sample an ensemble of nucleon configurations that the
+  // events draw from instead of sampling the nuclei from scratch.
+  const int ensemble_size = modus_cfg.take({"Initial_Ensemble_Size"}, 0);
+  if (ensemble_size > 0) {
+    const bool with_fermi_motion = fermi_motion_ == FermiMotion::On ||
+                                   fermi_motion_ == FermiMotion::Frozen;
+    projectile_->sample_initial_ensemble(ensemble_size, with_fermi_motion);
+    target_->sample_initial_ensemble(ensemble_size, with_fermi_motion);
+  }
 }
 
 std::ostream &operator<<(std::ostream &out, const ColliderModus &m) {
@@ -449,6 +491,21 @@ std::unique_ptr<DeformedNucleus> ColliderModus::create_deformed_nucleus(
   }
 }
 
+double ColliderModus::nuclei_passing_time() {
+  double v_a, v_b;
+  std::tie(v_a, v_b) =
+      get_velocities(total_s_, projectile_->mass(), target_->mass());
+  /* v_a >= 0 >= v_b; in the fixed-target frame only the projectile moves.
+   * Measured from the start of the simulation, the nuclei first close the
+   * initial gap and then traverse each other completely. The uncontracted
+   * radii overestimate the distance, which only delays the freezing of the
+   * spectators and never costs correctness. */
+  const double passing_distance =
+      2. * (projectile_->get_nuclear_radius() + target_->get_nuclear_radius() +
+            initial_z_displacement_);
+  return passing_distance / (v_a - v_b);
+}
+
 double ColliderModus::initial_conditions(Particles *particles,
                                          const ExperimentParameters &) {
   const auto &log = logger<LogArea::Collider>();
@@ -457,8 +514,16 @@ double ColliderModus::initial_conditions(Particles *particles,
   log.info() << "Impact parameter = " << format(impact_, "fm");
   // Populate the nuclei with appropriately distributed nucleons.
   // If deformed, this includes rotating the nucleus.
-  projectile_->arrange_nucleons();
-  target_->arrange_nucleons();
+  const bool use_ensemble = projectile_->has_initial_ensemble();
+  if (use_ensemble) {
+    /* Reuse pre-sampled configurations (with a fresh random rotation)
+     * instead of sampling positions and Fermi momenta from scratch. */
+    projectile_->draw_from_ensemble();
+    target_->draw_from_ensemble();
+  } else {
+    projectile_->arrange_nucleons();
+    target_->arrange_nucleons();
+  }
 
   // Use the total mandelstam variable to get the frame-dependent velocity for
   // each nucleus. Position a is projectile, position b is target.
@@ -486,8 +551,11 @@ double ColliderModus::initial_conditions(Particles *particles,
       fermi_motion_ == FermiMotion::Frozen) {
     // Frozen: Fermi momenta will be ignored during the propagation to
     // avoid that the nuclei will fly apart.
-    projectile_->generate_fermi_momenta();
-    target_->generate_fermi_momenta();
+    if (!use_ensemble) {
+      // Ensemble configurations already carry their Fermi momenta.
+      projectile_->generate_fermi_momenta();
+      target_->generate_fermi_momenta();
+    }
     if (fermi_motion_ == FermiMotion::On) {
       log.info() << "Fermi motion is ON.";
     } else {
@@ -156,6 +156,12 @@ std::vector<std::string> Configuration::list_upmost_nodes() {
 Configuration::Value Configuration::take(
     std::initializer_list<const char *> keys) {
   assert(keys.size() > 0);
+  if (*frozen_) {
+    throw std::logic_error("Attempt to take the configuration value \"" +
+                           std::string(keys.begin()[keys.size() - 1]) +
+                           "\" after initialization. All parameters have to "
+                           "be resolved while the experiment is set up.");
+  }
   auto node = root_node_;
   auto keyIt = begin(keys);
   std::size_t i = 0;
@@ -173,6 +179,12 @@ Configuration::Value Configuration::take(
 
 Configuration::Value Configuration::read(
     std::initializer_list<const char *> keys) const {
+  if (*frozen_) {
+    throw std::logic_error("Attempt to read the configuration value \"" +
+                           std::string(keys.begin()[keys.size() - 1]) +
+                           "\" after initialization. All parameters have to "
+                           "be resolved while the experiment is set up.");
+  }
   return {find_node_at(root_node_, keys), keys.begin()[keys.size() - 1]};
 }
 
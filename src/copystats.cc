@@ -0,0 +1,78 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/copystats.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+
+#include "smash/logging.h"
+
+namespace smash {
+
+namespace {
+
+/// Number of attribution scopes.
+constexpr std::size_t num_scopes = 6;
+
+/// Human-readable names of the scopes, in enumerator order.
+constexpr std::array<const char *, num_scopes> scope_names = {
+    {"collision_search", "propagation", "lattice_update", "output",
+     "perform_action", "other"}};
+
+/// Per-scope copy counters; worker threads count too, hence atomic.
+std::array<std::atomic<std::uint64_t>, num_scopes> copy_counts;
+
+/// Per-scope move counters.
+std::array<std::atomic<std::uint64_t>, num_scopes> move_counts;
+
+/// The scope copies of this thread are currently attributed to.
+thread_local CopyStats::Scope current_scope = CopyStats::Scope::Other;
+
+}  // unnamed namespace
+
+void CopyStats::count_copy() {
+  copy_counts[static_cast<int>(current_scope)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+void CopyStats::count_move() {
+  move_counts[static_cast<int>(current_scope)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+CopyStats::Scope CopyStats::enter_scope(Scope scope) {
+  const Scope previous = current_scope;
+  current_scope = scope;
+  return previous;
+}
+
+void CopyStats::report() {
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < num_scopes; i++) {
+    total += copy_counts[i].load(std::memory_order_relaxed) +
+             move_counts[i].load(std::memory_order_relaxed);
+  }
+  if (total == 0) {
+    return;
+  }
+  const auto &log = logger<LogArea::Memory>();
+  std::ostringstream line;
+  line << "ParticleData copies/moves of the run:";
+  for (std::size_t i = 0; i < num_scopes; i++) {
+    line << (i == 0 ? " " : ", ") << scope_names[i] << " "
+         << copy_counts[i].exchange(0, std::memory_order_relaxed) << "/"
+         << move_counts[i].exchange(0, std::memory_order_relaxed);
+  }
+  log.info() << line.str();
+}
+
+}  // namespace smash
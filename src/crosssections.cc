@@ -9,8 +9,15 @@
 
 #include "smash/crosssections.h"
 
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "smash/clebschgordan.h"
 #include "smash/constants.h"
+#include "smash/decaymodes.h"
 #include "smash/kinematics.h"
 #include "smash/logging.h"
 #include "smash/parametrizations.h"
@@ -109,6 +116,178 @@ static double sum_xs_of(CollisionBranchList& list) {
   return xs_sum;
 }
 
+/**
+ * One entry of the precomputed two-to-two channel registry: a possible
+ * final state of resonance production, together with the total isospin of
+ * the reaction and the corresponding isospin factor.
+ */
+struct ChannelEntry {
+  /// Type of the first outgoing particle.
+  ParticleTypePtr type_res_1;
+  /// Type of the second outgoing particle.
+  ParticleTypePtr type_res_2;
+  /// Twice the total isospin of the reaction.
+  int twoI;
+  /// Precomputed squared isospin Clebsch-Gordan factor.
+  double isospin_factor;
+  /**
+   * Opening energy of the channel: the lowest \f$\sqrt{s}\f$ for which the
+   * available mass range of the first outgoing particle is wider than the
+   * integration tolerance.
+   */
+  double threshold;
+};
+
+/**
+ * Helper function:
+ * \return The possible resonance-production final states for the given
+ * incoming types at the given \ref NNChannelSite.
+ *
+ * Which final states conserve charge, baryon number and strangeness and
+ * have a non-vanishing isospin factor depends only on the incoming
+ * species, not on the event, so the
+ * list is derived once per incoming pair and call site and then reused.
+ * Only the energy-dependent matrix elements and spectral integrals remain
+ * to be evaluated at runtime. The registry is thread-local, so concurrent
+ * cross-section evaluations do not interfere.
+ */
+static const std::vector<ChannelEntry>& channel_registry(
+    const ParticleType& type_a, const ParticleType& type_b,
+    const NNChannelSite site, const ParticleTypePtrList& list_res_1,
+    const ParticleTypePtrList& list_res_2) {
+  using RegistryKey = std::tuple<ParticleTypePtr, ParticleTypePtr,
+                                 NNChannelSite>;
+  static thread_local std::map<RegistryKey, std::vector<ChannelEntry>>
+      registries;
+  const RegistryKey key(&type_a, &type_b, site);
+  auto it = registries.find(key);
+  if (it == registries.end()) {
+    std::vector<ChannelEntry> entries;
+    for (ParticleTypePtr type_res_1 : list_res_1) {
+      for (ParticleTypePtr type_res_2 : list_res_2) {
+        /* Check the conservation laws. For the resonance-production
+         * sites the candidate lists conserve baryon number and
+         * strangeness by construction; the checks are paid only once
+         * per species pair here, never in the event loop. */
+        if (type_res_1->charge() + type_res_2->charge() !=
+                type_a.charge() + type_b.charge() ||
+            type_res_1->baryon_number() + type_res_2->baryon_number() !=
+                type_a.baryon_number() + type_b.baryon_number() ||
+            type_res_1->strangeness() + type_res_2->strangeness() !=
+                type_a.strangeness() + type_b.strangeness()) {
+          continue;
+        }
+        // loop over total isospin
+        for (const int twoI : I_tot_range(type_a, type_b)) {
+          const double isospin_factor = isospin_clebsch_gordan_sqr_2to2(
+              type_a, type_b, *type_res_1, *type_res_2, twoI);
+          // If Clebsch-Gordan coefficient is zero, don't bother with the rest.
+          if (std::abs(isospin_factor) < really_small) {
+            continue;
+          }
+          const double threshold =
+              type_res_1->min_mass_kinematic() + type_res_2->mass() + 1E-3;
+          entries.push_back(
+              {type_res_1, type_res_2, twoI, isospin_factor, threshold});
+        }
+      }
+    }
+    it = registries.emplace(key, std::move(entries)).first;
+  }
+  return it->second;
+}
+
+/**
+ * Helper function:
+ * \return The resonances that can be formed in a 2->1 process from the
+ * given incoming types.
+ *
+ * Charge and baryon-number conservation and the existence of a decay mode
+ * into the incoming species depend only on the types, so the candidate
+ * list is built once per incoming pair from ParticleType::list_all() and
+ * then reused; the in-width and the spectral function remain
+ * energy-dependent runtime quantities.
+ */
+static const ParticleTypePtrList& resonance_candidates(
+    const ParticleType& type_a, const ParticleType& type_b) {
+  static thread_local std::map<std::pair<ParticleTypePtr, ParticleTypePtr>,
+                               ParticleTypePtrList>
+      candidates;
+  const auto key = std::make_pair(ParticleTypePtr(&type_a),
+                                  ParticleTypePtr(&type_b));
+  auto it = candidates.find(key);
+  if (it == candidates.end()) {
+    ParticleTypePtrList list;
+    for (const ParticleType& type_resonance : ParticleType::list_all()) {
+      /* Not a resonance, go to next type of particle */
+      if (type_resonance.is_stable()) {
+        continue;
+      }
+      // Same resonance as in the beginning, ignore
+      if ((!type_a.is_stable() &&
+           type_resonance.pdgcode() == type_a.pdgcode()) ||
+          (!type_b.is_stable() &&
+           type_resonance.pdgcode() == type_b.pdgcode())) {
+        continue;
+      }
+      // Check for charge conservation.
+      if (type_resonance.charge() != type_a.charge() + type_b.charge()) {
+        continue;
+      }
+      // Check for baryon-number conservation.
+      if (type_resonance.baryon_number() !=
+          type_a.baryon_number() + type_b.baryon_number()) {
+        continue;
+      }
+      // The resonance needs a decay mode into the incoming species.
+      const ParticleTypePtrList l = {&type_a, &type_b};
+      const auto& decaymodes = type_resonance.decay_modes().decay_mode_list();
+      const bool has_mode =
+          std::any_of(decaymodes.begin(), decaymodes.end(),
+                      [&l](const DecayBranchPtr& mode) {
+                        return mode->type().has_particles(l);
+                      });
+      if (!has_mode) {
+        continue;
+      }
+      list.push_back(&type_resonance);
+    }
+    it = candidates.emplace(key, std::move(list)).first;
+  }
+  return it->second;
+}
+
+/**
+ * Helper function:
+ * \return The light nuclei a given nucleus species can turn into while
+ * conserving charge, baryon number and strangeness, excluding the species
+ * itself.
+ *
+ * Used by the \f$\pi d \leftrightarrow \pi d'\f$ and
+ * \f$N d \leftrightarrow N d'\f$ channels; like the channel registry, the
+ * conservation filtering happens once per species instead of once per
+ * collision.
+ */
+static const ParticleTypePtrList& nucleus_siblings(
+    const ParticleType& type_nucleus) {
+  static thread_local std::map<ParticleTypePtr, ParticleTypePtrList> siblings;
+  const ParticleTypePtr key(&type_nucleus);
+  auto it = siblings.find(key);
+  if (it == siblings.end()) {
+    ParticleTypePtrList list;
+    for (ParticleTypePtr nucleus : ParticleType::list_light_nuclei()) {
+      if (nucleus == key || nucleus->charge() != type_nucleus.charge() ||
+          nucleus->baryon_number() != type_nucleus.baryon_number() ||
+          nucleus->strangeness() != type_nucleus.strangeness()) {
+        continue;
+      }
+      list.push_back(nucleus);
+    }
+    it = siblings.emplace(key, std::move(list)).first;
+  }
+  return it->second;
+}
+
 CrossSections::CrossSections(const ParticleList& incoming_particles,
                              const double sqrt_s,
                              const std::pair<FourVector, FourVector> potentials)
@@ -705,21 +884,12 @@ CollisionBranchList CrossSections::two_to_one() const {
   const double m2 = incoming_particles_[1].effective_mass();
   const double p_cm_sqr = pCM_sqr(sqrt_s_, m1, m2);
 
-  // Find all the possible resonances
-  for (const ParticleType& type_resonance : ParticleType::list_all()) {
-    /* Not a resonance, go to next type of particle */
-    if (type_resonance.is_stable()) {
-      continue;
-    }
-
-    // Same resonance as in the beginning, ignore
-    if ((!type_particle_a.is_stable() &&
-         type_resonance.pdgcode() == type_particle_a.pdgcode()) ||
-        (!type_particle_b.is_stable() &&
-         type_resonance.pdgcode() == type_particle_b.pdgcode())) {
-      continue;
-    }
-
+  /* Find all the possible resonances. The candidates that conserve charge
+   * and baryon number and can decay into the incoming species are
+   * precomputed per incoming pair. */
+  for (const ParticleTypePtr resonance :
+       resonance_candidates(type_particle_a, type_particle_b)) {
+    const ParticleType& type_resonance = *resonance;
     double resonance_xsection = formation(type_resonance, p_cm_sqr);
 
     // If cross section is non-negligible, add resonance to the list
@@ -739,17 +909,9 @@ double CrossSections::formation(const ParticleType& type_resonance,
                                 double cm_momentum_sqr) const {
   const ParticleType& type_particle_a = incoming_particles_[0].type();
   const ParticleType& type_particle_b = incoming_particles_[1].type();
-  // Check for charge conservation.
-  if (type_resonance.charge() !=
-      type_particle_a.charge() + type_particle_b.charge()) {
-    return 0.;
-  }
-
-  // Check for baryon-number conservation.
-  if (type_resonance.baryon_number() !=
-      type_particle_a.baryon_number() + type_particle_b.baryon_number()) {
-    return 0.;
-  }
+  /* Charge and baryon-number conservation were already checked when the
+   * candidate list of the incoming pair was built, see
+   * resonance_candidates(). */
 
   // Calculate partial in-width.
   const double partial_width = type_resonance.get_partial_in_width(
@@ -868,7 +1030,8 @@ CollisionBranchList CrossSections::nn_xx(ReactionsBitSet included_2to2) const {
   // Find N N → N R channels.
   if (included_2to2[IncludedReactions::NN_to_NR] == 1) {
     channel_list = find_nn_xsection_from_type(
-        ParticleType::list_baryon_resonances(), nuc_or_anti_nuc,
+        NNChannelSite::NN_to_NR, ParticleType::list_baryon_resonances(),
+        nuc_or_anti_nuc,
         [&sqrts](const ParticleType& type_res_1, const ParticleType&) {
           return type_res_1.iso_multiplet()->get_integral_NR(sqrts);
         });
@@ -881,7 +1044,8 @@ CollisionBranchList CrossSections::nn_xx(ReactionsBitSet included_2to2) const {
   // Find N N → Δ R channels.
   if (included_2to2[IncludedReactions::NN_to_DR] == 1) {
     channel_list = find_nn_xsection_from_type(
-        ParticleType::list_baryon_resonances(), delta_or_anti_delta,
+        NNChannelSite::NN_to_DR, ParticleType::list_baryon_resonances(),
+        delta_or_anti_delta,
         [&sqrts](const ParticleType& type_res_1,
                  const ParticleType& type_res_2) {
           return type_res_1.iso_multiplet()->get_integral_RR(type_res_2, sqrts);
@@ -906,6 +1070,7 @@ CollisionBranchList CrossSections::nn_xx(ReactionsBitSet included_2to2) const {
     const ParticleTypePtrList antideutron_list = {antideutron};
     const ParticleTypePtrList pion_list = {pim, pi0, pip};
     channel_list = find_nn_xsection_from_type(
+        NNChannelSite::NN_to_dpi,
         (both_antinucleons ? antideutron_list : deutron_list), pion_list,
         [&sqrts](const ParticleType& type_res_1,
                  const ParticleType& type_res_2) {
@@ -1924,46 +2089,35 @@ CollisionBranchList CrossSections::dpi_xx(ReactionsBitSet
                                   ? ParticleType::list_nucleons()
                                   : ParticleType::list_anti_nucleons();
     const double s = sqrt_s_ * sqrt_s_;
-    for (ParticleTypePtr nuc_a : nuc) {
-      for (ParticleTypePtr nuc_b : nuc) {
-        if (type_a.charge() + type_b.charge() !=
-            nuc_a->charge() + nuc_b->charge()) {
-          continue;
-        }
-        // loop over total isospin
-        for (const int twoI : I_tot_range(*nuc_a, *nuc_b)) {
-          const double isospin_factor = isospin_clebsch_gordan_sqr_2to2(
-              type_a, type_b, *nuc_a, *nuc_b, twoI);
-          // If Clebsch-Gordan coefficient = 0, don't bother with the rest.
-          if (std::abs(isospin_factor) < really_small) {
-            continue;
-          }
-
-          // Calculate matrix element for inverse process.
-          const double matrix_element =
-              nn_to_resonance_matrix_element(sqrts, type_a, type_b, twoI);
-          if (matrix_element <= 0.) {
-            continue;
-          }
+    /* The conservation-law filtering and the isospin factors of the
+     * nucleon pairs are precomputed in the channel registry. */
+    for (const ChannelEntry& channel : channel_registry(
+             type_a, type_b, NNChannelSite::dpi_to_NN, nuc, nuc)) {
+      const ParticleType& nuc_a = *channel.type_res_1;
+      const ParticleType& nuc_b = *channel.type_res_2;
+      // Calculate matrix element for inverse process.
+      const double matrix_element =
+          nn_to_resonance_matrix_element(sqrts, type_a, type_b, channel.twoI);
+      if (matrix_element <= 0.) {
+        continue;
+      }
 
-          const double spin_factor = (nuc_a->spin() + 1) * (nuc_b->spin() + 1);
-          const int sym_fac_in =
-              (type_a.iso_multiplet() == type_b.iso_multiplet()) ? 2 : 1;
-          const int sym_fac_out =
-              (nuc_a->iso_multiplet() == nuc_b->iso_multiplet()) ? 2 : 1;
-          double p_cm_final = pCM_from_s(s, nuc_a->mass(), nuc_b->mass());
-          const double xsection = isospin_factor * spin_factor * sym_fac_in /
-                                  sym_fac_out * p_cm_final * matrix_element /
-                                  (s * cm_momentum());
-
-          if (xsection > really_small) {
-            process_list.push_back(make_unique<CollisionBranch>(
-                *nuc_a, *nuc_b, xsection, ProcessType::TwoToTwo));
-            log.debug(type_a.name(), type_b.name(), "->", nuc_a->name(),
-                      nuc_b->name(), " at sqrts [GeV] = ", sqrts,
-                      " with cs[mb] = ", xsection);
-          }
-        }
+      const double spin_factor = (nuc_a.spin() + 1) * (nuc_b.spin() + 1);
+      const int sym_fac_in =
+          (type_a.iso_multiplet() == type_b.iso_multiplet()) ? 2 : 1;
+      const int sym_fac_out =
+          (nuc_a.iso_multiplet() == nuc_b.iso_multiplet()) ? 2 : 1;
+      double p_cm_final = pCM_from_s(s, nuc_a.mass(), nuc_b.mass());
+      const double xsection = channel.isospin_factor * spin_factor *
+                              sym_fac_in / sym_fac_out * p_cm_final *
+                              matrix_element / (s * cm_momentum());
+
+      if (xsection > really_small) {
+        process_list.push_back(make_unique<CollisionBranch>(
+            nuc_a, nuc_b, xsection, ProcessType::TwoToTwo));
+        log.debug(type_a.name(), type_b.name(), "->", nuc_a.name(),
+                  nuc_b.name(), " at sqrts [GeV] = ", sqrts,
+                  " with cs[mb] = ", xsection);
       }
     }
   }
@@ -1975,15 +2129,10 @@ CollisionBranchList CrossSections::dpi_xx(ReactionsBitSet
        type_a.pdgcode().is_pion())) {
     const ParticleType& type_pi = type_a.pdgcode().is_pion() ? type_a : type_b;
     const ParticleType& type_nucleus = type_a.is_nucleus() ? type_a : type_b;
-    ParticleTypePtrList nuclei = ParticleType::list_light_nuclei();
     const double s = sqrt_s_ * sqrt_s_;
-    for (ParticleTypePtr produced_nucleus : nuclei) {
-      // Elastic collisions are treated in a different function
-      if (produced_nucleus == &type_nucleus ||
-          produced_nucleus->charge() != type_nucleus.charge() ||
-          produced_nucleus->baryon_number() != type_nucleus.baryon_number()) {
-        continue;
-      }
+    /* Elastic collisions are treated in a different function; the
+     * conservation-law filtering is precomputed per nucleus species. */
+    for (ParticleTypePtr produced_nucleus : nucleus_siblings(type_nucleus)) {
       // same matrix element for πd and πd̅
       const double tmp = sqrts - pion_mass - deuteron_mass;
       // Matrix element is fit to match the inelastic pi+ d -> pi+ n p
@@ -2027,17 +2176,12 @@ CollisionBranchList CrossSections::dn_xx(
   const ParticleType& type_N = type_a.is_nucleon() ? type_a : type_b;
   const ParticleType& type_nucleus = type_a.is_nucleus() ? type_a : type_b;
   CollisionBranchList process_list;
-  ParticleTypePtrList nuclei = ParticleType::list_light_nuclei();
   const double s = sqrt_s_ * sqrt_s_;
   const double sqrts = sqrt_s_;
 
-  for (ParticleTypePtr produced_nucleus : nuclei) {
-    // No elastic collisions for now, respect conservation laws
-    if (produced_nucleus == &type_nucleus ||
-        produced_nucleus->charge() != type_nucleus.charge() ||
-        produced_nucleus->baryon_number() != type_nucleus.baryon_number()) {
-      continue;
-    }
+  /* No elastic collisions for now; the conservation laws are respected
+   * by construction of the precomputed sibling list. */
+  for (ParticleTypePtr produced_nucleus : nucleus_siblings(type_nucleus)) {
     double matrix_element = 0.0;
     double tmp = sqrts - nucleon_mass - deuteron_mass;
     assert(tmp >= 0.0);
@@ -2362,51 +2506,39 @@ CollisionBranchList CrossSections::bar_bar_to_nuc_nuc(
     nuc_or_anti_nuc = ParticleType::list_nucleons();
   }
 
-  // Loop over all nucleon or anti-nucleon charge states.
-  for (ParticleTypePtr nuc_a : nuc_or_anti_nuc) {
-    for (ParticleTypePtr nuc_b : nuc_or_anti_nuc) {
-      /* Check for charge conservation. */
-      if (type_a.charge() + type_b.charge() !=
-          nuc_a->charge() + nuc_b->charge()) {
-        continue;
-      }
-      // loop over total isospin
-      for (const int twoI : I_tot_range(*nuc_a, *nuc_b)) {
-        const double isospin_factor = isospin_clebsch_gordan_sqr_2to2(
-            type_a, type_b, *nuc_a, *nuc_b, twoI);
-        // If Clebsch-Gordan coefficient is zero, don't bother with the rest
-        if (std::abs(isospin_factor) < really_small) {
-          continue;
-        }
-
-        // Calculate matrix element for inverse process.
-        const double matrix_element =
-            nn_to_resonance_matrix_element(sqrt_s_, type_a, type_b, twoI);
-        if (matrix_element <= 0.) {
-          continue;
-        }
+  /* The nucleon pairs conserving the quantum numbers of the incoming
+   * baryons, with their isospin factors, come precomputed from the
+   * channel registry; only the matrix elements are energy-dependent. */
+  for (const ChannelEntry& channel :
+       channel_registry(type_a, type_b, NNChannelSite::BB_to_NN,
+                        nuc_or_anti_nuc, nuc_or_anti_nuc)) {
+    const ParticleType& nuc_a = *channel.type_res_1;
+    const ParticleType& nuc_b = *channel.type_res_2;
+    // Calculate matrix element for inverse process.
+    const double matrix_element =
+        nn_to_resonance_matrix_element(sqrt_s_, type_a, type_b, channel.twoI);
+    if (matrix_element <= 0.) {
+      continue;
+    }
 
-        /** Cross section for 2->2 resonance absorption, obtained via detailed
-         * balance from the inverse reaction.
-         * See eqs. (B.6), (B.9) and (181) in \iref{Buss:2011mx}.
-         * There are factors for spin, isospin and symmetry involved. */
-        const double spin_factor = (nuc_a->spin() + 1) * (nuc_b->spin() + 1);
-        const int sym_fac_in =
-            (type_a.iso_multiplet() == type_b.iso_multiplet()) ? 2 : 1;
-        const int sym_fac_out =
-            (nuc_a->iso_multiplet() == nuc_b->iso_multiplet()) ? 2 : 1;
-        const double xsection = isospin_factor * spin_factor * sym_fac_in /
-                                sym_fac_out * p_cm_final * matrix_element /
-                                (s * cm_momentum());
-
-        if (xsection > really_small) {
-          process_list.push_back(make_unique<CollisionBranch>(
-              *nuc_a, *nuc_b, xsection, ProcessType::TwoToTwo));
-          const auto& log = logger<LogArea::CrossSections>();
-          log.debug("2->2 absorption with original particles: ", type_a,
-                    type_b);
-        }
-      }
+    /** Cross section for 2->2 resonance absorption, obtained via detailed
+     * balance from the inverse reaction.
+     * See eqs. (B.6), (B.9) and (181) in \iref{Buss:2011mx}.
+     * There are factors for spin, isospin and symmetry involved. */
+    const double spin_factor = (nuc_a.spin() + 1) * (nuc_b.spin() + 1);
+    const int sym_fac_in =
+        (type_a.iso_multiplet() == type_b.iso_multiplet()) ? 2 : 1;
+    const int sym_fac_out =
+        (nuc_a.iso_multiplet() == nuc_b.iso_multiplet()) ? 2 : 1;
+    const double xsection = channel.isospin_factor * spin_factor * sym_fac_in /
+                            sym_fac_out * p_cm_final * matrix_element /
+                            (s * cm_momentum());
+
+    if (xsection > really_small) {
+      process_list.push_back(make_unique<CollisionBranch>(
+          nuc_a, nuc_b, xsection, ProcessType::TwoToTwo));
+      const auto& log = logger<LogArea::CrossSections>();
+      log.debug("2->2 absorption with original particles: ", type_a, type_b);
     }
   }
   return process_list;
@@ -2497,7 +2629,7 @@ double CrossSections::nn_to_resonance_matrix_element(double sqrts,
 
 template <class IntegrationMethod>
 CollisionBranchList CrossSections::find_nn_xsection_from_type(
-    const ParticleTypePtrList& list_res_1,
+    const NNChannelSite site, const ParticleTypePtrList& list_res_1,
     const ParticleTypePtrList& list_res_2,
     const IntegrationMethod integrator) const {
   const ParticleType& type_particle_a = incoming_particles_[0].type();
@@ -2507,109 +2639,109 @@ CollisionBranchList CrossSections::find_nn_xsection_from_type(
   CollisionBranchList channel_list;
   const double s = sqrt_s_ * sqrt_s_;
 
-  // Loop over specified first resonance list
-  for (ParticleTypePtr type_res_1 : list_res_1) {
-    // Loop over specified second resonance list
-    for (ParticleTypePtr type_res_2 : list_res_2) {
-      // Check for charge conservation.
-      if (type_res_1->charge() + type_res_2->charge() !=
-          type_particle_a.charge() + type_particle_b.charge()) {
-        continue;
-      }
+  /* Loop over the precomputed channels: charge conservation and the
+   * isospin factors have already been checked when the registry for this
+   * incoming pair was built. */
+  for (const ChannelEntry& channel : channel_registry(
+           type_particle_a, type_particle_b, site, list_res_1, list_res_2)) {
+    const ParticleTypePtr type_res_1 = channel.type_res_1;
+    const ParticleTypePtr type_res_2 = channel.type_res_2;
+
+    /* Check the available energy against the precomputed channel opening
+     * (which requires it to be a little above the kinematic threshold,
+     * because the integration will not work if it's too close). */
+    if (sqrt_s_ < channel.threshold) {
+      continue;
+    }
 
-      // loop over total isospin
-      for (const int twoI : I_tot_range(type_particle_a, type_particle_b)) {
-        const double isospin_factor = isospin_clebsch_gordan_sqr_2to2(
-            type_particle_a, type_particle_b, *type_res_1, *type_res_2, twoI);
-        // If Clebsch-Gordan coefficient is zero, don't bother with the rest.
-        if (std::abs(isospin_factor) < really_small) {
-          continue;
-        }
+    // Calculate matrix element.
+    const double matrix_element = nn_to_resonance_matrix_element(
+        sqrt_s_, *type_res_1, *type_res_2, channel.twoI);
+    if (matrix_element <= 0.) {
+      continue;
+    }
 
-        // Integration limits.
-        const double lower_limit = type_res_1->min_mass_kinematic();
-        const double upper_limit = sqrt_s_ - type_res_2->mass();
-        /* Check the available energy (requiring it to be a little above the
-         * threshold, because the integration will not work if it's too close).
-         */
-        if (upper_limit - lower_limit < 1E-3) {
-          continue;
-        }
+    /* Calculate resonance production cross section
+     * using the Breit-Wigner distribution as probability amplitude.
+     * Integrate over the allowed resonance mass range. */
+    const double resonance_integral = integrator(*type_res_1, *type_res_2);
 
-        // Calculate matrix element.
-        const double matrix_element = nn_to_resonance_matrix_element(
-            sqrt_s_, *type_res_1, *type_res_2, twoI);
-        if (matrix_element <= 0.) {
-          continue;
-        }
+    /** Cross section for 2->2 process with 1/2 resonance(s) in final state.
+     * Based on Eq. (46) in \iref{Weil:2013mya} and Eq. (3.29) in
+     * \iref{Bass:1998ca} */
+    const double spin_factor =
+        (type_res_1->spin() + 1) * (type_res_2->spin() + 1);
+    const double xsection = channel.isospin_factor * spin_factor *
+                            matrix_element * resonance_integral /
+                            (s * cm_momentum());
 
-        /* Calculate resonance production cross section
-         * using the Breit-Wigner distribution as probability amplitude.
-         * Integrate over the allowed resonance mass range. */
-        const double resonance_integral = integrator(*type_res_1, *type_res_2);
-
-        /** Cross section for 2->2 process with 1/2 resonance(s) in final state.
-         * Based on Eq. (46) in \iref{Weil:2013mya} and Eq. (3.29) in
-         * \iref{Bass:1998ca} */
-        const double spin_factor =
-            (type_res_1->spin() + 1) * (type_res_2->spin() + 1);
-        const double xsection = isospin_factor * spin_factor * matrix_element *
-                                resonance_integral / (s * cm_momentum());
-
-        if (xsection > really_small) {
-          channel_list.push_back(make_unique<CollisionBranch>(
-              *type_res_1, *type_res_2, xsection, ProcessType::TwoToTwo));
-          log.debug("Found 2->2 creation process for resonance ", type_res_1,
-                    ", ", type_res_2);
-          log.debug("2->2 with original particles: ", type_particle_a,
-                    type_particle_b);
-        }
-      }
+    if (xsection > really_small) {
+      channel_list.push_back(make_unique<CollisionBranch>(
+          *type_res_1, *type_res_2, xsection, ProcessType::TwoToTwo));
+      log.debug("Found 2->2 creation process for resonance ", type_res_1,
+                ", ", type_res_2);
+      log.debug("2->2 with original particles: ", type_particle_a,
+                type_particle_b);
     }
   }
   return channel_list;
 }
 
-double CrossSections::string_probability(bool strings_switch,
-                                         bool use_transition_probability,
-                                         bool use_AQM,
-                                         bool treat_BBbar_with_strings) const {
-  /* string fragmentation is enabled when strings_switch is on and the process
-   * is included in pythia. */
-  if (!strings_switch) {
-    return 0.;
-  }
-
-  const ParticleType& t1 = incoming_particles_[0].type();
-  const ParticleType& t2 = incoming_particles_[1].type();
+/**
+ * The string-transition classification of a species pair: which of the
+ * pair classes of CrossSections::string_probability it belongs to and
+ * the bounds of its transition window. All of it depends only on the
+ * incoming types, so it is derived once per species pair and cached in
+ * the same thread-local registry fashion as the channel lists; the hot
+ * path reduces to a lookup and comparisons against the window bounds.
+ */
+struct StringTransition {
+  /// Nucleon-nucleon scattering (same antiparticle sign).
+  bool is_NN;
+  /// Nucleon-antinucleon scattering.
+  bool is_NNbar;
+  /// Nucleon-pion scattering.
+  bool is_Npi;
+  /**
+   * Pair class eligible for AQM strings; whether AQM is actually in use
+   * is a runtime switch and applied by the caller.
+   */
+  bool is_AQM_class;
+  /// Energy above which strings set in without the transition algorithm.
+  double threshold;
+  /// Lower bound of the transition window, strings are off below.
+  double region_lower;
+  /// Upper bound of the transition window, only strings above.
+  double region_upper;
+};
 
-  const bool is_NN_scattering =
-      t1.is_nucleon() && t2.is_nucleon() &&
-      t1.antiparticle_sign() == t2.antiparticle_sign();
-  const bool is_BBbar_scattering =
-      (treat_BBbar_with_strings && is_BBbar_pair_ && use_AQM) ||
-      (t1.is_nucleon() && t2.is_nucleon() &&
-       t1.antiparticle_sign() != t2.antiparticle_sign());
-  const bool is_Npi_scattering = (t1.pdgcode().is_pion() && t2.is_nucleon()) ||
-                                 (t1.is_nucleon() && t2.pdgcode().is_pion());
-  /* True for baryon-baryon, anti-baryon-anti-baryon, baryon-meson,
-   * anti-baryon-meson and meson-meson*/
-  const bool is_AQM_scattering =
-      use_AQM && ((t1.is_baryon() && t2.is_baryon() &&
-                   t1.antiparticle_sign() == t2.antiparticle_sign()) ||
-                  ((t1.is_baryon() && t2.is_meson()) ||
-                   (t2.is_baryon() && t1.is_meson())) ||
-                  (t1.is_meson() && t2.is_meson()));
-  const double mass_sum =
-      incoming_particles_[0].pole_mass() + incoming_particles_[1].pole_mass();
-
-  if (!is_NN_scattering && !is_BBbar_scattering && !is_Npi_scattering &&
-      !is_AQM_scattering) {
-    return 0.;
-  } else if (is_BBbar_scattering) {
-    // BBbar only goes through strings, so there are no "window" considerations
-    return 1.;
-  } else {
+/**
+ * Helper function:
+ * \return The cached \ref StringTransition classification of the pair.
+ */
+static const StringTransition& string_transition(const ParticleType& t1,
+                                                 const ParticleType& t2) {
+  static thread_local std::map<std::pair<ParticleTypePtr, ParticleTypePtr>,
+                               StringTransition>
+      transitions;
+  const auto key = std::make_pair(ParticleTypePtr(&t1), ParticleTypePtr(&t2));
+  auto it = transitions.find(key);
+  if (it == transitions.end()) {
+    StringTransition entry;
+    entry.is_NN = t1.is_nucleon() && t2.is_nucleon() &&
+                  t1.antiparticle_sign() == t2.antiparticle_sign();
+    entry.is_NNbar = t1.is_nucleon() && t2.is_nucleon() &&
+                     t1.antiparticle_sign() != t2.antiparticle_sign();
+    entry.is_Npi = (t1.pdgcode().is_pion() && t2.is_nucleon()) ||
+                   (t1.is_nucleon() && t2.pdgcode().is_pion());
+    /* True for baryon-baryon, anti-baryon-anti-baryon, baryon-meson,
+     * anti-baryon-meson and meson-meson*/
+    entry.is_AQM_class = (t1.is_baryon() && t2.is_baryon() &&
+                          t1.antiparticle_sign() == t2.antiparticle_sign()) ||
+                         ((t1.is_baryon() && t2.is_meson()) ||
+                          (t2.is_baryon() && t1.is_meson())) ||
+                         (t1.is_meson() && t2.is_meson());
+    const double mass_sum = t1.mass() + t2.mass();
     /* true for K+ p and K0 p (+ antiparticles), which have special treatment
      * to fit data */
     const PdgCode pdg1 = t1.pdgcode(), pdg2 = t2.pdgcode();
@@ -2628,34 +2760,66 @@ double CrossSections::string_probability(bool strings_switch,
     } else if (pdg1.is_pion() && pdg2.is_pion()) {
       aqm_offset = transit_high_energy::pipi_offset;
     }
-    /* if we do not use the probability transition algorithm, this is always a
-     * string contribution if the energy is large enough */
-    if (!use_transition_probability) {
-      return static_cast<double>(sqrt_s_ > mass_sum + aqm_offset);
-    }
+    entry.threshold = mass_sum + aqm_offset;
     /* No strings at low energy, only strings at high energy and
      * a transition region in the middle. Determine transition region: */
-    double region_lower, region_upper;
-    if (is_Npi_scattering) {
-      region_lower = transit_high_energy::sqrts_range_Npi[0];
-      region_upper = transit_high_energy::sqrts_range_Npi[1];
-    } else if (is_NN_scattering) {
-      region_lower = transit_high_energy::sqrts_range_NN[0];
-      region_upper = transit_high_energy::sqrts_range_NN[1];
+    if (entry.is_Npi) {
+      entry.region_lower = transit_high_energy::sqrts_range_Npi[0];
+      entry.region_upper = transit_high_energy::sqrts_range_Npi[1];
+    } else if (entry.is_NN) {
+      entry.region_lower = transit_high_energy::sqrts_range_NN[0];
+      entry.region_upper = transit_high_energy::sqrts_range_NN[1];
     } else {  // AQM - Additive Quark Model
       /* Transition region around 0.9 larger than the sum of pole masses;
        * highly arbitrary, feel free to improve */
-      region_lower = mass_sum + aqm_offset;
-      region_upper = mass_sum + aqm_offset + transit_high_energy::sqrts_range;
+      entry.region_lower = mass_sum + aqm_offset;
+      entry.region_upper =
+          mass_sum + aqm_offset + transit_high_energy::sqrts_range;
     }
+    it = transitions.emplace(key, entry).first;
+  }
+  return it->second;
+}
 
-    if (sqrt_s_ > region_upper) {
+double CrossSections::string_probability(bool strings_switch,
+                                         bool use_transition_probability,
+                                         bool use_AQM,
+                                         bool treat_BBbar_with_strings) const {
+  /* string fragmentation is enabled when strings_switch is on and the process
+   * is included in pythia. */
+  if (!strings_switch) {
+    return 0.;
+  }
+
+  const ParticleType& t1 = incoming_particles_[0].type();
+  const ParticleType& t2 = incoming_particles_[1].type();
+  const StringTransition& transition = string_transition(t1, t2);
+
+  const bool is_BBbar_scattering =
+      (treat_BBbar_with_strings && is_BBbar_pair_ && use_AQM) ||
+      transition.is_NNbar;
+  const bool is_AQM_scattering = use_AQM && transition.is_AQM_class;
+
+  if (!transition.is_NN && !is_BBbar_scattering && !transition.is_Npi &&
+      !is_AQM_scattering) {
+    return 0.;
+  } else if (is_BBbar_scattering) {
+    // BBbar only goes through strings, so there are no "window" considerations
+    return 1.;
+  } else {
+    /* if we do not use the probability transition algorithm, this is always a
+     * string contribution if the energy is large enough */
+    if (!use_transition_probability) {
+      return static_cast<double>(sqrt_s_ > transition.threshold);
+    }
+    if (sqrt_s_ > transition.region_upper) {
       return 1.;
-    } else if (sqrt_s_ < region_lower) {
+    } else if (sqrt_s_ < transition.region_lower) {
       return 0.;
     } else {
       // Rescale transition region to [-1, 1]
-      return probability_transit_high(region_lower, region_upper);
+      return probability_transit_high(transition.region_lower,
+                                      transition.region_upper);
     }
   }
 }
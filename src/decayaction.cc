@@ -184,12 +184,14 @@ void DecayAction::generate_final_state() {
   }
 
   // Set formation time.
+  const PrecomputedBoost boost_to_comp_frame(
+      -total_momentum_of_outgoing_particles().velocity());
   for (auto &p : outgoing_particles_) {
     log.debug("particle momenta in lrf ", p);
     // assuming decaying particles are always fully formed
     p.set_formation_time(time_of_execution_);
     // Boost to the computational frame
-    p.boost_momentum(-total_momentum_of_outgoing_particles().velocity());
+    p.boost_momentum(boost_to_comp_frame);
     log.debug("particle momenta in comp ", p);
   }
 }
@@ -61,21 +61,20 @@ void DecayActionDilepton::one_to_three() {
   const double dil_mom = pCM(cms_energy, dil_mass, mass_nl);
 
   // Here we assume an isotropic angular distribution.
-  Angles phitheta;
-  phitheta.distribute_isotropically();
+  const ThreeVector dil_dir = random::isotropic_unit_vector();
 
   FourVector dil_4mom(std::sqrt(dil_mass * dil_mass + dil_mom * dil_mom),
-                      phitheta.threevec() * dil_mom);
-  nl.set_4momentum(mass_nl, -phitheta.threevec() * dil_mom);
+                      dil_dir * dil_mom);
+  nl.set_4momentum(mass_nl, -dil_dir * dil_mom);
 
   // perform decay of virtual photon into two leptons
   const double mom_lep = pCM(dil_mass, mass_l1, mass_l2);
 
   // Here we assume an isotropic angular distribution.
-  phitheta.distribute_isotropically();
+  const ThreeVector lep_dir = random::isotropic_unit_vector();
 
-  l1.set_4momentum(mass_l1, phitheta.threevec() * mom_lep);
-  l2.set_4momentum(mass_l2, -phitheta.threevec() * mom_lep);
+  l1.set_4momentum(mass_l1, lep_dir * mom_lep);
+  l2.set_4momentum(mass_l2, -lep_dir * mom_lep);
 
   // Boost Dileptons back in parent particle rest frame
   ThreeVector velocity_CM = dil_4mom.velocity();
@@ -15,26 +15,83 @@
 #include "smash/experimentparameters.h"
 #include "smash/fourvector.h"
 #include "smash/particles.h"
+#include "smash/potential_globals.h"
 #include "smash/random.h"
 
 namespace smash {
 
+void DecayActionsFinder::sample_decay_time_(const ParticleData &p,
+                                            const double t_max,
+                                            ActionList *actions) const {
+  if (p.type().is_stable()) {
+    return;  // particle doesn't decay
+  }
+  /* Scheduling is only enabled without potentials, so the width only
+   * depends on the invariant mass and stays constant until the next
+   * interaction of the particle. */
+  const double width = p.type().total_hadronic_width(p.momentum().abs());
+  if (!(width > 0.0)) {
+    return;
+  }
+  constexpr double one_over_hbarc = 1. / hbarc;
+  double decay_time = random::exponential<double>(
+      /* The clock goes slower in the rest
+       * frame of the resonance */
+      one_over_hbarc * p.inverse_gamma() * width);
+  /* An unformed particle cannot decay; its exponential clock starts at the
+   * formation time. */
+  if (p.formation_time() > p.position().x0()) {
+    decay_time += p.formation_time() - p.position().x0();
+  }
+  if (decay_time < t_max) {
+    auto act = make_unique<DecayAction>(p, decay_time);
+    act->add_decays(p.type().get_partial_widths_hadronic(
+        p.momentum(), p.position().threevec()));
+    actions->emplace_back(std::move(act));
+  } else {
+    /* The decay is not due yet; keep it for the following timesteps
+     * instead of re-rolling it every step. */
+    schedule_.push({p.position().x0() + decay_time, p});
+  }
+}
+
 ActionList DecayActionsFinder::find_actions_in_cell(
-    const ParticleList &search_list, double dt) const {
+    const ParticleSlice &search_list, double dt) const {
   ActionList actions;
   /* for short time steps this seems reasonable to expect
    * less than 10 decays in most time steps */
   actions.reserve(10);
 
+  if (analytic_schedule_) {
+    for (const auto &p : search_list) {
+      sample_decay_time_(p, dt, &actions);
+    }
+    return actions;
+  }
+
   for (const auto &p : search_list) {
     if (p.type().is_stable()) {
       continue;  // particle doesn't decay
     }
 
-    DecayBranchList processes = p.type().get_partial_widths_hadronic(
-        p.momentum(), p.position().threevec());
-    // total decay width (mass-dependent)
-    const double width = total_weight<DecayBranch>(processes);
+    /* Without potentials the in-medium sqrt(s) of every decay mode equals
+     * the invariant mass of the particle, so the total hadronic width
+     * comes from the allocation-free cached evaluation; the branch list is
+     * only built for the rare particles that actually decay within this
+     * time step. */
+    const bool no_potentials = pot_pointer == nullptr &&
+                               UB_lat_pointer == nullptr &&
+                               UI3_lat_pointer == nullptr;
+    DecayBranchList processes;
+    double width;
+    if (no_potentials) {
+      width = p.type().total_hadronic_width(p.momentum().abs());
+    } else {
+      processes = p.type().get_partial_widths_hadronic(
+          p.momentum(), p.position().threevec());
+      // total decay width (mass-dependent)
+      width = total_weight<DecayBranch>(processes);
+    }
 
     // check if there are any (hadronic) decays
     if (!(width > 0.0)) {
@@ -58,6 +115,10 @@ ActionList DecayActionsFinder::find_actions_in_cell(
         (p.formation_time() < (p.position().x0() + decay_time))) {
       /* => decay_time ∈ [0, dt[
        * => the particle decays in this timestep. */
+      if (no_potentials) {
+        processes = p.type().get_partial_widths_hadronic(
+            p.momentum(), p.position().threevec());
+      }
       auto act = make_unique<DecayAction>(p, decay_time);
       act->add_decays(std::move(processes));
       actions.emplace_back(std::move(act));
@@ -66,6 +127,38 @@ ActionList DecayActionsFinder::find_actions_in_cell(
   return actions;
 }
 
+ActionList DecayActionsFinder::find_scheduled_decays(const Particles &particles,
+                                                     const double now,
+                                                     const double t_max) {
+  ActionList actions;
+  if (!schedule_initialized_) {
+    for (const ParticleData &p : particles) {
+      sample_decay_time_(p, now + t_max - p.position().x0(), &actions);
+    }
+    schedule_initialized_ = true;
+  }
+  while (!schedule_.empty() && schedule_.top().time < now + t_max) {
+    const ScheduledDecay &decay = schedule_.top();
+    /* Stale decays are dropped silently: the interaction that invalidated
+     * them also scheduled their replacement. */
+    if (particles.is_valid(decay.incoming)) {
+      const double time_until_decay =
+          decay.time - decay.incoming.position().x0();
+      auto act = make_unique<DecayAction>(decay.incoming, time_until_decay);
+      act->add_decays(decay.incoming.type().get_partial_widths_hadronic(
+          decay.incoming.momentum(), decay.incoming.position().threevec()));
+      actions.emplace_back(std::move(act));
+    }
+    schedule_.pop();
+  }
+  return actions;
+}
+
+void DecayActionsFinder::reset_scheduling() {
+  schedule_ = decltype(schedule_){};
+  schedule_initialized_ = false;
+}
+
 ActionList DecayActionsFinder::find_final_actions(const Particles &search_list,
                                                   bool /*only_res*/) const {
   ActionList actions;
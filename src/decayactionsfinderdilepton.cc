@@ -9,6 +9,9 @@
 
 #include "smash/decayactionsfinderdilepton.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "smash/constants.h"
 #include "smash/cxx14compat.h"
 #include "smash/decayactiondilepton.h"
@@ -24,34 +27,49 @@ void DecayActionsFinderDilepton::shine(const Particles &search_list,
     return;
   }
   for (const auto &p : search_list) {
-    // effective mass of decaying particle
-    const double m_eff = p.effective_mass();
-    const auto n_all_modes = p.type().get_partial_widths(m_eff).size();
-    if (n_all_modes == 0) {
-      continue;
-    }
+    shine_particle(p, output, dt);
+  }
+}
 
-    const double inv_gamma = p.inverse_gamma();
-    DecayBranchList dil_modes = p.type().get_partial_widths_dilepton(m_eff);
+void DecayActionsFinderDilepton::shine_particle(const ParticleData &p,
+                                                OutputInterface *output,
+                                                double dt) const {
+  /* if the particle has no dilepton channels at all or is stable, use
+   * shining only in find_final_actions and ignore it here, also unformed
+   * resonances cannot decay. These checks need no width evaluation, so
+   * they come first. */
+  if (p.type().is_stable() || !p.type().has_dilepton_decays() ||
+      (p.formation_time() > p.position().x0())) {
+    return;
+  }
 
-    /* if particle can only decay into dileptons or is stable, use shining only
-     * in find_final_actions and ignore them here, also unformed
-     * resonances cannot decay */
-    if (dil_modes.size() == n_all_modes || p.type().is_stable() ||
-        (p.formation_time() > p.position().x0())) {
-      continue;
-    }
+  // effective mass of decaying particle
+  const double m_eff = p.effective_mass();
+  const auto &widths = p.type().partial_widths(m_eff);
+  const size_t n_all_modes = std::count_if(
+      widths.begin(), widths.end(), [](const double w) { return w > 0.; });
+  if (n_all_modes == 0) {
+    return;
+  }
 
-    for (DecayBranchPtr &mode : dil_modes) {
-      // SHINING as described in \iref{Schmidt:2008hm}, chapter 2D
-      const double shining_weight = dt * inv_gamma * mode->weight() / hbarc;
+  const double inv_gamma = p.inverse_gamma();
+  DecayBranchList dil_modes = p.type().get_partial_widths_dilepton(m_eff);
 
-      if (shining_weight > 0.0) {  // decays that can happen
-        DecayActionDilepton act(p, 0., shining_weight);
-        act.add_decay(std::move(mode));
-        act.generate_final_state();
-        output->at_interaction(act, 0.0);
-      }
+  // if the particle can only decay into dileptons, shining would double
+  // count against find_final_actions
+  if (dil_modes.size() == n_all_modes) {
+    return;
+  }
+
+  for (DecayBranchPtr &mode : dil_modes) {
+    // SHINING as described in \iref{Schmidt:2008hm}, chapter 2D
+    const double shining_weight = dt * inv_gamma * mode->weight() / hbarc;
+
+    if (shining_weight > 0.0) {  // decays that can happen
+      DecayActionDilepton act(p, 0., shining_weight);
+      act.add_decay(std::move(mode));
+      act.generate_final_state();
+      output->at_interaction(act, 0.0);
     }
   }
 }
@@ -65,7 +83,7 @@ void DecayActionsFinderDilepton::shine_final(const Particles &search_list,
   for (const auto &p : search_list) {
     const ParticleType &t = p.type();
     if (t.decay_modes().decay_mode_list().empty() ||
-        (only_res && t.is_stable())) {
+        (only_res && t.is_stable()) || !t.has_dilepton_decays()) {
       continue;
     }
 
@@ -74,8 +92,8 @@ void DecayActionsFinderDilepton::shine_final(const Particles &search_list,
     DecayBranchList dil_modes = t.get_partial_widths_dilepton(m_eff);
 
     // total decay width, also hadronic decays
-    const double width_tot =
-        total_weight<DecayBranch>(t.get_partial_widths(m_eff));
+    const auto &widths = t.partial_widths(m_eff);
+    const double width_tot = std::accumulate(widths.begin(), widths.end(), 0.);
 
     for (DecayBranchPtr &mode : dil_modes) {
       const double shining_weight = mode->weight() / width_tot;
@@ -9,6 +9,9 @@
 
 #include "smash/decaymodes.h"
 
+#include <cstdint>
+#include <istream>
+#include <ostream>
 #include <vector>
 
 #include "smash/clebschgordan.h"
@@ -491,4 +494,85 @@ void DecayModes::load_decaymodes(const std::string &input) {
   }
 }
 
+void DecayModes::write_decaymodes_cache(std::ostream &output) {
+  const auto ntypes = static_cast<uint32_t>(ParticleType::list_all().size());
+  output.write(reinterpret_cast<const char *>(&ntypes), sizeof(ntypes));
+  for (const DecayModes &modes : *all_decay_modes) {
+    const auto nmodes =
+        static_cast<uint32_t>(modes.decay_mode_list().size());
+    output.write(reinterpret_cast<const char *>(&nmodes), sizeof(nmodes));
+    for (const auto &mode : modes.decay_mode_list()) {
+      const double weight = mode->weight();
+      const int32_t L = mode->angular_momentum();
+      output.write(reinterpret_cast<const char *>(&weight), sizeof(weight));
+      output.write(reinterpret_cast<const char *>(&L), sizeof(L));
+      const auto &types = mode->particle_types();
+      const auto ndaughters = static_cast<uint8_t>(types.size());
+      output.write(reinterpret_cast<const char *>(&ndaughters),
+                   sizeof(ndaughters));
+      for (const auto t : types) {
+        const int32_t pdg = t->pdgcode().get_decimal();
+        output.write(reinterpret_cast<const char *>(&pdg), sizeof(pdg));
+      }
+    }
+  }
+}
+
+bool DecayModes::read_decaymodes_cache(std::istream &input) {
+  /* The cache stores the decay branches per particle type after the
+   * multiplet expansion, the renormalization and the generation of the
+   * anti-multiplets, so replaying them through add_mode rebuilds the
+   * identical decay modes without any of that work. Like in
+   * load_decaymodes, the DecayType vector has to outlive the DecayModes
+   * vector, which references the DecayType objects. */
+  static std::vector<DecayTypePtr> cached_decaytypes;
+  cached_decaytypes.clear();
+  static std::vector<DecayModes> cached_decaymodes;
+  cached_decaymodes.clear();
+
+  const auto &particles = ParticleType::list_all();
+  uint32_t ntypes;
+  input.read(reinterpret_cast<char *>(&ntypes), sizeof(ntypes));
+  if (input.fail() || ntypes != particles.size()) {
+    return false;
+  }
+  cached_decaytypes.reserve(10 * ntypes);
+  all_decay_types = &cached_decaytypes;
+  cached_decaymodes.resize(ntypes);
+  all_decay_modes = &cached_decaymodes;
+  for (uint32_t i = 0; i < ntypes; i++) {
+    uint32_t nmodes;
+    input.read(reinterpret_cast<char *>(&nmodes), sizeof(nmodes));
+    const ParticleTypePtr mother = &particles[i];
+    for (uint32_t m = 0; m < nmodes && !input.fail(); m++) {
+      double weight;
+      int32_t L;
+      uint8_t ndaughters;
+      input.read(reinterpret_cast<char *>(&weight), sizeof(weight));
+      input.read(reinterpret_cast<char *>(&L), sizeof(L));
+      input.read(reinterpret_cast<char *>(&ndaughters), sizeof(ndaughters));
+      ParticleTypePtrList types;
+      types.reserve(ndaughters);
+      for (uint8_t d = 0; d < ndaughters && !input.fail(); d++) {
+        int32_t pdg;
+        input.read(reinterpret_cast<char *>(&pdg), sizeof(pdg));
+        if (!input.fail()) {
+          types.push_back(&ParticleType::find(PdgCode::from_decimal(pdg)));
+        }
+      }
+      if (!input.fail()) {
+        cached_decaymodes[i].add_mode(mother, weight, L, types);
+      }
+    }
+    if (input.fail()) {
+      cached_decaytypes.clear();
+      cached_decaymodes.clear();
+      all_decay_types = nullptr;
+      all_decay_modes = nullptr;
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace smash
@@ -9,17 +9,29 @@
 
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <string>
 
 #include "smash/constants.h"
 #include "smash/cxx14compat.h"
 #include "smash/formfactors.h"
 #include "smash/integrate.h"
+#include "smash/isoparticletype.h"
 #include "smash/kinematics.h"
 #include "smash/pdgcode_constants.h"
 #include "smash/pow.h"
 
 namespace smash {
 
+void DecayType::add_width(double m0, double G0, const std::vector<double> &m,
+                          std::vector<double> &w) const {
+  assert(m.size() == w.size());
+  for (std::size_t i = 0; i < m.size(); i++) {
+    w[i] += width(m0, G0, m[i]);
+  }
+}
+
 // auxiliary functions
 
 static double integrand_rho_Manley_1res(double sqrts, double mass,
@@ -96,6 +108,23 @@ double TwoBodyDecayStable::width(double m0, double G0, double m) const {
   return (m <= threshold()) ? 0. : G0 * rho(m) / rho(m0);
 }
 
+void TwoBodyDecayStable::add_width(double m0, double G0,
+                                   const std::vector<double> &m,
+                                   std::vector<double> &w) const {
+  assert(m.size() == w.size());
+  assert(rho(m0) != 0);
+  const double norm = G0 / rho(m0);
+  const double m_a = particle_types_[0]->mass();
+  const double m_b = particle_types_[1]->mass();
+  /* Same math as the scalar width, but with the per-element branches
+   * replaced by a clamp: below threshold the momentum vanishes and the
+   * width contribution is zero. */
+  for (std::size_t i = 0; i < m.size(); i++) {
+    const double p_ab = std::sqrt(std::max(0., pCM_sqr(m[i], m_a, m_b)));
+    w[i] += norm * p_ab / m[i] * blatt_weisskopf_sqr(p_ab, L_);
+  }
+}
+
 double TwoBodyDecayStable::in_width(double m0, double G0, double m, double,
                                     double) const {
   // in-width = out-width
@@ -144,24 +173,66 @@ double TwoBodyDecaySemistable::get_Lambda() {
 
 // number of tabulation points
 constexpr int num_tab_pts = 200;
-static /*thread_local (see #3075)*/ Integrator integrate;
+/* The width integrands are smooth except for narrow daughter resonances
+ * and the dilepton threshold, for which the fixed rule falls back to the
+ * adaptive algorithm by itself. */
+static thread_local IntegratorGaussLegendre<32> integrate;
+
+/* Protects the lazy initialization of the width tabulations below when
+ * several event threads evaluate widths concurrently. After the tabulation
+ * has been created it is only read, which needs no lock. */
+static std::mutex tabulation_mutex;
+
+/* The width tabulations, owned here and shared between decay types whose
+ * integrands are identical. All charge states of a decay like Δ → Nπ
+ * integrate exactly the same spectral functions, because the particle
+ * properties are isospin-symmetric (the input parser warns when they are
+ * not). Keying the tables by the daughter multiplets instead of the charge
+ * states builds and stores each of them only once. */
+static std::map<std::string, TabulationPtr> width_tabulations;
+
+/**
+ * \return the key of the shared width tabulation of a decay of the given
+ * daughter types \p types with angular momentum \p L.
+ *
+ * Types without a multiplet (e.g. leptons) key on their own name; they
+ * have no isospin partners to share a table with.
+ */
+static std::string tabulation_key(const ParticleTypePtrList &types, int L) {
+  std::string key;
+  for (const ParticleTypePtr t : types) {
+    key += (t->iso_multiplet() != nullptr) ? t->iso_multiplet()->name()
+                                           : t->name();
+    key += ' ';
+  }
+  key += 'L';
+  key += std::to_string(L);
+  return key;
+}
 
 double TwoBodyDecaySemistable::rho(double mass) const {
   if (tabulation_ == nullptr) {
-    /* TODO(weil): Move this lazy init to a global initialization function,
-     * in order to avoid race conditions in multi-threading. */
-    const ParticleTypePtr res = particle_types_[1];
-    const double tabulation_interval = std::max(2., 10. * res->width_at_pole());
-    const double m_stable = particle_types_[0]->mass();
-    const double mres_min = res->min_mass_kinematic();
-
-    tabulation_ = make_unique<Tabulation>(
-        threshold(), tabulation_interval, num_tab_pts, [&](double sqrts) {
-          const double mres_max = sqrts - m_stable;
-          return integrate(mres_min, mres_max, [&](double m) {
-            return integrand_rho_Manley_1res(sqrts, m, m_stable, res, L_);
+    std::lock_guard<std::mutex> guard(tabulation_mutex);
+    if (tabulation_ != nullptr) {
+      return tabulation_->get_value_linear(mass);
+    }
+    TabulationPtr &tab = width_tabulations[tabulation_key(particle_types_, L_)];
+    if (tab == nullptr) {
+      const ParticleTypePtr res = particle_types_[1];
+      const double tabulation_interval =
+          std::max(2., 10. * res->width_at_pole());
+      const double m_stable = particle_types_[0]->mass();
+      const double mres_min = res->min_mass_kinematic();
+
+      tab = make_unique<Tabulation>(
+          threshold(), tabulation_interval, num_tab_pts, [&](double sqrts) {
+            const double mres_max = sqrts - m_stable;
+            return integrate(mres_min, mres_max, [&](double m) {
+              return integrand_rho_Manley_1res(sqrts, m, m_stable, res, L_);
+            });
           });
-        });
+    }
+    tabulation_ = tab.get();
   }
   return tabulation_->get_value_linear(mass);
 }
@@ -198,32 +269,39 @@ double TwoBodyDecayUnstable::get_Lambda() {
   return 0.6;
 }
 
-static /*thread_local*/ Integrator2dCuhre integrate2d(1E7);
+static thread_local Integrator2dCuhre integrate2d(1E7);
 
 double TwoBodyDecayUnstable::rho(double mass) const {
   if (tabulation_ == nullptr) {
-    /* TODO(weil): Move this lazy init to a global initialization function,
-     * in order to avoid race conditions in multi-threading. */
-    const ParticleTypePtr r1 = particle_types_[0];
-    const ParticleTypePtr r2 = particle_types_[1];
-    const double m1_min = r1->min_mass_kinematic();
-    const double m2_min = r2->min_mass_kinematic();
-    const double sum_gamma = r1->width_at_pole() + r2->width_at_pole();
-    const double tab_interval = std::max(2., 10. * sum_gamma);
-
-    tabulation_ = make_unique<Tabulation>(
-        m1_min + m2_min, tab_interval, num_tab_pts, [&](double sqrts) {
-          const double m1_max = sqrts - m2_min;
-          const double m2_max = sqrts - m1_min;
-
-          const double result = integrate2d(m1_min, m1_max, m2_min, m2_max,
-                                            [&](double m1, double m2) {
-                                              return integrand_rho_Manley_2res(
-                                                  sqrts, m1, m2, r1, r2, L_);
-                                            })
-                                    .value();
-          return result;
-        });
+    std::lock_guard<std::mutex> guard(tabulation_mutex);
+    if (tabulation_ != nullptr) {
+      return tabulation_->get_value_linear(mass);
+    }
+    TabulationPtr &tab = width_tabulations[tabulation_key(particle_types_, L_)];
+    if (tab == nullptr) {
+      const ParticleTypePtr r1 = particle_types_[0];
+      const ParticleTypePtr r2 = particle_types_[1];
+      const double m1_min = r1->min_mass_kinematic();
+      const double m2_min = r2->min_mass_kinematic();
+      const double sum_gamma = r1->width_at_pole() + r2->width_at_pole();
+      const double tab_interval = std::max(2., 10. * sum_gamma);
+
+      tab = make_unique<Tabulation>(
+          m1_min + m2_min, tab_interval, num_tab_pts, [&](double sqrts) {
+            const double m1_max = sqrts - m2_min;
+            const double m2_max = sqrts - m1_min;
+
+            const double result =
+                integrate2d(m1_min, m1_max, m2_min, m2_max,
+                            [&](double m1, double m2) {
+                              return integrand_rho_Manley_2res(sqrts, m1, m2,
+                                                               r1, r2, L_);
+                            })
+                    .value();
+            return result;
+          });
+    }
+    tabulation_ = tab.get();
   }
   return tabulation_->get_value_linear(mass);
 }
@@ -431,6 +509,10 @@ double ThreeBodyDecayDilepton::width(double, double G0, double m) const {
   }
 
   if (!tabulation_) {
+    std::lock_guard<std::mutex> guard(tabulation_mutex);
+    if (tabulation_) {
+      return tabulation_->get_value_linear(m, Extrapolation::Const);
+    }
     int non_lepton_position = -1;
     for (int i = 0; i < 3; ++i) {
       if (!particle_types_[i]->is_lepton()) {
@@ -443,24 +525,36 @@ double ThreeBodyDecayDilepton::width(double, double G0, double m) const {
     // mass of non-leptonic particle in final state
     const double m_other = particle_types_[non_lepton_position]->mass();
 
-    // integrate differential width to obtain partial width
-    double M0 = mother_->mass();
-    double G0tot = mother_->width_at_pole();
-    tabulation_ = make_unique<Tabulation>(
-        m_other + 2 * m_l, M0 + 10 * G0tot, num_tab_pts, [&](double m_parent) {
-          const double bottom = 2 * m_l;
-          const double top = m_parent - m_other;
-          if (top < bottom) {  // numerical problems at lower bound
-            return 0.;
-          }
-          return integrate(bottom, top,
-                           [&](double m_dil) {
-                             return diff_width(
-                                 m_parent, m_l, m_dil, m_other,
-                                 particle_types_[non_lepton_position], mother_);
-                           })
-              .value();
-        });
+    /* The shared-table key carries the mother multiplet in addition to the
+     * daughters, since the differential width depends on it. */
+    const std::string mother_key =
+        (mother_->iso_multiplet() != nullptr) ? mother_->iso_multiplet()->name()
+                                              : mother_->name();
+    TabulationPtr &tab = width_tabulations[mother_key + " -> " +
+                                           tabulation_key(particle_types_, L_)];
+    if (tab == nullptr) {
+      // integrate differential width to obtain partial width
+      double M0 = mother_->mass();
+      double G0tot = mother_->width_at_pole();
+      tab = make_unique<Tabulation>(
+          m_other + 2 * m_l, M0 + 10 * G0tot, num_tab_pts,
+          [&](double m_parent) {
+            const double bottom = 2 * m_l;
+            const double top = m_parent - m_other;
+            if (top < bottom) {  // numerical problems at lower bound
+              return 0.;
+            }
+            return integrate(bottom, top,
+                             [&](double m_dil) {
+                               return diff_width(
+                                   m_parent, m_l, m_dil, m_other,
+                                   particle_types_[non_lepton_position],
+                                   mother_);
+                             })
+                .value();
+          });
+    }
+    tabulation_ = tab.get();
   }
 
   return tabulation_->get_value_linear(m, Extrapolation::Const);
@@ -6,8 +6,10 @@
  */
 #include "smash/deformednucleus.h"
 
+#include <array>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include "smash/angles.h"
 #include "smash/configuration.h"
@@ -83,6 +85,10 @@ DeformedNucleus::DeformedNucleus(Configuration &config, int nTest)
   } else {
     set_deformation_parameters_from_config(config);
   }
+  /* Build the sampling tables already here: this way the initialization
+   * time is paid once up front and does not depend on the deformation
+   * parameters of the first sampled event. */
+  ensure_deformed_tables_();
 }
 
 double DeformedNucleus::deformed_woods_saxon(double r, double cosx) const {
@@ -93,27 +99,83 @@ double DeformedNucleus::deformed_woods_saxon(double r, double cosx) const {
                                Nucleus::get_diffusiveness()));
 }
 
-ThreeVector DeformedNucleus::distribute_nucleon() const {
-  double a_radius;
-  Angles a_direction;
+void DeformedNucleus::ensure_deformed_tables_() const {
   // Set a sensible maximum bound for radial sampling.
   double radius_max =
       Nucleus::get_nuclear_radius() / Nucleus::get_diffusiveness() +
       Nucleus::get_nuclear_radius() * Nucleus::get_diffusiveness();
 
-  // Sample the distribution.
-  do {
-    a_direction.distribute_isotropically();
-    // sample r**2 dr
-    a_radius = radius_max * std::cbrt(random::canonical());
-  } while (random::canonical() >
-           deformed_woods_saxon(a_radius, a_direction.costheta()) /
-               Nucleus::get_saturation_density());
+  const std::array<double, 4> parameters = {
+      {Nucleus::get_nuclear_radius(), Nucleus::get_diffusiveness(), beta2_,
+       beta4_}};
+  if (radial_tables_.empty() || parameters != tabulated_parameters_) {
+    build_deformed_tables(radius_max);
+    tabulated_parameters_ = parameters;
+  }
+}
+
+ThreeVector DeformedNucleus::distribute_nucleon() const {
+  ensure_deformed_tables_();
+
+  /* Draw cos(theta) from its marginal and the radius from the conditional
+   * distribution at that angle, interpolating the radial quantile tables
+   * of the two neighboring angular nodes at a common quantile. */
+  const double cosx =
+      interpolate_inverse_cdf(inverse_cdf_costheta_, random::canonical());
+  const double node_position = (cosx + 1.) / 2. * angular_nodes_;
+  size_t node = static_cast<size_t>(node_position);
+  if (node >= angular_nodes_) {
+    node = angular_nodes_ - 1;
+  }
+  const double fraction = node_position - node;
+  const double quantile = random::canonical();
+  const double a_radius =
+      (1. - fraction) * interpolate_inverse_cdf(radial_tables_[node],
+                                                quantile) +
+      fraction * interpolate_inverse_cdf(radial_tables_[node + 1], quantile);
 
   // Update (x, y, z) positions.
+  Angles a_direction(random::uniform(0., twopi), cosx);
   return a_direction.threevec() * a_radius;
 }
 
+constexpr size_t DeformedNucleus::angular_nodes_;
+
+void DeformedNucleus::build_deformed_tables(double radius_max) const {
+  radial_tables_.resize(angular_nodes_ + 1);
+  std::vector<double> weights(angular_nodes_ + 1);
+  for (size_t j = 0; j <= angular_nodes_; ++j) {
+    const double cosx = -1. + 2. * static_cast<double>(j) / angular_nodes_;
+    radial_tables_[j] = build_inverse_cdf(
+        [this, cosx](double r) {
+          return r * r * deformed_woods_saxon(r, cosx);
+        },
+        radius_max, sampling_quantiles_, &weights[j]);
+  }
+  /* The radial integrals at the nodes form the un-normalized marginal of
+   * cos(theta); integrate it with the trapezoidal rule and store the
+   * cosines at equidistant quantiles. */
+  std::vector<double> cdf(angular_nodes_ + 1);
+  cdf[0] = 0.;
+  for (size_t j = 1; j <= angular_nodes_; ++j) {
+    cdf[j] = cdf[j - 1] + 0.5 * (weights[j - 1] + weights[j]);
+  }
+  const double dcos = 2. / angular_nodes_;
+  inverse_cdf_costheta_.assign(sampling_quantiles_ + 1, 0.);
+  inverse_cdf_costheta_[0] = -1.;
+  inverse_cdf_costheta_[sampling_quantiles_] = 1.;
+  size_t j = 1;
+  for (size_t i = 1; i < sampling_quantiles_; ++i) {
+    const double target =
+        cdf[angular_nodes_] * static_cast<double>(i) / sampling_quantiles_;
+    while (cdf[j] < target) {
+      ++j;
+    }
+    const double excess = (target - cdf[j - 1]) / (cdf[j] - cdf[j - 1]);
+    inverse_cdf_costheta_[i] = -1. + (j - 1 + excess) * dcos;
+  }
+}
+
 void DeformedNucleus::set_deformation_parameters_automatic() {
   // Set the deformation parameters extracted from \iref{Moller:1993ed}.
   switch (Nucleus::number_of_particles()) {
@@ -174,9 +236,22 @@ void DeformedNucleus::rotate() {
   }
 }
 
-void DeformedNucleus::generate_fermi_momenta() {
+double DeformedNucleus::nucleon_density(const ThreeVector &pos) const {
+  const double r = pos.abs();
+  if (r < really_small) {
+    return deformed_woods_saxon(0., 1.);
+  }
+  /* Fermi momenta are generated after rotate(), so the symmetry axis of
+   * the deformation is no longer the z axis but the rotated one. */
+  ThreeVector symmetry_axis(0., 0., 1.);
+  symmetry_axis.rotate(nuclear_orientation_.phi(),
+                       nuclear_orientation_.theta(), 0.);
+  return deformed_woods_saxon(r, pos * symmetry_axis / r);
+}
+
+void DeformedNucleus::sample_initial_ensemble(int, bool) {
   throw std::domain_error(
-      "Fermi momenta currently not implemented"
+      "A pre-sampled initial-state ensemble is not supported"
       " for a deformed nucleus.");
 }
 
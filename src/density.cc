@@ -11,6 +11,7 @@
 #include "smash/constants.h"
 #include "smash/logging.h"
 #include "smash/particles.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 
@@ -55,6 +56,48 @@ std::pair<double, ThreeVector> unnormalized_smearing_factor(
   return std::make_pair(sf, sf_grad);
 }
 
+bool unnormalized_smearing_factor_row(
+    const ThreeVector &r0, double dx, int n, const FourVector &p,
+    const double m_inv, const DensityParameters &dens_par,
+    const bool compute_gradient, std::vector<double> &sf,
+    std::vector<ThreeVector> &sf_grad) {
+  const FourVector u = p * m_inv;
+  const ThreeVector u_vec = u.threevec();
+  const double u_r0_scalar = r0 * u_vec;
+  /* The vector from the particle to node k of the row is
+   * r(k) = r0 - k dx e_x, so the Lorentz contracted squared distance
+   * r(k)^2 + (u r(k))^2 is the quadratic a + b k + c k^2. The contracted
+   * distance bounds the plain one from above, hence comparing it against
+   * the cut radius covers both cutoffs of the scalar version. */
+  const double a = r0.sqr() + u_r0_scalar * u_r0_scalar;
+  const double b = -2. * dx * (r0.x1() + u_r0_scalar * u_vec.x1());
+  const double c = dx * dx * (1. + u_vec.x1() * u_vec.x1());
+  const double cut_sqr = dens_par.r_cut_sqr();
+  // Skip the row wholesale if even its closest node is beyond the cut.
+  double k_nearest = -b / (2. * c);
+  k_nearest = std::min(std::max(k_nearest, 0.), static_cast<double>(n - 1));
+  if (a + (b + c * k_nearest) * k_nearest > cut_sqr) {
+    return false;
+  }
+  const double u0 = u.x0();
+  sf.resize(n);
+  for (int k = 0; k < n; k++) {
+    const double r_rest_sqr = a + (b + c * k) * k;
+    sf[k] =
+        r_rest_sqr > cut_sqr ? 0. : dens_par.smearing_exp(r_rest_sqr) * u0;
+  }
+  if (compute_gradient) {
+    const double two_sig_sqr_inv = dens_par.two_sig_sqr_inv();
+    sf_grad.resize(n);
+    for (int k = 0; k < n; k++) {
+      const ThreeVector r(r0.x1() - k * dx, r0.x2(), r0.x3());
+      const double u_r_scalar = r * u_vec;
+      sf_grad[k] = sf[k] * (r + u_vec * u_r_scalar) * two_sig_sqr_inv * 2.0;
+    }
+  }
+  return true;
+}
+
 /// \copydoc smash::rho_eckart
 template <typename /*ParticlesContainer*/ T>
 std::tuple<double, ThreeVector, ThreeVector, ThreeVector> rho_eckart_impl(
@@ -142,6 +185,372 @@ std::tuple<double, ThreeVector, ThreeVector, ThreeVector> rho_eckart(
   return rho_eckart_impl(r, plist, par, dens_type, compute_gradient);
 }
 
+/// \copydoc smash::rho_eckart_batch
+template <typename /*ParticlesContainer*/ T>
+std::vector<double> rho_eckart_batch_impl(
+    const std::vector<ThreeVector> &points, const T &plist,
+    const DensityParameters &par, DensityType dens_type) {
+  /* One pass over the particle list collects the per-particle quantities
+   * that every point needs, so the loops over the points only touch this
+   * compact array instead of re-deriving them per point. */
+  struct Contribution {
+    ThreeVector pos;
+    ThreeVector u_vec;
+    double u0;
+    double dens_factor;
+    FourVector tmp;
+  };
+  std::vector<Contribution> contributions;
+  for (const auto &p : plist) {
+    const double dens_factor = density_factor(p.type(), dens_type);
+    if (std::abs(dens_factor) < really_small) {
+      continue;
+    }
+    const FourVector mom = p.momentum();
+    const double m = mom.abs();
+    if (m < really_small) {
+      continue;
+    }
+    const FourVector u = mom * (1.0 / m);
+    contributions.push_back({p.position().threevec(), u.threevec(), u.x0(),
+                             dens_factor, mom * (dens_factor / mom.x0())});
+  }
+
+  std::vector<double> rho(points.size());
+  const auto evaluate_point = [&](size_t i) {
+    FourVector jmu_pos, jmu_neg;
+    for (const Contribution &c : contributions) {
+      const ThreeVector r = c.pos - points[i];
+      const double r_sqr = r.sqr();
+      /* The Lorentz contracted distance bounds the plain one from above,
+       * so this cheap check rejects most far particles early; both
+       * cutoffs reproduce those of unnormalized_smearing_factor(). */
+      if (r_sqr > par.r_cut_sqr()) {
+        continue;
+      }
+      const double u_r_scalar = r * c.u_vec;
+      const double r_rest_sqr = r_sqr + u_r_scalar * u_r_scalar;
+      if (r_rest_sqr > par.r_cut_sqr()) {
+        continue;
+      }
+      const double sf =
+          std::exp(-r_rest_sqr * par.two_sig_sqr_inv()) * c.u0;
+      if (sf < really_small) {
+        continue;
+      }
+      if (c.dens_factor > 0.) {
+        jmu_pos += c.tmp * sf;
+      } else {
+        jmu_neg += c.tmp * sf;
+      }
+    }
+    rho[i] = (jmu_pos.abs() - jmu_neg.abs()) * par.norm_factor_sf();
+  };
+  /* Every point is summed completely by one task, which makes the
+   * result independent of the thread scheduling. */
+  ThreadPool *const pool = shared_pool();
+  if (pool != nullptr && points.size() > 1) {
+    pool->parallel_range(points.size(), evaluate_point);
+  } else {
+    for (size_t i = 0; i < points.size(); i++) {
+      evaluate_point(i);
+    }
+  }
+  return rho;
+}
+
+std::vector<double> rho_eckart_batch(const std::vector<ThreeVector> &points,
+                                     const ParticleList &plist,
+                                     const DensityParameters &par,
+                                     DensityType dens_type) {
+  return rho_eckart_batch_impl(points, plist, par, dens_type);
+}
+std::vector<double> rho_eckart_batch(const std::vector<ThreeVector> &points,
+                                     const Particles &plist,
+                                     const DensityParameters &par,
+                                     DensityType dens_type) {
+  return rho_eckart_batch_impl(points, plist, par, dens_type);
+}
+
+IncrementalDensityUpdater::IncrementalDensityUpdater(double tolerance)
+    : tolerance_sqr_(tolerance * tolerance) {}
+
+constexpr int IncrementalDensityUpdater::refresh_interval_;
+
+void IncrementalDensityUpdater::deposit(DensityLattice *lat,
+                                        const Footprint &fp, double sign,
+                                        const DensityParameters &par,
+                                        bool compute_gradient) {
+  std::array<int, 3> l_bounds, u_bounds;
+  if (!lat->bounds_in_radius(fp.position, par.r_cut(), l_bounds, u_bounds)) {
+    return;
+  }
+  const double norm_factor = par.norm_factor_sf();
+  const double dx = lat->cell_sizes()[0];
+  const int n_x = u_bounds[0] - l_bounds[0];
+  const FourVector four_velocity = FourVector(1.0, fp.velocity);
+  for (int iz = l_bounds[2]; iz < u_bounds[2]; iz++) {
+    for (int iy = l_bounds[1]; iy < u_bounds[1]; iy++) {
+      const ThreeVector r0 =
+          fp.position - lat->cell_center(l_bounds[0], iy, iz);
+      /* The stored 4-velocity takes the role of the momentum with unit
+       * inverse mass, which reproduces the smearing factors of the
+       * original deposit bit for bit. */
+      if (!unnormalized_smearing_factor_row(r0, dx, n_x, fp.u, 1.0, par,
+                                            compute_gradient, sf_row_,
+                                            sf_grad_row_)) {
+        continue;
+      }
+      lat->iterate_sublattice(
+          {l_bounds[0], iy, iz}, {u_bounds[0], iy + 1, iz + 1},
+          [&](DensityOnLattice &node, int ix, int, int) {
+            dirty_[&node - lat->begin()] = 1;
+            const double sf = sf_row_[ix - l_bounds[0]];
+            if (sf * norm_factor > really_small) {
+              node.add_flow(four_velocity,
+                            sign * sf * norm_factor * fp.dens_factor,
+                            fp.dens_factor);
+            }
+            if (compute_gradient) {
+              node.add_flow_for_derivatives(
+                  four_velocity, sign * fp.dens_factor,
+                  sf_grad_row_[ix - l_bounds[0]] * norm_factor);
+            }
+          });
+    }
+  }
+}
+
+void IncrementalDensityUpdater::update(DensityLattice *lat,
+                                       const LatticeUpdate update,
+                                       const DensityType dens_type,
+                                       const DensityParameters &par,
+                                       const Particles &particles,
+                                       const bool compute_gradient) {
+  // Do not proceed if lattice does not exists/update not required
+  if (lat == nullptr || lat->when_update() != update) {
+    return;
+  }
+  if (footprints_.empty() || updates_since_refresh_ >= refresh_interval_) {
+    /* Full recomputation; record the footprints corresponding to the
+     * deposits that update_lattice() just made. */
+    update_lattice(lat, update, dens_type, par, particles, compute_gradient);
+    dirty_.assign(lat->size(), 1);
+    all_dirty_ = true;
+    footprints_.clear();
+    for (const auto &part : particles) {
+      const double dens_factor = density_factor(part.type(), dens_type);
+      if (std::abs(dens_factor) < really_small) {
+        continue;
+      }
+      const FourVector p = part.momentum();
+      const double m = p.abs();
+      if (unlikely(m < really_small)) {
+        continue;
+      }
+      footprints_[part.id()] = {part.position().threevec(), p * (1.0 / m),
+                                part.velocity(), dens_factor, true};
+    }
+    updates_since_refresh_ = 0;
+    return;
+  }
+  updates_since_refresh_++;
+  /* Only the nodes the deposits below write on become dirty; all others
+   * keep bitwise the same density, see dirty_nodes(). */
+  dirty_.assign(lat->size(), 0);
+  all_dirty_ = false;
+  for (auto &entry : footprints_) {
+    entry.second.seen = false;
+  }
+  for (const auto &part : particles) {
+    const double dens_factor = density_factor(part.type(), dens_type);
+    if (std::abs(dens_factor) < really_small) {
+      continue;
+    }
+    const FourVector p = part.momentum();
+    const double m = p.abs();
+    if (unlikely(m < really_small)) {
+      const auto &log = logger<LogArea::Density>();
+      log.warn("Gaussian smearing is undefined for momentum ", p);
+      continue;
+    }
+    const ThreeVector pos = part.position().threevec();
+    const FourVector u = p * (1.0 / m);
+    const auto it = footprints_.find(part.id());
+    if (it != footprints_.end()) {
+      Footprint &fp = it->second;
+      /* A 4-velocity change du shifts the Lorentz contracted distance by
+       * at most |du| r_cut, so both tests bound the displacement of the
+       * deposited contribution by the configured tolerance. */
+      if ((pos - fp.position).sqr() <= tolerance_sqr_ &&
+          (u.threevec() - fp.u.threevec()).sqr() * par.r_cut_sqr() <=
+              tolerance_sqr_) {
+        fp.seen = true;
+        continue;
+      }
+      deposit(lat, fp, -1., par, compute_gradient);
+    }
+    const Footprint fp = {pos, u, part.velocity(), dens_factor, true};
+    deposit(lat, fp, 1., par, compute_gradient);
+    footprints_[part.id()] = fp;
+  }
+  // Remove the footprints of particles that no longer exist.
+  for (auto it = footprints_.begin(); it != footprints_.end();) {
+    if (!it->second.seen) {
+      deposit(lat, it->second, -1., par, compute_gradient);
+      it = footprints_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+/**
+ * Find the finite-difference neighbors of index \p i along one lattice
+ * axis and the factor the node difference has to be multiplied with to
+ * become the derivative.
+ *
+ * \param[in] i Node index along the axis.
+ * \param[in] n Number of nodes along the axis.
+ * \param[in] h Cell size along the axis [fm].
+ * \param[in] periodic Whether the lattice wraps around.
+ * \param[out] prev Index of the left stencil neighbor.
+ * \param[out] next Index of the right stencil neighbor.
+ * \param[out] deriv_factor Inverse distance between the neighbors
+ *             [fm\f$^{-1}\f$]; zero for a degenerate one-node axis.
+ */
+static void stencil_neighbors(int i, int n, double h, bool periodic, int &prev,
+                              int &next, double &deriv_factor) {
+  prev = i > 0 ? i - 1 : (periodic && n > 1 ? n - 1 : i);
+  next = i < n - 1 ? i + 1 : (periodic && n > 1 ? 0 : i);
+  const int steps = (prev != i ? 1 : 0) + (next != i ? 1 : 0);
+  deriv_factor = steps > 0 ? 1. / (steps * h) : 0.;
+}
+
+void compute_gradients_finite_difference(DensityLattice *lat,
+                                         std::vector<FourVector> &jmu_old,
+                                         double time_interval) {
+  const std::array<int, 3> dims = lat->dimensions();
+  const std::array<double, 3> h = lat->cell_sizes();
+  const int nx = dims[0];
+  const int ny = dims[1];
+  const int nz = dims[2];
+  const bool periodic = lat->periodic();
+  const bool have_old =
+      jmu_old.size() == lat->size() && time_interval > really_small;
+  const double dt_inv = have_old ? 1. / time_interval : 0.;
+  /* Gather the field once; this keeps the stencil reads stride-1 in x and
+   * also becomes the previous-step field of the next call. */
+  std::vector<FourVector> jmu(lat->size());
+  for (size_t i = 0; i < lat->size(); i++) {
+    jmu[i] = (*lat)[i].jmu_net();
+  }
+  auto process_slab = [&](int iz_begin, int iz_end) {
+    for (int iz = iz_begin; iz < iz_end; iz++) {
+      int izm, izp;
+      double dz_factor;
+      stencil_neighbors(iz, nz, h[2], periodic, izm, izp, dz_factor);
+      for (int iy = 0; iy < ny; iy++) {
+        int iym, iyp;
+        double dy_factor;
+        stencil_neighbors(iy, ny, h[1], periodic, iym, iyp, dy_factor);
+        const size_t row = nx * (iy + static_cast<size_t>(ny) * iz);
+        const size_t row_ym = nx * (iym + static_cast<size_t>(ny) * iz);
+        const size_t row_yp = nx * (iyp + static_cast<size_t>(ny) * iz);
+        const size_t row_zm = nx * (iy + static_cast<size_t>(ny) * izm);
+        const size_t row_zp = nx * (iy + static_cast<size_t>(ny) * izp);
+        for (int ix = 0; ix < nx; ix++) {
+          int ixm, ixp;
+          double dx_factor;
+          stencil_neighbors(ix, nx, h[0], periodic, ixm, ixp, dx_factor);
+          const FourVector djmu_dx =
+              (jmu[row + ixp] - jmu[row + ixm]) * dx_factor;
+          const FourVector djmu_dy =
+              (jmu[row_yp + ix] - jmu[row_ym + ix]) * dy_factor;
+          const FourVector djmu_dz =
+              (jmu[row_zp + ix] - jmu[row_zm + ix]) * dz_factor;
+          const FourVector djmu_dt =
+              have_old ? (jmu[row + ix] - jmu_old[row + ix]) * dt_inv
+                       : FourVector();
+          (*lat)[row + ix].overwrite_djmu_dx(djmu_dt, djmu_dx, djmu_dy,
+                                             djmu_dz);
+        }
+      }
+    }
+  };
+  ThreadPool *const pool = shared_pool();
+  if (pool != nullptr && nz > 1) {
+    const int num_slabs = std::min(nz, 4 * pool->num_threads());
+    const int slab_height = (nz + num_slabs - 1) / num_slabs;
+    pool->parallel_range(num_slabs, [&](size_t s) {
+      const int begin = static_cast<int>(s) * slab_height;
+      process_slab(begin, std::min(nz, begin + slab_height));
+    });
+  } else {
+    process_slab(0, nz);
+  }
+  jmu_old = std::move(jmu);
+}
+
+void fill_lattice_from_rigid_snapshots(DensityLattice *lat,
+                                       const DensityLattice &snap_projectile,
+                                       double shift_projectile,
+                                       const DensityLattice &snap_target,
+                                       double shift_target) {
+  const std::array<int, 3> dims = lat->dimensions();
+  const int nx = dims[0];
+  const int ny = dims[1];
+  const int nz = dims[2];
+  auto process_slab = [&](int iz_begin, int iz_end) {
+    std::array<std::size_t, 8> indices;
+    std::array<double, 8> weights;
+    for (int iz = iz_begin; iz < iz_end; iz++) {
+      for (int iy = 0; iy < ny; iy++) {
+        for (int ix = 0; ix < nx; ix++) {
+          const size_t i = ix + nx * (iy + static_cast<size_t>(ny) * iz);
+          const ThreeVector r = lat->cell_center(ix, iy, iz);
+          DensityOnLattice node;
+          std::array<FourVector, 4> deriv;
+          for (int nucleus = 0; nucleus < 2; nucleus++) {
+            const DensityLattice &snap =
+                nucleus == 0 ? snap_projectile : snap_target;
+            const double shift =
+                nucleus == 0 ? shift_projectile : shift_target;
+            const ThreeVector r_shifted(r.x1(), r.x2(), r.x3() - shift);
+            if (!snap.interpolation_nodes(r_shifted, indices, weights)) {
+              continue;
+            }
+            FourVector jmu_pos, jmu_neg;
+            for (int c = 0; c < 8; c++) {
+              const DensityOnLattice &corner = snap[indices[c]];
+              jmu_pos += corner.jmu_pos() * weights[c];
+              jmu_neg += corner.jmu_neg() * weights[c];
+              for (int k = 0; k < 4; k++) {
+                deriv[k] += corner.djmu_dx()[k] * weights[c];
+              }
+            }
+            node.add_flow(jmu_pos, 1.0, 1.0);
+            node.add_flow(jmu_neg, 1.0, -1.0);
+          }
+          node.overwrite_djmu_dx(deriv[0], deriv[1], deriv[2], deriv[3]);
+          (*lat)[i] = node;
+        }
+      }
+    }
+  };
+  ThreadPool *const pool = shared_pool();
+  if (pool != nullptr && nz > 1) {
+    const int num_slabs = std::min(nz, 4 * pool->num_threads());
+    const int slab_height = (nz + num_slabs - 1) / num_slabs;
+    pool->parallel_range(num_slabs, [&](size_t s) {
+      const int begin = static_cast<int>(s) * slab_height;
+      process_slab(begin, std::min(nz, begin + slab_height));
+    });
+  } else {
+    process_slab(0, nz);
+  }
+}
+
 std::ostream &operator<<(std::ostream &os, DensityType dens_type) {
   switch (dens_type) {
     case DensityType::Hadron:
@@ -0,0 +1,171 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/digestoutput.h"
+
+#include <cinttypes>
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+
+#include "smash/action.h"
+#include "smash/config.h"
+#include "smash/particles.h"
+
+namespace smash {
+namespace {
+
+/**
+ * Scramble a 64-bit value (the finalizer of the splitmix64 generator).
+ *
+ * Every input bit affects every output bit, so hashes of similar particles
+ * do not cancel when they are summed up.
+ *
+ * \param[in] x The value to scramble.
+ * \return the scrambled value.
+ */
+std::uint64_t mix(std::uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+/**
+ * Fold the bit pattern of a double into a hash.
+ *
+ * Using the bit pattern instead of a rounded value makes the digest
+ * sensitive to any numerical difference, which is exactly what comparing
+ * two runs is supposed to detect.
+ *
+ * \param[in] h The hash so far.
+ * \param[in] value The value to fold in.
+ * \return the updated hash.
+ */
+std::uint64_t fold_double(std::uint64_t h, double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return mix(h ^ bits);
+}
+
+/**
+ * \param[in] p The particle to hash.
+ * \return a hash of the species, position and momentum of the particle.
+ *
+ * The particle id is deliberately not part of the hash: ids depend on the
+ * order particles were created in, which may differ between a serial and a
+ * parallel run of the same physics.
+ */
+std::uint64_t hash_particle(const ParticleData &p) {
+  std::uint64_t h = mix(static_cast<std::uint32_t>(p.pdgcode().code()));
+  const FourVector r = p.position();
+  const FourVector m = p.momentum();
+  h = fold_double(h, r.x0());
+  h = fold_double(h, r.x1());
+  h = fold_double(h, r.x2());
+  h = fold_double(h, r.x3());
+  h = fold_double(h, m.x0());
+  h = fold_double(h, m.x1());
+  h = fold_double(h, m.x2());
+  h = fold_double(h, m.x3());
+  return h;
+}
+
+}  // unnamed namespace
+
+/*!\Userguide
+ * \page digest_output_user_guide_ ASCII Digest Output
+ *
+ * The digest output (digest.dat) condenses every event into one line of
+ * 64-bit hashes, so that two runs can be verified to have gone through the
+ * same physics without storing their full outputs. Typical uses are
+ * comparing a serial against a parallel run or a run before against a run
+ * after an optimization, over arbitrarily many events.
+ *
+ * The file has a two-line header
+ * \code
+ * # **smash_version** digest output
+ * # event n_particles particles_digest n_actions actions_digest
+ * \endcode
+ * followed by one line per event with the columns
+ * \li \key event: Event number
+ * \li \key n_particles: Number of particles in the final state
+ * \li \key particles_digest: Hash of the final particle list (16 hex digits)
+ * \li \key n_actions: Number of performed interactions; 0 unless
+ *     \key Hash_Collisions is enabled
+ * \li \key actions_digest: Hash of all performed interactions (16 hex
+ *     digits); 0 unless \key Hash_Collisions is enabled
+ *
+ * Each particle is hashed over its PDG code and the full bit patterns of
+ * its position and momentum four-vectors; each interaction additionally
+ * over its process type. The per-particle and per-interaction hashes are
+ * combined by addition, so the digests do not depend on the order in which
+ * particles are stored or interactions are found. Particle ids are not
+ * hashed, since they depend on that order.
+ *
+ * Two runs with equal digests evolved the same events; a differing line
+ * immediately names the first event that deviated. Note that equal digests
+ * require the same random seed and the same number of events per run.
+ */
+
+DigestOutput::DigestOutput(const bf::path &path, const std::string &name,
+                           const OutputParameters &out_par)
+    : OutputInterface(name),
+      file_{out_par.shard_path(path, "digest.dat"), "w"},
+      hash_collisions_(out_par.digest_collisions) {
+  std::fprintf(file_.get(), "# %s digest output\n", VERSION_MAJOR);
+  std::fprintf(file_.get(),
+               "# event n_particles particles_digest n_actions"
+               " actions_digest\n");
+}
+
+void DigestOutput::at_eventstart(const Particles &, const int) {
+  actions_digest_ = 0;
+  actions_count_ = 0;
+}
+
+void DigestOutput::at_eventend(const Particles &particles,
+                               const int event_number, double) {
+  std::uint64_t digest = 0;
+  for (const ParticleData &p : particles) {
+    digest += hash_particle(p);
+  }
+  std::fprintf(file_.get(),
+               "%i %zu %016" PRIx64 " %" PRIu64 " %016" PRIx64 "\n",
+               event_number, particles.size(), digest, actions_count_,
+               actions_digest_);
+  /* Flush after every event, so interrupted runs still leave comparable
+   * digests of their completed events behind. */
+  std::fflush(file_.get());
+}
+
+void DigestOutput::at_interaction(const Action &action, const double) {
+  if (!hash_collisions_) {
+    return;
+  }
+  /* The two sides of the interaction are summed separately before they are
+   * folded in, so swapping two incoming particles (which a parallel search
+   * may do) does not change the hash, but moving a particle from the
+   * incoming to the outgoing side does. */
+  std::uint64_t incoming = 0;
+  for (const ParticleData &p : action.incoming_particles()) {
+    incoming += hash_particle(p);
+  }
+  std::uint64_t outgoing = 0;
+  for (const ParticleData &p : action.outgoing_particles()) {
+    outgoing += hash_particle(p);
+  }
+  std::uint64_t h = mix(static_cast<std::uint32_t>(action.get_type()));
+  h = mix(h ^ incoming);
+  h = mix(h ^ outgoing);
+  actions_digest_ += h;
+  ++actions_count_;
+}
+
+}  // namespace smash
@@ -248,6 +248,67 @@ double sample_momenta_from_thermal(const double temperature,
   return momentum_radial;
 }
 
+ThermalMomentumSampler::ThermalMomentumSampler(const double mass,
+                                               const double temperature)
+    : mass_(mass), temperature_(temperature) {
+  /* Cut the tabulated interval where the Boltzmann factor has dropped to
+   * e^-40 of its value at p = 0; the tail beyond carries less weight than
+   * the resolution of a single uniform random number. */
+  const double kinetic_max = 40. * temperature;
+  const double p_max = std::sqrt(kinetic_max * (kinetic_max + 2. * mass));
+  /* The grid has to be uniform in the momentum, not in the quantile: a
+   * quantile grid cannot resolve the exponential tail and visibly biases
+   * the second moment. */
+  constexpr size_t n_grid = 1 << 14;
+  dp_ = p_max / n_grid;
+  /* Integrate p^2 exp(-(E - m)/T) with the trapezoidal rule; the
+   * constant factor exp(-m/T) is irrelevant for sampling and would
+   * underflow for heavy species. */
+  const auto density = [&](const double p) {
+    return p * p *
+           std::exp((mass - std::sqrt(p * p + mass * mass)) / temperature);
+  };
+  cdf_.resize(n_grid + 1);
+  cdf_[0] = 0.;
+  double previous = density(0.);
+  for (size_t i = 1; i <= n_grid; ++i) {
+    const double current = density(i * dp_);
+    cdf_[i] = cdf_[i - 1] + 0.5 * (previous + current) * dp_;
+    previous = current;
+  }
+  const double norm = 1. / cdf_[n_grid];
+  for (double &c : cdf_) {
+    c *= norm;
+  }
+  cdf_[n_grid] = 1.;
+  /* For every equidistant quantile, store the first grid index whose CDF
+   * value is not below it, so that sample() only has to scan the few
+   * entries of one guide cell. */
+  guide_.resize(n_grid + 1);
+  size_t j = 1;
+  for (size_t k = 0; k <= n_grid; ++k) {
+    const double target = static_cast<double>(k) / n_grid;
+    while (cdf_[j] < target) {
+      ++j;
+    }
+    guide_[k] = j;
+  }
+}
+
+double ThermalMomentumSampler::sample() const {
+  const double u = random::canonical();
+  size_t j = guide_[static_cast<size_t>(u * (guide_.size() - 1))];
+  while (cdf_[j] < u) {
+    ++j;
+  }
+  /* Interpolate linearly inside the grid cell; in the far tail the CDF
+   * may be flat to machine precision, in which case the cell border is
+   * as good an answer as any. */
+  const double width = cdf_[j] - cdf_[j - 1];
+  const double fraction = width > 0. ? (u - cdf_[j - 1]) / width : 0.;
+  return (j - 1 + fraction) * dp_;
+}
+
 double sample_momenta_IC_ES(const double temperature) {
   double momentum_radial;
   const double a = -std::log(random::canonical_nonzero());
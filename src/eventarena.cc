@@ -0,0 +1,128 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/eventarena.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "smash/memorystats.h"
+
+namespace smash {
+
+namespace {
+
+/// Default size of one arena chunk.
+constexpr std::size_t arena_chunk_size = 1024 * 1024;
+
+/// All allocations are rounded to this, which keeps them suitably aligned.
+constexpr std::size_t arena_alignment = alignof(max_align_t);
+
+/// One contiguous block of arena memory.
+struct ArenaChunk {
+  /// The backing memory.
+  std::unique_ptr<char[]> memory;
+  /// Size of the backing memory.
+  std::size_t size;
+};
+
+/// The arena of one thread.
+struct ThreadArena {
+  /// The retained chunks, in the order they are bumped through.
+  std::vector<ArenaChunk> chunks;
+  /// Index of the chunk allocations are currently served from.
+  std::size_t current_chunk = 0;
+  /// Bytes used in the current chunk.
+  std::size_t used = 0;
+  /// Whether this arena is already in the reset registry.
+  bool registered = false;
+
+  ~ThreadArena();
+};
+
+/// Guards the registry of the per-thread arenas.
+std::mutex arena_registry_mutex;
+
+/// The arenas of all threads that allocated so far, for reset().
+std::vector<ThreadArena *> arena_registry;
+
+/// The arena of this thread.
+thread_local ThreadArena thread_arena;
+
+ThreadArena::~ThreadArena() {
+  if (!registered) {
+    return;
+  }
+  std::size_t total = 0;
+  for (const ArenaChunk &chunk : chunks) {
+    total += chunk.size;
+  }
+  MemoryStats::deallocate(MemoryStats::Category::EventArena, total);
+  std::lock_guard<std::mutex> guard(arena_registry_mutex);
+  arena_registry.erase(
+      std::remove(arena_registry.begin(), arena_registry.end(), this),
+      arena_registry.end());
+}
+
+}  // unnamed namespace
+
+void *EventArena::allocate(std::size_t bytes) {
+  ThreadArena &arena = thread_arena;
+  bytes = (bytes + arena_alignment - 1) / arena_alignment * arena_alignment;
+  while (true) {
+    if (arena.current_chunk == arena.chunks.size()) {
+      const std::size_t size = std::max(arena_chunk_size, bytes);
+      arena.chunks.push_back(
+          {std::unique_ptr<char[]>(new char[size]), size});
+      arena.used = 0;
+      MemoryStats::allocate(MemoryStats::Category::EventArena, size);
+      if (!arena.registered) {
+        arena.registered = true;
+        std::lock_guard<std::mutex> guard(arena_registry_mutex);
+        arena_registry.push_back(&arena);
+      }
+    }
+    ArenaChunk &chunk = arena.chunks[arena.current_chunk];
+    if (chunk.size - arena.used >= bytes) {
+      char *memory = chunk.memory.get() + arena.used;
+      arena.used += bytes;
+      return memory;
+    }
+    /* The current chunk is exhausted; move on to the next retained one
+     * (or fall through to allocating a new one at the end). */
+    ++arena.current_chunk;
+    arena.used = 0;
+  }
+}
+
+void EventArena::deallocate(void *ptr, std::size_t bytes) {
+  ThreadArena &arena = thread_arena;
+  bytes = (bytes + arena_alignment - 1) / arena_alignment * arena_alignment;
+  if (arena.current_chunk < arena.chunks.size()) {
+    const ArenaChunk &chunk = arena.chunks[arena.current_chunk];
+    if (static_cast<char *>(ptr) + bytes == chunk.memory.get() + arena.used) {
+      arena.used -= bytes;
+    }
+  }
+  /* Anything else stays occupied until the next reset(). This only loses
+   * memory for out-of-order frees within one event, e.g. the discarded
+   * smaller buffer when a container grows. */
+}
+
+void EventArena::reset() {
+  std::lock_guard<std::mutex> guard(arena_registry_mutex);
+  for (ThreadArena *arena : arena_registry) {
+    arena->current_chunk = 0;
+    arena->used = 0;
+  }
+}
+
+}  // namespace smash
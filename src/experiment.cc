@@ -73,12 +73,43 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  * \key Testparticles (int, optional, default = 1): \n
  * How many test particles per real particle should be simulated.
  *
+ * \key Ensembles (int, optional, default = 1): \n
+ * Number of parallel ensembles. Each ensemble is an independent physical
+ * event - the initial state is sampled anew for every ensemble and
+ * particles only ever collide with particles of their own ensemble - but
+ * all ensembles contribute to one shared mean-field lattice, normalized by
+ * the ensemble number. Compared to an equal number of test particles this
+ * gives the same field quality without diluting the cross sections:
+ * cross-ensemble pairs are rejected by a plain index comparison before any
+ * kinematics, instead of being carried through 1/N-scaled collision
+ * criteria. The outputs write the particles of all ensembles of an event
+ * together, so per-event observables beyond single-particle spectra mix
+ * ensembles. Not compatible with \key Forced_Thermalization.
+ *
  * \key Gaussian_Sigma (double, optional, default = 1.0): \n
  * Width of gaussians that represent Wigner density of particles, in fm.
  *
  * \key Gauss_Cutoff_In_Sigma (double, optional, default = 4.0): \n
  * Distance in sigma at which gaussian is considered 0.
  *
+ * \key Parallelism (int, optional, default = 1): \n
+ * Number of worker threads of the shared thread pool. All parallel work
+ * inside one event (e.g. the collision search over grid cells) is submitted
+ * to this single pool, so this one key controls how many cores the process
+ * uses in addition to the main thread. Parallel results are merged in a
+ * fixed order, so they stay reproducible for a given random seed. The
+ * default of 1 keeps everything serial.
+ *
+ * \key Tabulation_Cache_Path (string, optional, default = ""): \n
+ * Directory in which the resonance integral tabulations and the parsed
+ * particle and decay tables are cached on disk.
+ * The tables only depend on the particle and decay-mode descriptions, so
+ * with a cache configured only the first run with a given input has to
+ * parse and integrate; all later runs read the tables back instead. The
+ * cache is keyed on a digest of the particle and decay-mode content and
+ * may safely be shared between concurrent runs. An empty path (the
+ * default) disables caching.
+ *
  * \page input_output_options_ Output Configuration
  *
  * Description of options
@@ -94,6 +125,23 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  * system in Standard Output and other output formats which support this
  * functionality.
  *
+ * \key Interval_Scaling (double, optional, default = 1.0): \n
+ * Factor by which the interval between two intermediate outputs grows after
+ * every output. With the default of 1.0 the outputs stay equally spaced by
+ * \key Output_Interval; larger values give geometrically (log-) spaced
+ * output times, which resolve the dense early stage of the reaction finely
+ * without flooding the dilute late stage with nearly identical snapshots.
+ * The interval restarts from \key Output_Interval for every event.
+ *
+ * \key Density_Trigger (list of doubles, optional, no default): \n
+ * Net baryon densities in fm\f$^{-3}\f$ at which an extra snapshot of the
+ * particles is written, independently of the regular output times. Each
+ * threshold fires at most once per event, namely on the first timestep
+ * whose maximal net baryon density on the lattice reaches it. This
+ * requires a configured lattice (see \ref input_lattice_); when Skyrme
+ * potentials are active their baryon density lattice is reused, otherwise
+ * a dedicated lattice is evaluated once per timestep.
+ *
  * \key Density_Type (string, optional, default = "none"): \n
  * Determines which kind of density is printed into the headers of the
  * collision files.
@@ -104,6 +152,18 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  * \li \key "pion" - Pion density
  * \li \key "none" - Do not calculate density, print 0.0
  *
+ * \key Shard_Suffix (string, optional, default = ""): \n
+ * Suffix inserted in front of the file extension of every output file, e.g.
+ * with \key Shard_Suffix: "part3" the particles output is written to
+ * \c particle_lists.part3.oscar. This allows several SMASH instances to
+ * write into the same output directory concurrently without locking: give
+ * every instance its own suffix and it creates its own shard of every
+ * output file, its own lock file and its own configuration copy. Each
+ * instance additionally writes a manifest file
+ * (\c shards.<suffix>.manifest) that lists the output files it created, so
+ * analysis scripts can enumerate the shards. The VTK output is not
+ * sharded, since its file names are built from event and output counters.
+ *
  * \n
  * ### Format configuration independently of the specific output content
  * Further options are defined for every single output content
@@ -134,6 +194,35 @@ ExperimentPtr ExperimentBase::create(Configuration config,
                       VTK format): \n
  *   \li \key true - Print only final particle list \n
  *   \li \key false - Particle list at output interval including initial time \n
+ *
+ *   \key VTK_Binary (bool, optional, default = false, only affects the
+ *                    VTK format): \n
+ *   \li \key true - Write the VTK data sections in the binary encoding of the
+ *       legacy VTK format (smaller files, faster to write and to load) \n
+ *   \li \key false - Write human-readable ASCII VTK files \n
+ *
+ *   \key PDG_Codes (list of PDG codes, optional, default = all): \n
+ *   If given, only particles of the listed species are written to the
+ *   particles output.
+ *
+ *   \key Rapidity_Window (list of 2 doubles, optional, default = no cut): \n
+ *   If given, only particles with rapidity y inside [y_min, y_max] are
+ *   written to the particles output.
+ *
+ *   \key PT_Window (list of 2 doubles, optional, default = no cut): \n
+ *   If given, only particles with transverse momentum inside
+ *   [pT_min, pT_max] (in GeV) are written to the particles output.
+ *
+ *   The three content filters apply to the Oscar and binary particles
+ *   output and reduce the written data volume accordingly; the block
+ *   headers contain the number of particles that passed the filters. The
+ *   collision, VTK and Root outputs are not affected. \n
+ *
+ *   \key Cadence (int, optional, default = 1): \n
+ *   Write the particle list only at every this many-th intermediate output
+ *   time (counted per event, starting at the first one). This decimates
+ *   the particles output relative to the other output contents, which keep
+ *   the full \key Output_Interval frequency. \n
  * \n
  * - \b Collisions (VTK not available) \n
  *   \key Extended (bool, optional, default = false, incompatible with
@@ -145,6 +234,33 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  *                  Root format): \n
  *   \li \key true - Initial and final particle list is printed out \n
  *   \li \key false - Initial and final particle list is not printed out \n
+ *
+ *   \key Process_Types (list of ints, optional, default = all): \n
+ *   If given, only interactions whose numeric process type (the
+ *   process_type field of the output, see \ref format_binary_) is in the
+ *   list are written to the binary collisions output.
+ *
+ *   \key Sqrts_Window (list of 2 doubles, optional, default = no cut): \n
+ *   If given, only interactions with \f$\sqrt{s}\f$ of the incoming
+ *   particles inside [min, max] (in GeV) are written to the binary
+ *   collisions output.
+ *
+ *   \key Elastic_Prescale (int, optional, default = 1): \n
+ *   Write only every N-th elastic scattering to the binary collisions
+ *   output; all other process types are always written. Elastic
+ *   scatterings usually dominate the collision history by number while
+ *   carrying the least information per entry, so a prescale of e.g. 10
+ *   shrinks the file almost tenfold. The prescale counts
+ *   deterministically and therefore does not disturb the random number
+ *   stream of the simulation.
+ *
+ *   \key Buffer_Limit (int, optional, default = 64): \n
+ *   Size in MiB at which the in-memory buffer of the binary collisions
+ *   output is handed over to the asynchronous writer thread within an
+ *   event. This bounds the memory of collision-heavy events: when the
+ *   writer cannot keep up with the simulation, the simulation waits
+ *   instead of buffering ever more data. 0 removes the limit, buffering
+ *   a whole event like the other outputs do. \n
  * \n
  * - \b Dileptons (Only Oscar1999, Oscar2013 and binary formats) \n
  *   \key Extended (bool, optional, default = false, incompatible with
@@ -152,7 +268,9 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  *   \li \key true - Print extended information for each particle \n
  *   \li \key false - Regular output for each particle \n
  * \n
- * - \b Photons (Only Oscar1999, Oscar2013 and binary formats) \n
+ * - \b Photons (Only Oscar1999, Oscar2013 and binary formats; the
+ *   additional "Binary_Compact" format writes a dedicated per-event
+ *   buffered, weight-compacted photon file, see \ref format_binary_) \n
  *   \key Fractions (int, required):
  *   Number of fractional photons sampled per single perturbatively produced
  *   photon. See \ref input_photons for further information. \n
@@ -168,6 +286,11 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  *       a lattice. This lattice needs to be enabled in the conguration file
  *       and is regulated by the options of \ref input_lattice_. See
  *       \ref output_vtk_lattice_ for further information.
+ *   \li On the spatial lattice to a streaming binary file, with one packed
+ *       float32 frame appended per output moment. Only the Eckart density
+ *       is supported. This output also requires a lattice, see
+ *       \ref input_lattice_ and \ref thermodyn_lattice_binary_ for further
+ *       information.
  *   \li At a given point to ASCII output. See
  *       \ref thermodyn_output_user_guide_ for further information.
  *   \li Averaged over all particles to ASCII output. See
@@ -211,6 +334,78 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  *   energy-momentum tensor of all particles in a box with weights = 1, which
  *   would correspond to \key "Smearing: false".
  *
+ *   \key VTK_Binary (bool, optional, default = false, only affects the
+ *                    VTK format): \n
+ *   \li \key true - Write the lattice data sections in the binary encoding of
+ *       the legacy VTK format (full double precision, smaller files) \n
+ *   \li \key false - Write human-readable ASCII VTK files \n
+ *
+ *   \key Cadence (int, optional, default = 1): \n
+ *   Evaluate and write the thermodynamic quantities only at every this
+ *   many-th intermediate output time (counted per event, starting at the
+ *   first one). Since the lattice evaluation traverses all particles, this
+ *   also skips its computational cost on the intermediate outputs. \n
+ *
+ *   \key Region_Min (list of 3 doubles, optional, default = unbounded): \n
+ *   \key Region_Max (list of 3 doubles, optional, default = unbounded): \n
+ *   Region of interest of the lattice outputs in fm: only lattice nodes
+ *   with coordinates between \key Region_Min and \key Region_Max along
+ *   every axis are written, e.g. a central slab via
+ *   "Region_Min: [-20.0, -20.0, -0.5], Region_Max: [20.0, 20.0, 0.5]".
+ *   The lattice itself is unaffected; pointlike thermodynamic output
+ *   (the ASCII format) ignores these keys. \n
+ *
+ *   \key Stride (int, optional, default = 1): \n
+ *   Downsampling stride of the lattice outputs: blocks of \key Stride^3
+ *   lattice nodes within the region of interest are averaged into one
+ *   written node, reducing the output volume by \key Stride^3. \n
+ * \n
+ * - \b Digest (Only ASCII format, see \ref digest_output_user_guide_) \n
+ *   \key Hash_Collisions (bool, optional, default = false): \n
+ *   \li \key true - Hash every performed interaction into the per-event
+ *       digest as well \n
+ *   \li \key false - Only the final particle list is hashed \n
+ * \n
+ * - \b Spectra (Only ASCII format, see \ref spectra_output_user_guide_) \n
+ *   \key PDGs (list of PDG codes, required): \n
+ *   Species the spectra are accumulated for; every species gets one
+ *   histogram per axis. \n
+ *
+ *   \key Axes (list of strings, optional, default = ["pT", "y"]): \n
+ *   Histogrammed kinematic variables; valid axes are "pT", "y", "mT"
+ *   (transverse mass minus the pole mass) and "phi". \n
+ *
+ *   \key Bins (int, optional, default = 50): \n
+ *   Number of bins of every histogram. \n
+ *
+ *   \key PT_Max (double, optional, default = 4.0): \n
+ *   Upper edge in GeV of the "pT" and "mT" axes, which start at 0. \n
+ *
+ *   \key Y_Max (double, optional, default = 4.0): \n
+ *   The rapidity axis covers [-Y_Max, Y_Max]; the "phi" axis always
+ *   covers \f$[-\pi, \pi]\f$. \n
+ * \n
+ * - \b Root (optional section, tunes the buffering of all ROOT outputs) \n
+ *   \key Autoflush (int, optional, default = 0): \n
+ *   AutoFlush setting of the ROOT trees. A positive value flushes the
+ *   baskets to disk every that many tree entries, a negative value every
+ *   that many bytes; 0 keeps the ROOT default. Larger (absolute) values
+ *   batch more data per write, which helps on network file systems.
+ *
+ *   \key Basket_Size (int, optional, default = 0): \n
+ *   Basket size in bytes of all tree branches; 0 keeps the ROOT default.
+ *
+ *   \key Compression (string, optional, default = "ZLIB"): \n
+ *   Compression algorithm of the ROOT files; "ZLIB", "LZMA" or "LZ4".
+ *
+ *   \key Compression_Level (int, optional, default = -1): \n
+ *   Compression level (0 - 9) of the ROOT files; -1 keeps the ROOT default.
+ *
+ *   \key Autosave_Frequency (int, optional, default = 1000): \n
+ *   AutoSave the trees every this many events, so a crashed run leaves a
+ *   readable file. AutoSave is expensive, the value is a compromise between
+ *   safety and speed.
+ *
  * \n
  * \page configuring_output_ Output Configuration
  * Example: Configuring the SMASH Output
@@ -275,6 +470,11 @@ ExperimentParameters create_experiment_parameters(Configuration config) {
     throw std::invalid_argument("Testparticle number should be positive!");
   }
 
+  const int n_ensembles = config.take({"General", "Ensembles"}, 1);
+  if (n_ensembles <= 0) {
+    throw std::invalid_argument("Ensemble number should be positive!");
+  }
+
   const std::string modus_chooser = config.take({"General", "Modus"});
   // remove config maps of unused Modi
   config["Modi"].remove_all_but(modus_chooser);
@@ -302,6 +502,7 @@ ExperimentParameters create_experiment_parameters(Configuration config) {
   return {{0., dt},
           {0.0, output_dt},
           ntest,
+          n_ensembles,
           config.take({"General", "Gaussian_Sigma"}, 1.),
           config.take({"General", "Gauss_Cutoff_In_Sigma"}, 4.),
           config_coll.take({"Two_to_One"}, true),
@@ -316,12 +517,12 @@ ExperimentParameters create_experiment_parameters(Configuration config) {
 }
 
 std::string format_measurements(const Particles &particles,
+                                const QuantumNumbers &current_values,
                                 uint64_t scatterings_this_interval,
                                 const QuantumNumbers &conserved_initial,
                                 SystemTimePoint time_start, double time) {
   const SystemTimeSpan elapsed_seconds = SystemClock::now() - time_start;
 
-  const QuantumNumbers current_values(particles);
   const QuantumNumbers difference = conserved_initial - current_values;
 
   std::ostringstream ss;
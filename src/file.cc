@@ -9,8 +9,174 @@
 
 #include "smash/file.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
 namespace smash {
 
+MappedFile::MappedFile(const bf::path& filename) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open file " + filename.native() + ": " +
+                             std::strerror(errno));
+  }
+  struct stat file_status;
+  if (fstat(fd, &file_status) != 0) {
+    close(fd);
+    throw std::runtime_error("Cannot stat file " + filename.native() + ": " +
+                             std::strerror(errno));
+  }
+  size_ = file_status.st_size;
+  if (size_ > 0) {
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      size_ = 0;
+      throw std::runtime_error("Cannot map file " + filename.native() + ": " +
+                               std::strerror(errno));
+    }
+    // The readers walk the file front to back, so ask for aggressive
+    // readahead.
+    madvise(mapping, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(mapping);
+  }
+  // The mapping stays valid without the file descriptor.
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+    : data_(other.data_), size_(other.size_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+  if (this != &other) {
+    if (data_ != nullptr) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = other.data_;
+    size_ = other.size_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+AsyncWriter::AsyncWriter(std::FILE* file, bool compress)
+    : file_(file), compress_(compress) {
+  if (compress_) {
+#ifdef SMASH_USE_ZLIB
+    stream_ = {};
+    /* windowBits of 15 + 16 selects the gzip container, so the files can
+     * be read with standard tools (zcat, gzip) as well. */
+    if (deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      throw std::runtime_error("Could not initialize the zlib compressor.");
+    }
+    compress_buffer_.resize(1 << 16);
+    MemoryStats::allocate(MemoryStats::Category::OutputBuffers,
+                          compress_buffer_.capacity());
+#else
+    throw std::runtime_error(
+        "Compressed output requested, but zlib support not compiled in.");
+#endif
+  }
+  thread_ = std::thread([this]() { write_loop(); });
+}
+
+AsyncWriter::~AsyncWriter() {
+  flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+  }
+  condition_.notify_all();
+  thread_.join();
+  std::size_t capacity = fill_buffer_.capacity() + write_buffer_.capacity();
+#ifdef SMASH_USE_ZLIB
+  capacity += compress_buffer_.capacity();
+#endif
+  MemoryStats::deallocate(MemoryStats::Category::OutputBuffers, capacity);
+}
+
+void AsyncWriter::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Wait until the writer thread has drained the other buffer.
+  condition_.wait(lock, [this]() { return !has_work_; });
+  std::swap(fill_buffer_, write_buffer_);
+  fill_buffer_.clear();
+  has_work_ = true;
+  lock.unlock();
+  condition_.notify_all();
+}
+
+void AsyncWriter::write_loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    condition_.wait(lock, [this]() { return has_work_ || finished_; });
+    if (!has_work_) {
+      break;
+    }
+    /* write_buffer_ can be used without the lock: the producer only touches
+     * it in flush, after waiting for has_work_ to be false again. */
+    lock.unlock();
+#ifdef SMASH_USE_ZLIB
+    if (compress_) {
+      deflate_buffer(Z_SYNC_FLUSH);
+    } else
+#endif
+        if (!write_buffer_.empty()) {
+      std::fwrite(write_buffer_.data(), 1, write_buffer_.size(), file_);
+      write_buffer_.clear();
+    }
+    std::fflush(file_);
+    lock.lock();
+    has_work_ = false;
+    condition_.notify_all();
+  }
+#ifdef SMASH_USE_ZLIB
+  if (compress_) {
+    // write the gzip trailer and release the compressor state
+    lock.unlock();
+    deflate_buffer(Z_FINISH);
+    std::fflush(file_);
+    deflateEnd(&stream_);
+  }
+#endif
+}
+
+#ifdef SMASH_USE_ZLIB
+void AsyncWriter::deflate_buffer(int flush_mode) {
+  stream_.next_in = reinterpret_cast<Bytef*>(write_buffer_.data());
+  stream_.avail_in = write_buffer_.size();
+  int status = Z_OK;
+  do {
+    stream_.next_out = reinterpret_cast<Bytef*>(compress_buffer_.data());
+    stream_.avail_out = compress_buffer_.size();
+    status = deflate(&stream_, flush_mode);
+    const std::size_t produced = compress_buffer_.size() - stream_.avail_out;
+    if (produced > 0) {
+      std::fwrite(compress_buffer_.data(), 1, produced, file_);
+    }
+    /* Z_SYNC_FLUSH and Z_FINISH are done once all input is consumed and
+     * zlib had output space left over; Z_FINISH additionally reports
+     * Z_STREAM_END after the trailer. */
+  } while (stream_.avail_out == 0 && status == Z_OK);
+  write_buffer_.clear();
+}
+#endif
+
 FilePtr fopen(const bf::path& filename, const std::string& mode) {
   FilePtr f{std::fopen(filename.c_str(), mode.c_str())};
   return f;
@@ -13,19 +13,6 @@
 
 namespace smash {
 
-FourVector FourVector::LorentzBoost(const ThreeVector& v) const {
-  const double velocity_squared = v.sqr();
-
-  const double gamma =
-      velocity_squared < 1. ? 1. / std::sqrt(1. - velocity_squared) : 0;
-
-  // this is used four times in the Vector:
-  const double xprime_0 = gamma * (this->x0() - this->threevec() * v);
-  // this is the part of the space-like components that is always the same:
-  const double constantpart = gamma / (gamma + 1) * (xprime_0 + this->x0());
-  return FourVector(xprime_0, this->threevec() - v * constantpart);
-}
-
 bool FourVector::operator==(const FourVector& a) const {
   return almost_equal_physics(x_[0], a.x_[0]) &&
          almost_equal_physics(x_[1], a.x_[1]) &&
@@ -9,6 +9,9 @@
 
 #include <time.h>
 
+#include <algorithm>
+#include <numeric>
+
 #include "smash/angles.h"
 #include "smash/cxx14compat.h"
 #include "smash/distributions.h"
@@ -17,6 +20,7 @@
 #include "smash/particles.h"
 #include "smash/quantumnumbers.h"
 #include "smash/random.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 
@@ -37,12 +41,18 @@ void ThermLatticeNode::add_particle(const ParticleData &part, double factor) {
   ns_ += static_cast<double>(part.type().strangeness()) * factor;
 }
 
-void ThermLatticeNode::compute_rest_frame_quantities(HadronGasEos &eos) {
+void ThermLatticeNode::compute_rest_frame_quantities(
+    HadronGasEos &eos, const std::array<double, 3> &seed) {
   /// \todo(oliiny): use Newton's method instead of these iterations
   const int max_iter = 50;
   v_ = ThreeVector(0.0, 0.0, 0.0);
   double e_previous_step = 0.0;
   const double tolerance = 5.e-4;
+  /* Seed the solver with the converged solution of a neighboring cell, if
+   * one is given. Within the loop the solution of the previous iteration
+   * takes over this role; the conditions change little in both cases, so
+   * the solver starts close to the root. */
+  std::array<double, 3> warm_start = seed;
   int iter;
   for (iter = 0; iter < max_iter; iter++) {
     e_previous_step = e_;
@@ -54,16 +64,30 @@ void ThermLatticeNode::compute_rest_frame_quantities(HadronGasEos &eos) {
     EosTable::table_element tabulated;
     eos.from_table(tabulated, e_, gamma_inv * nb_);
     if (!eos.is_tabulated() || tabulated.p < 0.0) {
-      auto T_mub_mus = eos.solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_);
+      std::array<double, 3> T_mub_mus;
+      if (warm_start[0] > 0.) {
+        try {
+          T_mub_mus =
+              eos.solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_, warm_start);
+        } catch (const std::runtime_error &) {
+          /* The warm start can fail for an unlucky seed;
+           * retry from the generic initial approximation. */
+          T_mub_mus = eos.solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_);
+        }
+      } else {
+        T_mub_mus = eos.solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_);
+      }
       T_ = T_mub_mus[0];
       mub_ = T_mub_mus[1];
       mus_ = T_mub_mus[2];
+      warm_start = T_mub_mus;
       p_ = HadronGasEos::pressure(T_, mub_, mus_);
     } else {
       p_ = tabulated.p;
       T_ = tabulated.T;
       mub_ = tabulated.mub;
       mus_ = tabulated.mus;
+      warm_start = {{T_, mub_, mus_}};
     }
     v_ = Tmu0_.threevec() / (Tmu0_.x0() + p_);
   }
@@ -123,19 +147,134 @@ void GrandCanThermalizer::update_thermalizer_lattice(
   const DensityType dens_type = DensityType::Hadron;
   const LatticeUpdate update = LatticeUpdate::EveryFixedInterval;
   update_lattice(lat_.get(), update, dens_type, dens_par, particles);
-  for (auto &node : *lat_) {
-    /* If energy density is definitely below e_crit -
-       no need to find T, mu, etc. So if e = T00 - T0i*vi <=
-       T00 + sum abs(T0i) < e_crit, no efforts are necessary. */
-    if (!ignore_cells_under_treshold ||
-        node.Tmu0().x0() + std::abs(node.Tmu0().x1()) +
-                std::abs(node.Tmu0().x2()) + std::abs(node.Tmu0().x3()) >=
-            e_crit_) {
-      node.compute_rest_frame_quantities(eos_);
-    } else {
-      node = ThermLatticeNode();
+  /* Adjacent cells have nearly identical conditions, so the solver of each
+   * cell is warm-started from the converged solution of the previously
+   * processed cell of its range. */
+  const size_t n_nodes = lat_->size();
+  auto solve_nodes = [&](size_t begin, size_t end) {
+    std::array<double, 3> warm_start = {{0., 0., 0.}};
+    for (size_t i = begin; i < end; i++) {
+      ThermLatticeNode &node = (*lat_)[i];
+      /* If energy density is definitely below e_crit -
+         no need to find T, mu, etc. So if e = T00 - T0i*vi <=
+         T00 + sum abs(T0i) < e_crit, no efforts are necessary. */
+      if (!ignore_cells_under_treshold ||
+          node.Tmu0().x0() + std::abs(node.Tmu0().x1()) +
+                  std::abs(node.Tmu0().x2()) + std::abs(node.Tmu0().x3()) >=
+              e_crit_) {
+        node.compute_rest_frame_quantities(eos_, warm_start);
+        warm_start = {{node.T(), node.mub(), node.mus()}};
+      } else {
+        node = ThermLatticeNode();
+      }
+    }
+  };
+  ThreadPool *const pool = shared_pool();
+  if (pool == nullptr) {
+    solve_nodes(0, n_nodes);
+  } else {
+    /* Contiguous chunks keep the warm start useful within each chunk.
+     * compute_rest_frame_quantities reads the EoS table lock-free; only
+     * the rare off-table cells serialize on the solver mutex of eos_.
+     * More chunks than threads even out the load: the cells above
+     * threshold cluster in the center of the lattice. */
+    const size_t n_chunks =
+        std::min(n_nodes, static_cast<size_t>(4 * pool->num_threads()));
+    if (n_chunks > 0) {
+      const size_t chunk_size = (n_nodes + n_chunks - 1) / n_chunks;
+      pool->parallel_range(n_chunks, [&](size_t c) {
+        const size_t begin = c * chunk_size;
+        solve_nodes(begin, std::min(begin + chunk_size, n_nodes));
+      });
+    }
+  }
+}
+
+bool GrandCanThermalizer::regions_to_thermalize_exist(
+    const Particles &particles, const DensityParameters &par) {
+  const std::array<int, 3> dims = lat_->dimensions();
+  const std::array<double, 3> csize = lat_->cell_sizes();
+  const std::array<double, 3> orig = lat_->origin();
+  const bool periodic = lat_->periodic();
+  const size_t n_total = lat_->size();
+  e_bound_.assign(n_total, 0.0);
+  /* The smearing factor of a particle is at most its Lorentz gamma E/m,
+   * so T00 + sum |T0i| of a node is bounded by
+   * norm * sum_{nearby particles} (E + |p|) E / m. */
+  for (const ParticleData &part : particles) {
+    const FourVector mom = part.momentum();
+    const double m = mom.abs();
+    if (m < really_small) {
+      continue;
+    }
+    const ThreeVector pos = part.position().threevec();
+    std::array<int, 3> cell;
+    bool in_reach = true;
+    for (int d = 0; d < 3; d++) {
+      int i = static_cast<int>(std::floor((pos[d] - orig[d]) / csize[d]));
+      if (periodic) {
+        i = ((i % dims[d]) + dims[d]) % dims[d];
+      } else if (i < 0 || i >= dims[d]) {
+        /* Particles outside the lattice can still smear into boundary
+         * cells. They are accounted to the nearest cell; the widened box
+         * window below covers the shift. */
+        const int margin =
+            static_cast<int>(std::ceil(par.r_cut() / csize[d])) + 1;
+        if (i < -margin || i >= dims[d] + margin) {
+          in_reach = false;
+          break;
+        }
+        i = std::min(std::max(i, 0), dims[d] - 1);
+      }
+      cell[d] = i;
+    }
+    if (!in_reach) {
+      continue;
     }
+    const size_t index = cell[0] + dims[0] * (cell[1] + dims[1] * cell[2]);
+    e_bound_[index] += (mom.x0() + mom.threevec().abs()) * mom.x0() / m;
   }
+  /* Separable box sums along the three axes. After them every cell holds
+   * the summed bound over a window that covers all particles able to smear
+   * into it, including the clamped out-of-lattice ones. */
+  auto box_pass = [&](int d) {
+    const int hw = 2 * static_cast<int>(std::ceil(par.r_cut() / csize[d])) + 2;
+    e_bound_scratch_.assign(n_total, 0.0);
+    for (int iz = 0; iz < dims[2]; iz++) {
+      for (int iy = 0; iy < dims[1]; iy++) {
+        for (int ix = 0; ix < dims[0]; ix++) {
+          const std::array<int, 3> center = {{ix, iy, iz}};
+          double sum = 0.0;
+          for (int k = -hw; k <= hw; k++) {
+            int j = center[d] + k;
+            if (periodic) {
+              j = ((j % dims[d]) + dims[d]) % dims[d];
+            } else if (j < 0 || j >= dims[d]) {
+              continue;
+            }
+            std::array<int, 3> c = center;
+            c[d] = j;
+            sum += e_bound_[c[0] + dims[0] * (c[1] + dims[1] * c[2])];
+          }
+          e_bound_scratch_[ix + dims[0] * (iy + dims[1] * iz)] = sum;
+        }
+      }
+    }
+    e_bound_.swap(e_bound_scratch_);
+  };
+  box_pass(0);
+  box_pass(1);
+  box_pass(2);
+
+  const double norm_factor = par.norm_factor_sf();
+  hot_cells_.clear();
+  for (size_t i = 0; i < n_total; i++) {
+    if (e_bound_[i] * norm_factor >= e_crit_) {
+      hot_cells_.push_back(i);
+    }
+  }
+  hot_cells_valid_ = true;
+  return !hot_cells_.empty();
 }
 
 ThreeVector GrandCanThermalizer::uniform_in_cell() const {
@@ -171,8 +310,9 @@ void GrandCanThermalizer::renormalize_momenta(
 
   double E = 0.0;
   double E_expected = required_total_momentum.abs();
+  const PrecomputedBoost boost_generated(beta_CM_generated);
   for (auto &particle : plist) {
-    particle.boost_momentum(beta_CM_generated);
+    particle.boost_momentum(boost_generated);
     E += particle.momentum().x0();
   }
   // Renorm. momenta by factor (1+a) to get the right energy, binary search
@@ -206,10 +346,46 @@ void GrandCanThermalizer::renormalize_momenta(
   } while (std::abs(er) > tolerance && iter < max_iter);
 
   log.info("Renormalizing momenta by factor 1+a, a = ", a);
+  const PrecomputedBoost boost_required(-beta_CM_required);
   for (auto &particle : plist) {
     particle.set_4momentum(particle.type().mass(),
                            (1 + a) * particle.momentum().threevec());
-    particle.boost_momentum(-beta_CM_required);
+    particle.boost_momentum(boost_required);
+  }
+}
+
+void GrandCanThermalizer::precompute_thermal_yields() {
+  const size_t n_cells = cells_to_sample_.size();
+  N_type_in_cell_.resize(N_sorts_ * n_cells);
+  N_type_in_cell_cumulative_.resize(N_sorts_ * n_cells);
+  auto yields_of_cell = [&](size_t c) {
+    const ThermLatticeNode cell = (*lat_)[cells_to_sample_[c]];
+    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
+    for (size_t i = 0; i < N_sorts_; i++) {
+      // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
+      N_type_in_cell_[i * n_cells + c] =
+          cell_volume_ * gamma *
+          HadronGasEos::partial_density(*eos_typelist_[i], cell.T(),
+                                        cell.mub(), cell.mus());
+    }
+  };
+  /* Every cell writes to its own slots, so the cells can be processed on
+   * the thread pool; the cumulative sums below stay serial to keep the
+   * summation order (and with it the sampling) independent of threading. */
+  ThreadPool *const pool = shared_pool();
+  if (pool == nullptr) {
+    for (size_t c = 0; c < n_cells; c++) {
+      yields_of_cell(c);
+    }
+  } else {
+    pool->parallel_range(n_cells, yields_of_cell);
+  }
+  for (size_t i = 0; i < N_sorts_; i++) {
+    double partial_sum = 0.0;
+    for (size_t c = 0; c < n_cells; c++) {
+      partial_sum += N_type_in_cell_[i * n_cells + c];
+      N_type_in_cell_cumulative_[i * n_cells + c] = partial_sum;
+    }
   }
 }
 
@@ -241,46 +417,37 @@ void GrandCanThermalizer::sample_multinomial(HadronClass particle_class,
 void GrandCanThermalizer::sample_in_random_cell_BF_algo(ParticleList &plist,
                                                         const double time,
                                                         size_t type_index) {
-  N_in_cells_.clear();
-  N_total_in_cells_ = 0.0;
-  for (auto cell_index : cells_to_sample_) {
-    const ThermLatticeNode cell = (*lat_)[cell_index];
-    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
-    const double N_this_cell =
-        cell_volume_ * gamma *
-        HadronGasEos::partial_density(*eos_typelist_[type_index], cell.T(),
-                                      cell.mub(), cell.mus());
-    N_in_cells_.push_back(N_this_cell);
-    N_total_in_cells_ += N_this_cell;
-  }
+  const size_t n_cells = cells_to_sample_.size();
+  const auto cumulative_begin =
+      N_type_in_cell_cumulative_.begin() + type_index * n_cells;
+  const auto cumulative_end = cumulative_begin + n_cells;
+  const double N_total_in_cells =
+      (n_cells > 0) ? *(cumulative_end - 1) : 0.0;
 
   for (int i = 0; i < mult_int_[type_index]; i++) {
     // Choose random cell, probability = N_in_cell/N_total
-    double r = random::uniform(0.0, N_total_in_cells_);
-    double partial_sum = 0.0;
-    int index_only_thermalized = -1;
-    while (partial_sum < r) {
-      index_only_thermalized++;
-      partial_sum += N_in_cells_[index_only_thermalized];
-    }
+    const double r = random::uniform(0.0, N_total_in_cells);
+    const size_t index_only_thermalized =
+        std::lower_bound(cumulative_begin, cumulative_end, r) -
+        cumulative_begin;
     const int cell_index = cells_to_sample_[index_only_thermalized];
     const ThermLatticeNode cell = (*lat_)[cell_index];
     const ThreeVector cell_center = lat_->cell_center(cell_index);
 
-    ParticleData particle(*eos_typelist_[type_index]);
+    // Construct the particle directly in the (reused) output list instead
+    // of copying it there.
+    plist.emplace_back(*eos_typelist_[type_index]);
+    ParticleData &particle = plist.back();
     // Note: it's pole mass for resonances!
     const double m = eos_typelist_[type_index]->mass();
     // Position
     particle.set_4position(FourVector(time, cell_center + uniform_in_cell()));
     // Momentum
     double momentum_radial = sample_momenta_from_thermal(cell.T(), m);
-    Angles phitheta;
-    phitheta.distribute_isotropically();
-    particle.set_4momentum(m, phitheta.threevec() * momentum_radial);
+    particle.set_4momentum(m,
+                           random::isotropic_unit_vector() * momentum_radial);
     particle.boost_momentum(-cell.v());
     particle.set_formation_time(time);
-
-    plist.push_back(particle);
   }
 }
 
@@ -288,16 +455,14 @@ void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
                                              double time, int ntest) {
   const auto &log = logger<LogArea::GrandcanThermalizer>();
 
-  std::fill(mult_sort_.begin(), mult_sort_.end(), 0.0);
-  for (auto cell_index : cells_to_sample_) {
-    const ThermLatticeNode cell = (*lat_)[cell_index];
-    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
-    for (size_t i = 0; i < N_sorts_; i++) {
-      // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
-      mult_sort_[i] += cell_volume_ * gamma * ntest *
-                       HadronGasEos::partial_density(
-                           *eos_typelist_[i], cell.T(), cell.mub(), cell.mus());
-    }
+  const size_t n_cells = cells_to_sample_.size();
+  for (size_t i = 0; i < N_sorts_; i++) {
+    // The cumulative table ends with the sum over all cells of
+    // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
+    mult_sort_[i] =
+        (n_cells > 0)
+            ? ntest * N_type_in_cell_cumulative_[(i + 1) * n_cells - 1]
+            : 0.0;
   }
 
   std::fill(mult_classes_.begin(), mult_classes_.end(), 0.0);
@@ -371,6 +536,12 @@ void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
         HadronClass::ZeroQZeroSMeson,
         random::poisson(mult_class(HadronClass::ZeroQZeroSMeson)));
 
+    /* The sampled multiplicities are known at this point, so the output
+     * list can grow to its final size in one step. After the first
+     * attempt the buffer usually already has enough capacity, because
+     * clear() keeps it across attempts and thermalizations. */
+    sampled_list_.reserve(
+        std::accumulate(mult_int_.begin(), mult_int_.end(), 0));
     for (size_t itype = 0; itype < N_sorts_; itype++) {
       sample_in_random_cell_BF_algo(sampled_list_, time, itype);
     }
@@ -525,15 +696,27 @@ void GrandCanThermalizer::thermalize(const Particles &particles, double time,
   // Save the indices of cells inside the volume with e > e_crit_
   cells_to_sample_.clear();
   const size_t lattice_total_cells = lat_->size();
-  for (size_t i = 0; i < lattice_total_cells; i++) {
-    if ((*lat_)[i].e() > e_crit_) {
-      cells_to_sample_.push_back(i);
+  if (hot_cells_valid_) {
+    /* The pre-screening bound is conservative, so scanning its compact
+     * candidate list finds every cell above the threshold. */
+    for (size_t i : hot_cells_) {
+      if ((*lat_)[i].e() > e_crit_) {
+        cells_to_sample_.push_back(i);
+      }
+    }
+    hot_cells_valid_ = false;
+  } else {
+    for (size_t i = 0; i < lattice_total_cells; i++) {
+      if ((*lat_)[i].e() > e_crit_) {
+        cells_to_sample_.push_back(i);
+      }
     }
   }
   log.info("Number of cells in the thermalization region = ",
            cells_to_sample_.size(), ", its total volume [fm^3]: ",
            cells_to_sample_.size() * cell_volume_, ", in % of lattice: ",
            100.0 * cells_to_sample_.size() / lattice_total_cells);
+  precompute_thermal_yields();
 
   switch (algorithm_) {
     case ThermalizationAlgorithm::BiasedBF:
@@ -18,8 +18,8 @@
 #include "smash/threevector.h"
 
 namespace std {
-template <typename T>
-static std::ostream &operator<<(std::ostream &out, const std::vector<T> &v) {
+template <typename T, typename A>
+static std::ostream &operator<<(std::ostream &out, const std::vector<T, A> &v) {
   auto column = out.tellp();
   out << "{ ";
   for (const auto &x : v) {
@@ -73,19 +73,23 @@ GridBase::find_min_and_length(const Particles &particles) {
   auto &min_position = r.first;
   auto &length = r.second;
 
+  /* The scan only needs the positions, so it runs over the
+   * structure-of-arrays mirror instead of the full ParticleData objects.
+   * The refreshed mirror is then reused when the particles are sorted into
+   * cells below. */
+  const Particles::HotArrays &hot = particles.update_hot_arrays();
+
   // intialize min and max position arrays with the position of the first
   // particle in the list
-  const auto &first_position = particles.front().position();
-  min_position = {{first_position[1], first_position[2], first_position[3]}};
+  min_position = {{hot.x[0], hot.y[0], hot.z[0]}};
   auto max_position = min_position;
-  for (const auto &p : particles) {
-    const auto &pos = p.position();
-    min_position[0] = std::min(min_position[0], pos[1]);
-    min_position[1] = std::min(min_position[1], pos[2]);
-    min_position[2] = std::min(min_position[2], pos[3]);
-    max_position[0] = std::max(max_position[0], pos[1]);
-    max_position[1] = std::max(max_position[1], pos[2]);
-    max_position[2] = std::max(max_position[2], pos[3]);
+  for (std::size_t i = 0; i != hot.size(); ++i) {
+    min_position[0] = std::min(min_position[0], hot.x[i]);
+    min_position[1] = std::min(min_position[1], hot.y[i]);
+    min_position[2] = std::min(min_position[2], hot.z[i]);
+    max_position[0] = std::max(max_position[0], hot.x[i]);
+    max_position[1] = std::max(max_position[1], hot.y[i]);
+    max_position[2] = std::max(max_position[2], hot.z[i]);
   }
   length[0] = max_position[0] - min_position[0];
   length[1] = max_position[1] - min_position[1];
@@ -108,9 +112,10 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
   // very simple setup for non-periodic boundaries and largest cellsize strategy
   if (O == GridOptions::Normal && strategy == CellSizeStrategy::Largest) {
     number_of_cells_ = {1, 1, 1};
-    cells_.clear();
-    cells_.reserve(1);
-    cells_.emplace_back(particles.copy_to_vector());
+    cell_particles_ = particles.copy_to_vector();
+    const Particles::HotArrays &hot = particles.update_hot_arrays();
+    sorted_indices_.assign(hot.index.begin(), hot.index.end());
+    cell_offsets_ = {0, SizeType(cell_particles_.size())};
     return;
   }
 
@@ -189,12 +194,20 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
               " cells. Therefore the Grid falls back to a single cell / "
               "particle list.");
     number_of_cells_ = {1, 1, 1};
-    cells_.resize(1);
-    cells_.front().reserve(particles.size());
-    std::copy_if(particles.begin(), particles.end(),
-                 std::back_inserter(cells_.front()), [](const ParticleData &p) {
-                   return p.xsec_scaling_factor() > 0.0;
-                 });  // filter out the particles that can not interact
+    const Particles::HotArrays &hot = particles.update_hot_arrays();
+    cell_particles_.reserve(hot.size());
+    // filter out the particles that can not interact
+    for (std::size_t slot = 0; slot != hot.size(); ++slot) {
+      if (hot.xsec_scale[slot] <= 0.0) {
+        // The particle may become interactive while a caller reuses the
+        // grid, so refreshing must not keep it excluded.
+        refreshable_ = false;
+      } else if (hot.frozen[slot] == 0) {
+        cell_particles_.push_back(particles.at_index(hot.index[slot]));
+        sorted_indices_.push_back(hot.index[slot]);
+      }
+    }
+    cell_offsets_ = {0, SizeType(cell_particles_.size())};
   } else {
     // construct a normal grid
     log.debug("min: ", min_position, "\nlength: ", length_,
@@ -202,42 +215,121 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
 
     // After the grid parameters are determined, we can start placing the
     // particles in cells.
-    cells_.resize(number_of_cells_[0] * number_of_cells_[1] *
-                  number_of_cells_[2]);
-
-    // Returns the one-dimensional cell-index from the position vector inside
-    // the grid.
-    // This simply calculates the distance to min_position and multiplies it
-    // with index_factor to determine the 3 x,y,z indexes to pass to make_index.
-    auto &&cell_index_for = [&](const ParticleData &p) {
-      return make_index(
-          std::floor((p.position()[1] - min_position[0]) * index_factor[0]),
-          std::floor((p.position()[2] - min_position[1]) * index_factor[1]),
-          std::floor((p.position()[3] - min_position[2]) * index_factor[2]));
-    };
-
-    for (const auto &p : particles) {
-      if (p.xsec_scaling_factor() > 0.0) {
-        const auto idx = cell_index_for(p);
+    const SizeType number_of_cells =
+        number_of_cells_[0] * number_of_cells_[1] * number_of_cells_[2];
+
+    /* The cell indexes only depend on the positions and the spectator
+     * filter only on the cross-section scaling factors and the frozen
+     * flags, so all of them are read from the structure-of-arrays mirror.
+     * The full ParticleData objects are only touched once, to copy them
+     * into the flat cell storage. */
+    const Particles::HotArrays &hot = particles.update_hot_arrays();
+
+    /* Binning pass: the cell index is a pure arithmetic function of the
+     * position. The index factors are the precomputed reciprocal cell
+     * sizes, so there is no division, and for periodic grids the wrap of
+     * positions just outside the box is folded into the index arithmetic
+     * instead of a branch. Since the pass reads only the structure-of-
+     * arrays position arrays and has no branches, the compiler can
+     * vectorize it; the interactivity filter is applied in the counting
+     * pass below. */
+    SizeVector cell_index_of(hot.size());
+    const double fx = index_factor[0];
+    const double fy = index_factor[1];
+    const double fz = index_factor[2];
+    const double min_x = min_position[0];
+    const double min_y = min_position[1];
+    const double min_z = min_position[2];
+    const SizeType nx = number_of_cells_[0];
+    const SizeType ny = number_of_cells_[1];
+    const SizeType nz = number_of_cells_[2];
+    for (std::size_t slot = 0; slot != hot.size(); ++slot) {
+      SizeType ix = static_cast<SizeType>(std::floor((hot.x[slot] - min_x) *
+                                                     fx));
+      SizeType iy = static_cast<SizeType>(std::floor((hot.y[slot] - min_y) *
+                                                     fy));
+      SizeType iz = static_cast<SizeType>(std::floor((hot.z[slot] - min_z) *
+                                                     fz));
+      if (O == GridOptions::PeriodicBoundaries) {
+        /* A particle can sit at most one cell row outside the box before
+         * its wall crossing is performed, so one fold per side suffices. */
+        ix += nx * (ix < 0) - nx * (ix >= nx);
+        iy += ny * (iy < 0) - ny * (iy >= ny);
+        iz += nz * (iz < 0) - nz * (iz >= nz);
+      }
+      cell_index_of[slot] = (iz * ny + iy) * nx + ix;
+    }
+
+    /* Counting sort: first count the particles per cell, ... The offsets
+     * are sized first so that the arena frees of the build transients
+     * below rewind cleanly. */
+    cell_offsets_.clear();
+    cell_offsets_.resize(number_of_cells + 1, 0);
+    for (std::size_t slot = 0; slot != hot.size(); ++slot) {
+      if (hot.xsec_scale[slot] > 0.0 && hot.frozen[slot] == 0) {
+        const auto idx = cell_index_of[slot];
 #ifndef NDEBUG
-        if (idx >= SizeType(cells_.size())) {
+        if (idx < 0 || idx >= number_of_cells) {
           log.fatal(
               source_location,
               "\nan out-of-bounds access would be necessary for the "
               "particle ",
-              p, "\nfor a grid with the following parameters:\nmin: ",
+              particles.at_index(hot.index[slot]),
+              "\nfor a grid with the following parameters:\nmin: ",
               min_position, "\nlength: ", length_,
               "\ncells: ", number_of_cells_, "\nindex_factor: ", index_factor,
-              "\ncells_.size: ", cells_.size(), "\nrequested index: ", idx);
+              "\nnumber of cells: ", number_of_cells,
+              "\nrequested index: ", idx);
           throw std::runtime_error("out-of-bounds grid access on construction");
         }
 #endif
-        cells_[idx].push_back(p);
+        ++cell_offsets_[idx + 1];
+      } else {
+        cell_index_of[slot] = -1;
+        if (hot.xsec_scale[slot] <= 0.0) {
+          // The particle may become interactive while a caller reuses the
+          // grid, so refreshing must not keep it excluded.
+          refreshable_ = false;
+        }
       }
     }
+    /* ... then turn the counts into start offsets ... */
+    for (SizeType i = 0; i != number_of_cells; ++i) {
+      cell_offsets_[i + 1] += cell_offsets_[i];
+    }
+    /* ... and finally place the particles. The sort works on the slot
+     * numbers, so that the ParticleData objects are copied exactly once,
+     * into their final position. */
+    SizeVector sorted_slots(cell_offsets_[number_of_cells]);
+    {
+      SizeVector cursor(cell_offsets_.begin(), cell_offsets_.end() - 1);
+      for (std::size_t slot = 0; slot != hot.size(); ++slot) {
+        if (cell_index_of[slot] >= 0) {
+          sorted_slots[cursor[cell_index_of[slot]]++] = slot;
+        }
+      }
+    }
+    cell_particles_.reserve(sorted_slots.size());
+    sorted_indices_.reserve(sorted_slots.size());
+    for (const SizeType slot : sorted_slots) {
+      cell_particles_.push_back(particles.at_index(hot.index[slot]));
+      sorted_indices_.push_back(hot.index[slot]);
+    }
   }
 
-  log.debug(cells_);
+  log.debug("cell offsets: ", cell_offsets_);
+}
+
+template <GridOptions O>
+void Grid<O>::refresh(const Particles &particles) {
+  /* The binning is kept, only the particle copies in the cells are brought
+   * up to date. This is only correct under the guarantees documented in
+   * grid.h; in particular the storage indexes recorded on construction must
+   * still refer to the same particles. */
+  cell_particles_.clear();
+  for (const unsigned index : sorted_indices_) {
+    cell_particles_.push_back(particles.at_index(index));
+  }
 }
 
 template <GridOptions Options>
@@ -249,8 +341,8 @@ inline typename Grid<Options>::SizeType Grid<Options>::make_index(
 template <>
 /// Specialization of iterate_cells
 void Grid<GridOptions::Normal>::iterate_cells(
-    const std::function<void(const ParticleList &)> &search_cell_callback,
-    const std::function<void(const ParticleList &, const ParticleList &)>
+    const std::function<void(const ParticleSlice &)> &search_cell_callback,
+    const std::function<void(const ParticleSlice &, const ParticleSlice &)>
         &neighbor_cell_callback) const {
   std::array<SizeType, 3> search_index;
   SizeType &x = search_index[0];
@@ -262,8 +354,8 @@ void Grid<GridOptions::Normal>::iterate_cells(
       for (x = 0; x < number_of_cells_[0]; ++x, ++search_cell_index) {
         assert(search_cell_index == make_index(search_index));
         assert(search_cell_index >= 0);
-        assert(search_cell_index < SizeType(cells_.size()));
-        const ParticleList &search = cells_[search_cell_index];
+        assert(search_cell_index < SizeType(cell_offsets_.size()) - 1);
+        const ParticleSlice search = cell(search_cell_index);
         search_cell_callback(search);
 
         const auto dz_list = z == number_of_cells_[2] - 1
@@ -288,7 +380,7 @@ void Grid<GridOptions::Normal>::iterate_cells(
             for (SizeType dx : dx_list) {
               const auto di = make_index(dx, dy, dz);
               if (di > 0) {
-                neighbor_cell_callback(search, cells_[search_cell_index + di]);
+                neighbor_cell_callback(search, cell(search_cell_index + di));
               }
             }
           }
@@ -319,8 +411,8 @@ struct NeighborLookup {
 template <>
 /// Specialization of iterate_cells
 void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
-    const std::function<void(const ParticleList &)> &search_cell_callback,
-    const std::function<void(const ParticleList &, const ParticleList &)>
+    const std::function<void(const ParticleSlice &)> &search_cell_callback,
+    const std::function<void(const ParticleSlice &, const ParticleSlice &)>
         &neighbor_cell_callback) const {
   const auto &log = logger<LogArea::Grid>();
 
@@ -330,6 +422,10 @@ void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
   SizeType &z = search_index[2];
   SizeType search_cell_index = 0;
 
+  /* The translated copies of the previous iteration are only released now:
+   * callbacks may have retained slices into them until this point. */
+  wrapped_search_cells_.clear();
+
   // defaults:
   std::array<NeighborLookup, 2> dz_list;
   std::array<NeighborLookup, 3> dy_list;
@@ -376,10 +472,16 @@ void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
 
         assert(search_cell_index == make_index(search_index));
         assert(search_cell_index >= 0);
-        assert(search_cell_index < SizeType(cells_.size()));
-        ParticleList search = cells_[search_cell_index];
+        assert(search_cell_index < SizeType(cell_offsets_.size()) - 1);
+        const ParticleSlice search = cell(search_cell_index);
         search_cell_callback(search);
 
+        /* View of the search cell handed to the neighbor callback. For
+         * wrapped combinations it is redirected to a translated copy of
+         * the cell in grid-owned storage, so it is equally long-lived as
+         * the slices into the flat cell array. */
+        ParticleSlice wrapped_search = search;
+
         auto virtual_search_index = search_index;
         ThreeVector wrap_vector = {};  // no change
         auto current_wrap_vector = wrap_vector;
@@ -417,20 +519,28 @@ void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
               const auto neighbor_cell_index =
                   make_index(dx.index, dy.index, dz.index);
               assert(neighbor_cell_index >= 0);
-              assert(neighbor_cell_index < SizeType(cells_.size()));
+              assert(neighbor_cell_index < SizeType(cell_offsets_.size()) - 1);
               if (neighbor_cell_index <= make_index(virtual_search_index)) {
                 continue;
               }
 
               if (wrap_vector != current_wrap_vector) {
-                log.debug("translating search cell by ",
-                          wrap_vector - current_wrap_vector);
-                for_each(search, [&](ParticleData &p) {
-                  p = p.translated(wrap_vector - current_wrap_vector);
-                });
+                if (wrap_vector == ThreeVector{}) {
+                  wrapped_search = search;
+                } else {
+                  log.debug("translating search cell by ", wrap_vector);
+                  wrapped_search_cells_.emplace_back(search.begin(),
+                                                     search.end());
+                  ParticleList &copy = wrapped_search_cells_.back();
+                  for (ParticleData &p : copy) {
+                    p.set_4position(p.position() + FourVector(0., wrap_vector));
+                  }
+                  wrapped_search =
+                      ParticleSlice(copy.data(), copy.data() + copy.size());
+                }
                 current_wrap_vector = wrap_vector;
               }
-              neighbor_cell_callback(search, cells_[neighbor_cell_index]);
+              neighbor_cell_callback(wrapped_search, cell(neighbor_cell_index));
             }
             virtual_search_index[0] = search_index[0];
             wrap_vector[0] = 0;
@@ -453,4 +563,7 @@ template Grid<GridOptions::PeriodicBoundaries>::Grid(
         &min_and_length,
     const Particles &particles, double max_interaction_length,
     CellSizeStrategy strategy);
+template void Grid<GridOptions::Normal>::refresh(const Particles &particles);
+template void Grid<GridOptions::PeriodicBoundaries>::refresh(
+    const Particles &particles);
 }  // namespace smash
@@ -9,13 +9,21 @@
 
 #include <gsl/gsl_sf_bessel.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 
 #include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #include "smash/constants.h"
+#include "smash/cxx14compat.h"
 #include "smash/forwarddeclarations.h"
 #include "smash/fpenvironment.h"
 #include "smash/hadgas_eos.h"
@@ -23,16 +31,180 @@
 #include "smash/logging.h"
 #include "smash/pow.h"
 #include "smash/random.h"
+#include "smash/tabulation.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 
+namespace {
+
+/// On-disk header of the binary EoS table, directly followed by the entries.
+struct EosTableHeader {
+  char magic[4];           ///< Magic bytes, "SMSH" as in the binary outputs
+  uint16_t version;        ///< Format version
+  uint16_t variant;        ///< Format variant, 4 = EoS table
+  uint64_t particle_hash;  ///< Hash of the particle table the EoS was built on
+  double de;               ///< Step in energy density
+  double dnb;              ///< Step in net-baryon density
+  uint64_t n_e;            ///< Number of steps in energy density
+  uint64_t n_nb;           ///< Number of steps in net-baryon density
+};
+
+/// Version of the binary EoS table format
+constexpr uint16_t eos_table_version = 0;
+/// Variant number distinguishing the EoS table from other binary files
+constexpr uint16_t eos_table_variant = 4;
+
+/**
+ * FNV-1a hash of the properties of all particle types that enter the hadron
+ * gas EoS. A saved table with a matching hash was computed from the same
+ * particle content, so no sampled consistency check against the EoS is needed.
+ */
+uint64_t particle_table_hash() {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  const auto mix_bytes = [&hash](const void *data, size_t size) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++) {
+      hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+  };
+  for (const ParticleType &ptype : ParticleType::list_all()) {
+    const int32_t pdg = ptype.pdgcode().get_decimal();
+    const double mass = ptype.mass();
+    const double width = ptype.width_at_pole();
+    mix_bytes(&pdg, sizeof(pdg));
+    mix_bytes(&mass, sizeof(mass));
+    mix_bytes(&width, sizeof(width));
+  }
+  return hash;
+}
+
+/// Constants of one species entering the hadron-gas sums.
+struct EosSpecies {
+  /// Pole mass. [GeV]
+  double mass;
+  /// Spin degeneracy.
+  double g;
+  /// Baryon number.
+  double b;
+  /// Strangeness.
+  double s;
+  /// Whether the pole mass is used instead of the spectral integration.
+  bool stable;
+  /// The species itself, for the spectral integration of resonances.
+  ParticleTypePtr type;
+};
+
+/**
+ * \return The species contributing to the EoS, with the constants of the
+ * thermodynamic sums packed into one contiguous array. Every iteration of
+ * the EoS root solver walks this array instead of filtering the full
+ * particle-type list.
+ */
+const std::vector<EosSpecies> &eos_species_list() {
+  static thread_local std::vector<EosSpecies> list;
+  static thread_local size_t n_types = 0;
+  if (n_types != ParticleType::list_all().size()) {
+    list.clear();
+    for (const ParticleType &ptype : ParticleType::list_all()) {
+      if (!HadronGasEos::is_eos_particle(ptype)) {
+        continue;
+      }
+      list.push_back({ptype.mass(), static_cast<double>(ptype.spin() + 1),
+                      static_cast<double>(ptype.baryon_number()),
+                      static_cast<double>(ptype.strangeness()),
+                      ptype.is_stable(), &ptype});
+    }
+    n_types = ParticleType::list_all().size();
+  }
+  return list;
+}
+
+}  // unnamed namespace
+
 EosTable::EosTable(double de, double dnb, size_t n_e, size_t n_nb)
     : de_(de), dnb_(dnb), n_e_(n_e), n_nb_(n_nb) {
   table_.resize(n_e_ * n_nb_);
+  table_view_ = table_.data();
+}
+
+EosTable::~EosTable() {
+  if (map_addr_ != nullptr) {
+    munmap(map_addr_, map_size_);
+  }
+}
+
+bool EosTable::try_map_table(const std::string &filename, uint64_t hash) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  EosTableHeader header;
+  struct stat file_stat;
+  if (read(fd, &header, sizeof(header)) !=
+          static_cast<ssize_t>(sizeof(header)) ||
+      std::memcmp(header.magic, "SMSH", 4) != 0 ||
+      header.version != eos_table_version ||
+      header.variant != eos_table_variant || header.particle_hash != hash ||
+      header.n_e < 2 || header.n_nb < 2 || fstat(fd, &file_stat) != 0 ||
+      static_cast<uint64_t>(file_stat.st_size) !=
+          sizeof(header) + header.n_e * header.n_nb * sizeof(table_element)) {
+    close(fd);
+    return false;
+  }
+  /* A shared read-only mapping: all SMASH processes on the node reference
+   * the same physical pages of the page cache instead of each keeping a
+   * private copy of the table. */
+  void *addr = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after closing the descriptor.
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+  map_addr_ = addr;
+  map_size_ = file_stat.st_size;
+  de_ = header.de;
+  dnb_ = header.dnb;
+  n_e_ = header.n_e;
+  n_nb_ = header.n_nb;
+  table_ = std::vector<table_element>();
+  table_view_ = reinterpret_cast<const table_element *>(
+      static_cast<const char *>(addr) + sizeof(header));
+  return true;
+}
+
+void EosTable::save_binary_table(const std::string &filename,
+                                 uint64_t hash) const {
+  EosTableHeader header;
+  std::memcpy(header.magic, "SMSH", 4);
+  header.version = eos_table_version;
+  header.variant = eos_table_variant;
+  header.particle_hash = hash;
+  header.de = de_;
+  header.dnb = dnb_;
+  header.n_e = n_e_;
+  header.n_nb = n_nb_;
+  const boost::filesystem::path tmp_path =
+      boost::filesystem::unique_path(filename + ".%%%%-%%%%");
+  {
+    boost::filesystem::ofstream file(tmp_path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(table_.data()),
+               table_.size() * sizeof(table_element));
+  }
+  /* Renaming is atomic, so concurrently starting processes never map a
+   * half-written table. */
+  boost::filesystem::rename(tmp_path, filename);
 }
 
 void EosTable::compile_table(HadronGasEos &eos,
                              const std::string &eos_savefile_name) {
+  const std::string binary_name = eos_savefile_name + ".bin";
+  const uint64_t hash = particle_table_hash();
+  if (try_map_table(binary_name, hash)) {
+    std::cout << "Mapped EoS table from file " << binary_name << std::endl;
+    return;
+  }
   bool table_read_success = false, table_consistency = true;
   if (boost::filesystem::exists(eos_savefile_name)) {
     std::cout << "Reading table from file " << eos_savefile_name << std::endl;
@@ -86,7 +258,7 @@ finish_consistency_check:
   if (!table_read_success || !table_consistency) {
     std::cout << "Compiling an EoS table..." << std::endl;
     const double ns = 0.0;
-    for (size_t ie = 0; ie < n_e_; ie++) {
+    const auto compile_row = [&](size_t ie, HadronGasEos &row_eos) {
       const double e = de_ * ie;
       for (size_t inb = 0; inb < n_nb_; inb++) {
         const double nb = dnb_ * inb;
@@ -104,14 +276,31 @@ finish_consistency_check:
           init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
                          2.0 * x.mus - y.mus};
         } else {
-          init_approx = eos.solve_eos_initial_approximation(e, nb);
+          init_approx = row_eos.solve_eos_initial_approximation(e, nb);
         }
-        const std::array<double, 3> res = eos.solve_eos(e, nb, ns, init_approx);
+        const std::array<double, 3> res =
+            row_eos.solve_eos(e, nb, ns, init_approx);
         const double T = res[0];
         const double mub = res[1];
         const double mus = res[2];
-        table_[index(ie, inb)] = {eos.pressure(T, mub, mus), T, mub, mus};
+        table_[index(ie, inb)] = {HadronGasEos::pressure(T, mub, mus), T, mub,
+                                  mus};
       }
+    };
+    ThreadPool *const pool = shared_pool();
+    if (pool == nullptr) {
+      for (size_t ie = 0; ie < n_e_; ie++) {
+        compile_row(ie, eos);
+      }
+    } else {
+      /* The warm starts only ever use previous solutions of the same row, so
+       * a row at fixed ie is an independent unit of work. The GSL multiroot
+       * solver state lives in the HadronGasEos instance, hence every task
+       * solves on an instance of its own. */
+      pool->parallel_range(n_e_, [&](size_t ie) {
+        HadronGasEos row_eos(false);
+        compile_row(ie, row_eos);
+      });
     }
     // Save table to file
     std::cout << "Saving table to file " << eos_savefile_name << std::endl;
@@ -128,6 +317,9 @@ finish_consistency_check:
       }
     }
   }
+  // Save the binary copy that subsequent runs map instead of parsing text.
+  save_binary_table(binary_name, hash);
+  table_view_ = table_.data();
 }
 
 void EosTable::get(EosTable::table_element &res, double e, double nb) const {
@@ -140,10 +332,10 @@ void EosTable::get(EosTable::table_element &res, double e, double nb) const {
     // 1st order interpolation
     const double ae = e / de_ - ie;
     const double an = nb / dnb_ - inb;
-    const EosTable::table_element s1 = table_[index(ie, inb)];
-    const EosTable::table_element s2 = table_[index(ie + 1, inb)];
-    const EosTable::table_element s3 = table_[index(ie, inb + 1)];
-    const EosTable::table_element s4 = table_[index(ie + 1, inb + 1)];
+    const EosTable::table_element s1 = table_view_[index(ie, inb)];
+    const EosTable::table_element s2 = table_view_[index(ie + 1, inb)];
+    const EosTable::table_element s3 = table_view_[index(ie, inb + 1)];
+    const EosTable::table_element s4 = table_view_[index(ie + 1, inb + 1)];
     res.p = ae * (an * s4.p + (1.0 - an) * s2.p) +
             (1.0 - ae) * (an * s3.p + (1.0 - an) * s1.p);
     res.T = ae * (an * s4.T + (1.0 - an) * s2.T) +
@@ -184,6 +376,47 @@ double HadronGasEos::scaled_partial_density_auxiliary(double m_over_T,
              : m_over_T * m_over_T * x * gsl_sf_bessel_Kn_scaled(2, m_over_T);
 }
 
+const Tabulation *HadronGasEos::resonance_density_table(
+    const ParticleType &ptype) {
+  /* Built once for the whole particle list on first use and read-only
+   * afterwards, so concurrent lookups are safe. The build stays serial:
+   * the first lookup can already happen on a thread-pool worker, which
+   * must not start a nested parallel region. */
+  static const std::vector<std::unique_ptr<Tabulation>> tables = []() {
+    const ParticleTypeList &all_types = ParticleType::list_all();
+    std::vector<std::unique_ptr<Tabulation>> tabs(all_types.size());
+    Integrator integrate;
+    for (size_t i = 0; i < all_types.size(); i++) {
+      const ParticleType &t = all_types[i];
+      if (t.is_stable() || !is_eos_particle(t)) {
+        continue;
+      }
+      // Same substitution as in scaled_partial_density()
+      const double m0 = t.mass();
+      const double w0 = t.width_at_pole();
+      const double mth = t.min_mass_spectral();
+      const double u_min = std::atan(2.0 * (mth - m0) / w0);
+      const double u_max = 0.5 * M_PI;
+      tabs[i] = make_unique<Tabulation>(
+          res_tab_beta_min_, res_tab_beta_max_ - res_tab_beta_min_,
+          res_tab_intervals_, [&](double beta) {
+            const double I = integrate(u_min, u_max, [&](double u) {
+              const double tanu = std::tan(u);
+              const double m = m0 + 0.5 * w0 * tanu;
+              const double jacobian = 0.5 * w0 * (1.0 + tanu * tanu);
+              return t.spectral_function(m) * jacobian *
+                     scaled_partial_density_auxiliary(m * beta, 0.0);
+            });
+            return std::log(I);
+          });
+    }
+    return tabs;
+  }();
+  const size_t i_type = std::addressof(ptype) -
+                        std::addressof(ParticleType::list_all()[0]);
+  return (i_type < tables.size()) ? tables[i_type].get() : nullptr;
+}
+
 double HadronGasEos::scaled_partial_density(const ParticleType &ptype,
                                             double beta, double mub,
                                             double mus) {
@@ -194,6 +427,15 @@ double HadronGasEos::scaled_partial_density(const ParticleType &ptype,
   if (ptype.is_stable()) {
     return g * scaled_partial_density_auxiliary(m_over_T, mu_over_T);
   } else {
+    /* Inside the tabulated domain the thermal integral is interpolated
+     * from the shared per-species table; the chemical potentials enter
+     * exactly through the exponential prefactor. */
+    if (beta >= res_tab_beta_min_ && beta <= res_tab_beta_max_) {
+      const Tabulation *table = resonance_density_table(ptype);
+      if (table != nullptr) {
+        return g * std::exp(mu_over_T + table->get_value_linear(beta));
+      }
+    }
     // Integral \int_{threshold}^{\infty} A(m) N_{thermal}(m) dm,
     // where A(m) is the spectral function of the resonance.
     const double m0 = ptype.mass();
@@ -201,7 +443,7 @@ double HadronGasEos::scaled_partial_density(const ParticleType &ptype,
     const double mth = ptype.min_mass_spectral();
     const double u_min = std::atan(2.0 * (mth - m0) / w0);
     const double u_max = 0.5 * M_PI;
-    Integrator integrate;
+    static thread_local Integrator integrate;
     const double result =
         g * integrate(u_min, u_max, [&](double u) {
           // One of many possible variable substitutions. Not clear if it has
@@ -231,21 +473,16 @@ double HadronGasEos::energy_density(double T, double mub, double mus) {
   }
   const double beta = 1.0 / T;
   double e = 0.0;
-  for (const ParticleType &ptype : ParticleType::list_all()) {
-    if (!is_eos_particle(ptype)) {
-      continue;
-    }
-    const double z = ptype.mass() * beta;
-    double x = beta * (mub * ptype.baryon_number() + mus * ptype.strangeness() -
-                       ptype.mass());
+  for (const EosSpecies &sp : eos_species_list()) {
+    const double z = sp.mass * beta;
+    double x = beta * (mub * sp.b + mus * sp.s - sp.mass);
     if (x < -500.0) {
       return 0.0;
     }
     x = std::exp(x);
-    const size_t g = ptype.spin() + 1;
     // Small mass case, z*z*K_2(z) -> 2, z*z*z*K_1(z) -> 0 at z->0
-    e += (z < really_small) ? 3.0 * g * x
-                            : z * z * g * x *
+    e += (z < really_small) ? 3.0 * sp.g * x
+                            : z * z * sp.g * x *
                                   (3.0 * gsl_sf_bessel_Kn_scaled(2, z) +
                                    z * gsl_sf_bessel_K1_scaled(z));
   }
@@ -259,11 +496,8 @@ double HadronGasEos::density(double T, double mub, double mus) {
   }
   const double beta = 1.0 / T;
   double rho = 0.0;
-  for (const ParticleType &ptype : ParticleType::list_all()) {
-    if (!is_eos_particle(ptype)) {
-      continue;
-    }
-    rho += scaled_partial_density(ptype, beta, mub, mus);
+  for (const EosSpecies &sp : eos_species_list()) {
+    rho += scaled_partial_density(*sp.type, beta, mub, mus);
   }
   rho *= prefactor_ * T * T * T;
   return rho;
@@ -275,12 +509,11 @@ double HadronGasEos::net_baryon_density(double T, double mub, double mus) {
   }
   const double beta = 1.0 / T;
   double rho = 0.0;
-  for (const ParticleType &ptype : ParticleType::list_all()) {
-    if (!ptype.is_baryon() || !is_eos_particle(ptype)) {
+  for (const EosSpecies &sp : eos_species_list()) {
+    if (sp.b == 0.) {
       continue;
     }
-    rho +=
-        scaled_partial_density(ptype, beta, mub, mus) * ptype.baryon_number();
+    rho += scaled_partial_density(*sp.type, beta, mub, mus) * sp.b;
   }
   rho *= prefactor_ * T * T * T;
   return rho;
@@ -292,11 +525,11 @@ double HadronGasEos::net_strange_density(double T, double mub, double mus) {
   }
   const double beta = 1.0 / T;
   double rho = 0.0;
-  for (const ParticleType &ptype : ParticleType::list_all()) {
-    if (ptype.strangeness() == 0 || !is_eos_particle(ptype)) {
+  for (const EosSpecies &sp : eos_species_list()) {
+    if (sp.s == 0.) {
       continue;
     }
-    rho += scaled_partial_density(ptype, beta, mub, mus) * ptype.strangeness();
+    rho += scaled_partial_density(*sp.type, beta, mub, mus) * sp.s;
   }
   rho *= prefactor_ * T * T * T;
   return rho;
@@ -398,6 +631,54 @@ double HadronGasEos::mus_net_strangeness0(double T, double mub) {
   return mus;
 }
 
+std::array<double, 3> HadronGasEos::energy_and_net_densities(double T,
+                                                             double mub,
+                                                             double mus) {
+  if (T < really_small) {
+    return {{0.0, 0.0, 0.0}};
+  }
+  const double beta = 1.0 / T;
+  double e = 0.0, nb = 0.0, ns = 0.0;
+  bool e_underflow = false;
+  for (const EosSpecies &sp : eos_species_list()) {
+    const double z = sp.mass * beta;
+    const double x = beta * (mub * sp.b + mus * sp.s - sp.mass);
+    double expx = 0.0;
+    double k2_scaled = 0.0;
+    if (x < -500.0) {
+      // matches the early return of energy_density()
+      e_underflow = true;
+    } else {
+      expx = std::exp(x);
+      if (z >= really_small) {
+        k2_scaled = gsl_sf_bessel_Kn_scaled(2, z);
+      }
+    }
+    // Small mass case, z*z*K_2(z) -> 2, z*z*z*K_1(z) -> 0 at z->0
+    e += (z < really_small)
+             ? 3.0 * sp.g * expx
+             : z * z * sp.g * expx *
+                   (3.0 * k2_scaled + z * gsl_sf_bessel_K1_scaled(z));
+    if (sp.b == 0. && sp.s == 0.) {
+      continue;
+    }
+    double dens;
+    if (sp.stable) {
+      /* The scaled partial density of a stable species reuses the
+       * exponential and the Bessel function of the energy-density term. */
+      dens = (z < really_small) ? 2.0 * sp.g * expx
+                                : sp.g * z * z * expx * k2_scaled;
+    } else {
+      dens = scaled_partial_density(*sp.type, beta, mub, mus);
+    }
+    nb += dens * sp.b;
+    ns += dens * sp.s;
+  }
+  const double n_prefactor = prefactor_ * T * T * T;
+  return {{e_underflow ? 0.0 : e * (n_prefactor * T), nb * n_prefactor,
+           ns * n_prefactor}};
+}
+
 int HadronGasEos::set_eos_solver_equations(const gsl_vector *x, void *params,
                                            gsl_vector *f) {
   double e = reinterpret_cast<struct rparams *>(params)->e;
@@ -408,9 +689,10 @@ int HadronGasEos::set_eos_solver_equations(const gsl_vector *x, void *params,
   const double mub = gsl_vector_get(x, 1);
   const double mus = gsl_vector_get(x, 2);
 
-  gsl_vector_set(f, 0, energy_density(T, mub, mus) - e);
-  gsl_vector_set(f, 1, net_baryon_density(T, mub, mus) - nb);
-  gsl_vector_set(f, 2, net_strange_density(T, mub, mus) - ns);
+  const std::array<double, 3> dens = energy_and_net_densities(T, mub, mus);
+  gsl_vector_set(f, 0, dens[0] - e);
+  gsl_vector_set(f, 1, dens[1] - nb);
+  gsl_vector_set(f, 2, dens[2] - ns);
 
   return GSL_SUCCESS;
 }
@@ -486,6 +768,7 @@ std::array<double, 3> HadronGasEos::solve_eos_initial_approximation(double e,
 std::array<double, 3> HadronGasEos::solve_eos(
     double e, double nb, double ns,
     std::array<double, 3> initial_approximation) {
+  std::lock_guard<std::mutex> guard(solver_mutex_);
   int residual_status = GSL_SUCCESS;
   size_t iter = 0;
 
@@ -87,6 +87,28 @@ class Action {
    */
   virtual ~Action();
 
+  /**
+   * Allocate memory for an action from the action memory pool.
+   *
+   * The collision finders create actions in large numbers every time step
+   * and most of them are discarded without ever being performed. Going
+   * through the general-purpose heap for each of them is measurable in
+   * profiles, so all classes deriving from Action draw their memory from a
+   * pool of size-bucketed free lists instead.
+   *
+   * \param[in] size size of the object to allocate, provided by the compiler
+   * \return memory for the new action
+   */
+  static void *operator new(std::size_t size);
+
+  /**
+   * Return the memory of an action to the pool, making it available for the
+   * next allocation of similar size.
+   *
+   * \param[in] ptr memory previously obtained from operator new
+   */
+  static void operator delete(void *ptr);
+
   /**
    * Determine whether one action takes place before another in time
    *
@@ -204,6 +226,19 @@ class Action {
    */
   bool is_valid(const Particles &particles) const;
 
+  /**
+   * Prefetch the memory that validating and performing this action will
+   * touch: the stored slots of the incoming particles and their type-table
+   * rows.
+   *
+   * This is purely a latency hint, used to overlap the cache misses of the
+   * next few scheduled actions with the work on the current one; it has no
+   * observable effect.
+   *
+   * \param[in] particles current particle list
+   */
+  void prefetch_incoming(const Particles &particles) const;
+
   /**
    * Check if the action is Pauli-blocked.
    *
@@ -236,6 +271,19 @@ class Action {
    */
   void update_incoming(const Particles &particles);
 
+  /**
+   * Propagate the incoming particles that are stored in this action along
+   * straight lines to the execution time of the action.
+   *
+   * For a valid action without potentials this produces the same incoming
+   * state as propagating the global particle list to the execution time and
+   * calling \ref update_incoming, but without touching any other particle.
+   * It allows the final state to be generated before the evolution has
+   * actually reached the action. Must not be used with frozen Fermi motion,
+   * where the propagation velocity differs from the particle velocity.
+   */
+  void propagate_incoming_to_execution_time();
+
   /**
    * Get the list of particles that resulted from the action.
    *
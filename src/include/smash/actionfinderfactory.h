@@ -31,13 +31,13 @@ class ActionFinderInterface {
   /**
    * Abstract function for finding actions, given a list of particles.
    *
-   * \param[in] search_list a list of particles where each pair needs to be
-   *                  tested  for possible interaction
+   * \param[in] search_list the particles of one grid cell, where each pair
+   *                  needs to be tested for possible interaction
    * \param[in] dt duration of the current time step [fm]
    * \return The function returns a list (std::vector) of Action objects that
    *         could possibly be executed in this time step.
    */
-  virtual ActionList find_actions_in_cell(const ParticleList &search_list,
+  virtual ActionList find_actions_in_cell(const ParticleSlice &search_list,
                                           double dt) const = 0;
   /**
    * Abstract function for finding actions, given two lists of particles,
@@ -52,7 +52,7 @@ class ActionFinderInterface {
    *         could possibly be executed in this time step.
    */
   virtual ActionList find_actions_with_neighbors(
-      const ParticleList &search_list, const ParticleList &neighbors_list,
+      const ParticleSlice &search_list, const ParticleSlice &neighbors_list,
       double dt) const = 0;
 
   /**
@@ -65,13 +65,15 @@ class ActionFinderInterface {
    *                    tested for possible interactions with the surrounding
    *                    particles
    * \param[in] surrounding_list a list of particles that need to be tested
-   *                  against particles in search_list for possible interaction
+   *                  against particles in search_list for possible
+   *                  interaction, e.g. the spatial neighborhood of the
+   *                  search list
    * \param[in] dt duration of the current time step [fm]
    * \return The function returns a list (std::vector) of Action objects that
    *         could possibly be executed in this time step.
    */
   virtual ActionList find_actions_with_surrounding_particles(
-      const ParticleList &search_list, const Particles &surrounding_list,
+      const ParticleList &search_list, const ParticleList &surrounding_list,
       double dt) const = 0;
 
   /**
@@ -87,6 +89,16 @@ class ActionFinderInterface {
    */
   virtual ActionList find_final_actions(const Particles &search_list,
                                         bool only_res = false) const = 0;
+
+  /**
+   * \return whether find_actions_in_cell and find_actions_with_neighbors may
+   *         be called concurrently from several threads for disjoint cells.
+   *
+   * Finders that draw random numbers during the search have to return false
+   * here, otherwise the result would depend on the thread scheduling and
+   * runs would not be reproducible for a fixed seed.
+   */
+  virtual bool is_search_thread_safe() const { return false; }
 };
 
 }  // namespace smash
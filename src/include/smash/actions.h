@@ -8,12 +8,15 @@
 #define SRC_INCLUDE_ACTIONS_H_
 
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
 #include "action.h"
 #include "forwarddeclarations.h"
+#include "memorystats.h"
 
 namespace smash {
 
@@ -39,8 +42,21 @@ class Actions {
    * \param[in] action_list The ActionList from which to construct the Actions
    *                    object
    */
-  explicit Actions(ActionList&& action_list) : data_(std::move(action_list)) {
+  explicit Actions(ActionList&& action_list)
+      : data_(std::make_move_iterator(action_list.begin()),
+              std::make_move_iterator(action_list.end())) {
     std::make_heap(data_.begin(), data_.end(), cmp);
+    track_growth(0, data_.capacity());
+  }
+
+  /// Returns the accounted storage before it is freed, see MemoryStats.
+  ~Actions() {
+    std::size_t capacity = data_.capacity();
+    for (const auto& bucket : buckets_) {
+      capacity += bucket.capacity();
+    }
+    MemoryStats::deallocate(MemoryStats::Category::Actions,
+                            capacity * sizeof(ActionPtr));
   }
 
   /// Cannot be copied
@@ -48,8 +64,40 @@ class Actions {
   /// Cannot be copied
   Actions& operator=(const Actions&) = delete;
 
+  /**
+   * Switch this container from the default binary heap to a bucketed
+   * calendar queue covering the time range [\p start_time, \p end_time].
+   *
+   * Without time steps the pending actions of the whole evolution live in
+   * this container and every insert and pop pays the full heap reshuffle.
+   * The calendar queue sorts actions into time buckets instead: an insert
+   * only appends to the bucket of its execution time and a bucket is sorted
+   * once, when the evolution reaches it, which is constant amortized work
+   * per action.
+   *
+   * This may only be called while the container is empty. Actions outside
+   * of the given time range are placed in the first or last bucket, they
+   * are not lost.
+   *
+   * \param[in] start_time earliest expected execution time [fm/c]
+   * \param[in] end_time latest expected execution time [fm/c]
+   */
+  void use_calendar_queue(double start_time, double end_time) {
+    assert(data_.empty());
+    constexpr std::size_t number_of_buckets = 1024;
+    calendar_start_ = start_time;
+    bucket_width_ = (end_time - start_time) / number_of_buckets;
+    if (!(bucket_width_ > 0.)) {
+      bucket_width_ = 1.;
+    }
+    buckets_.resize(number_of_buckets);
+    use_calendar_ = true;
+  }
+
   /// \return whether the list of actions is empty.
-  bool is_empty() const { return data_.empty(); }
+  bool is_empty() const {
+    return use_calendar_ ? calendar_size_ == 0 : data_.empty();
+  }
 
   /**
    * Return the first action in the list and removes it from the list.
@@ -57,15 +105,51 @@ class Actions {
    * \throw RuntimeError if the list is empty.
    */
   ActionPtr pop() {
-    if (data_.empty()) {
+    if (is_empty()) {
       throw std::runtime_error("Empty actions list!");
     }
+    if (use_calendar_) {
+      return pop_calendar();
+    }
     std::pop_heap(data_.begin(), data_.end(), cmp);
     ActionPtr act = std::move(data_.back());
     data_.pop_back();
     return act;
   }
 
+  /**
+   * Call \p callback with up to \p count upcoming actions, without
+   * removing them from the container.
+   *
+   * The traversal is only approximately in execution-time order (heap
+   * layer order, or draining order of the calendar buckets), which is
+   * sufficient for its purpose: issuing latency-hiding prefetches for the
+   * actions that will be popped next.
+   *
+   * \param[in] count Maximal number of actions to visit.
+   * \param[in] callback Called with each visited action.
+   */
+  template <typename Callback>
+  void peek_upcoming(std::size_t count, Callback&& callback) const {
+    if (use_calendar_) {
+      for (std::size_t b = current_bucket_;
+           count > 0 && b < buckets_.size(); ++b) {
+        const std::vector<ActionPtr>& bucket = buckets_[b];
+        // a sorted bucket holds its earliest actions at the back
+        for (auto it = bucket.rbegin(); count > 0 && it != bucket.rend();
+             ++it) {
+          callback(**it);
+          --count;
+        }
+      }
+    } else {
+      // the first heap entries are the earliest few actions, in layer order
+      for (std::size_t i = 0; i < count && i < data_.size(); ++i) {
+        callback(*data_[i]);
+      }
+    }
+  }
+
   /**
    * Insert a list of actions into this object.
    *
@@ -79,6 +163,31 @@ class Actions {
     }
   }
 
+  /**
+   * Insert a whole list of actions in one pass.
+   *
+   * In heap mode the list is appended and the heap is rebuilt once, which
+   * is linear in the total size instead of one logarithmic reshuffle per
+   * action; for the large batches of a collision search this beats
+   * \ref insert. In calendar mode an insert is a cheap bucket append
+   * already, so the actions are inserted one by one.
+   *
+   * \param[in] new_acts The actions that will be inserted.
+   */
+  void insert_bulk(ActionList&& new_acts) {
+    if (use_calendar_) {
+      for (auto& a : new_acts) {
+        insert_calendar(std::move(a));
+      }
+      return;
+    }
+    const std::size_t old_capacity = data_.capacity();
+    data_.insert(data_.end(), std::make_move_iterator(new_acts.begin()),
+                 std::make_move_iterator(new_acts.end()));
+    track_growth(old_capacity, data_.capacity());
+    std::make_heap(data_.begin(), data_.end(), cmp);
+  }
+
   /**
    * Insert an action into this container.
    *
@@ -87,15 +196,31 @@ class Actions {
    * \param[in] action The action to insert.
    */
   void insert(ActionPtr&& action) {
+    if (use_calendar_) {
+      insert_calendar(std::move(action));
+      return;
+    }
+    const std::size_t old_capacity = data_.capacity();
     data_.push_back(std::move(action));
+    track_growth(old_capacity, data_.capacity());
     std::push_heap(data_.begin(), data_.end(), cmp);
   }
 
   /// \return Number of actions.
-  ActionList::size_type size() const { return data_.size(); }
+  ActionList::size_type size() const {
+    return use_calendar_ ? calendar_size_ : data_.size();
+  }
 
   /// Delete all actions.
-  void clear() { data_.clear(); }
+  void clear() {
+    data_.clear();
+    for (auto& bucket : buckets_) {
+      bucket.clear();
+    }
+    current_bucket_ = 0;
+    current_bucket_sorted_ = false;
+    calendar_size_ = 0;
+  }
 
   /// \return an iterator to the earliest action.
   std::vector<ActionPtr>::const_reverse_iterator begin() const {
@@ -120,6 +245,68 @@ class Actions {
     return a->time_of_execution() > b->time_of_execution();
   }
 
+  /**
+   * Account a possible reallocation of an ActionPtr vector with
+   * MemoryStats. Vectors never shrink here, so only growth is accounted;
+   * the destructor returns the final capacities in one go.
+   *
+   * \param[in] old_capacity Capacity before the insertion.
+   * \param[in] new_capacity Capacity after the insertion.
+   */
+  static void track_growth(std::size_t old_capacity,
+                           std::size_t new_capacity) {
+    if (new_capacity != old_capacity) {
+      MemoryStats::allocate(MemoryStats::Category::Actions,
+                            (new_capacity - old_capacity) * sizeof(ActionPtr));
+    }
+  }
+
+  /// Insert an action into its time bucket of the calendar queue.
+  void insert_calendar(ActionPtr&& action) {
+    const double time = action->time_of_execution();
+    std::size_t index = 0;
+    if (time > calendar_start_) {
+      index = std::min(
+          static_cast<std::size_t>((time - calendar_start_) / bucket_width_),
+          buckets_.size() - 1);
+    }
+    if (index < current_bucket_) {
+      /* The action is due before the bucket the evolution has reached. Put
+       * it into the current bucket so it is not skipped. */
+      index = current_bucket_;
+    }
+    std::vector<ActionPtr>& bucket = buckets_[index];
+    const std::size_t old_capacity = bucket.capacity();
+    if (index == current_bucket_ && current_bucket_sorted_) {
+      // keep the latest-first order of the bucket intact
+      const auto position =
+          std::lower_bound(bucket.begin(), bucket.end(), action, cmp);
+      bucket.insert(position, std::move(action));
+    } else {
+      bucket.push_back(std::move(action));
+    }
+    track_growth(old_capacity, bucket.capacity());
+    ++calendar_size_;
+  }
+
+  /// Remove and \return the earliest action of the calendar queue.
+  ActionPtr pop_calendar() {
+    while (buckets_[current_bucket_].empty()) {
+      ++current_bucket_;
+      current_bucket_sorted_ = false;
+    }
+    std::vector<ActionPtr>& bucket = buckets_[current_bucket_];
+    if (!current_bucket_sorted_) {
+      // latest first, so that the earliest action is popped off the back
+      std::sort(bucket.begin(), bucket.end(), cmp);
+      current_bucket_sorted_ = true;
+    }
+    ActionPtr act = std::move(bucket.back());
+    bucket.pop_back();
+    --calendar_size_;
+    return act;
+  }
+
   /**
    * Dynamic data.
    *
@@ -128,6 +315,23 @@ class Actions {
    * requires a less efficient sort algorithm.
    */
   std::vector<ActionPtr> data_;
+
+  /// Whether the calendar queue is used instead of the binary heap.
+  bool use_calendar_ = false;
+  /// Start of the time range covered by the calendar queue.
+  double calendar_start_ = 0.;
+  /// Width of one calendar bucket [fm/c].
+  double bucket_width_ = 1.;
+  /// The calendar buckets; bucket i covers times
+  /// [calendar_start_ + i * bucket_width_, calendar_start_ + (i + 1) *
+  /// bucket_width_).
+  std::vector<std::vector<ActionPtr>> buckets_;
+  /// The bucket the evolution has been drained up to.
+  std::size_t current_bucket_ = 0;
+  /// Whether the current bucket has already been sorted for popping.
+  bool current_bucket_sorted_ = false;
+  /// Number of actions stored in the calendar buckets.
+  std::size_t calendar_size_ = 0;
 };
 
 }  // namespace smash
@@ -185,6 +185,39 @@ inline std::ostream &operator<<(std::ostream &out, const Angles &a) {
   return out << "φ:" << field << a.phi() << ", cos ϑ:" << field << a.costheta();
 }
 
+namespace random {
+/**
+ * Sample a direction isotropically and return it directly as a unit
+ * three-vector.
+ *
+ * This is the preferred sampler for callers that only need the
+ * direction: it uses the polar method of Marsaglia (1972), which maps a
+ * point drawn uniformly from the unit disk onto the sphere and thus
+ * evaluates no trigonometric function, only one square root per
+ * direction. Drawing \f$\varphi\f$ and \f$\cos\vartheta\f$ via \ref
+ * Angles::distribute_isotropically and converting with \ref
+ * Angles::threevec gives the same distribution, but pays a sine and a
+ * cosine for the conversion. Angles remains the right tool whenever the
+ * angles themselves are needed afterwards, e.g. for \ref
+ * Angles::add_to_theta.
+ *
+ * (The function is declared here and not in random.h, because random.h
+ * does not know about ThreeVector.)
+ *
+ * \return unit three-vector distributed uniformly on the sphere
+ */
+inline ThreeVector isotropic_unit_vector() {
+  double u, v, s;
+  do {
+    u = uniform(-1.0, 1.0);
+    v = uniform(-1.0, 1.0);
+    s = u * u + v * v;
+  } while (s >= 1.0);
+  const double f = 2.0 * std::sqrt(1.0 - s);
+  return ThreeVector(f * u, f * v, 1.0 - 2.0 * s);
+}
+}  // namespace random
+
 void inline Angles::distribute_isotropically() {
   /* Isotropic distribution: phi in [0, 2pi) and cos(theta) in [-1,1]. */
   phi_ = random::uniform(0.0, twopi);
@@ -266,7 +299,10 @@ double inline Angles::y() const { return sintheta() * std::sin(phi_); }
 double inline Angles::z() const { return costheta_; }
 
 ThreeVector inline Angles::threevec() const {
-  return ThreeVector(x(), y(), z());
+  // compute sintheta only once instead of once in x() and once in y()
+  const double sinth = sintheta();
+  return ThreeVector(sinth * std::cos(phi_), sinth * std::sin(phi_),
+                     costheta_);
 }
 
 double inline Angles::theta() const { return std::acos(costheta_); }
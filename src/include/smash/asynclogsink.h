@@ -0,0 +1,84 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_ASYNCLOGSINK_H_
+#define SRC_INCLUDE_ASYNCLOGSINK_H_
+
+#include <cstdint>
+
+namespace smash {
+
+/**
+ * Moves the log writes off the simulation threads.
+ *
+ * By default every log record is written and flushed on the thread that
+ * produced it, so a slow log destination (NFS, piped consumers) stalls the
+ * event loop. When the sink is installed, records are only formatted on the
+ * producing thread and then handed to a bounded queue that a background
+ * flusher thread drains to the original destination.
+ *
+ * The producer never blocks: when the queue is full (the flusher cannot
+ * keep up), the record is dropped and counted, and the number of dropped
+ * records is reported when the sink shuts down. Record order is preserved
+ * for the records that are written.
+ *
+ * Optionally the records are written as JSON-lines ("structured") instead
+ * of plain text, one object per record with the run id, the current event
+ * number and the formatted message, so log aggregation does not have to
+ * parse the human-readable layout.
+ *
+ * Controlled by the \key Async and \key Structured keys of the
+ * \ref input_logging_ "Logging" configuration section.
+ */
+class AsyncLogSink {
+ public:
+  /**
+   * Install the sink and start its flusher thread. May be called only
+   * once; all log output from this point on goes through the queue.
+   *
+   * \param[in] structured Whether to write JSON-lines records instead of
+   *            the plain formatted text.
+   */
+  static void install(bool structured);
+
+  /**
+   * Drain the queue, stop the flusher thread and restore direct writes.
+   * If records were dropped, a final record reporting their number is
+   * written. Safe to call without a preceding install (does nothing).
+   */
+  static void shutdown();
+
+  /**
+   * Forget the sink without draining or joining.
+   *
+   * Has to be called in the child process directly after a fork(): the
+   * flusher thread only exists in the parent, so the child restores
+   * direct writes and abandons the inherited queue.
+   */
+  static void drop_after_fork();
+
+  /**
+   * Set the run id reported in structured records.
+   * \param[in] run_id The run id, usually the random seed of the run.
+   */
+  static void set_run_id(int64_t run_id);
+
+  /**
+   * Set the event number reported in structured records.
+   * \param[in] event The number of the event that is being computed.
+   */
+  static void set_event(int event);
+
+  /// \return the number of records dropped because the queue was full.
+  static uint64_t dropped();
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_ASYNCLOGSINK_H_
@@ -10,12 +10,17 @@
 #ifndef SRC_INCLUDE_BINARYOUTPUT_H_
 #define SRC_INCLUDE_BINARYOUTPUT_H_
 
+#include <array>
+#include <cstdint>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <boost/numeric/conversion/cast.hpp>
 
 #include "file.h"
 #include "forwarddeclarations.h"
+#include "fourvector.h"
 #include "outputinterface.h"
 #include "outputparameters.h"
 
@@ -26,6 +31,10 @@ namespace smash {
  * Base class for SMASH binary output.
  */
 class BinaryOutputBase : public OutputInterface {
+ public:
+  /// The extended format prints the full particle history.
+  bool requires_history() const override { return extended_; }
+
  protected:
   /**
    * Create binary output base.
@@ -34,9 +43,11 @@ class BinaryOutputBase : public OutputInterface {
    * \param[in] mode Is used to determine the file access mode.
    * \param[in] name Name of the output.
    * \param[in] extended_format Is the written output extended.
+   * \param[in] compressed Whether the output is gzip-compressed.
    */
   explicit BinaryOutputBase(const bf::path &path, const std::string &mode,
-                            const std::string &name, bool extended_format);
+                            const std::string &name, bool extended_format,
+                            bool compressed = false);
 
   /**
    * Write string to binary output.
@@ -60,25 +71,19 @@ class BinaryOutputBase : public OutputInterface {
    * Write integer (32 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::int32_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::int32_t x) { writer_.append(&x, sizeof(x)); }
 
   /**
    * Write unsigned integer (32 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::uint32_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::uint32_t x) { writer_.append(&x, sizeof(x)); }
 
   /**
    * Write unsigned integer (16 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::uint16_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::uint16_t x) { writer_.append(&x, sizeof(x)); }
 
   /**
    * Write a std::size_t to binary output.
@@ -100,15 +105,35 @@ class BinaryOutputBase : public OutputInterface {
 
   /**
    * Write particle data to binary output.
+   *
+   * The extended-vs-standard decision is a template parameter, so each
+   * instantiation is a branch-free write of one block layout. The
+   * per-block loops dispatch on \ref is_extended once instead of testing
+   * the flag for every particle.
+   *
+   * \tparam Extended Whether the extended block layout is written.
    * \param[in] p Particle data to be written.
    */
+  template <bool Extended>
   void write_particledata(const ParticleData &p);
 
+  /// \return Whether the extended block layout is written.
+  bool is_extended() const { return extended_; }
+
   /// Binary particles output file path
   RenamingFilePtr file_;
 
+  /**
+   * Writer thread the serialized blocks are handed to. The simulation
+   * serializes into its in-memory buffer and only the flush at the end of
+   * an event waits for the disk, and only if the writer has not caught up
+   * with the previous event yet. Declared after file_ so it is destroyed
+   * (and drained) before the file is closed and renamed.
+   */
+  AsyncWriter writer_;
+
  private:
-  /// Binary file format version number
+  /// Binary file format version number; bumped to 7 for compressed files.
   uint16_t format_version_ = 6;
   /// Option for extended output
   bool extended_;
@@ -134,9 +159,11 @@ class BinaryOutputCollisions : public BinaryOutputBase {
    * \param[in] path Output path.
    * \param[in] name Name of the output.
    * \param[in] out_par A structure containing parameters of the output.
+   * \param[in] compressed Whether the output is gzip-compressed.
    */
   BinaryOutputCollisions(const bf::path &path, std::string name,
-                         const OutputParameters &out_par);
+                         const OutputParameters &out_par,
+                         bool compressed = false);
 
   /**
    * Writes the initial particle information list of an event to the binary
@@ -159,7 +186,9 @@ class BinaryOutputCollisions : public BinaryOutputBase {
 
   /**
    * Writes an interaction block, including information about the incoming and
-   * outgoing particles, to the binary output.
+   * outgoing particles, to the binary output. Interactions rejected by the
+   * content filters (process types, \f$\sqrt{s}\f$ window, elastic
+   * prescale) are skipped.
    * \param[in] action Action that holds the information of the interaction.
    * \param[in] density Density at the interaction point.
    */
@@ -168,6 +197,173 @@ class BinaryOutputCollisions : public BinaryOutputBase {
  private:
   /// Write initial and final particles additonally to collisions?
   bool print_start_end_;
+
+  /// Numeric process types that are written; empty means all.
+  std::set<int> process_filter_;
+
+  /// \f$\sqrt{s}\f$ window [min, max] in GeV of written interactions.
+  std::array<double, 2> sqrts_filter_;
+
+  /// Write only every this many-th elastic scattering.
+  int elastic_prescale_;
+
+  /// Number of elastic scatterings seen so far, for the prescale.
+  uint64_t elastic_count_ = 0;
+};
+
+/**
+ * \ingroup output
+ * \brief Compact per-event binary output for perturbative photons.
+ *
+ * Photon runs write two orders of magnitude more records than hadronic
+ * runs, and each fractional photon only differs from its siblings in the
+ * photon momentum and the weight. This output therefore buffers the
+ * photons of an event instead of writing a full interaction block per
+ * fractional photon, merges records with identical kinematics by summing
+ * their weights, and hands the whole event to the asynchronous writer as
+ * one block of compact photon records ('g' blocks, see
+ * \ref format_binary_). Requested with the "Binary_Compact" format of the
+ * \key Photons content.
+ */
+class BinaryOutputPhotons : public BinaryOutputBase {
+ public:
+  /**
+   * Create the compact binary photon output.
+   *
+   * \param[in] path Output path.
+   * \param[in] name Name of the output, "Photons".
+   * \param[in] out_par A structure containing parameters of the output.
+   */
+  BinaryOutputPhotons(const bf::path &path, std::string name,
+                      const OutputParameters &out_par);
+
+  /**
+   * Starts a new event: drops the buffered records of the previous one.
+   * \param[in] particles Unused, needed since inherited.
+   * \param[in] event_number Unused, needed since inherited.
+   */
+  void at_eventstart(const Particles &particles,
+                     const int event_number) override;
+
+  /**
+   * Compacts the buffered photons of the event and writes them as one
+   * 'g' block, followed by the event end line.
+   * \param[in] particles Unused, needed since inherited.
+   * \param[in] event_number Number of event.
+   * \param[in] impact_parameter Impact parameter of this event.
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   double impact_parameter) override;
+
+  /**
+   * Buffers the photons of a photon interaction; nothing is written yet.
+   * \param[in] action Action that holds the produced photon.
+   * \param[in] density Unused, needed since inherited.
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+ private:
+  /// One buffered photon of the current event.
+  struct PhotonRecord {
+    /// Production 4-position of the photon.
+    FourVector position;
+    /// 4-momentum of the photon.
+    FourVector momentum;
+    /// Weight; merged records accumulate the weights of their photons.
+    double weight;
+  };
+
+  /// Photons of the current event, compacted and written at its end.
+  std::vector<PhotonRecord> records_;
+};
+
+/**
+ * \ingroup output
+ * \brief Compact binary output of the per-event interaction graph.
+ *
+ * Rescattering studies reconstruct particle ancestry from the process-id
+ * chains in the particle histories, which normally means writing the full
+ * collision output and post-processing it. This output records only the
+ * graph itself: one node per performed process (with its type and time)
+ * and the edges given by the particle ids connecting a producing to a
+ * consuming process. The nodes of an event are buffered and written at
+ * the event end as one varint-encoded 'v' block (see \ref format_binary_),
+ * which is orders of magnitude smaller than the collision history it
+ * replaces. Requested with the "Binary_Provenance" format of the
+ * \key Collisions content.
+ */
+class BinaryOutputProvenance : public BinaryOutputBase {
+ public:
+  /**
+   * Create the provenance output.
+   *
+   * \param[in] path Output path.
+   * \param[in] name Name of the output, "Collisions".
+   * \param[in] out_par A structure containing parameters of the output.
+   */
+  BinaryOutputProvenance(const bf::path &path, std::string name,
+                         const OutputParameters &out_par);
+
+  /// The origin process of the incoming particles is read from their
+  /// history, so the history bookkeeping has to stay enabled.
+  bool requires_history() const override { return true; }
+
+  /**
+   * Starts a new event: drops the buffered graph of the previous one.
+   * \param[in] particles Unused, needed since inherited.
+   * \param[in] event_number Unused, needed since inherited.
+   */
+  void at_eventstart(const Particles &particles,
+                     const int event_number) override;
+
+  /**
+   * Writes the buffered graph of the event as one 'v' block, followed by
+   * the event end line.
+   * \param[in] particles Unused, needed since inherited.
+   * \param[in] event_number Number of event.
+   * \param[in] impact_parameter Impact parameter of this event.
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   double impact_parameter) override;
+
+  /**
+   * Appends one graph node for the performed process; nothing is written
+   * yet. Wall crossings are skipped, they do not change the ancestry.
+   * \param[in] action Action that holds the information of the process.
+   * \param[in] density Unused, needed since inherited.
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+ private:
+  /**
+   * Appends an unsigned integer in varint encoding to the event buffer:
+   * 7 payload bits per byte, least significant group first, the high bit
+   * flags a continuation byte.
+   * \param[in] x Value to append.
+   */
+  void append_varint(uint64_t x);
+
+  /**
+   * \return The zigzag mapping of a signed value to an unsigned one
+   * (0, -1, 1, -2, ... to 0, 1, 2, 3, ...), so small deltas of either
+   * sign encode into few varint bytes.
+   * \param[in] x Value to map.
+   */
+  static uint64_t zigzag(int64_t x) {
+    return (static_cast<uint64_t>(x) << 1) ^ static_cast<uint64_t>(x >> 63);
+  }
+
+  /// Encoded graph nodes of the current event.
+  std::vector<uint8_t> buffer_;
+
+  /// Number of buffered graph nodes.
+  uint32_t n_nodes_ = 0;
+
+  /// Process id of the previously buffered node, for the delta encoding.
+  uint32_t previous_process_id_ = 0;
+
+  /// Quantized time of the previously buffered node, in units of 1e-3 fm.
+  int64_t previous_quantized_time_ = 0;
 };
 
 /**
@@ -193,9 +389,11 @@ class BinaryOutputParticles : public BinaryOutputBase {
    * \param[in] path Output path.
    * \param[in] name Name of the ouput.
    * \param[in] out_par A structure containing the parameters of the output.
+   * \param[in] compressed Whether the output is gzip-compressed.
    */
   BinaryOutputParticles(const bf::path &path, std::string name,
-                        const OutputParameters &out_par);
+                        const OutputParameters &out_par,
+                        bool compressed = false);
 
   /**
    * Writes the initial particle information of an event to the binary output.
@@ -224,8 +422,19 @@ class BinaryOutputParticles : public BinaryOutputBase {
                             const DensityParameters &dens_param) override;
 
  private:
+  /**
+   * Write one particle block, applying the content filters of the particles
+   * output: the block contains the number of passing particles followed by
+   * their data.
+   * \param[in] particles Current list of particles.
+   */
+  void write_filtered_block(const Particles &particles);
+
   /// Write only final particles (True) or both, inital and final (False).
   bool only_final_;
+
+  /// Parameters of the output, holding the content filters.
+  const OutputParameters out_par_;
 };
 
 }  // namespace smash
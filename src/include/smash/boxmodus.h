@@ -10,6 +10,7 @@
 #include <map>
 #include <memory>
 
+#include "distributions.h"
 #include "forwarddeclarations.h"
 #include "modusdefault.h"
 
@@ -116,6 +117,25 @@ class BoxModus : public ModusDefault {
     return 0.5 * std::sqrt(length_ * length_ - max_transverse_distance_sqr);
   }
 
+  /**
+   * \return An estimate of the maximal number of stored particles, twice
+   *         the initial multiplicity to leave headroom for particle
+   *         production. For the thermal initialization the multiplicities
+   *         are only sampled during the first event, so no estimate is
+   *         available and zero is returned.
+   * \param[in] ntest Number of test particles per physical particle.
+   */
+  int max_particle_number(int ntest) const {
+    if (use_thermal_) {
+      return 0;
+    }
+    int multiplicity = 0;
+    for (const auto &mult : init_multipl_) {
+      multiplicity += mult.second;
+    }
+    return 2 * multiplicity * ntest;
+  }
+
   /// \return Length of the box
   double length() const { return length_; }
 
@@ -153,6 +173,13 @@ class BoxModus : public ModusDefault {
    * Saved to avoid recalculating at every event
    */
   std::map<PdgCode, double> average_multipl_;
+  /**
+   * Inverse-CDF samplers of the thermal momentum distribution, one per
+   * stable species. Built on the first event and reused afterwards, so
+   * that the initialization cost scales linearly with the particle
+   * number instead of with the rejection rate of the thermal sampler.
+   */
+  std::map<PdgCode, ThermalMomentumSampler> thermal_samplers_;
 
   /**
    * \ingroup logging
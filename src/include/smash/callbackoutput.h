@@ -0,0 +1,175 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_CALLBACKOUTPUT_H_
+#define SRC_INCLUDE_CALLBACKOUTPUT_H_
+
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * \brief Forwards output calls to user-provided callbacks
+ *
+ * This output does not write any file. It hands the particle list and the
+ * interactions over to std::function callbacks, so analyses that are linked
+ * with SMASH (flow, spectra, etc.) can run in the same process without
+ * serializing and re-parsing any output file.
+ *
+ * Callbacks that are not set are simply skipped. The references passed to
+ * the callbacks are only valid for the duration of the call; a callback
+ * that wants to keep particle data beyond that has to copy it.
+ *
+ * A CallbackOutput is registered with \ref ExperimentBase::add_output, for
+ * example:
+ * \code
+ * auto experiment = ExperimentBase::create(config, output_path);
+ * auto callbacks = make_unique<CallbackOutput>("MyAnalysis");
+ * callbacks->set_eventend_callback(
+ *     [&](const Particles &particles, int event_number, double impact) {
+ *       analysis.fill(particles, event_number, impact);
+ *     });
+ * experiment->add_output(std::move(callbacks));
+ * experiment->run();
+ * \endcode
+ *
+ * \note The event-end call may be made from the asynchronous output writer
+ * thread; the callbacks therefore have to be safe to call from a thread
+ * other than the one running the experiment. They are never called
+ * concurrently with each other.
+ */
+class CallbackOutput : public OutputInterface {
+ public:
+  /// Callback type receiving the particle list and the event number.
+  using EventStartCallback = std::function<void(const Particles &, int)>;
+  /**
+   * Callback type receiving the particle list, the event number and the
+   * impact parameter.
+   */
+  using EventEndCallback = std::function<void(const Particles &, int, double)>;
+  /**
+   * Callback type receiving the action and the density at the interaction
+   * point.
+   */
+  using InteractionCallback = std::function<void(const Action &, double)>;
+  /// Callback type receiving the particle list and the output clock.
+  using IntermediateCallback =
+      std::function<void(const Particles &, const Clock &)>;
+
+  /**
+   * Create the callback output.
+   *
+   * \param[in] name Name of the output; only used in the Experiment
+   *            printout, no file of this name is created.
+   */
+  explicit CallbackOutput(const std::string &name) : OutputInterface(name) {}
+
+  /**
+   * Register the callback invoked at event start.
+   * \param[in] callback The callback to be invoked.
+   */
+  void set_eventstart_callback(EventStartCallback callback) {
+    eventstart_callback_ = std::move(callback);
+  }
+
+  /**
+   * Register the callback invoked at event end.
+   * \param[in] callback The callback to be invoked.
+   */
+  void set_eventend_callback(EventEndCallback callback) {
+    eventend_callback_ = std::move(callback);
+  }
+
+  /**
+   * Register the callback invoked at each interaction.
+   * \param[in] callback The callback to be invoked.
+   */
+  void set_interaction_callback(InteractionCallback callback) {
+    interaction_callback_ = std::move(callback);
+  }
+
+  /**
+   * Register the callback invoked at each intermediate output time.
+   * \param[in] callback The callback to be invoked.
+   */
+  void set_intermediate_callback(IntermediateCallback callback) {
+    intermediate_callback_ = std::move(callback);
+  }
+
+  /**
+   * Invoke the event-start callback, if one is registered.
+   * \param[in] particles Current list of all particles.
+   * \param[in] event_number Number of the current event.
+   */
+  void at_eventstart(const Particles &particles,
+                     const int event_number) override {
+    if (eventstart_callback_) {
+      eventstart_callback_(particles, event_number);
+    }
+  }
+
+  /**
+   * Invoke the event-end callback, if one is registered.
+   * \param[in] particles Current list of particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] impact_parameter Impact parameter of this event.
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   double impact_parameter) override {
+    if (eventend_callback_) {
+      eventend_callback_(particles, event_number, impact_parameter);
+    }
+  }
+
+  /**
+   * Invoke the interaction callback, if one is registered.
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Density at the interaction point.
+   */
+  void at_interaction(const Action &action, const double density) override {
+    if (interaction_callback_) {
+      interaction_callback_(action, density);
+    }
+  }
+
+  /**
+   * Invoke the intermediate-time callback, if one is registered.
+   * \param[in] particles Current list of particles.
+   * \param[in] clock System clock.
+   * \param[in] dens_param Unused, needed since inherited.
+   */
+  void at_intermediate_time(const Particles &particles, const Clock &clock,
+                            const DensityParameters &dens_param) override {
+    SMASH_UNUSED(dens_param);
+    if (intermediate_callback_) {
+      intermediate_callback_(particles, clock);
+    }
+  }
+
+ private:
+  /// Callback invoked at event start; may be empty.
+  EventStartCallback eventstart_callback_;
+  /// Callback invoked at event end; may be empty.
+  EventEndCallback eventend_callback_;
+  /// Callback invoked at each interaction; may be empty.
+  InteractionCallback interaction_callback_;
+  /// Callback invoked at each intermediate output time; may be empty.
+  IntermediateCallback intermediate_callback_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_CALLBACKOUTPUT_H_
@@ -0,0 +1,93 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_CHECKPOINT_H_
+#define SRC_INCLUDE_CHECKPOINT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "clock.h"
+#include "forwarddeclarations.h"
+#include "fourvector.h"
+#include "particledata.h"
+#include "quantumnumbers.h"
+#include "random.h"
+
+namespace smash {
+
+/**
+ * A snapshot of the evolving state of one event, taken at a timestep
+ * boundary.
+ *
+ * Together with the (unchanged) configuration this suffices to continue the
+ * run bit-exactly: pending actions do not have to be stored, because at a
+ * timestep boundary the action queue is empty and the search of the next
+ * timestep reconstructs it deterministically from the restored particles and
+ * random engine.
+ */
+struct CheckpointState {
+  /// Number of the event being computed
+  int32_t event_number = 0;
+  /// State of the computational frame clock
+  Clock::State labclock = {0, 0, 0};
+  /// State of the output clock
+  Clock::State outputclock = {0, 0, 0};
+  /// State of the random engine of the event thread
+  random::Engine::State engine = {0, 0, 0, {0, 0}, 0};
+  /// Total number of performed actions
+  uint64_t interactions_total = 0;
+  /// Performed actions at the previous intermediate output
+  uint64_t previous_interactions_total = 0;
+  /// Total number of wall crossings
+  uint64_t wall_actions_total = 0;
+  /// Wall crossings at the previous intermediate output
+  uint64_t previous_wall_actions_total = 0;
+  /// Total number of Pauli-blocked actions
+  uint64_t total_pauli_blocked = 0;
+  /// Number of intermediate outputs already written, drives output cadences
+  uint64_t intermediate_output_count = 0;
+  /// Number of density-trigger thresholds already crossed
+  uint64_t density_triggers_fired = 0;
+  /// Conserved quantities at the start of the event
+  QuantumNumbers conserved_initial;
+  /// All currently existing particles
+  ParticleList particles;
+  /// Beam momenta, non-empty only for frozen Fermi motion
+  std::vector<FourVector> beam_momentum;
+  /// Bookkeeping whether a nucleon has interacted, collider runs only
+  std::vector<bool> nucleon_has_interacted;
+};
+
+/**
+ * Write the state to a checkpoint file.
+ *
+ * The file is first written under a unique temporary name and then renamed,
+ * so an interrupted write never destroys the previous checkpoint.
+ *
+ * \param[in] file Name of the checkpoint file.
+ * \param[in] state The state to write.
+ */
+void write_checkpoint(const bf::path &file, const CheckpointState &state);
+
+/**
+ * Read a state back from a checkpoint file.
+ *
+ * \param[in] file Name of the checkpoint file.
+ * \return The restored state.
+ * \throw runtime_error if the file cannot be read, was written by a
+ *        different SMASH version or is corrupted.
+ */
+CheckpointState read_checkpoint(const bf::path &file);
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_CHECKPOINT_H_
@@ -126,6 +126,25 @@ class Clock {
   }
   /// \return the time step size.
   double timestep_duration() const { return convert(timestep_duration_); }
+  /// Serializable copy of the raw clock state, used for checkpointing.
+  struct State {
+    std::int64_t timestep_duration;  ///< \see timestep_duration_
+    std::int64_t reset_time;         ///< \see reset_time_
+    std::int64_t counter;            ///< \see counter_
+  };
+  /// \return A copy of the raw internal state.
+  State state() const { return {timestep_duration_, reset_time_, counter_}; }
+  /**
+   * Restore a state previously obtained from state(), making the clock
+   * bit-identical to the saved one.
+   *
+   * \param[in] state The state to restore.
+   */
+  void restore_state(const State &state) {
+    timestep_duration_ = state.timestep_duration;
+    reset_time_ = state.reset_time;
+    counter_ = state.counter;
+  }
   /**
    * Sets the time step size (and resets the counter).
    *
@@ -7,6 +7,7 @@
 #ifndef SRC_INCLUDE_COLLIDERMODUS_H_
 #define SRC_INCLUDE_COLLIDERMODUS_H_
 
+#include <cmath>
 #include <cstring>
 #include <memory>
 #include <utility>
@@ -93,10 +94,35 @@ class ColliderModus : public ModusDefault {
    *         the beam momenta in experiment.cc if Fermi motion is frozen.
    */
   double velocity_target() const { return velocity_target_; }
+  /**
+   * \return A generous estimate of the maximal number of stored particles a
+   *         single event can reach. The nuclei are already filled with test
+   *         particles, so total_N_number() carries the testparticle factor,
+   *         and the number of produced particles per incoming nucleon grows
+   *         logarithmically with the collision energy.
+   */
+  int max_particle_number(int /*ntest*/) const {
+    return static_cast<int>(total_N_number() *
+                            (4. + 10. * std::log(sqrt_s_NN_)));
+  }
   /**
    * \return A flag: whether to allow first collisions within the same nucleus.
    */
   bool cll_in_nucleus() { return cll_in_nucleus_; }
+  /**
+   * \return A flag: whether the spectator fast path is enabled, see
+   *         \key Spectator_Suppression.
+   */
+  bool spectator_suppression() const { return spectator_suppression_; }
+  /**
+   * Time after which the initial nuclei have passed through each other,
+   * measured from the start of the simulation. The estimate uses the
+   * uncontracted nuclear radii and the initial separation, so it errs
+   * towards a later time.
+   *
+   * \return The passing time of the nuclei. [fm/c]
+   */
+  double nuclei_passing_time();
   /// \return The Fermi motion type
   FermiMotion fermi_motion() { return fermi_motion_; }
   /// \return whether the modus is collider (which is, yes, trivially true)
@@ -202,6 +228,11 @@ class ColliderModus : public ModusDefault {
    * An option to accept first collisions within the same nucleus
    */
   bool cll_in_nucleus_ = false;
+  /**
+   * An option to freeze non-interacted nucleons after the nuclei have
+   * passed each other, see \key Spectator_Suppression.
+   */
+  bool spectator_suppression_ = false;
   /**
    * Beam velocity of the projectile
    */
@@ -11,6 +11,7 @@
 #define SRC_INCLUDE_CONFIGURATION_H_
 
 #include <array>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -661,6 +662,29 @@ class Configuration {
                                       "\" should be \"None\" or \"Fixed\".");
     }
 
+    /**
+     * Set memory placement policy from configuration values.
+     *
+     * \return memory placement policy.
+     * \throw IncorrectTypeInAssignment in case a memory policy that is
+     * not available is provided as a configuration value.
+     */
+    operator MemoryPolicy() const {
+      const std::string s = operator std::string();
+      if (s == "Default") {
+        return MemoryPolicy::Default;
+      }
+      if (s == "Interleave") {
+        return MemoryPolicy::Interleave;
+      }
+      if (s == "Local") {
+        return MemoryPolicy::Local;
+      }
+      throw IncorrectTypeInAssignment(
+          "The value for key \"" + std::string(key_) +
+          "\" should be \"Default\", \"Interleave\" or \"Local\".");
+    }
+
     /**
      * Set initial condition for box setup from configuration values.
      *
@@ -914,7 +938,9 @@ class Configuration {
    */
   template <typename T>
   Configuration operator[](T &&key) {
-    return root_node_[std::forward<T>(key)];
+    Configuration subobject = root_node_[std::forward<T>(key)];
+    subobject.frozen_ = frozen_;
+    return subobject;
   }
 
   /**
@@ -947,6 +973,23 @@ class Configuration {
    */
   std::string unused_values_report() const;
 
+  /**
+   * Forbid any further take() or read() on this configuration tree.
+   *
+   * All parameters that matter during the run are resolved into typed
+   * structures (ExperimentParameters and friends) while the experiment is
+   * set up. Freezing the configuration afterwards turns a late string-keyed
+   * YAML lookup from running code into an immediate error instead of a
+   * silent per-event map traversal. The flag is shared between all copies
+   * and subobjects of one tree.
+   *
+   * \throw std::logic_error on any subsequent take() or read().
+   */
+  void freeze() { *frozen_ = true; }
+
+  /// \return whether freeze() has been called on this configuration tree.
+  bool is_frozen() const { return *frozen_; }
+
   /**
    * Returns a YAML string of the current tree.
    *
@@ -966,6 +1009,9 @@ class Configuration {
 
   /// the general_config.yaml contents - fully parsed
   YAML::Node root_node_;
+
+  /// Set by freeze(), shared by all copies and subobjects of one tree.
+  std::shared_ptr<bool> frozen_ = std::make_shared<bool>(false);
 };
 
 }  // namespace smash
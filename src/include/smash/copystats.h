@@ -0,0 +1,102 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_COPYSTATS_H_
+#define SRC_INCLUDE_COPYSTATS_H_
+
+namespace smash {
+
+/**
+ * Counts the copies and moves of ParticleData objects, attributed to the
+ * phases of the evolution loop.
+ *
+ * ParticleData objects are a few hundred bytes large and are copied
+ * pervasively: into grid cells, into search lists, into the incoming and
+ * outgoing lists of actions, into output snapshots. Before and after a
+ * layout change the counters give the evidence which flows dominate and
+ * whether the change removed them.
+ *
+ * The instrumentation is a diagnostics build: it is compiled in with the
+ * \c PARTICLE_COPY_STATS cmake option (macro \c SMASH_PARTICLE_COPY_STATS)
+ * and is entirely absent otherwise, because even an always-off branch in
+ * the copy constructor would be paid on every copy. The current phase is
+ * tracked per thread by the RuntimeProfiler guards that already bracket
+ * the phases; copies made outside any guard count as "other".
+ */
+class CopyStats {
+ public:
+  /// The scopes copies and moves are attributed to.
+  enum class Scope : int {
+    /// Grid construction and collision/decay finding.
+    ActionSearch = 0,
+    /// Straight-line propagation between actions.
+    Propagation = 1,
+    /// Density lattice refresh and potential evaluation.
+    LatticeUpdate = 2,
+    /// Intermediate and event-end output.
+    Output = 3,
+    /// Final-state generation and performing of actions.
+    PerformAction = 4,
+    /// Everything outside the instrumented phases.
+    Other = 5,
+  };
+
+  /// Count one ParticleData copy in the current scope of this thread.
+  static void count_copy();
+
+  /// Count one ParticleData move in the current scope of this thread.
+  static void count_move();
+
+  /**
+   * Make \p scope the current scope of this thread.
+   *
+   * \param[in] scope The scope subsequent copies are attributed to.
+   * \return the previous scope, to be restored when the scope ends.
+   */
+  static Scope enter_scope(Scope scope);
+
+  /**
+   * Log the accumulated per-scope copy and move counts and clear the
+   * accumulators. Logs nothing when no copy or move was counted, in
+   * particular always in builds without the instrumentation.
+   */
+  static void report();
+};
+
+/**
+ * Empty base class of ParticleData that counts its copies and moves in the
+ * diagnostics build.
+ *
+ * In regular builds all special member functions are defaulted, so the
+ * base is trivial, adds no storage thanks to the empty base optimization,
+ * and leaves the copy semantics of ParticleData untouched.
+ */
+struct CopyCounted {
+#ifdef SMASH_PARTICLE_COPY_STATS
+  CopyCounted() = default;
+  /// Counts the copy.
+  CopyCounted(const CopyCounted &) { CopyStats::count_copy(); }
+  /// Counts the copy. \return *this
+  CopyCounted &operator=(const CopyCounted &) {
+    CopyStats::count_copy();
+    return *this;
+  }
+  /// Counts the move.
+  CopyCounted(CopyCounted &&) { CopyStats::count_move(); }
+  /// Counts the move. \return *this
+  CopyCounted &operator=(CopyCounted &&) {
+    CopyStats::count_move();
+    return *this;
+  }
+#endif
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_COPYSTATS_H_
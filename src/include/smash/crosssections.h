@@ -49,6 +49,16 @@ const double pipi_offset = 1.12;
 const double KN_offset = 15.15;
 }  // namespace transit_high_energy
 
+/**
+ * Identifies one of the two-to-two call sites that draw their candidate
+ * final states from the precomputed channel registry: the
+ * resonance-production sites of CrossSections::find_nn_xsection_from_type
+ * and the nucleon-pair absorption sites. Together with the incoming
+ * particle types, the site determines the candidate final states, so it
+ * is part of the registry key.
+ */
+enum class NNChannelSite { NN_to_NR, NN_to_DR, NN_to_dpi, BB_to_NN, dpi_to_NN };
+
 /**
  * The cross section class assembels everything that is needed to
  * calculate the cross section and returns a list of all possible reactions
@@ -133,6 +143,10 @@ class CrossSections {
    * \param[in] cm_momentum_sqr Square of the center-of-mass momentum of the
    * two initial particles.
    *
+   * The resonance is assumed to conserve charge and baryon number; the
+   * candidates of two_to_one are pre-filtered accordingly when the
+   * registry is built, so no conservation checks are repeated here.
+   *
    * \return The cross section for the process
    * [initial particle a] + [initial particle b] -> resonance.
    */
@@ -433,6 +447,8 @@ class CrossSections {
 
   /**
    * Utility function to avoid code replication in nn_xx().
+   * \param[in] site Call site identifier, used to key the precomputed
+   * channel registry together with the incoming types
    * \param[in] type_res_1 List of possible first final resonance types
    * \param[in] type_res_2 List of possible second final resonance types
    * \param[in] integrator Used to integrate over the kinematically allowed
@@ -442,7 +458,7 @@ class CrossSections {
    */
   template <class IntegrationMethod>
   CollisionBranchList find_nn_xsection_from_type(
-      const ParticleTypePtrList& type_res_1,
+      const NNChannelSite site, const ParticleTypePtrList& type_res_1,
       const ParticleTypePtrList& type_res_2,
       const IntegrationMethod integrator) const;
 
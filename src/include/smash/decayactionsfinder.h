@@ -10,9 +10,11 @@
 #ifndef SRC_INCLUDE_DECAYACTIONSFINDER_H_
 #define SRC_INCLUDE_DECAYACTIONSFINDER_H_
 
+#include <queue>
 #include <vector>
 
 #include "actionfinderfactory.h"
+#include "particledata.h"
 
 namespace smash {
 
@@ -21,32 +23,72 @@ namespace smash {
  * A simple decay finder:
  * Just loops through all particles and checks if they can decay during the next
  * timestep.
+ *
+ * With analytic scheduling the decay time of every resonance is instead
+ * sampled once when its momentum changes: find_scheduled_decays() pops the
+ * decays due in the current timestep, and find_actions_in_cell() - called
+ * for the outgoing particles of every performed action - refills the
+ * schedule. The exponential decay law is memoryless, so one sample at
+ * creation is distributed like the per-timestep re-rolls, but the
+ * per-timestep scan over all resonances disappears. Only correct without
+ * potentials, where the decay width of a particle stays constant between
+ * actions.
  */
 class DecayActionsFinder : public ActionFinderInterface {
  public:
-  /// Initialize the finder
-  DecayActionsFinder() {}
+  /**
+   * Initialize the finder
+   *
+   * \param[in] analytic_schedule Whether decays beyond the current timestep
+   * are kept in a persistent schedule instead of being re-rolled every
+   * timestep. Only correct without potentials.
+   */
+  explicit DecayActionsFinder(bool analytic_schedule = false)
+      : analytic_schedule_(analytic_schedule) {}
 
   /**
    * Check the whole particle list for decays.
    *
+   * With analytic scheduling, decays beyond \p dt are additionally pushed
+   * onto the persistent schedule.
+   *
    * \param[in] search_list All particles in grid cell.
    * \param[in] dt Size of timestep [fm]
    * \return List with the found (Decay)Action objects.
    */
-  ActionList find_actions_in_cell(const ParticleList &search_list,
+  ActionList find_actions_in_cell(const ParticleSlice &search_list,
                                   double dt) const override;
 
+  /**
+   * Pop all scheduled decays that are due within the current timestep.
+   * On the first call of an event the schedule is filled with the decay
+   * times of all particles; afterwards it is kept up to date by the
+   * find_actions_in_cell() calls for outgoing particles of performed
+   * actions. Decays whose particle has changed in the meantime are dropped
+   * silently - the interaction that invalidated them also scheduled their
+   * replacement.
+   *
+   * \param[in] particles The current particle list, for validation.
+   * \param[in] now Start time of the current timestep. [fm]
+   * \param[in] t_max Size of the current timestep. [fm]
+   * \return List of the decays due within this timestep.
+   */
+  ActionList find_scheduled_decays(const Particles &particles, double now,
+                                   double t_max);
+
+  /// Forget all scheduled decays, e.g. at the start of a new event.
+  void reset_scheduling();
+
   /// Ignore the neighbor searches for decays
-  ActionList find_actions_with_neighbors(const ParticleList &,
-                                         const ParticleList &,
+  ActionList find_actions_with_neighbors(const ParticleSlice &,
+                                         const ParticleSlice &,
                                          double) const override {
     return {};
   }
 
   /// Ignore the surrounding searches for decays
   ActionList find_actions_with_surrounding_particles(const ParticleList &,
-                                                     const Particles &,
+                                                     const ParticleList &,
                                                      double) const override {
     return {};
   }
@@ -62,6 +104,50 @@ class DecayActionsFinder : public ActionFinderInterface {
    */
   ActionList find_final_actions(const Particles &search_list,
                                 bool only_res = false) const override;
+
+ private:
+  /// One sampled decay.
+  struct ScheduledDecay {
+    /// Absolute time of the decay. [fm]
+    double time;
+    /// State of the particle when the decay was sampled.
+    ParticleData incoming;
+  };
+
+  /// Orders scheduled decays by ascending absolute time (min-heap).
+  struct MoreTime {
+    /// \return whether decay \p a happens after decay \p b.
+    bool operator()(const ScheduledDecay &a, const ScheduledDecay &b) const {
+      return a.time > b.time;
+    }
+  };
+
+  /**
+   * Sample the decay time of particle \p p once. If the decay is due
+   * within \p t_max the corresponding action is appended to \p actions,
+   * otherwise the decay is pushed onto the persistent schedule.
+   *
+   * \param[in] p The particle to examine.
+   * \param[in] t_max Time horizon for immediate actions. [fm]
+   * \param[out] actions List the due decays are appended to.
+   */
+  void sample_decay_time_(const ParticleData &p, double t_max,
+                          ActionList *actions) const;
+
+  /// Whether decay times are sampled once per momentum change.
+  const bool analytic_schedule_;
+
+  /**
+   * The scheduled decays, earliest on top. Mutable because
+   * find_actions_in_cell() is const in the finder interface but pushes the
+   * decays beyond its time horizon here.
+   */
+  mutable std::priority_queue<ScheduledDecay, std::vector<ScheduledDecay>,
+                              MoreTime>
+      schedule_;
+
+  /// Whether the schedule was initialized for the current event.
+  bool schedule_initialized_ = false;
 };
 
 }  // namespace smash
@@ -42,6 +42,22 @@ class DecayActionsFinderDilepton {
   void shine(const Particles& search_list, OutputInterface* output,
              double dt) const;
 
+  /**
+   * Print out possible dilepton decays of a single particle, see shine().
+   *
+   * Exists separately so that Experiment::propagate_and_shine can fuse
+   * the shining into the propagation pass over the particles. Unlike
+   * shine(), the caller has to make sure that \p output is a dilepton
+   * output.
+   *
+   * \param[in] p Particle to shine from.
+   * \param[in] output Pointer to the dilepton output.
+   * \param[in] dt Length of the time interval the particle was
+   *            propagated over [fm]
+   */
+  void shine_particle(const ParticleData& p, OutputInterface* output,
+                      double dt) const;
+
   /**
    * Shine dileptons from resonances at the end of the simulation.
    *
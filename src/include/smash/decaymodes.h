@@ -7,6 +7,7 @@
 #ifndef SRC_INCLUDE_DECAYMODES_H_
 #define SRC_INCLUDE_DECAYMODES_H_
 
+#include <iosfwd>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -85,6 +86,29 @@ class DecayModes {
    */
   static void load_decaymodes(const std::string &input);
 
+  /**
+   * Write the fully constructed decay modes of all particle types as the
+   * decay section of the binary tables cache. The weights are written after
+   * the renormalization, so reading the section back does not renormalize
+   * again.
+   *
+   * \param[out] output Stream the section is written to.
+   */
+  static void write_decaymodes_cache(std::ostream &output);
+
+  /**
+   * Initialize the global decay modes from the decay section of the binary
+   * tables cache, replacing the parsing done by load_decaymodes. The
+   * particle-type list has to be initialized before. Like load_decaymodes
+   * this must only be called once.
+   *
+   * \param[in] input Stream positioned at the decay section.
+   * \return whether the decay modes were built. If false is returned,
+   *         nothing was built and the caller has to fall back to
+   *         load_decaymodes.
+   */
+  static bool read_decaymodes_cache(std::istream &input);
+
   /**
    * Retrieve a decay type.
    *
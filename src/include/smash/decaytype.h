@@ -67,6 +67,24 @@ class DecayType {
    * \param[in] m Actual mass of the decaying particle [GeV].
    */
   virtual double width(double m0, double G0, double m) const = 0;
+  /**
+   * Add the mass-dependent width for a whole batch of masses to a per-mass
+   * accumulator. This amortizes the per-call setup of the width evaluation
+   * over the batch, e.g. when spectral functions are tabulated or dumped
+   * over a mass grid.
+   *
+   * The base implementation loops over \ref width; decay types whose width
+   * is cheap, branch-free math override it with a loop the compiler can
+   * vectorize.
+   *
+   * \param[in] m0 Pole mass of the decaying particle [GeV].
+   * \param[in] G0 Partial width at the pole mass [GeV].
+   * \param[in] m Batch of actual masses of the decaying particle [GeV].
+   * \param[inout] w Accumulator of the same size as \p m; the width at
+   *                \p m[i] is added to \p w[i].
+   */
+  virtual void add_width(double m0, double G0, const std::vector<double> &m,
+                         std::vector<double> &w) const;
   /**
    * \return The mass-dependent in-width for a resonance formation process.
    *
@@ -140,6 +158,9 @@ class TwoBodyDecayStable : public TwoBodyDecay {
 
   double width(double m0, double G0, double m) const override;
 
+  void add_width(double m0, double G0, const std::vector<double> &m,
+                 std::vector<double> &w) const override;
+
   double in_width(double m0, double G0, double m, double m1,
                   double m2) const override;
 
@@ -187,8 +208,9 @@ class TwoBodyDecaySemistable : public TwoBodyDecay {
   /// Cut-off parameter Λ for semi-stable decays.
   double Lambda_;
 
-  /// Tabulation of the resonance integrals.
-  mutable std::unique_ptr<Tabulation> tabulation_;
+  /** Tabulation of the resonance integrals, shared between all charge
+   * states of the decay and owned by the table registry in decaytype.cc. */
+  mutable const Tabulation *tabulation_;
 };
 
 /**
@@ -220,8 +242,9 @@ class TwoBodyDecayUnstable : public TwoBodyDecay {
   /// Cut-off parameter Λ for unstable decays.
   double Lambda_;
 
-  /// Tabulation of the resonance integrals.
-  mutable std::unique_ptr<Tabulation> tabulation_;
+  /** Tabulation of the resonance integrals, shared between all charge
+   * states of the decay and owned by the table registry in decaytype.cc. */
+  mutable const Tabulation *tabulation_;
 };
 
 /**
@@ -305,8 +328,9 @@ class ThreeBodyDecayDilepton : public ThreeBodyDecay {
   double width(double m0, double G0, double m) const override;
 
  protected:
-  /// Tabulation of the resonance integrals.
-  mutable std::unique_ptr<Tabulation> tabulation_;
+  /** Tabulation of the resonance integrals, shared between all charge
+   * states of the decay and owned by the table registry in decaytype.cc. */
+  mutable const Tabulation *tabulation_;
 
   /// Type of the mother particle.
   ParticleTypePtr mother_;
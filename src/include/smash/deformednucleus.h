@@ -7,7 +7,9 @@
 #ifndef SRC_INCLUDE_DEFORMEDNUCLEUS_H_
 #define SRC_INCLUDE_DEFORMEDNUCLEUS_H_
 
+#include <array>
 #include <map>
+#include <vector>
 
 #include "angles.h"
 #include "configuration.h"
@@ -87,10 +89,25 @@ class DeformedNucleus : public Nucleus {
   void rotate() override;
 
   /**
-   * Does not allow to generate Fermi-momenta for a deformed nucleus.
+   * Local nucleon number density of the deformed Woods-Saxon profile.
+   * The deformation is evaluated with respect to the rotated symmetry
+   * axis of the nucleus, since Fermi momenta are generated after
+   * rotate(). This enables Fermi motion for deformed nuclei through the
+   * generic Nucleus::generate_fermi_momenta().
+   *
+   * \param[in] pos Position relative to the center of the nucleus. [fm]
+   * \return Number density of nucleons at \p pos. [fm\f$^{-3}\f$]
+   */
+  double nucleon_density(const ThreeVector &pos) const override;
+
+  /**
+   * Does not allow to pre-sample an initial-state ensemble for a
+   * deformed nucleus: draw_from_ensemble() applies a random rotation,
+   * which would override the configured nuclear orientation.
    * \throws domain_error if this function is ever called
    */
-  void generate_fermi_momenta() override;
+  void sample_initial_ensemble(int n_configurations,
+                               bool with_fermi_motion) override;
 
   /**
    * Spherical harmonics Y_2_0 and Y_4_0.
@@ -127,6 +144,44 @@ class DeformedNucleus : public Nucleus {
   }
 
  private:
+  /**
+   * Build the inverse-CDF tables of the deformed Woods-Saxon
+   * distribution.
+   *
+   * At every angular node a radial quantile table is built with
+   * build_inverse_cdf(), and the radial integrals form the marginal of
+   * \f$\cos\vartheta\f$, whose inverse CDF is tabulated as well. The
+   * method only touches the mutable table caches, see radial_tables_.
+   *
+   * \param[in] radius_max Upper end of the tabulated radial interval.
+   */
+  void build_deformed_tables(double radius_max) const;
+
+  /**
+   * Build the sampling tables via build_deformed_tables() unless they
+   * already exist for the current Woods-Saxon and deformation
+   * parameters. Called from the constructor, so that the table cost is
+   * paid up front, and from distribute_nucleon(), which covers parameter
+   * changes after construction (e.g. in tests).
+   */
+  void ensure_deformed_tables_() const;
+
+  /// Number of cos(theta) nodes of the deformed sampling tables.
+  static constexpr size_t angular_nodes_ = 64;
+  /**
+   * Inverse CDF of the cos(theta) marginal of the deformed Woods-Saxon
+   * distribution; a lazily built cache like radial_tables_.
+   */
+  mutable std::vector<double> inverse_cdf_costheta_;
+  /**
+   * Radial inverse-CDF tables at the equidistant cos(theta) nodes. Like
+   * the spherical table in Nucleus these are pure caches: they are built
+   * on the first call of distribute_nucleon() and rebuilt whenever a
+   * Woods-Saxon or deformation parameter changed, hence mutable.
+   */
+  mutable std::vector<std::vector<double>> radial_tables_;
+  /// Radius, diffusiveness, beta2 and beta4 the tables were built for.
+  mutable std::array<double, 4> tabulated_parameters_{{0., 0., 0., 0.}};
   /// Deformation parameter for angular momentum l=2.
   double beta2_ = 0.0;
   /// Deformation parameter for angular momentum l=4.
@@ -9,7 +9,11 @@
 #ifndef SRC_INCLUDE_DENSITY_H_
 #define SRC_INCLUDE_DENSITY_H_
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <map>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -22,6 +26,7 @@
 #include "particledata.h"
 #include "particles.h"
 #include "pdgcode.h"
+#include "threadpool.h"
 #include "threevector.h"
 
 namespace smash {
@@ -113,17 +118,32 @@ class DensityParameters {
   DensityParameters(const ExperimentParameters &par)  // NOLINT
       : sig_(par.gaussian_sigma),
         r_cut_(par.gauss_cutoff_in_sigma * par.gaussian_sigma),
-        ntest_(par.testparticles) {
+        ntest_(par.testparticles),
+        n_ensembles_(par.n_ensembles) {
     r_cut_sqr_ = r_cut_ * r_cut_;
     const double two_sig_sqr = 2 * sig_ * sig_;
     two_sig_sqr_inv_ = 1. / two_sig_sqr;
     const double norm = smearing_factor_norm(two_sig_sqr);
     const double corr_factor =
         smearing_factor_rcut_correction(par.gauss_cutoff_in_sigma);
-    norm_factor_sf_ = 1. / (norm * ntest_ * corr_factor);
+    /* All ensembles deposit on the same lattice, so the densities are
+     * normalized by the ensemble number exactly like by the
+     * test-particle number. */
+    norm_factor_sf_ = 1. / (norm * ntest_ * n_ensembles_ * corr_factor);
+    /* Tabulate the smearing Gaussian over the squared contracted
+     * distance, which is the only quantity the exponential ever sees.
+     * Two extra entries keep the interpolation in smearing_exp() safe at
+     * the upper end of the range. */
+    exp_table_scale_ = exp_table_size_ / r_cut_sqr_;
+    exp_table_.resize(exp_table_size_ + 2);
+    for (size_t i = 0; i < exp_table_.size(); i++) {
+      exp_table_[i] = std::exp(-(i / exp_table_scale_) * two_sig_sqr_inv_);
+    }
   }
   /// \return Testparticle number
   int ntest() const { return ntest_; }
+  /// \return Number of parallel ensembles sharing the lattice
+  int n_ensembles() const { return n_ensembles_; }
   /// \return Cut-off radius [fm]
   double r_cut() const { return r_cut_; }
   /// \return Squared cut-off radius [fm\f$^2\f$]
@@ -137,7 +157,28 @@ class DensityParameters {
    */
   double norm_factor_sf() const { return norm_factor_sf_; }
 
+  /**
+   * Look up \f$ \exp(-r^2_{\rm rest} / 2\sigma^2) \f$ in the precomputed
+   * table instead of evaluating the exponential.
+   *
+   * The table is linearly interpolated; with its resolution over
+   * \f$ [0, r_{\rm cut}^2] \f$ the relative error stays below
+   * \f$ 10^{-6} \f$, well under the accuracy of the smearing itself.
+   *
+   * \param[in] r_rest_sqr Squared Lorentz-contracted distance from the
+   *            particle, must not exceed r_cut_sqr() [fm\f$^2\f$].
+   * \return The interpolated value of the smearing Gaussian.
+   */
+  double smearing_exp(const double r_rest_sqr) const {
+    const double position = r_rest_sqr * exp_table_scale_;
+    const size_t i = static_cast<size_t>(position);
+    const double fraction = position - i;
+    return exp_table_[i] * (1. - fraction) + exp_table_[i + 1] * fraction;
+  }
+
  private:
+  /// Number of bins of the tabulated smearing Gaussian.
+  static const size_t exp_table_size_ = 4096;
   /// Gaussian smearing width [fm]
   const double sig_;
   /// Cut-off radius [fm]
@@ -148,8 +189,14 @@ class DensityParameters {
   double two_sig_sqr_inv_;
   /// Normalization for smearing factor
   double norm_factor_sf_;
+  /// Tabulated smearing Gaussian over the squared contracted distance.
+  std::vector<double> exp_table_;
+  /// Bins of exp_table_ per unit of squared distance [fm\f$^{-2}\f$]
+  double exp_table_scale_;
   /// Testparticle number
   const int ntest_;
+  /// Number of parallel ensembles sharing the lattice
+  const int n_ensembles_;
 };
 
 /**
@@ -173,6 +220,42 @@ std::pair<double, ThreeVector> unnormalized_smearing_factor(
     const ThreeVector &r, const FourVector &p, const double m_inv,
     const DensityParameters &dens_par, const bool compute_gradient = false);
 
+/**
+ * Batch version of unnormalized_smearing_factor() for a contiguous x-row
+ * of lattice nodes.
+ *
+ * Along a row the Lorentz-contracted squared distance is a quadratic
+ * polynomial in the node index, so its coefficients are computed once per
+ * row and the remaining per-node work is one polynomial evaluation and
+ * one lookup in the tabulated Gaussian (DensityParameters::smearing_exp)
+ * in a tight branch-free loop over plain buffers, which the compiler can
+ * vectorize. Rows whose minimal contracted distance already exceeds the
+ * cut are skipped wholesale.
+ *
+ * \param[in] r0 Vector from the particle to the first node of the
+ *            row [fm].
+ * \param[in] dx Cell size in x-direction [fm].
+ * \param[in] n Number of nodes in the row.
+ * \param[in] p Particle 4-momentum to account for Lorentz
+ *            contraction [GeV].
+ * \param[in] m_inv Inverse particle mass \f$ (E^2 - p^2)^{-1/2} \f$
+ *            [GeV\f$^{-1}\f$].
+ * \param[in] dens_par Object containing precomputed parameters for
+ *            density calculation.
+ * \param[in] compute_gradient Option, true - compute gradients, false - no.
+ * \param[out] sf Smearing factors of the row nodes; nodes beyond the cut
+ *             radius get exactly 0. Resized to n entries.
+ * \param[out] sf_grad Gradients of the smearing factors, only filled if
+ *             \p compute_gradient is true.
+ * \return Whether any node of the row lies within the cut radius; if
+ *         false the buffers are left untouched.
+ */
+bool unnormalized_smearing_factor_row(
+    const ThreeVector &r0, double dx, int n, const FourVector &p,
+    const double m_inv, const DensityParameters &dens_par,
+    const bool compute_gradient, std::vector<double> &sf,
+    std::vector<ThreeVector> &sf_grad);
+
 /**
  * Calculates Eckart rest frame density and optionally the gradient of the
  * density in an arbitary frame, the curl of the 3-currrent and the time
@@ -218,6 +301,33 @@ std::tuple<double, ThreeVector, ThreeVector, ThreeVector> rho_eckart(
     const ThreeVector &r, const Particles &plist, const DensityParameters &par,
     DensityType dens_type, bool compute_gradient);
 
+/**
+ * Calculates the Eckart density of rho_eckart() at several points in one
+ * pass over the particle list. The per-particle quantities that all
+ * points share are computed once, and the points are evaluated in
+ * parallel by the shared thread pool, if any. Every point is summed by a
+ * single task in particle order, so the result equals a gradient-free
+ * rho_eckart() call at that point bit by bit and does not depend on the
+ * number of threads. Intended for thermodynamic probes and density
+ * profiles, where one particle scan per point becomes expensive.
+ *
+ * \param[in] points Space points where the density is calculated [fm]
+ * \param[in] plist List of all particles entering \f$j^{\mu}\f$
+ * \param[in] par Set of parameters packed in one structure
+ * \param[in] dens_type Type of four-current to be calculated
+ * \return Densities in the local Eckart frame at the given points
+ *         [fm\$f^{-3}\$f].
+ */
+std::vector<double> rho_eckart_batch(const std::vector<ThreeVector> &points,
+                                     const ParticleList &plist,
+                                     const DensityParameters &par,
+                                     DensityType dens_type);
+/// convenience overload of the above (ParticleList -> Particles)
+std::vector<double> rho_eckart_batch(const std::vector<ThreeVector> &points,
+                                     const Particles &plist,
+                                     const DensityParameters &par,
+                                     DensityType dens_type);
+
 /**
  * A class for time-efficient (time-memory trade-off) calculation of density
  * on the lattice. It holds six FourVectors - positive and negative
@@ -290,6 +400,51 @@ class DensityOnLattice {
     }
   }
 
+  /**
+   * Adds a recorded flow contribution to the 4-current, like
+   * add_particle(), but reconstructed from a stored footprint instead of
+   * a live particle. The summand is routed into jmu_pos_ or jmu_neg_ by
+   * the sign of \p dens_factor instead of the sign of \p FactorTimesSf,
+   * so that a removal (a negated contribution) lands in the same bucket
+   * as the addition it cancels. Used by IncrementalDensityUpdater.
+   *
+   * \param[in] four_velocity 4-velocity \f$(1, \vec v)\f$ the particle
+   *            was originally deposited with.
+   * \param[in] FactorTimesSf Contribution as in add_particle(), negated
+   *            when a footprint is removed.
+   * \param[in] dens_factor Density factor of the original deposit; its
+   *            sign selects the bucket.
+   */
+  void add_flow(const FourVector &four_velocity, double FactorTimesSf,
+                double dens_factor) {
+    if (dens_factor > 0.0) {
+      jmu_pos_ += four_velocity * FactorTimesSf;
+    } else {
+      jmu_neg_ += four_velocity * FactorTimesSf;
+    }
+  }
+
+  /**
+   * Adds a recorded flow contribution to the derivatives of the
+   * 4-current, like add_particle_for_derivatives(), but from a stored
+   * footprint. The derivatives are linear in the contributions, so a
+   * removal simply passes a negated \p factor.
+   *
+   * \param[in] four_velocity 4-velocity \f$(1, \vec v)\f$ the particle
+   *            was originally deposited with.
+   * \param[in] factor Density factor of the deposit, negated when the
+   *            footprint is removed.
+   * \param[in] sf_grad Smearing factor of the gradients
+   */
+  void add_flow_for_derivatives(const FourVector &four_velocity, double factor,
+                                const ThreeVector &sf_grad) {
+    for (int k = 1; k <= 3; k++) {
+      djmu_dx_[k] += factor * four_velocity * sf_grad[k - 1];
+      djmu_dx_[0] -= factor * four_velocity * sf_grad[k - 1] *
+                     four_velocity.threevec()[k - 1];
+    }
+  }
+
   /**
    * Compute the net Eckart density on the local lattice
    *
@@ -350,6 +505,26 @@ class DensityOnLattice {
     return djmu_dx_[0].threevec() * norm_factor;
   }
 
+  /**
+   * Overwrite the derivatives of the 4-current with externally computed
+   * values, discarding whatever particles deposited before. Used by the
+   * finite-difference derivatives mode, which derives them from the
+   * assembled 4-current field instead of per-particle kernel gradients.
+   *
+   * \param[in] djmu_dt Time derivative \f$\partial_t j^\mu\f$.
+   * \param[in] djmu_dx Derivative \f$\partial_x j^\mu\f$.
+   * \param[in] djmu_dy Derivative \f$\partial_y j^\mu\f$.
+   * \param[in] djmu_dz Derivative \f$\partial_z j^\mu\f$.
+   */
+  void overwrite_djmu_dx(const FourVector &djmu_dt, const FourVector &djmu_dx,
+                         const FourVector &djmu_dy,
+                         const FourVector &djmu_dz) {
+    djmu_dx_[0] = djmu_dt;
+    djmu_dx_[1] = djmu_dx;
+    djmu_dx_[2] = djmu_dy;
+    djmu_dx_[3] = djmu_dz;
+  }
+
   /**
    * \return Net current density
    *
@@ -358,6 +533,15 @@ class DensityOnLattice {
    */
   FourVector jmu_net() const { return jmu_pos_ + jmu_neg_; }
 
+  /// \return 4-current of the positively contributing particles.
+  const FourVector &jmu_pos() const { return jmu_pos_; }
+
+  /// \return 4-current of the negatively contributing particles.
+  const FourVector &jmu_neg() const { return jmu_neg_; }
+
+  /// \return The derivatives \f$\partial_\nu j^\mu\f$ of the 4-current.
+  const std::array<FourVector, 4> &djmu_dx() const { return djmu_dx_; }
+
  private:
   /// Four-current density of the positively charged particle.
   FourVector jmu_pos_;
@@ -371,9 +555,79 @@ class DensityOnLattice {
 typedef RectangularLattice<DensityOnLattice> DensityLattice;
 
 /**
- * Updates the contents on the lattice.
+ * Replace the derivatives of the 4-current on the whole lattice by finite
+ * differences of the assembled field: central differences between the
+ * neighboring nodes for the spatial derivatives (one-sided at the faces of
+ * a non-periodic lattice, wrapping around a periodic one) and the
+ * difference to the field of the previous call for the time derivative.
+ * The pass is a stride-1 stencil over the node array and runs on the
+ * shared thread pool when one exists.
+ *
+ * The lattice has to be filled by update_lattice() first; only the
+ * derivatives are overwritten, the 4-current itself is left alone.
+ *
+ * \param[inout] lat The density lattice whose derivatives are computed.
+ * \param[inout] jmu_old The 4-current field of the previous call, used for
+ *               the time derivative and refreshed with the current field
+ *               on return. Pass an empty vector on the first call (or
+ *               after an event reset); the time derivative is then zero.
+ * \param[in] time_interval Time since the previous call [fm/c].
+ */
+void compute_gradients_finite_difference(DensityLattice *lat,
+                                         std::vector<FourVector> &jmu_old,
+                                         double time_interval);
+
+/**
+ * Overwrite the whole lattice with the sum of two cached density fields,
+ * each translated rigidly along the beam (z) axis. Before the first
+ * interaction of a collider event the nuclei move as rigid bodies, so the
+ * smeared density field of each nucleus at a later time is its field at
+ * the snapshot time shifted by the beam velocity times the elapsed time.
+ * Every node samples both snapshots at its shifted position by trilinear
+ * interpolation between the eight surrounding snapshot nodes; the
+ * positive and negative current buckets and all four derivatives of the
+ * current are interpolated, so the result feeds the potentials exactly
+ * like a freshly deposited lattice. A shifted position outside a
+ * non-periodic snapshot contributes nothing, i.e. matter that was beyond
+ * the lattice at the snapshot time enters as vacuum. The pass runs on
+ * the shared thread pool when one exists.
+ *
+ * \param[out] lat The density lattice to be overwritten.
+ * \param[in] snap_projectile Snapshot of the projectile contribution,
+ *            with the same geometry as \p lat.
+ * \param[in] shift_projectile Projectile displacement along z since the
+ *            snapshot [fm].
+ * \param[in] snap_target Snapshot of the target contribution, with the
+ *            same geometry as \p lat.
+ * \param[in] shift_target Target displacement along z since the
+ *            snapshot [fm].
+ */
+void fill_lattice_from_rigid_snapshots(DensityLattice *lat,
+                                       const DensityLattice &snap_projectile,
+                                       double shift_projectile,
+                                       const DensityLattice &snap_target,
+                                       double shift_target);
+
+/**
+ * Updates the contents on one lattice, and optionally on a second lattice
+ * of identical structure in the same particle pass.
+ *
+ * If the shared thread pool exists, the Gaussian smearing contributions are
+ * scattered in parallel over z-slabs of the lattice; otherwise the update
+ * runs serially. Both paths produce identical lattices, because additions
+ * to any given node always happen on one thread and in particle order.
+ *
+ * When \p lat_extra is given, every smearing factor is evaluated once and
+ * deposited into the nodes of both lattices. This is what the
+ * thermodynamic output uses to fill the density and energy-momentum tensor
+ * lattices together; updating them separately doubles the smearing work,
+ * which dominates the cost of these passes.
  *
  * \param[out] lat The lattice on which the content will be updated
+ * \param[out] lat_extra Optional second lattice filled in the same pass.
+ *             It has to share the structure of \p lat; lattices of a
+ *             different geometry or update schedule are updated with a
+ *             separate pass of their own instead.
  * \param[in] update tells if called for update at printout or at timestep
  * \param[in] dens_type density type to be computed on the lattice
  * \param[in] par a structure containing testparticles number and gaussian
@@ -381,18 +635,143 @@ typedef RectangularLattice<DensityOnLattice> DensityLattice;
  * \param[in] particles the particles vector
  * \param[in] compute_gradient Whether to compute the gradients
  * \tparam T LatticeType
+ * \tparam TExtra LatticeType of the second lattice
  */
-template <typename T>
-void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
-                    const DensityType dens_type, const DensityParameters &par,
-                    const Particles &particles,
+template <typename T, typename TExtra>
+void update_lattice(RectangularLattice<T> *lat,
+                    RectangularLattice<TExtra> *lat_extra,
+                    const LatticeUpdate update, const DensityType dens_type,
+                    const DensityParameters &par, const Particles &particles,
                     const bool compute_gradient = false) {
   // Do not proceed if lattice does not exists/update not required
   if (lat == nullptr || lat->when_update() != update) {
+    if (lat_extra != nullptr) {
+      update_lattice(lat_extra, update, dens_type, par, particles,
+                     compute_gradient);
+    }
     return;
   }
+  if (lat_extra != nullptr &&
+      (lat_extra->when_update() != update ||
+       !lat->identical_to_lattice(lat_extra))) {
+    // No common pass possible - update the second lattice on its own.
+    update_lattice(lat_extra, update, dens_type, par, particles,
+                   compute_gradient);
+    lat_extra = nullptr;
+  }
   lat->reset();
+  if (lat_extra != nullptr) {
+    lat_extra->reset();
+  }
   const double norm_factor = par.norm_factor_sf();
+  ThreadPool *const pool = shared_pool();
+  if (pool != nullptr) {
+    /* Scatter the smearing contributions in parallel over z-slabs of the
+     * lattice. Every slab is written by exactly one task, so no two threads
+     * ever touch the same node and neither locks nor per-thread lattice
+     * copies are needed. The particles and the cell ranges they smear into
+     * are collected serially first; this is cheap compared to evaluating
+     * the smearing factors. */
+    struct Contribution {
+      const ParticleData *part;
+      double dens_factor;
+      FourVector p;
+      double m_inv;
+      ThreeVector pos;
+      std::array<int, 3> l_bounds;
+      std::array<int, 3> u_bounds;
+    };
+    const int n_z = lat->dimensions()[2];
+    const int num_slabs = std::min(n_z, 4 * pool->num_threads());
+    const int slab_height = (n_z + num_slabs - 1) / num_slabs;
+    std::vector<Contribution> contributions;
+    std::vector<std::vector<size_t>> slab_members(num_slabs);
+    for (const auto &part : particles) {
+      Contribution c;
+      c.dens_factor = density_factor(part.type(), dens_type);
+      if (std::abs(c.dens_factor) < really_small) {
+        continue;
+      }
+      c.p = part.momentum();
+      const double m = c.p.abs();
+      if (unlikely(m < really_small)) {
+        const auto &log = logger<LogArea::Density>();
+        log.warn("Gaussian smearing is undefined for momentum ", c.p);
+        continue;
+      }
+      c.m_inv = 1.0 / m;
+      c.pos = part.position().threevec();
+      if (!lat->bounds_in_radius(c.pos, par.r_cut(), c.l_bounds, c.u_bounds)) {
+        continue;
+      }
+      c.part = &part;
+      const size_t index = contributions.size();
+      contributions.push_back(c);
+      /* On a periodic lattice the z-bounds are not clipped, so the wrapped
+       * index decides which slab a cell row belongs to. */
+      for (int iz = c.l_bounds[2]; iz < c.u_bounds[2]; iz++) {
+        const size_t slab = ((iz % n_z) + n_z) % n_z / slab_height;
+        if (slab_members[slab].empty() || slab_members[slab].back() != index) {
+          slab_members[slab].push_back(index);
+        }
+      }
+    }
+    const double dx = lat->cell_sizes()[0];
+    pool->parallel_range(num_slabs, [&](size_t s) {
+      const int slab_begin = static_cast<int>(s) * slab_height;
+      const int slab_end = std::min(n_z, slab_begin + slab_height);
+      /* Row buffers of the batched smearing kernel; reused over all rows
+       * of the slab and local to this task, so no synchronization. */
+      std::vector<double> sf_row;
+      std::vector<ThreeVector> sf_grad_row;
+      for (const size_t ci : slab_members[s]) {
+        const Contribution &c = contributions[ci];
+        const int n_x = c.u_bounds[0] - c.l_bounds[0];
+        for (int iz = c.l_bounds[2]; iz < c.u_bounds[2]; iz++) {
+          const int iz_wrapped = ((iz % n_z) + n_z) % n_z;
+          if (iz_wrapped < slab_begin || iz_wrapped >= slab_end) {
+            continue;
+          }
+          for (int iy = c.l_bounds[1]; iy < c.u_bounds[1]; iy++) {
+            const ThreeVector r0 =
+                c.pos - lat->cell_center(c.l_bounds[0], iy, iz);
+            if (!unnormalized_smearing_factor_row(r0, dx, n_x, c.p, c.m_inv,
+                                                  par, compute_gradient,
+                                                  sf_row, sf_grad_row)) {
+              continue;
+            }
+            lat->iterate_sublattice_indices(
+                {c.l_bounds[0], iy, iz}, {c.u_bounds[0], iy + 1, iz + 1},
+                [&](size_t index, int ix, int, int) {
+                  const double sf = sf_row[ix - c.l_bounds[0]];
+                  if (sf * norm_factor > really_small) {
+                    (*lat)[index].add_particle(
+                        *c.part, sf * norm_factor * c.dens_factor);
+                    if (lat_extra != nullptr) {
+                      (*lat_extra)[index].add_particle(
+                          *c.part, sf * norm_factor * c.dens_factor);
+                    }
+                  }
+                  if (compute_gradient) {
+                    (*lat)[index].add_particle_for_derivatives(
+                        *c.part, c.dens_factor,
+                        sf_grad_row[ix - c.l_bounds[0]] * norm_factor);
+                    if (lat_extra != nullptr) {
+                      (*lat_extra)[index].add_particle_for_derivatives(
+                          *c.part, c.dens_factor,
+                          sf_grad_row[ix - c.l_bounds[0]] * norm_factor);
+                    }
+                  }
+                });
+          }
+        }
+      }
+    });
+    return;
+  }
+  const double dx = lat->cell_sizes()[0];
+  std::vector<double> sf_row;
+  std::vector<ThreeVector> sf_grad_row;
   for (const auto &part : particles) {
     const double dens_factor = density_factor(part.type(), dens_type);
     if (std::abs(dens_factor) < really_small) {
@@ -408,22 +787,191 @@ void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
     const double m_inv = 1.0 / m;
 
     const ThreeVector pos = part.position().threevec();
-    lat->iterate_in_radius(
-        pos, par.r_cut(), [&](T &node, int ix, int iy, int iz) {
-          const ThreeVector r = lat->cell_center(ix, iy, iz);
-          const auto sf = unnormalized_smearing_factor(pos - r, p, m_inv, par,
-                                                       compute_gradient);
-          if (sf.first * norm_factor > really_small) {
-            node.add_particle(part, sf.first * norm_factor * dens_factor);
-          }
-          if (compute_gradient) {
-            node.add_particle_for_derivatives(part, dens_factor,
-                                              sf.second * norm_factor);
-          }
-        });
+    std::array<int, 3> l_bounds, u_bounds;
+    if (!lat->bounds_in_radius(pos, par.r_cut(), l_bounds, u_bounds)) {
+      continue;
+    }
+    const int n_x = u_bounds[0] - l_bounds[0];
+    for (int iz = l_bounds[2]; iz < u_bounds[2]; iz++) {
+      for (int iy = l_bounds[1]; iy < u_bounds[1]; iy++) {
+        const ThreeVector r0 = pos - lat->cell_center(l_bounds[0], iy, iz);
+        if (!unnormalized_smearing_factor_row(r0, dx, n_x, p, m_inv, par,
+                                              compute_gradient, sf_row,
+                                              sf_grad_row)) {
+          continue;
+        }
+        lat->iterate_sublattice_indices(
+            {l_bounds[0], iy, iz}, {u_bounds[0], iy + 1, iz + 1},
+            [&](size_t index, int ix, int, int) {
+              const double sf = sf_row[ix - l_bounds[0]];
+              if (sf * norm_factor > really_small) {
+                (*lat)[index].add_particle(part,
+                                           sf * norm_factor * dens_factor);
+                if (lat_extra != nullptr) {
+                  (*lat_extra)[index].add_particle(
+                      part, sf * norm_factor * dens_factor);
+                }
+              }
+              if (compute_gradient) {
+                (*lat)[index].add_particle_for_derivatives(
+                    part, dens_factor,
+                    sf_grad_row[ix - l_bounds[0]] * norm_factor);
+                if (lat_extra != nullptr) {
+                  (*lat_extra)[index].add_particle_for_derivatives(
+                      part, dens_factor,
+                      sf_grad_row[ix - l_bounds[0]] * norm_factor);
+                }
+              }
+            });
+      }
+    }
   }
 }
 
+/**
+ * Updates the contents on the lattice.
+ *
+ * \param[out] lat The lattice on which the content will be updated
+ * \param[in] update tells if called for update at printout or at timestep
+ * \param[in] dens_type density type to be computed on the lattice
+ * \param[in] par a structure containing testparticles number and gaussian
+ *            smearing parameters.
+ * \param[in] particles the particles vector
+ * \param[in] compute_gradient Whether to compute the gradients
+ * \tparam T LatticeType
+ */
+template <typename T>
+void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
+                    const DensityType dens_type, const DensityParameters &par,
+                    const Particles &particles,
+                    const bool compute_gradient = false) {
+  update_lattice(lat, static_cast<RectangularLattice<T> *>(nullptr), update,
+                 dens_type, par, particles, compute_gradient);
+}
+
+/**
+ * Incrementally maintains a density lattice from per-particle smearing
+ * footprints.
+ *
+ * A full update_lattice() call resets the lattice and re-deposits every
+ * particle, although between two consecutive calls most particles have
+ * barely moved. This class records per particle the position, 4-velocity
+ * and density factor of the last deposited smearing contribution. On
+ * update() a particle whose position moved by less than a configured
+ * distance and whose 4-velocity changed correspondingly little keeps its
+ * old deposit; only the footprints of particles beyond the tolerance and
+ * of appeared or disappeared particles are subtracted and re-deposited.
+ * The computed densities therefore lag behind slowly drifting particles
+ * by up to the configured distance - an approximation traded for speed,
+ * so the distance should be small against the Gaussian smearing width.
+ *
+ * A removal replays the identical smearing rows of the deposit with the
+ * opposite sign, so it cancels the addition up to floating-point
+ * round-off; a full recomputation every refresh_interval_ updates keeps
+ * that round-off from accumulating. The updater pays off when lattice
+ * updates are frequent compared to momentum changes, e.g. in box runs
+ * with potentials on a fine lattice, where between collisions the
+ * potential forces barely change the momenta.
+ */
+class IncrementalDensityUpdater {
+ public:
+  /**
+   * \param[in] tolerance Distance [fm] a particle may move away from its
+   *            deposited footprint before the footprint is re-deposited.
+   */
+  explicit IncrementalDensityUpdater(double tolerance);
+
+  /**
+   * Brings the lattice up to date with the given particles, see the
+   * class description. The first call and every refresh_interval_-th
+   * call recompute the lattice from scratch with update_lattice().
+   *
+   * \param[out] lat The lattice on which the content will be updated
+   * \param[in] update tells if called for update at printout or at timestep
+   * \param[in] dens_type density type to be computed on the lattice
+   * \param[in] par a structure containing testparticles number and gaussian
+   *            smearing parameters.
+   * \param[in] particles the particles vector
+   * \param[in] compute_gradient Whether to compute the gradients
+   */
+  void update(DensityLattice *lat, LatticeUpdate update, DensityType dens_type,
+              const DensityParameters &par, const Particles &particles,
+              bool compute_gradient);
+
+  /**
+   * \return Whether the last update() recomputed every node, in which
+   *         case dirty_nodes() is meaningless and all-ones.
+   */
+  bool all_nodes_dirty() const { return all_dirty_; }
+
+  /**
+   * Drops the recorded footprints, forcing the next update() to
+   * recompute the lattice from scratch. Needed when the lattice content
+   * was overwritten behind the updater's back, e.g. by the cached rigid
+   * nuclei of the collider approach phase.
+   */
+  void invalidate() {
+    footprints_.clear();
+    updates_since_refresh_ = 0;
+  }
+
+  /**
+   * \return Per-node flags marking the nodes the last update() deposited
+   *         on. A node with zero flag holds bitwise the same density as
+   *         before the update, so quantities derived from it (e.g. the
+   *         potentials and their forces) are still valid and need no
+   *         recomputation.
+   */
+  const std::vector<char> &dirty_nodes() const { return dirty_; }
+
+ private:
+  /// Last deposited smearing contribution of one particle.
+  struct Footprint {
+    /// Position the smearing rows were evaluated at
+    ThreeVector position;
+    /// 4-velocity \f$ p^\mu/m \f$ entering the Lorentz contraction
+    FourVector u;
+    /// Velocity the 4-current contribution was built with
+    ThreeVector velocity;
+    /// Density factor of the deposit, see density_factor()
+    double dens_factor;
+    /// Mark-and-sweep flag to detect disappeared particles
+    bool seen;
+  };
+
+  /**
+   * Deposits (\p sign = 1) or removes (\p sign = -1) the footprint on
+   * the lattice, replaying the same smearing rows that update_lattice()
+   * evaluates.
+   *
+   * \param[out] lat The lattice on which the content will be updated
+   * \param[in] fp The footprint to deposit or remove
+   * \param[in] sign +1 to deposit, -1 to remove
+   * \param[in] par a structure containing testparticles number and gaussian
+   *            smearing parameters.
+   * \param[in] compute_gradient Whether to compute the gradients
+   */
+  void deposit(DensityLattice *lat, const Footprint &fp, double sign,
+               const DensityParameters &par, bool compute_gradient);
+
+  /// Number of incremental updates after which a full recomputation runs.
+  static constexpr int refresh_interval_ = 100;
+  /// Footprints of the last deposits, keyed by particle id.
+  std::map<int32_t, Footprint> footprints_;
+  /// Squared movement tolerance [fm\f$^2\f$].
+  const double tolerance_sqr_;
+  /// Incremental updates since the last full recomputation.
+  int updates_since_refresh_ = 0;
+  /// Row buffer of the smearing kernel, reused between deposits.
+  std::vector<double> sf_row_;
+  /// \see sf_row_
+  std::vector<ThreeVector> sf_grad_row_;
+  /// Flags of the nodes the last update() touched, see dirty_nodes().
+  std::vector<char> dirty_;
+  /// \see all_nodes_dirty()
+  bool all_dirty_ = true;
+};
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_DENSITY_H_
@@ -0,0 +1,96 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_DIGESTOUTPUT_H_
+#define SRC_INCLUDE_DIGESTOUTPUT_H_
+
+#include <cstdint>
+#include <string>
+
+#include "file.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * \brief Writes an order-independent hash of every event.
+ *
+ * The digest output condenses the final particle list of each event (and
+ * optionally every performed interaction) into one 64-bit hash per event.
+ * Two runs that went through the same physics produce the same digests, so
+ * a serial and a parallel run, or a run before and after an optimization,
+ * can be compared over millions of events by comparing two small files
+ * instead of storing the full outputs.
+ *
+ * The per-particle hashes are combined by addition, which makes the digest
+ * independent of the iteration order of the particle storage; the same
+ * holds for the particles within one interaction and for the interactions
+ * within one event. The hash covers the species and the full bit patterns
+ * of position and momentum, so any deviation in the final state shows up.
+ */
+class DigestOutput : public OutputInterface {
+ public:
+  /**
+   * Create the digest output.
+   *
+   * \param[in] path Path to the output directory.
+   * \param[in] name Name of the output.
+   * \param[in] out_par Parameters of the output, in particular whether the
+   *            performed interactions are hashed as well.
+   */
+  DigestOutput(const bf::path &path, const std::string &name,
+               const OutputParameters &out_par);
+
+  /**
+   * Resets the interaction digest of the new event.
+   * \param[in] particles Unused, needed since inherited.
+   * \param[in] event_number Unused, needed since inherited.
+   */
+  void at_eventstart(const Particles &particles,
+                     const int event_number) override;
+
+  /**
+   * Computes the digest of the final particle list and writes the digest
+   * line of the event.
+   * \param[in] particles Final list of particles.
+   * \param[in] event_number Number of the event.
+   * \param[in] impact_parameter Unused, needed since inherited.
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   double impact_parameter) override;
+
+  /**
+   * Folds the interaction into the interaction digest of the event, if
+   * hashing the interactions is enabled.
+   * \param[in] action The performed action.
+   * \param[in] density Unused, needed since inherited.
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+ private:
+  /// Pointer to the output file.
+  RenamingFilePtr file_;
+
+  /// Whether the performed interactions are hashed as well.
+  const bool hash_collisions_;
+
+  /// Combined hash of the interactions performed in the current event.
+  std::uint64_t actions_digest_ = 0;
+
+  /// Number of interactions folded into actions_digest_.
+  std::uint64_t actions_count_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_DIGESTOUTPUT_H_
@@ -7,6 +7,9 @@
 #ifndef SRC_INCLUDE_DISTRIBUTIONS_H_
 #define SRC_INCLUDE_DISTRIBUTIONS_H_
 
+#include <cstddef>
+#include <vector>
+
 namespace smash {
 
 /**
@@ -163,6 +166,66 @@ double sample_momenta_2M_IC(const double temperature, const double mass);
  */
 double sample_momenta_from_thermal(const double temperature, const double mass);
 
+/**
+ * Sampler of the radial momentum of the Maxwell-Boltzmann (thermal)
+ * distribution \f$ p^2 \exp(-\sqrt{p^2+m^2}/T) \f$ for one fixed mass and
+ * temperature.
+ *
+ * While sample_momenta_from_thermal() draws with rejection loops whose
+ * acceptance rate depends on \f$ T/m \f$, this sampler tabulates the CDF
+ * once in the constructor on a momentum grid fine enough to resolve the
+ * exponential tail, together with a guide table into the grid; every
+ * draw afterwards costs a single uniform random number and an amortized
+ * O(1) table lookup. This pays off whenever many momenta are needed for
+ * the same (mass, temperature) pair, e.g. for the thermal box
+ * initialization.
+ */
+class ThermalMomentumSampler {
+ public:
+  /// Construct an empty sampler that matches no (mass, temperature) pair.
+  ThermalMomentumSampler() = default;
+
+  /**
+   * Build the inverse-CDF table for the given parameters.
+   *
+   * \param[in] mass Mass of the particles to sample momenta for [GeV]
+   * \param[in] temperature Temperature \f$T\f$ [GeV]
+   */
+  ThermalMomentumSampler(double mass, double temperature);
+
+  /**
+   * \return One radial momentum, distributed like the result of
+   *         sample_momenta_from_thermal() [GeV]
+   */
+  double sample() const;
+
+  /**
+   * \param[in] mass Mass to check against [GeV]
+   * \param[in] temperature Temperature to check against [GeV]
+   * \return whether the table was built for exactly these parameters.
+   */
+  bool is_tabulated_for(double mass, double temperature) const {
+    return !cdf_.empty() && mass == mass_ && temperature == temperature_;
+  }
+
+ private:
+  /// Normalized CDF of the distribution on a uniform momentum grid
+  std::vector<double> cdf_;
+  /**
+   * Guide table: for equidistant quantiles, the first grid index whose
+   * CDF value is not below the quantile. Sampling starts the search for
+   * a uniform random number here, so only a few CDF entries have to be
+   * scanned per draw.
+   */
+  std::vector<size_t> guide_;
+  /// Spacing of the momentum grid [GeV]
+  double dp_ = 0.;
+  /// Mass the table was built for [GeV]
+  double mass_ = -1.;
+  /// Temperature the table was built for [GeV]
+  double temperature_ = -1.;
+};
+
 /**
  * Sample momenta according to the momentum distribution
  * in \iref{Bazow:2016oky}
@@ -0,0 +1,131 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_EVENTARENA_H_
+#define SRC_INCLUDE_EVENTARENA_H_
+
+#include <cstddef>
+
+namespace smash {
+
+/**
+ * A monotonic memory arena for transient allocations whose lifetime is
+ * bounded by one event.
+ *
+ * Per-event and per-timestep scratch structures (the cell layout of the
+ * collision-search grid, its build transients, and similar) are allocated
+ * and freed over and over with the same sizes. Serving them from the
+ * general-purpose heap costs a lock or cache transfer per call when many
+ * SMASH processes share a node. The arena instead hands out memory by
+ * bumping a pointer through chunks that are retained across events: after
+ * the first event has established the peak, no further system allocations
+ * happen and the per-event memory behavior is flat.
+ *
+ * Each thread bump-allocates from its own chunks, so there is no
+ * synchronization on the allocation path. Freeing the most recent
+ * allocation of a thread rewinds the bump pointer, which covers the
+ * typical scoped (last-in, first-out) use; any other free is a no-op and
+ * the memory is recovered by reset(), which the Experiment calls between
+ * events. Long-lived data — the particle storage, the type tables, the
+ * lattices — must stay on the normal heap.
+ */
+class EventArena {
+ public:
+  /**
+   * Allocate \p bytes from the arena of the calling thread.
+   *
+   * \param[in] bytes Size of the allocation. It is rounded up so that the
+   *            returned memory is suitably aligned for any type.
+   * \return Pointer to the allocated memory. Never nullptr.
+   */
+  static void *allocate(std::size_t bytes);
+
+  /**
+   * Return an allocation to the arena.
+   *
+   * If it is the most recent allocation of the calling thread the bump
+   * pointer is rewound and the memory is reused immediately; otherwise it
+   * stays occupied until the next reset().
+   *
+   * \param[in] ptr Pointer obtained from allocate().
+   * \param[in] bytes The size that was passed to allocate().
+   */
+  static void deallocate(void *ptr, std::size_t bytes);
+
+  /**
+   * Make the memory of all threads' arenas available again, keeping the
+   * chunks for the next event.
+   *
+   * All arena allocations are invalidated, so this must only be called
+   * between events, when no arena-backed object is alive and no worker
+   * thread is allocating.
+   */
+  static void reset();
+};
+
+/**
+ * Standard-library compatible allocator that serves containers from the
+ * EventArena.
+ *
+ * Only hand this to containers that die before the next EventArena::reset,
+ * i.e. whose lifetime is contained in one event.
+ *
+ * \tparam T Type of the allocated elements.
+ */
+template <typename T>
+class EventArenaAllocator {
+ public:
+  /// Type of the allocated elements.
+  using value_type = T;
+
+  EventArenaAllocator() = default;
+
+  /// Converting copy constructor, required of allocators.
+  template <typename U>
+  EventArenaAllocator(const EventArenaAllocator<U> &) {}
+
+  /**
+   * Allocate storage for \p n elements from the event arena.
+   *
+   * \param[in] n Number of elements.
+   * \return Pointer to the uninitialized storage.
+   */
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(EventArena::allocate(n * sizeof(T)));
+  }
+
+  /**
+   * Return the storage of \p n elements to the event arena.
+   *
+   * \param[in] p Pointer obtained from allocate().
+   * \param[in] n The element count that was passed to allocate().
+   */
+  void deallocate(T *p, std::size_t n) {
+    EventArena::deallocate(p, n * sizeof(T));
+  }
+};
+
+/// \return Whether the allocators are interchangeable, which they always
+/// are: memory may be returned through any instance.
+template <typename T, typename U>
+bool operator==(const EventArenaAllocator<T> &,
+                const EventArenaAllocator<U> &) {
+  return true;
+}
+
+/// \return The negation of operator==, i.e. always false.
+template <typename T, typename U>
+bool operator!=(const EventArenaAllocator<T> &,
+                const EventArenaAllocator<U> &) {
+  return false;
+}
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_EVENTARENA_H_
@@ -7,20 +7,33 @@
 #ifndef SRC_INCLUDE_EXPERIMENT_H_
 #define SRC_INCLUDE_EXPERIMENT_H_
 
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <iostream>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "actionfinderfactory.h"
 #include "actions.h"
+#include "asynclogsink.h"
+#include "checkpoint.h"
 #include "chrono.h"
 #include "decayactionsfinder.h"
 #include "decayactionsfinderdilepton.h"
 #include "energymomentumtensor.h"
+#include "eventarena.h"
 #include "fourvector.h"
 #include "grandcan_thermalizer.h"
 #include "grid.h"
+#include "largealloc.h"
+#include "memorystats.h"
 #include "outputparameters.h"
 #include "pauliblocking.h"
 #include "potential_globals.h"
@@ -28,12 +41,20 @@
 #include "processstring.h"
 #include "propagation.h"
 #include "quantumnumbers.h"
+#include "runtimeprofiler.h"
 #include "scatteractionphoton.h"
 #include "scatteractionsfinder.h"
+#include "spatialindex.h"
+#include "startupprofiler.h"
 #include "thermalizationaction.h"
+#include "threadpool.h"
+#include "tracerecorder.h"
 // Output
 #include "binaryoutput.h"
+#include "digestoutput.h"
 #include "oscaroutput.h"
+#include "spectraoutput.h"
+#include "thermodynamiclatticeoutput.h"
 #include "thermodynamicoutput.h"
 #ifdef SMASH_USE_ROOT
 #include "rootoutput.h"
@@ -119,6 +140,18 @@ class ExperimentBase {
    */
   virtual void run() = 0;
 
+  /**
+   * Register an additional output.
+   *
+   * This allows callers that embed SMASH as a library to receive the
+   * simulation data in-process, e.g. via a \ref CallbackOutput, without
+   * going through any file. It has to be called before \ref run.
+   *
+   * \param[in] output The output to be added; the experiment takes
+   *            ownership.
+   */
+  virtual void add_output(std::unique_ptr<OutputInterface> output) = 0;
+
   /**
    * \ingroup exception
    * Exception class that is thrown if an invalid modus is requested from the
@@ -171,6 +204,16 @@ class Experiment : public ExperimentBase {
    */
   void run() override;
 
+  /**
+   * Register an additional output, e.g. a \ref CallbackOutput for
+   * in-process analyses.
+   *
+   * \param[in] output The output to be added.
+   */
+  void add_output(std::unique_ptr<OutputInterface> output) override {
+    outputs_.emplace_back(std::move(output));
+  }
+
   /**
    * Create a new Experiment.
    *
@@ -190,8 +233,12 @@ class Experiment : public ExperimentBase {
    * This is called in the beginning of each event. It initializes particles
    * according to selected modus, resets the clock and saves the initial
    * conserved quantities for subsequent sanity checks.
+   *
+   * \param[in] event_number The number of the event to initialize. It selects
+   *            the random-number stream of the event, so any event is
+   *            reproducible from the seed and its number alone.
    */
-  void initialize_new_event();
+  void initialize_new_event(int event_number);
 
   /**
    * Runs the time evolution of an event with fixed-sized time steps or without
@@ -201,6 +248,24 @@ class Experiment : public ExperimentBase {
    */
   void run_time_evolution();
 
+  /**
+   * Write a checkpoint of the evolving state to the checkpoint file.
+   *
+   * \param[in] event_number Number of the event being computed.
+   */
+  void write_checkpoint_file(int event_number);
+
+  /**
+   * Overwrite the state of this experiment with a restored checkpoint.
+   *
+   * Has to be called right after initialize_new_event() of the checkpointed
+   * event; everything the initialization set up is replaced by the saved
+   * state.
+   *
+   * \param[in] state The restored state.
+   */
+  void restore_checkpoint(const CheckpointState &state);
+
   /// Performs the final decays of an event
   void do_final_decays();
 
@@ -232,12 +297,16 @@ class Experiment : public ExperimentBase {
    *                   the private member particles_.
    * \param[in] particles_before_actions A container with the ParticleData
    *                 from this time step before any actions were performed.
+   * \param[in] generate Whether to generate the final state of the action.
+   *                 Pass false if it was already generated, e.g. in parallel
+   *                 by do_final_decays().
    * \return False if the action is rejected either due to invalidity or
    *         Pauli-blocking, or true if it's accepted and performed.
    */
   template <typename Container>
   bool perform_action(Action &action,
-                      const Container &particles_before_actions);
+                      const Container &particles_before_actions,
+                      bool generate = true);
   /**
    * Create a list of output files
    *
@@ -274,9 +343,50 @@ class Experiment : public ExperimentBase {
   /// Intermediate output during an event
   void intermediate_output();
 
+  /**
+   * Check the \key Density_Trigger thresholds against the current maximal
+   * net baryon density on the lattice and write a snapshot of the
+   * particles for every threshold that was crossed since the last check.
+   */
+  void check_density_triggers();
+
+  /**
+   * Evaluate the configured \key Trigger predicates against the current
+   * state of the event.
+   *
+   * \return Whether the event qualifies and the evolution continues.
+   */
+  bool event_passes_trigger() const;
+
+  /**
+   * Freeze and thaw spectators for the fast path of the collider modus.
+   *
+   * Nucleons that have not collided by the time the nuclei have passed
+   * each other are frozen: they keep free-streaming with everything else
+   * but are skipped by the collision-search grid. Any frozen particle the
+   * interacting cloud comes within reach of is thawed again before the
+   * search of this timestep runs, so a stray late interaction is still
+   * found. See \key Spectator_Suppression.
+   *
+   * \param[in] dt The timestep duration. [fm/c]
+   * \return whether any particle was frozen or thawed by this call.
+   */
+  bool update_frozen_spectators(double dt);
+
   /// Recompute potentials on lattices if necessary.
   void update_potentials();
 
+  /**
+   * Deposit the density contributions of the cold projectile and target
+   * separately on snapshot lattices, see \key Rigid_Approach. Until the
+   * first interaction the main lattices are then filled by rigidly
+   * translating these snapshots instead of re-smearing every nucleon.
+   *
+   * \param[in] deposit_gradients Whether the snapshots carry the analytic
+   *            kernel gradients, as in update_lattice().
+   */
+  void take_approach_snapshots(bool deposit_gradients);
+
   /**
    * Calculate the minimal size for the grid cells such that the
    * ScatterActionsFinder will find all collisions within the maximal
@@ -331,12 +441,40 @@ class Experiment : public ExperimentBase {
    */
   OutputsList outputs_;
 
+  /**
+   * The final state of the previous event, kept alive while the
+   * asynchronous output below still writes it.
+   */
+  Particles output_snapshot_;
+
+  /**
+   * Handle of the event-end output of the previous event when it runs
+   * asynchronously on the shared thread pool. The next event waits for it
+   * before writing anything, so the files stay in event order.
+   */
+  std::future<void> previous_event_output_;
+
   /// The Dilepton output
   OutputPtr dilepton_output_;
 
   /// The Photon output
   OutputPtr photon_output_;
 
+  /**
+   * The outputs that receive the ordinary interaction printout, i.e. all
+   * outputs except the dilepton and photon ones. Derived from outputs_ at
+   * the start of the run, so that \ref perform_action does not have to
+   * filter the output list again for every single action.
+   */
+  std::vector<OutputInterface *> interaction_outputs_;
+
+  /**
+   * The dilepton outputs, derived from outputs_ like
+   * interaction_outputs_, so that the shining in \ref propagate_and_shine
+   * does not rebuild the list on every propagation.
+   */
+  std::vector<OutputInterface *> dilepton_outputs_;
+
   /**
    * nucleon_has_interacted_ labels whether the particles in the nuclei
    * have experienced any collisions or not. It's only valid in
@@ -357,6 +495,23 @@ class Experiment : public ExperimentBase {
   /// The Dilepton Action Finder
   std::unique_ptr<DecayActionsFinderDilepton> dilepton_finder_;
 
+  /**
+   * The wall crossing finder with analytic scheduling, used instead of a
+   * per-timestep scan when the particles move on straight lines between
+   * actions (periodic box without potentials); nullptr otherwise, in which
+   * case the finder sits in action_finders_ like before.
+   */
+  std::unique_ptr<WallCrossActionsFinder> wall_finder_;
+
+  /**
+   * The decay finder with analytic scheduling, used instead of a
+   * per-timestep scan over all resonances when the decay widths are
+   * constant between actions (no potentials, no forced thermalization);
+   * nullptr otherwise, in which case the finder sits in action_finders_
+   * like before.
+   */
+  std::unique_ptr<DecayActionsFinder> decay_finder_;
+
   /// The (Scatter) Actions Finder for Direct Photons
   std::unique_ptr<ActionFinderInterface> photon_finder_;
 
@@ -369,6 +524,15 @@ class Experiment : public ExperimentBase {
   /// Isospin projection density on the lattices
   std::unique_ptr<DensityLattice> jmu_I3_lat_;
 
+  /**
+   * Incremental updater for jmu_B_lat_, only created if the
+   * \key Incremental_Update_Distance lattice option is positive.
+   */
+  std::unique_ptr<IncrementalDensityUpdater> jmu_B_updater_;
+
+  /// Incremental updater for jmu_I3_lat_, see jmu_B_updater_.
+  std::unique_ptr<IncrementalDensityUpdater> jmu_I3_updater_;
+
   /**
    * Custom density on the lattices.
    * In the config user asks for some kind of density for printout.
@@ -401,6 +565,86 @@ class Experiment : public ExperimentBase {
   std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
       FI3_lat_;
 
+  /**
+   * Finer baryon density lattice covering the core region, only created
+   * if the \key Core_Sizes lattice option is given. Together with
+   * FB_core_lat_ it refines the force evaluation where the matter sits,
+   * see \ref input_lattice_.
+   */
+  std::unique_ptr<DensityLattice> jmu_B_core_lat_;
+
+  /// Finer isospin projection density lattice, see jmu_B_core_lat_.
+  std::unique_ptr<DensityLattice> jmu_I3_core_lat_;
+
+  /// Finer Skyrme force lattice covering the core region
+  std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
+      FB_core_lat_;
+
+  /// Finer symmetry force lattice covering the core region
+  std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
+      FI3_core_lat_;
+
+  /**
+   * Whether the density derivatives are computed with finite differences
+   * between lattice nodes instead of accumulating analytic gradients of
+   * the smearing kernels, see \key Derivatives_Mode.
+   */
+  bool derivatives_finite_difference_ = false;
+
+  /**
+   * Whether the potential forces are interpolated trilinearly between the
+   * surrounding lattice nodes, see \key Interpolate_Forces.
+   */
+  bool interpolate_forces_ = false;
+
+  /**
+   * Net baryon current of the previous potentials update, used for the
+   * backward time difference in the "Finite Difference" derivatives mode.
+   * Empty at the start of an event, which makes the first time derivative
+   * vanish.
+   */
+  std::vector<FourVector> jmu_B_old_;
+
+  /// Previous net isospin current, see jmu_B_old_.
+  std::vector<FourVector> jmu_I3_old_;
+
+  /// Previous net baryon current on the core lattice, see jmu_B_old_.
+  std::vector<FourVector> jmu_B_core_old_;
+
+  /// Previous net isospin current on the core lattice, see jmu_B_old_.
+  std::vector<FourVector> jmu_I3_core_old_;
+
+  /**
+   * Time of the previous potentials update, defines the backward time
+   * difference in the "Finite Difference" derivatives mode.
+   */
+  double previous_potentials_update_time_ = 0.;
+
+  /**
+   * Whether the lattice densities of the approach phase of a collider
+   * event are translated rigidly from cached snapshots instead of being
+   * re-deposited every update, see \key Rigid_Approach.
+   */
+  bool rigid_approach_ = false;
+
+  /// Cached baryon current of the cold projectile, see rigid_approach_.
+  std::unique_ptr<DensityLattice> jmu_B_projectile_snap_;
+
+  /// Cached baryon current of the cold target, see rigid_approach_.
+  std::unique_ptr<DensityLattice> jmu_B_target_snap_;
+
+  /// Cached isospin current of the cold projectile, see rigid_approach_.
+  std::unique_ptr<DensityLattice> jmu_I3_projectile_snap_;
+
+  /// Cached isospin current of the cold target, see rigid_approach_.
+  std::unique_ptr<DensityLattice> jmu_I3_target_snap_;
+
+  /// Lab time the approach-phase snapshots were taken at. [fm/c]
+  double approach_snapshot_time_ = 0.;
+
+  /// Whether approach-phase snapshots of the current event exist.
+  bool approach_snapshots_valid_ = false;
+
   /// Lattices of energy-momentum tensors for printout
   std::unique_ptr<RectangularLattice<EnergyMomentumTensor>> Tmn_;
 
@@ -416,6 +660,82 @@ class Experiment : public ExperimentBase {
   /// Whether to print the thermodynamics quantities evaluated on the lattices
   bool printout_lattice_td_ = false;
 
+  /**
+   * Factor by which the output interval is stretched after every
+   * intermediate output, see \key Interval_Scaling. One keeps the classic
+   * equidistant output times; larger values space the outputs
+   * geometrically, which resolves the dense early stage finely without
+   * flooding the dilute late stage with nearly identical snapshots.
+   */
+  double output_interval_scaling_ = 1.0;
+
+  /// The configured output interval, restored at the start of every event
+  double base_output_interval_ = 0.0;
+
+  /// Write the particles output only at every this many-th intermediate output
+  int part_output_cadence_ = 1;
+
+  /**
+   * Evaluate and write the thermodynamic quantities only at every this
+   * many-th intermediate output.
+   */
+  int td_output_cadence_ = 1;
+
+  /// Number of intermediate outputs of the current event, drives the cadences
+  uint64_t intermediate_output_count_ = 0;
+
+  /**
+   * Net baryon densities (in fm\f$^{-3}\f$, sorted ascending) at which an
+   * extra snapshot of the particles is written, see \key Density_Trigger.
+   */
+  std::vector<double> density_trigger_thresholds_;
+
+  /// Number of entries of density_trigger_thresholds_ already crossed
+  size_t density_triggers_fired_ = 0;
+
+  /**
+   * Lab time in fm at which the event trigger predicates are evaluated;
+   * negative when no trigger is configured. See \key Trigger.
+   */
+  double trigger_time_ = -1.;
+
+  /**
+   * Minimal number of participants (nucleons that underwent at least one
+   * interaction) an event needs at the trigger check, see \key Trigger.
+   */
+  int trigger_min_participants_ = 0;
+
+  /**
+   * Species of which at least trigger_required_multiplicity_ particles
+   * have to exist at the trigger check, see \key Trigger.
+   */
+  std::vector<PdgCode> trigger_required_pdgs_;
+
+  /// Required joint multiplicity of trigger_required_pdgs_.
+  int trigger_required_multiplicity_ = 1;
+
+  /// Whether the trigger was already evaluated in the current event.
+  bool trigger_checked_ = false;
+
+  /// Whether the current event was aborted by the trigger.
+  bool event_aborted_ = false;
+
+  /// Number of events the trigger aborted so far.
+  uint64_t events_aborted_ = 0;
+
+  /// Whether the spectator fast path of the collider modus is active
+  bool spectator_suppression_ = false;
+
+  /// Lab time after which non-interacted nucleons may be frozen. [fm/c]
+  double spectator_freeze_time_ = 0.0;
+
+  /**
+   * Baryon density lattice evaluated for the \key Density_Trigger check.
+   * Only created when the Skyrme potentials do not already keep jmu_B_lat_
+   * current on every timestep.
+   */
+  std::unique_ptr<DensityLattice> jmu_trigger_lat_;
+
   /// Instance of class used for forced thermalization
   std::unique_ptr<GrandCanThermalizer> thermalizer_;
 
@@ -484,6 +804,33 @@ class Experiment : public ExperimentBase {
    */
   QuantumNumbers conserved_initial_;
 
+  /**
+   * Running total of the conserved quantities of the system.
+   *
+   * Starts out equal to \ref conserved_initial_ and is updated with the
+   * difference of outgoing and incoming quantum numbers of every
+   * performed action, so the conservation check can compare against it
+   * without summing over all particles each timestep. A full scan over
+   * the particle list re-validates it periodically, see
+   * \key Conservation_Check_Interval.
+   */
+  QuantumNumbers conserved_running_;
+
+  /**
+   * \return Current conserved quantities of the system.
+   *
+   * Returns the running totals maintained by the action bookkeeping when
+   * they track the particle list exactly. With potentials or expansion
+   * the momenta also change during propagation, outside of any action, so
+   * in those cases a full scan over the particles is performed instead.
+   */
+  QuantumNumbers current_conserved_quantities() const {
+    if (potentials_ || metric_.mode_ != ExpansionMode::NoExpansion) {
+      return QuantumNumbers(particles_);
+    }
+    return conserved_running_;
+  }
+
   /// system starting time of the simulation
   SystemTimePoint time_start_ = SystemClock::now();
 
@@ -520,9 +867,201 @@ class Experiment : public ExperimentBase {
    */
   uint64_t total_pauli_blocked_ = 0;
 
-  /// random seed for the next event.
+  /**
+   * Total number of actions discarded in the current event because they
+   * were invalid when popped, i.e. an incoming particle had already
+   * interacted since the action was found.
+   */
+  uint64_t discarded_actions_total_ = 0;
+
+  /**
+   * Non-owning pointer to the scatter finder, kept for the per-event
+   * collision search statistics; nullptr when collisions are disabled.
+   */
+  ScatterActionsFinder *scat_finder_ = nullptr;
+
+  /// The configured random seed; every event derives its stream from it.
   int64_t seed_ = -1;
 
+  /**
+   * Interval in fm/c between two checkpoints of the evolving state. Zero or
+   * negative disables checkpointing. A checkpoint is taken at the first
+   * timestep boundary after the interval has elapsed.
+   */
+  double checkpoint_interval_ = 0.0;
+
+  /// The checkpoint file, living in the output directory.
+  bf::path checkpoint_file_;
+
+  /// Checkpoint file to resume from; empty for a fresh run.
+  bf::path resume_file_;
+
+  /**
+   * Append a status line to the status file for farm monitoring, see
+   * \key Status_Interval.
+   *
+   * \param[in] event_number Number of the last completed event.
+   */
+  void write_status(int event_number);
+
+  /**
+   * Number of completed events after which a status line is appended to
+   * the status file; 0 disables the status file.
+   */
+  int status_interval_ = 0;
+
+  /// The status file, living in the output directory.
+  bf::path status_file_;
+
+  /**
+   * If true, a one-line performance digest is printed to stdout and
+   * flushed after every event, see \key Performance_Digest.
+   */
+  bool performance_digest_ = false;
+
+  /// Wall times of all completed events in seconds, for the digest.
+  std::vector<double> event_wall_times_;
+
+  /**
+   * If non-negative, only this event of the run is computed, see
+   * \key Replay_Event.
+   */
+  int replay_event_ = -1;
+
+  /**
+   * File in the output directory recording one line per computed event
+   * with the random substream the event drew from, see \key Replay_Event.
+   */
+  bf::path substream_file_;
+
+  /**
+   * Interactions performed in all completed events of this run, reported
+   * in the status file. Unlike interactions_total_ it is not reset per
+   * event.
+   */
+  uint64_t status_interactions_ = 0;
+
+  /**
+   * Scan the particles and the potential lattices for non-finite values,
+   * see \key Validity_Check_Interval.
+   *
+   * \throw std::runtime_error if a NaN or infinity is found.
+   */
+  void validate_fp_values() const;
+
+  /**
+   * Check whether any collision can still happen in the current particle
+   * configuration, assuming straight-line trajectories: any unstable
+   * particle can decay into products that scatter again, and any pair that
+   * approaches within the maximum interaction distance can collide. Used
+   * for \key Early_Termination.
+   *
+   * \return true unless the remaining evolution is pure free streaming.
+   */
+  bool collisions_still_possible() const;
+
+  /**
+   * Number of timesteps between two scans for non-finite values;
+   * 0 disables the scans.
+   */
+  int validity_check_interval_ = 0;
+
+  /**
+   * Number of timesteps between two full-scan validations of
+   * \ref conserved_running_ against the particle list;
+   * 0 disables the full scans.
+   */
+  int conservation_check_interval_ = 100;
+
+  /**
+   * Number of timesteps between two cache-locality compactions of the
+   * particle storage, see \key Compaction_Interval; 0 disables them.
+   */
+  int compaction_interval_ = 100;
+
+  /**
+   * Number of actions per timestep below which the remainder of the event
+   * is evolved without time stepping; negative values disable the switch.
+   */
+  double timestepless_threshold_ = -1.;
+
+  /**
+   * Number of consecutive timesteps the collision-search grid may be
+   * reused before a full rebuild, see \key Grid_Reuse_Steps; 0 disables
+   * the reuse.
+   */
+  int grid_reuse_steps_ = 0;
+
+  /// The grid type created by the modus of this experiment.
+  using GridType = decltype(std::declval<Modus &>().create_grid(
+      std::declval<const Particles &>(), 0.));
+
+  /**
+   * The grid of the previous timestep, kept alive so that it can be
+   * refreshed instead of rebuilt, see \key Grid_Reuse_Steps. It is reset
+   * whenever the recorded cell binning can no longer be trusted: at the
+   * end of every event (the grid holds arena-backed storage), after a
+   * compaction of the particle storage and after spectator freeze/thaw
+   * flags changed.
+   */
+  std::unique_ptr<GridType> cached_grid_;
+
+  /// Number of consecutive timesteps \ref cached_grid_ was already reused.
+  int grid_reuse_count_ = 0;
+
+  /**
+   * Sum of the action counters at the time \ref cached_grid_ was built.
+   * Every action popped from the queue bumps exactly one of the performed,
+   * discarded and Pauli-blocked counters, so an unchanged sum guarantees
+   * that no action has modified the particles since the grid was built.
+   */
+  uint64_t grid_build_stamp_ = 0;
+
+  /// Number of stored particles at the time \ref cached_grid_ was built.
+  size_t grid_build_particle_count_ = 0;
+
+  /**
+   * Whether the timestep size adapts to the measured action density, see
+   * \key Adaptive_Time_Step.
+   */
+  bool adaptive_time_step_ = false;
+
+  /**
+   * Target number of performed actions per particle and per timestep the
+   * adaptive timestep steers towards, see \key Adaptive_Target_Fraction.
+   */
+  double adaptive_target_fraction_ = 0.05;
+
+  /// Lower bound of the adaptive timestep. [fm/c]
+  double adaptive_min_dt_ = 0.;
+
+  /// Upper bound of the adaptive timestep. [fm/c]
+  double adaptive_max_dt_ = 0.;
+
+  /**
+   * Whether the event ends as soon as no further collision is possible,
+   * see \key Early_Termination.
+   */
+  bool early_termination_ = true;
+
+  /**
+   * File for the machine-readable run phase accounting, living in the
+   * output directory. Only written with `--profile-run`.
+   */
+  bf::path run_profile_file_;
+
+  /**
+   * File for the Chrome trace-event timeline, living in the output
+   * directory. Only written with `--trace`.
+   */
+  bf::path trace_file_;
+
+  /// Time at which the next checkpoint is due, reset for every event.
+  double next_checkpoint_time_ = 0.0;
+
+  /// Number of the event currently being computed, stored in checkpoints.
+  int current_event_ = 0;
+
   /**
    * \ingroup logging
    * Writes the initial state for the Experiment to the output stream.
@@ -558,14 +1097,33 @@ void Experiment<Modus>::create_output(const std::string &format,
 #else
     log.error("Root output requested, but Root support not compiled in");
 #endif
-  } else if (format == "Binary") {
+  } else if (content == "Thermodynamics" && format == "Binary") {
+    printout_lattice_td_ = true;
+    outputs_.emplace_back(
+        make_unique<ThermodynamicLatticeOutput>(output_path, content, out_par));
+  } else if (content == "Photons" && format == "Binary_Compact") {
+    outputs_.emplace_back(
+        make_unique<BinaryOutputPhotons>(output_path, content, out_par));
+  } else if (content == "Collisions" && format == "Binary_Provenance") {
+    outputs_.emplace_back(
+        make_unique<BinaryOutputProvenance>(output_path, content, out_par));
+  } else if (format == "Binary" || format == "Binary_Compressed") {
+    const bool compressed = (format == "Binary_Compressed");
+#ifndef SMASH_USE_ZLIB
+    if (compressed) {
+      log.error(
+          "Compressed binary output requested, but zlib support not "
+          "compiled in");
+      return;
+    }
+#endif
     if (content == "Collisions" || content == "Dileptons" ||
         content == "Photons") {
-      outputs_.emplace_back(
-          make_unique<BinaryOutputCollisions>(output_path, content, out_par));
+      outputs_.emplace_back(make_unique<BinaryOutputCollisions>(
+          output_path, content, out_par, compressed));
     } else if (content == "Particles") {
-      outputs_.emplace_back(
-          make_unique<BinaryOutputParticles>(output_path, content, out_par));
+      outputs_.emplace_back(make_unique<BinaryOutputParticles>(
+          output_path, content, out_par, compressed));
     }
   } else if (format == "Oscar1999" || format == "Oscar2013") {
     outputs_.emplace_back(
@@ -577,6 +1135,12 @@ void Experiment<Modus>::create_output(const std::string &format,
     printout_lattice_td_ = true;
     outputs_.emplace_back(
         make_unique<VtkOutput>(output_path, content, out_par));
+  } else if (content == "Digest" && format == "ASCII") {
+    outputs_.emplace_back(
+        make_unique<DigestOutput>(output_path, content, out_par));
+  } else if (content == "Spectra" && format == "ASCII") {
+    outputs_.emplace_back(
+        make_unique<SpectraOutput>(output_path, content, out_par));
   } else {
     log.error() << "Unknown combination of format (" << format
                 << ") and content (" << content << "). Fix the config.";
@@ -601,10 +1165,222 @@ ExperimentParameters create_experiment_parameters(Configuration config);
  * \key Randomseed (int, required): \n
  * Initial seed for the random number generator. If this is
  * negative, the seed will be randomly generated by the operating system.
+ * Every event uses its own random-number stream derived from the seed and
+ * the event number, so a single event can be reproduced without rerunning
+ * the events before it.
  *
  * \key Nevents (int, required): \n
  * Number of events to calculate.
  *
+ * \key Event_Parallelism (int, optional, default = 1): \n
+ * Number of events that are computed concurrently on separate threads
+ * within one process. The events are distributed over that many
+ * experiments, which share the immutable particle and decay tables but
+ * write into their own output subdirectories ("worker-0", "worker-1", ...)
+ * and use consecutive random seeds derived from \key Randomseed. Results
+ * are reproducible for a fixed seed and a fixed number of workers, but the
+ * assignment of events to seeds differs from a serial run. Cannot be
+ * combined with potentials.
+ *
+ * \key Fork_Batches (int, optional, default = 1): \n
+ * Number of child processes the events are distributed over. The parent
+ * process performs all expensive initialization (particle and decay tables,
+ * spectral-integral tabulations) once; the children are forked afterwards
+ * and inherit it copy-on-write, so the startup cost is paid a single time
+ * instead of once per job. This pays off for small systems, where an event
+ * takes milliseconds but initialization takes tens of seconds. Every batch
+ * writes into its own output subdirectory ("batch-0", "batch-1", ...) and
+ * uses a consecutive random seed derived from \key Randomseed, like the
+ * threads of \key Event_Parallelism, with which it cannot be combined.
+ *
+ * \key Checkpoint_Interval (double, optional, default = 0): \n
+ * If positive, the full evolving state (particles, clocks, random engine,
+ * conserved-quantity bookkeeping) is written to "checkpoint.bin" in the
+ * output directory at the first timestep boundary after every interval of
+ * the given length in fm. A preempted run can then be resumed bit-exactly
+ * with the `--resume` command line option instead of being recomputed from
+ * scratch. Requires fixed timesteps.
+ *
+ * \key Resume_From (string, optional, default = ""): \n
+ * Path of a checkpoint file to resume from; normally set via the `--resume`
+ * command line option.
+ *
+ * \key Replay_Event (int, optional, default = -1): \n
+ * If non-negative, only the event with this number is computed; it has to
+ * be smaller than \key Nevents. Every event draws from its own
+ * random-number stream derived from \key Randomseed and the event number,
+ * so the replayed event is bit-identical to the same event of the full
+ * run. This allows re-running a single interesting event for debugging
+ * and splitting the events of one run over independent jobs with
+ * identical physics; normally set via the `--replay-event` command line
+ * option. The streams of all computed events are recorded in
+ * "substreams.dat" in the output directory. Cannot be combined with
+ * \key Resume_From.
+ *
+ * \key Status_Interval (int, optional, default = 0): \n
+ * If positive, a line with the last completed event number, the wall time
+ * since the start of the run in seconds, the total number of performed
+ * interactions and the peak resident set size in kB is appended to
+ * "status.dat" in the output directory after every that many completed
+ * events (and once more at the end of the run). A farm scheduler can watch
+ * this file to measure the progress of a job and to detect wedged jobs by
+ * the age of the last line, without parsing the regular outputs.
+ *
+ * \key Performance_Digest (bool, optional, default = false): \n
+ * If true, one line starting with "perf:" is printed to stdout and flushed
+ * after every event, reporting the wall time of the event, the median, the
+ * 90th percentile and the maximum of the wall times of all events completed
+ * so far, the number of performed actions and the resulting actions per
+ * second. Log scrapers can follow the line stream while the job runs; the
+ * line is printed even with \key Quiet set.
+ *
+ * \key Quiet (bool, optional, default = false): \n
+ * If true, the verbosity of the Main and Experiment log areas is reduced to
+ * warnings, which removes all per-event console output. The console I/O is
+ * measurable for runs with many small events; combine with
+ * \key Performance_Digest to keep one machine-readable line per event.
+ *
+ * \key Validity_Check_Interval (int, optional, default = 0): \n
+ * If positive, the particles and the potential lattices are scanned for NaN
+ * and infinity values after every that many timesteps and the run aborts
+ * with a report of the offending particle and its last process if one is
+ * found. This is a cheap alternative to the floating-point traps (which
+ * perturb performance and are therefore often disabled in production runs)
+ * and bounds how far a corrupted state can propagate before it is noticed.
+ *
+ * \key Conservation_Check_Interval (int, optional, default = 100): \n
+ * The conservation check compares the initial conserved quantities against a
+ * running total that is updated from the quantum-number differences of the
+ * performed actions, which avoids a sum over all particles every timestep.
+ * After every that many timesteps the running total is additionally
+ * re-validated against a full scan of the particle list, which catches any
+ * modification of the particles that bypassed the action bookkeeping. Set to
+ * 0 to disable the full scans. Note that a non-conserving action shows up in
+ * the cheap check immediately, because it shifts the running total away from
+ * the initial values.
+ *
+ * \key Compaction_Interval (int, optional, default = 100): \n
+ * If positive, the internal particle storage is compacted after every that
+ * many timesteps: holes left by removed particles are dropped and the
+ * remaining particles are re-sorted by spatial position to match the cell
+ * order of the collision-search grid. After many scatterings the slot reuse
+ * decorrelates storage order and position, which turns every grid-cell
+ * traversal into a random access pattern; the periodic re-sort restores the
+ * locality at an amortized O(N log N / interval) cost per timestep. The
+ * reordering changes the order in which particle pairs are examined and with
+ * it the random number stream, so runs are only reproducible for a fixed
+ * value of this option. Set to 0 to disable the compaction.
+ *
+ * \key Expected_Maximum_Particles (int, optional, default = automatic): \n
+ * Number of stored particles (test particles included) the storage is sized
+ * for up front, so that the multiplicity build-up of an event does not
+ * trigger reallocations. If not given, the estimate of the modus is used:
+ * the collider modus scales the number of incoming nucleons with a
+ * logarithmic energy factor, the box modus doubles the configured initial
+ * multiplicities. Exceeding the estimate is harmless (the storage then
+ * grows as usual), unless \key Guarantee_No_Reallocation is on.
+ *
+ * \key Guarantee_No_Reallocation (bool, optional, default = false): \n
+ * If true, the particle storage is never reallocated after initialization:
+ * exceeding the reserved capacity aborts the run with a message that
+ * includes the capacity that would have been needed, to be set via \key
+ * Expected_Maximum_Particles. This guarantees that pointers into the
+ * particle storage stay valid for the whole run.
+ *
+ * \key Memory_Policy (string, optional, default = "Default"): \n
+ * NUMA placement of the large allocations (particle storage, lattices).
+ * \li \key "Default" - Leave the placement to the operating system
+ * (first touch).
+ * \li \key "Interleave" - Spread the pages round-robin over all online
+ * NUMA nodes, for lattices that are written by all threads.
+ * \li \key "Local" - Prefer the NUMA node of the allocating thread.
+ *
+ * The policy is advisory and silently ignored on machines without NUMA
+ * support. Independently of it, large blocks are backed by transparent
+ * hugepages where the kernel provides them.
+ *
+ * \key Timestepless_Threshold (double, optional, default = -1): \n
+ * If non-negative and the \key Fixed time step mode is used, the number of
+ * actions performed in each timestep is monitored. Once it stays below the
+ * threshold for three consecutive timesteps the remainder of the event is
+ * evolved without further time stepping, like in the \key None mode, which
+ * avoids action searches that find nothing in the dilute late stage of a
+ * collision. The switch only happens when nothing has to be recomputed
+ * once per timestep, i.e. without potentials, expansion and forced
+ * thermalization; otherwise the option is ignored.
+ *
+ * \key Grid_Reuse_Steps (int, optional, default = 0): \n
+ * If positive, the collision-finding grid is not rebuilt from scratch every
+ * timestep: as long as no action modified the particles, the grid of the
+ * previous timestep keeps its cell assignment and only the stored particle
+ * copies are refreshed, for at most that many consecutive timesteps. To
+ * keep this exact, the cells are enlarged by twice the reuse window
+ * (2 * \key Grid_Reuse_Steps * dt), which bounds how far any pair can have
+ * drifted towards each other since the cells were assigned. This pays off
+ * when the timestep is small compared to the cell size, e.g. in runs with
+ * potentials; large values enlarge the cells and therefore the number of
+ * examined pairs, so values of a few are sensible. Requires the \key Fixed
+ * time step mode without an expanding metric, otherwise it is ignored.
+ *
+ * \key Adaptive_Time_Step (bool, optional, default = false): \n
+ * If true (and the \key Fixed time step mode is used), the timestep size
+ * is adapted to the measured activity after every step: the number of
+ * performed scatterings and decays is compared with
+ * \key Adaptive_Target_Fraction times the number of particles, and the
+ * timestep shrinks or grows towards the target, at most by a factor of
+ * two per step and bounded by \key Adaptive_Minimal_Time_Step and
+ * \key Adaptive_Maximal_Time_Step. The hot initial phase is thereby
+ * resolved more finely than the configured \key Delta_Time and the dilute
+ * tail is evolved with fewer collision searches. The intermediate outputs
+ * still happen at the exact configured times, independently of the
+ * stepping. Cannot be combined with \key Grid_Reuse_Steps.
+ *
+ * \key Adaptive_Target_Fraction (double, optional, default = 0.05): \n
+ * Target number of performed actions per particle and per timestep that
+ * the adaptive timestep steers towards.
+ *
+ * \key Adaptive_Minimal_Time_Step (double, optional, default =
+ * \key Delta_Time / 100): \n
+ * Lower bound of the adaptive timestep. [fm/c]
+ *
+ * \key Adaptive_Maximal_Time_Step (double, optional, default =
+ * \key Delta_Time with potentials, 10 * \key Delta_Time without): \n
+ * Upper bound of the adaptive timestep. With potentials the default does
+ * not exceed \key Delta_Time, because the equations of motion are
+ * integrated once per timestep and a larger step would degrade their
+ * accuracy. [fm/c]
+ *
+ * \key Early_Termination (bool, optional, default = true): \n
+ * In the \key Fixed time step mode, after a timestep in which no action
+ * happened an analysis checks whether any collision is still possible: all
+ * particles are stable and no pair gets closer than the maximum
+ * interaction distance on its straight-line trajectories. If not, the
+ * remaining evolution is free streaming, so the clock is fast-forwarded
+ * to \key End_Time (the intermediate output times are still respected).
+ * The analysis is exact and therefore enabled by default; it is skipped
+ * in setups where it would not be (potentials, expansion, forced
+ * thermalization, dilepton output, periodic boxes, frozen Fermi motion).
+ *
+ * \key Trigger (section, optional): \n
+ * Early-abort trigger for studies that only analyze qualifying events.
+ * The predicates below are evaluated once per event at the first timestep
+ * boundary at or after \key Time; an event that fails any of them is
+ * aborted on the spot and discarded: neither final decays nor the
+ * end-of-event output are performed for it, which multiplies the
+ * effective throughput of rare-probe studies by the rejection factor.
+ * Note that interaction records written by collision outputs before the
+ * check stay in their files. The section takes the keys
+ * \li \key Time (double, required): lab time in fm at which the
+ * predicates are checked, e.g. after the nuclei have passed each other.
+ * \li \key Minimum_Participants (int, optional, default = 0): minimal
+ * number of participants, counted as nucleons that underwent at least one
+ * interaction.
+ * \li \key Required_PDGs (list of PDG codes, optional): species of which
+ * together at least \key Required_Multiplicity particles have to exist at
+ * the check.
+ * \li \key Required_Multiplicity (int, optional, default = 1): required
+ * joint multiplicity of the \key Required_PDGs.
+ *
  * \key Use_Grid (bool, optional, default = true): \n
  * \li \key true - A grid is used to reduce the combinatorics of interaction
  * lookup \n \li \key false - No grid is used.
@@ -735,7 +1511,20 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
     n_fractional_photons_ = config.take({"Output", "Photons", "Fractions"});
   }
   if (parameters_.two_to_one) {
-    action_finders_.emplace_back(make_unique<DecayActionsFinder>());
+    if (config.has_value({"Potentials"}) ||
+        config.has_value({"Forced_Thermalization"})) {
+      /* With potentials the momenta and thereby the decay widths change
+       * continuously, and forced thermalization replaces particles outside
+       * of the action machinery, so the decays have to be re-rolled every
+       * timestep. */
+      action_finders_.emplace_back(make_unique<DecayActionsFinder>());
+    } else {
+      /* The decay width of a particle stays constant between actions, so
+       * its decay time can be sampled the moment its momentum changes.
+       * This replaces the per-timestep scan over all resonances; see
+       * run_time_evolution. */
+      decay_finder_ = make_unique<DecayActionsFinder>(true);
+    }
   }
   bool no_coll = config.take({"Collision_Term", "No_Collisions"}, false);
   if ((parameters_.two_to_one || parameters_.included_2to2.any() ||
@@ -744,9 +1533,9 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
     auto scat_finder = make_unique<ScatterActionsFinder>(
         config, parameters_, nucleon_has_interacted_, modus_.total_N_number(),
         modus_.proj_N_number());
-    max_transverse_distance_sqr_ =
-        scat_finder->max_transverse_distance_sqr(parameters_.testparticles);
+    max_transverse_distance_sqr_ = scat_finder->max_transverse_distance_sqr();
     process_string_ptr_ = scat_finder->get_process_string_ptr();
+    scat_finder_ = scat_finder.get();
     action_finders_.emplace_back(std::move(scat_finder));
   } else {
     max_transverse_distance_sqr_ = maximum_cross_section / M_PI * fm2_mb;
@@ -754,7 +1543,20 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
   }
   const double modus_l = modus_.length();
   if (modus_l > 0.) {
-    action_finders_.emplace_back(make_unique<WallCrossActionsFinder>(modus_l));
+    if (config.has_value({"Potentials"}) ||
+        config.has_value({"Forced_Thermalization"})) {
+      /* With potentials the momenta change continuously, and forced
+       * thermalization replaces particles outside of the action machinery,
+       * so the wall crossings have to be recomputed every timestep. */
+      action_finders_.emplace_back(
+          make_unique<WallCrossActionsFinder>(modus_l));
+    } else {
+      /* Between actions the particles move on straight lines, so every
+       * crossing can be scheduled analytically the moment the momentum of
+       * a particle changes. This replaces the per-timestep scan over all
+       * particles; see run_time_evolution. */
+      wall_finder_ = make_unique<WallCrossActionsFinder>(modus_l, true);
+    }
   }
 
   if (config.has_value({"Collision_Term", "Pauli_Blocking"})) {
@@ -854,6 +1656,16 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    *          quantities, see \ref Thermodynamics.
    *    - Available formats: \ref thermodyn_output_user_guide_,
    *      \ref output_vtk_lattice_
+   * - \b Digest     One line per event with order-independent hashes of the
+   *                 final particle list and (optionally) of all performed
+   *                 interactions, meant for automatically comparing runs,
+   *                 see \subpage digest_output_user_guide_.
+   *    - Available format: "ASCII"
+   * - \b Spectra    Single-particle spectra histograms accumulated over all
+   *                 events in-process and written once at the end of the
+   *                 run, replacing the particle output for spectra-only
+   *                 analyses, see \subpage spectra_output_user_guide_.
+   *    - Available format: "ASCII"
    *
    * \n
    * \anchor list_of_output_formats
@@ -872,6 +1684,16 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    *   - Saves coordinates and momenta with the full double precision
    *   - General file structure is similar to \ref oscar_general_
    *   - Detailed description: \subpage format_binary_
+   * - \b "Binary_Compressed" - the same binary output streamed through a
+   *     gzip compressor
+   *   - Requires SMASH to be built with zlib support
+   *   - Compresses the large particle blocks about fourfold; the files can
+   *     be unpacked with standard tools
+   * - \b "Binary_Provenance" - compact varint-encoded interaction graph,
+   *     available for the "Collisions" content
+   *   - Writes only process nodes and particle-id edges, orders of
+   *     magnitude smaller than the full collision history; see
+   *     \ref format_binary_
    * - \b "Root" - binary output in the format used by ROOT software
    *     (http://root.cern.ch)
    *   - Even faster to read and write, requires less disk space
@@ -882,8 +1704,9 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    *   - For "Particles" content \subpage format_vtk
    *   - For "Thermodynamics" content \subpage output_vtk_lattice_
    * - \b "ASCII" - a human-readable text-format table of values
-   *   - Used only for "Thermodynamics", see
-   * \subpage thermodyn_output_user_guide_
+   *   - Used for "Thermodynamics" (see \subpage thermodyn_output_user_guide_),
+   *     "Digest" (see \ref digest_output_user_guide_) and "Spectra"
+   *     (see \ref spectra_output_user_guide_)
    *
    * \note Output of coordinates for the "Collisions" content in
    *       the periodic box has a feature:
@@ -1023,19 +1846,43 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
   dens_type_ = config.take({"Output", "Density_Type"}, DensityType::None);
   log.debug() << "Density type printed to headers: " << dens_type_;
 
-  const OutputParameters output_parameters(std::move(output_conf));
-
-  std::vector<std::string> output_contents = output_conf.list_upmost_nodes();
-  for (const auto &content : output_contents) {
-    auto this_output_conf = output_conf[content.c_str()];
-    std::vector<std::string> formats = this_output_conf.take({"Format"});
-    for (const auto &format : formats) {
-      create_output(format, content, output_path, output_parameters);
+  output_interval_scaling_ = config.take({"Output", "Interval_Scaling"}, 1.0);
+  if (output_interval_scaling_ < 1.0) {
+    throw std::invalid_argument(
+        "Output: Interval_Scaling has to be at least 1.");
+  }
+  base_output_interval_ = parameters_.outputclock.timestep_duration();
+  if (config.has_value({"Output", "Density_Trigger"})) {
+    density_trigger_thresholds_ =
+        config.take({"Output", "Density_Trigger"})
+            .convert_for(density_trigger_thresholds_);
+    std::sort(density_trigger_thresholds_.begin(),
+              density_trigger_thresholds_.end());
+    if (density_trigger_thresholds_.empty() ||
+        density_trigger_thresholds_.front() <= 0.) {
+      throw std::invalid_argument(
+          "Output: Density_Trigger thresholds have to be positive.");
     }
   }
 
-  /* We can take away the Fermi motion flag, because the collider modus is
-   * already initialized. We only need it when potentials are enabled, but we
+  const OutputParameters output_parameters(std::move(output_conf));
+  part_output_cadence_ = output_parameters.part_cadence;
+  td_output_cadence_ = output_parameters.td_cadence;
+
+  {
+    StartupProfiler::Phase phase("Output creation");
+    std::vector<std::string> output_contents = output_conf.list_upmost_nodes();
+    for (const auto &content : output_contents) {
+      auto this_output_conf = output_conf[content.c_str()];
+      std::vector<std::string> formats = this_output_conf.take({"Format"});
+      for (const auto &format : formats) {
+        create_output(format, content, output_path, output_parameters);
+      }
+    }
+  }
+
+  /* We can take away the Fermi motion flag, because the collider modus is
+   * already initialized. We only need it when potentials are enabled, but we
    * always have to take it, otherwise SMASH will complain about unused
    * options. We have to provide a default value for modi other than Collider.
    */
@@ -1087,6 +1934,80 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    *      Use periodic continuation or not. With periodic continuation
    *      x + i * lx is equivalent to x, same for y, z.
    *
+   * \key Incremental_Update_Distance (double, optional, default = 0.0): \n
+   *      If positive, the density lattices for the potentials are updated
+   *      incrementally: a particle keeps its previously deposited smearing
+   *      contribution as long as it moved less than this distance (in fm)
+   *      and its 4-velocity changed correspondingly little, so only the
+   *      lattice regions around particles that actually changed are
+   *      touched. The computed densities may lag behind slowly drifting
+   *      particles by up to this distance, hence it should be chosen small
+   *      against the Gaussian smearing width; the lattices are still
+   *      recomputed from scratch at regular intervals. Box runs with fine
+   *      lattices benefit most.
+   *
+   * \key First_Touch (bool, optional, default = true): \n
+   *      If true and SMASH runs with \key Parallelism larger than one, the
+   *      lattice node storage is initialized in parallel by the worker
+   *      threads. On NUMA machines this spreads the memory pages of large
+   *      lattices over the NUMA domains of the threads that later update
+   *      them, instead of leaving all pages on the domain of the main
+   *      thread. This only affects where the memory is placed, never the
+   *      computed values.
+   *
+   * \key Derivatives_Mode (string, optional, default = "Covariant Gaussian"):
+   * \n
+   *      How the density derivatives entering the potential forces are
+   *      obtained:
+   *      \li \key "Covariant Gaussian" - every particle deposits analytic
+   *      gradients of its smearing kernel on the lattice while the
+   *      densities are accumulated. Most accurate, but the cost of a
+   *      lattice update grows with the particle number.
+   *      \li \key "Finite Difference" - only the currents themselves are
+   *      deposited; their derivatives are then computed once per timestep
+   *      with central differences between neighboring nodes (one-sided at
+   *      non-periodic lattice faces) and the time derivative with a
+   *      backward difference between consecutive updates. Much cheaper for
+   *      large particle numbers, accurate if the lattice spacing resolves
+   *      the Gaussian smearing width.
+   *
+   * \key Interpolate_Forces (bool, optional, default = false): \n
+   *      If true, the potential forces acting on a particle are
+   *      interpolated trilinearly between the eight lattice nodes around
+   *      its position instead of taking the value at the nearest node.
+   *      This smooths the forces between nodes and removes the
+   *      discontinuities a particle sees when crossing a cell boundary, at
+   *      the price of eight node reads per particle instead of one.
+   *
+   * \key Rigid_Approach (bool, optional, default = false): \n
+   *      Only affects the collider modus. If true, the density
+   *      contribution of each cold nucleus is deposited on the lattice
+   *      once at the beginning of the event and, until the first
+   *      interaction, only translated rigidly along the beam axis with
+   *      the beam velocity instead of being re-deposited from the
+   *      nucleons every update. This removes the per-nucleon smearing
+   *      cost of the approach phase, which dominates potentials runs at
+   *      low energies where the nuclei take long to touch. The
+   *      translation is exact for \key Fermi_Motion "off" and "frozen";
+   *      with Fermi motion "on" the nucleons drift individually, so the
+   *      cached field is an approximation to the slowly dispersing
+   *      nuclei. The off-grid shifts are interpolated trilinearly
+   *      between the snapshot nodes.
+   *
+   * \key Core_Sizes (array<double,3>, optional): \n
+   *      Sizes in fm of a refined core region, centered on the center of
+   *      the lattice. If given (together with \key Core_Cell_Number),
+   *      additional finer density and force lattices are created for this
+   *      region and particles inside it take their potential forces from
+   *      them. This gives high resolution where the matter sits - for
+   *      example in the Lorentz-contracted overlap zone of a collider
+   *      setup - without paying for equally fine cells in the dilute
+   *      halo. The core sizes must not exceed \key Sizes.
+   *
+   * \key Core_Cell_Number (array<int,3>, optional): \n
+   *      Number of cells of the refined core lattices in x, y, z
+   *      directions. Required if \key Core_Sizes is given.
+   *
    * \key Potentials_Affect_Thresholds (bool, optional, default = false): \n
    * Include potential effects, since mean field potentials change the threshold
    * energies of the actions.
@@ -1120,6 +2041,37 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
     const std::array<int, 3> n = config.take({"Lattice", "Cell_Number"});
     const std::array<double, 3> origin = config.take({"Lattice", "Origin"});
     const bool periodic = config.take({"Lattice", "Periodic"});
+    const double incremental_distance =
+        config.take({"Lattice", "Incremental_Update_Distance"}, 0.0);
+    const bool first_touch = config.take({"Lattice", "First_Touch"}, true);
+    const std::string derivatives_mode = std::string(config.take(
+        {"Lattice", "Derivatives_Mode"}, std::string("Covariant Gaussian")));
+    if (derivatives_mode == "Finite Difference") {
+      derivatives_finite_difference_ = true;
+    } else if (derivatives_mode != "Covariant Gaussian") {
+      throw std::invalid_argument(
+          "Lattice: Derivatives_Mode must be \"Covariant Gaussian\" or "
+          "\"Finite Difference\".");
+    }
+    interpolate_forces_ = config.take({"Lattice", "Interpolate_Forces"}, false);
+    rigid_approach_ =
+        config.take({"Lattice", "Rigid_Approach"}, false) &&
+        modus_.is_collider();
+    const bool has_core = config.has_value({"Lattice", "Core_Sizes"});
+    std::array<double, 3> core_l{}, core_origin{};
+    std::array<int, 3> core_n{};
+    if (has_core) {
+      core_l = config.take({"Lattice", "Core_Sizes"});
+      core_n = config.take({"Lattice", "Core_Cell_Number"});
+      for (int i = 0; i < 3; i++) {
+        if (core_l[i] > l[i]) {
+          throw std::invalid_argument(
+              "Lattice: Core_Sizes must not exceed Sizes.");
+        }
+        // Center the refined region on the center of the lattice.
+        core_origin[i] = origin[i] + 0.5 * (l[i] - core_l[i]);
+      }
+    }
 
     if (printout_lattice_td_) {
       dens_type_lattice_printout_ = output_parameters.td_dens_type;
@@ -1129,50 +2081,94 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
     }
     if (printout_tmn_ || printout_tmn_landau_ || printout_v_landau_) {
       Tmn_ = make_unique<RectangularLattice<EnergyMomentumTensor>>(
-          l, n, origin, periodic, LatticeUpdate::AtOutput);
+          l, n, origin, periodic, LatticeUpdate::AtOutput, first_touch);
     }
     /* Create baryon and isospin density lattices regardless of config
        if potentials are on. This is because they allow to compute
        potentials faster */
     if (potentials_) {
       if (potentials_->use_skyrme()) {
-        jmu_B_lat_ = make_unique<DensityLattice>(l, n, origin, periodic,
-                                                 LatticeUpdate::EveryTimestep);
+        jmu_B_lat_ = make_unique<DensityLattice>(
+            l, n, origin, periodic, LatticeUpdate::EveryTimestep, first_touch);
         UB_lat_ = make_unique<RectangularLattice<FourVector>>(
-            l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+            l, n, origin, periodic, LatticeUpdate::EveryTimestep, first_touch);
         FB_lat_ = make_unique<
             RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
-            l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+            l, n, origin, periodic, LatticeUpdate::EveryTimestep, first_touch);
+        if (has_core) {
+          jmu_B_core_lat_ =
+              make_unique<DensityLattice>(core_l, core_n, core_origin, false,
+                                          LatticeUpdate::EveryTimestep,
+                                          first_touch);
+          FB_core_lat_ = make_unique<
+              RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
+              core_l, core_n, core_origin, false, LatticeUpdate::EveryTimestep,
+              first_touch);
+        }
       }
       if (potentials_->use_symmetry()) {
-        jmu_I3_lat_ = make_unique<DensityLattice>(l, n, origin, periodic,
-                                                  LatticeUpdate::EveryTimestep);
+        jmu_I3_lat_ = make_unique<DensityLattice>(
+            l, n, origin, periodic, LatticeUpdate::EveryTimestep, first_touch);
         UI3_lat_ = make_unique<RectangularLattice<FourVector>>(
-            l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+            l, n, origin, periodic, LatticeUpdate::EveryTimestep, first_touch);
         FI3_lat_ = make_unique<
             RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
-            l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+            l, n, origin, periodic, LatticeUpdate::EveryTimestep, first_touch);
+        if (has_core) {
+          jmu_I3_core_lat_ =
+              make_unique<DensityLattice>(core_l, core_n, core_origin, false,
+                                          LatticeUpdate::EveryTimestep,
+                                          first_touch);
+          FI3_core_lat_ = make_unique<
+              RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
+              core_l, core_n, core_origin, false, LatticeUpdate::EveryTimestep,
+              first_touch);
+        }
+      }
+      if (incremental_distance > 0.) {
+        if (jmu_B_lat_) {
+          jmu_B_updater_ =
+              make_unique<IncrementalDensityUpdater>(incremental_distance);
+        }
+        if (jmu_I3_lat_) {
+          jmu_I3_updater_ =
+              make_unique<IncrementalDensityUpdater>(incremental_distance);
+        }
       }
     } else {
       if (dens_type_lattice_printout_ == DensityType::Baryon) {
-        jmu_B_lat_ = make_unique<DensityLattice>(l, n, origin, periodic,
-                                                 LatticeUpdate::AtOutput);
+        jmu_B_lat_ = make_unique<DensityLattice>(
+            l, n, origin, periodic, LatticeUpdate::AtOutput, first_touch);
       }
       if (dens_type_lattice_printout_ == DensityType::BaryonicIsospin) {
-        jmu_I3_lat_ = make_unique<DensityLattice>(l, n, origin, periodic,
-                                                  LatticeUpdate::AtOutput);
+        jmu_I3_lat_ = make_unique<DensityLattice>(
+            l, n, origin, periodic, LatticeUpdate::AtOutput, first_touch);
       }
     }
     if (dens_type_lattice_printout_ != DensityType::None &&
         dens_type_lattice_printout_ != DensityType::BaryonicIsospin &&
         dens_type_lattice_printout_ != DensityType::Baryon) {
-      jmu_custom_lat_ = make_unique<DensityLattice>(l, n, origin, periodic,
-                                                    LatticeUpdate::AtOutput);
+      jmu_custom_lat_ = make_unique<DensityLattice>(
+          l, n, origin, periodic, LatticeUpdate::AtOutput, first_touch);
+    }
+    /* The density trigger samples the net baryon density on every timestep.
+     * When the Skyrme potentials keep jmu_B_lat_ current anyway, that
+     * lattice is reused; otherwise a dedicated lattice is filled. */
+    if (!density_trigger_thresholds_.empty() &&
+        !(potentials_ && potentials_->use_skyrme())) {
+      jmu_trigger_lat_ = make_unique<DensityLattice>(
+          l, n, origin, periodic, LatticeUpdate::EveryTimestep, first_touch);
     }
   } else if (printout_lattice_td_) {
     log.error(
         "If you want Thermodynamic VTK output, configure a lattice for it.");
   }
+  if (!density_trigger_thresholds_.empty() && jmu_trigger_lat_ == nullptr &&
+      jmu_B_lat_ == nullptr) {
+    throw std::invalid_argument(
+        "Output: Density_Trigger requires a configured lattice, "
+        "see the Lattice section of the user guide.");
+  }
 
   // Store pointers to potential and lattice accessible for Action
   if (parameters_.potential_affect_threshold) {
@@ -1183,6 +2179,13 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
 
   // Create forced thermalizer
   if (config.has_value({"Forced_Thermalization"})) {
+    if (parameters_.n_ensembles > 1) {
+      /* The thermalization region samples one grand-canonical state from
+       * all particles inside it, which would merge the ensembles. */
+      throw std::invalid_argument(
+          "Forced_Thermalization is not compatible with Ensembles > 1.");
+    }
+    StartupProfiler::Phase phase("Thermalizer and EoS table");
     Configuration &&th_conf = config["Forced_Thermalization"];
     thermalizer_ = modus_.create_grandcan_thermalizer(th_conf);
   }
@@ -1190,27 +2193,187 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
   /* Take the seed setting only after the configuration was stored to a file
    * in smash.cc */
   seed_ = config.take({"General", "Randomseed"});
+
+  // Checkpointing of the evolving state, see CheckpointState.
+  checkpoint_interval_ = config.take({"General", "Checkpoint_Interval"}, 0.0);
+  checkpoint_file_ = output_path / "checkpoint.bin";
+  run_profile_file_ = output_path / "run_phases.dat";
+  trace_file_ = output_path / "trace.json";
+  resume_file_ =
+      std::string(config.take({"General", "Resume_From"}, std::string()));
+  status_interval_ = config.take({"General", "Status_Interval"}, 0);
+  performance_digest_ = config.take({"General", "Performance_Digest"}, false);
+  if (config.take({"General", "Quiet"}, false)) {
+    /* Warnings and errors still get through; the per-event lines do not.
+     * The areas of the subsystems are left untouched, they are quiet at
+     * their default verbosity anyway. */
+    logger<LogArea::Main>().setVerbosity(einhard::WARN);
+    logger<LogArea::Experiment>().setVerbosity(einhard::WARN);
+  }
+  replay_event_ = config.take({"General", "Replay_Event"}, -1);
+  if (replay_event_ >= 0) {
+    if (replay_event_ >= nevents_) {
+      throw std::invalid_argument(
+          "Replay_Event must be smaller than Nevents.");
+    }
+    if (!resume_file_.empty()) {
+      throw std::invalid_argument(
+          "Replay_Event cannot be combined with resuming from a "
+          "checkpoint.");
+    }
+  }
+  validity_check_interval_ =
+      config.take({"General", "Validity_Check_Interval"}, 0);
+  conservation_check_interval_ =
+      config.take({"General", "Conservation_Check_Interval"}, 100);
+  compaction_interval_ = config.take({"General", "Compaction_Interval"}, 100);
+  /* Set the placement policy before the first large allocation, i.e. before
+   * the particle storage is pre-sized below. */
+  LargeAlloc::set_policy(
+      config.take({"General", "Memory_Policy"}, MemoryPolicy::Default));
+  /* Pre-size the particle storage to the expected peak multiplicity, so
+   * that the event build-up does not trigger reallocations (which copy all
+   * particles and invalidate all pointers into the storage). */
+  int expected_max_particles =
+      config.take({"General", "Expected_Maximum_Particles"}, 0);
+  if (expected_max_particles <= 0) {
+    expected_max_particles =
+        modus_.max_particle_number(parameters_.testparticles);
+  }
+  if (expected_max_particles > 0) {
+    particles_.reserve(expected_max_particles);
+  }
+  if (config.take({"General", "Guarantee_No_Reallocation"}, false)) {
+    if (expected_max_particles <= 0) {
+      log.warn(
+          "Guarantee_No_Reallocation is on, but neither the modus nor "
+          "Expected_Maximum_Particles provide a capacity estimate; the run "
+          "will abort as soon as the default capacity is exceeded.");
+    }
+    particles_.lock_capacity();
+  }
+  timestepless_threshold_ =
+      config.take({"General", "Timestepless_Threshold"}, -1.);
+  grid_reuse_steps_ = config.take({"General", "Grid_Reuse_Steps"}, 0);
+  if (grid_reuse_steps_ < 0) {
+    throw std::invalid_argument("Grid_Reuse_Steps has to be non-negative.");
+  }
+  if (grid_reuse_steps_ > 0 && (time_step_mode_ != TimeStepMode::Fixed ||
+                                metric_.mode_ != ExpansionMode::NoExpansion)) {
+    /* The safety margin of the oversized cells is a multiple of the fixed
+     * timestep and only covers straight-line drift, so neither the None
+     * mode nor an expanding metric can use the reuse. */
+    log.warn(
+        "Grid_Reuse_Steps requires the Fixed time step mode without "
+        "expansion; the option is ignored.");
+    grid_reuse_steps_ = 0;
+  }
+  adaptive_time_step_ = config.take({"General", "Adaptive_Time_Step"}, false);
+  adaptive_target_fraction_ =
+      config.take({"General", "Adaptive_Target_Fraction"}, 0.05);
+  adaptive_min_dt_ = config.take({"General", "Adaptive_Minimal_Time_Step"},
+                                 0.01 * delta_time_startup_);
+  /* With potentials the equations of motion are integrated once per
+   * timestep, so the default upper bound does not exceed the configured
+   * Delta_Time; without them growing the step is exact. */
+  adaptive_max_dt_ = config.take(
+      {"General", "Adaptive_Maximal_Time_Step"},
+      potentials_ ? delta_time_startup_ : 10. * delta_time_startup_);
+  if (adaptive_time_step_) {
+    if (time_step_mode_ != TimeStepMode::Fixed) {
+      log.warn(
+          "Adaptive_Time_Step requires the Fixed time step mode; the "
+          "option is ignored.");
+      adaptive_time_step_ = false;
+    } else if (!(adaptive_target_fraction_ > 0.) ||
+               !(adaptive_min_dt_ > 0.) ||
+               adaptive_min_dt_ > adaptive_max_dt_) {
+      throw std::invalid_argument(
+          "Adaptive_Target_Fraction has to be positive and the adaptive "
+          "time step bounds have to satisfy 0 < minimum <= maximum.");
+    }
+    if (grid_reuse_steps_ > 0) {
+      /* The reuse margin of the cached grid is sized with a fixed dt. */
+      log.warn(
+          "Grid_Reuse_Steps is not available together with "
+          "Adaptive_Time_Step; the option is ignored.");
+      grid_reuse_steps_ = 0;
+    }
+  }
+  early_termination_ = config.take({"General", "Early_Termination"}, true);
+  if (config.has_value({"General", "Trigger"})) {
+    trigger_time_ = config.take({"General", "Trigger", "Time"});
+    trigger_min_participants_ =
+        config.take({"General", "Trigger", "Minimum_Participants"}, 0);
+    if (config.has_value({"General", "Trigger", "Required_PDGs"})) {
+      trigger_required_pdgs_ =
+          config.take({"General", "Trigger", "Required_PDGs"})
+              .convert_for(trigger_required_pdgs_);
+    }
+    trigger_required_multiplicity_ =
+        config.take({"General", "Trigger", "Required_Multiplicity"}, 1);
+    if (trigger_time_ < 0.) {
+      throw std::invalid_argument("Trigger: Time must not be negative.");
+    }
+    if (trigger_min_participants_ <= 0 && trigger_required_pdgs_.empty()) {
+      throw std::invalid_argument(
+          "Trigger: configure Minimum_Participants and/or Required_PDGs.");
+    }
+    if (time_step_mode_ == TimeStepMode::None) {
+      log.warn(
+          "The event trigger is checked at timestep boundaries; without "
+          "time steps it only fires at the end of the evolution.");
+    }
+  }
+  status_file_ = output_path / "status.dat";
+  substream_file_ = output_path / "substreams.dat";
+  if (checkpoint_interval_ > 0. && time_step_mode_ == TimeStepMode::None) {
+    log.warn(
+        "Checkpoints are taken at timestep boundaries and are therefore "
+        "not available without timesteps; Checkpoint_Interval is ignored.");
+    checkpoint_interval_ = 0.;
+  }
+
+  /* The particle history is only read by the extended output formats, by
+   * checkpointing, by the frozen Fermi motion in the collider modus and
+   * by the participant count of the event trigger. When none of them is
+   * active, skip maintaining it for every outgoing particle of every
+   * action. */
+  bool history_needed = checkpoint_interval_ > 0. || !resume_file_.empty() ||
+                        modus_.is_collider() || trigger_min_participants_ > 0;
+  for (const auto &output : outputs_) {
+    history_needed = history_needed || output->requires_history();
+  }
+  ParticleData::history_enabled_ = history_needed;
 }
 
 /// String representing a horizontal line.
 const std::string hline(67, '-');
 
 template <typename Modus>
-void Experiment<Modus>::initialize_new_event() {
+void Experiment<Modus>::initialize_new_event(int event_number) {
   const auto &log = logger<LogArea::Experiment>();
-
-  random::set_seed(seed_);
-  log.info() << "random number seed: " << seed_;
-  /* Set seed for the next event. It has to be positive, so it can be entered
-   * in the config.
-   *
-   * We have to be careful about the minimal integer, whose absolute value
-   * cannot be represented. */
-  int64_t r = random::advance();
-  while (r == INT64_MIN) {
-    r = random::advance();
+  current_event_ = event_number;
+
+  /* Each event draws from its own counter-based random stream, derived from
+   * the seed and the event number. Events are therefore reproducible in
+   * isolation and independent of the order in which they run. */
+  random::set_stream(seed_, event_number);
+  log.info() << "random number seed: " << seed_ << ", event " << event_number;
+  /* Record the substream of this event, so it can be reproduced in
+   * isolation with --replay-event and so the events of a split run can be
+   * mapped back to their random streams. */
+  {
+    const bool fresh = !bf::exists(substream_file_);
+    FilePtr substream_file = fopen(substream_file_, "a");
+    if (substream_file) {
+      if (fresh) {
+        std::fprintf(substream_file.get(), "# event seed\n");
+      }
+      std::fprintf(substream_file.get(), "%i %" PRId64 "\n", event_number,
+                   seed_);
+    }
   }
-  seed_ = std::abs(r);
   /* Set the random seed used in PYTHIA hadronization
    * to be same with the SMASH one.
    * In this way we ensure that the results are reproducible
@@ -1220,9 +2383,37 @@ void Experiment<Modus>::initialize_new_event() {
   }
 
   particles_.reset();
+  if (wall_finder_ != nullptr) {
+    /* The crossings scheduled in the previous event refer to particles
+     * that no longer exist. */
+    wall_finder_->reset_scheduling();
+  }
+  if (decay_finder_ != nullptr) {
+    // same for the decays sampled in the previous event
+    decay_finder_->reset_scheduling();
+  }
 
-  // Sample particles according to the initial conditions
-  double start_time = modus_.initial_conditions(&particles_, parameters_);
+  /* Sample particles according to the initial conditions, once per
+   * parallel ensemble. Every ensemble is an independently sampled initial
+   * state; its particles are tagged with the ensemble index, which the
+   * collision finder uses to keep the ensembles from interacting. */
+  double start_time = 0.;
+  for (int ensemble = 0; ensemble < parameters_.n_ensembles; ensemble++) {
+    int max_id_before = -1;
+    if (ensemble > 0) {
+      for (const ParticleData &p : particles_) {
+        max_id_before = std::max(max_id_before, p.id());
+      }
+    }
+    start_time = modus_.initial_conditions(&particles_, parameters_);
+    if (ensemble > 0) {
+      for (ParticleData &p : particles_) {
+        if (p.id() > max_id_before) {
+          p.set_ensemble(ensemble);
+        }
+      }
+    }
+  }
   /* For box modus make sure that particles are in the box. In principle, after
    * a correct initialization they should be, so this is just playing it safe.
    */
@@ -1245,8 +2436,9 @@ void Experiment<Modus>::initialize_new_event() {
   Clock clock_for_this_event(start_time, timestep);
   parameters_.labclock = std::move(clock_for_this_event);
 
-  // Reset the output clock
-  const double dt_output = parameters_.outputclock.timestep_duration();
+  /* Reset the output clock to the configured base interval, which
+   * Interval_Scaling may have stretched during the previous event. */
+  const double dt_output = base_output_interval_;
   const double zeroth_output_time =
       std::floor(start_time / dt_output) * dt_output;
   Clock output_clock(zeroth_output_time, dt_output);
@@ -1260,11 +2452,32 @@ void Experiment<Modus>::initialize_new_event() {
   /* Save the initial conserved quantum numbers and total momentum in
    * the system for conservation checks */
   conserved_initial_ = QuantumNumbers(particles_);
+  conserved_running_ = conserved_initial_;
   wall_actions_total_ = 0;
   previous_wall_actions_total_ = 0;
   interactions_total_ = 0;
   previous_interactions_total_ = 0;
   total_pauli_blocked_ = 0;
+  discarded_actions_total_ = 0;
+  intermediate_output_count_ = 0;
+  trigger_checked_ = false;
+  event_aborted_ = false;
+  /* Forget the currents of the previous event, so that the first
+   * finite-difference time derivative of the new event vanishes. */
+  jmu_B_old_.clear();
+  jmu_I3_old_.clear();
+  jmu_B_core_old_.clear();
+  jmu_I3_core_old_.clear();
+  previous_potentials_update_time_ = parameters_.labclock.current_time();
+  /* The approach-phase snapshots belong to the sampled nucleons of the
+   * previous event; the new event takes fresh ones on its first
+   * potentials update. */
+  jmu_B_projectile_snap_.reset();
+  jmu_B_target_snap_.reset();
+  jmu_I3_projectile_snap_.reset();
+  jmu_I3_target_snap_.reset();
+  approach_snapshots_valid_ = false;
+  density_triggers_fired_ = 0;
   // Print output headers
   log.info() << hline;
   log.info() << "Time [fm]   Ediff [GeV]    Scatt.|Decays   "
@@ -1275,14 +2488,22 @@ void Experiment<Modus>::initialize_new_event() {
 template <typename Modus>
 template <typename Container>
 bool Experiment<Modus>::perform_action(
-    Action &action, const Container &particles_before_actions) {
+    Action &action, const Container &particles_before_actions, bool generate) {
   const auto &log = logger<LogArea::Experiment>();
+  /* Attribute the cycles of this action (including final-state generation,
+   * the Pauli-blocking check and the interaction output) to its process
+   * type; the type is read when the guard ends, because scatter actions
+   * only decide on their process while generating the final state. */
+  RuntimeProfiler::ActionGuard profile_action(action);
   // Make sure to skip invalid and Pauli-blocked actions.
   if (!action.is_valid(particles_)) {
+    discarded_actions_total_++;
     log.debug(~einhard::DRed(), "✘ ", action, " (discarded: invalid)");
     return false;
   }
-  action.generate_final_state();
+  if (generate) {
+    action.generate_final_state();
+  }
   log.debug("Process Type is: ", action.get_type());
   if (pauli_blocker_ && action.is_pauli_blocked(particles_, *pauli_blocker_)) {
     total_pauli_blocked_++;
@@ -1293,7 +2514,8 @@ bool Experiment<Modus>::perform_action(
      * to collide with nucleons from their native nucleus */
     for (const auto &incoming : action.incoming_particles()) {
       assert(incoming.id() >= 0);
-      if (incoming.id() < modus_.total_N_number()) {
+      if (incoming.id() <
+          parameters_.n_ensembles * modus_.total_N_number()) {
         nucleon_has_interacted_[incoming.id()] = true;
       }
     }
@@ -1303,6 +2525,18 @@ bool Experiment<Modus>::perform_action(
   const auto id_process = static_cast<uint32_t>(interactions_total_ + 1);
   action.perform(&particles_, id_process);
   interactions_total_++;
+  /* Fold the delta of this action into the running totals, so the
+   * conservation check can compare against them instead of rescanning the
+   * whole particle list. */
+  conserved_running_ = conserved_running_ +
+                       QuantumNumbers(action.outgoing_particles()) -
+                       QuantumNumbers(action.incoming_particles());
+  if (pauli_blocker_) {
+    // Let later phase-space density estimates see the new particles.
+    for (const auto &p : action.outgoing_particles()) {
+      pauli_blocker_->add_to_index(p);
+    }
+  }
   if (action.get_type() == ProcessType::Wall) {
     wall_actions_total_++;
   }
@@ -1330,10 +2564,8 @@ bool Experiment<Modus>::perform_action(
    * their x coordinates would be 0.1 and 9.9 fm and interaction point
    * position could be either at 10 fm or at 5 fm.
    */
-  for (const auto &output : outputs_) {
-    if (!output->is_dilepton_output() && !output->is_photon_output()) {
-      output->at_interaction(action, rho);
-    }
+  for (OutputInterface *output : interaction_outputs_) {
+    output->at_interaction(action, rho);
   }
 
   // At every collision photons can be produced.
@@ -1377,10 +2609,11 @@ bool Experiment<Modus>::perform_action(
  * Generate the tabulated string which will be printed to the screen when
  * SMASH is running
  *
- * \param[in] particles The interacting particles. Their information will be
- *            used to check the conservation of the total energy and momentum.
- *	      the total number of the particles will be used and printed as
- *	      well.
+ * \param[in] particles The interacting particles. Only their total number is
+ *            read and printed.
+ * \param[in] current_values Current quantum numbers of the system, usually
+ *            the running totals maintained by the action bookkeeping, so no
+ *            scan over the particles is needed here.
  * \param[in] scatterings_this_interval Number of the scatterings occur within
  *            the current timestep.
  * \param[in] conserved_initial Initial quantum numbers needed to check the
@@ -1394,63 +2627,300 @@ bool Experiment<Modus>::perform_action(
  *          'Computing time consumed'
  */
 std::string format_measurements(const Particles &particles,
+                                const QuantumNumbers &current_values,
                                 uint64_t scatterings_this_interval,
                                 const QuantumNumbers &conserved_initial,
                                 SystemTimePoint time_start, double time);
 
+/**
+ * \internal
+ * Reconciliation pass over the flat array of actions emitted by the cell
+ * and neighbor searches: sorts by execution time, with the incoming
+ * particle ids as a deterministic tie-break, and drops duplicate
+ * candidates (same incoming particles at the same time), which can arise
+ * when search regions overlap. Dropping them early is safe because only
+ * one of them could ever be performed - the first one invalidates the
+ * incoming particles of the others. Reconciling one flat sorted array and
+ * bulk-inserting it is cheaper than reshuffling the priority queue per
+ * action, and it makes the queue content independent of the cell
+ * traversal order and the thread scheduling.
+ *
+ * \param[inout] found The found actions, sorted and deduplicated in place.
+ */
+inline void reconcile_found_actions(ActionList &found) {
+  const auto id_less = [](const ParticleData &p, const ParticleData &q) {
+    return p.id() < q.id();
+  };
+  std::sort(found.begin(), found.end(),
+            [&id_less](const ActionPtr &a, const ActionPtr &b) {
+              if (a->time_of_execution() != b->time_of_execution()) {
+                return a->time_of_execution() < b->time_of_execution();
+              }
+              const ParticleList &in_a = a->incoming_particles();
+              const ParticleList &in_b = b->incoming_particles();
+              return std::lexicographical_compare(in_a.begin(), in_a.end(),
+                                                  in_b.begin(), in_b.end(),
+                                                  id_less);
+            });
+  const auto id_equal = [](const ParticleData &p, const ParticleData &q) {
+    return p.id() == q.id();
+  };
+  found.erase(std::unique(found.begin(), found.end(),
+                          [&id_equal](const ActionPtr &a, const ActionPtr &b) {
+                            if (a->time_of_execution() !=
+                                b->time_of_execution()) {
+                              return false;
+                            }
+                            const ParticleList &in_a = a->incoming_particles();
+                            const ParticleList &in_b = b->incoming_particles();
+                            return in_a.size() == in_b.size() &&
+                                   std::equal(in_a.begin(), in_a.end(),
+                                              in_b.begin(), id_equal);
+                          }),
+              found.end());
+}
+
 template <typename Modus>
 void Experiment<Modus>::run_time_evolution() {
   Actions actions;
+  if (time_step_mode_ == TimeStepMode::None) {
+    /* Without time steps the pending actions of the entire evolution are
+     * queued in this container; popping them in time order from a calendar
+     * queue is cheaper than from the binary heap. */
+    actions.use_calendar_queue(parameters_.labclock.current_time(), end_time_);
+  }
 
   const auto &log = logger<LogArea::Experiment>();
 
-  log.info() << format_measurements(particles_, 0u, conserved_initial_,
-                                    time_start_,
+  log.info() << format_measurements(particles_, current_conserved_quantities(),
+                                    0u, conserved_initial_, time_start_,
                                     parameters_.labclock.current_time());
 
+  /* Works both for fresh and for resumed events: the next checkpoint is due
+   * one full interval after the current (possibly restored) time. */
+  next_checkpoint_time_ =
+      parameters_.labclock.current_time() + checkpoint_interval_;
+
+  int timesteps_since_validity_check = 0;
+  int timesteps_since_conservation_scan = 0;
+  int timesteps_since_compaction = 0;
+  int dilute_timesteps = 0;
+  bool termination_test_failed = false;
   while (parameters_.labclock.current_time() < end_time_) {
     const double t = parameters_.labclock.current_time();
     const double dt =
         std::min(parameters_.labclock.timestep_duration(), end_time_ - t);
+    const uint64_t interactions_before_step = interactions_total_;
+    const uint64_t wall_actions_before_step = wall_actions_total_;
     log.debug("Timestepless propagation for next ", dt, " fm/c.");
 
+    /* Periodically re-sort the particle storage by position, so the cell
+     * traversals of the collision search scan it linearly again. Safe at
+     * this point of the loop: all actions of the previous timestep are
+     * consumed, so no copy carrying an internal index is alive. */
+    if (compaction_interval_ > 0 &&
+        ++timesteps_since_compaction >= compaction_interval_) {
+      particles_.sort_by_position();
+      timesteps_since_compaction = 0;
+      /* The re-sort moves the particles to new storage slots, so the
+       * indexes recorded by the cached grid are stale. */
+      cached_grid_.reset();
+    }
+
+    /* Flip the scaling factor of string products whose formation time has
+     * passed, so the collision search reads a constant for them. */
+    particles_.complete_formation(t);
+
+    /* Spectator fast path: freeze the nucleons that never interacted and
+     * thaw any frozen particle the interacting cloud approaches. Safe at
+     * this point of the loop for the same reason as the compaction above:
+     * no copy of a stored particle is alive. */
+    if (spectator_suppression_ && t >= spectator_freeze_time_) {
+      if (update_frozen_spectators(dt)) {
+        /* Frozen particles are excluded from the cells, so changed flags
+         * change the grid membership. */
+        cached_grid_.reset();
+      }
+    }
+
+    /* Refresh the Pauli-blocker cell index. Within this timestep the
+     * particles drift by at most dt, which the index covers with its
+     * margin; newly produced particles are added in perform_action. */
+    if (pauli_blocker_) {
+      pauli_blocker_->build_index(particles_, dt);
+    }
+
     // Perform forced thermalization if required
     if (thermalizer_ &&
         thermalizer_->is_time_to_thermalize(parameters_.labclock)) {
-      const bool ignore_cells_under_treshold = true;
-      thermalizer_->update_thermalizer_lattice(particles_, density_param_,
-                                               ignore_cells_under_treshold);
-      const double current_t = parameters_.labclock.current_time();
-      thermalizer_->thermalize(particles_, current_t,
-                               parameters_.testparticles);
-      ThermalizationAction th_act(*thermalizer_, current_t);
-      if (th_act.any_particles_thermalized()) {
-        perform_action(th_act, particles_);
+      TraceRecorder::Span trace_span("thermalization");
+      /* The cheap binned bound skips the lattice update and the sampling
+       * entirely on the many timesteps where no cell can reach the
+       * critical energy density (peripheral events, late times). */
+      if (thermalizer_->regions_to_thermalize_exist(particles_,
+                                                    density_param_)) {
+        const bool ignore_cells_under_treshold = true;
+        thermalizer_->update_thermalizer_lattice(particles_, density_param_,
+                                                 ignore_cells_under_treshold);
+        const double current_t = parameters_.labclock.current_time();
+        thermalizer_->thermalize(particles_, current_t,
+                                 parameters_.testparticles);
+        ThermalizationAction th_act(*thermalizer_, current_t);
+        if (th_act.any_particles_thermalized()) {
+          perform_action(th_act, particles_);
+        }
       }
     }
 
-    /* (1.a) Create grid. */
-    double min_cell_length = compute_min_cell_length(dt);
-    log.debug("Creating grid with minimal cell length ", min_cell_length);
-    const auto &grid = use_grid_
-                           ? modus_.create_grid(particles_, min_cell_length)
-                           : modus_.create_grid(particles_, min_cell_length,
-                                                CellSizeStrategy::Largest);
-
-    /* (1.b) Iterate over cells and find actions. */
-    grid.iterate_cells(
-        [&](const ParticleList &search_list) {
-          for (const auto &finder : action_finders_) {
-            actions.insert(finder->find_actions_in_cell(search_list, dt));
-          }
-        },
-        [&](const ParticleList &search_list,
-            const ParticleList &neighbors_list) {
+    {
+      RuntimeProfiler::Guard profile_search(
+          RuntimeProfiler::Phase::ActionSearch);
+      TraceRecorder::Span trace_span("collision_search");
+
+      /* (1.a) Create grid. */
+      double min_cell_length = compute_min_cell_length(dt);
+      if (scat_finder_ != nullptr) {
+        /* With Adaptive_Cell_Size this scales the cells up from the safe
+         * minimum based on the measured cost of the previous search;
+         * otherwise the factor is one. */
+        min_cell_length *= scat_finder_->cell_length_scale(particles_.size());
+      }
+      /* The sum changes whenever an action was performed, discarded or
+       * Pauli-blocked, i.e. whenever particles may have been modified
+       * outside of plain propagation. */
+      const uint64_t action_stamp = interactions_total_ +
+                                    discarded_actions_total_ +
+                                    total_pauli_blocked_;
+      if (cached_grid_ && grid_reuse_count_ < grid_reuse_steps_ &&
+          cached_grid_->refreshable() && action_stamp == grid_build_stamp_ &&
+          particles_.size() == grid_build_particle_count_) {
+        /* Nothing but propagation happened since the grid was built, so
+         * the oversized cells still cover all reachable pairs; only the
+         * particle copies in the cells have to be brought up to date. */
+        log.debug("Refreshing the grid of the previous timestep.");
+        cached_grid_->refresh(particles_);
+        ++grid_reuse_count_;
+      } else {
+        /* The cells are enlarged by the maximal drift of both pair members
+         * over the full reuse window, so that a pair which drifts towards
+         * each other during the reuse is still found in the same or an
+         * adjacent cell. */
+        const double reuse_margin = 2. * grid_reuse_steps_ * dt;
+        log.debug("Creating grid with minimal cell length ",
+                  min_cell_length + reuse_margin);
+        cached_grid_ = make_unique<GridType>(
+            use_grid_
+                ? modus_.create_grid(particles_, min_cell_length + reuse_margin)
+                : modus_.create_grid(particles_, min_cell_length + reuse_margin,
+                                     CellSizeStrategy::Largest));
+        grid_reuse_count_ = 0;
+        grid_build_stamp_ = action_stamp;
+        grid_build_particle_count_ = particles_.size();
+      }
+      const GridType &grid = *cached_grid_;
+
+      /* (1.b) Iterate over cells and find actions. The per-cell batches
+       * are only appended to one flat array here, without any cross-cell
+       * coordination; ordering and deduplication happen in a single
+       * reconciliation pass below, before the queue insertion. */
+      ActionList found_flat;
+      ThreadPool *const search_pool = shared_pool();
+      if (search_pool) {
+        /* Collect the independent cell and neighbor searches as tasks for the
+         * work-stealing pool. Finders that are not safe to call concurrently
+         * (those drawing random numbers) are run serially while collecting.
+         * The slices view storage owned by the grid (including the wrapped
+         * search-cell copies of the periodic grid) and stay valid until the
+         * next iterate_cells call, so no particle list is copied here. */
+        struct SearchTask {
+          ParticleSlice search;
+          ParticleSlice neighbors;
+          bool in_cell;
+        };
+        std::vector<SearchTask> tasks;
+        const auto append_flat = [&found_flat](ActionList &&list) {
+          found_flat.insert(found_flat.end(),
+                            std::make_move_iterator(list.begin()),
+                            std::make_move_iterator(list.end()));
+        };
+        grid.iterate_cells(
+            [&](const ParticleSlice &search_list) {
+              tasks.push_back({search_list, {}, true});
+              for (const auto &finder : action_finders_) {
+                if (!finder->is_search_thread_safe()) {
+                  append_flat(finder->find_actions_in_cell(search_list, dt));
+                }
+              }
+            },
+            [&](const ParticleSlice &search_list,
+                const ParticleSlice &neighbors_list) {
+              tasks.push_back({search_list, neighbors_list, false});
+              for (const auto &finder : action_finders_) {
+                if (!finder->is_search_thread_safe()) {
+                  append_flat(finder->find_actions_with_neighbors(
+                      search_list, neighbors_list, dt));
+                }
+              }
+            });
+        /* Each task writes into its own slot; the reconciliation pass
+         * orders the merged array deterministically, so the result does
+         * not depend on the thread scheduling and stays reproducible for
+         * a fixed seed. */
+        std::vector<ActionList> found_actions(tasks.size());
+        search_pool->parallel_range(tasks.size(), [&](size_t i) {
+          const SearchTask &task = tasks[i];
           for (const auto &finder : action_finders_) {
-            actions.insert(finder->find_actions_with_neighbors(
-                search_list, neighbors_list, dt));
+            if (finder->is_search_thread_safe()) {
+              ActionList list =
+                  task.in_cell
+                      ? finder->find_actions_in_cell(task.search, dt)
+                      : finder->find_actions_with_neighbors(task.search,
+                                                            task.neighbors, dt);
+              found_actions[i].insert(found_actions[i].end(),
+                                      std::make_move_iterator(list.begin()),
+                                      std::make_move_iterator(list.end()));
+            }
           }
         });
+        for (ActionList &found : found_actions) {
+          append_flat(std::move(found));
+        }
+      } else {
+        grid.iterate_cells(
+            [&](const ParticleSlice &search_list) {
+              for (const auto &finder : action_finders_) {
+                ActionList list = finder->find_actions_in_cell(search_list, dt);
+                found_flat.insert(found_flat.end(),
+                                  std::make_move_iterator(list.begin()),
+                                  std::make_move_iterator(list.end()));
+              }
+            },
+            [&](const ParticleSlice &search_list,
+                const ParticleSlice &neighbors_list) {
+              for (const auto &finder : action_finders_) {
+                ActionList list = finder->find_actions_with_neighbors(
+                    search_list, neighbors_list, dt);
+                found_flat.insert(found_flat.end(),
+                                  std::make_move_iterator(list.begin()),
+                                  std::make_move_iterator(list.end()));
+              }
+            });
+      }
+      reconcile_found_actions(found_flat);
+      actions.insert_bulk(std::move(found_flat));
+    }
+
+    /* (1.c) Pop the wall crossings and decays that are due in this
+     *       timestep from the analytic schedules (runs without
+     *       potentials). */
+    if (wall_finder_ != nullptr) {
+      actions.insert(wall_finder_->find_scheduled_crossings(
+          particles_, parameters_.labclock.current_time(), dt));
+    }
+    if (decay_finder_ != nullptr) {
+      actions.insert(decay_finder_->find_scheduled_decays(
+          particles_, parameters_.labclock.current_time(), dt));
+    }
 
     /* \todo (optimizations) Adapt timestep size here */
 
@@ -1460,9 +2930,14 @@ void Experiment<Modus>::run_time_evolution() {
     /* (3) Update potentials (if computed on the lattice) and
      *     compute new momenta according to equations of motion */
     if (potentials_) {
+      RuntimeProfiler::Guard profile_lattice(
+          RuntimeProfiler::Phase::LatticeUpdate);
+      TraceRecorder::Span trace_span("lattice_update");
       update_potentials();
       update_momenta(&particles_, parameters_.labclock.timestep_duration(),
-                     *potentials_, FB_lat_.get(), FI3_lat_.get());
+                     *potentials_, FB_lat_.get(), FI3_lat_.get(),
+                     FB_core_lat_.get(), FI3_core_lat_.get(),
+                     interpolate_forces_);
     }
 
     /* (4) Expand universe if non-minkowskian metric; updates
@@ -1473,6 +2948,27 @@ void Experiment<Modus>::run_time_evolution() {
 
     ++parameters_.labclock;
 
+    /* (4b) Density-triggered snapshots: write an extra output of the
+     *      particles the first time the maximal net baryon density on the
+     *      lattice crosses each configured threshold. */
+    if (density_triggers_fired_ < density_trigger_thresholds_.size()) {
+      check_density_triggers();
+    }
+
+    /* (4c) Event trigger: evaluate the abort predicates once per event at
+     *      the first timestep boundary past the configured check time and
+     *      abandon the evolution of a non-qualifying event. */
+    if (trigger_time_ >= 0. && !trigger_checked_ &&
+        parameters_.labclock.current_time() >= trigger_time_) {
+      trigger_checked_ = true;
+      if (!event_passes_trigger()) {
+        event_aborted_ = true;
+        log.info("Event aborted by the trigger at t = ",
+                 parameters_.labclock.current_time(), " fm/c.");
+        break;
+      }
+    }
+
     /* (5) Check conservation laws.
      *
      * Check conservation of conserved quantities if potentials and string
@@ -1481,11 +2977,142 @@ void Experiment<Modus>::run_time_evolution() {
      * momentum are only very roughly conserved in high-energy collisions. */
     if (!potentials_ && !parameters_.strings_switch &&
         metric_.mode_ == ExpansionMode::NoExpansion) {
-      std::string err_msg = conserved_initial_.report_deviations(particles_);
+      /* Compare against the running totals maintained in perform_action,
+       * which is O(1) in the particle number. A non-conserving action is
+       * still caught here, because its delta shifts the running totals away
+       * from the initial values. */
+      std::string err_msg =
+          conserved_initial_.report_deviations(conserved_running_);
       if (!err_msg.empty()) {
         log.error() << err_msg;
         throw std::runtime_error("Violation of conserved quantities!");
       }
+      /* Periodically re-validate the running totals against a full scan of
+       * the particle list, which catches modifications of the particles
+       * that bypassed the action bookkeeping. */
+      if (conservation_check_interval_ > 0 &&
+          ++timesteps_since_conservation_scan >=
+              conservation_check_interval_) {
+        err_msg = conserved_initial_.report_deviations(particles_);
+        if (!err_msg.empty()) {
+          log.error() << err_msg;
+          throw std::runtime_error("Violation of conserved quantities!");
+        }
+        timesteps_since_conservation_scan = 0;
+      }
+    }
+
+    /* (5b) Periodically scan for non-finite values. This is a cheap
+     *      alternative for production runs that have the floating-point
+     *      traps (see fpenvironment.h) disabled for performance. */
+    if (validity_check_interval_ > 0 &&
+        ++timesteps_since_validity_check >= validity_check_interval_) {
+      validate_fp_values();
+      timesteps_since_validity_check = 0;
+    }
+
+    /* (5c) Adapt the timestep to the measured action density: shrink it
+     *      while the system is hot, grow it geometrically in the dilute
+     *      tail. The intermediate output times stay exact independently of
+     *      the stepping, because the output clock runs separately and the
+     *      propagation stops at every due output time, see
+     *      run_time_evolution_timestepless. */
+    if (adaptive_time_step_) {
+      /* Wall crossings are bookkeeping, not physics, so they do not count
+       * towards the activity of the system. */
+      const double scatterings_this_step = static_cast<double>(
+          (interactions_total_ - interactions_before_step) -
+          (wall_actions_total_ - wall_actions_before_step));
+      const double target =
+          adaptive_target_fraction_ * static_cast<double>(particles_.size());
+      /* The factor is bounded to [1/2, 2] per step, so a single noisy
+       * timestep cannot destabilize the controller. */
+      const double factor = std::min(
+          2., std::max(0.5, target / std::max(scatterings_this_step, 1.)));
+      double new_dt = std::min(
+          adaptive_max_dt_,
+          std::max(adaptive_min_dt_,
+                   parameters_.labclock.timestep_duration() * factor));
+      /* The box modus limits the step so that no particle can cross more
+       * than one cell. */
+      const double modus_max_dt =
+          modus_.max_timestep(max_transverse_distance_sqr_);
+      if (modus_max_dt > 0. && new_dt > modus_max_dt) {
+        new_dt = modus_max_dt;
+      }
+      if (new_dt != parameters_.labclock.timestep_duration()) {
+        log.debug("Adaptive timestep: dt = ", new_dt, " fm/c after ",
+                  scatterings_this_step, " scatterings.");
+        parameters_.labclock.set_timestep_duration(new_dt);
+      }
+    }
+
+    /* (5d) If the event has become dilute, evolve the remainder without
+     *      further time stepping. This is only exact when nothing has to be
+     *      recomputed once per timestep: no potentials, no expansion and no
+     *      forced thermalization. */
+    if (timestepless_threshold_ >= 0. &&
+        time_step_mode_ == TimeStepMode::Fixed && potentials_ == nullptr &&
+        thermalizer_ == nullptr &&
+        metric_.mode_ == ExpansionMode::NoExpansion) {
+      const uint64_t actions_this_step =
+          interactions_total_ - interactions_before_step;
+      dilute_timesteps = (static_cast<double>(actions_this_step) <
+                          timestepless_threshold_)
+                             ? dilute_timesteps + 1
+                             : 0;
+      if (dilute_timesteps >= 3) {
+        double remainder = end_time_ - parameters_.labclock.current_time();
+        /* The box modus limits the step so that no particle can cross more
+         * than one cell; other modi impose no limit. */
+        const double max_dt = modus_.max_timestep(max_transverse_distance_sqr_);
+        if (max_dt > 0. && max_dt < remainder) {
+          remainder = max_dt;
+        }
+        if (remainder > parameters_.labclock.timestep_duration()) {
+          log.info() << "Below " << timestepless_threshold_
+                     << " actions per timestep at t = "
+                     << parameters_.labclock.current_time()
+                     << " fm/c, evolving the remaining " << remainder
+                     << " fm/c without time steps.";
+          parameters_.labclock.set_timestep_duration(remainder);
+        }
+      }
+    }
+
+    /* (5e) If nothing happened in this timestep and no collision is still
+     *      possible, the remaining evolution is pure free streaming;
+     *      fast-forward to the end of the event. */
+    if (early_termination_ && !termination_test_failed &&
+        time_step_mode_ == TimeStepMode::Fixed &&
+        interactions_total_ == interactions_before_step &&
+        potentials_ == nullptr && thermalizer_ == nullptr &&
+        dilepton_finder_ == nullptr &&
+        metric_.mode_ == ExpansionMode::NoExpansion && modus_.length() <= 0. &&
+        beam_momentum_.empty() &&
+        parameters_.labclock.current_time() < end_time_) {
+      if (collisions_still_possible()) {
+        /* Re-testing every quiet timestep would cost O(N^2) each time;
+         * wait for the next interaction before trying again. */
+        termination_test_failed = true;
+      } else {
+        log.info() << "No further interactions are possible at t = "
+                   << parameters_.labclock.current_time()
+                   << " fm/c, fast-forwarding to the end of the event.";
+        parameters_.labclock.set_timestep_duration(
+            end_time_ - parameters_.labclock.current_time());
+      }
+    } else if (interactions_total_ != interactions_before_step) {
+      termination_test_failed = false;
+    }
+
+    /* (6) Checkpoint the evolving state. At this point the action queue is
+     *     empty, so particles, clocks, counters and the random engine fully
+     *     determine the remaining evolution. */
+    if (checkpoint_interval_ > 0. &&
+        parameters_.labclock.current_time() >= next_checkpoint_time_) {
+      write_checkpoint_file(current_event_);
+      next_checkpoint_time_ += checkpoint_interval_;
     }
   }
 
@@ -1495,15 +3122,78 @@ void Experiment<Modus>::run_time_evolution() {
   }
 }
 
+template <typename Modus>
+void Experiment<Modus>::write_checkpoint_file(int event_number) {
+  CheckpointState state;
+  state.event_number = event_number;
+  state.labclock = parameters_.labclock.state();
+  state.outputclock = parameters_.outputclock.state();
+  state.engine = random::engine.state();
+  state.interactions_total = interactions_total_;
+  state.previous_interactions_total = previous_interactions_total_;
+  state.wall_actions_total = wall_actions_total_;
+  state.previous_wall_actions_total = previous_wall_actions_total_;
+  state.total_pauli_blocked = total_pauli_blocked_;
+  state.intermediate_output_count = intermediate_output_count_;
+  state.density_triggers_fired = density_triggers_fired_;
+  state.conserved_initial = conserved_initial_;
+  state.particles = particles_.copy_to_vector();
+  state.beam_momentum = beam_momentum_;
+  state.nucleon_has_interacted = nucleon_has_interacted_;
+  write_checkpoint(checkpoint_file_, state);
+  logger<LogArea::Experiment>().info(
+      "Wrote checkpoint at t = ", parameters_.labclock.current_time(),
+      " fm/c to ", checkpoint_file_.string());
+}
+
+template <typename Modus>
+void Experiment<Modus>::restore_checkpoint(const CheckpointState &state) {
+  particles_.reset();
+  for (const ParticleData &p : state.particles) {
+    particles_.insert_with_id(p);
+  }
+  parameters_.labclock.restore_state(state.labclock);
+  parameters_.outputclock.restore_state(state.outputclock);
+  random::engine.restore_state(state.engine);
+  interactions_total_ = state.interactions_total;
+  previous_interactions_total_ = state.previous_interactions_total;
+  wall_actions_total_ = state.wall_actions_total;
+  previous_wall_actions_total_ = state.previous_wall_actions_total;
+  total_pauli_blocked_ = state.total_pauli_blocked;
+  intermediate_output_count_ = state.intermediate_output_count;
+  density_triggers_fired_ = static_cast<size_t>(state.density_triggers_fired);
+  conserved_initial_ = state.conserved_initial;
+  /* The restored particle list is exact, so the running totals can be
+   * re-derived from it instead of being stored in the checkpoint. */
+  conserved_running_ = QuantumNumbers(particles_);
+  beam_momentum_ = state.beam_momentum;
+  nucleon_has_interacted_ = state.nucleon_has_interacted;
+}
+
 template <typename Modus>
 void Experiment<Modus>::propagate_and_shine(double to_time) {
-  const double dt =
-      propagate_straight_line(&particles_, to_time, beam_momentum_);
+  RuntimeProfiler::Guard profile_propagation(
+      RuntimeProfiler::Phase::Propagation);
+  TraceRecorder::Span trace_span("propagation");
   if (dilepton_finder_ != nullptr) {
-    for (const auto &output : outputs_) {
-      dilepton_finder_->shine(particles_, output.get(), dt);
+    if (!dilepton_outputs_.empty()) {
+      /* Fuse the shining into the propagation pass, so the particle
+       * array is traversed only once. Each particle shines with the
+       * interval it was actually propagated over, which matters in the
+       * timestepless mode, where the particles sit at different times
+       * between actions; the unfused code applied the interval of the
+       * last propagated particle to all of them. */
+      propagate_straight_line_fused(
+          &particles_, to_time, beam_momentum_,
+          [&](const ParticleData &data, double dt) {
+            for (OutputInterface *output : dilepton_outputs_) {
+              dilepton_finder_->shine_particle(data, output, dt);
+            }
+          });
+      return;
     }
   }
+  propagate_straight_line(&particles_, to_time, beam_momentum_);
 }
 
 /**
@@ -1530,10 +3220,146 @@ void Experiment<Modus>::run_time_evolution_timestepless(Actions &actions) {
   log.debug("Timestepless propagation: ", "Actions size = ", actions.size(),
             ", start time = ", start_time, ", end time = ", end_time);
 
+  /* A spatial index of the particles that stays alive while the actions are
+   * performed, so that the surrounding-particle search after each performed
+   * action only scans a neighborhood instead of the full particle list.
+   * Indexed positions age by up to time_left as the particles propagate and
+   * the search particle moves just as far, so the cell length has to absorb
+   * twice the maximal drift on top of the usual interaction reach. */
+  SpatialIndex spatial_index(
+      particles_, compute_min_cell_length(time_left) + 2 * time_left);
+
+  /* Speculative parallel evaluation: actions whose incoming particles are
+   * pairwise disjoint commute exactly, so their final states can be sampled
+   * ahead of time on the thread pool while only the commits — which assign
+   * process and particle IDs and mutate the particle list — stay serial and
+   * keep their original order. A speculated action that a commit turns out
+   * to conflict with is discarded by the usual validity check, exactly as
+   * in a serial run. Dilepton shining is excluded because it observes the
+   * particles during the propagation between actions; frozen Fermi motion
+   * is excluded because the speculation propagates the incoming particles
+   * itself, without access to the beam momenta. */
+  ThreadPool *const pool = shared_pool();
+  const bool speculate =
+      pool != nullptr && dilepton_finder_ == nullptr && beam_momentum_.empty();
+  std::vector<ActionPtr> batch;
+  std::size_t batch_next = 0;
+
   // iterate over all actions
-  while (!actions.is_empty()) {
+  while (!actions.is_empty() || batch_next < batch.size()) {
     // get next action
-    ActionPtr act = actions.pop();
+    ActionPtr act;
+    bool pregenerated = false;
+    if (batch_next < batch.size()) {
+      /* Interleave actions that were found after the batch was speculated
+       * (decays and collisions of freshly produced particles) at their
+       * proper place in time. */
+      if (!actions.is_empty()) {
+        act = actions.pop();
+        if (act->time_of_execution() >=
+            batch[batch_next]->time_of_execution()) {
+          actions.insert(std::move(act));
+          act = std::move(batch[batch_next++]);
+          pregenerated = true;
+        }
+      } else {
+        act = std::move(batch[batch_next++]);
+        pregenerated = true;
+      }
+    } else {
+      act = actions.pop();
+      if (speculate && !actions.is_empty() && act->is_valid(particles_) &&
+          act->time_of_execution() <= next_output_time()) {
+        /* Collect a prefix of mutually independent actions. The collection
+         * stops at the first action touching an already claimed particle,
+         * at the next output time (the output has to observe the particle
+         * list with all earlier commits applied) and at a modest batch
+         * size, which bounds the work lost when a commit invalidates the
+         * speculation. */
+        constexpr std::size_t max_batch_size = 64;
+        batch.clear();
+        std::vector<int32_t> claimed_ids;
+        for (const ParticleData &p : act->incoming_particles()) {
+          claimed_ids.push_back(p.id());
+        }
+        batch.push_back(std::move(act));
+        while (batch.size() < max_batch_size && !actions.is_empty()) {
+          ActionPtr candidate = actions.pop();
+          if (!candidate->is_valid(particles_)) {
+            log.debug(~einhard::DRed(), "✘ ", candidate,
+                      " (discarded: invalid)");
+            continue;
+          }
+          if (candidate->time_of_execution() > next_output_time()) {
+            actions.insert(std::move(candidate));
+            break;
+          }
+          bool conflict = false;
+          for (const ParticleData &p : candidate->incoming_particles()) {
+            if (std::find(claimed_ids.begin(), claimed_ids.end(), p.id()) !=
+                claimed_ids.end()) {
+              conflict = true;
+              break;
+            }
+          }
+          if (conflict) {
+            actions.insert(std::move(candidate));
+            break;
+          }
+          for (const ParticleData &p : candidate->incoming_particles()) {
+            claimed_ids.push_back(p.id());
+          }
+          batch.push_back(std::move(candidate));
+        }
+        if (batch.size() > 1) {
+          /* Bring the incoming copies to their execution time, which the
+           * serial loop achieves by propagating all particles; the final
+           * state is placed at the interaction point, so it has to be
+           * sampled with the propagated positions. */
+          for (const ActionPtr &a : batch) {
+            a->propagate_incoming_to_execution_time();
+          }
+          /* Every task seeds the engine of its worker with a value drawn
+           * serially beforehand, which makes the sampled final states
+           * independent of the thread scheduling, cf. do_final_decays. */
+          std::vector<uint64_t> task_seeds(batch.size());
+          for (auto &seed : task_seeds) {
+            seed = random::engine();
+          }
+          std::vector<std::exception_ptr> errors(batch.size());
+          pool->parallel_range(batch.size(), [&](size_t i) {
+            random::engine.seed(task_seeds[i]);
+            try {
+              batch[i]->generate_final_state();
+            } catch (...) {
+              errors[i] = std::current_exception();
+            }
+          });
+          for (const auto &error : errors) {
+            if (error) {
+              std::rethrow_exception(error);
+            }
+          }
+          pregenerated = true;
+          act = std::move(batch[0]);
+          batch_next = 1;
+        } else {
+          // a batch of one gains nothing; fall back to the serial path
+          act = std::move(batch[0]);
+          batch.clear();
+          batch_next = 0;
+        }
+      }
+    }
+    /* Overlap the pointer chasing of the upcoming actions with the work on
+     * the current one: peek at the next few scheduled actions and prefetch
+     * the particle slots and type rows their validation and execution will
+     * dereference. A pure latency hint, so the approximate peek order does
+     * not affect determinism. */
+    constexpr std::size_t prefetch_depth = 4;
+    actions.peek_upcoming(prefetch_depth, [this](const Action &next) {
+      next.prefetch_incoming(particles_);
+    });
     if (!act->is_valid(particles_)) {
       log.debug(~einhard::DRed(), "✘ ", act, " (discarded: invalid)");
       continue;
@@ -1563,7 +3389,7 @@ void Experiment<Modus>::run_time_evolution_timestepless(Actions &actions) {
      * propagated since the construction of the action. */
     act->update_incoming(particles_);
 
-    const bool performed = perform_action(*act, particles_);
+    const bool performed = perform_action(*act, particles_, !pregenerated);
 
     /* No need to update actions for outgoing particles
      * if the action is not performed. */
@@ -1575,13 +3401,46 @@ void Experiment<Modus>::run_time_evolution_timestepless(Actions &actions) {
 
     time_left = end_time - act->time_of_execution();
     const ParticleList &outgoing_particles = act->outgoing_particles();
+    /* The incoming particles went stale in the index automatically (their
+     * id_process changed), the outgoing ones have to be added. */
+    for (const ParticleData &p : outgoing_particles) {
+      spatial_index.insert(p);
+    }
+    /* Gather the current state of the particles around the outgoing ones
+     * once; duplicates from overlapping neighborhoods must be dropped,
+     * otherwise the same interaction would be found twice. */
+    ParticleList surrounding_particles;
+    for (const ParticleData &p : outgoing_particles) {
+      for (ParticleData &neighbor : spatial_index.neighborhood(p, particles_)) {
+        const auto duplicate = std::find_if(
+            surrounding_particles.begin(), surrounding_particles.end(),
+            [&neighbor](const ParticleData &q) {
+              return q.id() == neighbor.id();
+            });
+        if (duplicate == surrounding_particles.end()) {
+          surrounding_particles.push_back(std::move(neighbor));
+        }
+      }
+    }
     for (const auto &finder : action_finders_) {
       // Outgoing particles can still decay, cross walls...
       actions.insert(
           finder->find_actions_in_cell(outgoing_particles, time_left));
       // ... and collide with other particles.
       actions.insert(finder->find_actions_with_surrounding_particles(
-          outgoing_particles, particles_, time_left));
+          outgoing_particles, surrounding_particles, time_left));
+    }
+    if (wall_finder_ != nullptr) {
+      /* Returns the crossings within the remaining timestep and schedules
+       * the later ones for the following steps. */
+      actions.insert(
+          wall_finder_->find_actions_in_cell(outgoing_particles, time_left));
+    }
+    if (decay_finder_ != nullptr) {
+      /* Samples the decay times of the outgoing particles once; decays
+       * within the remaining timestep are returned, later ones scheduled. */
+      actions.insert(
+          decay_finder_->find_actions_in_cell(outgoing_particles, time_left));
     }
 
     check_interactions_total(interactions_total_);
@@ -1603,6 +3462,8 @@ void Experiment<Modus>::run_time_evolution_timestepless(Actions &actions) {
 
 template <typename Modus>
 void Experiment<Modus>::intermediate_output() {
+  RuntimeProfiler::Guard profile_output(RuntimeProfiler::Phase::Output);
+  TraceRecorder::Span trace_span("intermediate_output");
   const auto &log = logger<LogArea::Experiment>();
   const uint64_t wall_actions_this_interval =
       wall_actions_total_ - previous_wall_actions_total_;
@@ -1611,46 +3472,78 @@ void Experiment<Modus>::intermediate_output() {
                                               previous_interactions_total_ -
                                               wall_actions_this_interval;
   previous_interactions_total_ = interactions_total_;
-  log.info() << format_measurements(particles_, interactions_this_interval,
-                                    conserved_initial_, time_start_,
-                                    parameters_.outputclock.current_time());
+  log.info() << format_measurements(
+      particles_, current_conserved_quantities(), interactions_this_interval,
+      conserved_initial_, time_start_, parameters_.outputclock.current_time());
   const LatticeUpdate lat_upd = LatticeUpdate::AtOutput;
-  // save evolution data
-  for (const auto &output : outputs_) {
-    if (output->is_dilepton_output() || output->is_photon_output()) {
-      continue;
-    }
-    output->at_intermediate_time(particles_, parameters_.outputclock,
-                                 density_param_);
-
-    // Thermodynamic output on the lattice versus time
+  const uint64_t output_number = intermediate_output_count_++;
+  /* Whether the thermodynamic quantities are due at this output; with the
+   * default cadence of one they are evaluated at every output. */
+  const bool td_due =
+      td_output_cadence_ <= 1 || output_number % td_output_cadence_ == 0;
+
+  /* Thermodynamic output on the lattice versus time. The lattices are
+   * filled once per output interval, before the loop over the enabled
+   * outputs, so that several outputs share one traversal of the particles.
+   * The density and energy-momentum tensor lattices are filled for the
+   * same density type, so one fused pass evaluates every smearing factor
+   * only once for both of them. */
+  RectangularLattice<EnergyMomentumTensor> *Tmn_to_update =
+      (td_due && (printout_tmn_ || printout_tmn_landau_ || printout_v_landau_))
+          ? Tmn_.get()
+          : nullptr;
+  DensityLattice *jmu_to_print = nullptr;
+  if (td_due) {
     switch (dens_type_lattice_printout_) {
       case DensityType::Baryon:
-        update_lattice(jmu_B_lat_.get(), lat_upd, DensityType::Baryon,
-                       density_param_, particles_, false);
-        output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
-                                      DensityType::Baryon, *jmu_B_lat_);
+        update_lattice(jmu_B_lat_.get(), Tmn_to_update, lat_upd,
+                       DensityType::Baryon, density_param_, particles_, false);
+        jmu_to_print = jmu_B_lat_.get();
         break;
       case DensityType::BaryonicIsospin:
-        update_lattice(jmu_I3_lat_.get(), lat_upd, DensityType::BaryonicIsospin,
-                       density_param_, particles_, false);
-        output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
-                                      DensityType::BaryonicIsospin,
-                                      *jmu_I3_lat_);
+        update_lattice(jmu_I3_lat_.get(), Tmn_to_update, lat_upd,
+                       DensityType::BaryonicIsospin, density_param_, particles_,
+                       false);
+        jmu_to_print = jmu_I3_lat_.get();
         break;
       case DensityType::None:
+        update_lattice(Tmn_to_update, lat_upd, dens_type_lattice_printout_,
+                       density_param_, particles_);
         break;
       default:
-        update_lattice(jmu_custom_lat_.get(), lat_upd,
+        update_lattice(jmu_custom_lat_.get(), Tmn_to_update, lat_upd,
                        dens_type_lattice_printout_, density_param_, particles_,
                        false);
-        output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
-                                      dens_type_lattice_printout_,
-                                      *jmu_custom_lat_);
+        jmu_to_print = jmu_custom_lat_.get();
     }
-    if (printout_tmn_ || printout_tmn_landau_ || printout_v_landau_) {
-      update_lattice(Tmn_.get(), lat_upd, dens_type_lattice_printout_,
-                     density_param_, particles_);
+  }
+
+  // save evolution data
+  for (const auto &output : outputs_) {
+    if (output->is_dilepton_output() || output->is_photon_output()) {
+      continue;
+    }
+    TraceRecorder::Span trace_output_span(output->name().c_str());
+    /* The per-content cadences decimate the regular snapshot of the
+     * particles and the thermodynamic evaluation independently; every other
+     * content keeps the full output frequency. */
+    const std::string &content = output->name();
+    const bool content_due =
+        (content == "Particles")
+            ? (part_output_cadence_ <= 1 ||
+               output_number % part_output_cadence_ == 0)
+            : (content != "Thermodynamics" || td_due);
+    if (content_due) {
+      output->at_intermediate_time(particles_, parameters_.outputclock,
+                                   density_param_);
+    }
+
+    if (jmu_to_print != nullptr) {
+      output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
+                                    dens_type_lattice_printout_,
+                                    *jmu_to_print);
+    }
+    if (Tmn_to_update != nullptr) {
       if (printout_tmn_) {
         output->thermodynamics_output(ThermodynamicQuantity::Tmn,
                                       dens_type_lattice_printout_, *Tmn_);
@@ -1665,20 +3558,209 @@ void Experiment<Modus>::intermediate_output() {
       }
     }
 
-    if (thermalizer_) {
+    if (thermalizer_ && td_due) {
       output->thermodynamics_output(*thermalizer_);
     }
   }
+
+  /* Geometric spacing of the output times: every subsequent intermediate
+   * output covers an interval stretched by the configured factor. The clock
+   * state (and with it the stretched interval) is part of the checkpoint,
+   * so a resumed event continues the same output schedule. */
+  if (output_interval_scaling_ > 1.) {
+    parameters_.outputclock.set_timestep_duration(
+        parameters_.outputclock.timestep_duration() *
+        output_interval_scaling_);
+  }
+}
+
+template <typename Modus>
+bool Experiment<Modus>::update_frozen_spectators(double dt) {
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  /* Bounding box of the particles that can initiate an interaction: all
+   * produced particles and all nucleons that collided at least once. The
+   * spectator candidates are deliberately left out, otherwise the two
+   * receding spectator clusters would keep the box large forever. */
+  const int n_initial = parameters_.n_ensembles * modus_.total_N_number();
+  std::array<double, 3> lo = {{inf, inf, inf}};
+  std::array<double, 3> hi = {{-inf, -inf, -inf}};
+  for (const ParticleData &p : particles_) {
+    if (p.id() < n_initial &&
+        p.get_history().collisions_per_particle == 0) {
+      continue;
+    }
+    const FourVector &r = p.position();
+    lo[0] = std::min(lo[0], r.x1());
+    hi[0] = std::max(hi[0], r.x1());
+    lo[1] = std::min(lo[1], r.x2());
+    hi[1] = std::max(hi[1], r.x2());
+    lo[2] = std::min(lo[2], r.x3());
+    hi[2] = std::max(hi[2], r.x3());
+  }
+  /* The reach of the collision search within this timestep: the maximal
+   * interaction range plus the drift of both the active and the frozen
+   * particle. */
+  const double margin = compute_min_cell_length(dt) + 2. * dt;
+  bool changed = false;
+  for (ParticleData &p : particles_) {
+    if (p.id() >= n_initial ||
+        p.get_history().collisions_per_particle != 0) {
+      continue;
+    }
+    const FourVector &r = p.position();
+    const bool near_active = r.x1() >= lo[0] - margin &&
+                             r.x1() <= hi[0] + margin &&
+                             r.x2() >= lo[1] - margin &&
+                             r.x2() <= hi[1] + margin &&
+                             r.x3() >= lo[2] - margin &&
+                             r.x3() <= hi[2] + margin;
+    if (p.frozen() == near_active) {
+      p.set_frozen(!near_active);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+template <typename Modus>
+void Experiment<Modus>::check_density_triggers() {
+  const auto &log = logger<LogArea::Experiment>();
+  if (jmu_trigger_lat_) {
+    update_lattice(jmu_trigger_lat_.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, density_param_, particles_, false);
+  }
+  DensityLattice *lat =
+      jmu_trigger_lat_ ? jmu_trigger_lat_.get() : jmu_B_lat_.get();
+  double rho_max = 0.;
+  for (DensityOnLattice &node : *lat) {
+    rho_max = std::max(rho_max, node.density());
+  }
+  bool crossed = false;
+  while (density_triggers_fired_ < density_trigger_thresholds_.size() &&
+         rho_max >= density_trigger_thresholds_[density_triggers_fired_]) {
+    log.info("Net baryon density crossed ",
+             density_trigger_thresholds_[density_triggers_fired_],
+             " fm^-3 (lattice maximum: ", rho_max, " fm^-3) at t = ",
+             parameters_.labclock.current_time(), " fm/c.");
+    density_triggers_fired_++;
+    crossed = true;
+  }
+  if (!crossed) {
+    return;
+  }
+  /* The snapshot is stamped with the lab time, which generally falls
+   * between two ticks of the output clock. */
+  const Clock snapshot_clock(parameters_.labclock.current_time(),
+                             parameters_.outputclock.timestep_duration());
+  for (const auto &output : outputs_) {
+    if (output->is_dilepton_output() || output->is_photon_output()) {
+      continue;
+    }
+    output->at_intermediate_time(particles_, snapshot_clock, density_param_);
+  }
+}
+
+template <typename Modus>
+bool Experiment<Modus>::event_passes_trigger() const {
+  if (trigger_min_participants_ > 0) {
+    int participants = 0;
+    for (const ParticleData &p : particles_) {
+      if (p.type().is_nucleon() &&
+          p.get_history().collisions_per_particle > 0) {
+        participants++;
+      }
+    }
+    if (participants < trigger_min_participants_) {
+      return false;
+    }
+  }
+  if (!trigger_required_pdgs_.empty()) {
+    int found = 0;
+    for (const ParticleData &p : particles_) {
+      if (std::find(trigger_required_pdgs_.begin(),
+                    trigger_required_pdgs_.end(),
+                    p.pdgcode()) != trigger_required_pdgs_.end()) {
+        found++;
+      }
+    }
+    if (found < trigger_required_multiplicity_) {
+      return false;
+    }
+  }
+  return true;
 }
 
 template <typename Modus>
 void Experiment<Modus>::update_potentials() {
   if (potentials_) {
+    /* With finite-difference derivatives only the currents themselves are
+     * deposited; their gradients come from the node differences below and
+     * the time derivative from a backward difference to the previous
+     * update. */
+    const bool deposit_gradients = !derivatives_finite_difference_;
+    const double time_interval = parameters_.labclock.current_time() -
+                                 previous_potentials_update_time_;
+    previous_potentials_update_time_ = parameters_.labclock.current_time();
+    /* Until the first interaction of a collider event the nuclei move
+     * rigidly, so the lattice currents are translated from the cached
+     * snapshots instead of re-deposited from every nucleon. */
+    const bool rigid_phase = rigid_approach_ && interactions_total_ == 0;
+    if (rigid_phase && !approach_snapshots_valid_) {
+      take_approach_snapshots(deposit_gradients);
+    } else if (!rigid_phase && approach_snapshots_valid_) {
+      /* The first interaction broke the rigid motion: drop the snapshots
+       * and make the incremental updaters, which never saw the rigid
+       * fills, recompute from scratch. */
+      jmu_B_projectile_snap_.reset();
+      jmu_B_target_snap_.reset();
+      jmu_I3_projectile_snap_.reset();
+      jmu_I3_target_snap_.reset();
+      approach_snapshots_valid_ = false;
+      if (jmu_B_updater_) {
+        jmu_B_updater_->invalidate();
+      }
+      if (jmu_I3_updater_) {
+        jmu_I3_updater_->invalidate();
+      }
+    }
+    const double time_since_snapshot =
+        parameters_.labclock.current_time() - approach_snapshot_time_;
+    const double shift_projectile =
+        modus_.velocity_projectile() * time_since_snapshot;
+    const double shift_target = modus_.velocity_target() * time_since_snapshot;
     if (potentials_->use_skyrme() && jmu_B_lat_ != nullptr) {
-      update_lattice(jmu_B_lat_.get(), LatticeUpdate::EveryTimestep,
-                     DensityType::Baryon, density_param_, particles_, true);
+      if (rigid_phase) {
+        fill_lattice_from_rigid_snapshots(
+            jmu_B_lat_.get(), *jmu_B_projectile_snap_, shift_projectile,
+            *jmu_B_target_snap_, shift_target);
+      } else if (jmu_B_updater_) {
+        jmu_B_updater_->update(jmu_B_lat_.get(), LatticeUpdate::EveryTimestep,
+                               DensityType::Baryon, density_param_, particles_,
+                               deposit_gradients);
+      } else {
+        update_lattice(jmu_B_lat_.get(), LatticeUpdate::EveryTimestep,
+                       DensityType::Baryon, density_param_, particles_,
+                       deposit_gradients);
+      }
+      if (derivatives_finite_difference_) {
+        compute_gradients_finite_difference(jmu_B_lat_.get(), jmu_B_old_,
+                                            time_interval);
+      }
+      /* Nodes the incremental update left untouched hold bitwise the
+       * same density as before, so their cached potentials and forces
+       * are still valid and the recomputation skips them. Node
+       * differences couple neighbors, so with finite-difference
+       * derivatives the skipping is disabled. */
+      const std::vector<char> *dirty_B =
+          !rigid_phase && !derivatives_finite_difference_ && jmu_B_updater_ &&
+                  !jmu_B_updater_->all_nodes_dirty()
+              ? &jmu_B_updater_->dirty_nodes()
+              : nullptr;
       const size_t UBlattice_size = UB_lat_->size();
       for (size_t i = 0; i < UBlattice_size; i++) {
+        if (dirty_B != nullptr && !(*dirty_B)[i]) {
+          continue;
+        }
         auto jB = (*jmu_B_lat_)[i];
         const FourVector flow_four_velocity = abs(jB.density()) > really_small
                                                   ? jB.jmu_net() / jB.density()
@@ -1688,13 +3770,52 @@ void Experiment<Modus>::update_potentials() {
         (*FB_lat_)[i] = potentials_->skyrme_force(jB.density(), jB.grad_rho(),
                                                   jB.dj_dt(), jB.rot_j());
       }
+      if (jmu_B_core_lat_ != nullptr) {
+        /* The refined core lattice is small, so it is always recomputed
+         * from scratch; the gradients pick up the finer cell spacing. */
+        update_lattice(jmu_B_core_lat_.get(), LatticeUpdate::EveryTimestep,
+                       DensityType::Baryon, density_param_, particles_,
+                       deposit_gradients);
+        if (derivatives_finite_difference_) {
+          compute_gradients_finite_difference(jmu_B_core_lat_.get(),
+                                              jmu_B_core_old_, time_interval);
+        }
+        const size_t core_size = FB_core_lat_->size();
+        for (size_t i = 0; i < core_size; i++) {
+          auto jB = (*jmu_B_core_lat_)[i];
+          (*FB_core_lat_)[i] = potentials_->skyrme_force(
+              jB.density(), jB.grad_rho(), jB.dj_dt(), jB.rot_j());
+        }
+      }
     }
     if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
-      update_lattice(jmu_I3_lat_.get(), LatticeUpdate::EveryTimestep,
-                     DensityType::BaryonicIsospin, density_param_, particles_,
-                     true);
+      if (rigid_phase) {
+        fill_lattice_from_rigid_snapshots(
+            jmu_I3_lat_.get(), *jmu_I3_projectile_snap_, shift_projectile,
+            *jmu_I3_target_snap_, shift_target);
+      } else if (jmu_I3_updater_) {
+        jmu_I3_updater_->update(jmu_I3_lat_.get(), LatticeUpdate::EveryTimestep,
+                                DensityType::BaryonicIsospin, density_param_,
+                                particles_, deposit_gradients);
+      } else {
+        update_lattice(jmu_I3_lat_.get(), LatticeUpdate::EveryTimestep,
+                       DensityType::BaryonicIsospin, density_param_,
+                       particles_, deposit_gradients);
+      }
+      if (derivatives_finite_difference_) {
+        compute_gradients_finite_difference(jmu_I3_lat_.get(), jmu_I3_old_,
+                                            time_interval);
+      }
+      const std::vector<char> *dirty_I3 =
+          !rigid_phase && !derivatives_finite_difference_ && jmu_I3_updater_ &&
+                  !jmu_I3_updater_->all_nodes_dirty()
+              ? &jmu_I3_updater_->dirty_nodes()
+              : nullptr;
       const size_t UI3lattice_size = UI3_lat_->size();
       for (size_t i = 0; i < UI3lattice_size; i++) {
+        if (dirty_I3 != nullptr && !(*dirty_I3)[i]) {
+          continue;
+        }
         auto jI3 = (*jmu_I3_lat_)[i];
         const FourVector flow_four_velocity =
             abs(jI3.density()) > really_small ? jI3.jmu_net() / jI3.density()
@@ -1704,10 +3825,71 @@ void Experiment<Modus>::update_potentials() {
         (*FI3_lat_)[i] = potentials_->symmetry_force(jI3.grad_rho(),
                                                      jI3.dj_dt(), jI3.rot_j());
       }
+      if (jmu_I3_core_lat_ != nullptr) {
+        update_lattice(jmu_I3_core_lat_.get(), LatticeUpdate::EveryTimestep,
+                       DensityType::BaryonicIsospin, density_param_,
+                       particles_, deposit_gradients);
+        if (derivatives_finite_difference_) {
+          compute_gradients_finite_difference(jmu_I3_core_lat_.get(),
+                                              jmu_I3_core_old_, time_interval);
+        }
+        const size_t core_size = FI3_core_lat_->size();
+        for (size_t i = 0; i < core_size; i++) {
+          auto jI3 = (*jmu_I3_core_lat_)[i];
+          (*FI3_core_lat_)[i] = potentials_->symmetry_force(
+              jI3.grad_rho(), jI3.dj_dt(), jI3.rot_j());
+        }
+      }
     }
   }
 }
 
+template <typename Modus>
+void Experiment<Modus>::take_approach_snapshots(bool deposit_gradients) {
+  /* Split the particles between the nuclei by which beam velocity their
+   * longitudinal velocity is closer to; before contact this is
+   * unambiguous for Fermi motion "off" and "frozen" and a good guess
+   * with Fermi motion "on". */
+  const double v_projectile = modus_.velocity_projectile();
+  const double v_target = modus_.velocity_target();
+  Particles projectile, target;
+  for (const ParticleData &p : particles_) {
+    const double vz = p.velocity().x3();
+    if (std::abs(vz - v_projectile) < std::abs(vz - v_target)) {
+      projectile.insert(p);
+    } else {
+      target.insert(p);
+    }
+  }
+  auto make_snapshot = [](const DensityLattice &geometry) {
+    return make_unique<DensityLattice>(
+        geometry.lattice_sizes(), geometry.dimensions(), geometry.origin(),
+        geometry.periodic(), LatticeUpdate::EveryTimestep);
+  };
+  if (potentials_->use_skyrme() && jmu_B_lat_ != nullptr) {
+    jmu_B_projectile_snap_ = make_snapshot(*jmu_B_lat_);
+    jmu_B_target_snap_ = make_snapshot(*jmu_B_lat_);
+    update_lattice(jmu_B_projectile_snap_.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, density_param_, projectile,
+                   deposit_gradients);
+    update_lattice(jmu_B_target_snap_.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, density_param_, target,
+                   deposit_gradients);
+  }
+  if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
+    jmu_I3_projectile_snap_ = make_snapshot(*jmu_I3_lat_);
+    jmu_I3_target_snap_ = make_snapshot(*jmu_I3_lat_);
+    update_lattice(jmu_I3_projectile_snap_.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::BaryonicIsospin, density_param_, projectile,
+                   deposit_gradients);
+    update_lattice(jmu_I3_target_snap_.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::BaryonicIsospin, density_param_, target,
+                   deposit_gradients);
+  }
+  approach_snapshot_time_ = parameters_.labclock.current_time();
+  approach_snapshots_valid_ = true;
+}
+
 template <typename Modus>
 void Experiment<Modus>::do_final_decays() {
   /* At end of time evolution: Force all resonances to decay. In order to handle
@@ -1726,12 +3908,52 @@ void Experiment<Modus>::do_final_decays() {
       }
     }
     // Find actions.
+    ActionList final_actions;
     for (const auto &finder : action_finders_) {
-      actions.insert(finder->find_final_actions(particles_));
+      ActionList found = finder->find_final_actions(particles_);
+      final_actions.insert(final_actions.end(),
+                           std::make_move_iterator(found.begin()),
+                           std::make_move_iterator(found.end()));
     }
+    if (decay_finder_ != nullptr) {
+      ActionList found = decay_finder_->find_final_actions(particles_);
+      final_actions.insert(final_actions.end(),
+                           std::make_move_iterator(found.begin()),
+                           std::make_move_iterator(found.end()));
+    }
+    ThreadPool *const pool = shared_pool();
+    bool pregenerated = false;
+    if (pool != nullptr && final_actions.size() > 1) {
+      /* The forced decays are independent of each other, so their final
+       * states can be sampled in parallel. Every task seeds the engine of
+       * its worker with a value drawn serially beforehand, which makes the
+       * sampled final states independent of the thread scheduling. The
+       * actions are performed serially below, so process and particle IDs
+       * are assigned in the same deterministic order as in a serial run. */
+      std::vector<uint64_t> task_seeds(final_actions.size());
+      for (auto &seed : task_seeds) {
+        seed = random::engine();
+      }
+      std::vector<std::exception_ptr> errors(final_actions.size());
+      pool->parallel_range(final_actions.size(), [&](size_t i) {
+        random::engine.seed(task_seeds[i]);
+        try {
+          final_actions[i]->generate_final_state();
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      });
+      for (const auto &error : errors) {
+        if (error) {
+          std::rethrow_exception(error);
+        }
+      }
+      pregenerated = true;
+    }
+    actions.insert(std::move(final_actions));
     // Perform actions.
     while (!actions.is_empty()) {
-      perform_action(*actions.pop(), particles_before_actions);
+      perform_action(*actions.pop(), particles_before_actions, !pregenerated);
     }
     // loop until no more decays occur
   } while (interactions_total_ > interactions_old);
@@ -1746,6 +3968,9 @@ void Experiment<Modus>::do_final_decays() {
 
 template <typename Modus>
 void Experiment<Modus>::final_output(const int evt_num) {
+  /* The event-end files written asynchronously on the thread pool are not
+   * covered by this guard; only the main-thread part of the output is. */
+  RuntimeProfiler::Guard profile_output(RuntimeProfiler::Phase::Output);
   const auto &log = logger<LogArea::Experiment>();
   /* make sure the experiment actually ran (note: we should compare this
    * to the start time, but we don't know that. Therefore, we check that
@@ -1756,9 +3981,10 @@ void Experiment<Modus>::final_output(const int evt_num) {
     const uint64_t interactions_this_interval = interactions_total_ -
                                                 previous_interactions_total_ -
                                                 wall_actions_this_interval;
-    log.info() << format_measurements(particles_, interactions_this_interval,
-                                      conserved_initial_, time_start_,
-                                      parameters_.outputclock.current_time());
+    log.info() << format_measurements(
+        particles_, current_conserved_quantities(), interactions_this_interval,
+        conserved_initial_, time_start_,
+        parameters_.outputclock.current_time());
     log.info() << hline;
     log.info() << "Time real: " << SystemClock::now() - time_start_;
     log.info() << "Final interaction number: "
@@ -1774,21 +4000,212 @@ void Experiment<Modus>::final_output(const int evt_num) {
       log.warn("End time might be too small. ", unformed_particles_count,
                " unformed particles were found at the end of the evolution.");
     }
+    if (scat_finder_ != nullptr && scat_finder_->collect_statistics()) {
+      log.info() << "Actions: "
+                 << interactions_total_ - wall_actions_total_ << " performed, "
+                 << discarded_actions_total_ << " invalid when popped, "
+                 << total_pauli_blocked_ << " Pauli-blocked.";
+      scat_finder_->report_statistics();
+    }
   }
 
-  for (const auto &output : outputs_) {
-    output->at_eventend(particles_, evt_num, modus_.impact_parameter());
+  ThreadPool *const pool = shared_pool();
+  if (pool != nullptr) {
+    /* Hand the final state over to an asynchronous writer, so reading and
+     * sampling of the next event does not wait for the files. The particle
+     * list can be moved out, because the next event rebuilds it from
+     * scratch; run() waits for the writer before the next event start
+     * output and after the last event. */
+    output_snapshot_ = std::move(particles_);
+    const double impact_parameter = modus_.impact_parameter();
+    previous_event_output_ = pool->submit([this, evt_num, impact_parameter] {
+      for (const auto &output : outputs_) {
+        TraceRecorder::Span trace_output_span(output->name().c_str());
+        output->at_eventend(output_snapshot_, evt_num, impact_parameter);
+      }
+    });
+  } else {
+    for (const auto &output : outputs_) {
+      TraceRecorder::Span trace_output_span(output->name().c_str());
+      output->at_eventend(particles_, evt_num, modus_.impact_parameter());
+    }
   }
 }
 
+template <typename Modus>
+void Experiment<Modus>::write_status(const int event_number) {
+  const bool fresh = !bf::exists(status_file_);
+  FilePtr file = fopen(status_file_, "a");
+  if (!file) {
+    return;
+  }
+  if (fresh) {
+    std::fprintf(file.get(), "# event wall_seconds interactions max_rss_kb\n");
+  }
+  const SystemTimeSpan elapsed = SystemClock::now() - time_start_;
+  const double wall_seconds =
+      std::chrono::duration_cast<std::chrono::duration<double>>(elapsed)
+          .count();
+  /* Peak resident set size of the process; ru_maxrss is in kilobytes on
+   * Linux. The scheduler compares it against the memory request of the
+   * job. */
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  std::fprintf(file.get(), "%i %.1f %" PRIu64 " %ld\n", event_number,
+               wall_seconds, status_interactions_,
+               static_cast<long>(usage.ru_maxrss));
+  /* The FilePtr closes the file again right away, so every line reaches
+   * the filesystem and the file modification time advances even if the
+   * run is killed later. */
+}
+
+/**
+ * \internal
+ * \return Whether all components of the given four-vector are finite.
+ *
+ * A NaN or infinity in any component propagates into the sum, so a single
+ * isfinite check suffices. Finite components cannot sum up to an infinity
+ * for any physically sensible magnitude.
+ */
+inline bool all_components_finite(const FourVector &v) {
+  return std::isfinite(v.x0() + v.x1() + v.x2() + v.x3());
+}
+
+template <typename Modus>
+void Experiment<Modus>::validate_fp_values() const {
+  const auto &log = logger<LogArea::Experiment>();
+  const ParticleData *offender = particles_.find_nonfinite_particle();
+  if (offender) {
+    /* The printed particle includes the id of the last process it took part
+     * in; together with the process type this locates the code that produced
+     * the value. */
+    log.error() << "Non-finite position or momentum found at t = "
+                << parameters_.labclock.current_time() << " fm/c: " << *offender
+                << ", last process type: "
+                << static_cast<int>(offender->get_history().process_type);
+    throw std::runtime_error("Non-finite values in particle data!");
+  }
+  /* The potential lattices feed back into the momenta of all particles, so
+   * a non-finite node would corrupt the whole ensemble in the next timestep
+   * even while all particles are still valid. */
+  for (const DensityLattice *lat : {jmu_B_lat_.get(), jmu_I3_lat_.get()}) {
+    if (lat) {
+      for (const DensityOnLattice &node : *lat) {
+        if (!all_components_finite(node.jmu_net())) {
+          throw std::runtime_error("Non-finite values in density lattice!");
+        }
+      }
+    }
+  }
+  for (const RectangularLattice<FourVector> *lat :
+       {UB_lat_.get(), UI3_lat_.get()}) {
+    if (lat) {
+      for (const FourVector &node : *lat) {
+        if (!all_components_finite(node)) {
+          throw std::runtime_error("Non-finite values in potential lattice!");
+        }
+      }
+    }
+  }
+}
+
+template <typename Modus>
+bool Experiment<Modus>::collisions_still_possible() const {
+  /* A list of pointers suffices for the pair loop; copying the full
+   * ParticleData objects here would be the largest remaining wholesale
+   * copy of the particle list. */
+  std::vector<const ParticleData *> plist;
+  plist.reserve(particles_.size());
+  for (const ParticleData &p : particles_) {
+    if (!p.type().is_stable()) {
+      // Its decay products could scatter again.
+      return true;
+    }
+    plist.push_back(&p);
+  }
+  for (size_t i = 0; i < plist.size(); i++) {
+    for (size_t j = i + 1; j < plist.size(); j++) {
+      const ParticleData &p1 = *plist[i];
+      const ParticleData &p2 = *plist[j];
+      /* Pairs that recede from each other or move in parallel never reach
+       * their point of closest approach. */
+      if (ScatterActionsFinder::collision_time(p1, p2) <= 0.) {
+        continue;
+      }
+      /* The transverse distance in the center-of-momentum frame of the
+       * pair is constant on straight-line trajectories; comparing it with
+       * the upper bound of the interaction distance mirrors the criterion
+       * of the scatter finder (see ScatterAction::transverse_distance_sqr),
+       * just without the time window of one timestep. */
+      ParticleData boosted_a = p1;
+      ParticleData boosted_b = p2;
+      const FourVector mom_sum = p1.momentum() + p2.momentum();
+      const ThreeVector beta_cm = mom_sum.threevec() / mom_sum.x0();
+      boosted_a.boost(beta_cm);
+      boosted_b.boost(beta_cm);
+      const ThreeVector pos_diff =
+          boosted_a.position().threevec() - boosted_b.position().threevec();
+      const ThreeVector mom_diff =
+          boosted_a.momentum().threevec() - boosted_b.momentum().threevec();
+      const double mom_diff_sqr = mom_diff.sqr();
+      double distance_sqr = pos_diff.sqr();
+      if (mom_diff_sqr > really_small) {
+        const double projection = pos_diff * mom_diff;
+        distance_sqr -= projection * projection / mom_diff_sqr;
+      }
+      if (distance_sqr < max_transverse_distance_sqr_) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 template <typename Modus>
 void Experiment<Modus>::run() {
   const auto &mainlog = logger<LogArea::Main>();
-  for (int j = 0; j < nevents_; j++) {
+  /* Sort the outputs by what they receive once; no outputs are added any
+   * more once the run has started. */
+  interaction_outputs_.clear();
+  dilepton_outputs_.clear();
+  for (const auto &output : outputs_) {
+    if (output->is_dilepton_output()) {
+      dilepton_outputs_.push_back(output.get());
+    } else if (!output->is_photon_output()) {
+      interaction_outputs_.push_back(output.get());
+    }
+  }
+  std::unique_ptr<CheckpointState> resume;
+  int first_event = 0;
+  int last_event = nevents_;
+  if (replay_event_ >= 0) {
+    /* The replayed event draws from the same random stream as in the full
+     * run, so skipping its predecessors does not change its physics. */
+    first_event = replay_event_;
+    last_event = replay_event_ + 1;
+    mainlog.info() << "Replaying only event " << replay_event_;
+  }
+  if (!resume_file_.empty()) {
+    resume = make_unique<CheckpointState>(read_checkpoint(resume_file_));
+    first_event = resume->event_number;
+    mainlog.info() << "Resuming event " << first_event << " from checkpoint "
+                   << resume_file_.string();
+  }
+  for (int j = first_event; j < last_event; j++) {
+    AsyncLogSink::set_event(j);
     mainlog.info() << "Event " << j;
+    const SystemTimePoint event_start = SystemClock::now();
+
+    /* Reclaim the event-scoped arena memory of the previous event. No
+     * arena-backed object is alive between events and the worker threads
+     * are idle, so this is the one safe point to rewind. The cached grid
+     * holds arena-backed storage, so it has to go first (its binning
+     * refers to the previous event anyway). */
+    cached_grid_.reset();
+    EventArena::reset();
 
     // Sample initial particles, start clock, some printout and book-keeping
-    initialize_new_event();
+    initialize_new_event(j);
     /* In the ColliderModus, if the first collisions within the same nucleus are
      * forbidden, 'nucleon_has_interacted_', which records whether a nucleon has
      * collided with another nucleon, is initialized equal to false. If allowed,
@@ -1797,40 +4214,126 @@ void Experiment<Modus>::run() {
      * therefore collide with each other later on since these collisions are not
      * "first" to them. */
     if (modus_.is_collider()) {
+      // one entry per initial nucleon of every parallel ensemble
+      const int n_nucleons =
+          parameters_.n_ensembles * modus_.total_N_number();
       if (!modus_.cll_in_nucleus()) {
-        nucleon_has_interacted_.assign(modus_.total_N_number(), false);
+        nucleon_has_interacted_.assign(n_nucleons, false);
       } else {
-        nucleon_has_interacted_.assign(modus_.total_N_number(), true);
+        nucleon_has_interacted_.assign(n_nucleons, true);
+      }
+      /* Arm the spectator fast path: freezing may start once the nuclei
+       * have passed through each other. */
+      spectator_suppression_ = modus_.spectator_suppression();
+      if (spectator_suppression_) {
+        spectator_freeze_time_ =
+            parameters_.labclock.current_time() + modus_.nuclei_passing_time();
       }
     }
     /* In the ColliderModus, if Fermi motion is frozen, assign the beam momenta
      * to the nucleons in both the projectile and the target. */
     if (modus_.is_collider() && modus_.fermi_motion() == FermiMotion::Frozen) {
-      for (int i = 0; i < modus_.total_N_number(); i++) {
-        const auto mass_beam = particles_.copy_to_vector()[i].effective_mass();
-        const auto v_beam = i < modus_.proj_N_number()
-                                ? modus_.velocity_projectile()
-                                : modus_.velocity_target();
+      /* The nucleons are the first total_N_number() entries per ensemble
+       * of the freshly initialized particle list, in insertion order (the
+       * projectile first within each ensemble block). Iterating directly
+       * avoids copying the full particle list for every nucleon. */
+      int i = 0;
+      for (const ParticleData &particle : particles_) {
+        if (i == parameters_.n_ensembles * modus_.total_N_number()) {
+          break;
+        }
+        const auto mass_beam = particle.effective_mass();
+        const auto v_beam =
+            i % modus_.total_N_number() < modus_.proj_N_number()
+                ? modus_.velocity_projectile()
+                : modus_.velocity_target();
         const auto gamma = 1.0 / std::sqrt(1.0 - v_beam * v_beam);
         beam_momentum_.emplace_back(FourVector(gamma * mass_beam, 0.0, 0.0,
                                                gamma * v_beam * mass_beam));
+        i++;
       }
     }
 
+    /* Overwrite the freshly initialized state with the checkpointed one; the
+     * evolution then continues at the saved timestep. */
+    if (resume) {
+      restore_checkpoint(*resume);
+      resume.reset();
+    }
+
+    /* Wait for the asynchronous output of the previous event before writing
+     * anything of this one, so the files stay in event order. */
+    if (previous_event_output_.valid()) {
+      previous_event_output_.get();
+    }
+
     // Output at event start
     for (const auto &output : outputs_) {
+      TraceRecorder::Span trace_output_span(output->name().c_str());
       output->at_eventstart(particles_, j);
     }
 
     run_time_evolution();
 
-    if (force_decays_) {
-      do_final_decays();
+    if (event_aborted_) {
+      /* The event failed the trigger: discard it without final decays and
+       * without the end-of-event output. */
+      events_aborted_++;
+    } else {
+      if (force_decays_) {
+        do_final_decays();
+      }
+
+      // Output at event end
+      final_output(j);
+    }
+
+    MemoryStats::report_event(j);
+
+    if (performance_digest_) {
+      const double seconds =
+          std::chrono::duration<double>(SystemClock::now() - event_start)
+              .count();
+      event_wall_times_.push_back(seconds);
+      std::vector<double> sorted = event_wall_times_;
+      std::sort(sorted.begin(), sorted.end());
+      const std::size_t n = sorted.size();
+      const uint64_t actions = interactions_total_ - wall_actions_total_;
+      /* One parseable line per event, flushed immediately so scrapers can
+       * follow the run live. It bypasses the logger on purpose: the digest
+       * is data rather than diagnostics, it has to reach the pipe without
+       * the latency of the asynchronous log sink, and it stays on with
+       * \key Quiet set. */
+      std::cout << "perf: event " << j << " time " << seconds << " s, p50 "
+                << sorted[(n - 1) / 2] << " s, p90 "
+                << sorted[(n - 1) * 9 / 10] << " s, max " << sorted[n - 1]
+                << " s, actions " << actions << ", rate "
+                << (seconds > 0. ? actions / seconds : 0.) << " /s"
+                << std::endl;
     }
 
-    // Output at event end
-    final_output(j);
+    status_interactions_ += interactions_total_ - wall_actions_total_;
+    if (status_interval_ > 0 && (j + 1) % status_interval_ == 0) {
+      write_status(j);
+    }
+  }
+  // The output of the last event may still be in flight.
+  if (previous_event_output_.valid()) {
+    previous_event_output_.get();
+  }
+  // Mark the run as finished, unless the last event was already reported.
+  if (status_interval_ > 0 &&
+      (last_event - first_event) % status_interval_ != 0) {
+    write_status(last_event - 1);
+  }
+  if (trigger_time_ >= 0.) {
+    mainlog.info("Trigger aborted ", events_aborted_, " of ", nevents_,
+                 " events.");
   }
+  MemoryStats::report_final();
+  CopyStats::report();
+  RuntimeProfiler::report(run_profile_file_);
+  TraceRecorder::write(trace_file_);
 }
 
 }  // namespace smash
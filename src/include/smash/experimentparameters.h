@@ -30,6 +30,14 @@ struct ExperimentParameters {
   /// Number of test particle
   int testparticles;
 
+  /**
+   * Number of parallel ensembles. Each ensemble is an independent physical
+   * event whose particles only ever collide among themselves, while all
+   * ensembles contribute to one shared mean-field lattice, see
+   * \key Ensembles.
+   */
+  int n_ensembles;
+
   /// Width of gaussian Wigner density of particles
   double gaussian_sigma;
 
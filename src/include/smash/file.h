@@ -11,16 +11,25 @@
 #define SRC_INCLUDE_FILE_H_
 
 #include <cerrno>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
+#ifdef SMASH_USE_ZLIB
+#include <zlib.h>
+#endif
+
 #include "cxx14compat.h"
 #include "forwarddeclarations.h"
+#include "memorystats.h"
 
 namespace smash {
 
@@ -95,6 +104,185 @@ class RenamingFilePtr {
   bf::path filename_unfinished_;
 };
 
+/**
+ * A read-only memory mapping of a whole file.
+ *
+ * The file contents are visible as one contiguous character range without
+ * copying them into userspace buffers first; the kernel faults the pages in
+ * on demand and may drop them again under memory pressure. This is used for
+ * large input files where reading through a stream would either copy the
+ * whole file or stall on every refill of the stream buffer.
+ */
+class MappedFile {
+ public:
+  /// Constructs an empty mapping.
+  MappedFile() = default;
+
+  /**
+   * Maps the file at \p filename read-only.
+   *
+   * \param[in] filename Path to the file to map.
+   * \throws runtime_error if the file cannot be opened or mapped.
+   */
+  explicit MappedFile(const bf::path& filename);
+
+  /// Unmaps the file.
+  ~MappedFile();
+
+  /// Takes over the mapping of \p other, which is left empty.
+  MappedFile(MappedFile&& other);
+  /**
+   * Unmaps the current file and takes over the mapping of \p other, which
+   * is left empty.
+   *
+   * \param[in] other The mapping to take over.
+   * \return This object.
+   */
+  MappedFile& operator=(MappedFile&& other);
+
+  /// A mapping cannot be copied, only moved.
+  MappedFile(const MappedFile&) = delete;
+  /// A mapping cannot be copied, only moved.
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// \return Pointer to the first byte of the file contents.
+  const char* begin() const { return data_; }
+  /// \return Pointer behind the last byte of the file contents.
+  const char* end() const { return data_ + size_; }
+  /// \return The size of the file in bytes.
+  std::size_t size() const { return size_; }
+
+ private:
+  /// The mapped file contents; nullptr for an empty mapping.
+  const char* data_ = nullptr;
+  /// The size of the mapping in bytes.
+  std::size_t size_ = 0;
+};
+
+/**
+ * Writes to a file from a dedicated thread, with double-buffered
+ * serialization.
+ *
+ * The producing thread serializes into an in-memory buffer via \ref append
+ * and continues working, while the writer thread drains the previously
+ * handed-over buffer to disk. This decouples the simulation from filesystem
+ * latency spikes: a slow disk only stalls the producer once both buffers
+ * are in flight. Buffered data is handed to the writer thread by \ref
+ * flush, which is also where the producer waits if the writer has not
+ * caught up yet.
+ *
+ * The class is not thread-safe on the producer side: \ref append and \ref
+ * flush have to be called from one thread at a time.
+ *
+ * The writer can optionally compress the stream into the gzip format, in
+ * which case the compression also runs on the writer thread and stays off
+ * the hot path.
+ */
+class AsyncWriter {
+ public:
+  /**
+   * Construct an `AsyncWriter` and start its writer thread.
+   *
+   * \param[in] file The open file to write to. The caller keeps ownership
+   *                 and has to keep it open until the writer is destroyed.
+   * \param[in] compress Whether to gzip-compress the stream on the writer
+   *                     thread. Requires zlib support to be compiled in.
+   * \throws runtime_error if compression is requested without zlib support.
+   */
+  explicit AsyncWriter(std::FILE* file, bool compress = false);
+
+  /// Hands over remaining data, joins the writer thread.
+  ~AsyncWriter();
+
+  /// The writer owns a running thread and cannot be copied.
+  AsyncWriter(const AsyncWriter&) = delete;
+  /// The writer owns a running thread and cannot be assigned.
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+  /**
+   * Append raw bytes to the current serialization buffer.
+   *
+   * \param[in] data Pointer to the bytes to append.
+   * \param[in] size Number of bytes to append.
+   */
+  void append(const void* data, std::size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    const std::size_t old_capacity = fill_buffer_.capacity();
+    fill_buffer_.insert(fill_buffer_.end(), bytes, bytes + size);
+    if (fill_buffer_.capacity() != old_capacity) {
+      MemoryStats::allocate(MemoryStats::Category::OutputBuffers,
+                            fill_buffer_.capacity() - old_capacity);
+    }
+    if (buffer_limit_ != 0 && fill_buffer_.size() >= buffer_limit_) {
+      flush();
+    }
+  }
+
+  /**
+   * Bound the in-memory serialization buffer.
+   *
+   * Once the fill buffer reaches \p bytes, append() hands it over to the
+   * writer thread right away instead of waiting for the flush at the end
+   * of the event. If the writer has not drained the previous hand-over
+   * yet, the producer blocks until it has, so the memory held by the two
+   * buffers stays bounded no matter how much data an event produces
+   * (backpressure instead of unbounded buffering).
+   *
+   * \param[in] bytes Buffer size at which append() flushes; 0 restores
+   *            the default of flushing only on explicit request.
+   */
+  void limit_buffer(std::size_t bytes) { buffer_limit_ = bytes; }
+
+  /**
+   * Hand the serialization buffer over to the writer thread, which writes
+   * it out and flushes the file, and continue with the second buffer.
+   * Waits only if the writer thread has not drained the previous buffer
+   * yet.
+   */
+  void flush();
+
+ private:
+  /// The loop run by the writer thread.
+  void write_loop();
+
+#ifdef SMASH_USE_ZLIB
+  /**
+   * Compress the drained buffer into the file.
+   *
+   * \param[in] flush_mode zlib flush mode; Z_SYNC_FLUSH completes all
+   *            handed-over data on disk, Z_FINISH writes the gzip trailer.
+   */
+  void deflate_buffer(int flush_mode);
+#endif
+
+  /// The file written to; not owned.
+  std::FILE* file_;
+  /// Whether the stream is gzip-compressed by the writer thread.
+  const bool compress_;
+#ifdef SMASH_USE_ZLIB
+  /// The zlib stream state for compressed output.
+  z_stream stream_;
+  /// Scratch buffer the compressed data is produced into.
+  std::vector<char> compress_buffer_;
+#endif
+  /// Fill-buffer size at which append() flushes; 0 means explicit only.
+  std::size_t buffer_limit_ = 0;
+  /// The buffer the producer currently serializes into.
+  std::vector<char> fill_buffer_;
+  /// The buffer the writer thread drains; swapped with fill_buffer_.
+  std::vector<char> write_buffer_;
+  /// Protects the flags below and the buffer hand-over.
+  std::mutex mutex_;
+  /// Signals both hand-over to the writer and completed draining.
+  std::condition_variable condition_;
+  /// True while write_buffer_ holds data the writer has not written yet.
+  bool has_work_ = false;
+  /// True once the destructor asks the writer thread to exit.
+  bool finished_ = false;
+  /// The writer thread; started last, so it sees initialized members.
+  std::thread thread_;
+};
+
 /**
  * Open a file with given mode.
  *
@@ -17,6 +17,8 @@
 #include <memory>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 #ifdef _LIBCPP_BEGIN_NAMESPACE_STD
 _LIBCPP_BEGIN_NAMESPACE_STD
 #else
@@ -54,6 +56,11 @@ template <typename T>
 using build_unique_ptr_ = std::unique_ptr<T, std::default_delete<T>>;
 template <typename T>
 using build_vector_ = std::vector<T, std::allocator<T>>;
+/* Vector with an inline buffer for N elements. The hot paths of the action
+ * pipeline create many short-lived lists of 1-4 entries (incoming pairs,
+ * final states); with the inline buffer these never touch the heap. */
+template <typename T, std::size_t N>
+using build_small_vector_ = boost::container::small_vector<T, N>;
 
 class Action;
 class ScatterAction;
@@ -68,6 +75,7 @@ class ThreeVector;
 class ModusDefault;
 class OutputInterface;
 class ParticleData;
+class ParticleSlice;
 class Particles;
 class ParticleType;
 class ParticleTypePtr;
@@ -116,6 +124,19 @@ enum class TimeStepMode : char {
   Fixed,
 };
 
+/**
+ * NUMA placement policy of the large allocations (particle storage,
+ * lattices, equation-of-state table), see \ref LargeAlloc.
+ */
+enum class MemoryPolicy : char {
+  /// Leave the placement to the operating system (first touch).
+  Default,
+  /// Spread the pages round-robin over all online NUMA nodes.
+  Interleave,
+  /// Prefer the NUMA node of the allocating thread.
+  Local,
+};
+
 /**
  * Initial condition for a particle in a box.
  *
@@ -218,12 +239,12 @@ enum class ThermalizationAlgorithm {
 /// @cond
 using ActionPtr = build_unique_ptr_<Action>;
 using ScatterActionPtr = build_unique_ptr_<ScatterAction>;
-using ActionList = build_vector_<ActionPtr>;
+using ActionList = build_small_vector_<ActionPtr, 4>;
 
 using OutputPtr = build_unique_ptr_<OutputInterface>;
 using OutputsList = build_vector_<OutputPtr>;
 
-using ParticleList = build_vector_<ParticleData>;
+using ParticleList = build_small_vector_<ParticleData, 4>;
 using ParticleTypeList = build_vector_<ParticleType>;
 using ParticleTypePtrList = build_vector_<ParticleTypePtr>;
 using IsoParticleTypeList = build_vector_<IsoParticleType>;
@@ -281,8 +281,11 @@ class FourVector {
   const_iterator cend() const { return x_.cend(); }
 
  private:
-  /// internal storage of this vector's components
-  std::array<double, 4> x_;
+  /**
+   * internal storage of this vector's components, aligned to 16 bytes so
+   * that the compiler can use aligned vector loads and stores
+   */
+  alignas(16) std::array<double, 4> x_;
 };
 
 // Definitions of previous inline functions
@@ -452,6 +455,59 @@ double inline FourVector::sqr3() const { return this->threevec().sqr(); }
 
 double inline FourVector::abs3() const { return this->threevec().abs(); }
 
+inline FourVector FourVector::LorentzBoost(const ThreeVector &v) const {
+  const double velocity_squared = v.sqr();
+
+  const double gamma =
+      velocity_squared < 1. ? 1. / std::sqrt(1. - velocity_squared) : 0;
+
+  // this is used four times in the Vector:
+  const double xprime_0 = gamma * (this->x0() - this->threevec() * v);
+  // this is the part of the space-like components that is always the same:
+  const double constantpart = gamma / (gamma + 1) * (xprime_0 + this->x0());
+  return FourVector(xprime_0, this->threevec() - v * constantpart);
+}
+
+/**
+ * \ingroup data
+ *
+ * A Lorentz boost with the velocity-dependent factors precomputed.
+ *
+ * FourVector::LorentzBoost() recomputes the gamma factor, including a
+ * square root, for every transformed vector. When many four-vectors are
+ * transformed with the same velocity - e.g. all outgoing particles of an
+ * action between the center-of-mass and the computational frame - this
+ * class pays for the square root only once.
+ */
+class PrecomputedBoost {
+ public:
+  /**
+   * Precompute the boost factors.
+   *
+   * \param[in] v boost 3-velocity
+   */
+  explicit PrecomputedBoost(const ThreeVector &v)
+      : v_(v), gamma_(v.sqr() < 1. ? 1. / std::sqrt(1. - v.sqr()) : 0) {}
+
+  /**
+   * Apply the boost to one four-vector.
+   *
+   * \param[in] x The four-vector to transform.
+   * \return The same result as x.LorentzBoost(v).
+   */
+  FourVector operator()(const FourVector &x) const {
+    const double xprime_0 = gamma_ * (x.x0() - x.threevec() * v_);
+    const double constantpart = gamma_ / (gamma_ + 1) * (xprime_0 + x.x0());
+    return FourVector(xprime_0, x.threevec() - v_ * constantpart);
+  }
+
+ private:
+  /// The boost velocity.
+  ThreeVector v_;
+  /// The gamma factor of the boost velocity.
+  double gamma_;
+};
+
 /**\ingroup logging
  * Writes the four components of the vector to the output stream.
  *
@@ -7,6 +7,7 @@
 #ifndef SRC_INCLUDE_GRANDCAN_THERMALIZER_H_
 #define SRC_INCLUDE_GRANDCAN_THERMALIZER_H_
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -39,7 +40,7 @@ namespace smash {
  *   const double some_smearing_factor = ...;
  *   node.add_particle(particle, some_smearing_factor);
  * }
- * HadronGasEos eos = HadronGasEos(false);
+ * HadronGasEos eos(false);
  * node.compute_rest_frame_quantities(eos);
  *
  * Note that before calling the compute_rest_frame_quantities T, mu, p and e
@@ -76,8 +77,14 @@ class ThermLatticeNode {
    * \iref{Oliinychenko:2015lva}. The advantage of this rest frame
    * transformation is that it conserves energy and momentum, even
    * though the dissipative part of the energy-momentum tensor is neglected.
+   *
+   * \param[in] seed Warm start (T [GeV], mub [GeV], mus [GeV]) for the
+   * equation-of-state solver, typically the converged solution of a
+   * neighboring cell; a zero temperature requests the generic initial
+   * approximation.
    */
-  void compute_rest_frame_quantities(HadronGasEos& eos);
+  void compute_rest_frame_quantities(
+      HadronGasEos& eos, const std::array<double, 3>& seed = {{0., 0., 0.}});
   /**
    * Set all the rest frame quantities to some values, this is useful
    * for testing.
@@ -253,6 +260,26 @@ class GrandCanThermalizer {
   void update_thermalizer_lattice(const Particles& particles,
                                   const DensityParameters& par,
                                   bool ignore_cells_under_threshold = true);
+  /**
+   * Cheap pre-screening of the thermalization region. Bins the particles
+   * into the lattice cells and box-sums an upper bound of the local energy
+   * density; no smearing kernel is evaluated. If no cell can possibly
+   * exceed the critical energy density, the expensive lattice update and
+   * the sampling can be skipped for this timestep. The cells whose bound
+   * does reach the threshold are remembered as a compact candidate list,
+   * and the next \ref thermalize call only inspects those.
+   *
+   * The bound is conservative: the smearing factor of a particle is at
+   * most its Lorentz gamma, and e = T00 - T0i vi of a node is at most
+   * T00 + sum |T0i|, so a cell above the critical energy density is
+   * always among the candidates.
+   *
+   * \param[in] particles The current particle list
+   * \param[in] par Density parameters (smearing range and normalization)
+   * \return whether any cell can exceed the critical energy density
+   */
+  bool regions_to_thermalize_exist(const Particles& particles,
+                                   const DensityParameters& par);
   /// \return 3 vector uniformly sampled from the rectangular cell.
   ThreeVector uniform_in_cell() const;
   /**
@@ -264,6 +291,17 @@ class GrandCanThermalizer {
    */
   void renormalize_momenta(ParticleList& plist,
                            const FourVector required_total_momentum);
+  /**
+   * Precomputes the thermal yields \f$ N_i = n_i V \gamma \f$ of every
+   * species of eos_typelist_ in every cell of the thermalization region,
+   * together with their cumulative sums over cells. The temperature and
+   * chemical potentials of a cell are fixed during one thermalization step,
+   * so computing the densities once here removes the repeated
+   * \see HadronGasEos::partial_density evaluations (a spectral integration
+   * for every resonance species) from the sampling loops, which are rerun
+   * on every rejection of the BF algorithm.
+   */
+  void precompute_thermal_yields();
 
   // Functions for BF-sampling algorithm
 
@@ -312,18 +350,16 @@ class GrandCanThermalizer {
    */
   template <typename F>
   void compute_N_in_cells_mode_algo(F&& condition) {
+    const size_t n_cells = cells_to_sample_.size();
     N_in_cells_.clear();
     N_total_in_cells_ = 0.0;
-    for (auto cell_index : cells_to_sample_) {
-      const ThermLatticeNode cell = (*lat_)[cell_index];
-      const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
+    for (size_t c = 0; c < n_cells; c++) {
       double N_tot = 0.0;
-      for (ParticleTypePtr i : eos_typelist_) {
-        if (condition(i->strangeness(), i->baryon_number(), i->charge())) {
+      for (size_t i = 0; i < N_sorts_; i++) {
+        ParticleTypePtr t = eos_typelist_[i];
+        if (condition(t->strangeness(), t->baryon_number(), t->charge())) {
           // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
-          N_tot += cell_volume_ * gamma *
-                   HadronGasEos::partial_density(*i, cell.T(), cell.mub(),
-                                                 cell.mus());
+          N_tot += N_type_in_cell_[i * n_cells + c];
         }
       }
       N_in_cells_.push_back(N_tot);
@@ -355,21 +391,20 @@ class GrandCanThermalizer {
     const int cell_index = cells_to_sample_[index_only_thermalized];
     const ThermLatticeNode cell = (*lat_)[cell_index];
     const ThreeVector cell_center = lat_->cell_center(cell_index);
-    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
     const double N_in_cell = N_in_cells_[index_only_thermalized];
     // Which sort to sample - probability N_i/N_tot
     r = random::uniform(0.0, N_in_cell);
     double N_sum = 0.0;
     ParticleTypePtr type_to_sample;
-    for (ParticleTypePtr i : eos_typelist_) {
-      if (!condition(i->strangeness(), i->baryon_number(), i->charge())) {
+    const size_t n_cells = cells_to_sample_.size();
+    for (size_t i = 0; i < N_sorts_; i++) {
+      ParticleTypePtr t = eos_typelist_[i];
+      if (!condition(t->strangeness(), t->baryon_number(), t->charge())) {
         continue;
       }
-      N_sum +=
-          cell_volume_ * gamma *
-          HadronGasEos::partial_density(*i, cell.T(), cell.mub(), cell.mus());
+      N_sum += N_type_in_cell_[i * n_cells + index_only_thermalized];
       if (N_sum >= r) {
-        type_to_sample = i;
+        type_to_sample = t;
         break;
       }
     }
@@ -418,9 +453,9 @@ class GrandCanThermalizer {
   /// Get the critical energy density
   double e_crit() const { return e_crit_; }
   /// List of particles to be removed from the simulation
-  ParticleList particles_to_remove() const { return to_remove_; }
+  const ParticleList& particles_to_remove() const { return to_remove_; }
   /// List of newly created particles to be inserted in the simulation
-  ParticleList particles_to_insert() const { return sampled_list_; }
+  const ParticleList& particles_to_insert() const { return sampled_list_; }
 
  private:
   /**
@@ -460,10 +495,32 @@ class GrandCanThermalizer {
   }
   /// Number of particles to be sampled in one cell
   std::vector<double> N_in_cells_;
+  /**
+   * Thermal yield \f$ n_i V \gamma \f$ per species and cell; the entry for
+   * species i in cell c of cells_to_sample_ is at [i * n_cells + c].
+   * Filled by \see precompute_thermal_yields.
+   */
+  std::vector<double> N_type_in_cell_;
+  /**
+   * Cumulative sums of N_type_in_cell_ over cells for each species,
+   * used to binary-search the cell a particle is sampled in.
+   */
+  std::vector<double> N_type_in_cell_cumulative_;
   /// Cells above critical energy density
   std::vector<size_t> cells_to_sample_;
+  /**
+   * Candidate cells from the last \ref regions_to_thermalize_exist call,
+   * in ascending index order
+   */
+  std::vector<size_t> hot_cells_;
+  /// Whether hot_cells_ is up to date for the next \ref thermalize call
+  bool hot_cells_valid_ = false;
+  /// Scratch buffers of the energy-density bound, one value per cell
+  std::vector<double> e_bound_;
+  /// \see e_bound_
+  std::vector<double> e_bound_scratch_;
   /// Hadron gas equation of state
-  HadronGasEos eos_ = HadronGasEos(true);
+  HadronGasEos eos_{true};
   /// The lattice on which the thermodynamic quantities are calculated
   std::unique_ptr<RectangularLattice<ThermLatticeNode>> lat_;
   /// Particles to be removed after this thermalization step
@@ -16,6 +16,7 @@
 #include <utility>
 #include <vector>
 
+#include "eventarena.h"
 #include "forwarddeclarations.h"
 #include "particles.h"
 
@@ -23,9 +24,9 @@ namespace smash {
 
 /// Identifies the mode of the Grid.
 enum class GridOptions : char {
-  /// Without ghost cells
+  /// Without wrap-around of cells at the boundaries
   Normal = 0,
-  /// With ghost cells for periodic boundaries
+  /// With neighbor cells wrapped around for periodic boundaries
   PeriodicBoundaries = 1
 };
 
@@ -52,6 +53,13 @@ class GridBase {
   /// A type to store the sizes
   typedef int SizeType;
 
+  /**
+   * Storage for cell offsets and the build transients. The grid is rebuilt
+   * every timestep, so these come from the event arena instead of the
+   * general-purpose heap.
+   */
+  using SizeVector = std::vector<SizeType, EventArenaAllocator<SizeType>>;
+
  protected:
   /**
    * \return the minimum x,y,z coordinates and the largest dx,dy,dz distances of
@@ -123,12 +131,42 @@ class Grid : public GridBase {
    *                              non-empty cell and adjacent cell combination.
    *                              For a periodic grid, the first argument will
    *                              be adjusted to wrap around the grid.
+   *
+   * The slices passed to the callbacks view storage owned by the grid: the
+   * flat cell array, or, for wrapped neighbor combinations of the periodic
+   * grid, a translated copy of the search cell. They stay valid until the
+   * grid is destroyed or iterate_cells is called again, so the callbacks
+   * may retain them and process the cell combinations later (e.g. on a
+   * thread pool) without copying any particle lists.
    */
   void iterate_cells(
-      const std::function<void(const ParticleList &)> &search_cell_callback,
-      const std::function<void(const ParticleList &, const ParticleList &)>
+      const std::function<void(const ParticleSlice &)> &search_cell_callback,
+      const std::function<void(const ParticleSlice &, const ParticleSlice &)>
           &neighbor_cell_callback) const;
 
+  /**
+   * Refresh the particle copies in the cells from the current particle
+   * data without re-binning.
+   *
+   * The cell assignment of the construction is kept, so the caller has to
+   * guarantee that the \p particles storage holds the same particles in
+   * the same slots as at construction (no insertions, removals or
+   * compactions since) and that no particle can have drifted further than
+   * the safety margin the cells were oversized by.
+   *
+   * \param[in] particles The particle storage the grid was built from.
+   */
+  void refresh(const Particles &particles);
+
+  /**
+   * \return whether the grid may be refreshed with \ref refresh.
+   *
+   * Refreshing is forbidden when a particle was excluded from the grid
+   * because it could not interact yet: its formation may begin during a
+   * reuse window, which would change the grid membership.
+   */
+  bool refreshable() const { return refreshable_; }
+
  private:
   /**
    * \return the one-dimensional cell-index from the 3-dim index \p x, \p y, \p
@@ -144,14 +182,51 @@ class Grid : public GridBase {
     return make_index(idx[0], idx[1], idx[2]);
   }
 
+  /// \return a view on the cell with the given \p index.
+  ParticleSlice cell(SizeType index) const {
+    return {cell_particles_.data() + cell_offsets_[index],
+            cell_particles_.data() + cell_offsets_[index + 1]};
+  }
+
   /// The 3 lengths of the complete grid. Used for periodic boundary wrapping.
   const std::array<double, 3> length_;
 
   /// The number of cells in x, y, and z direction.
   std::array<int, 3> number_of_cells_;
 
-  /// The cell storage.
-  std::vector<ParticleList> cells_;
+  /**
+   * The cell storage: all particles on the grid in one flat array, ordered
+   * by cell index (a counting sort places them on construction). This avoids
+   * one heap allocation per cell.
+   */
+  ParticleList cell_particles_;
+
+  /**
+   * Translated copies of boundary search cells, one per cell and wrap
+   * vector that actually occurs, made by the periodic iterate_cells for
+   * the wrapped neighbor combinations. They are kept until the next
+   * iteration so that the slices handed to the callbacks remain valid
+   * (growing the outer vector moves the inner lists, but not their
+   * heap storage the slices point into).
+   */
+  mutable std::vector<ParticleList> wrapped_search_cells_;
+
+  /**
+   * Start offsets of the cells in cell_particles_. The particles of cell \c
+   * i occupy the range [cell_offsets_[i], cell_offsets_[i + 1]).
+   * cell_offsets_ therefore has one entry more than there are cells.
+   */
+  SizeVector cell_offsets_;
+
+  /**
+   * Storage indexes of the binned particles in cell order, recorded so
+   * that \ref refresh can re-copy the current particle data into
+   * cell_particles_ without re-binning.
+   */
+  std::vector<unsigned> sorted_indices_;
+
+  /// Whether the grid may be refreshed, see \ref refreshable.
+  bool refreshable_ = true;
 };
 
 }  // namespace smash
@@ -14,10 +14,13 @@
 #include <gsl/gsl_vector.h>
 
 #include <array>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "constants.h"
+#include "forwarddeclarations.h"
 #include "particletype.h"
 
 namespace smash {
@@ -51,6 +54,12 @@ class EosTable {
    * (e, nb) = (ie*de, inb*dnb) [GeV/fm^4, GeV/fm^3].
    */
   EosTable(double de, double dnb, size_t n_e, size_t n_b);
+  /// Unmaps the table file, if the table is backed by a file mapping.
+  ~EosTable();
+  /// The table may be backed by a file mapping and cannot be copied.
+  EosTable(const EosTable&) = delete;
+  /// The table may be backed by a file mapping and cannot be copied.
+  EosTable& operator=(const EosTable&) = delete;
   /// Define the data structure for one element of the table.
   struct table_element {
     /// Pressure
@@ -66,6 +75,11 @@ class EosTable {
    * Computes the actual content of the table (for EosTable description see
    * documentation of the constructor).
    *
+   * Besides the text file a binary copy named \c eos_savefile_name + ".bin"
+   * is maintained. If it exists and its header matches the current particle
+   * table, it is mapped into memory read-only instead of being parsed, so
+   * all SMASH processes on a node share one copy of the table.
+   *
    * \param[in] eos equation of state
    * \param[in] eos_savefile_name name of the file to save tabulated equation
    *            of state
@@ -85,8 +99,30 @@ class EosTable {
  private:
   /// proper index in a 1d vector, where the 2d table is stored
   size_t index(size_t ie, size_t inb) const { return ie * n_nb_ + inb; }
+  /**
+   * Map an existing binary table file into memory read-only.
+   *
+   * \param[in] filename name of the binary table file
+   * \param[in] hash hash of the current particle table
+   * \return true if the file exists, its header matches the given hash and
+   *         the table geometry is sane, and mapping succeeded
+   */
+  bool try_map_table(const std::string& filename, uint64_t hash);
+  /**
+   * Atomically save the table to a binary file that try_map_table can map.
+   *
+   * \param[in] filename name of the binary table file
+   * \param[in] hash hash of the current particle table
+   */
+  void save_binary_table(const std::string& filename, uint64_t hash) const;
   /// Storage for the tabulated equation of state
   std::vector<table_element> table_;
+  /// Read access to the table: points to table_ or to a read-only mapping
+  const table_element* table_view_ = nullptr;
+  /// Address of the file mapping, nullptr if the table is not mapped
+  void* map_addr_ = nullptr;
+  /// Size of the file mapping in bytes
+  size_t map_size_ = 0;
   /// Step in energy density
   double de_;
   /// Step in net-baryon density
@@ -320,6 +356,37 @@ class HadronGasEos {
   static double scaled_partial_density(const ParticleType& ptype, double beta,
                                        double mub, double mus);
 
+  /**
+   * Get the tabulation of the scaled thermal integral
+   * \f[ I(\beta) = \int A(m) (m\beta)^2 K_2(m\beta) e^{-m\beta} dm \f]
+   * of an unstable species. The chemical potentials enter the Boltzmann
+   * densities only through the exact factor \f$ e^{\mu/T} \f$, so this
+   * one-dimensional family in the inverse temperature replaces the
+   * on-line spectral integration in the EoS solver, the EoS table
+   * generation and the thermalizer yields. \f$ \log I \f$ is tabulated,
+   * which is nearly linear in \f$ \beta \f$ and therefore interpolates
+   * accurately. The tables are built once on first use and shared.
+   *
+   * \param[in] ptype the unstable hadron sort
+   * \return the tabulation, or nullptr if the species has none
+   */
+  static const Tabulation* resonance_density_table(const ParticleType& ptype);
+
+  /**
+   * Compute energy density, net baryon density and net strangeness density
+   * in one pass over the species, sharing the exponential and Bessel
+   * function of each species between the three sums. This is what every
+   * iteration of the \ref solve_eos root solver evaluates.
+   *
+   * \param[in] T temperature [GeV]
+   * \param[in] mub baryon chemical potential [GeV]
+   * \param[in] mus strangeness chemical potential [GeV]
+   * \return \f$ \{e, n_B, n_S\} \f$
+   *         [GeV/fm\f$^{3}\f$, fm\f$^{-3}\f$, fm\f$^{-3}\f$]
+   */
+  static std::array<double, 3> energy_and_net_densities(double T, double mub,
+                                                        double mus);
+
   /// Interface EoS equations to be solved to gnu library
   static int set_eos_solver_equations(const gsl_vector* x, void* params,
                                       gsl_vector* f);
@@ -342,11 +409,20 @@ class HadronGasEos {
   /// Precision of equation solving
   static constexpr double tolerance_ = 1.e-8;
 
+  /// Lowest inverse temperature of the resonance tables [1/GeV] (T = 2 GeV)
+  static constexpr double res_tab_beta_min_ = 0.5;
+
+  /// Highest inverse temperature of the resonance tables [1/GeV] (T = 20 MeV)
+  static constexpr double res_tab_beta_max_ = 50.0;
+
+  /// Number of intervals of the resonance tables
+  static constexpr int res_tab_intervals_ = 1000;
+
   /// Number of equations in the system of equations to be solved
   static constexpr size_t n_equations_ = 3;
 
   /// EOS Table to be used
-  EosTable eos_table_ = EosTable(1.e-2, 1.e-2, 900, 900);
+  EosTable eos_table_{1.e-2, 1.e-2, 900, 900};
 
   /**
    * Variables used by gnu equation solver. They are stored here to allocate
@@ -359,6 +435,14 @@ class HadronGasEos {
   /// \see x_
   gsl_multiroot_fsolver* solver_;
 
+  /**
+   * Serializes concurrent solve_eos calls on the same instance: the GSL
+   * solver state above is reused between calls. Table lookups via
+   * \ref from_table stay lock-free, so for a tabulated EoS the threaded
+   * lattice update only contends here for the rare off-table cells.
+   */
+  std::mutex solver_mutex_;
+
   /// Create an EoS table or not?
   const bool tabulate_;
 };
@@ -16,6 +16,8 @@
 #include <gsl/gsl_monte_vegas.h>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -102,6 +104,12 @@ class Result : public std::pair<double, double> {
  * Integrator integrate;
  * const auto result = integrate(0.1, 0.9, [](double x) { return x * x; });
  * \endcode
+ *
+ * \note Thread safety: each call scribbles into the workspace owned by the
+ * instance, so a single instance must not be called from several threads
+ * at once. Distinct instances are fully independent; declare the instance
+ * `static thread_local` (as all call sites in SMASH do) to integrate
+ * concurrently, e.g. when tabulations are filled from the thread pool.
  */
 class Integrator {
  public:
@@ -174,6 +182,146 @@ class Integrator {
   const double accuracy_relative_ = 5.0e-4;
 };
 
+/**
+ * A fixed-order Gauss-Legendre integrator with an adaptive fallback.
+ *
+ * In contrast to \ref Integrator this does not subdivide the interval: the
+ * integrand is evaluated at the \p Order nodes of the Gauss-Legendre rule
+ * in one tight loop without any allocation or bookkeeping, which the
+ * compiler can unroll and vectorize. For integrands that are smooth on the
+ * whole interval (like the spectral and width integrands after the
+ * substitutions applied at the call sites) this replaces the few hundred
+ * evaluations of the adaptive algorithm by \p Order of them at the same
+ * accuracy.
+ *
+ * The error is estimated by comparing against the embedded rule of half
+ * the order. If the estimate misses the accuracy the adaptive integrator
+ * would enforce, the call transparently falls back to \ref Integrator, so
+ * choosing this integrator at a call site never loses accuracy — peaked or
+ * singular cases (a narrow resonance inside a wide tabulation range, the
+ * dilepton threshold) just take the slow path for the few points where the
+ * fixed rule is insufficient.
+ *
+ * The nodes and weights are computed once in the constructor by Newton
+ * iteration on the Legendre polynomial.
+ *
+ * Example:
+ * \code
+ * IntegratorGaussLegendre<32> integrate;
+ * const auto result = integrate(0.1, 0.9, [](double x) { return x * x; });
+ * \endcode
+ *
+ * \note Thread safety: the node tables are immutable after construction,
+ * but the embedded adaptive fallback owns a workspace, so the contract is
+ * the same as for \ref Integrator: one instance per thread.
+ *
+ * \tparam Order Number of nodes of the quadrature rule.
+ */
+template <int Order>
+class IntegratorGaussLegendre {
+  static_assert(Order >= 4 && Order % 2 == 0,
+                "the embedded error estimate needs an even order ≥ 4");
+
+ public:
+  /// Construct the integrator, tabulating the nodes of both rules.
+  IntegratorGaussLegendre() {
+    compute_nodes(abscissas_.data(), weights_.data(), Order);
+    compute_nodes(abscissas_half_.data(), weights_half_.data(), Order / 2);
+  }
+
+  /**
+   * The function call operator implements the integration functionality.
+   *
+   * \param[in] a The lower limit of the integral.
+   * \param[in] b The upper limit of the integral.
+   * \tparam F Type of the integrand function.
+   * \param[in] fun The callable to integrate over, taking and returning a
+   *            `double` as for \ref Integrator.
+   * \return Pair of integral value and absolute error estimate.
+   */
+  template <typename F>
+  Result operator()(double a, double b, F &&fun) {
+    if (b <= a) {
+      return {0., 0.};
+    }
+    const double center = 0.5 * (b + a);
+    const double half_length = 0.5 * (b - a);
+    double sum = 0.;
+    for (int i = 0; i < Order; i++) {
+      sum += weights_[i] * fun(center + half_length * abscissas_[i]);
+    }
+    double sum_half = 0.;
+    for (int i = 0; i < Order / 2; i++) {
+      sum_half +=
+          weights_half_[i] * fun(center + half_length * abscissas_half_[i]);
+    }
+    const double value = half_length * sum;
+    const double error = std::abs(half_length * (sum - sum_half));
+    if (error >
+        std::max(accuracy_absolute_, std::abs(value) * accuracy_relative_)) {
+      // Not smooth enough for the fixed rule; let the adaptive
+      // algorithm subdivide (and enforce its own error check).
+      return fallback_(a, b, std::forward<F>(fun));
+    }
+    return {value, error};
+  }
+
+ private:
+  /**
+   * Compute the nodes and weights of the \p n-point Gauss-Legendre rule on
+   * [-1, 1] by Newton iteration on the Legendre polynomial \f$P_n\f$,
+   * starting from the Chebyshev approximation of its roots.
+   *
+   * \param[out] x The \p n abscissas, in ascending order.
+   * \param[out] w The corresponding weights.
+   * \param[in] n The order of the rule.
+   */
+  static void compute_nodes(double *x, double *w, int n) {
+    // The rule is symmetric about zero, so only half the roots are needed.
+    for (int i = 0; i < (n + 1) / 2; i++) {
+      double root = std::cos(M_PI * (i + 0.75) / (n + 0.5));
+      double derivative = 0.;
+      double step = 1.;
+      /* The iteration cap only guards against oscillation in the last bit;
+       * a handful of steps reaches machine precision. */
+      for (int iter = 0; std::abs(step) > 1.e-15 && iter < 100; iter++) {
+        /* Evaluate P_n and P_{n-1} at the current guess with the
+         * three-term recurrence. */
+        double p_j = 1.;
+        double p_jm1 = 0.;
+        for (int j = 0; j < n; j++) {
+          const double p_jm2 = p_jm1;
+          p_jm1 = p_j;
+          p_j = ((2 * j + 1) * root * p_jm1 - j * p_jm2) / (j + 1);
+        }
+        derivative = n * (root * p_j - p_jm1) / (root * root - 1.);
+        step = p_j / derivative;
+        root -= step;
+      }
+      x[i] = -root;
+      x[n - 1 - i] = root;
+      w[i] = w[n - 1 - i] = 2. / ((1. - root * root) * derivative * derivative);
+    }
+  }
+
+  /// The abscissas of the full rule on [-1, 1].
+  std::array<double, Order> abscissas_;
+  /// The weights of the full rule.
+  std::array<double, Order> weights_;
+  /// The abscissas of the embedded half-order rule.
+  std::array<double, Order / 2> abscissas_half_;
+  /// The weights of the embedded half-order rule.
+  std::array<double, Order / 2> weights_half_;
+  /// The adaptive integrator taking over when the error estimate is bad.
+  Integrator fallback_;
+
+  /// Desired absolute error limit, as for \ref Integrator.
+  const double accuracy_absolute_ = 1.0e-9;
+
+  /// Desired relative error limit, as for \ref Integrator.
+  const double accuracy_relative_ = 5.0e-4;
+};
+
 /**
  * A C++ interface for numerical integration in one dimension
  * with the GSL Monte-Carlo integration functions.
@@ -184,6 +332,10 @@ class Integrator {
  * const auto result = integrate(0.1, 0.9,
  *                               [](double x) { return x * x; });
  * \endcode
+ *
+ * \note Thread safety: the instance owns the sampler state and its random
+ * number generator, so concurrent calls on one instance are not allowed;
+ * use one (e.g. `static thread_local`) instance per thread.
  */
 class Integrator1dMonte {
  public:
@@ -284,6 +436,10 @@ class Integrator1dMonte {
  * const auto result = integrate(0.1, 0.9, 0., 0.5,
  *                               [](double x, double y) { return x * y; });
  * \endcode
+ *
+ * \note Thread safety: the instance owns the sampler state and its random
+ * number generator, so concurrent calls on one instance are not allowed;
+ * use one (e.g. `static thread_local`) instance per thread.
  */
 class Integrator2d {
  public:
@@ -402,6 +558,11 @@ struct Integrand2d {
  * const auto result = integrate(0.1, 0.9, 0., 0.5,
  *                               [](double x, double y) { return x * y; });
  * \endcode
+ *
+ * \note Thread safety: the instance holds only the accuracy configuration
+ * and no per-call state, so a shared instance may be called concurrently
+ * as long as the Cuba library itself was built thread-safe. The call sites
+ * keep `static thread_local` instances to be independent of that.
  */
 class Integrator2dCuhre {
  public:
@@ -437,7 +598,8 @@ class Integrator2dCuhre {
    * \return Pair of integral value and absolute error estimate.
    */
   template <typename F>
-  Result operator()(double min1, double max1, double min2, double max2, F fun) {
+  Result operator()(double min1, double max1, double min2, double max2,
+                    F fun) const {
     Result result = {0., 0.};
 
     if (max1 < min1 || max2 < min2) {
@@ -474,15 +636,29 @@ class Integrator2dCuhre {
     const int key = -1;  // Use the default.
     const char *statefile = nullptr;
     void *spin = nullptr;
+    /* Per-call diagnostics of the algorithm. These are locals rather than
+     * members so the instance stays free of mutable state; see the
+     * thread-safety notes of this class. */
+    // The actual number of subregions needed.
+    int nregions;
+    // The actual number of integrand evaluations needed.
+    int neval;
+    /* An error flag: 0 if the desired accuracy was reached, -1 if the
+     * dimension is out of range, larger than 0 if the accuracy goal was
+     * not met within the maximum number of evaluations. */
+    int fail;
+    /* The chi^2 probability that the error is not a reliable estimate of
+     * the true integration error. */
+    double prob;
 
     Cuhre(ndim, ncomp, cuhre_fun, userdata, nvec, epsrel_, epsabs_, flags,
-          mineval, maxeval, key, statefile, spin, &nregions_, &neval_, &fail_,
-          &result.first, &result.second, &prob_);
+          mineval, maxeval, key, statefile, spin, &nregions, &neval, &fail,
+          &result.first, &result.second, &prob);
 
-    if (fail_) {
+    if (fail) {
       std::stringstream err;
-      err << "After " << neval_ << " evaluations "
-          << "Cuhre integration from Cuba reports error code " << fail_;
+      err << "After " << neval << " evaluations "
+          << "Cuhre integration from Cuba reports error code " << fail;
       throw std::runtime_error(err.str());
     }
     result.check_error("Cuba integration ", epsrel_, epsabs_);
@@ -497,23 +673,6 @@ class Integrator2dCuhre {
   double epsrel_;
   /// Requested absolute accuracy.
   double epsabs_;
-  /// Actual number of subregions needed.
-  int nregions_;
-  /// Actual number of integrand evaluations needed.
-  int neval_;
-  /**
-   * An error flag.
-   *
-   * 0 if the desired accuracy was reached, -1 if the dimension is out of
-   * range, larger than 0 if the accuracy goal was not met within the maximum
-   * number of evaluations.
-   */
-  int fail_;
-  /**
-   * The chi^2 probability that the error is not a reliable estimate of the
-   * true integration error.
-   */
-  double prob_;
 };
 
 }  // namespace smash
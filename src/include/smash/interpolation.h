@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <numeric>
 #include <sstream>
@@ -86,6 +87,14 @@ class InterpolateDataLinear {
   std::vector<T> x_;
   /// Piecewise linear interpolation using f(x_i)
   std::vector<InterpolateLinear<T>> f_;
+  /**
+   * Whether the x-values are uniformly spaced. Detected once in the
+   * constructor; in that case the interval of a lookup argument follows
+   * directly from (x - x_0) / dx and the binary search is skipped.
+   */
+  bool uniform_ = false;
+  /// Inverse spacing 1/dx of a uniform grid
+  T inv_dx_ = T();
 };
 
 template <typename T>
@@ -174,6 +183,21 @@ InterpolateDataLinear<T>::InterpolateDataLinear(const std::vector<T>& x,
     f_.emplace_back(
         InterpolateLinear<T>(x_[i], y_sorted[i], x_[i + 1], y_sorted[i + 1]));
   }
+  /* Detect a uniform grid: most tabulations in SMASH are equidistant, in
+   * which case each lookup can compute its interval directly instead of
+   * binary-searching it. */
+  if (n > 1) {
+    const T dx = (x_[n - 1] - x_[0]) / static_cast<T>(n - 1);
+    const T tolerance = std::abs(dx) * static_cast<T>(1e-9);
+    uniform_ = dx > T();
+    for (size_t i = 1; uniform_ && i < n; i++) {
+      uniform_ = std::abs(x_[i] - (x_[0] + static_cast<T>(i) * dx)) <=
+                 tolerance;
+    }
+    if (uniform_) {
+      inv_dx_ = 1 / dx;
+    }
+  }
 }
 
 /**
@@ -207,7 +231,14 @@ size_t find_index(const std::vector<T>& v, T x) {
 template <typename T>
 T InterpolateDataLinear<T>::operator()(T x0) const {
   // Find the piecewise linear interpolation corresponding to x0.
-  size_t i = find_index(x_, x0);
+  size_t i;
+  if (uniform_) {
+    // On a uniform grid the interval follows directly from the argument.
+    const T index = (x0 - x_[0]) * inv_dx_;
+    i = index > T() ? static_cast<size_t>(index) : 0;
+  } else {
+    i = find_index(x_, x0);
+  }
   if (i >= f_.size()) {
     // We don't have a linear interpolation beyond the last point in x_.
     // Use the last linear interpolation instead.
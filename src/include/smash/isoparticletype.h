@@ -170,6 +170,30 @@ class IsoParticleType {
    */
   static void create_multiplet(const ParticleType &type);
 
+  /**
+   * Build the spectral-integral tabulations of all resonance multiplets up
+   * front, distributing the independent multiplets over the shared thread
+   * pool. Without a shared pool this does nothing and the tabulations keep
+   * being built lazily on first use.
+   *
+   * Has to be called after the particle types have been created.
+   */
+  static void tabulate_integrals();
+
+  /**
+   * Enable the persistent on-disk cache for the spectral-integral
+   * tabulations. The tables only depend on the particle and decay-mode
+   * descriptions, so once written they can be reused by every later run
+   * with the same input.
+   *
+   * \param dir The cache directory given in the configuration.
+   * \param key A digest of the particle and decay-mode descriptions. The
+   *        tables are stored in a subdirectory of this name, so a changed
+   *        particle content can never pick up stale tables.
+   */
+  static void set_tabulation_cache(const bf::path &dir,
+                                   const std::string &key);
+
   /**
    * Look up the tabulated resonance integral for the XX -> NR cross section.
    *
@@ -249,6 +273,13 @@ class IsoParticleType {
    * \throw ParticleNotFoundFailure if \p name not found.
    */
   static IsoParticleType &find_private(const std::string &name);
+
+  /// Build the tabulation for the NN -> NR cross sections.
+  void tabulate_nr();
+  /// Build the tabulation for the dpi -> d'pi cross sections.
+  void tabulate_pir();
+  /// Build the tabulation for the NK -> RK cross sections.
+  void tabulate_rk();
 };
 
 }  // namespace smash
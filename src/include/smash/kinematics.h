@@ -11,8 +11,11 @@
 #include <array>
 #include <cassert>
 #include <sstream>
+#include <utility>
 
 #include "constants.h"
+#include "fourvector.h"
+#include "threevector.h"
 
 namespace smash {
 
@@ -92,6 +95,29 @@ T pCM_sqr(const T sqrts, const T mass_a, const T mass_b) noexcept {
   return pCM_sqr_from_s(sqrts * sqrts, mass_a, mass_b);
 }
 
+/**
+ * Compute the four-momenta of a two-body final state in its
+ * center-of-momentum frame in one fused computation.
+ *
+ * Only the energy of the first particle takes a square root; the energy of
+ * the second follows from energy conservation. Besides saving the square
+ * root, this makes the total energy of the pair exactly \p sqrts, instead
+ * of reproducing it up to rounding errors.
+ *
+ * \param[in] sqrts sqrt(s) of the process [GeV].
+ * \param[in] mass_a Mass of the first outgoing particle [GeV].
+ * \param[in] momentum Momentum of the first outgoing particle in the
+ *            center-of-momentum frame, usually a direction sampled by the
+ *            angular distribution scaled with \ref pCM [GeV].
+ * \return The four-momenta of the two particles, back to back. [GeV]
+ */
+inline std::pair<FourVector, FourVector> two_body_momenta(
+    double sqrts, double mass_a, const ThreeVector &momentum) {
+  const double energy_a = std::sqrt(mass_a * mass_a + momentum.sqr());
+  return {FourVector(energy_a, momentum),
+          FourVector(sqrts - energy_a, -momentum)};
+}
+
 /**
  * Get the range of Mandelstam-t values allowed in a particular 2->2 process,
  * see PDG 2014 booklet, eq. (46.34).
@@ -0,0 +1,64 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_LARGEALLOC_H_
+#define SRC_INCLUDE_LARGEALLOC_H_
+
+#include <cstddef>
+
+#include "forwarddeclarations.h"
+
+namespace smash {
+
+/**
+ * Allocation utility for the few large, long-lived blocks of a run: the
+ * particle storage, the lattice nodes, and the equation-of-state table.
+ *
+ * Traversals of these blocks dominate the memory traffic of a run. On
+ * Linux, blocks of at least 2 MB are therefore served by anonymous
+ * mappings that are advised to use transparent hugepages (fewer TLB
+ * misses on linear scans) and that can be placed with an explicit NUMA
+ * policy, see \ref MemoryPolicy — on dual-socket nodes the difference
+ * between local and cross-socket accesses in the lattice and particle
+ * traversals is worth double-digit percentages. Small blocks and other
+ * platforms fall back to the general-purpose heap.
+ *
+ * The policy and hugepage requests are advisory: if the kernel rejects
+ * them, the allocation still succeeds with the system defaults.
+ */
+class LargeAlloc {
+ public:
+  /**
+   * Set the NUMA placement policy for subsequent large allocations.
+   *
+   * \param[in] policy The policy to apply, see \ref MemoryPolicy.
+   */
+  static void set_policy(MemoryPolicy policy);
+
+  /**
+   * Allocate \p bytes of zero-initialized memory.
+   *
+   * \param[in] bytes Size of the allocation.
+   * \return Pointer to the allocated memory.
+   * \throw std::bad_alloc if the memory cannot be obtained.
+   */
+  static void *allocate(std::size_t bytes);
+
+  /**
+   * Free memory obtained from allocate().
+   *
+   * \param[in] ptr Pointer returned by allocate().
+   * \param[in] bytes The size that was passed to allocate().
+   */
+  static void deallocate(void *ptr, std::size_t bytes);
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_LARGEALLOC_H_
@@ -10,16 +10,21 @@
 #ifndef SRC_INCLUDE_LATTICE_H_
 #define SRC_INCLUDE_LATTICE_H_
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <functional>
+#include <new>
 #include <utility>
 #include <vector>
 
 #include "forwarddeclarations.h"
 #include "fourvector.h"
+#include "largealloc.h"
 #include "logging.h"
+#include "memorystats.h"
 #include "numerics.h"
+#include "threadpool.h"
 
 namespace smash {
 
@@ -61,18 +66,20 @@ class RectangularLattice {
    * \param[in] per Boolean indicating whether a periodic boundary condition
    *            is applied.
    * \param[in] upd Enum indicating how frequently the lattice is updated.
+   * \param[in] first_touch Whether the node storage may be constructed in
+   *            parallel by the shared thread pool, see allocate_nodes().
+   *            The node values do not depend on this choice.
    */
   RectangularLattice(const std::array<double, 3>& l,
                      const std::array<int, 3>& n,
                      const std::array<double, 3>& orig, bool per,
-                     const LatticeUpdate upd)
+                     const LatticeUpdate upd, const bool first_touch = true)
       : lattice_sizes_(l),
         n_cells_(n),
         cell_sizes_{l[0] / n[0], l[1] / n[1], l[2] / n[2]},
         origin_(orig),
         periodic_(per),
         when_update_(upd) {
-    lattice_.resize(n_cells_[0] * n_cells_[1] * n_cells_[2]);
     const auto& log = logger<LogArea::Lattice>();
     log.debug("Rectangular lattice created: sizes[fm] = (", lattice_sizes_[0],
               ",", lattice_sizes_[1], ",", lattice_sizes_[2], "), dims = (",
@@ -86,10 +93,28 @@ class RectangularLattice {
           "Lattice sizes should be positive, "
           "lattice dimensions should be > 0.");
     }
+    allocate_nodes(first_touch);
   }
 
+  /// Destroys the nodes and frees their storage.
+  ~RectangularLattice() {
+    if (lattice_ != nullptr) {
+      for (std::size_t i = 0; i < lattice_size_; i++) {
+        lattice_[i].~T();
+      }
+      LargeAlloc::deallocate(lattice_, lattice_size_ * sizeof(T));
+      MemoryStats::deallocate(MemoryStats::Category::Lattices,
+                              lattice_size_ * sizeof(T));
+    }
+  }
+
+  /// Lattices own large storage and are never copied.
+  RectangularLattice(const RectangularLattice&) = delete;
+  /// Lattices own large storage and are never copied.
+  RectangularLattice& operator=(const RectangularLattice&) = delete;
+
   /// Sets all values on lattice to zeros.
-  void reset() { std::fill(lattice_.begin(), lattice_.end(), T()); }
+  void reset() { std::fill(begin(), end(), T()); }
 
   /**
    * Checks if 3D index is out of lattice bounds.
@@ -157,23 +182,23 @@ class RectangularLattice {
   LatticeUpdate when_update() const { return when_update_; }
 
   /// Iterator of lattice.
-  using iterator = typename std::vector<T>::iterator;
+  using iterator = T*;
   /// Const interator of lattice.
-  using const_iterator = typename std::vector<T>::const_iterator;
+  using const_iterator = const T*;
   /// \return First element of lattice.
-  iterator begin() { return lattice_.begin(); }
+  iterator begin() { return lattice_; }
   /// \return First element of lattice (const).
-  const_iterator begin() const { return lattice_.begin(); }
+  const_iterator begin() const { return lattice_; }
   /// \return Last element of lattice.
-  iterator end() { return lattice_.end(); }
+  iterator end() { return lattice_ + lattice_size_; }
   /// \return Last element of lattice (const).
-  const_iterator end() const { return lattice_.end(); }
+  const_iterator end() const { return lattice_ + lattice_size_; }
   /// \return ith element of lattice.
   T& operator[](std::size_t i) { return lattice_[i]; }
   /// \return ith element of lattice (const).
   const T& operator[](std::size_t i) const { return lattice_[i]; }
   /// \return Size of lattice.
-  std::size_t size() const { return lattice_.size(); }
+  std::size_t size() const { return lattice_size_; }
 
   /**
    * Take the value of a cell given its 3-D indices.
@@ -219,6 +244,82 @@ class RectangularLattice {
     }
   }
 
+  /**
+   * Finds the 1-dimensional index of the cell containing the given
+   * position, i.e. the cell whose node value_at() reads. For a periodic
+   * lattice the position is wrapped back onto the lattice first.
+   *
+   * \param[in] r Position to locate on the lattice [fm].
+   * \return Index of the containing cell in the underlying node array,
+   *         or -1 if the position is outside a non-periodic lattice.
+   */
+  int cell_index_at(const ThreeVector& r) const {
+    const int ix = std::floor((r.x1() - origin_[0]) / cell_sizes_[0]);
+    const int iy = std::floor((r.x2() - origin_[1]) / cell_sizes_[1]);
+    const int iz = std::floor((r.x3() - origin_[2]) / cell_sizes_[2]);
+    if (out_of_bounds(ix, iy, iz)) {
+      return -1;
+    }
+    return periodic_
+               ? positive_modulo(ix, n_cells_[0]) +
+                     n_cells_[0] *
+                         (positive_modulo(iy, n_cells_[1]) +
+                          n_cells_[1] * positive_modulo(iz, n_cells_[2]))
+               : ix + n_cells_[0] * (iy + n_cells_[1] * iz);
+  }
+
+  /**
+   * Finds the eight nodes surrounding the given position together with
+   * their trilinear interpolation weights. The weights are non-negative
+   * and sum to one, so \f$ \sum_k w_k \cdot \mathrm{node}_k \f$ is the
+   * first-order interpolation of the lattice quantity at \p r. On a
+   * periodic lattice the neighbors wrap around; otherwise positions in
+   * the outer half-cell of a face fall back to the face nodes (two
+   * entries then share an index, which keeps the weight sum intact).
+   *
+   * \param[in] r Position to interpolate at [fm].
+   * \param[out] indices 1-dimensional indices of the eight nodes.
+   * \param[out] weights Interpolation weight of each node.
+   * \return Whether the position is located inside the lattice.
+   */
+  bool interpolation_nodes(const ThreeVector& r,
+                           std::array<std::size_t, 8>& indices,
+                           std::array<double, 8>& weights) const {
+    if (!periodic_ && cell_index_at(r) < 0) {
+      return false;
+    }
+    std::array<int, 3> lower, upper;
+    std::array<double, 3> frac;
+    for (int d = 0; d < 3; d++) {
+      // node centers sit half a cell from the lattice origin
+      const double u = (r[d] - origin_[d]) / cell_sizes_[d] - 0.5;
+      const double base = std::floor(u);
+      frac[d] = u - base;
+      lower[d] = static_cast<int>(base);
+      upper[d] = lower[d] + 1;
+      if (periodic_) {
+        lower[d] = positive_modulo(lower[d], n_cells_[d]);
+        upper[d] = positive_modulo(upper[d], n_cells_[d]);
+      } else {
+        lower[d] = std::max(lower[d], 0);
+        upper[d] = std::min(upper[d], n_cells_[d] - 1);
+      }
+    }
+    for (int c = 0; c < 8; c++) {
+      const int dx = c & 1;
+      const int dy = (c >> 1) & 1;
+      const int dz = c >> 2;
+      indices[c] = static_cast<std::size_t>(
+          (dx ? upper[0] : lower[0]) +
+          n_cells_[0] * ((dy ? upper[1] : lower[1]) +
+                         n_cells_[1] * (dz ? upper[2] : lower[2])));
+      weights[c] = (dx ? frac[0] : 1. - frac[0]) *
+                   (dy ? frac[1] : 1. - frac[1]) *
+                   (dz ? frac[2] : 1. - frac[2]);
+    }
+    return true;
+  }
+
   /**
    * A sub-lattice iterator, which iterates in a 3D-structured manner and
    * calls a function on every cell.
@@ -264,22 +365,62 @@ class RectangularLattice {
   }
 
   /**
-   * Iterates only nodes, whose cell centers lie not further than r_cut in x, y,
-   * z directions from the given point and applies a function to each node.
-   * Useful for adding quantities from one particle to the lattice.
+   * A sub-lattice iterator like \ref iterate_sublattice, but passing the
+   * flat node index instead of the node itself. This allows depositing into
+   * several lattices of identical structure in lockstep: the same index is
+   * valid for all of them.
+   *
+   * \tparam F Type of the function. Arguments are the flat node index and
+   * the 3 integer indices of the cell.
+   * \param[in] lower_bounds Starting numbers for iterating ix, iy, iz.
+   * \param[in] upper_bounds Ending numbers for iterating ix, iy, iz.
+   * \param[in] func Function acting on the cell indices.
+   */
+  template <typename F>
+  void iterate_sublattice_indices(const std::array<int, 3>& lower_bounds,
+                                  const std::array<int, 3>& upper_bounds,
+                                  F&& func) const {
+    if (periodic_) {
+      for (int iz = lower_bounds[2]; iz < upper_bounds[2]; iz++) {
+        const int z_offset = positive_modulo(iz, n_cells_[2]) * n_cells_[1];
+        for (int iy = lower_bounds[1]; iy < upper_bounds[1]; iy++) {
+          const int y_offset =
+              n_cells_[0] * (positive_modulo(iy, n_cells_[1]) + z_offset);
+          for (int ix = lower_bounds[0]; ix < upper_bounds[0]; ix++) {
+            const int index = positive_modulo(ix, n_cells_[0]) + y_offset;
+            func(static_cast<std::size_t>(index), ix, iy, iz);
+          }
+        }
+      }
+    } else {
+      for (int iz = lower_bounds[2]; iz < upper_bounds[2]; iz++) {
+        const int z_offset = iz * n_cells_[1];
+        for (int iy = lower_bounds[1]; iy < upper_bounds[1]; iy++) {
+          const int y_offset = n_cells_[0] * (iy + z_offset);
+          for (int ix = lower_bounds[0]; ix < upper_bounds[0]; ix++) {
+            func(static_cast<std::size_t>(ix + y_offset), ix, iy, iz);
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Computes the index bounds of the cells whose centers lie not further
+   * than r_cut in x, y, z directions from the given point. These are the
+   * cells iterate_in_radius() visits.
    *
-   * \tparam F Type of the function. Arguments are the current node and the 3
-   * integer indices of the cell.
    * \param[in] point Position, usually the position of particle [fm].
    * \param[in] r_cut Maximum distance from the cell center to the
    *            given position. [fm]
-   * \param[in] func Function acting on the cells (such as taking value).
+   * \param[out] l_bounds Lower bounds of the index range.
+   * \param[out] u_bounds Upper bounds of the index range.
+   * \return Whether the index range contains any cells. This is always the
+   *         case for a periodic lattice.
    */
-  template <typename F>
-  void iterate_in_radius(const ThreeVector& point, const double r_cut,
-                         F&& func) {
-    std::array<int, 3> l_bounds, u_bounds;
-
+  bool bounds_in_radius(const ThreeVector& point, const double r_cut,
+                        std::array<int, 3>& l_bounds,
+                        std::array<int, 3>& u_bounds) const {
     /* Array holds value at the cell center: r_center = r_0 + (i+0.5)cell_size,
      * where i is index in any direction. Therefore we want cells with condition
      * (r-r_cut)*csize - 0.5 < i < (r+r_cut)*csize - 0.5, r = r_center - r_0 */
@@ -299,10 +440,32 @@ class RectangularLattice {
           u_bounds[i] = n_cells_[i];
         }
         if (l_bounds[i] > n_cells_[i] || u_bounds[i] < 0) {
-          return;
+          return false;
         }
       }
     }
+    return true;
+  }
+
+  /**
+   * Iterates only nodes, whose cell centers lie not further than r_cut in x, y,
+   * z directions from the given point and applies a function to each node.
+   * Useful for adding quantities from one particle to the lattice.
+   *
+   * \tparam F Type of the function. Arguments are the current node and the 3
+   * integer indices of the cell.
+   * \param[in] point Position, usually the position of particle [fm].
+   * \param[in] r_cut Maximum distance from the cell center to the
+   *            given position. [fm]
+   * \param[in] func Function acting on the cells (such as taking value).
+   */
+  template <typename F>
+  void iterate_in_radius(const ThreeVector& point, const double r_cut,
+                         F&& func) {
+    std::array<int, 3> l_bounds, u_bounds;
+    if (!bounds_in_radius(point, r_cut, l_bounds, u_bounds)) {
+      return;
+    }
     iterate_sublattice(l_bounds, u_bounds, std::forward<F>(func));
   }
 
@@ -333,7 +496,9 @@ class RectangularLattice {
 
  protected:
   /// The lattice itself, array containing physical quantities.
-  std::vector<T> lattice_;
+  T* lattice_ = nullptr;
+  /// Number of nodes in the lattice.
+  std::size_t lattice_size_ = 0;
   /// Lattice sizes in x, y, z directions.
   const std::array<double, 3> lattice_sizes_;
   /// Number of cells in x,y,z directions.
@@ -348,6 +513,50 @@ class RectangularLattice {
   const LatticeUpdate when_update_;
 
  private:
+  /**
+   * Allocates the node storage and default-constructs all nodes.
+   *
+   * Operating systems place a memory page on the NUMA domain of the
+   * thread that touches it first. The nodes of a large lattice are
+   * therefore constructed in parallel over the same z-slab decomposition
+   * that update_lattice() writes with, which spreads the pages over the
+   * domains of the worker threads instead of leaving the whole lattice
+   * on the domain of the main thread. Serial construction is used when
+   * SMASH runs without a thread pool or when \p first_touch is false.
+   *
+   * \param[in] first_touch Whether the shared thread pool, if any, may
+   *            be used for the parallel first touch.
+   */
+  void allocate_nodes(const bool first_touch) {
+    lattice_size_ = n_cells_[0] * n_cells_[1] * n_cells_[2];
+    /* Served by LargeAlloc, so big lattices get hugepages and the
+     * configured NUMA placement. */
+    lattice_ =
+        static_cast<T*>(LargeAlloc::allocate(lattice_size_ * sizeof(T)));
+    MemoryStats::allocate(MemoryStats::Category::Lattices,
+                          lattice_size_ * sizeof(T));
+    ThreadPool* const pool = first_touch ? shared_pool() : nullptr;
+    if (pool == nullptr) {
+      for (std::size_t i = 0; i < lattice_size_; i++) {
+        ::new (lattice_ + i) T();
+      }
+      return;
+    }
+    const int n_z = n_cells_[2];
+    const int num_slabs = std::min(n_z, 4 * pool->num_threads());
+    const int slab_height = (n_z + num_slabs - 1) / num_slabs;
+    const std::size_t nodes_per_z =
+        static_cast<std::size_t>(n_cells_[0]) * n_cells_[1];
+    pool->parallel_range(num_slabs, [&](size_t s) {
+      const int slab_begin = static_cast<int>(s) * slab_height;
+      const int slab_end = std::min(n_z, slab_begin + slab_height);
+      for (std::size_t i = slab_begin * nodes_per_z;
+           i < slab_end * nodes_per_z; i++) {
+        ::new (lattice_ + i) T();
+      }
+    });
+  }
+
   /**
    * Returns division modulo, which is always between 0 and n-1
    * i%n is not suitable, because it returns results from -(n-1) to n-1
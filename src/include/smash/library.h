@@ -0,0 +1,97 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_LIBRARY_H_
+#define SRC_INCLUDE_LIBRARY_H_
+
+#include <string>
+
+#include "configuration.h"
+#include "forwarddeclarations.h"
+
+namespace smash {
+
+/**
+ * The process-wide initialized context for embedding SMASH as a library.
+ *
+ * Building the particle and decay tables, checking their consistency and
+ * tabulating the spectral integrals dominates the startup time, but only
+ * depends on the particle and decay-mode content, not on the run
+ * configuration. A SmashContext performs this initialization exactly once;
+ * afterwards any number of Experiment instances can be created from it with
+ * different configurations and seeds, each paying only its own setup cost.
+ *
+ * The underlying tables are immutable once the context exists, so
+ * experiments created from it may also run concurrently (this is how the
+ * Event_Parallelism mode of the stand-alone binary works).
+ *
+ * Typical use in an embedding service:
+ * \code
+ * const auto &context = SmashContext::initialize(
+ *     particle_string, decay_string, num_threads);
+ * for (const auto &request : requests) {
+ *   auto experiment = context.create_experiment(
+ *       request.config, request.output_path, request.seed);
+ *   experiment->run();
+ * }
+ * \endcode
+ *
+ * In-process access to the simulation data is available by registering a
+ * \ref CallbackOutput with \ref ExperimentBase::add_output before run().
+ */
+class SmashContext {
+ public:
+  /**
+   * Build the context. May be called only once per process, since the
+   * particle and decay tables are process-wide.
+   *
+   * \param[in] particles Content of the particles file.
+   * \param[in] decaymodes Content of the decaymodes file.
+   * \param[in] num_threads Number of worker threads of the shared thread
+   *            pool; for values <= 1 everything runs serially.
+   * \return The initialized context.
+   * \throw std::logic_error if the context was already initialized.
+   * \throw LoadFailure if the particle or decay-mode content is invalid.
+   */
+  static const SmashContext &initialize(const std::string &particles,
+                                        const std::string &decaymodes,
+                                        int num_threads = 1);
+
+  /**
+   * \return The context built by \ref initialize.
+   * \throw std::logic_error if \ref initialize was not called yet.
+   */
+  static const SmashContext &instance();
+
+  /**
+   * Create a new Experiment on top of the context.
+   *
+   * This is \ref ExperimentBase::create plus an optional seed override;
+   * the tables of the context are reused, not rebuilt.
+   *
+   * \param[in] config The configuration of the run; has to contain
+   *            everything a stand-alone run would read from config.yaml.
+   * \param[in] output_path The directory where the output files are
+   *            written.
+   * \param[in] seed Random seed for the run; a negative value keeps the
+   *            Randomseed of \p config.
+   * \return An owning pointer to the Experiment object.
+   */
+  ExperimentPtr create_experiment(Configuration config,
+                                  const bf::path &output_path,
+                                  int64_t seed = -1) const;
+
+ private:
+  /// Contexts are only created by \ref initialize.
+  SmashContext() = default;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_LIBRARY_H_
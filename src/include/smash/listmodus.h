@@ -8,11 +8,14 @@
 #define SRC_INCLUDE_LISTMODUS_H_
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "file.h"
 #include "forwarddeclarations.h"
 #include "modusdefault.h"
 
@@ -151,36 +154,40 @@ class ListModus : public ModusDefault {
   /// File prefix of the particle list
   std::string particle_list_file_prefix_;
 
-  /// File name of current file
-  std::string current_particle_list_file_;
-
   /// shift_id is the start number of file_id_
   const int shift_id_;
 
   /// event_id_ = the unique id of the current event
   int event_id_;
 
-  /// file_id_ is the id of the current file
+  /// file_id_ is the id of the next file to be opened
   int file_id_;
 
+  /// Number of events to skip before the first one that is read
+  int events_to_skip_ = 0;
+
   /// Counter for mass-check warnings to avoid spamming
   int n_warns_precision_ = 0;
   /// Counter for energy-momentum conservation warnings to avoid spamming
   int n_warns_mass_consistency_ = 0;
 
-  /** Check if the file given by filepath has events left after streampos
-   * last_position
-   *
-   * \param[in] filepath Path to file to be checked.
-   * \param[in] last_position Streamposition in file after which check is
-   * performed
-   * \return True if there is at least one event left, false otherwise
-   * \throws runtime_error If file could not be read for whatever reason.
+  /// Memory mapping of the file that is currently being read
+  MappedFile current_file_;
+
+  /// Whether the currently mapped file is in the SMASH binary format
+  bool current_file_is_binary_ = false;
+
+  /// Whether the binary file uses the extended particle line layout
+  bool binary_extended_ = false;
+
+  /**
+   * Byte ranges [begin, end) of the events in the current file, built by
+   * load_or_build_index_().
    */
-  bool file_has_events_(bf::path filepath, std::streampos last_position);
+  std::vector<std::pair<std::size_t, std::size_t>> event_offsets_;
 
-  /// last read position in current file
-  std::streampos last_read_position_;
+  /// Index into event_offsets_ of the next event to be read
+  std::size_t next_event_in_file_ = 0;
 
   /** Return the absolute file path based on given integer. The filename
    * is assumed to have the form (particle_list_prefix)_(file_id)
@@ -192,14 +199,39 @@ class ListModus : public ModusDefault {
    */
   bf::path file_path_(const int file_id);
 
-  /**  Read the next event. Either from the current file if it has more events
-   * or from the next file (with file_id += 1)
+  /** Position next_event_in_file_ on the next unread event, mapping new
+   * files (with file_id_ += 1) as the current one runs out of events and
+   * applying the \key First_Event skip.
+   *
+   * \throws runtime_error If a required file does not exist or could not
+   * be mapped.
+   */
+  void advance_to_next_event_();
+
+  /** Fill event_offsets_ for the currently mapped file, either from the
+   * sidecar index file "(fpath).idx" or by scanning the mapped contents.
+   * Files in the SMASH binary format are detected by their magic number
+   * and indexed by blocks instead of lines.
+   * After a scan the index is saved next to the data file so that later
+   * runs (e.g. event-parallel jobs) can seek directly to their events;
+   * failure to save (read-only directory) is silently ignored.
+   *
+   * \param[in] fpath Path of the currently mapped file.
+   */
+  void load_or_build_index_(const bf::path &fpath);
+
+  /** Fill event_offsets_ by scanning the mapped file as text, with events
+   * delimited by lines containing "end".
+   */
+  void scan_text_file_();
+
+  /** Save event_offsets_ to the sidecar index file. Failure to save (e.g.
+   * in a read-only directory) is silently ignored.
    *
-   * \returns
-   *  One event as string.
-   *  \throws runtime_error If file could not be read for whatever reason.
+   * \param[in] index_path Path of the sidecar index file.
+   * \param[in] checksum Content hash of the indexed file.
    */
-  std::string next_event_();
+  void save_index_(const bf::path &index_path, const uint64_t checksum);
 
   /**\ingroup logging
    * Writes the initial state for the List to the output stream.
@@ -18,11 +18,45 @@
 
 #include "macros.h"
 
+#ifndef SMASH_LOG_LEVEL_MAX
+/** \internal
+ * The compile-time maximum log level; overridden by the MAX_LOG_LEVEL CMake
+ * option. The value must name an einhard::LogLevel enumerator.
+ */
+#define SMASH_LOG_LEVEL_MAX ALL
+#endif
+
 namespace smash {
 
 /// Configuration object to set the verbosity of each area independently.
 class Configuration;
 
+/**
+ * The maximum log level compiled into SMASH.
+ *
+ * Log calls of a more verbose level are eliminated at compile time: their
+ * level check folds to a constant false branch, so the compiler removes
+ * the formatting code and, for inlinable argument expressions without side
+ * effects, the construction of the arguments as well. Building with
+ * \code cmake -DMAX_LOG_LEVEL=INFO \endcode therefore compiles all debug
+ * and trace calls out of the collision loop of a production build. The
+ * runtime verbosity of the \ref input_logging_ "Logging" configuration
+ * section can only lower the level further, never raise it above this one.
+ */
+constexpr einhard::LogLevel maximum_loglevel = einhard::SMASH_LOG_LEVEL_MAX;
+
+/**
+ * The logger type of all log areas, with the compile-time maximum level
+ * applied.
+ *
+ * Messages that pass the compile-time gate are still checked against the
+ * runtime verbosity of their area before anything is formatted: both the
+ * variadic call form and every stream insertion of the `log.debug() <<`
+ * form are guarded inside einhard, so a disabled record never constructs
+ * its text representation.
+ */
+using Logger = einhard::Logger<maximum_loglevel>;
+
 /*!\Userguide
  * \page input_logging_ Logging
  * This section controls the logging levels for different areas of the code.
@@ -57,6 +91,7 @@ class Configuration;
  * \li \key GrandcanThermalizer
  * \li \key CrossSections
  * \li \key Output
+ * \li \key Memory
  *
  * Each key can have one of the following values:
  * \li ALL   - Log all messages (default)
@@ -69,7 +104,24 @@ class Configuration;
  * \li OFF   - If selected no messages will be output
  *
  * Note that the logging levels TRACE and DEBUG are only available in
- * debugging builds (i.e. with -DCMAKE_BUILD_TYPE=Debug). \n
+ * debugging builds (i.e. with -DCMAKE_BUILD_TYPE=Debug). In addition, all
+ * levels more verbose than the compile-time maximum level (CMake option
+ * MAX_LOG_LEVEL, default ALL) are eliminated from the executable entirely
+ * and cannot be enabled here. \n
+ *
+ * Two further keys control how the records are written:
+ *
+ * \key Async (bool, optional, default = false): \n
+ * Write the log records on a background thread instead of the thread that
+ * produced them. The producing thread only formats the record and hands it
+ * to a bounded queue, so a slow log destination (e.g. NFS) cannot stall
+ * the simulation. When the queue is full, further records are dropped and
+ * their number is reported at the end of the run.
+ *
+ * \key Structured (bool, optional, default = false, requires \key Async): \n
+ * Write the records as JSON lines, one object per record with the run id
+ * (the random seed), the current event number and the formatted message,
+ * for consumption by log aggregation instead of humans.
  *
  * \n
  * Example: Configuring the Logging Area
@@ -196,6 +248,7 @@ DECLARE_LOGAREA(24, Pythia);
 DECLARE_LOGAREA(25, GrandcanThermalizer);
 DECLARE_LOGAREA(26, CrossSections);
 DECLARE_LOGAREA(27, Output);
+DECLARE_LOGAREA(28, Memory);
 
 /**
  * This type collects all existing log areas so they will be created with the
@@ -206,7 +259,7 @@ using AreaTuple =
                ParticleType, FindScatter, Clock, DecayModes, Resonances,
                ScatterAction, Distributions, Propagation, Grid, List, Nucleus,
                Density, PauliBlocking, Tmn, Fpe, Lattice, Sampling, Pythia,
-               GrandcanThermalizer, CrossSections, Output>;
+               GrandcanThermalizer, CrossSections, Output, Memory>;
 }  // namespace LogArea
 
 /**
@@ -220,18 +273,18 @@ using AreaTuple =
 void create_all_loggers(Configuration config);
 
 /** \internal
- * \return The einhard::Logger object created for the area with the associated
+ * \return The Logger object created for the area with the associated
  * index \p id.
  */
-einhard::Logger<> &retrieve_logger_impl(int id);
+Logger &retrieve_logger_impl(int id);
 
 /**
- * \return The einhard::Logger object created for the named area (see the
+ * \return The Logger object created for the named area (see the
  * LogArea types).
  * \tparam LogAreaTag Type determining the logging area.
  */
 template <typename LogAreaTag>
-inline einhard::Logger<> &logger() {
+inline Logger &logger() {
   static_assert(LogAreaTag::id < std::tuple_size<LogArea::AreaTuple>::value &&
                     LogAreaTag::id >= 0,
                 "The LogArea::AreaTuple is out of sync with the declared log "
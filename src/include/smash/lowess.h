@@ -21,6 +21,8 @@
 #include <utility>
 #include <vector>
 
+#include "threadpool.h"
+
 namespace smash {
 
 namespace lowess {
@@ -97,6 +99,45 @@ void lowest(const T *x, const T *y, size_t n, T xs, T &ys, size_t nleft,
   }
 }
 
+/**
+ * Fit the output points with indices in [first, last] (1-based, inclusive),
+ * assuming delta == 0, i.e. every point with a distinct abscissa is fitted.
+ * Tie points (equal abscissas) are skipped and have to be filled in from
+ * their anchor point by the caller.
+ *
+ * The fit of a point does not depend on the fit of any other point, and
+ * the sliding window is re-derived from the left, which reaches the same
+ * window the full sequential sweep in lowess() would, so disjoint ranges
+ * can be fitted concurrently with bit-identical results.
+ */
+template <typename T>
+void fit_range(const T *x, const T *y, size_t n, T *ys, size_t ns, bool userw,
+               T *rw, T *w, size_t first, size_t last) {
+  // 1-based views, as in lowess() below
+  const T *x1 = x - 1;
+  const T *y1 = y - 1;
+  T *ys1 = ys - 1;
+
+  size_t nleft = 1;
+  size_t nright = ns;
+  for (size_t i = first; i <= last; i++) {
+    if (i > 1 && x1[i] == x1[i - 1]) {
+      continue;
+    }
+    // move nleft, nright to right if radius decreases
+    while (nright < n && x1[i] - x1[nleft] > x1[nright + 1] - x1[i]) {
+      nleft++;
+      nright++;
+    }
+    // fitted value at x[i]
+    bool ok;
+    lowest(x, y, n, x1[i], ys1[i], nleft, nright, w, userw, rw, ok);
+    if (!ok) {
+      ys1[i] = y1[i];
+    }
+  }
+}
+
 /**
  * Partial sort.
  * based on R function rPsort: adapted to C++ by Christian Stratowa
@@ -156,70 +197,92 @@ void lowess(const T *x, const T *y, size_t n, T *ys, T span, size_t iter,
   // robustness iterations
   size_t iiter = 1;
   while (iiter <= iter + 1) {
-    size_t nleft = 1;
-    size_t nright = ns;
-    size_t last = 0;  // index of prev estimated point
-    size_t i = 1;     // index of current point
+    ThreadPool *const pool = shared_pool();
+    if (delta == 0. && pool != nullptr && n * ns >= (size_t{1} << 20)) {
+      /* With delta == 0 every point with a distinct abscissa is fitted,
+       * so the pass can be distributed over the thread pool; see
+       * fit_range() for why the results stay bit-identical. */
+      const bool iterg1 = iiter > 1;
+      const size_t num_chunks =
+          std::min(n, static_cast<size_t>(pool->num_threads()) * 4);
+      pool->parallel_range(num_chunks, [&](size_t c) {
+        std::vector<T> w(n);
+        fit_range(&x[1], &y[1], n, &ys[1], ns, iterg1, rw, w.data(),
+                  n * c / num_chunks + 1, n * (c + 1) / num_chunks);
+      });
+      // fill the tie points from their anchor point
+      for (size_t i = 2; i <= n; i++) {
+        if (x[i] == x[i - 1]) {
+          ys[i] = ys[i - 1];
+        }
+      }
+    } else {
+      size_t nleft = 1;
+      size_t nright = ns;
+      size_t last = 0;  // index of prev estimated point
+      size_t i = 1;     // index of current point
 
-    for (;;) {
-      if (nright < n) {
-        // move nleft,  nright to right if radius decreases
-        const auto d1 = x[i] - x[nleft];
-        const auto d2 = x[nright + 1] - x[i];
+      for (;;) {
+        if (nright < n) {
+          // move nleft,  nright to right if radius decreases
+          const auto d1 = x[i] - x[nleft];
+          const auto d2 = x[nright + 1] - x[i];
 
-        // if d1 <= d2 with x[nright+1] == x[nright], lowest fixes
-        if (d1 > d2) {
-          // radius will not decrease by move right
-          nleft++;
-          nright++;
-          continue;
+          // if d1 <= d2 with x[nright+1] == x[nright], lowest fixes
+          if (d1 > d2) {
+            // radius will not decrease by move right
+            nleft++;
+            nright++;
+            continue;
+          }
         }
-      }
 
-      // fitted value at x[i]
-      const bool iterg1 = iiter > 1;
-      bool ok;
-      lowest(&x[1], &y[1], n, x[i], ys[i], nleft, nright, res, iterg1, rw, ok);
-      if (!ok)
-        ys[i] = y[i];
+        // fitted value at x[i]
+        const bool iterg1 = iiter > 1;
+        bool ok;
+        lowest(&x[1], &y[1], n, x[i], ys[i], nleft, nright, res, iterg1, rw,
+               ok);
+        if (!ok)
+          ys[i] = y[i];
 
-      // all weights zero copy over value (all rw==0)
-      if (last < i - 1) {
-        const auto denom = x[i] - x[last];
+        // all weights zero copy over value (all rw==0)
+        if (last < i - 1) {
+          const auto denom = x[i] - x[last];
 
-        // skipped points -- interpolate non-zero - proof?
-        for (auto j = last + 1; j < i; j++) {
-          const auto alpha = (x[j] - x[last]) / denom;
-          ys[j] = alpha * ys[i] + (1. - alpha) * ys[last];
+          // skipped points -- interpolate non-zero - proof?
+          for (auto j = last + 1; j < i; j++) {
+            const auto alpha = (x[j] - x[last]) / denom;
+            ys[j] = alpha * ys[i] + (1. - alpha) * ys[last];
+          }
         }
-      }
 
-      // last point actually estimated
-      last = i;
+        // last point actually estimated
+        last = i;
 
-      // x coord of close points
-      const auto cut = x[last] + delta;
-      for (i = last + 1; i <= n; i++) {
-        if (x[i] > cut)
-          break;
-        if (x[i] == x[last]) {
-          ys[i] = ys[last];
-          last = i;
+        // x coord of close points
+        const auto cut = x[last] + delta;
+        for (i = last + 1; i <= n; i++) {
+          if (x[i] > cut)
+            break;
+          if (x[i] == x[last]) {
+            ys[i] = ys[last];
+            last = i;
+          }
         }
+        i = std::max(last + 1, i - 1);
+        if (last >= n)
+          break;
       }
-      i = std::max(last + 1, i - 1);
-      if (last >= n)
-        break;
     }
 
     // residuals
-    for (i = 0; i < n; i++)
+    for (size_t i = 0; i < n; i++)
       res[i] = y[i + 1] - ys[i + 1];
 
     // compute robustness weights except last time
     if (iiter > iter)
       break;
-    for (i = 0; i < n; i++)
+    for (size_t i = 0; i < n; i++)
       rw[i] = std::abs(res[i]);
 
     // compute cmad := 6 * median(rw[], n)
@@ -238,7 +301,7 @@ void lowess(const T *x, const T *y, size_t n, T *ys, T span, size_t iter,
 
     const auto c9 = 0.999 * cmad;
     const auto c1 = 0.001 * cmad;
-    for (i = 0; i < n; i++) {
+    for (size_t i = 0; i < n; i++) {
       if (cmad == 0.) {
         // In this case, `r` cannot really be smaller than `c1` or `c2`, so we
         // would set `rw[i] = 0` anyway. To avoid divisions by zero, we do this
@@ -300,6 +363,85 @@ std::vector<T> smooth(const std::vector<T> &x, const std::vector<T> &y,
   return std::move(result);
 }
 
+/**
+ * Extend a LOWESS fit to data points appended after a previous smooth().
+ *
+ * Only the tail of the table whose smoothing windows can reach the appended
+ * points is refitted, so lazily growing a large table does not redo the
+ * whole fit on every append. The outcome is the same as rerunning smooth()
+ * on the full data; cases where this cannot be guaranteed cheaply fall back
+ * to the full fit:
+ * - robustness iterations (their weights depend on the global median
+ *   residual),
+ * - delta > 0 (the interpolation anchors shift),
+ * - appends that change the window size (it is a fixed fraction of the
+ *   number of points),
+ * - windows so narrow relative to the total x-range that the spread guard
+ *   of the local fit could react to the enlarged range.
+ *
+ * \param x All x-values in ascending order, including the appended ones.
+ * \param y All y-values.
+ * \param[inout] ys Smoothed y-values of the first `ys.size()` points, as
+ *     returned by a previous smooth() or smooth_append() with the same
+ *     parameters; extended in place to the full length.
+ * \param span The smoother span, as for smooth().
+ * \param iter The number of robustifying iterations, as for smooth().
+ * \param delta Merging distance for close x-values, as for smooth().
+ */
+template <typename T>
+void smooth_append(const std::vector<T> &x, const std::vector<T> &y,
+                   std::vector<T> &ys, T span = 2. / 3, size_t iter = 3,
+                   T delta = 0) {
+  assert(x.size() == y.size());
+  assert(ys.size() <= x.size());
+  const size_t n = x.size();
+  const size_t n_old = ys.size();
+  if (n_old == n) {
+    return;
+  }
+  constexpr size_t two = 2;
+  const auto ns =
+      std::max(two, std::min(n, static_cast<size_t>(span * n + 1e-7)));
+  const auto ns_old =
+      std::max(two, std::min(n_old, static_cast<size_t>(span * n_old + 1e-7)));
+  if (iter > 0 || delta != 0 || n_old < ns + 1 || ns != ns_old) {
+    ys = smooth(x, y, span, iter, delta);
+    return;
+  }
+  // 1-based view, as inside lowess::lowess()
+  const T *x1 = x.data() - 1;
+  /* Find the first point whose fit can be changed by the appended data: its
+   * window was clipped at the old boundary, its weight bell reaches the
+   * first appended abscissa, or the window is degenerate enough that the
+   * spread guard in lowess::lowest() could react to the enlarged x-range
+   * (conservatively included). */
+  size_t lo = n_old + 1;
+  size_t nleft = 1;
+  size_t nright = ns;
+  for (size_t i = 1; i <= n_old; i++) {
+    while (nright < n && x1[i] - x1[nleft] > x1[nright + 1] - x1[i]) {
+      nleft++;
+      nright++;
+    }
+    const auto h = std::max(x1[i] - x1[nleft], x1[nright] - x1[i]);
+    if (nright > n_old || x1[i] + 0.999 * h >= x1[n_old + 1] ||
+        x1[nright] - x1[nleft] <= 0.002 * (x1[n] - x1[1])) {
+      lo = i;
+      break;
+    }
+  }
+  ys.resize(n);
+  std::vector<T> w(n);
+  lowess::fit_range(x.data(), y.data(), n, ys.data(), ns, false,
+                    w.data() /* unused */, w.data(), lo, n);
+  // fill the tie points from their anchor point
+  for (size_t i = std::max(lo, two); i <= n; i++) {
+    if (x1[i] == x1[i - 1]) {
+      ys[i - 1] = ys[i - 2];
+    }
+  }
+}
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_LOWESS_H_
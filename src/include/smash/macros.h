@@ -16,6 +16,14 @@
 #define unlikely(x) (x)
 #endif
 
+/* support for gcc data prefetching */
+#ifdef __GNUC__
+#define SMASH_PREFETCH(addr) __builtin_prefetch((addr))
+#else
+/// Prefetch the cache line holding the address (no-op without support).
+#define SMASH_PREFETCH(addr) ((void)(addr))
+#endif
+
 /**
  * Mark as unused, silencing compiler warnings.
  *
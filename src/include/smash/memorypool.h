@@ -0,0 +1,54 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_MEMORYPOOL_H_
+#define SRC_INCLUDE_MEMORYPOOL_H_
+
+#include <cstddef>
+
+namespace smash {
+
+/**
+ * A pool of size-bucketed, thread-local free lists for small objects that
+ * are created and destroyed in large numbers, such as actions and process
+ * branches. Classes opt in by implementing their class-level operator
+ * new/delete on top of \ref allocate and \ref deallocate.
+ *
+ * Allocations are rounded up to a multiple of a cache line and served from
+ * a free list per size bucket. The free lists are thread-local because the
+ * parallel collision search allocates concurrently. The backing chunks are
+ * owned globally, so a block handed out by a worker thread stays valid
+ * however long the object lives; whichever thread eventually frees the
+ * block adopts it into its own free list. Chunks are only released at
+ * program exit.
+ */
+namespace memory_pool {
+
+/**
+ * Get a block of at least \p size bytes from the pool.
+ *
+ * Sizes beyond the largest bucket fall back to the general-purpose heap.
+ *
+ * \param[in] size number of bytes to allocate
+ * \return a block of memory, suitably aligned for any type
+ */
+void *allocate(std::size_t size);
+
+/**
+ * Return a block to the free list of its size bucket, making it available
+ * for the next allocation of similar size.
+ *
+ * \param[in] ptr block previously obtained from allocate, may be nullptr
+ */
+void deallocate(void *ptr);
+
+}  // namespace memory_pool
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_MEMORYPOOL_H_
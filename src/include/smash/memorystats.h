@@ -0,0 +1,82 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_MEMORYSTATS_H_
+#define SRC_INCLUDE_MEMORYSTATS_H_
+
+#include <cstdint>
+
+namespace smash {
+
+/**
+ * Accounts the heap memory held by the large dynamic data structures of a
+ * run and reports the current usage and high-water marks after every event
+ * and at the end of the run.
+ *
+ * When a node runs out of memory it matters which of the big consumers
+ * grew: the particle storage, the queue of pending actions, the density
+ * and potential lattices, or the output serialization buffers. An external
+ * profiler cannot attribute this cheaply enough for production runs, so
+ * the owning classes report their allocations here themselves.
+ *
+ * The accounting is always on. The owning classes only call in when an
+ * allocation actually grows or shrinks, which is rare compared to how
+ * often the memory is used, and each call is a handful of relaxed atomic
+ * operations. Calls may come from any thread.
+ */
+class MemoryStats {
+ public:
+  /// The accounted consumers of heap memory.
+  enum class Category : int {
+    /// The ParticleData storage of the Particles containers.
+    Particles = 0,
+    /// The action queue (the pointer storage, not the actions themselves).
+    Actions = 1,
+    /// The nodes of the RectangularLattice instances.
+    Lattices = 2,
+    /// The serialization buffers of the output classes.
+    OutputBuffers = 3,
+    /// The chunks of the EventArena.
+    EventArena = 4,
+  };
+
+  /**
+   * Record that \p bytes of heap memory were allocated for \p category.
+   *
+   * \param[in] category The consumer the memory belongs to.
+   * \param[in] bytes Size of the allocation.
+   */
+  static void allocate(Category category, std::uint64_t bytes);
+
+  /**
+   * Record that \p bytes of heap memory accounted to \p category were
+   * freed. Every allocate() needs a matching deallocate(), otherwise the
+   * reported current usage drifts.
+   *
+   * \param[in] category The consumer the memory belonged to.
+   * \param[in] bytes Size of the freed allocation.
+   */
+  static void deallocate(Category category, std::uint64_t bytes);
+
+  /**
+   * Log one line with the current usage of every category and its
+   * high-water mark since the previous call, then restart the per-event
+   * marks.
+   *
+   * \param[in] event_number Number of the event that just finished.
+   */
+  static void report_event(int event_number);
+
+  /// Log the high-water marks of the whole run.
+  static void report_final();
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_MEMORYSTATS_H_
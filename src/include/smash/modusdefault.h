@@ -69,6 +69,12 @@ class ModusDefault {
   bool cll_in_nucleus() const { return false; }
   /// \return Checks if modus is collider; overwritten in ColliderModus
   bool is_collider() const { return false; }
+
+  /// \return whether the spectator fast path is enabled (collider-specific)
+  bool spectator_suppression() const { return false; }
+
+  /// \return time until the initial nuclei have passed each other (collider)
+  double nuclei_passing_time() const { return 0.0; }
   /// \return The impact parameter; overwritten in ColliderModus
   double impact_parameter() const { return 0.0; }
   /** \return The beam velocity of the projectile required in the Collider
@@ -83,6 +89,12 @@ class ModusDefault {
   /// \return Maximal timestep accepted by this modus. Negative means infinity.
   double max_timestep(double) const { return -1.; }
 
+  /** \return Estimate of the maximal number of stored particles one event
+   * can reach (test particles included), used to pre-size the particle
+   * storage. Zero means no estimate is available; overwritten in
+   * ColliderModus and BoxModus. */
+  int max_particle_number(int /*ntest*/) const { return 0; }
+
   /// \return Length of the box; overwritten in BoxModus
   double length() const { return -1.; }
 
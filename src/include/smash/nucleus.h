@@ -7,6 +7,7 @@
 #ifndef SRC_INCLUDE_NUCLEUS_H_
 #define SRC_INCLUDE_NUCLEUS_H_
 
+#include <functional>
 #include <map>
 #include <stdexcept>
 #include <vector>
@@ -61,7 +62,7 @@ class Nucleus {
    * \param[in] x the position at which to evaluate the function
    * \return un-normalized Woods-saxon probability
    */
-  double woods_saxon(double x);
+  double woods_saxon(double x) const;
 
   /// Sets the positions of the nucleons inside a nucleus.
   void arrange_nucleons();
@@ -93,6 +94,45 @@ class Nucleus {
    */
   virtual void generate_fermi_momenta();
 
+  /**
+   * Local nucleon number density at a given position, used for the local
+   * Fermi momentum in generate_fermi_momenta(). The default implementation
+   * is the spherical Woods-Saxon profile.
+   *
+   * \param[in] pos Position relative to the center of the nucleus. [fm]
+   * \return Number density of nucleons at \p pos. [fm\f$^{-3}\f$]
+   */
+  virtual double nucleon_density(const ThreeVector &pos) const;
+
+  /**
+   * Pre-sample an ensemble of nucleon configurations for reuse.
+   *
+   * Every configuration holds the positions (and, if requested, the
+   * Fermi momenta) of all nucleons as produced by arrange_nucleons()
+   * and generate_fermi_momenta(). Once an ensemble exists,
+   * draw_from_ensemble() restores a random member with a fresh random
+   * rotation instead of sampling the nucleus from scratch, which makes
+   * the per-event initialization a copy instead of a sampling problem.
+   *
+   * \param[in] n_configurations Number of configurations to sample.
+   * \param[in] with_fermi_motion Whether to also store Fermi momenta.
+   */
+  virtual void sample_initial_ensemble(int n_configurations,
+                                       bool with_fermi_motion);
+
+  /// \return whether an ensemble was sampled with sample_initial_ensemble().
+  bool has_initial_ensemble() const { return !ensemble_.empty(); }
+
+  /**
+   * Set the nucleons to a random member of the pre-sampled ensemble.
+   *
+   * A uniformly random rotation is applied to the positions and momenta
+   * of the stored configuration, so the ensemble stays isotropic even
+   * though each member is reused many times; rotating both together
+   * preserves the density-momentum correlations of the Fermi sea.
+   */
+  void draw_from_ensemble();
+
   /**
    * Boosts the nuclei into the computational frame, such that
    * the nucleons have the appropriate momentum and the
@@ -184,6 +224,41 @@ class Nucleus {
     using std::length_error::length_error;
   };
 
+ protected:
+  /// Number of quantiles stored in the inverse-CDF sampling tables.
+  static constexpr size_t sampling_quantiles_ = 4096;
+
+  /**
+   * Tabulate the inverse CDF of an un-normalized radial density.
+   *
+   * The density is integrated over [0, r_max] with the trapezoidal rule
+   * on a fine grid and the radii at \p n_quantiles equidistant quantiles
+   * are stored, so that drawing from the density afterwards only costs
+   * one uniform random number and a linear interpolation in the table,
+   * see interpolate_inverse_cdf().
+   *
+   * \param[in] density The un-normalized density in the radius.
+   * \param[in] r_max Upper end of the tabulated interval.
+   * \param[in] n_quantiles Number of quantiles to store.
+   * \param[out] norm If non-null, receives the integral of the density
+   *             over [0, r_max].
+   * \return The radii at the equidistant quantiles, n_quantiles + 1
+   *         entries.
+   */
+  static std::vector<double> build_inverse_cdf(
+      const std::function<double(double)> &density, double r_max,
+      size_t n_quantiles, double *norm = nullptr);
+
+  /**
+   * Evaluate an inverse-CDF table at the given quantile.
+   *
+   * \param[in] table A table built by build_inverse_cdf().
+   * \param[in] u The quantile, uniform in [0, 1).
+   * \return The linearly interpolated tabulated value at the quantile.
+   */
+  static double interpolate_inverse_cdf(const std::vector<double> &table,
+                                        double u);
+
  private:
   /**
    * Diffusiveness of Woods-Saxon distribution of this nucleus in fm
@@ -203,6 +278,26 @@ class Nucleus {
   size_t testparticles_ = 1;
   /// Particles associated with this nucleus.
   std::vector<ParticleData> particles_;
+  /**
+   * Inverse CDF of the radial Woods-Saxon profile at equidistant
+   * quantiles. This is a pure cache: it is built lazily on the first
+   * call of distribute_nucleon() and rebuilt whenever the Woods-Saxon
+   * parameters changed in the meantime, hence mutable.
+   */
+  mutable std::vector<double> inverse_cdf_radius_;
+  /// Nuclear radius inverse_cdf_radius_ was built for.
+  mutable double tabulated_nuclear_radius_ = 0.;
+  /// Diffusiveness inverse_cdf_radius_ was built for.
+  mutable double tabulated_diffusiveness_ = 0.;
+  /// One pre-sampled nucleon configuration of the initial-state ensemble.
+  struct EnsembleConfiguration {
+    /// Positions of all nucleons, centered and unboosted.
+    std::vector<ThreeVector> positions;
+    /// Momenta of all nucleons in the nucleus rest frame.
+    std::vector<FourVector> momenta;
+  };
+  /// Pre-sampled configurations, see sample_initial_ensemble().
+  std::vector<EnsembleConfiguration> ensemble_;
 
  public:
   /// For iterators over the particle list:
@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "file.h"
 #include "forwarddeclarations.h"
@@ -65,8 +66,14 @@ class OscarOutput : public OutputInterface {
    *
    * \param[in] path Output path.
    * \param[in] name Name of the ouput.
+   * \param[in] out_par Parameters of the output, in particular the content
+   *            filters of the particles output.
    */
-  OscarOutput(const bf::path &path, const std::string &name);
+  OscarOutput(const bf::path &path, const std::string &name,
+              const OutputParameters &out_par);
+
+  /// Returns the accounted buffer storage, see MemoryStats.
+  ~OscarOutput() override;
 
   /**
    * Writes the initial particle information of an event to the oscar output.
@@ -93,6 +100,11 @@ class OscarOutput : public OutputInterface {
    */
   void at_interaction(const Action &action, const double density) override;
 
+  /// The extended 2013 format prints the full particle history.
+  bool requires_history() const override {
+    return Format == OscarFormat2013Extended;
+  }
+
   /**
    * Writes a prefix line then write out all current particles.
    *
@@ -104,6 +116,21 @@ class OscarOutput : public OutputInterface {
                             const DensityParameters &dens_param) override;
 
  private:
+  /**
+   * Append a printf-style formatted line to the output block buffer.
+   *
+   * The formatting uses vsnprintf, so the produced bytes are identical to
+   * what fprintf would have written; batching them into one buffer saves
+   * the per-line stream locking and lets the block go out with a single
+   * fwrite in \ref flush_buffer.
+   *
+   * \param[in] format The printf-style format string.
+   */
+  void append(const char *format, ...);
+
+  /// Write the buffered output block to the file with a single fwrite.
+  void flush_buffer();
+
   /**
    * Write single particle information line to output.
    * \param[in] data Data of particle.
@@ -112,16 +139,37 @@ class OscarOutput : public OutputInterface {
 
   /**
    * Write the particle information of a list of particles to the output.
-   * One line per particle.
+   * One line per particle. Particles rejected by the content filters are
+   * skipped.
    * \param[in] particles List of particles to be written
    */
   void write(const Particles &particles);
 
+  /**
+   * \param[in] particles Current list of particles.
+   * \return the number of particles that pass the content filters and are
+   *         therefore written to the particle block.
+   */
+  size_t count_printed(const Particles &particles) const;
+
   /// Keep track of event number.
   int current_event_ = 0;
 
+  /// Buffer the current output block is formatted into before one fwrite.
+  std::vector<char> buffer_;
+
   /// Full filepath of the output file.
   RenamingFilePtr file_;
+
+  /// Parameters of the output, holding the content filters.
+  const OutputParameters out_par_;
+
+  /**
+   * Whether the content filters apply to the particle blocks of this
+   * output. They are only active for the particles output; the particle
+   * lists written by the collision outputs stay complete.
+   */
+  const bool filtering_;
 };
 
 /**
@@ -11,6 +11,7 @@
 #define SRC_INCLUDE_OUTPUTINTERFACE_H_
 
 #include <string>
+#include <utility>
 
 #include "density.h"
 #include "energymomentumtensor.h"
@@ -40,9 +41,13 @@ class OutputInterface {
    */
   explicit OutputInterface(std::string name)
       : is_dilepton_output_(name == "Dileptons"),
-        is_photon_output_(name == "Photons") {}
+        is_photon_output_(name == "Photons"),
+        output_name_(std::move(name)) {}
   virtual ~OutputInterface() = default;
 
+  /// \return the name the output was constructed with.
+  const std::string &name() const { return output_name_; }
+
   /**
    * Output launched at event start after initialization, when particles are
    * generated but not yet propagated.
@@ -139,6 +144,13 @@ class OutputInterface {
   /// Get, whether this is the photon output?
   bool is_photon_output() const { return is_photon_output_; }
 
+  /**
+   * Get, whether this output reads the particle history
+   * (\ref HistoryData). If no enabled output does, the experiment skips
+   * maintaining the history, see ParticleData::history_enabled_.
+   */
+  virtual bool requires_history() const { return false; }
+
   /**
    * Convert thermodynamic quantities to strings.
    * \param[in] tq Enum value of the thermodynamic quantity.
@@ -185,6 +197,9 @@ class OutputInterface {
 
   /// Is this the photon output?
   const bool is_photon_output_;
+
+  /// The name the output was constructed with.
+  const std::string output_name_;
 };
 
 }  // namespace smash
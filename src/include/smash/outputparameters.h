@@ -7,13 +7,23 @@
 #ifndef SRC_INCLUDE_OUTPUTPARAMETERS_H_
 #define SRC_INCLUDE_OUTPUTPARAMETERS_H_
 
+#include <array>
+#include <cmath>
+#include <limits>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #include "configuration.h"
 #include "density.h"
 #include "forwarddeclarations.h"
 #include "logging.h"
+#include "particledata.h"
+#include "pdgcode.h"
 
 namespace smash {
 
@@ -31,18 +41,49 @@ struct OutputParameters {
         td_tmn_landau(false),
         td_v_landau(false),
         td_smearing(true),
+        td_cadence(1),
+        td_region_min({{-std::numeric_limits<double>::infinity(),
+                        -std::numeric_limits<double>::infinity(),
+                        -std::numeric_limits<double>::infinity()}}),
+        td_region_max({{std::numeric_limits<double>::infinity(),
+                        std::numeric_limits<double>::infinity(),
+                        std::numeric_limits<double>::infinity()}}),
+        td_stride(1),
         part_extended(false),
         part_only_final(true),
+        part_vtk_binary(false),
+        td_vtk_binary(false),
+        part_y_filter({{-std::numeric_limits<double>::infinity(),
+                        std::numeric_limits<double>::infinity()}}),
+        part_pt_filter({{0., std::numeric_limits<double>::infinity()}}),
+        part_filtering(false),
+        part_cadence(1),
         coll_extended(false),
         coll_printstartend(false),
+        coll_sqrts_filter({{0., std::numeric_limits<double>::infinity()}}),
+        coll_elastic_prescale(1),
+        coll_buffer_limit(64),
         dil_extended(false),
-        photons_extended(false) {}
+        photons_extended(false),
+        root_autoflush(0),
+        root_basket_size(0),
+        root_compression("ZLIB"),
+        root_compression_level(-1),
+        root_autosave_frequency(1000),
+        shard_suffix(""),
+        digest_collisions(false),
+        spectra_axes({"pT", "y"}),
+        spectra_bins(50),
+        spectra_pt_max(4.),
+        spectra_y_max(4.) {}
 
   /// Constructor from configuration
   explicit OutputParameters(Configuration&& conf) : OutputParameters() {
     const auto& log = logger<LogArea::Experiment>();
     log.trace(source_location);
 
+    shard_suffix = conf.take({"Shard_Suffix"}, std::string());
+
     if (conf.has_value({"Thermodynamics"})) {
       auto subcon = conf["Thermodynamics"];
       if (subcon.has_value({"Position"})) {
@@ -61,16 +102,92 @@ struct OutputParameters {
                  "Change the density type to avoid output being dropped.");
       }
       td_smearing = subcon.take({"Smearing"}, true);
+      td_vtk_binary = subcon.take({"VTK_Binary"}, false);
+      td_cadence = subcon.take({"Cadence"}, 1);
+      if (td_cadence < 1) {
+        throw std::invalid_argument(
+            "Cadence of the thermodynamic output has to be at least 1.");
+      }
+      if (subcon.has_value({"Region_Min"})) {
+        td_region_min = subcon.take({"Region_Min"});
+      }
+      if (subcon.has_value({"Region_Max"})) {
+        td_region_max = subcon.take({"Region_Max"});
+      }
+      for (int i = 0; i < 3; i++) {
+        if (td_region_min[i] >= td_region_max[i]) {
+          log.warn("Empty region of interest for the thermodynamic output: ",
+                   "no lattice node will be written.");
+        }
+      }
+      td_stride = subcon.take({"Stride"}, 1);
+      if (td_stride < 1) {
+        throw std::invalid_argument(
+            "Stride of the thermodynamic output has to be at least 1.");
+      }
     }
 
     if (conf.has_value({"Particles"})) {
       part_extended = conf.take({"Particles", "Extended"}, false);
       part_only_final = conf.take({"Particles", "Only_Final"}, true);
+      part_vtk_binary = conf.take({"Particles", "VTK_Binary"}, false);
+      if (conf.has_value({"Particles", "PDG_Codes"})) {
+        const std::vector<PdgCode> codes = conf.take({"Particles",
+                                                      "PDG_Codes"});
+        part_pdg_filter.insert(codes.begin(), codes.end());
+      }
+      if (conf.has_value({"Particles", "Rapidity_Window"})) {
+        part_y_filter = conf.take({"Particles", "Rapidity_Window"});
+        if (part_y_filter[0] >= part_y_filter[1]) {
+          log.warn("Empty Rapidity_Window for the particles output: ",
+                   "no particle will be written.");
+        }
+      }
+      if (conf.has_value({"Particles", "PT_Window"})) {
+        part_pt_filter = conf.take({"Particles", "PT_Window"});
+        if (part_pt_filter[0] >= part_pt_filter[1]) {
+          log.warn("Empty PT_Window for the particles output: ",
+                   "no particle will be written.");
+        }
+      }
+      part_filtering =
+          !part_pdg_filter.empty() ||
+          part_y_filter[0] > -std::numeric_limits<double>::infinity() ||
+          part_y_filter[1] < std::numeric_limits<double>::infinity() ||
+          part_pt_filter[0] > 0. ||
+          part_pt_filter[1] < std::numeric_limits<double>::infinity();
+      part_cadence = conf.take({"Particles", "Cadence"}, 1);
+      if (part_cadence < 1) {
+        throw std::invalid_argument(
+            "Cadence of the particles output has to be at least 1.");
+      }
     }
 
     if (conf.has_value({"Collisions"})) {
       coll_extended = conf.take({"Collisions", "Extended"}, false);
       coll_printstartend = conf.take({"Collisions", "Print_Start_End"}, false);
+      if (conf.has_value({"Collisions", "Process_Types"})) {
+        const std::vector<int> types =
+            conf.take({"Collisions", "Process_Types"});
+        coll_process_filter.insert(types.begin(), types.end());
+      }
+      if (conf.has_value({"Collisions", "Sqrts_Window"})) {
+        coll_sqrts_filter = conf.take({"Collisions", "Sqrts_Window"});
+        if (coll_sqrts_filter[0] >= coll_sqrts_filter[1]) {
+          log.warn("Empty Sqrts_Window for the collisions output: ",
+                   "no interaction will be written.");
+        }
+      }
+      coll_elastic_prescale = conf.take({"Collisions", "Elastic_Prescale"}, 1);
+      if (coll_elastic_prescale < 1) {
+        throw std::invalid_argument(
+            "Elastic_Prescale of the collisions output has to be at least 1.");
+      }
+      coll_buffer_limit = conf.take({"Collisions", "Buffer_Limit"}, 64);
+      if (coll_buffer_limit < 0) {
+        throw std::invalid_argument(
+            "Buffer_Limit of the collisions output must not be negative.");
+      }
     }
 
     if (conf.has_value({"Dileptons"})) {
@@ -80,6 +197,50 @@ struct OutputParameters {
     if (conf.has_value({"Photons"})) {
       photons_extended = conf.take({"Photons", "Extended"}, false);
     }
+
+    if (conf.has_value({"Digest"})) {
+      digest_collisions = conf.take({"Digest", "Hash_Collisions"}, false);
+    }
+
+    if (conf.has_value({"Spectra"})) {
+      const std::vector<PdgCode> codes = conf.take({"Spectra", "PDGs"});
+      spectra_pdgs = codes;
+      if (spectra_pdgs.empty()) {
+        throw std::invalid_argument(
+            "PDGs of the spectra output must not be empty.");
+      }
+      if (conf.has_value({"Spectra", "Axes"})) {
+        const std::vector<std::string> axes = conf.take({"Spectra", "Axes"});
+        spectra_axes = axes;
+        if (spectra_axes.empty()) {
+          throw std::invalid_argument(
+              "Axes of the spectra output must not be empty.");
+        }
+      }
+      spectra_bins = conf.take({"Spectra", "Bins"}, 50);
+      if (spectra_bins < 1) {
+        throw std::invalid_argument(
+            "Bins of the spectra output has to be at least 1.");
+      }
+      spectra_pt_max = conf.take({"Spectra", "PT_Max"}, 4.);
+      spectra_y_max = conf.take({"Spectra", "Y_Max"}, 4.);
+      if (spectra_pt_max <= 0. || spectra_y_max <= 0.) {
+        throw std::invalid_argument(
+            "PT_Max and Y_Max of the spectra output have to be positive.");
+      }
+    }
+
+    if (conf.has_value({"Root"})) {
+      auto subcon = conf["Root"];
+      root_autoflush = subcon.take({"Autoflush"}, 0);
+      root_basket_size = subcon.take({"Basket_Size"}, 0);
+      root_compression = subcon.take({"Compression"}, std::string("ZLIB"));
+      root_compression_level = subcon.take({"Compression_Level"}, -1);
+      root_autosave_frequency = subcon.take({"Autosave_Frequency"}, 1000);
+      // The section only holds the keys taken above; remove the empty map,
+      // so it is not mistaken for an output content.
+      conf.take({"Root"});
+    }
   }
 
   /**
@@ -99,6 +260,60 @@ struct OutputParameters {
     }
   }
 
+  /**
+   * Check a particle against the content filters of the particles output.
+   *
+   * \param[in] p Particle to be checked.
+   * \return whether the particle passes all configured filters and is
+   *         therefore written to the particles output.
+   */
+  bool passes_filter(const ParticleData& p) const {
+    if (!part_pdg_filter.empty() &&
+        part_pdg_filter.count(p.pdgcode()) == 0) {
+      return false;
+    }
+    const FourVector mom = p.momentum();
+    const double y = 0.5 * std::log((mom.x0() + mom.x3()) /
+                                    (mom.x0() - mom.x3()));
+    if (y < part_y_filter[0] || y > part_y_filter[1]) {
+      return false;
+    }
+    const double pt = std::sqrt(mom.x1() * mom.x1() + mom.x2() * mom.x2());
+    return pt >= part_pt_filter[0] && pt <= part_pt_filter[1];
+  }
+
+  /**
+   * Compose the path of an output file, inserting the shard suffix (if any)
+   * in front of the first file extension.
+   *
+   * With \key Shard_Suffix set to e.g. "part3", the file "particles.oscar"
+   * becomes "particles.part3.oscar" and is recorded in the per-shard
+   * manifest "shards.part3.manifest" in the output directory. Without a
+   * shard suffix the file name is used unchanged and no manifest is
+   * written.
+   *
+   * \param[in] path Output directory.
+   * \param[in] filename Unsharded name of the output file.
+   * \return Path of the (possibly sharded) output file.
+   */
+  bf::path shard_path(const bf::path& path, const std::string& filename) const {
+    if (shard_suffix.empty()) {
+      return path / filename;
+    }
+    const auto dot = filename.find('.');
+    const std::string sharded =
+        (dot == std::string::npos)
+            ? filename + "." + shard_suffix
+            : filename.substr(0, dot) + "." + shard_suffix +
+                  filename.substr(dot);
+    /* All outputs of one SMASH instance share the suffix, so only this
+     * instance ever appends to its manifest: no locking is needed. */
+    bf::ofstream(path / ("shards." + shard_suffix + ".manifest"),
+                 std::ios_base::app)
+        << sharded << "\n";
+    return path / sharded;
+  }
+
   /// Point, where thermodynamic quantities are calculated
   ThreeVector td_position;
 
@@ -126,23 +341,147 @@ struct OutputParameters {
    */
   bool td_smearing;
 
+  /**
+   * Evaluate and write the thermodynamic quantities only at every this
+   * many-th intermediate output.
+   */
+  int td_cadence;
+
+  /**
+   * Lower corner in fm of the region of interest of the lattice outputs;
+   * nodes below it along any axis are not written.
+   */
+  std::array<double, 3> td_region_min;
+
+  /**
+   * Upper corner in fm of the region of interest of the lattice outputs;
+   * nodes above it along any axis are not written.
+   */
+  std::array<double, 3> td_region_max;
+
+  /**
+   * Downsampling stride of the lattice outputs: blocks of stride^3 nodes
+   * are averaged into one written node.
+   */
+  int td_stride;
+
   /// Extended format for particles output
   bool part_extended;
 
   /// Print only final particles in event
   bool part_only_final;
 
+  /// Use the binary encoding for the VTK particles output
+  bool part_vtk_binary;
+
+  /// Use the binary encoding for the VTK thermodynamics output
+  bool td_vtk_binary;
+
+  /**
+   * If non-empty, only particles of the listed species are written to the
+   * particles output.
+   */
+  std::set<PdgCode> part_pdg_filter;
+
+  /**
+   * Rapidity window [min, max] of the particles output; particles outside
+   * the window are not written.
+   */
+  std::array<double, 2> part_y_filter;
+
+  /**
+   * Transverse-momentum window [min, max] in GeV of the particles output;
+   * particles outside the window are not written.
+   */
+  std::array<double, 2> part_pt_filter;
+
+  /// Whether any content filter of the particles output is active
+  bool part_filtering;
+
+  /// Write the particles output only at every this many-th intermediate output
+  int part_cadence;
+
   /// Extended format for collisions output
   bool coll_extended;
 
   /// Print initial and final particles in event into collision output
   bool coll_printstartend;
 
+  /**
+   * If non-empty, only interactions whose numeric process type (the
+   * process_type field of the output) is contained in the set are written
+   * to the binary collisions output.
+   */
+  std::set<int> coll_process_filter;
+
+  /**
+   * \f$\sqrt{s}\f$ window [min, max] in GeV of the binary collisions
+   * output; interactions outside the window are not written.
+   */
+  std::array<double, 2> coll_sqrts_filter;
+
+  /**
+   * Write only every this many-th elastic scattering to the binary
+   * collisions output; all other process types are always written.
+   */
+  int coll_elastic_prescale;
+
+  /**
+   * Size in MiB at which the serialization buffer of the binary collisions
+   * output is handed to the writer thread within an event; 0 disables the
+   * limit.
+   */
+  int coll_buffer_limit;
+
   /// Extended format for dilepton output
   bool dil_extended;
 
   /// Extended format for photon output
   bool photons_extended;
+
+  /**
+   * AutoFlush setting of the ROOT trees: a positive value flushes the
+   * baskets to disk every that many tree entries, a negative value every
+   * that many bytes; 0 keeps the ROOT default.
+   */
+  int root_autoflush;
+
+  /// Basket size in bytes of the ROOT branches; 0 keeps the ROOT default
+  int root_basket_size;
+
+  /// Compression algorithm of the ROOT files ("ZLIB", "LZMA" or "LZ4")
+  std::string root_compression;
+
+  /// Compression level (0-9) of the ROOT files; -1 keeps the ROOT default
+  int root_compression_level;
+
+  /// AutoSave the ROOT trees every this many events
+  int root_autosave_frequency;
+
+  /**
+   * Suffix distinguishing the output files of this SMASH instance from
+   * those of other instances sharing the same output directory; empty if
+   * the output is not sharded.
+   */
+  std::string shard_suffix;
+
+  /// Hash the performed interactions into the digest output as well
+  bool digest_collisions;
+
+  /// Species the spectra output histograms, one set of axes each
+  std::vector<PdgCode> spectra_pdgs;
+
+  /// Axis names ("pT", "y", "mT", "phi") of the spectra output
+  std::vector<std::string> spectra_axes;
+
+  /// Number of bins of every spectra histogram
+  int spectra_bins;
+
+  /// Upper edge in GeV of the pT and mT axes of the spectra output
+  double spectra_pt_max;
+
+  /// The rapidity axis of the spectra output covers [-Y_Max, Y_Max]
+  double spectra_y_max;
 };
 
 }  // namespace smash
@@ -9,6 +9,7 @@
 
 #include <limits>
 
+#include "copystats.h"
 #include "forwarddeclarations.h"
 #include "fourvector.h"
 #include "particletype.h"
@@ -49,7 +50,7 @@ struct HistoryData {
  * Each particle has its momentum, position and other relevant physical
  * data entry.
  */
-class ParticleData {
+class ParticleData : private CopyCounted {
  public:
   /**
    * Create a new particle with the given \p particle_type and optionally a
@@ -131,6 +132,11 @@ class ParticleData {
    * \param[in] plist list of parent particles */
   void set_history(int ncoll, uint32_t pid, ProcessType pt, double time_of_or,
                    const ParticleList &plist);
+  /**
+   * Restore complete history information, e.g. from a checkpoint.
+   * \param[in] history the history struct to restore
+   */
+  void set_history(const HistoryData &history) { history_ = history; }
 
   /**
    * Get the particle's 4-momentum
@@ -144,6 +150,7 @@ class ParticleData {
    */
   void set_4momentum(const FourVector &momentum_vector) {
     momentum_ = momentum_vector;
+    kinematics_cached_ = false;
   }
 
   /**
@@ -154,6 +161,7 @@ class ParticleData {
    */
   void set_4momentum(double mass, const ThreeVector &mom) {
     momentum_ = FourVector(std::sqrt(mass * mass + mom * mom), mom);
+    kinematics_cached_ = false;
   }
 
   /**
@@ -167,6 +175,7 @@ class ParticleData {
   void set_4momentum(double mass, double px, double py, double pz) {
     momentum_ = FourVector(std::sqrt(mass * mass + px * px + py * py + pz * pz),
                            px, py, pz);
+    kinematics_cached_ = false;
   }
   /**
    * Set the momentum of the particle without modifying the energy.
@@ -176,6 +185,7 @@ class ParticleData {
    */
   void set_3momentum(const ThreeVector &mom) {
     momentum_ = FourVector(momentum_.x0(), mom);
+    kinematics_cached_ = false;
   }
 
   /**
@@ -275,11 +285,64 @@ class ParticleData {
     initial_xsec_scaling_factor_ = xsec_scal;
   }
 
+  /**
+   * Mark the particle as fully formed once its formation time has passed.
+   * From then on \ref xsec_scaling_factor only reads the precomputed value
+   * instead of branching on the formation logic, which matters in the
+   * pairwise collision search. The scaling factor of a formed particle is
+   * one at the formation time and at any later time, so completing the
+   * formation does not change any subsequent evaluation.
+   *
+   * \param[in] now The current time. [fm]
+   */
+  void complete_formation(double now) {
+    if (initial_xsec_scaling_factor_ != 1. && formation_time_ <= now) {
+      initial_xsec_scaling_factor_ = 1.;
+    }
+  }
+
+  /// \return whether the particle is a frozen spectator
+  bool frozen() const { return frozen_; }
+
+  /**
+   * Mark or unmark the particle as a frozen spectator. Frozen particles
+   * free-stream like any other particle but are skipped by the
+   * collision-search grid, see the \key Spectator_Suppression option of the
+   * collider modus.
+   *
+   * \param[in] frozen The new value of the flag.
+   */
+  void set_frozen(bool frozen) { frozen_ = frozen; }
+
+  /// \return index of the parallel ensemble the particle belongs to
+  int ensemble() const { return ensemble_; }
+
+  /**
+   * Assign the particle to a parallel ensemble. Particles of different
+   * ensembles never interact, but contribute to the same mean-field
+   * lattice, see the \key Ensembles option.
+   *
+   * \param[in] ensemble The ensemble index.
+   */
+  void set_ensemble(int ensemble) {
+    ensemble_ = static_cast<uint16_t>(ensemble);
+  }
+
   /**
    * Get the velocity 3-vector
+   *
+   * The value is cached: between momentum changes (i.e. between the
+   * collisions of the particle, commonly thousands of timesteps for
+   * spectators) the three divisions are only paid once, while the
+   * propagation, the density smearing and the collision finders all read
+   * the velocity every timestep.
+   *
    * \return 3-velocity of the particle
    */
-  ThreeVector velocity() const { return momentum_.velocity(); }
+  ThreeVector velocity() const {
+    update_kinematic_cache();
+    return velocity_cache_;
+  }
 
   /**
    * Get the inverse of the gamma factor from the current velocity of the
@@ -291,10 +354,14 @@ class ParticleData {
    * \ref velocity, since the \ref velocity function must execute three
    * divisions (for every space component of the momentum vector).
    *
+   * The value is cached together with \ref velocity and reused until the
+   * momentum changes.
+   *
    * \returns inverse gamma factor
    */
   double inverse_gamma() const {
-    return std::sqrt(1. - momentum_.sqr3() / (momentum_.x0() * momentum_.x0()));
+    update_kinematic_cache();
+    return inverse_gamma_cache_;
   }
 
   /**
@@ -314,6 +381,15 @@ class ParticleData {
     set_4momentum(momentum_.LorentzBoost(v));
   }
 
+  /**
+   * Apply a precomputed Lorentz-boost to only the momentum. Preferable
+   * when several particles are boosted with the same velocity.
+   * \param[in] b precomputed boost
+   */
+  void boost_momentum(const PrecomputedBoost &b) {
+    set_4momentum(b(momentum_));
+  }
+
   /**
    * Check whether two particles have the same id
    * \param[in] a particle to compare to
@@ -364,6 +440,18 @@ class ParticleData {
   /// Power with which the cross section scaling factor grows in time.
   static double formation_power_;
 
+  /**
+   * Whether the particle history (\ref HistoryData) is maintained.
+   *
+   * The history is pure bookkeeping: it is read by the extended output
+   * formats, by checkpointing and by the frozen Fermi motion in the
+   * collider modus, but never by the collision dynamics itself. Experiment
+   * disables it when none of these consumers is active, which skips the
+   * parent lookup and the history writes for every outgoing particle of
+   * every action.
+   */
+  static bool history_enabled_;
+
  private:
   friend class Particles;
   /// Default constructor.
@@ -376,12 +464,18 @@ class ParticleData {
    * \param[in] dst particle values are copied to
    */
   void copy_to(ParticleData &dst) const {
-    dst.history_ = history_;
+    if (history_enabled_) {
+      dst.history_ = history_;
+    }
     dst.momentum_ = momentum_;
+    dst.velocity_cache_ = velocity_cache_;
+    dst.inverse_gamma_cache_ = inverse_gamma_cache_;
+    dst.kinematics_cached_ = kinematics_cached_;
     dst.position_ = position_;
     dst.formation_time_ = formation_time_;
     dst.initial_xsec_scaling_factor_ = initial_xsec_scaling_factor_;
     dst.begin_formation_time_ = begin_formation_time_;
+    dst.ensemble_ = ensemble_;
   }
 
   /**
@@ -413,7 +507,7 @@ class ParticleData {
   // this leaves us two Bytes padding to use for "free"
   static_assert(sizeof(ParticleTypePtr) == 2, "");
   // make sure we don't exceed that space
-  static_assert(sizeof(bool) <= 2, "");
+  static_assert(2 * sizeof(bool) <= 2, "");
   /**
    * If \c true, the object is an entry in Particles::data_ and does not hold
    * valid particle data. Specifically iterations over Particles must skip
@@ -424,6 +518,34 @@ class ParticleData {
    */
   bool hole_ = false;
 
+  /**
+   * If \c true, the particle is a frozen spectator: it keeps free-streaming
+   * but is invisible to the collision-search grid until the interacting
+   * particles come back within reach, see \ref Experiment and the \key
+   * Spectator_Suppression option of the collider modus. A pure runtime
+   * flag: it is neither written to outputs nor to checkpoints (restored
+   * particles simply refreeze on the next check).
+   */
+  bool frozen_ = false;
+
+  /**
+   * Index of the parallel ensemble the particle belongs to; 0 unless the
+   * run uses the \key Ensembles option. Kept across actions: outgoing
+   * particles inherit the ensemble of the incoming ones.
+   */
+  uint16_t ensemble_ = 0;
+
+  /**
+   * Generation counter of the Particles slot this object occupies (or was
+   * copied from). The Particles class bumps the stored counter on every
+   * mutation of the slot — insertion, update, removal, compaction — so a
+   * copy is a valid representation of the stored particle exactly if the
+   * counters agree, see \ref Particles::is_valid. The counter of a slot
+   * never decreases, also across reallocations and resets, so a stale
+   * copy can never be revived by slot reuse.
+   */
+  uint32_t generation_ = 0;
+
   /// momenta of the particle: x0, x1, x2, x3 as E, px, py, pz
   FourVector momentum_;
   /// position in space: x0, x1, x2, x3 as t, x, y, z
@@ -441,14 +563,113 @@ class ParticleData {
   double initial_xsec_scaling_factor_ = 1.0;
   /// history information
   HistoryData history_;
+
+  /**
+   * Fill the cached kinematic derivatives of the momentum if they are not
+   * current. The formulas match the previously uncached ones exactly, so
+   * results are bit-identical.
+   */
+  void update_kinematic_cache() const {
+    if (kinematics_cached_) {
+      return;
+    }
+    velocity_cache_ = momentum_.velocity();
+    inverse_gamma_cache_ =
+        std::sqrt(1. - momentum_.sqr3() / (momentum_.x0() * momentum_.x0()));
+    kinematics_cached_ = true;
+  }
+
+  /// Cached 3-velocity, valid while kinematics_cached_ is true.
+  mutable ThreeVector velocity_cache_;
+  /// Cached inverse gamma factor, valid while kinematics_cached_ is true.
+  mutable double inverse_gamma_cache_ = 0.0;
+  /// Whether the cached kinematic derivatives match the current momentum.
+  mutable bool kinematics_cached_ = false;
 };
 
+/**
+ * \ingroup data
+ *
+ * A non-owning view on a contiguous range of ParticleData objects.
+ *
+ * The collision search operates on the cells of the Grid, which keeps all
+ * particles of a time step in one flat array. A ParticleSlice refers to such
+ * a cell without copying it. A full ParticleList converts implicitly, so
+ * functions taking a ParticleSlice can be called with either.
+ *
+ * Like any view, a ParticleSlice is only usable as long as the underlying
+ * storage is neither modified nor destroyed.
+ */
+class ParticleSlice {
+ public:
+  /// Creates an empty slice.
+  ParticleSlice() = default;
+
+  /**
+   * Creates a slice for the range [\p begin, \p end).
+   *
+   * \param[in] begin First particle of the viewed range.
+   * \param[in] end Behind the last particle of the viewed range.
+   */
+  ParticleSlice(const ParticleData *begin, const ParticleData *end)
+      : begin_(begin), end_(end) {}
+
+  /**
+   * Creates a slice viewing all entries of \p list. Intentionally not
+   * explicit, so that existing ParticleList arguments keep working.
+   *
+   * \param[in] list The list to view.
+   */
+  ParticleSlice(const ParticleList &list)  // NOLINT(runtime/explicit)
+      : begin_(list.data()), end_(list.data() + list.size()) {}
+
+  /// \return a pointer to the first particle in the slice.
+  const ParticleData *begin() const { return begin_; }
+  /// \return a pointer behind the last particle in the slice.
+  const ParticleData *end() const { return end_; }
+  /// \return the number of particles in the slice.
+  std::size_t size() const { return end_ - begin_; }
+  /// \return whether the slice is empty.
+  bool empty() const { return begin_ == end_; }
+  /// \return the particle at position \p i in the slice.
+  const ParticleData &operator[](std::size_t i) const { return begin_[i]; }
+
+ private:
+  /// First particle of the viewed range.
+  const ParticleData *begin_ = nullptr;
+  /// Behind the last particle of the viewed range.
+  const ParticleData *end_ = nullptr;
+};
+
+/**
+ * \ingroup data
+ *
+ * Boost the momenta of all particles in the list with the same velocity
+ * in one pass, precomputing the velocity-dependent factors of the boost.
+ *
+ * \param[inout] plist The particles whose momenta are boosted.
+ * \param[in] v boost 3-velocity
+ */
+inline void boost_momenta(ParticleList &plist, const ThreeVector &v) {
+  const PrecomputedBoost boost(v);
+  for (ParticleData &data : plist) {
+    data.boost_momentum(boost);
+  }
+}
+
 /**
  * \ingroup logging
  * Writes the state of the particle to the output stream.
  */
 std::ostream &operator<<(std::ostream &s, const ParticleData &p);
 
+/**
+ * \ingroup logging
+ * Writes a compact overview over the particles in the \p slice argument to
+ * the stream.
+ */
+std::ostream &operator<<(std::ostream &out, const ParticleSlice &slice);
+
 /**
  * \ingroup logging
  * Writes a compact overview over the particles in the \p particle_list argument
@@ -463,14 +684,14 @@ std::ostream &operator<<(std::ostream &out, const ParticleList &particle_list);
  */
 struct PrintParticleListDetailed {
   /// Particle list
-  const ParticleList &list;
+  ParticleSlice list;
 };
 /**
  * \ingroup logging
- * Request the ParticleList to be printed in full detail (i.e. one full
+ * Request the particles to be printed in full detail (i.e. one full
  * ParticleData printout per line).
  */
-inline PrintParticleListDetailed detailed(const ParticleList &list) {
+inline PrintParticleListDetailed detailed(const ParticleSlice &list) {
   return {list};
 }
 
@@ -35,11 +35,23 @@ class Particles {
   /// Creates a new (empty) Particles object.
   Particles();
 
+  /// Returns the accounted storage before it is freed, see MemoryStats.
+  ~Particles();
+
   /// Cannot be copied
   Particles(const Particles &) = delete;
   /// Cannot be copied
   Particles &operator=(const Particles &) = delete;
 
+  /**
+   * Moving is allowed, e.g. to hand the final state of an event over to an
+   * asynchronous output writer. The moved-from object is empty afterwards,
+   * as if it was newly constructed.
+   */
+  Particles(Particles &&other);
+  /// \copydoc Particles(Particles &&)
+  Particles &operator=(Particles &&other);
+
   /// \return a copy of all particles as a std::vector<ParticleData>.
   ParticleList copy_to_vector() const {
     if (dirty_.empty()) {
@@ -67,6 +79,21 @@ class Particles {
    */
   const ParticleData &insert(const ParticleData &p);
 
+  /**
+   * Add the particle to the list keeping its id, e.g. when restoring a
+   * checkpointed particle list. The id counter continues after the highest
+   * inserted id, so ids of particles created later do not clash with the
+   * restored ones.
+   *
+   * \param[in] p The data to be added, carrying a valid unique id. May only
+   * be called on a list without holes, i.e. one on which no particle was
+   * removed since the last reset().
+   *
+   * \return An immutable reference to the new ParticleData object in the
+   * Particles list.
+   */
+  const ParticleData &insert_with_id(const ParticleData &p);
+
   /**
    * Add \p n particles of the same type (\p pdg) to the list.
    *
@@ -108,6 +135,66 @@ class Particles {
    */
   void reset();
 
+  /**
+   * Remove the holes from the internal storage and reorder the particles
+   * by their spatial position (z, then y, then x), matching the cell
+   * iteration order of the grid.
+   *
+   * After many scatterings the slot reuse decorrelates the storage order
+   * from the positions, so every grid-cell traversal becomes a random
+   * access pattern over the array. Re-sorting restores the locality; run
+   * periodically, the O(N log N) cost amortizes over many timesteps.
+   *
+   * All outstanding copies of particles are invalidated (\ref is_valid
+   * returns false for them afterwards), because the reordering changes the
+   * internal indices. Callers must therefore only invoke this between
+   * timesteps, when no found actions or other index-carrying copies are
+   * alive.
+   */
+  void sort_by_position();
+
+  /**
+   * Reserve memory for at least \p capacity particles.
+   *
+   * This avoids the repeated reallocations (each of which copies all
+   * particles and invalidates all pointers into the storage) during the
+   * multiplicity build-up of an event when the peak particle number can be
+   * estimated up front, e.g. from the colliding system and energy.
+   *
+   * \param[in] capacity The number of particles to allocate storage for.
+   *            Does nothing if the current capacity is already sufficient.
+   */
+  void reserve(unsigned capacity);
+
+  /**
+   * Forbid any further reallocation of the particle storage.
+   *
+   * While locked, exceeding the reserved capacity throws a
+   * std::runtime_error that includes the capacity that would have been
+   * needed, instead of silently reallocating. This gives a hard guarantee
+   * that pointers into the storage stay valid for the duration of an
+   * event.
+   */
+  void lock_capacity() { capacity_locked_ = true; }
+
+  /// Allow reallocation of the particle storage again.
+  void unlock_capacity() { capacity_locked_ = false; }
+
+  /**
+   * Scan all particles for non-finite (NaN or infinite) position or momentum
+   * components.
+   *
+   * This is a cheap alternative to the floating-point traps (see
+   * fpenvironment.h) for production runs that have the traps disabled: the
+   * scan touches each particle once with plain additions and one finiteness
+   * check, which the compiler can vectorize.
+   *
+   * \return Pointer to the first particle with a non-finite component, or
+   *         nullptr if all values are finite. The pointer is invalidated by
+   *         any modification of the Particles object.
+   */
+  const ParticleData *find_nonfinite_particle() const;
+
   /**
    * Check whether the ParticleData copy is still a valid copy of the one
    * stored in the Particles object.
@@ -121,13 +208,24 @@ class Particles {
     if (data_size_ <= copy.index_) {
       return false;
     }
-    /* Check if the particles still exists. If it decayed
-     * or scattered inelastically it is gone. */
-    return data_[copy.index_].id() == copy.id()
-           /* If the particle has scattered
-            * elastically, its id_process has
-            * changed and we consider it invalid. */
-           && data_[copy.index_].id_process() == copy.id_process();
+    /* Every mutation of the slot — insertion, update (also elastic),
+     * removal, compaction — bumps its generation counter, so a single
+     * integer compare decides whether the copy still represents the
+     * stored particle. */
+    return data_[copy.index_].generation_ == copy.generation_;
+  }
+
+  /**
+   * Prefetch the stored slot of the given ParticleData copy into the data
+   * caches. This is purely a latency hint for upcoming \ref is_valid or
+   * \ref lookup calls on the same copy; out-of-range copies are ignored.
+   *
+   * \param[in] copy ParticleData copy whose stored slot will be accessed
+   */
+  void prefetch(const ParticleData &copy) const {
+    if (copy.index_ < data_size_) {
+      SMASH_PREFETCH(&data_[copy.index_]);
+    }
   }
 
   /**
@@ -178,6 +276,7 @@ class Particles {
     assert(p.type() == new_state.type());
     ParticleData &original = data_[p.index_];
     new_state.copy_to(original);
+    ++original.generation_;
     return original;
   }
 
@@ -197,6 +296,20 @@ class Particles {
    * \param[in] new_state New states of these particles
    * \param[in] do_replace Whether to replace the old states by the new ones
    */
+  /**
+   * Mark all particles whose formation time has passed as fully formed, so
+   * that their cross-section scaling factor becomes a precomputed value.
+   * Called once per time step; afterwards only the particles still forming
+   * branch on the formation logic in the pairwise collision search.
+   *
+   * \param[in] now The current time. [fm]
+   */
+  void complete_formation(double now) {
+    for (ParticleData &data : *this) {
+      data.complete_formation(now);
+    }
+  }
+
   void update(const ParticleList &old_state, ParticleList &new_state,
               bool do_replace) {
     if (do_replace) {
@@ -224,6 +337,79 @@ class Particles {
     return data_[old_state.index_];
   }
 
+  /**
+   * Structure-of-arrays mirror of the hot subset of the particle data.
+   *
+   * A ParticleData object is a few hundred bytes large, but the inner loops
+   * of the grid construction and the collision search only read the
+   * position, the momentum, and the cross-section scaling factor. Scanning
+   * these contiguous arrays instead of the full objects moves an order of
+   * magnitude less memory through the caches.
+   *
+   * All arrays have one entry per particle, in iteration order (i.e. holes
+   * in the internal storage are skipped). The mirror is a read-only
+   * snapshot: modifications of particles go through the usual Particles
+   * interface and are only picked up by the next call to
+   * \ref update_hot_arrays.
+   */
+  struct HotArrays {
+    /// x coordinates of the particle positions.
+    std::vector<double> x;
+    /// y coordinates of the particle positions.
+    std::vector<double> y;
+    /// z coordinates of the particle positions.
+    std::vector<double> z;
+    /// Energies of the particles.
+    std::vector<double> p0;
+    /// x components of the particle momenta.
+    std::vector<double> px;
+    /// y components of the particle momenta.
+    std::vector<double> py;
+    /// z components of the particle momenta.
+    std::vector<double> pz;
+    /// Cross-section scaling factors, used to filter out spectators.
+    std::vector<double> xsec_scale;
+    /// Non-zero for frozen spectators, which the grid skips as well.
+    std::vector<char> frozen;
+    /**
+     * For entry \c i of the other arrays: the index of the mirrored particle
+     * in the internal storage. It identifies the full ParticleData object
+     * again when a mirrored particle was selected for an interaction.
+     */
+    std::vector<unsigned> index;
+
+    /// \return the number of mirrored particles.
+    std::size_t size() const { return x.size(); }
+  };
+
+  /**
+   * Refresh the structure-of-arrays mirror from the current particle data
+   * with one linear pass over the particles.
+   *
+   * The pass pays off as soon as the caller scans the hot data more than
+   * once before the particles are modified again. The grid construction is
+   * the prime example: it determines the grid dimensions in a first pass
+   * over all positions and sorts the particles into cells in a second one.
+   *
+   * The mirror is only a cache of the authoritative ParticleData storage,
+   * therefore refreshing it does not change the observable state and the
+   * function can be called on a const object.
+   *
+   * \return a reference to the refreshed mirror. It is valid until the
+   *         particles are modified or refreshed again.
+   */
+  const HotArrays &update_hot_arrays() const;
+
+  /**
+   * \return the particle at the given \p index of the internal storage.
+   *
+   * The index must come from \ref HotArrays::index of an up-to-date mirror,
+   * otherwise the entry may be a hole or out of range (this is not checked).
+   * It allows scans to run over the compact arrays and to look up only the
+   * selected particles in full.
+   */
+  const ParticleData &at_index(unsigned index) const { return data_[index]; }
+
   /**
    * \internal
    * Iterator type that skips over the holes in data_. It implements a standard
@@ -475,18 +661,59 @@ class Particles {
    * The capacity of the memory pointed to by data_.
    */
   unsigned data_capacity_ = 100u;
+  /**
+   * \internal
+   * Whether increase_capacity throws instead of reallocating, see \ref
+   * lock_capacity.
+   */
+  bool capacity_locked_ = false;
+  /**
+   * \internal
+   * Destroys the elements of a data_ buffer and returns its memory to
+   * LargeAlloc. Remembers the capacity the buffer was allocated with.
+   */
+  struct DataDeleter {
+    /**
+     * \param[in] cap Number of elements the buffer was allocated for.
+     */
+    explicit DataDeleter(unsigned cap = 0) : capacity(cap) {}
+    /// Number of elements to destroy and free.
+    unsigned capacity;
+    /// Destroys the elements and frees the memory at \p ptr.
+    void operator()(ParticleData *ptr) const;
+  };
+
+  /**
+   * \internal
+   * Allocates storage for \p capacity default-constructed ParticleData
+   * objects with their index_ members set, served by LargeAlloc so that
+   * large particle storages get hugepages and the configured NUMA
+   * placement.
+   *
+   * \param[in] capacity Number of elements to allocate.
+   * \return owning pointer to the new buffer.
+   */
+  static std::unique_ptr<ParticleData[], DataDeleter> allocate_data(
+      unsigned capacity);
+
   /**
    * Points to a dynamically allocated array of ParticleData objects. The
    * allocated size is stored in data_capacity_ and the used range (starting
    * from index 0) is stored in data_size_.
    */
-  std::unique_ptr<ParticleData[]> data_;
+  std::unique_ptr<ParticleData[], DataDeleter> data_;
 
   /**
    * Stores the indexes in data_ that do not hold valid particle data and should
    * be reused when new particles are added.
    */
   std::vector<unsigned> dirty_;
+
+  /**
+   * The structure-of-arrays mirror filled by update_hot_arrays. Mutable
+   * because it caches data_ and never carries state of its own.
+   */
+  mutable HotArrays hot_;
 };
 
 }  // namespace smash
@@ -7,7 +7,10 @@
 #ifndef SRC_INCLUDE_PARTICLETYPE_H_
 #define SRC_INCLUDE_PARTICLETYPE_H_
 
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <iosfwd>
 #include <string>
 #include <utility>
 #include <vector>
@@ -178,7 +181,7 @@ class ParticleType {
   int charge() const { return charge_; }
 
   /// \copydoc PdgCode::spin
-  unsigned int spin() const { return pdgcode_.spin(); }
+  unsigned int spin() const { return spin_; }
 
   /// \copydoc PdgCode::is_hadron
   bool is_hadron() const { return pdgcode_.is_hadron(); }
@@ -187,13 +190,13 @@ class ParticleType {
   bool is_lepton() const { return pdgcode_.is_lepton(); }
 
   /// \copydoc PdgCode::is_baryon
-  bool is_baryon() const { return pdgcode_.is_baryon(); }
+  bool is_baryon() const { return is_baryon_; }
 
   /// \copydoc PdgCode::is_meson
-  bool is_meson() const { return pdgcode_.is_meson(); }
+  bool is_meson() const { return is_meson_; }
 
   /// \copydoc PdgCode::baryon_number
-  int baryon_number() const { return pdgcode_.baryon_number(); }
+  int baryon_number() const { return baryon_number_; }
 
   /// \copydoc PdgCode::strangeness
   int strangeness() const { return pdgcode_.strangeness(); }
@@ -245,8 +248,15 @@ class ParticleType {
    *
    * \return The minimum mass that a particle of this type can assume, where at
    *         least one decay is possible.
+   *
+   * The value is immutable and cached after the first call; the threshold
+   * checks of the cross-section code hit this per channel, so the inline
+   * fast path reduces them to one load and compare.
    */
-  double min_mass_kinematic() const;
+  double min_mass_kinematic() const {
+    return likely(min_mass_kinematic_ >= 0.) ? min_mass_kinematic_
+                                             : min_mass_kinematic_compute();
+  }
 
   /**
    * The minimum mass of the resonance, where the spectral function is non-zero.
@@ -258,8 +268,14 @@ class ParticleType {
    *
    * \return The minimum mass that a particle of this type can assume, where the
    * spectral function still has a non-zero value.
+   *
+   * Cached like \ref min_mass_kinematic; the bisection over the spectral
+   * function runs only on the first call.
    */
-  double min_mass_spectral() const;
+  double min_mass_spectral() const {
+    return likely(min_mass_spectral_ >= 0.) ? min_mass_spectral_
+                                            : min_mass_spectral_compute();
+  }
 
   /**
    * Get the mass-dependent partial decay width of a particle with mass m
@@ -279,6 +295,52 @@ class ParticleType {
    */
   double total_width(const double m) const;
 
+  /**
+   * Get the mass-dependent total width for a whole batch of masses at once.
+   *
+   * The decay modes are summed in the outer loop, so every mode fetches its
+   * parameters once and runs a tight loop over the masses. Use this instead
+   * of the scalar \ref total_width when a grid of masses is evaluated, e.g.
+   * for tabulations and dumps.
+   *
+   * \param[in] masses Batch of invariant masses of the decaying particle.
+   * \return the total width for all modes at each of the masses
+   */
+  std::vector<double> total_width(const std::vector<double> &masses) const;
+
+  /**
+   * Get all the mass-dependent partial decay widths of a particle with mass
+   * m, without allocating.
+   *
+   * The widths are kept in a per-type, thread-local cache that is shared
+   * with \ref total_width and \ref get_partial_widths, so evaluating
+   * several width quantities at the same mass runs the decay-mode width
+   * formulas only once.
+   *
+   * \param[in] m Invariant mass of the decaying particle.
+   * \return a view of the partial widths, aligned with
+   *         decay_modes().decay_mode_list(). Modes below threshold have
+   *         width 0. The view stays valid until the next width evaluation
+   *         of this type at a different mass on the same thread.
+   */
+  const std::vector<double> &partial_widths(const double m) const;
+
+  /**
+   * Get the summed mass-dependent partial widths of all hadronic
+   * (i.e. non-dilepton) decay modes of a particle with mass m.
+   *
+   * This is the in-vacuum counterpart of summing the weights of
+   * \ref get_partial_widths_hadronic. It does not build a branch list, so
+   * the decay finder can sample the decay time of every resonance without
+   * allocations and only needs the branch list for the rare particles that
+   * actually decay within the time step.
+   *
+   * \param[in] m Invariant mass of the decaying particle.
+   * \return the total width of all non-dilepton modes for this mass
+   * \throw runtime_error if a decay has less than 2 or more than 3 products
+   */
+  double total_hadronic_width(const double m) const;
+
   /**
    * Get all the mass-dependent partial decay widths of a particle with mass m.
    * \todo lots of code duplication in general in these partial width functions
@@ -316,6 +378,15 @@ class ParticleType {
    */
   DecayBranchList get_partial_widths_dilepton(const double m) const;
 
+  /**
+   * \return whether the particle has any dilepton decay modes.
+   *
+   * Looked up from a per-type classification of the decay-mode list that is
+   * built on first use, so the dilepton finder can skip the (vast majority
+   * of) particles without dilepton channels without evaluating any width.
+   */
+  bool has_dilepton_decays() const;
+
   /**
    * Get the mass-dependent partial width of a resonance with mass m,
    * decaying into two given daughter particles.
@@ -358,6 +429,26 @@ class ParticleType {
    */
   double spectral_function(double m) const;
 
+  /**
+   * Full spectral function for a whole batch of masses at once, built on
+   * the batched \ref total_width.
+   * \see spectral_function
+   *
+   * \param[in] masses Batch of actual off-shell masses of the resonance.
+   * \return the value of the spectral function at each of the masses
+   */
+  std::vector<double> spectral_function(const std::vector<double> &masses)
+      const;
+
+  /**
+   * Hit and miss counts of the per-type spectral-function memo, summed
+   * over all threads since the last call. Reported together with the
+   * collision search statistics.
+   *
+   * \return {hits, misses}; the counters are reset to zero.
+   */
+  static std::array<uint64_t, 2> spectral_cache_statistics();
+
   /**
    * Full spectral function without normalization factor.
    * \see spectral_function
@@ -523,6 +614,25 @@ class ParticleType {
    */
   static void create_type_list(const std::string &particles);
 
+  /**
+   * Write the fully constructed particle-type list as the particle section
+   * of the binary tables cache.
+   *
+   * \param[out] output Stream the section is written to.
+   */
+  static void write_type_list_cache(std::ostream &output);
+
+  /**
+   * Initialize the global ParticleType list from the particle section of
+   * the binary tables cache, replacing the parsing done by
+   * create_type_list. Like create_type_list this must only be called once.
+   *
+   * \param[in] input Stream positioned at the particle section.
+   * \return whether the list was built. If false is returned, nothing was
+   *         built and the caller has to fall back to create_type_list.
+   */
+  static bool read_type_list_cache(std::istream &input);
+
   /**
    * \param[in] rhs another ParticleType to compare to
    * \return whether the two ParticleType objects have the same PDG code.
@@ -599,8 +709,35 @@ class ParticleType {
   };
 
  private:
+  /**
+   * Shared tail of create_type_list and read_type_list_cache: sorts the
+   * freshly built list, checks it for duplicates, publishes it as the
+   * global list and builds the isospin multiplets and the derived particle
+   * lists.
+   *
+   * \param[in] type_list The complete list of particle types.
+   * \throw LoadFailure if there are duplicate PDG codes in the list
+   * \throw runtime_error if the global list was already built
+   */
+  static void finalize_type_list(ParticleTypeList &type_list);
+
   /// name of the particle
   std::string name_;
+
+  /**
+   * Compute and cache \ref min_mass_kinematic by walking the decay modes;
+   * the slow path behind the inline accessor.
+   * \return the cached value
+   */
+  double min_mass_kinematic_compute() const;
+
+  /**
+   * Compute and cache \ref min_mass_spectral by bisection over the
+   * spectral function; the slow path behind the inline accessor.
+   * \return the cached value
+   */
+  double min_mass_spectral_compute() const;
+
   /// pole mass of the particle
   double mass_;
   /// width of the particle
@@ -632,15 +769,21 @@ class ParticleType {
   mutable int isospin_;
   /// Isospin projection of the particle; filled automatically from pdgcode_.
   int I3_;
+  /**
+   * Twice the spin of the particle; filled automatically from pdgcode_, so
+   * that hot loops do not decode the PDG bitfields over and over again.
+   */
+  unsigned int spin_;
+  /// Baryon number of the particle; filled automatically from pdgcode_.
+  int baryon_number_;
+  /// Whether this is a baryon; filled automatically from pdgcode_.
+  bool is_baryon_;
+  /// Whether this is a meson; filled automatically from pdgcode_.
+  bool is_meson_;
 
   /// Container for the isospin multiplet information
   IsoParticleType *iso_multiplet_ = nullptr;
 
-  /// Maximum factor for single-res mass sampling, cf. sample_resonance_mass.
-  mutable double max_factor1_ = 1.;
-  /// Maximum factor for double-res mass sampling, cf. sample_resonance_masses.
-  mutable double max_factor2_ = 1.;
-
   /**\ingroup logging
    * Writes all information about the particle type to the output stream.
    *
@@ -10,6 +10,9 @@
 #ifndef SRC_INCLUDE_PAULIBLOCKING_H_
 #define SRC_INCLUDE_PAULIBLOCKING_H_
 
+#include <array>
+#include <vector>
+
 #include "configuration.h"
 #include "experimentparameters.h"
 #include "forwarddeclarations.h"
@@ -65,6 +68,34 @@ class PauliBlocker {
                          const Particles &particles, const PdgCode pdg,
                          const ParticleList &disregard) const;
 
+  /**
+   * Builds the internal cell list over the baryons, which lets
+   * phasespace_dens() visit only the particles within the averaging
+   * sphere instead of scanning the full particle list.
+   *
+   * The index stores copies: entries of particles that interacted since
+   * the build are skipped via Particles::is_valid and the surviving ones
+   * are looked up in their current state, so the computed density is the
+   * same as with the full scan. Newly produced particles have to be added
+   * with add_to_index(). Experiment rebuilds the index at the beginning
+   * of every timestep.
+   *
+   * \param[in] particles Current particle list.
+   * \param[in] drift_margin Upper bound [fm] on the distance a particle
+   *            can propagate while the index is in use. It enlarges the
+   *            search radius, so particles drifting into the averaging
+   *            sphere are not missed.
+   */
+  void build_index(const Particles &particles, double drift_margin);
+
+  /**
+   * Adds a newly produced particle to the index. Non-baryons are
+   * ignored, as is the call before the first build_index().
+   *
+   * \param[in] p A valid copy of the particle to add.
+   */
+  void add_to_index(const ParticleData &p);
+
  private:
   /// Tabulate integrals for weights
   void init_weights();
@@ -84,11 +115,45 @@ class PauliBlocker {
   /// Radius of averaging in momentum space, GeV/c
   double rp_;
 
-  /// Testparticles number
+  /// Testparticles number times the number of parallel ensembles
   int ntest_;
 
-  /// Weights: tabulated results of numerical integration
+  /**
+   * \return the index of the cell containing \p pos in cells_, clamped
+   * to the covered region. Clamping is safe because it cannot move two
+   * positions further apart than they really are.
+   */
+  int index_cell(const ThreeVector &pos) const;
+
+  /**
+   * Weights: tabulated results of numerical integration, including the
+   * test-particle normalization 1/ntest_.
+   */
   std::array<double, 30> weights_;
+
+  /// Whether build_index() was called and the cell list can be used
+  bool index_built_ = false;
+
+  /// Gathering radius of the index: rr_ + rc_ plus the drift margin, fm
+  double index_radius_ = 0.0;
+
+  /// Minimum coordinates covered by the index cells
+  std::array<double, 3> index_min_;
+
+  /// Inverse cell length of the index, 1/fm
+  double index_factor_ = 1.0;
+
+  /// Number of index cells in x, y and z direction
+  std::array<int, 3> index_cells_;
+
+  /// Indexed baryon copies, one list per cell
+  std::vector<ParticleList> cells_;
+
+  /**
+   * Buffer of the squared distances entering the weight interpolation,
+   * reused between phasespace_dens() calls (which happen serially).
+   */
+  mutable std::vector<double> rdist_sqr_buffer_;
 };
 }  // namespace smash
 
@@ -262,23 +262,105 @@ class PdgCode {
     return result;
   }
 
+  /**
+   * Construct PDG code from decimal number without any validation.
+   *
+   * This is the fast path for input readers that construct many codes
+   * from trusted or separately validated data, e.g. the list modus
+   * reading multi-gigabyte particle files: it sets the internal fields
+   * purely arithmetically, with none of the digit tests and consistency
+   * checks of the validating constructors. Validation is deferred to the
+   * caller; an invalid code is harmless in itself (the accessors return
+   * meaningless but well-defined values) and can be caught later with
+   * \ref test_code and \ref check, or implicitly by the particle-type
+   * lookup, which does not know invalid codes.
+   *
+   * \param[in] pdgcode_decimal decimal integer representing the PDG code
+   * \return the constructed code, not validated
+   */
+  static PdgCode from_decimal_unchecked(const int pdgcode_decimal) {
+    PdgCode result;
+    int a = pdgcode_decimal;
+    if (a < 0) {
+      result.digits_.antiparticle_ = true;
+      a = -a;
+    }
+    if (a >= 1000000000) {
+      // ±10LZZZAAAI is the standard for nuclei
+      result.nucleus_.is_nucleus_ = true;
+      result.nucleus_.I_ = a % 10;
+      a /= 10;
+      result.nucleus_.A_ = a % 1000;
+      a /= 1000;
+      result.nucleus_.Z_ = a % 1000;
+      a /= 1000;
+      // The remaining "10L" digits leave L after removing the leading 10.
+      result.nucleus_.n_Lambda_ = a - 100;
+      return result;
+    }
+    /* Unpack the decimal digits; digit[7] is the extra spin digit of
+     * codes whose spin degeneracy does not fit into the last digit. */
+    std::uint32_t digit[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    int i = 0;
+    while (a) {
+      digit[i++] = a % 10;
+      a /= 10;
+    }
+    result.digits_.n_J_ = digit[0] + digit[7];
+    result.digits_.n_q3_ = digit[1];
+    result.digits_.n_q2_ = digit[2];
+    result.digits_.n_q1_ = digit[3];
+    result.digits_.n_L_ = digit[4];
+    result.digits_.n_R_ = digit[5];
+    result.digits_.n_ = digit[6];
+    return result;
+  }
+
+  /**
+   * Construct many PDG codes from decimal numbers at once, without
+   * validation. This is the bulk interface of
+   * \ref from_decimal_unchecked for input readers that convert whole
+   * blocks of particle records.
+   *
+   * \param[in] decimal_codes pointer to \p count decimal PDG codes
+   * \param[in] count number of codes to convert
+   * \param[out] codes destination for \p count constructed codes
+   */
+  static void from_decimal_bulk(const std::int32_t* decimal_codes,
+                                size_t count, PdgCode* codes) {
+    for (size_t i = 0; i < count; i++) {
+      codes[i] = from_decimal_unchecked(decimal_codes[i]);
+    }
+  }
+
   /**
    * Construct PDG code from decimal number.
    * \param[in] pdgcode_decimal decimal integer representing the PDG code
+   * \throw InvalidPdgCode as the validating string constructor would
    */
   static PdgCode from_decimal(const int pdgcode_decimal) {
-    // Nucleus and special codes with 2J+1 > 9
-    if (std::abs(pdgcode_decimal) > 1E7) {
-      return PdgCode(std::to_string(pdgcode_decimal));
+    const int abs_code = std::abs(pdgcode_decimal);
+    // Codes of nine digits are neither hadron codes nor nuclei.
+    if (abs_code >= 100000000 && abs_code < 1000000000) {
+      throw InvalidPdgCode("String \"" + std::to_string(pdgcode_decimal) +
+                           "\" too long for PDG Code\n");
     }
-    int a = pdgcode_decimal;
-    int hex_pdg = 0, tmp = 1;
-    while (a) {
-      hex_pdg += (a % 10) * tmp;
-      tmp *= 16;
-      a = a / 10;
+    PdgCode result = from_decimal_unchecked(pdgcode_decimal);
+    if (result.is_nucleus()) {
+      if (abs_code / 100000000 != 10) {
+        throw InvalidPdgCode("Pdg code of nucleus \"" +
+                             std::to_string(pdgcode_decimal) +
+                             "\" should start with 10\n");
+      }
+      return result;
     }
-    return PdgCode(hex_pdg);
+    const int test = result.test_code();
+    if (test > 0) {
+      throw InvalidPdgCode("Invalid digits " + std::to_string(test) +
+                           " in PDG Code " + result.string());
+    }
+    result.check();
+    return result;
   }
 
   /****************************************************************************
@@ -10,6 +10,8 @@
 #ifndef SRC_INCLUDE_POW_H_
 #define SRC_INCLUDE_POW_H_
 
+#include <cmath>
+
 namespace smash {
 
 /**
@@ -39,6 +41,23 @@ inline constexpr T square(const T base) {
   return pow_int(base, 2);
 }
 
+/**
+ * Power with a precomputed logarithm of the base:
+ * \f$ x^a = \exp(a \log x) \f$.
+ *
+ * Many cross-section parametrizations evaluate both a power law and
+ * logarithmic terms of the same variable; sharing the logarithm saves its
+ * recomputation inside std::pow. The result agrees with std::pow to a few
+ * ulp (i.e. well below \f$ 10^{-12} \f$ relative error).
+ *
+ * \param[in] log_base the logarithm of the base
+ * \param[in] exponent the exponent
+ * \return base^exponent
+ */
+inline double pow_from_log(const double log_base, const double exponent) {
+  return std::exp(exponent * log_base);
+}
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_POW_H_
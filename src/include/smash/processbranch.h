@@ -7,6 +7,7 @@
 #ifndef SRC_INCLUDE_PROCESSBRANCH_H_
 #define SRC_INCLUDE_PROCESSBRANCH_H_
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -132,6 +133,27 @@ class ProcessBranch {
    */
   virtual ~ProcessBranch() = default;
 
+  /**
+   * Allocate memory for a branch from the shared memory pool.
+   *
+   * Branch lists are rebuilt for every cross-section evaluation and every
+   * decay, so the branches are among the most frequently allocated objects
+   * in a run. Serving them from the pool's thread-local free lists turns
+   * the churn into pointer pops instead of heap round trips.
+   *
+   * \param[in] size size of the object to allocate, provided by the compiler
+   * \return memory for the new branch
+   */
+  static void *operator new(std::size_t size);
+
+  /**
+   * Return the memory of a branch to the pool, making it available for the
+   * next allocation of similar size.
+   *
+   * \param[in] ptr memory previously obtained from operator new
+   */
+  static void operator delete(void *ptr);
+
   /**
    * Set the weight of the branch.
    * In other words, how probable this branch is
@@ -10,8 +10,11 @@
 #ifndef SRC_INCLUDE_PROCESSSTRING_H_
 #define SRC_INCLUDE_PROCESSSTRING_H_
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -20,6 +23,7 @@
 #include "constants.h"
 #include "logging.h"
 #include "particledata.h"
+#include "pythiapool.h"
 
 namespace smash {
 
@@ -144,20 +148,82 @@ class StringProcess {
   /// PYTHIA object used in fragmentation
   std::unique_ptr<Pythia8::Pythia> pythia_hadron_;
 
+  /**
+   * Pool of pre-initialized PYTHIA instances for fragmentation. Its
+   * capacity follows the size of the shared thread pool, so concurrent
+   * fragment_string() calls never serialize on a single PYTHIA object and
+   * never re-run the expensive init().
+   */
+  std::unique_ptr<PythiaPool> pythia_hadron_pool_;
+
   /// An object to compute cross-sections
   Pythia8::SigmaTotal pythia_sigmatot_;
 
+  /// Lock serializing access to the stateful pythia_sigmatot_ object.
+  mutable std::mutex sigmatot_mutex_;
+
+  /**
+   * Memoized results of \ref cross_sections_diffractive, keyed by the PDG
+   * codes and the (threshold-clamped) collision energy. The same pair is
+   * queried at the identical energy whenever it is re-examined in later
+   * timesteps without having interacted, so exact-key memoization removes
+   * the repeated SigmaTotal evaluations without altering any value.
+   * Cleared at the start of every event to bound its growth. Guarded by
+   * sigmatot_mutex_.
+   */
+  std::map<std::tuple<int, int, double>, std::array<double, 3>>
+      sigmatot_cache_;
+
   /**
    * event record for intermediate partonic state
    * in the hard string routine
    */
   Pythia8::Event event_intermediate_;
 
+  /// strangeness suppression factor, kept for the deferred PYTHIA setup
+  double strange_supp_;
+  /// diquark suppression factor, kept for the deferred PYTHIA setup
+  double diquark_supp_;
+  /// StringZ:aLund parameter, kept for the deferred PYTHIA setup
+  double stringz_a_;
+  /// StringZ:bLund parameter, kept for the deferred PYTHIA setup
+  double stringz_b_;
+  /// StringPT:sigma parameter, kept for the deferred PYTHIA setup
+  double string_sigma_T_;
+
+  /// Guards the one-time deferred creation of the PYTHIA objects.
+  std::once_flag pythia_init_once_;
+
+  /// Whether the PYTHIA objects have been created and initialized.
+  bool pythia_initialized_ = false;
+
+  /// Seed to apply to the PYTHIA objects when they are first initialized.
+  int pythia_seed_ = 0;
+
+  /// Whether a seed is waiting to be applied at the deferred initialization.
+  bool pythia_seed_pending_ = false;
+
+  /**
+   * Create and initialize the PYTHIA objects if that has not happened yet.
+   *
+   * Creating and initializing PYTHIA takes seconds of startup time and a
+   * sizable amount of memory, so it is deferred until the first string
+   * process is actually requested; runs whose collision energies never
+   * cross the string threshold skip it entirely. Thread-safe; only the
+   * first caller initializes.
+   */
+  void require_pythia();
+
+  /// Performs the deferred creation and initialization of PYTHIA.
+  void initialize_pythia();
+
  public:
   // clang-format off
 
   /**
-   * Constructor, initializes pythia. Should only be called once.
+   * Constructor. Should only be called once. The PYTHIA objects are not
+   * created here; their creation and initialization is deferred until the
+   * first string process is requested.
    * \param[in] string_tension value of #kappa_tension_string_ [GeV/fm]
    * \param[in] time_formation value of #time_formation_const_ [fm]
    * \param[in] gluon_beta value of #pow_fgluon_beta_
@@ -231,11 +297,29 @@ class StringProcess {
    */
   void init_pythia_hadron_rndm() {
     const auto &log = logger<LogArea::Pythia>();
+    {
+      /* New event: the memoized SigmaTotal results of the previous event
+       * are unlikely to recur and are dropped to bound the cache size. */
+      std::lock_guard<std::mutex> guard(sigmatot_mutex_);
+      sigmatot_cache_.clear();
+    }
+    /* The seed is drawn unconditionally, so the SMASH random stream does
+     * not depend on whether PYTHIA has been initialized yet. */
     const int seed_new =
         random::uniform_int(1, maximum_rndm_seed_in_pythia);
+    pythia_seed_ = seed_new;
+    if (!pythia_initialized_) {
+      /* The PYTHIA objects do not exist yet; the seed is applied when they
+       * are first initialized. */
+      pythia_seed_pending_ = true;
+      return;
+    }
 
     pythia_hadron_->rndm.init(seed_new);
     log.debug("pythia_hadron_ : rndm is initialized with seed ", seed_new);
+    /* The fragmentation instances get consecutive seeds derived from the
+     * same draw, so they stay decorrelated but reproducible. */
+    pythia_hadron_pool_->seed(seed_new);
   }
 
   // clang-format on
@@ -244,7 +328,21 @@ class StringProcess {
    * Function to get the PYTHIA object for hard string routine
    * \return pointer to the PYTHIA object used in hard string routine
    */
-  Pythia8::Pythia *get_ptr_pythia_parton() { return pythia_parton_.get(); }
+  Pythia8::Pythia *get_ptr_pythia_parton() {
+    require_pythia();
+    return pythia_parton_.get();
+  }
+
+  /**
+   * \return The pool of pre-initialized fragmentation PYTHIA instances.
+   *
+   * Callers that want to fragment several strings concurrently submit their
+   * work via PythiaPool::run_async() or check out instances themselves.
+   */
+  PythiaPool &pythia_hadron_pool() {
+    require_pythia();
+    return *pythia_hadron_pool_;
+  }
 
   /**
    * Interface to pythia_sigmatot_ to compute cross-sections of A+B->
@@ -257,6 +355,7 @@ class StringProcess {
    */
   std::array<double, 3> cross_sections_diffractive(int pdg_a, int pdg_b,
                                                    double sqrt_s) {
+    require_pythia();
     // This threshold magic is following Pythia. Todo(ryu): take care of this.
     double sqrts_threshold = 2. * (1. + 1.0e-6);
     /* In the case of mesons, the corresponding vector meson masses
@@ -272,9 +371,21 @@ class StringProcess {
     if (sqrt_s < sqrts_threshold) {
       sqrt_s = sqrts_threshold;
     }
+    /* pythia_sigmatot_ is stateful, so concurrent collision searches have
+     * to serialize here. The result only depends on the arguments, hence
+     * the call order does not affect reproducibility. */
+    const std::tuple<int, int, double> key(pdg_a, pdg_b, sqrt_s);
+    std::lock_guard<std::mutex> guard(sigmatot_mutex_);
+    auto cached = sigmatot_cache_.find(key);
+    if (cached != sigmatot_cache_.end()) {
+      return cached->second;
+    }
     pythia_sigmatot_.calc(pdg_a, pdg_b, sqrt_s);
-    return {pythia_sigmatot_.sigmaAX(), pythia_sigmatot_.sigmaXB(),
-            pythia_sigmatot_.sigmaXX()};
+    const std::array<double, 3> result = {pythia_sigmatot_.sigmaAX(),
+                                          pythia_sigmatot_.sigmaXB(),
+                                          pythia_sigmatot_.sigmaXX()};
+    sigmatot_cache_[key] = result;
+    return result;
   }
 
   /**
@@ -716,10 +827,12 @@ class StringProcess {
 
   /**
    * a function to get the final state particle list
-   * which is called after the collision
+   * which is called after the collision.
+   * The internal list is moved out instead of copied; it is rebuilt from
+   * scratch by the next next_*() call anyway.
    * \return ParticleList filled with the final state particles.
    */
-  ParticleList get_final_state() { return final_state_; }
+  ParticleList get_final_state() { return std::move(final_state_); }
 
   /**
    * compute the formation time and fill the arrays with final-state particles
@@ -8,9 +8,11 @@
 #ifndef SRC_INCLUDE_PROPAGATION_H_
 #define SRC_INCLUDE_PROPAGATION_H_
 
+#include <cassert>
 #include <vector>
 
 #include "lattice.h"
+#include "logging.h"
 #include "particles.h"
 #include "potentials.h"
 
@@ -71,6 +73,93 @@ double calc_hubble(double time, const ExpansionProperties &metric);
 double propagate_straight_line(Particles *particles, double to_time,
                                const std::vector<FourVector> &beam_momentum);
 
+/**
+ * Variant of propagate_straight_line() that calls a functor on every
+ * particle right after it was advanced, while the particle data is
+ * still in cache. This allows per-particle post-processing (e.g. the
+ * dilepton shining of Experiment::propagate_and_shine) without
+ * traversing the particle array a second time.
+ *
+ * Without beam-momentum overrides (which exist only for the collider
+ * modus with frozen Fermi motion) the propagation runs in a tight loop
+ * that is free of per-particle branching and debug logging, so it
+ * compiles to straight-line code over the particle storage.
+ *
+ * \param[out] particles The particle list in the event
+ * \param[in] to_time final time [fm]
+ * \param[in] beam_momentum Beam-momentum overrides, see
+ *            propagate_straight_line().
+ * \param[in] on_moved Functor called with every particle and the time
+ *            interval it was propagated over, after its position was
+ *            updated.
+ * \return dt time interval of propagation of the last particle, see
+ *            propagate_straight_line().
+ * \tparam F Type of the functor, callable as
+ *           \c f(const ParticleData &, double).
+ */
+template <typename F>
+double propagate_straight_line_fused(
+    Particles *particles, double to_time,
+    const std::vector<FourVector> &beam_momentum, F &&on_moved) {
+  const auto &log = logger<LogArea::Propagation>();
+  bool negative_dt_error = false;
+  double dt = 0.0;
+  if (beam_momentum.empty()) {
+    for (ParticleData &data : *particles) {
+      dt = to_time - data.position().x0();
+      if (dt < 0.0 && !negative_dt_error) {
+        // Print error message once, not for every particle
+        negative_dt_error = true;
+        log.error("propagate_straight_line - negative dt = ", dt);
+      }
+      assert(dt >= 0.0);
+      FourVector position =
+          data.position() + FourVector(0.0, data.velocity() * dt);
+      position.set_x0(to_time);
+      data.set_4position(position);
+      on_moved(data, dt);
+    }
+    return dt;
+  }
+  for (ParticleData &data : *particles) {
+    const double t0 = data.position().x0();
+    dt = to_time - t0;
+    if (dt < 0.0 && !negative_dt_error) {
+      // Print error message once, not for every particle
+      negative_dt_error = true;
+      log.error("propagate_straight_line - negative dt = ", dt);
+    }
+    assert(dt >= 0.0);
+    /* "Frozen Fermi motion": Fermi momenta are only used for collisions,
+     * but not for propagation. This is done to avoid nucleus flying apart
+     * even if potentials are off. Initial nucleons before the first collision
+     * are propagated only according to beam momentum.
+     * Initial nucleons are distinguished by data.id() < the size of
+     * beam_momentum, which is by default zero except for the collider modus
+     * with the fermi motion == frozen.
+     * todo(m. mayer): improve this condition (see comment #11 issue #4213)*/
+    assert(data.id() >= 0);
+    const bool avoid_fermi_motion =
+        (static_cast<uint64_t>(data.id()) <
+         static_cast<uint64_t>(beam_momentum.size())) &&
+        (data.get_history().collisions_per_particle == 0);
+    ThreeVector v;
+    if (avoid_fermi_motion) {
+      const FourVector vbeam = beam_momentum[data.id()];
+      v = vbeam.velocity();
+    } else {
+      v = data.velocity();
+    }
+    const FourVector distance = FourVector(0.0, v * dt);
+    log.debug("Particle ", data, " motion: ", distance);
+    FourVector position = data.position() + distance;
+    position.set_x0(to_time);
+    data.set_4position(position);
+    on_moved(data, dt);
+  }
+  return dt;
+}
+
 /**
  * Modifies positions and momentum of all particles to account for
  * space-time deformation.
@@ -98,11 +187,25 @@ void expand_space_time(Particles *particles,
  *            components of the Skyrme force
  * \param[in] FI3_lat Lattice for the electric and magnetic
  *            components of the symmetry force
+ * \param[in] FB_core_lat Optional finer Skyrme force lattice covering the
+ *            core region, see \ref input_lattice_. Particles inside it
+ *            take their force from here instead of FB_lat.
+ * \param[in] FI3_core_lat Optional finer symmetry force lattice covering
+ *            the core region, used like FB_core_lat.
+ * \param[in] interpolate_forces If true, the force a particle feels is
+ *            interpolated trilinearly between the eight lattice nodes
+ *            surrounding its position instead of taking the value at the
+ *            nearest node, see \key Interpolate_Forces.
  */
 void update_momenta(
     Particles *particles, double dt, const Potentials &pot,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat);
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_core_lat =
+        nullptr,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_core_lat =
+        nullptr,
+    bool interpolate_forces = false);
 
 }  // namespace smash
 #endif  // SRC_INCLUDE_PROPAGATION_H_
@@ -0,0 +1,154 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_PYTHIAPOOL_H_
+#define SRC_INCLUDE_PYTHIAPOOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Pythia8/Pythia.h"
+
+namespace smash {
+
+/**
+ * A pool of identically configured PYTHIA instances.
+ *
+ * Pythia::init() is expensive, so instead of constructing a fresh instance
+ * for every piece of concurrent work, instances are checked out of the pool
+ * with acquire(), used through the returned lease and automatically returned
+ * when the lease goes out of scope. Instances are created lazily on first
+ * use, up to the capacity given at construction; a serial run therefore
+ * never pays for more than one init().
+ *
+ * The pool itself is thread-safe; the leased instances are not shared, so
+ * multiple threads can run fragmentation concurrently as long as each works
+ * on its own lease. run_async() combines a lease with the shared thread
+ * pool for fire-and-forget submission.
+ */
+class PythiaPool {
+ public:
+  /**
+   * Function configuring a freshly constructed instance. It is called
+   * before Pythia::init(), which the pool runs itself.
+   */
+  using Setup = std::function<void(Pythia8::Pythia &)>;
+
+  /**
+   * Construct a pool.
+   *
+   * \param[in] capacity Maximum number of instances the pool creates,
+   *            must be positive.
+   * \param[in] setup Configuration applied to every new instance.
+   * \throw invalid_argument for a non-positive capacity.
+   */
+  PythiaPool(int capacity, Setup setup);
+
+  /**
+   * An exclusive, movable handle to one instance of the pool. The instance
+   * is returned to the pool when the lease is destroyed.
+   */
+  class Lease {
+   public:
+    /**
+     * \param[in] pool The pool the instance goes back to.
+     * \param[in] pythia The leased instance.
+     */
+    Lease(PythiaPool *pool, Pythia8::Pythia *pythia)
+        : pool_(pool), pythia_(pythia) {}
+    /// Return the instance to the pool.
+    ~Lease() {
+      if (pool_) {
+        pool_->release(pythia_);
+      }
+    }
+    /// Leases cannot be copied: the instance is exclusive.
+    Lease(const Lease &) = delete;
+    /// Leases cannot be copied: the instance is exclusive.
+    Lease &operator=(const Lease &) = delete;
+    /// Move the lease; \p other no longer returns the instance.
+    Lease(Lease &&other) : pool_(other.pool_), pythia_(other.pythia_) {
+      other.pool_ = nullptr;
+      other.pythia_ = nullptr;
+    }
+    /// \return The leased instance.
+    Pythia8::Pythia &operator*() const { return *pythia_; }
+    /// \return The leased instance.
+    Pythia8::Pythia *operator->() const { return pythia_; }
+
+   private:
+    /// The pool the instance goes back to, nullptr for a moved-from lease.
+    PythiaPool *pool_;
+    /// The leased instance.
+    Pythia8::Pythia *pythia_;
+  };
+
+  /**
+   * Check an instance out of the pool, blocking until one is free. Creates
+   * and initializes a new instance if all existing ones are leased and the
+   * capacity is not exhausted yet.
+   *
+   * \return A lease of the instance.
+   */
+  Lease acquire();
+
+  /**
+   * Run \p task with a leased instance on the shared thread pool, or
+   * synchronously in the caller if there is no shared pool.
+   *
+   * \param[in] task The work needing a PYTHIA instance.
+   * \return A future that becomes ready when the task has finished.
+   */
+  std::future<void> run_async(std::function<void(Pythia8::Pythia &)> task);
+
+  /**
+   * Reseed the random number generators of the instances; instance i gets
+   * the seed base_seed + i, so the instances stay decorrelated but
+   * reproducible. Instances created later inherit the same rule.
+   *
+   * Must not be called while any lease is alive, e.g. between events.
+   *
+   * \param[in] base_seed Seed of the first instance.
+   */
+  void seed(int base_seed);
+
+  /// \return Maximum number of instances the pool creates.
+  int capacity() const { return capacity_; }
+
+ private:
+  /**
+   * Give an instance back to the pool and wake one waiting acquire().
+   *
+   * \param[in] pythia The instance being returned.
+   */
+  void release(Pythia8::Pythia *pythia);
+
+  /// Maximum number of instances.
+  const int capacity_;
+  /// Configuration applied to every new instance.
+  const Setup setup_;
+  /// Lock protecting the instance lists and the seed.
+  std::mutex mutex_;
+  /// Signalled when an instance is returned to the pool.
+  std::condition_variable instance_available_;
+  /// All instances created so far; index i was created as the i-th one.
+  std::vector<std::unique_ptr<Pythia8::Pythia>> instances_;
+  /// Instances currently not leased.
+  std::vector<Pythia8::Pythia *> free_;
+  /// Base seed new instances derive their seed from.
+  int base_seed_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_PYTHIAPOOL_H_
@@ -216,6 +216,20 @@ class QuantumNumbers {
             baryon_number_ - rhs.baryon_number_};
   }
 
+  /**
+   * \return Entry-wise sum of two sets of QuantumNumbers.
+   * \param rhs Right-hand side.
+   *
+   * Useful for bookkeeping that applies the differences of performed
+   * actions to a running total.
+   */
+  QuantumNumbers operator+(const QuantumNumbers& rhs) const {
+    return {momentum_ + rhs.momentum_,          charge_ + rhs.charge_,
+            isospin3_ + rhs.isospin3_,          strangeness_ + rhs.strangeness_,
+            charmness_ + rhs.charmness_,        bottomness_ + rhs.bottomness_,
+            baryon_number_ + rhs.baryon_number_};
+  }
+
   /**
    * Checks if the current particle list has still the same values and
    * reports about differences.
@@ -11,6 +11,7 @@
 #define SRC_INCLUDE_RANDOM_H_
 
 #include <cassert>
+#include <cstddef>
 #include <limits>
 #include <random>
 #include <utility>
@@ -23,11 +24,183 @@ namespace smash {
 
 namespace random {
 
-/// The random number engine used is the Mersenne Twister.
-using Engine = std::mt19937_64;
+/**
+ * A counter-based random engine following the Philox design (Salmon et al.,
+ * "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11), producing 64-bit
+ * outputs with the Philox-2x64-10 bijection.
+ *
+ * In contrast to a Mersenne Twister, the state is just a key and a 128-bit
+ * block counter, so independent streams are cheap: any (seed, event number,
+ * stream id) triple deterministically selects a stream via set_stream(),
+ * independent of which thread uses it or in which order streams are
+ * consumed. This makes parallel execution bit-reproducible for a fixed
+ * seed.
+ *
+ * The engine satisfies the UniformRandomBitGenerator requirements and can
+ * be used with all distributions from \<random\>.
+ */
+class PhiloxEngine {
+ public:
+  /// The type of the generated values.
+  using result_type = uint64_t;
 
-/// The engine that is used commonly by all distributions.
-extern /*thread_local (see #3075)*/ Engine engine;
+  /// \return The smallest possible value.
+  static constexpr result_type min() { return 0u; }
+
+  /// \return The largest possible value.
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /**
+   * Construct an engine for the given seed, on stream 0 of event 0.
+   *
+   * \param[in] seed_value The seed selecting the key of the bijection.
+   */
+  explicit PhiloxEngine(uint64_t seed_value = 0u) { seed(seed_value); }
+
+  /**
+   * Reseed the engine; equivalent to selecting stream 0 of event 0.
+   *
+   * \param[in] seed_value The new seed.
+   */
+  void seed(uint64_t seed_value) { set_stream(seed_value, 0u, 0u); }
+
+  /**
+   * Jump to the beginning of a deterministic substream.
+   *
+   * \param[in] seed_value The global seed.
+   * \param[in] event_number The event this stream belongs to.
+   * \param[in] stream_id Distinguishes several streams within one event.
+   */
+  void set_stream(uint64_t seed_value, uint64_t event_number,
+                  uint64_t stream_id) {
+    /* The stream id is folded into the key with a golden-ratio multiplier,
+     * the event number selects the high word of the block counter. Any two
+     * distinct triples therefore encrypt disjoint counter blocks or use
+     * different keys. */
+    key_ = seed_value ^ (stream_id * 0x9E3779B97F4A7C15ull);
+    counter_low_ = 0u;
+    counter_high_ = event_number;
+    index_ = 2;
+  }
+
+  /// \return The next pseudorandom 64-bit value.
+  result_type operator()() {
+    if (index_ == 2) {
+      generate_block();
+      index_ = 0;
+    }
+    return output_[index_++];
+  }
+
+  /**
+   * Advance the engine's state as if operator() was called \p z times.
+   *
+   * \param[in] z Number of values to discard.
+   */
+  void discard(unsigned long long z) {
+    while (z-- > 0) {
+      (*this)();
+    }
+  }
+
+  /// Serializable copy of the full engine state, used for checkpointing.
+  struct State {
+    uint64_t key;           ///< \see key_
+    uint64_t counter_low;   ///< \see counter_low_
+    uint64_t counter_high;  ///< \see counter_high_
+    uint64_t output[2];     ///< \see output_
+    int32_t index;          ///< \see index_
+  };
+
+  /// \return A copy of the full internal state.
+  State state() const {
+    return {key_,
+            counter_low_,
+            counter_high_,
+            {output_[0], output_[1]},
+            index_};
+  }
+
+  /**
+   * Restore a state previously obtained from state(). The sequence of
+   * generated values continues exactly where the saved engine left off.
+   *
+   * \param[in] s The state to restore.
+   */
+  void restore_state(const State &s) {
+    key_ = s.key;
+    counter_low_ = s.counter_low;
+    counter_high_ = s.counter_high;
+    output_[0] = s.output[0];
+    output_[1] = s.output[1];
+    index_ = s.index;
+  }
+
+ private:
+  /**
+   * Full 64x64 -> 128 bit multiplication.
+   *
+   * \param[in] a First factor.
+   * \param[in] b Second factor.
+   * \param[out] hi The high 64 bits of the product.
+   * \param[out] lo The low 64 bits of the product.
+   */
+  static void mulhilo(uint64_t a, uint64_t b, uint64_t &hi, uint64_t &lo) {
+    const uint64_t a_lo = a & 0xFFFFFFFFull;
+    const uint64_t a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xFFFFFFFFull;
+    const uint64_t b_hi = b >> 32;
+    const uint64_t t = a_lo * b_lo;
+    const uint64_t u = a_hi * b_lo + (t >> 32);
+    const uint64_t v = a_lo * b_hi + (u & 0xFFFFFFFFull);
+    hi = a_hi * b_hi + (u >> 32) + (v >> 32);
+    lo = a * b;
+  }
+
+  /// Encrypt the current counter block and advance the counter.
+  void generate_block() {
+    uint64_t x0 = counter_low_;
+    uint64_t x1 = counter_high_;
+    uint64_t k = key_;
+    for (int round = 0; round < 10; ++round) {
+      uint64_t hi, lo;
+      mulhilo(0xD2B74407B1CE6E93ull, x0, hi, lo);
+      x0 = hi ^ k ^ x1;
+      x1 = lo;
+      k += 0x9E3779B97F4A7C15ull;
+    }
+    output_[0] = x0;
+    output_[1] = x1;
+    if (++counter_low_ == 0u) {
+      ++counter_high_;
+    }
+  }
+
+  /// The key of the Philox bijection, derived from seed and stream id.
+  uint64_t key_;
+  /// Low word of the 128-bit block counter.
+  uint64_t counter_low_;
+  /// High word of the 128-bit block counter, carries the event number.
+  uint64_t counter_high_;
+  /// The two outputs of the most recently encrypted block.
+  uint64_t output_[2];
+  /// Position of the next unused value in output_, 2 if none is left.
+  int index_;
+};
+
+/// The random number engine used is the counter-based Philox engine.
+using Engine = PhiloxEngine;
+
+/**
+ * The engine that is used commonly by all distributions.
+ *
+ * Every thread owns its own engine, so event threads running concurrently
+ * do not interfere with each other. Each thread has to seed its engine
+ * before drawing random numbers.
+ */
+extern thread_local Engine engine;
 
 /** Provides uniform random numbers on a fixed interval.
  *
@@ -74,6 +247,23 @@ void set_seed(T &&seed) {
 /// Advance the engine's state and return the generated value.
 inline Engine::result_type advance() { return engine(); }
 
+/**
+ * Select a deterministic random-number substream for the calling thread.
+ *
+ * All subsequent draws on this thread come from the stream selected by the
+ * (seed, event_number, stream_id) triple, regardless of which thread calls
+ * this or what other streams were used before. This is the entry point for
+ * reproducible parallel execution.
+ *
+ * \param[in] seed The global seed.
+ * \param[in] event_number The event the stream belongs to.
+ * \param[in] stream_id Distinguishes several streams within one event.
+ */
+inline void set_stream(uint64_t seed, uint64_t event_number,
+                       uint64_t stream_id = 0u) {
+  engine.set_stream(seed, event_number, stream_id);
+}
+
 /**
  * \returns A uniformly distributed random real number \f$\chi \in [{\rm
  * min}, {\rm max})\f$
@@ -236,6 +426,20 @@ int binomial(const int N, const T &p) {
   return std::binomial_distribution<int>(N, p)(engine);
 }
 
+/**
+ * Returns a random number drawn from the standard normal distribution.
+ *
+ * The sampling uses the ziggurat method (Marsaglia and Tsang, 2000):
+ * most draws cost one 64-bit engine value and a table comparison,
+ * instead of the logarithms and square roots of the polar method behind
+ * std::normal_distribution. The sampler is stateless between calls, so
+ * reseeding the engine at an event boundary cannot leak a cached second
+ * variate from the previous event.
+ *
+ * \return Sampled random number.
+ */
+double standard_normal();
+
 /**
  * Returns a random number drawn from a normal distribution.
  *
@@ -245,11 +449,18 @@ int binomial(const int N, const T &p) {
  */
 template <typename T>
 double normal(const T &mean, const T &sigma) {
-  return std::normal_distribution<double>(mean, sigma)(engine);
+  return mean + sigma * standard_normal();
 }
 
 /**
  * Discrete distribution with weight given by probability vector.
+ *
+ * Internally the weights are preprocessed into a Walker (1977) alias
+ * table: every draw costs one uniform number and one table
+ * lookup, independently of the number of outcomes, instead of the scan or
+ * binary search of std::discrete_distribution. The preprocessing is linear
+ * in the number of outcomes, so the table pays off whenever the same
+ * distribution is drawn from more than a few times.
  */
 template <typename T>
 class discrete_dist {
@@ -258,33 +469,87 @@ class discrete_dist {
    *
    * Always draws 0.
    */
-  discrete_dist() : distribution({1.0}) {}
+  discrete_dist() { reset_weights({T(1)}); }
 
   /** Construct from probability vector.
    * \param plist Vector with probabilities such that P(i) = vec[i]
    */
-  explicit discrete_dist(const std::vector<T> &plist)
-      : distribution(plist.begin(), plist.end()) {}
+  explicit discrete_dist(const std::vector<T> &plist) { reset_weights(plist); }
 
   /** Construct from probability list.
    * \param l Initializer list with probabilities such that P(i) = l[i]
    */
-  explicit discrete_dist(std::initializer_list<T> l) : distribution(l) {}
+  explicit discrete_dist(std::initializer_list<T> l) {
+    reset_weights(std::vector<T>(l));
+  }
 
   /** Reset the discrete distribution from a new probability list.
    * \param plist Vector with probabilities such that P(i) = vec[i]
    */
   void reset_weights(const std::vector<T> &plist) {
-    distribution = std::discrete_distribution<>(plist.begin(), plist.end());
+    const std::size_t n = plist.size();
+    double sum = 0.;
+    for (const T &p : plist) {
+      sum += static_cast<double>(p);
+    }
+    if (n == 0 || !(sum > 0.)) {
+      // mirror the degenerate default: always draw 0
+      prob_.assign(1, 1.);
+      alias_.assign(1, 0);
+      return;
+    }
+    /* Vose's stable construction of the alias table: outcomes whose scaled
+     * weight is below average donate the remainder of their table column to
+     * an outcome above average, so every column is filled exactly. */
+    prob_.resize(n);
+    alias_.resize(n);
+    std::vector<double> scaled(n);
+    std::vector<int> small, large;
+    for (std::size_t i = 0; i < n; i++) {
+      scaled[i] = static_cast<double>(plist[i]) * n / sum;
+      (scaled[i] < 1. ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      const int s = small.back();
+      const int l = large.back();
+      small.pop_back();
+      prob_[s] = scaled[s];
+      alias_[s] = l;
+      scaled[l] -= 1. - scaled[s];
+      if (scaled[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    /* Whatever remains in either list has weight 1 up to rounding. */
+    for (const int i : small) {
+      prob_[i] = 1.;
+      alias_[i] = i;
+    }
+    for (const int i : large) {
+      prob_[i] = 1.;
+      alias_[i] = i;
+    }
   }
   /** Draw a random number from the discrete distribution.
    * \return Sampled value
    */
-  int operator()() { return distribution(engine); }
+  int operator()() {
+    /* One uniform number serves twice: the integer part picks the table
+     * column, the fractional part decides between it and its alias. */
+    const double u = canonical() * prob_.size();
+    std::size_t i = static_cast<std::size_t>(u);
+    if (i >= prob_.size()) {  // guard against rounding up to n
+      i = prob_.size() - 1;
+    }
+    return (u - i < prob_[i]) ? i : alias_[i];
+  }
 
  private:
-  /** The distribution object that is being used. */
-  std::discrete_distribution<> distribution;
+  /** Probability of drawing the column index itself instead of its alias. */
+  std::vector<double> prob_;
+  /** The alias of each table column. */
+  std::vector<int> alias_;
 };
 
 /**
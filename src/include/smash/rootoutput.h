@@ -211,6 +211,17 @@ class RootOutput : public OutputInterface {
    */
   int autosave_frequency_;
 
+  /**
+   * AutoFlush setting applied to the trees: a positive value flushes the
+   * baskets to disk every that many entries, a negative value every that
+   * many bytes. 0 keeps the ROOT default. Larger (absolute) values batch
+   * more data per write, which helps on network file systems.
+   */
+  const int autoflush_;
+
+  /// Basket size in bytes applied to all branches; 0 keeps the ROOT default.
+  const int basket_size_;
+
   /**
    * Basic initialization routine, creating the TTree objects
    * for particles and collisions.
@@ -0,0 +1,150 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_RUNTIMEPROFILER_H_
+#define SRC_INCLUDE_RUNTIMEPROFILER_H_
+
+#include <cstdint>
+
+#include "copystats.h"
+#include "forwarddeclarations.h"
+#include "processbranch.h"
+#include "tsc.h"
+
+namespace smash {
+
+class Action;
+
+/**
+ * Accumulates the CPU cycles spent in the phases of the evolution loop
+ * (collision search, propagation, lattice update, output) and in performed
+ * actions, keyed by their process type, so that the cost of decays, elastic
+ * collisions or string fragmentation can be told apart without attaching a
+ * profiler.
+ *
+ * Accounting is off by default and switched on with the `--profile-run`
+ * command line option; a disabled guard costs only a branch, so the
+ * instrumentation can stay in place permanently. Cycle counts come from the
+ * low-overhead TimeStampCounter. The evolution loop runs on the main
+ * thread, hence the accumulators need no locking; work a phase hands to the
+ * thread pool is attributed to the phase, because the main thread waits for
+ * it inside the phase.
+ */
+class RuntimeProfiler {
+ public:
+  /// The instrumented phases of the evolution loop.
+  enum class Phase {
+    /// Grid construction and collision/decay finding.
+    ActionSearch = 0,
+    /// Straight-line propagation between actions.
+    Propagation = 1,
+    /// Density lattice refresh and potential evaluation.
+    LatticeUpdate = 2,
+    /// Intermediate and event-end output.
+    Output = 3,
+  };
+
+  /// Switch the collection of run phase timings on.
+  static void enable();
+
+  /// \return whether the collection of run phase timings is on.
+  static bool is_enabled();
+
+  /**
+   * Attribute cycles spent performing one action to its process type.
+   *
+   * \param[in] type The process type of the performed action.
+   * \param[in] cycles The CPU cycles the action took.
+   */
+  static void account_action(ProcessType type, uint64_t cycles);
+
+  /**
+   * Print the accumulated accounting as a table and write it to a
+   * machine-readable file, then clear the accumulators.
+   *
+   * Does nothing if profiling is disabled.
+   *
+   * \param[in] output_file Path of the machine-readable file, one
+   *            tab-separated line per phase or process type.
+   */
+  static void report(const bf::path &output_file);
+
+  /**
+   * Guard that adds the cycles from its construction to its destruction to
+   * one phase of the evolution loop.
+   */
+  class Guard {
+   public:
+    /**
+     * Start measuring.
+     *
+     * \param[in] phase The phase the cycles are accounted to.
+     */
+    explicit Guard(Phase phase);
+
+    /// Stop measuring and accumulate the cycles.
+    ~Guard();
+
+    /// A running measurement cannot be copied.
+    Guard(const Guard &) = delete;
+    /// A running measurement cannot be assigned.
+    Guard &operator=(const Guard &) = delete;
+
+   private:
+    /// The phase the cycles are accounted to.
+    Phase phase_;
+    /// Cycle counter covering the guarded scope.
+    TimeStampCounter tsc_;
+#ifdef SMASH_PARTICLE_COPY_STATS
+    /// Copy-counting scope to restore when the guard ends.
+    CopyStats::Scope previous_scope_;
+#endif
+  };
+
+  /**
+   * Guard that attributes the cycles from its construction to its
+   * destruction to the process type of the given action.
+   *
+   * The type is read in the destructor, because scatter actions only decide
+   * on their process (elastic, 2->2, string, ...) while generating the
+   * final state.
+   */
+  class ActionGuard {
+   public:
+    /**
+     * Start measuring.
+     *
+     * \param[in] action The action whose process type the cycles are
+     *            accounted to.
+     */
+    explicit ActionGuard(const Action &action);
+
+    /// Stop measuring and accumulate the cycles.
+    ~ActionGuard();
+
+    /// A running measurement cannot be copied.
+    ActionGuard(const ActionGuard &) = delete;
+    /// A running measurement cannot be assigned.
+    ActionGuard &operator=(const ActionGuard &) = delete;
+
+   private:
+    /// The measured action.
+    const Action &action_;
+    /// Cycle counter covering the guarded scope.
+    TimeStampCounter tsc_;
+#ifdef SMASH_PARTICLE_COPY_STATS
+    /// Copy-counting scope to restore when the guard ends.
+    CopyStats::Scope previous_scope_;
+#endif
+  };
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_RUNTIMEPROFILER_H_
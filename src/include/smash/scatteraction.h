@@ -74,6 +74,21 @@ class ScatterAction : public Action {
    */
   double transverse_distance_sqr() const;
 
+  /**
+   * The same squared transverse distance for a prospective pair,
+   * without constructing an action. The collision finder uses this to
+   * reject pairs by the distance criterion before allocating a
+   * ScatterAction for them. The criterion is evaluated covariantly from
+   * four-vector contractions, so no boost (and no square root) is
+   * performed per pair.
+   *
+   * \param[in] in_part1 first scattering partner
+   * \param[in] in_part2 second scattering partner
+   * \return  squared distance \f$d^2_\mathrm{coll}\f$.
+   */
+  static double transverse_distance_sqr(const ParticleData& in_part1,
+                                        const ParticleData& in_part2);
+
   /**
    * Generate the final-state of the scattering process.
    * Performs either elastic or inelastic scattering.
@@ -124,6 +139,17 @@ class ScatterAction : public Action {
                            bool strings_with_probability,
                            NNbarTreatment nnbar_treatment);
 
+  /**
+   * Add the elastic scattering as the only subprocess for this action
+   * object, bypassing the full cross-section dispatch. Used by the finder
+   * when the configuration implies that no other process is possible.
+   *
+   * \param[in] elastic_parameter If non-negative, given global
+   *            elastic cross section.
+   * \param[in] use_AQM use elastic cross sections via AQM?
+   */
+  void add_elastic_scattering(double elastic_parameter, bool use_AQM);
+
   /**
    * Get list of possible collision channels.
    *
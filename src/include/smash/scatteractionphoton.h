@@ -10,9 +10,12 @@
 #ifndef SRC_INCLUDE_SCATTERACTIONPHOTON_H_
 #define SRC_INCLUDE_SCATTERACTIONPHOTON_H_
 
+#include <array>
+#include <memory>
 #include <utility>
 
 #include "scatteraction.h"
+#include "tabulation.h"
 
 namespace smash {
 
@@ -238,6 +241,35 @@ class ScatterActionPhoton : public ScatterAction {
   double diff_cross_section(const double t, const double m_rho,
                             MediatorType mediator = default_mediator_) const;
 
+  /**
+   * Look up the differential cross section in a table over t, which is
+   * built from the analytic parametrization on first use.
+   *
+   * The kinematics of the action (s, the masses, the rho mass) are fixed,
+   * only the momentum transfer t differs between the fractional photons.
+   * The parametrizations in CrosssectionsPhoton are therefore sampled once
+   * into a Tabulation over the full t range and all further fractional
+   * photons of this action are served by linear interpolation. With a
+   * single photon the analytic code is called directly, a table would not
+   * pay off.
+   *
+   * \param[in] t Mandelstam-t [GeV^2].
+   * \param[in] m_rho Mass of the incoming or outgoing rho-particle [GeV]
+   * \param[in] mediator Switch for determing which mediating particle to use
+   *
+   * \return Differential cross section. [mb/\f$GeV^2\f$]
+   */
+  double diff_cross_section_tabulated(const double t, const double m_rho,
+                                      MediatorType mediator);
+
+  /**
+   * Tables of \ref diff_cross_section over t, one per mediator choice,
+   * indexed by the MediatorType value (see \ref
+   * diff_cross_section_tabulated). Null until the first fractional photon
+   * needs them.
+   */
+  std::array<std::unique_ptr<Tabulation>, 3> diff_xs_tables_;
+
   /**
    * Find the mass of the participating rho-particle.
    *
@@ -324,6 +356,59 @@ class ScatterActionPhoton : public ScatterAction {
    */
   double diff_cross_section_w_ff(const double t, const double m_rho,
                                  const double E_photon);
+
+  /**
+   * Kinematic quantities of the photon-producing collision that are shared
+   * by all fractional photons, computed once per collision by \ref
+   * prepare_photon_kinematics.
+   */
+  struct PhotonKinematics {
+    /// Mandelstam s of the incoming pair [GeV^2]
+    double s;
+    /// CM energy of the incoming pair [GeV]
+    double sqrts;
+    /// Lower end of the Mandelstam-t range [GeV^2]
+    double t1;
+    /// Upper end of the Mandelstam-t range [GeV^2]
+    double t2;
+    /// CM momentum of the incoming pair [GeV]
+    double pcm_in;
+    /// CM momentum of the outgoing pair [GeV]
+    double pcm_out;
+    /// Effective mass of the first incoming particle (the pion) [GeV]
+    double m1;
+    /// Effective mass of the second incoming particle [GeV]
+    double m2;
+    /// Mass of the participating rho, see \ref rho_mass [GeV]
+    double m_rho;
+    /// Point of the interaction in the computational frame
+    FourVector middle_point;
+    /// Boost velocity from the CM to the computational frame
+    ThreeVector beta;
+  };
+
+  /**
+   * Compute the sample-independent kinematics of the photon production.
+   *
+   * Swaps the incoming particles such that the pion comes first (the t
+   * range is defined with the rho as the second particle), so it has to be
+   * called before any fractional photon is sampled.
+   *
+   * \return The shared kinematic quantities.
+   */
+  PhotonKinematics prepare_photon_kinematics();
+
+  /**
+   * Generate one fractional photon from the given momentum transfer and
+   * azimuthal angle and set the outgoing particles and, for more than one
+   * fractional photon, the weight accordingly.
+   *
+   * \param[in] kin Shared kinematics from \ref prepare_photon_kinematics
+   * \param[in] t Sampled Mandelstam-t [GeV^2]
+   * \param[in] phi Sampled azimuthal angle
+   */
+  void sample_fractional_photon(const PhotonKinematics &kin, const double t,
+                                const double phi);
 };
 
 }  // namespace smash
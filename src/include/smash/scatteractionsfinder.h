@@ -10,8 +10,14 @@
 #ifndef SRC_INCLUDE_SCATTERACTIONSFINDER_H_
 #define SRC_INCLUDE_SCATTERACTIONSFINDER_H_
 
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "action.h"
@@ -22,6 +28,107 @@
 
 namespace smash {
 
+/**
+ * \ingroup action
+ * A lazily populated table of total cross sections, keyed by the species
+ * pair and a fine \f$\sqrt{s}\f$ bin.
+ *
+ * In matter dominated by a few stable species the same
+ * (type_a, type_b, sqrt(s)) inputs recur very often in the collision search,
+ * but the cross-section machinery recomputes all parametrizations and
+ * spectral integrals every time. This cache memoizes the largest total
+ * cross section seen in a bin, which serves as an upper bound to reject
+ * most pairs via the geometric collision criterion without building the
+ * full process list. Accepted pairs still evaluate the exact cross section.
+ *
+ * Only pairs of stable species are cached, because for resonances the
+ * cross section additionally depends on the off-shell masses. The table may
+ * be filled from several threads concurrently: the stored values are
+ * deterministic, so racing writers agree, and the per-pair tables are
+ * published with release/acquire ordering.
+ */
+class CrossSectionCache {
+ public:
+  CrossSectionCache();
+  ~CrossSectionCache();
+
+  /// The cache owns its tables and cannot be copied.
+  CrossSectionCache(const CrossSectionCache &) = delete;
+  /// The cache owns its tables and cannot be assigned.
+  CrossSectionCache &operator=(const CrossSectionCache &) = delete;
+
+  /**
+   * Moving transfers the tables and leaves a fresh mutex behind; it keeps
+   * ScatterActionsFinder movable. Only safe before the collision search
+   * starts, i.e. while no other thread uses the cache.
+   */
+  CrossSectionCache(CrossSectionCache &&other)
+      : tables_(std::move(other.tables_)) {}
+
+  /**
+   * Look up the memoized total cross section.
+   *
+   * \param[in] type_a The species of the first incoming particle.
+   * \param[in] type_b The species of the second incoming particle.
+   * \param[in] sqrts The center-of-mass energy of the pair [GeV].
+   * \return the largest total cross section stored for this species pair
+   *         and \p sqrts bin so far [mb], or a negative value if the bin is
+   *         empty or not cacheable.
+   */
+  double get(const ParticleType &type_a, const ParticleType &type_b,
+             double sqrts) const;
+
+  /**
+   * Store a computed total cross section, keeping the maximum per bin.
+   *
+   * Uncacheable inputs (unstable species, energies beyond the table) are
+   * silently ignored.
+   *
+   * \param[in] type_a The species of the first incoming particle.
+   * \param[in] type_b The species of the second incoming particle.
+   * \param[in] sqrts The center-of-mass energy of the pair [GeV].
+   * \param[in] cross_section The total cross section of the pair [mb].
+   */
+  void store(const ParticleType &type_a, const ParticleType &type_b,
+             double sqrts, double cross_section);
+
+  /**
+   * Write the filled tables to a file, so that a later run can start with
+   * a warm cache via \ref load. The species are identified by their PDG
+   * codes, which keeps the file valid across reorderings of the particle
+   * list.
+   *
+   * \param[in] path File the tables are written to.
+   * \return the number of species pairs written.
+   */
+  std::size_t save(const bf::path &path) const;
+
+  /**
+   * Merge the tables stored in a file written by \ref save into this
+   * cache, keeping the maximum per bin. Files with a different binning and
+   * entries for species unknown to the current particle list are ignored
+   * with a warning.
+   *
+   * \param[in] path File the tables are read from.
+   * \return the number of species pairs merged.
+   */
+  std::size_t load(const bf::path &path);
+
+ private:
+  /**
+   * \return the flat index of the unordered species pair (\p type_a,
+   * \p type_b) into tables_.
+   */
+  std::size_t pair_index(const ParticleType &type_a,
+                         const ParticleType &type_b) const;
+
+  /// One atomically published table per species pair; null until first use.
+  std::unique_ptr<std::atomic<std::atomic<double> *>[]> tables_;
+
+  /// Guards the allocation of new per-pair tables.
+  std::mutex mutex_;
+};
+
 /**
  * \ingroup action
  * A simple scatter finder:
@@ -103,7 +210,7 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * \param[in] dt The maximum time interval at the current time step [fm/c]
    * \return A list of possible scatter actions
    */
-  ActionList find_actions_in_cell(const ParticleList &search_list,
+  ActionList find_actions_in_cell(const ParticleSlice &search_list,
                                   double dt) const override;
 
   /**
@@ -116,8 +223,8 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * \param[in] dt The maximum time interval at the current time step [fm/c]
    * \return A list of possible scatter actions
    */
-  ActionList find_actions_with_neighbors(const ParticleList &search_list,
-                                         const ParticleList &neighbors_list,
+  ActionList find_actions_with_neighbors(const ParticleSlice &search_list,
+                                         const ParticleSlice &neighbors_list,
                                          double dt) const override;
 
   /**
@@ -125,12 +232,13 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * particles and the rest.
    *
    * \param[in] search_list A list of particles within the current cell
-   * \param[in] surrounding_list The whole particle list
+   * \param[in] surrounding_list The particles that might interact with the
+   *             search list, e.g. its spatial neighborhood
    * \param[in] dt The maximum time interval at the current time step [fm/c]
    * \return A list of possible scatter actions
    */
   ActionList find_actions_with_surrounding_particles(
-      const ParticleList &search_list, const Particles &surrounding_list,
+      const ParticleList &search_list, const ParticleList &surrounding_list,
       double dt) const override;
 
   /**
@@ -142,6 +250,16 @@ class ScatterActionsFinder : public ActionFinderInterface {
     return ActionList();
   }
 
+  /**
+   * The collision search only evaluates cross sections and geometric
+   * criteria and draws no random numbers, so disjoint cells can be searched
+   * concurrently. The stateful Pythia cross-section object used for string
+   * excitation is protected by a lock inside StringProcess.
+   *
+   * \return true
+   */
+  bool is_search_thread_safe() const override { return true; }
+
   /**
    * If there is only one particle sort, no decays
    * (only elastic scatterings are possible),
@@ -161,18 +279,36 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * The maximal distance over which particles can interact, related to the
    * number of test particles and the maximal cross section.
    *
-   * \param[in] testparticles Number of test particles.
-   *
    * \return Maximal transverse distance squared. [fm\f$^{2}\f$]
    *         Particle pairs whose transverse distance is larger than this
    *         are not checked for collisions.
    */
-  double max_transverse_distance_sqr(int testparticles) const {
+  double max_transverse_distance_sqr() const {
     return (is_constant_elastic_isotropic() ? elastic_parameter_
-                                            : maximum_cross_section) /
-           testparticles * fm2_mb * M_1_PI;
+                                            : maximum_cross_section) *
+           xs_to_dist_sqr_;
   }
 
+  /**
+   * The maximal total cross section of the given species pair, usable as a
+   * distance cut for this pair only.
+   *
+   * For stable species the maximum is found by scanning the actual
+   * cross-section machinery over the reachable energy range once per pair
+   * (with a safety margin on top, lazily, the result is memoized). This is
+   * typically far below the global \ref maximum_cross_section, e.g. for
+   * pion pairs, so most candidate pairs are rejected much earlier. For
+   * unstable species, and for energies beyond the scanned range, the
+   * global bound is returned.
+   *
+   * \param[in] type_a The species of the first incoming particle.
+   * \param[in] type_b The species of the second incoming particle.
+   * \param[in] sqrts The center-of-mass energy of the pair [GeV].
+   * \return The maximal total cross section of the pair [mb].
+   */
+  double max_cross_section(const ParticleType &type_a,
+                           const ParticleType &type_b, double sqrts) const;
+
   /**
    * Prints out all the 2-> n (n > 1) reactions with non-zero cross-sections
    * between all possible pairs of particle types.
@@ -205,6 +341,40 @@ class ScatterActionsFinder : public ActionFinderInterface {
     }
   }
 
+  /**
+   * \return whether collision search counters are collected
+   *         (\key Collision_Statistics).
+   */
+  bool collect_statistics() const { return collect_statistics_; }
+
+  /**
+   * Print the counters collected since the last report (cell and neighbor
+   * searches, pairs examined, pairs passing the distance criterion against
+   * the maximal cross section, actions created) and reset them.
+   *
+   * Does nothing unless \key Collision_Statistics is on.
+   */
+  void report_statistics() const;
+
+  /**
+   * \return The factor by which the minimal cell length of the collision
+   *         grid should be scaled for the next timestep, at least one.
+   *
+   * With \key Adaptive_Cell_Size the factor hill-climbs on the cost of the
+   * previous search, measured by the counters the finder already collects:
+   * every visited cell combination has a fixed overhead and every examined
+   * pair an additional one. Larger cells trade fewer cell visits (good for
+   * a dilute halo) against longer candidate lists (bad for a dense core);
+   * the measured optimum moves as the system expands, so the factor is
+   * re-adjusted every timestep. It never drops below one because cells
+   * smaller than the interaction length would miss collision partners.
+   *
+   * \param[in] particle_count Current number of particles, used to
+   *            normalize the cost so that a growing multiplicity is not
+   *            mistaken for a worse cell size.
+   */
+  double cell_length_scale(size_t particle_count);
+
  private:
   /**
    * Check for a single pair of particles (id_a, id_b) if a collision will
@@ -219,12 +389,46 @@ class ScatterActionsFinder : public ActionFinderInterface {
    */
   ActionPtr check_collision(const ParticleData &data_a,
                             const ParticleData &data_b, double dt) const;
+
+  /**
+   * Scan the cross-section machinery over the reachable energy range to
+   * determine the maximal total cross section of a pair of stable species.
+   *
+   * \param[in] type_a The species of the first incoming particle.
+   * \param[in] type_b The species of the second incoming particle.
+   * \return The maximal total cross section found, with a safety margin,
+   *         clamped to \ref maximum_cross_section [mb].
+   */
+  double scan_max_cross_section(const ParticleType &type_a,
+                                const ParticleType &type_b) const;
+
+  /**
+   * The axis separation beyond which a particle pair cannot collide within
+   * the given time interval: the transverse distance is bounded by \ref
+   * max_transverse_distance_sqr and each particle moves by less than \p dt
+   * during the time step. This is the same length that is used as the
+   * minimal grid cell size, so the sort-and-sweep refinement of the cell
+   * search discards no pair that the grid itself would have kept.
+   *
+   * \param[in] dt The maximum time interval at the current time step [fm/c]
+   * \return The sweep range [fm]
+   */
+  double sweep_range(double dt) const {
+    return std::sqrt(4. * dt * dt + max_transverse_distance_sqr());
+  }
+
   /// Class that deals with strings, interfacing Pythia.
   std::unique_ptr<StringProcess> string_process_interface_;
   /// Elastic cross section parameter (in mb).
   const double elastic_parameter_;
-  /// Number of test particles.
-  const int testparticles_;
+  /**
+   * Conversion factor from a cross section [mb] to the squared transverse
+   * distance [fm\f$^{2}\f$] of the geometric collision criterion,
+   * \f$ \sigma\, \mathrm{fm}^2/\mathrm{mb} / (\pi N_{\rm test}) \f$.
+   * Precomputed once so that the test-particle scaling is not redone for
+   * every candidate pair.
+   */
+  const double xs_to_dist_sqr_;
   /// Do all collisions isotropically.
   const bool isotropic_;
   /// Enable 2->1 processes.
@@ -244,6 +448,16 @@ class ScatterActionsFinder : public ActionFinderInterface {
   const bool strings_with_probability_;
   /// Switch for NNbar reactions
   const NNbarTreatment nnbar_treatment_;
+  /**
+   * Whether the configuration implies that elastic scattering is the only
+   * possible process for any pair: only the Elastic bit of Included_2to2
+   * is set, resonance formation, strings and NNbar annihilation are off
+   * and no light nuclei are present (their production channels ignore the
+   * reaction bitset). Derived once at construction; \ref check_collision
+   * then adds the elastic branch directly instead of running the full
+   * cross-section dispatch.
+   */
+  const bool elastic_only_;
   /**
    * Parameter to record whether the nucleon
    * has experienced a collision or not
@@ -253,8 +467,93 @@ class ScatterActionsFinder : public ActionFinderInterface {
   const int N_tot_;
   /// Record the number of the nucleons in the projectile
   const int N_proj_;
+  /// Number of parallel ensembles, see \key Ensembles
+  const int n_ensembles_;
   /// Parameter for formation time
   const double string_formation_time_;
+  /// Memoized total cross sections, consulted before the full machinery.
+  mutable CrossSectionCache xs_cache_;
+  /**
+   * File the cross-section cache is loaded from on construction and saved
+   * to after a cross-section dump (\key Cross_Section_Cache_File); empty
+   * if the cache is not persisted.
+   */
+  const std::string xs_cache_file_;
+  /**
+   * Maximal total cross section per species pair, -1 until the pair was
+   * scanned. The entries are atomic because the parallel search may fill
+   * them concurrently; the scan is deterministic, so racing writers agree.
+   */
+  mutable std::unique_ptr<std::atomic<double>[]> max_xs_table_;
+  /**
+   * Whether collision search counters are collected
+   * (\key Collision_Statistics).
+   */
+  const bool collect_statistics_;
+
+  /**
+   * Whether the cell length of the collision grid is tuned from the search
+   * counters (\key Adaptive_Cell_Size), see \ref cell_length_scale.
+   */
+  const bool adaptive_cell_size_;
+
+  /**
+   * \return whether the search counters are updated. They feed the
+   * statistics report and the cell-size tuner; when neither is enabled, no
+   * counter is ever touched.
+   */
+  bool counting_enabled() const {
+    return collect_statistics_ || adaptive_cell_size_;
+  }
+
+  /// State of the cell-size tuner, see \ref cell_length_scale.
+  struct CellSizeTuner {
+    /// The scale factor recommended for the next timestep.
+    double scale = 1.0;
+    /// Whether the scale factor is currently being increased.
+    bool growing = true;
+    /// Normalized search cost of the previous timestep, -1 before the first.
+    double last_cost = -1.;
+    /// Search counter values at the previous adjustment.
+    uint64_t last_searches = 0;
+    /// Pair counter value at the previous adjustment.
+    uint64_t last_pairs = 0;
+  };
+  /// State of the cell-size tuner, only used with \key Adaptive_Cell_Size.
+  CellSizeTuner tuner_;
+  /// Counters of the collision search, see \ref report_statistics.
+  struct SearchStatistics {
+    /// Cell searches since the last statistics report.
+    std::atomic<uint64_t> cell_searches{0};
+    /// Neighbor-pair searches since the last statistics report.
+    std::atomic<uint64_t> neighbor_searches{0};
+    /// Particle pairs examined since the last statistics report.
+    std::atomic<uint64_t> pairs_examined{0};
+    /**
+     * Pairs whose closest approach falls into the current time step, i.e.
+     * that survived the cheap rejection layers (just-collided, initial
+     * nucleon ban, receding or out-of-step pairs) since the last report.
+     */
+    std::atomic<uint64_t> pairs_approaching{0};
+    /**
+     * Pairs that passed the distance criterion against the maximal cross
+     * section of their species pair since the last statistics report.
+     */
+    std::atomic<uint64_t> pairs_within_distance{0};
+    /**
+     * Pairs that also survived the cached cross-section bound and for
+     * which the full cross-section machinery ran, since the last report.
+     */
+    std::atomic<uint64_t> xs_evaluations{0};
+    /// Actions created since the last statistics report.
+    std::atomic<uint64_t> actions_created{0};
+  };
+  /**
+   * The search counters, heap-allocated because the atomics would
+   * otherwise make the finder immovable. Always allocated; the counters
+   * are only touched when \ref collect_statistics_ is on.
+   */
+  mutable std::unique_ptr<SearchStatistics> stats_;
 };
 
 }  // namespace smash
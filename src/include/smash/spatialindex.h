@@ -0,0 +1,98 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SPATIALINDEX_H_
+#define SRC_INCLUDE_SPATIALINDEX_H_
+
+#include <array>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "grid.h"
+#include "particles.h"
+
+namespace smash {
+
+/**
+ * A coarse cell index over the particles that stays alive while actions are
+ * performed.
+ *
+ * The Grid is rebuilt from scratch for every collision search and its cells
+ * only stay correct until the first action is performed. In timestepless
+ * evolution, however, every performed action triggers a search of the
+ * outgoing particles against the surrounding particles, which otherwise has
+ * to scan the full particle list. The SpatialIndex is built once per
+ * propagation interval and is updated incrementally: newly produced
+ * particles are added with \ref insert, while particles that interacted or
+ * disappeared are skipped lazily via Particles::is_valid when a
+ * neighborhood is gathered.
+ *
+ * The cell length must be chosen large enough that any pair that can still
+ * interact within the propagation interval sits in adjacent cells, even
+ * though the indexed positions age as the particles propagate (see
+ * Experiment::run_time_evolution_timestepless for the bound used there).
+ */
+class SpatialIndex : public GridBase {
+ public:
+  /**
+   * Builds the index from the given particles.
+   *
+   * \param[in] particles The particles to index.
+   * \param[in] min_cell_length The minimal length a cell must have.
+   */
+  SpatialIndex(const Particles &particles, double min_cell_length);
+
+  /**
+   * Adds a newly produced particle to the index.
+   *
+   * \param[in] p A valid copy of the particle to add.
+   */
+  void insert(const ParticleData &p);
+
+  /**
+   * Collects the current state of all indexed particles in the cells around
+   * \p p.
+   *
+   * Indexed entries that are no longer valid copies (the particle interacted
+   * or was removed since it was indexed) are skipped; the remaining ones are
+   * looked up in \p particles so that the returned list holds their current
+   * state.
+   *
+   * \param[in] p The particle whose neighborhood is searched.
+   * \param[in] particles The particle list the index was built from.
+   * \return the current state of the particles indexed in the cell of \p p
+   *         and all adjacent cells.
+   */
+  ParticleList neighborhood(const ParticleData &p,
+                            const Particles &particles) const;
+
+ private:
+  /**
+   * \return the cell coordinate for position \p x on axis \p dim, clamped to
+   * the grid. Clamping is safe because it cannot move two positions further
+   * apart than they really are.
+   */
+  SizeType cell_coordinate(double x, std::size_t dim) const;
+
+  /// The minimum x,y,z coordinates covered by the cells.
+  std::array<double, 3> min_;
+
+  /// The inverse cell length, for index calculation.
+  double index_factor_;
+
+  /// The number of cells in x, y, and z direction.
+  std::array<SizeType, 3> number_of_cells_;
+
+  /// The indexed particle copies, one vector per cell.
+  std::vector<ParticleList> cells_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SPATIALINDEX_H_
@@ -0,0 +1,124 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SPECTRAOUTPUT_H_
+#define SRC_INCLUDE_SPECTRAOUTPUT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "file.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+#include "pdgcode.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * \brief Accumulates spectra histograms in-process and writes them once.
+ *
+ * Many analyses only ever reduce the particle output to a handful of
+ * single-particle spectra. This output fills the histograms while the run
+ * is going: at the end of each event the final particle list is binned in
+ * the configured kinematic variables for the configured species, without
+ * ever copying or storing the particles. The histograms are summed over
+ * all events of the run and written as one small text file when the
+ * output is destroyed at the end of the run, so no per-event particle
+ * I/O is needed at all.
+ */
+class SpectraOutput : public OutputInterface {
+ public:
+  /// Kinematic variable of one histogram axis.
+  enum class Axis {
+    /// Transverse momentum \f$p_T\f$ [GeV]
+    PT,
+    /// Rapidity \f$y\f$
+    Y,
+    /// Transverse mass minus the pole mass \f$m_T - m_0\f$ [GeV]
+    MT,
+    /// Azimuthal angle \f$\phi\f$ [rad]
+    PHI,
+  };
+
+  /**
+   * Create the spectra output.
+   *
+   * \param[in] path Path to the output directory.
+   * \param[in] name Name of the output.
+   * \param[in] out_par Parameters of the output, holding the species,
+   *            axes and binning of the histograms.
+   */
+  SpectraOutput(const bf::path &path, const std::string &name,
+                const OutputParameters &out_par);
+
+  /// Writes the accumulated histograms of the whole run.
+  ~SpectraOutput();
+
+  /**
+   * Does nothing; the histograms accumulate over events.
+   * \param[in] particles Unused, needed since inherited.
+   * \param[in] event_number Unused, needed since inherited.
+   */
+  void at_eventstart(const Particles &particles,
+                     const int event_number) override;
+
+  /**
+   * Bins the final particle list of the event into the histograms.
+   * \param[in] particles Final list of particles.
+   * \param[in] event_number Unused, needed since inherited.
+   * \param[in] impact_parameter Unused, needed since inherited.
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   double impact_parameter) override;
+
+ private:
+  /**
+   * \param[in] axis The histogram axis.
+   * \return Lower edge of the histogram range of the axis.
+   */
+  double lower_edge(Axis axis) const;
+
+  /**
+   * \param[in] axis The histogram axis.
+   * \return Upper edge of the histogram range of the axis.
+   */
+  double upper_edge(Axis axis) const;
+
+  /// Pointer to the output file.
+  RenamingFilePtr file_;
+
+  /// Species the histograms are filled for, one set of axes each.
+  std::vector<PdgCode> pdgs_;
+
+  /// Histogrammed kinematic variables.
+  std::vector<Axis> axes_;
+
+  /// Number of bins of every histogram.
+  int bins_;
+
+  /// Upper edge in GeV of the \f$p_T\f$ and \f$m_T - m_0\f$ axes.
+  double pt_max_;
+
+  /// The rapidity axis covers [-y_max_, y_max_].
+  double y_max_;
+
+  /// Bin contents, one histogram per species and axis.
+  std::vector<std::vector<double>> counts_;
+
+  /// Number of events accumulated into the histograms.
+  uint64_t events_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SPECTRAOUTPUT_H_
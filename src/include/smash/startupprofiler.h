@@ -0,0 +1,87 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_STARTUPPROFILER_H_
+#define SRC_INCLUDE_STARTUPPROFILER_H_
+
+#include <chrono>
+#include <string>
+
+#include "tsc.h"
+
+namespace smash {
+
+/**
+ * Collects wall-clock times and CPU cycle counts of the named startup
+ * phases (table parsing, spectral-integral tabulations, output creation,
+ * ...) and prints them as a report.
+ *
+ * Profiling is off by default and switched on with the `--verbose-startup`
+ * command line option; a disabled Phase guard costs only a branch, so the
+ * instrumentation can stay in place permanently. Startup runs on a single
+ * thread, hence the collected records need no locking.
+ *
+ * Phases that only finish after report() was called — like the deferred
+ * PYTHIA initialization, which happens at the first string excitation —
+ * are printed individually as soon as they end.
+ */
+class StartupProfiler {
+ public:
+  /// Switch the collection of startup phase timings on.
+  static void enable();
+
+  /// \return whether the collection of startup phase timings is on.
+  static bool is_enabled();
+
+  /**
+   * Print all phases recorded so far to standard output and clear them.
+   *
+   * Does nothing if profiling is disabled. Phases ending after this call
+   * print their own line immediately instead of being collected.
+   */
+  static void report();
+
+  /**
+   * Guard that measures one named startup phase from its construction to
+   * its destruction.
+   *
+   * Wall-clock time comes from a steady clock, the cycle count from the
+   * TimeStampCounter, so frequency scaling during startup shows up as a
+   * discrepancy between the two columns.
+   */
+  class Phase {
+   public:
+    /**
+     * Start measuring a phase.
+     *
+     * \param[in] name The name the phase is reported under.
+     */
+    explicit Phase(const std::string &name);
+
+    /// Stop measuring and record (or print) the phase.
+    ~Phase();
+
+    /// A running measurement cannot be copied.
+    Phase(const Phase &) = delete;
+    /// A running measurement cannot be assigned.
+    Phase &operator=(const Phase &) = delete;
+
+   private:
+    /// The name the phase is reported under.
+    std::string name_;
+    /// Start of the phase on the steady clock.
+    std::chrono::steady_clock::time_point wall_start_;
+    /// Cycle counter covering the phase.
+    TimeStampCounter tsc_;
+  };
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_STARTUPPROFILER_H_
@@ -8,9 +8,13 @@
 #ifndef SRC_INCLUDE_TABULATION_H_
 #define SRC_INCLUDE_TABULATION_H_
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
+#include <iosfwd>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "forwarddeclarations.h"
@@ -44,6 +48,83 @@ class Tabulation {
   Tabulation(double x_min, double range, int num,
              std::function<double(double)> f);
 
+  /**
+   * Construct a tabulation from already computed values.
+   *
+   * \param x_min lower bound of tabulation domain
+   * \param range range (x_max-x_min) of tabulation domain
+   * \param values the tabulated values, evenly spaced over the domain
+   */
+  Tabulation(double x_min, double range, std::vector<double> values);
+
+  /**
+   * Construct a new tabulation object from a batched function, which is
+   * called once with all grid points instead of once per point. Useful for
+   * functions with a batch evaluation that amortizes per-call setup, like
+   * ParticleType::spectral_function.
+   *
+   * \param x_min lower bound of tabulation domain
+   * \param range range (x_max-x_min) of tabulation domain
+   * \param num number of intervals (the number of tabulated points is
+   *        num + 1)
+   * \param f batched function mapping all grid points to their values
+   */
+  Tabulation(
+      double x_min, double range, int num,
+      const std::function<std::vector<double>(const std::vector<double> &)> &f);
+
+  /**
+   * Construct a tabulation viewing values that are stored elsewhere, e.g.
+   * in a read-only file mapping. The storage has to outlive the
+   * tabulation.
+   *
+   * \param x_min lower bound of tabulation domain
+   * \param range range (x_max-x_min) of tabulation domain
+   * \param values pointer to the tabulated values, evenly spaced over the
+   *        domain
+   * \param num the number of tabulated values
+   */
+  Tabulation(double x_min, double range, const double* values,
+             std::size_t num);
+
+  /// A tabulation cannot be copied: it may own a file mapping.
+  Tabulation(const Tabulation&) = delete;
+  /// A tabulation cannot be copied: it may own a file mapping.
+  Tabulation& operator=(const Tabulation&) = delete;
+
+  /// Unmaps the table file if the tabulation was created by \ref map_file.
+  ~Tabulation();
+
+  /**
+   * Map a tabulation file written by \ref write read-only into memory.
+   *
+   * The mapping is shared, so all SMASH processes on a node that map the
+   * same cached tabulation reference the same physical pages of the page
+   * cache instead of each holding a private copy of the values.
+   *
+   * \param filename the file holding the tabulation
+   * \return the tabulation, or nullptr if the file cannot be mapped or
+   *         does not hold a complete tabulation
+   */
+  static std::unique_ptr<Tabulation> map_file(const std::string& filename);
+
+  /**
+   * Write the tabulation to a stream in a simple binary format, suitable
+   * for reading it back with \ref from_stream.
+   *
+   * \param stream the stream to write to
+   */
+  void write(std::ostream& stream) const;
+
+  /**
+   * Read a tabulation back from a binary stream written by \ref write.
+   *
+   * \param stream the stream to read from
+   * \return the tabulation, or nullptr if the stream does not hold a
+   *         complete tabulation
+   */
+  static std::unique_ptr<Tabulation> from_stream(std::istream& stream);
+
   /**
    * Look up a value from the tabulation (without any interpolation, simply
    * using the closest tabulated value). If \par x is below the lower tabulation
@@ -53,7 +134,18 @@ class Tabulation {
    * \param x Argument to tabulated function.
    * \return Tabulated value using constant interpolation.
    */
-  double get_value_step(double x) const;
+  double get_value_step(double x) const {
+    if (x < x_min_) {
+      return 0.;
+    }
+    // this rounds correctly because double -> int conversion truncates
+    const unsigned int n = (x - x_min_) * inv_dx_ + 0.5;
+    if (n >= num_values_) {
+      return data_[num_values_ - 1];
+    } else {
+      return data_[n];
+    }
+  }
 
   /**
    * Look up a value from the tabulation using linear interpolation.
@@ -68,14 +160,49 @@ class Tabulation {
    * \param extrapolation Extrapolation that should be used for values
    * outside the tabulation.
    * \return Tabulated value using linear interpolation.
+   *
+   * Defined in the header so that the per-candidate-pair cross-section
+   * lookups can inline it.
    */
   double get_value_linear(
-      double x, Extrapolation extrapolation = Extrapolation::Linear) const;
+      double x, Extrapolation extrapolation = Extrapolation::Linear) const {
+    if (x < x_min_) {
+      return 0.;
+    }
+    if (extrapolation == Extrapolation::Zero && x > x_max_) {
+      return 0.0;
+    }
+    if (extrapolation == Extrapolation::Const && x > x_max_) {
+      return data_[num_values_ - 1];
+    }
+    const double index_double = (x - x_min_) * inv_dx_;
+    // here n is the lower index
+    const size_t n =
+        std::min(static_cast<size_t>(index_double), num_values_ - 2);
+    const double r = index_double - n;
+    return data_[n] + (data_[n + 1] - data_[n]) * r;
+  }
 
  protected:
-  /// vector for storing tabulated values
+  /// vector for storing tabulated values (empty for a view, see \ref data_)
   std::vector<double> values_;
 
+  /**
+   * The tabulated values the lookups read: values_.data() for an owning
+   * tabulation, or externally owned storage (like a shared file mapping)
+   * for a view.
+   */
+  const double* data_;
+
+  /// number of tabulated values behind \ref data_
+  std::size_t num_values_;
+
+  /// address of the file mapping created by \ref map_file, if any
+  void* map_addr_ = nullptr;
+
+  /// size of the file mapping created by \ref map_file, if any
+  std::size_t map_size_ = 0;
+
   /// lower bound for tabulation
   const double x_min_;
 
@@ -147,14 +274,16 @@ inline double spec_func_integrand_2res(double sqrts, double res_mass_1,
  * Create a table for the spectral integral of a resonance and a stable
  * particle.
  *
+ * \tparam Integrator1d Type of the one-dimensional integrator.
  * \param[inout] integrate Numerical integrator.
  * \param[in] resonance Type of the resonance particle.
  * \param[in] stable Type of the stable particle.
  * \param[in] range Distance between tabulation points [GeV].
  * \return Tabulation of the given integral.
  */
+template <typename Integrator1d>
 inline std::unique_ptr<Tabulation> spectral_integral_semistable(
-    Integrator& integrate, const ParticleType& resonance,
+    Integrator1d& integrate, const ParticleType& resonance,
     const ParticleType& stable, double range) {
   const double m_min = resonance.min_mass_kinematic();
   const double m_stable = stable.mass();
@@ -0,0 +1,116 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_THERMODYNAMICLATTICEOUTPUT_H_
+#define SRC_INCLUDE_THERMODYNAMICLATTICEOUTPUT_H_
+
+#include <string>
+#include <vector>
+
+#include "density.h"
+#include "file.h"
+#include "forwarddeclarations.h"
+#include "lattice.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * \brief Writes the Eckart density lattice to a streaming binary file
+ *
+ * In contrast to the VTK lattice output, which creates one ASCII file per
+ * quantity and output moment, this output appends one packed float32 frame
+ * per output moment to a single binary file. The lattice geometry is written
+ * once in the file header, so a frame is just the event number, the output
+ * time and the node values; the values are collected in a reusable buffer
+ * and written with a single call. This makes per-timestep captures of the
+ * density evolution cheap enough for production runs.
+ **/
+class ThermodynamicLatticeOutput : public OutputInterface {
+ public:
+  /**
+   * Construct Output
+   * \param[in] path Path to output
+   * \param[in] name Filename
+   * \param[in] out_par Parameters of output
+   */
+  ThermodynamicLatticeOutput(const bf::path &path, const std::string &name,
+                             const OutputParameters &out_par);
+  /// Default destructor
+  ~ThermodynamicLatticeOutput();
+
+  /**
+   * Stores the event number for the frame headers.
+   * \param[in] particles Dummy, is just here to satisfy inheritance
+   * \param[in] event_number Current event number
+   */
+  void at_eventstart(const Particles &particles,
+                     const int event_number) override;
+
+  /**
+   * Flushes the output file.
+   * \param[in] particles Dummy, is just here to satisfy inheritance
+   * \param[in] event_number Dummy, is just here to satisfy inheritance
+   * \param[in] impact_parameter Dummy, is just here to satisfy inheritance
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   double impact_parameter) override;
+
+  /**
+   * Stores the output time for the frame headers.
+   * \param[in] particles Dummy, is just here to satisfy inheritance
+   * \param[in] clock Clock, from which the output time is taken
+   * \param[in] dens_param Dummy, is just here to satisfy inheritance
+   */
+  void at_intermediate_time(const Particles &particles, const Clock &clock,
+                            const DensityParameters &dens_param) override;
+
+  /**
+   * Appends one frame of the density lattice to the file. Quantities other
+   * than the Eckart density are not supported and are silently skipped.
+   * \param[in] tq Output quantity, only EckartDensity is written
+   * \param[in] dens_type Density type of the lattice
+   * \param[in] lattice Lattice of tabulated values
+   */
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dens_type,
+      RectangularLattice<DensityOnLattice> &lattice) override;
+
+ private:
+  /**
+   * Writes the file header containing the lattice geometry; called once,
+   * before the first frame, when the lattice is first seen.
+   * \param[in] dens_type Density type of the lattice
+   * \param[in] lattice Lattice of tabulated values
+   */
+  void write_header(const DensityType dens_type,
+                    const RectangularLattice<DensityOnLattice> &lattice);
+
+  /// Binary output file
+  RenamingFilePtr file_;
+
+  /// Whether the file header was already written
+  bool header_written_ = false;
+
+  /// Event number written into the frame headers
+  int current_event_ = 0;
+
+  /// Output time written into the frame headers
+  double current_time_ = 0.0;
+
+  /// Reusable buffer the lattice values are packed into
+  std::vector<float> buffer_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_THERMODYNAMICLATTICEOUTPUT_H_
@@ -0,0 +1,169 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_THREADPOOL_H_
+#define SRC_INCLUDE_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace smash {
+
+/**
+ * A work-stealing pool of worker threads for data-parallel loops.
+ *
+ * The pool owns a fixed set of worker threads that sleep between parallel
+ * regions. A parallel region is started with parallel_range(), which
+ * distributes the index range over per-worker queues. Each worker first
+ * drains its own queue and then steals indices from the back of the queues
+ * of other workers, so load imbalance between tasks (e.g. grid cells with
+ * very different occupancy) is evened out automatically.
+ *
+ * The pool makes no attempt to order task execution; callers that need a
+ * deterministic result have to write their per-index results into
+ * preallocated slots and merge them in index order after parallel_range()
+ * returns.
+ */
+class ThreadPool {
+ public:
+  /**
+   * Construct a pool with the given number of worker threads.
+   *
+   * \param[in] num_threads Number of worker threads, must be positive.
+   */
+  explicit ThreadPool(int num_threads);
+
+  /// Shut down the workers and join them.
+  ~ThreadPool();
+
+  /// \return The number of worker threads of the pool.
+  int num_threads() const { return static_cast<int>(workers_.size()); }
+
+  /**
+   * Execute \p task for every index in [0, n) on the worker threads and
+   * block until all invocations have finished.
+   *
+   * The task must not itself call parallel_range() on the same pool and has
+   * to be safe to call concurrently for different indices.
+   *
+   * \param[in] n Number of indices to process.
+   * \param[in] task The callable invoked once for each index.
+   */
+  void parallel_range(size_t n, const std::function<void(size_t)> &task);
+
+  /**
+   * Submit a single task for asynchronous execution on the pool.
+   *
+   * \param[in] task The callable to execute.
+   * \return A future that becomes ready when the task has finished; it also
+   *         transports any exception the task throws.
+   */
+  std::future<void> submit(std::function<void()> task);
+
+ private:
+  /// The main loop run by every worker thread.
+  void worker_loop(int id);
+
+  /**
+   * Enqueue a task on the given queue and wake a worker.
+   *
+   * \param[in] queue_index The queue the task is pushed to.
+   * \param[in] task The task to enqueue.
+   */
+  void enqueue(size_t queue_index, std::function<void()> &&task);
+
+  /**
+   * Pop a task from the front of the own queue of worker \p id.
+   *
+   * \param[in] id The worker's own queue index.
+   * \param[out] task The popped task, if any.
+   * \return whether a task was popped.
+   */
+  bool pop_own(int id, std::function<void()> &task);
+
+  /**
+   * Try to steal a task from the back of another worker's queue.
+   *
+   * \param[in] id The thief's own queue index, which is skipped.
+   * \param[out] task The stolen task, if any.
+   * \return whether a task was stolen.
+   */
+  bool steal(int id, std::function<void()> &task);
+
+  /// A per-worker task queue with its own lock.
+  struct WorkQueue {
+    /// Lock protecting \c tasks.
+    std::mutex mutex;
+    /// Tasks waiting to be processed; owner pops front, thieves pop back.
+    std::deque<std::function<void()>> tasks;
+  };
+
+  /// One queue per worker thread.
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  /// The worker threads.
+  std::vector<std::thread> workers_;
+  /// Lock for the condition variables below.
+  std::mutex mutex_;
+  /// Signalled when a new parallel region starts or the pool shuts down.
+  std::condition_variable work_ready_;
+  /// Signalled when the last task of a parallel region finishes.
+  std::condition_variable work_done_;
+  /// Number of tasks still sitting in the queues.
+  std::atomic<size_t> queued_{0};
+  /// Number of tasks of the current parallel region that have not finished.
+  std::atomic<size_t> pending_{0};
+  /// Round-robin position for distributing submitted tasks.
+  std::atomic<size_t> next_queue_{0};
+  /// Set in the destructor to make the workers exit.
+  bool shutdown_ = false;
+};
+
+/**
+ * Create the process-wide shared thread pool.
+ *
+ * Call this once at startup, before any subsystem uses shared_pool(). For
+ * \p num_threads <= 1 no pool is created and all users fall back to their
+ * serial code paths.
+ *
+ * \param[in] num_threads Number of worker threads of the shared pool.
+ * \throw logic_error if the shared pool was already created.
+ */
+void initialize_shared_pool(int num_threads);
+
+/**
+ * \return The process-wide shared thread pool, or nullptr if no pool was
+ *         requested (serial operation).
+ *
+ * All subsystems (collision search, lattice updates, tabulation building,
+ * output writers) use this single pool instead of spawning their own
+ * threads, so one Parallelism setting controls the core budget of the
+ * whole process.
+ */
+ThreadPool *shared_pool();
+
+/**
+ * Forget the process-wide shared pool without destroying it.
+ *
+ * Has to be called in the child process directly after a fork(): the pool's
+ * worker threads only exist in the parent, so the child must neither use nor
+ * destroy the inherited pool object. Afterwards shared_pool() returns
+ * nullptr and all subsystems run serially.
+ */
+void drop_shared_pool_after_fork();
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_THREADPOOL_H_
@@ -0,0 +1,83 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_TRACERECORDER_H_
+#define SRC_INCLUDE_TRACERECORDER_H_
+
+#include <cstdint>
+
+#include "forwarddeclarations.h"
+
+namespace smash {
+
+/**
+ * Records the begin and end of named spans (collision search, propagation,
+ * output writing, ...) and writes them as a Chrome trace-event JSON file
+ * that chrome://tracing or Perfetto can load as a timeline. Unlike the
+ * aggregating RuntimeProfiler this keeps every individual span, so stalls
+ * like a slow output flush, the deferred PYTHIA initialization or a
+ * thermalizer activation show up at their position in the event.
+ *
+ * Recording is off by default and switched on with the `--trace` command
+ * line option; a disabled span costs only a branch. Timestamps are raw
+ * rdtscp cycle counts, taken without locking; a span only takes the mutex
+ * once when it ends, to append its record. The cycle counts are converted
+ * to microseconds when the file is written, using a calibration against
+ * the steady clock over the whole recording.
+ */
+class TraceRecorder {
+ public:
+  /// Switch the recording of spans on.
+  static void enable();
+
+  /// \return whether the recording of spans is on.
+  static bool is_enabled();
+
+  /**
+   * Write all recorded spans as Chrome trace-event JSON and clear them.
+   *
+   * Does nothing if recording is disabled.
+   *
+   * \param[in] output_file Path of the JSON file.
+   */
+  static void write(const bf::path &output_file);
+
+  /**
+   * Guard that records one span from its construction to its destruction.
+   */
+  class Span {
+   public:
+    /**
+     * Start a span.
+     *
+     * \param[in] name The name shown in the timeline. Must outlive the
+     *            recording, so pass a string literal or a string member of
+     *            a long-lived object.
+     */
+    explicit Span(const char *name);
+
+    /// End the span and append its record.
+    ~Span();
+
+    /// A running span cannot be copied.
+    Span(const Span &) = delete;
+    /// A running span cannot be assigned.
+    Span &operator=(const Span &) = delete;
+
+   private:
+    /// The name shown in the timeline.
+    const char *name_;
+    /// Cycle count at the begin of the span.
+    uint64_t begin_cycles_;
+  };
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_TRACERECORDER_H_
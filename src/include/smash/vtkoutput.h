@@ -10,6 +10,8 @@
 #ifndef SRC_INCLUDE_VTKOUTPUT_H_
 #define SRC_INCLUDE_VTKOUTPUT_H_
 
+#include <array>
+#include <cstddef>
 #include <string>
 
 #include <boost/filesystem.hpp>
@@ -103,6 +105,48 @@ class VtkOutput : public OutputInterface {
   void thermodynamics_output(const GrandCanThermalizer &gct) override;
 
  private:
+  /**
+   * The portion of a lattice that is written: the index window selected by
+   * the configured region of interest and the dimensions after applying
+   * the downsampling stride.
+   */
+  struct LatticeWindow {
+    /// First node index per axis
+    std::array<int, 3> begin;
+    /// One past the last node index per axis
+    std::array<int, 3> end;
+    /// Dimensions of the downsampled output
+    std::array<int, 3> dim_out;
+  };
+
+  /**
+   * Intersect the configured region of interest with the given lattice and
+   * apply the downsampling stride.
+   *
+   * \param lat Lattice corresponding to output.
+   * \return the index window of the lattice that is written.
+   */
+  template <typename T>
+  LatticeWindow make_window(RectangularLattice<T> &lat) const;
+
+  /**
+   * Flat index of the downsampled output node that the lattice node with
+   * the given indices is averaged into.
+   *
+   * \param win The index window of the lattice that is written.
+   * \param ix x index of the lattice node.
+   * \param iy y index of the lattice node.
+   * \param iz z index of the lattice node.
+   */
+  std::size_t block_index(const LatticeWindow &win, int ix, int iy,
+                          int iz) const {
+    return (static_cast<std::size_t>((iz - win.begin[2]) / td_stride_) *
+                win.dim_out[1] +
+            (iy - win.begin[1]) / td_stride_) *
+               win.dim_out[0] +
+           (ix - win.begin[0]) / td_stride_;
+  }
+
   /**
    * Write the given particles to the output.
    *
@@ -132,10 +176,12 @@ class VtkOutput : public OutputInterface {
    *
    * \param file Output file.
    * \param lat Lattice corresponding to output.
+   * \param win The index window of the lattice that is written.
    * \param description Description of the output.
    */
   template <typename T>
   void write_vtk_header(std::ofstream &file, RectangularLattice<T> &lat,
+                        const LatticeWindow &win,
                         const std::string &description);
 
   /**
@@ -143,24 +189,28 @@ class VtkOutput : public OutputInterface {
    *
    * \param file Output file.
    * \param lat Lattice corresponding to output.
+   * \param win The index window of the lattice that is written.
    * \param varname Name of the output variable.
    * \param function Function that gets the scalar given a lattice node.
    */
   template <typename T, typename F>
   void write_vtk_scalar(std::ofstream &file, RectangularLattice<T> &lat,
-                        const std::string &varname, F &&function);
+                        const LatticeWindow &win, const std::string &varname,
+                        F &&function);
 
   /**
    * Write a VTK vector.
    *
    * \param file Output file.
    * \param lat Lattice corresponding to output.
+   * \param win The index window of the lattice that is written.
    * \param varname Name of the output variable.
    * \param function Function that gets the vector given a lattice node.
    */
   template <typename T, typename F>
   void write_vtk_vector(std::ofstream &file, RectangularLattice<T> &lat,
-                        const std::string &varname, F &&function);
+                        const LatticeWindow &win, const std::string &varname,
+                        F &&function);
 
   /// filesystem path for output
   const bf::path base_path_;
@@ -182,6 +232,22 @@ class VtkOutput : public OutputInterface {
   int vtk_fluidization_counter_ = 0;
   /// Is the VTK output a thermodynamics output
   bool is_thermodynamics_output_;
+
+  /**
+   * Use the binary encoding of the legacy VTK format instead of ASCII. The
+   * file layout (headers, sections) is identical, but the values are dumped
+   * as raw big-endian data, which is both smaller and much cheaper to write.
+   */
+  bool vtk_binary_;
+
+  /// Lower corner in fm of the written region of the lattice outputs
+  std::array<double, 3> td_region_min_;
+
+  /// Upper corner in fm of the written region of the lattice outputs
+  std::array<double, 3> td_region_max_;
+
+  /// Blocks of this many nodes per axis are averaged into one written node
+  int td_stride_;
 };
 
 }  // namespace smash
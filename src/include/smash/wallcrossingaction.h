@@ -10,6 +10,9 @@
 #ifndef SRC_INCLUDE_WALLCROSSINGACTION_H_
 #define SRC_INCLUDE_WALLCROSSINGACTION_H_
 
+#include <queue>
+#include <vector>
+
 #include "action.h"
 #include "actionfinderfactory.h"
 
@@ -46,34 +49,69 @@ class WallcrossingAction : public Action {
  * Finder for wall crossing actions, when using peridic boundary conditons.
  * Loops through all particles and checks if they cross the box wall during the
  * next timestep.
+ *
+ * Without potentials the particles move on straight lines between actions,
+ * so the crossing times are exactly computable the moment the momentum of a
+ * particle changes. With analytic scheduling enabled the finder keeps a
+ * persistent queue of precomputed crossings instead of re-examining every
+ * particle each timestep: find_scheduled_crossings() pops the crossings due
+ * in the current timestep, and find_actions_in_cell() - called for the
+ * outgoing particles of every performed action - refills the queue.
  */
 class WallCrossActionsFinder : public ActionFinderInterface {
  public:
   /**
    * Construct wallcrossing actionfinder.
    * \param[in] l Box edge length. Box is assumbed to be a cube. [fm]
+   * \param[in] analytic_schedule Whether crossings beyond the current
+   * timestep are kept in a persistent schedule instead of being discarded
+   * and recomputed. Only correct without potentials.
    */
-  explicit WallCrossActionsFinder(double l) : l_{l, l, l} {};
+  explicit WallCrossActionsFinder(double l, bool analytic_schedule = false)
+      : l_{l, l, l}, analytic_schedule_(analytic_schedule){};
 
   /**
    * Find the next wall crossings for every particle before time t_max.
+   * With analytic scheduling, crossings beyond t_max are additionally
+   * pushed onto the persistent schedule.
    * \param[in] plist List of all particles.
    * \param[in] t_max Time until crossing can appear. [fm]
    * \return List of all found wall crossings.
    */
-  ActionList find_actions_in_cell(const ParticleList &plist,
+  ActionList find_actions_in_cell(const ParticleSlice &plist,
                                   double t_max) const override;
 
+  /**
+   * Pop all scheduled crossings that are due within the current timestep.
+   * On the first call of an event the schedule is filled with the crossings
+   * of all particles; afterwards it is kept up to date by the
+   * find_actions_in_cell() calls for outgoing particles of performed
+   * actions. Crossings whose particle has changed in the meantime are
+   * dropped silently - the momentum change that invalidated them also
+   * scheduled their replacement.
+   *
+   * \param[in] particles Current particle list, used for initialization and
+   * to drop stale crossings.
+   * \param[in] now Current time of the system. [fm]
+   * \param[in] t_max Duration of the current timestep. [fm]
+   * \return List of all wall crossings within the timestep.
+   */
+  ActionList find_scheduled_crossings(const Particles &particles, double now,
+                                      double t_max);
+
+  /// Forget all scheduled crossings, e.g. at the start of a new event.
+  void reset_scheduling();
+
   /// Ignore the neighbor searches for wall crossing
-  ActionList find_actions_with_neighbors(const ParticleList &,
-                                         const ParticleList &,
+  ActionList find_actions_with_neighbors(const ParticleSlice &,
+                                         const ParticleSlice &,
                                          double) const override {
     return {};
   }
 
   /// Ignore the surrounding searches for wall crossing
   ActionList find_actions_with_surrounding_particles(const ParticleList &,
-                                                     const Particles &,
+                                                     const ParticleList &,
                                                      double) const override {
     return {};
   }
@@ -84,8 +122,56 @@ class WallCrossActionsFinder : public ActionFinderInterface {
   }
 
  private:
+  /// One analytically precomputed wall crossing.
+  struct ScheduledCrossing {
+    /// Absolute time of the crossing. [fm]
+    double time;
+    /// State of the particle when the crossing was scheduled.
+    ParticleData incoming;
+    /// The same particle with the position wrapped to the opposite wall.
+    ParticleData outgoing;
+  };
+
+  /// Orders scheduled crossings by ascending absolute time (min-heap).
+  struct MoreTime {
+    /// \return whether crossing \p a happens after crossing \p b.
+    bool operator()(const ScheduledCrossing &a,
+                    const ScheduledCrossing &b) const {
+      return a.time > b.time;
+    }
+  };
+
+  /**
+   * Compute the next wall crossing of particle \p p on its straight-line
+   * trajectory.
+   *
+   * \param[in] p The particle to examine.
+   * \param[out] time_until Time until the crossing, relative to the current
+   * time of \p p. [fm]
+   * \param[out] out Copy of \p p with the position set to the (wrapped)
+   * crossing point.
+   * \return whether the particle crosses a wall at all.
+   */
+  bool next_crossing_(const ParticleData &p, double *time_until,
+                      ParticleData *out) const;
+
   /// Periods in x,y,z directions in fm.
   const std::array<double, 3> l_;
+
+  /// Whether crossings are precomputed once per momentum change.
+  const bool analytic_schedule_;
+
+  /**
+   * The scheduled crossings, earliest on top. Mutable because
+   * find_actions_in_cell() is const in the finder interface but pushes the
+   * crossings beyond its time horizon here.
+   */
+  mutable std::priority_queue<ScheduledCrossing,
+                              std::vector<ScheduledCrossing>, MoreTime>
+      schedule_;
+
+  /// Whether the schedule was initialized for the current event.
+  bool schedule_initialized_ = false;
 };
 
 }  // namespace smash
@@ -7,14 +7,37 @@
 
 #include "smash/isoparticletype.h"
 
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "smash/filelock.h"
 #include "smash/integrate.h"
 #include "smash/kinematics.h"
 #include "smash/logging.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 
 static IsoParticleTypeList iso_type_list;
 
+/**
+ * Index from multiplet name to its position in iso_type_list. It is
+ * rebuilt lazily whenever the list has grown (which only happens during
+ * create_multiplet, i.e. while the particle table is constructed), so all
+ * later name lookups — decaymode parsing, dilepton and cross-section setup
+ * — are a single hash probe instead of a string binary search.
+ */
+static std::unordered_map<std::string, size_t> iso_name_index;
+
 IsoParticleType::IsoParticleType(const std::string &n, double m, double w,
                                  unsigned int s, Parity p)
     : name_(n), mass_(m), width_(w), spin_(s), parity_(p) {}
@@ -23,15 +46,18 @@ const IsoParticleTypeList &IsoParticleType::list_all() { return iso_type_list; }
 
 /// Helper function for IsoParticleType::try_find and friends.
 static IsoParticleType *try_find_private(const std::string &name) {
-  auto found =
-      std::lower_bound(iso_type_list.begin(), iso_type_list.end(), name,
-                       [](const IsoParticleType &l, const std::string &r) {
-                         return l.name() < r;
-                       });
-  if (found == iso_type_list.end() || found->name() != name) {
+  if (iso_name_index.size() != iso_type_list.size()) {
+    iso_name_index.clear();
+    iso_name_index.reserve(iso_type_list.size());
+    for (size_t i = 0; i < iso_type_list.size(); ++i) {
+      iso_name_index.emplace(iso_type_list[i].name(), i);
+    }
+  }
+  const auto found = iso_name_index.find(name);
+  if (found == iso_name_index.end()) {
     return {};  // The default constructor creates an invalid pointer.
   }
-  return &*found;
+  return &iso_type_list[found->second];
 }
 
 const IsoParticleType *IsoParticleType::try_find(const std::string &name) {
@@ -151,51 +177,203 @@ void IsoParticleType::create_multiplet(const ParticleType &type) {
   multiplet.add_state(type);
 }
 
-static /*thread_local (see #3075)*/ Integrator integrate;
+/* The spectral integrands are smooth except for narrow resonances, for
+ * which the fixed rule falls back to the adaptive algorithm by itself. */
+static thread_local IntegratorGaussLegendre<32> integrate;
+
+/**
+ * The directory the spectral-integral tabulations are cached in; empty if
+ * caching is disabled (the default).
+ */
+static bf::path tabulation_cache_dir;
+
+void IsoParticleType::set_tabulation_cache(const bf::path &dir,
+                                           const std::string &key) {
+  tabulation_cache_dir = dir / key;
+  bf::create_directories(tabulation_cache_dir);
+}
+
+/**
+ * Build the tabulation with \p tabulate and publish it in the cache as
+ * \p file. The table is written to a unique temporary file and renamed
+ * into place: the rename is atomic, so the many processes of a campaign
+ * can race on the same cache without anyone ever reading a half-written
+ * table.
+ *
+ * \param file Path of the tabulation inside the cache.
+ * \param tabulate Builds the tabulation.
+ */
+static TabulationPtr tabulate_and_publish(
+    const bf::path &file, const std::function<TabulationPtr()> &tabulate) {
+  TabulationPtr table = tabulate();
+  const bf::path tmp = bf::unique_path(file.native() + ".%%%%-%%%%");
+  {
+    bf::ofstream stream(tmp, std::ios::binary);
+    table->write(stream);
+  }
+  bf::rename(tmp, file);
+  return table;
+}
+
+/**
+ * Return the tabulation called \p name from the cache directory, or build
+ * it with \p tabulate and store it for later runs. Without a configured
+ * cache directory this simply tabulates.
+ *
+ * Cached tabulations are mapped shared and read-only, so all SMASH
+ * processes on a node reference one copy of the values in the page cache
+ * instead of each holding a private one. A file lock makes one process
+ * build a missing tabulation while the others wait for it to appear and
+ * then map it, instead of all of them computing the same integrals.
+ *
+ * \param name Unique name of the tabulation inside the cache.
+ * \param tabulate Builds the tabulation on a cache miss.
+ */
+static TabulationPtr load_or_tabulate(
+    const std::string &name, const std::function<TabulationPtr()> &tabulate) {
+  if (tabulation_cache_dir.empty()) {
+    return tabulate();
+  }
+  const bf::path file = tabulation_cache_dir / (name + ".tab");
+  /* Waiting on the builder is bounded so that a crashed process that left
+   * its lock file behind cannot stall a whole campaign; after the timeout
+   * the table is simply built privately like before. */
+  const auto poll_interval = std::chrono::milliseconds(50);
+  const int max_polls = 600 * 20;  // 10 minutes
+  for (int polls = 0; polls < max_polls; ++polls) {
+    if (bf::exists(file)) {
+      auto table = Tabulation::map_file(file.native());
+      if (table != nullptr) {
+        return table;
+      }
+      const auto &log = logger<LogArea::ParticleType>();
+      log.warn() << "Discarding truncated cached tabulation \""
+                 << file.native() << "\", rebuilding it.";
+      break;
+    }
+    FileLock lock(bf::path(file.native() + ".lock"));
+    if (lock.acquire()) {
+      // Double check: the builder may have finished while we raced it.
+      if (bf::exists(file)) {
+        auto table = Tabulation::map_file(file.native());
+        if (table != nullptr) {
+          return table;
+        }
+      }
+      TabulationPtr table = tabulate_and_publish(file, tabulate);
+      /* Prefer the mapped copy of the freshly published file over the
+       * private one, so the builder shares the pages as well. */
+      auto mapped = Tabulation::map_file(file.native());
+      return mapped != nullptr ? std::move(mapped) : std::move(table);
+    }
+    std::this_thread::sleep_for(poll_interval);
+  }
+  return tabulate_and_publish(file, tabulate);
+}
+
+/* Protects the lazy initialization of the spectral-integral tabulations
+ * below when several event threads request them concurrently. After a
+ * tabulation has been created it is only read, which needs no lock. Most
+ * tabulations are built up front by tabulate_integrals(), where every
+ * multiplet is handled by one task and no lock is needed. */
+static std::mutex tabulation_mutex;
+
+void IsoParticleType::tabulate_nr() {
+  ParticleTypePtr type_res = states_[0];
+  ParticleTypePtr nuc = IsoParticleType::find("N").get_states()[0];
+  XS_NR_tabulation_ = load_or_tabulate("NR_" + name_, [&]() {
+    return spectral_integral_semistable(integrate, *type_res, *nuc, 2.0);
+  });
+}
+
+void IsoParticleType::tabulate_pir() {
+  ParticleTypePtr type_res = states_[0];
+  ParticleTypePtr pion = IsoParticleType::find("π").get_states()[0];
+  XS_piR_tabulation_ = load_or_tabulate("piR_" + name_, [&]() {
+    return spectral_integral_semistable(integrate, *type_res, *pion, 2.0);
+  });
+}
+
+void IsoParticleType::tabulate_rk() {
+  ParticleTypePtr type_res = states_[0];
+  ParticleTypePtr kaon = IsoParticleType::find("K").get_states()[0];
+  XS_RK_tabulation_ = load_or_tabulate("RK_" + name_, [&]() {
+    return spectral_integral_semistable(integrate, *type_res, *kaon, 2.0);
+  });
+}
+
+void IsoParticleType::tabulate_integrals() {
+  ThreadPool *const pool = shared_pool();
+  if (pool == nullptr) {
+    /* Without the shared pool the tabulations are cheaper to build lazily,
+     * because a run might never request some of them. */
+    return;
+  }
+  /* The tabulations of different multiplets are independent, so every
+   * multiplet is one task and the startup time shrinks towards the longest
+   * single table. */
+  std::vector<IsoParticleType *> multiplets;
+  for (auto &multiplet : iso_type_list) {
+    const ParticleTypePtr res = multiplet.states_[0];
+    if (!res->is_stable() && res->baryon_number() >= 1) {
+      multiplets.push_back(&multiplet);
+    }
+  }
+  IsoParticleType *delta_multiplet = try_find_private("Δ");
+  pool->parallel_range(multiplets.size(), [&](size_t i) {
+    IsoParticleType *multiplet = multiplets[i];
+    multiplet->tabulate_nr();
+    if (multiplet->states_[0]->baryon_number() > 1) {
+      // Only the unstable light nuclei (d') appear in πd -> πd'.
+      multiplet->tabulate_pir();
+    } else {
+      multiplet->tabulate_rk();
+      if (delta_multiplet) {
+        /* The NN -> ΔR channels need the RR' tabulation with the Δ
+         * multiplet; other pairings stay lazy. */
+        ParticleTypePtr delta_state = delta_multiplet->get_states()[0];
+        multiplet->XS_RR_tabulations.emplace(
+            delta_multiplet, multiplet->integrate_RR(delta_state));
+      }
+    }
+  });
+}
 
 double IsoParticleType::get_integral_NR(double sqrts) {
   if (XS_NR_tabulation_ == nullptr) {
-    // initialize tabulation
-    /* TODO(weil): Move this lazy init to a global initialization function,
-     * in order to avoid race conditions in multi-threading. */
-    ParticleTypePtr type_res = states_[0];
-    ParticleTypePtr nuc = IsoParticleType::find("N").get_states()[0];
-    XS_NR_tabulation_ =
-        spectral_integral_semistable(integrate, *type_res, *nuc, 2.0);
+    std::lock_guard<std::mutex> guard(tabulation_mutex);
+    if (XS_NR_tabulation_ == nullptr) {
+      tabulate_nr();
+    }
   }
   return XS_NR_tabulation_->get_value_linear(sqrts);
 }
 
 double IsoParticleType::get_integral_piR(double sqrts) {
   if (XS_piR_tabulation_ == nullptr) {
-    // initialize tabulation
-    /* TODO(weil): Move this lazy init to a global initialization function,
-     * in order to avoid race conditions in multi-threading. */
-    ParticleTypePtr type_res = states_[0];
-    ParticleTypePtr pion = IsoParticleType::find("π").get_states()[0];
-    XS_piR_tabulation_ =
-        spectral_integral_semistable(integrate, *type_res, *pion, 2.0);
+    std::lock_guard<std::mutex> guard(tabulation_mutex);
+    if (XS_piR_tabulation_ == nullptr) {
+      tabulate_pir();
+    }
   }
   return XS_piR_tabulation_->get_value_linear(sqrts);
 }
 
 double IsoParticleType::get_integral_RK(double sqrts) {
   if (XS_RK_tabulation_ == nullptr) {
-    // initialize tabulation
-    /* TODO(weil): Move this lazy init to a global initialization function,
-     * in order to avoid race conditions in multi-threading. */
-    ParticleTypePtr type_res = states_[0];
-    ParticleTypePtr kaon = IsoParticleType::find("K").get_states()[0];
-    XS_RK_tabulation_ =
-        spectral_integral_semistable(integrate, *type_res, *kaon, 2.0);
+    std::lock_guard<std::mutex> guard(tabulation_mutex);
+    if (XS_RK_tabulation_ == nullptr) {
+      tabulate_rk();
+    }
   }
   return XS_RK_tabulation_->get_value_linear(sqrts);
 }
 
-static /*thread_local (see #3075)*/ Integrator2dCuhre integrate2d;
+static thread_local Integrator2dCuhre integrate2d;
 
 double IsoParticleType::get_integral_RR(const ParticleType &type_res_2,
                                         double sqrts) {
+  std::lock_guard<std::mutex> guard(tabulation_mutex);
   auto search = XS_RR_tabulations.find(find(type_res_2));
   if (search != XS_RR_tabulations.end()) {
     return search->second->get_value_linear(sqrts);
@@ -208,16 +386,18 @@ double IsoParticleType::get_integral_RR(const ParticleType &type_res_2,
 
 TabulationPtr IsoParticleType::integrate_RR(ParticleTypePtr &res2) {
   ParticleTypePtr res1 = states_[0];
-  const double m1_min = res1->min_mass_kinematic();
-  const double m2_min = res2->min_mass_kinematic();
-  return make_unique<Tabulation>(m1_min + m2_min, 3., 125, [&](double srts) {
-    const double m1_max = srts - m2_min;
-    const double m2_max = srts - m1_min;
-    const auto result =
-        integrate2d(m1_min, m1_max, m2_min, m2_max, [&](double m1, double m2) {
-          return spec_func_integrand_2res(srts, m1, m2, *res1, *res2);
-        });
-    return result.value();
+  return load_or_tabulate("RR_" + name_ + "_" + find(*res2)->name(), [&]() {
+    const double m1_min = res1->min_mass_kinematic();
+    const double m2_min = res2->min_mass_kinematic();
+    return make_unique<Tabulation>(m1_min + m2_min, 3., 125, [&](double srts) {
+      const double m1_max = srts - m2_min;
+      const double m2_max = srts - m1_min;
+      const auto result = integrate2d(
+          m1_min, m1_max, m2_min, m2_max, [&](double m1, double m2) {
+            return spec_func_integrand_2res(srts, m1, m2, *res1, *res2);
+          });
+      return result.value();
+    });
   });
 }
 
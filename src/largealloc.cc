@@ -0,0 +1,140 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/largealloc.h"
+
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+#endif
+
+namespace smash {
+
+namespace {
+
+/**
+ * Blocks of at least this size go through the mapped path; this is the
+ * (usual) size of one hugepage, smaller blocks cannot profit from one.
+ */
+constexpr std::size_t large_threshold = 2 * 1024 * 1024;
+
+/// The NUMA policy applied to subsequent large allocations.
+MemoryPolicy current_policy = MemoryPolicy::Default;
+
+#ifdef __linux__
+
+/**
+ * \return a bitmask of the online NUMA nodes, parsed from sysfs
+ * (e.g. "0-1,4"). Limited to the first 64 nodes, which covers any
+ * machine SMASH runs on.
+ */
+unsigned long online_node_mask() {
+  unsigned long mask = 0;
+  std::ifstream online("/sys/devices/system/node/online");
+  int first = -1;
+  char separator = ',';
+  int node;
+  while (online >> node) {
+    if (separator == '-' && first >= 0) {
+      for (int i = first; i <= node && i < 64; i++) {
+        mask |= 1ul << i;
+      }
+    } else if (node < 64) {
+      mask |= 1ul << node;
+    }
+    first = node;
+    if (!(online >> separator)) {
+      break;
+    }
+  }
+  return mask != 0 ? mask : 1ul;
+}
+
+/**
+ * Apply the configured NUMA policy to the mapping at \p address.
+ *
+ * Uses the raw mbind system call so that SMASH does not grow a libnuma
+ * dependency for two call sites. Failures are ignored, the policy is
+ * advisory.
+ *
+ * \param[in] address Start of the mapping.
+ * \param[in] length Length of the mapping.
+ */
+void apply_numa_policy(void *address, std::size_t length) {
+#ifdef SYS_mbind
+  /* Values from linux/mempolicy.h, which is not available through a
+   * portable header. */
+  constexpr int mpol_preferred = 1;
+  constexpr int mpol_interleave = 3;
+  switch (current_policy) {
+    case MemoryPolicy::Interleave: {
+      static const unsigned long mask = online_node_mask();
+      syscall(SYS_mbind, address, length, mpol_interleave, &mask,
+              sizeof(mask) * 8, 0);
+      break;
+    }
+    case MemoryPolicy::Local:
+      /* An empty node mask makes the preferred node the local one. */
+      syscall(SYS_mbind, address, length, mpol_preferred, nullptr, 0, 0);
+      break;
+    case MemoryPolicy::Default:
+      break;
+  }
+#else
+  (void)address;
+  (void)length;
+#endif
+}
+
+#endif  // __linux__
+
+}  // unnamed namespace
+
+void LargeAlloc::set_policy(MemoryPolicy policy) { current_policy = policy; }
+
+void *LargeAlloc::allocate(std::size_t bytes) {
+#ifdef __linux__
+  if (bytes >= large_threshold) {
+    void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
+    apply_numa_policy(memory, bytes);
+    return memory;
+  }
+#endif
+  return ::operator new(bytes);
+}
+
+void LargeAlloc::deallocate(void *ptr, std::size_t bytes) {
+  if (ptr == nullptr) {
+    return;
+  }
+#ifdef __linux__
+  if (bytes >= large_threshold) {
+    munmap(ptr, bytes);
+    return;
+  }
+#else
+  (void)bytes;
+#endif
+  ::operator delete(ptr);
+}
+
+}  // namespace smash
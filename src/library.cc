@@ -0,0 +1,67 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/library.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "smash/decaymodes.h"
+#include "smash/experiment.h"
+#include "smash/isoparticletype.h"
+#include "smash/particletype.h"
+#include "smash/threadpool.h"
+
+namespace smash {
+
+namespace {
+
+/// Whether SmashContext::initialize has completed.
+bool context_initialized = false;
+
+}  // unnamed namespace
+
+const SmashContext &SmashContext::initialize(const std::string &particles,
+                                             const std::string &decaymodes,
+                                             int num_threads) {
+  if (context_initialized) {
+    throw std::logic_error(
+        "SmashContext::initialize may only be called once per process.");
+  }
+  ParticleType::create_type_list(particles);
+  DecayModes::load_decaymodes(decaymodes);
+  ParticleType::check_consistency();
+  initialize_shared_pool(num_threads);
+  /* Building all spectral-integral tabulations up front (instead of lazily
+   * at the first collision of each kind) makes the experiments created
+   * later read-only consumers of the context. */
+  IsoParticleType::tabulate_integrals();
+  context_initialized = true;
+  return instance();
+}
+
+const SmashContext &SmashContext::instance() {
+  if (!context_initialized) {
+    throw std::logic_error(
+        "SmashContext::instance was called before initialize.");
+  }
+  static SmashContext context;
+  return context;
+}
+
+ExperimentPtr SmashContext::create_experiment(Configuration config,
+                                              const bf::path &output_path,
+                                              int64_t seed) const {
+  if (seed >= 0) {
+    config["General"]["Randomseed"] = seed;
+  }
+  return ExperimentBase::create(std::move(config), output_path);
+}
+
+}  // namespace smash
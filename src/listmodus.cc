@@ -9,9 +9,13 @@
 
 #include "smash/listmodus.h"
 
+#include <algorithm>
+#include <cinttypes>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <list>
 #include <map>
@@ -28,6 +32,7 @@
 #include "smash/constants.h"
 #include "smash/distributions.h"
 #include "smash/experimentparameters.h"
+#include "smash/file.h"
 #include "smash/fourvector.h"
 #include "smash/inputfunctions.h"
 #include "smash/logging.h"
@@ -56,6 +61,11 @@ namespace smash {
  * \key Shift_Id (int, required):\n
  * Starting id for file_id_, i.e. the first file which is read.
  *
+ * \key First_Event (int, optional, default = 0):\n
+ * Number of events to skip at the beginning of the file set before the
+ * first one is read. Together with \key Shift_Id this allows several SMASH
+ * instances to process disjoint slices of one large set of input files.
+ *
  * \n
  * Example: Configuring an Afterburner Simulation
  * --------------
@@ -103,6 +113,25 @@ namespace smash {
  * the first event (and also for the second event).
  *
  * \n
+ * Binary input
+ * --------------
+ * Particle files in the uncompressed \ref format_binary_ "SMASH binary
+ * format", as written by the binary particles output, are detected
+ * automatically by their magic number and can be mixed freely with text
+ * files in one file set. For each event the last particle block before the
+ * event-end marker is used, i.e. the final state of the event. This allows
+ * a SMASH-to-SMASH or hydro-to-SMASH handoff without going through text.
+ *
+ * \n
+ * The first time a particle file is read, SMASH saves a small sidecar index
+ * "(file).idx" next to it that records the byte offsets of the events.
+ * Later runs — in particular event-parallel afterburner jobs that use
+ * \key First_Event — use the index to seek directly to their events
+ * instead of scanning the file from the top. The index is rebuilt
+ * automatically when the particle file changes; if the directory is not
+ * writable, it is simply not saved.
+ *
+ * \n
  * \note
  * SMASH is shipped with an example configuration file to set up an afterburner
  * simulation by means of the list modus. This also requires a particle list to
@@ -129,7 +158,117 @@ ListModus::ListModus(Configuration modus_config, const ExperimentParameters &)
 
   event_id_ = 0;
   file_id_ = shift_id_;
+  events_to_skip_ = modus_config.take({"List", "First_Event"}, 0);
+}
+
+namespace {
+/// First line of a list-modus sidecar index file (followed by size and hash).
+constexpr char index_magic[] = "# SMASH list index 1";
+
+/// Size of a default binary particle line: 9 doubles, pdg, ID and charge
+/// (see \ref format_binary_).
+constexpr std::size_t binary_record_size =
+    9 * sizeof(double) + 3 * sizeof(int32_t);
+
+/// Additional size of an extended binary particle line: ncoll, form_time,
+/// xsecfac, proc_id_origin, proc_type_origin, time_last_coll and the two
+/// mother pdg codes.
+constexpr std::size_t binary_extended_extra =
+    3 * sizeof(double) + 3 * sizeof(int32_t) + 2 * sizeof(uint32_t);
+
+/**
+ * Copies one value of type \p T out of a binary particle list and advances
+ * the read position. memcpy is used because the mapped data has no
+ * alignment guarantees.
+ *
+ * \param[inout] pos The read position, advanced by sizeof(T).
+ * \return The value read.
+ */
+template <typename T>
+T read_binary_value(const char *&pos) {
+  T value;
+  std::memcpy(&value, pos, sizeof(T));
+  pos += sizeof(T);
+  return value;
+}
+
+/**
+ * \return a hash over the size and the first and last kilobyte of the
+ * mapped file \p file, used to detect stale sidecar index files after the
+ * particle file has been replaced.
+ */
+uint64_t index_checksum(const MappedFile &file) {
+  // FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ull;
+  const auto mix = [&hash](const char *pos, const char *end) {
+    for (; pos < end; ++pos) {
+      hash = (hash ^ static_cast<unsigned char>(*pos)) * 0x100000001b3ull;
+    }
+  };
+  const std::size_t probe = std::min(file.size(), std::size_t{1024});
+  mix(file.begin(), file.begin() + probe);
+  mix(file.end() - probe, file.end());
+  return hash ^ file.size();
+}
+
+/**
+ * Parses one line of an external particle list without copying it into a
+ * stream first.
+ *
+ * The caller guarantees that the byte at \p end cannot extend a number (it
+ * is a newline, a comment sign or a terminating null character), because
+ * std::strtod does not know about \p end and would otherwise read on.
+ *
+ * \param[in] pos Beginning of the line.
+ * \param[in] end End of the line (exclusive).
+ * \param[out] value The nine floating-point columns t x y z mass E px py pz.
+ * \param[out] pdg_string The PDG code column.
+ * \param[out] id The particle id column.
+ * \param[out] charge The charge column.
+ * \return whether all twelve columns were converted successfully.
+ */
+bool parse_particle_line(const char *pos, const char *end, double (&value)[9],
+                         std::string &pdg_string, int &id, int &charge) {
+  const auto skip_blanks = [&pos, end]() {
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {
+      ++pos;
+    }
+  };
+  char *number_end = nullptr;
+  for (double &v : value) {
+    skip_blanks();
+    if (pos >= end) {
+      return false;
+    }
+    v = std::strtod(pos, &number_end);
+    if (number_end == pos) {
+      return false;
+    }
+    pos = number_end;
+  }
+  skip_blanks();
+  const char *const token_begin = pos;
+  while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\r') {
+    ++pos;
+  }
+  if (pos == token_begin) {
+    return false;
+  }
+  pdg_string.assign(token_begin, pos);
+  for (int *integer : {&id, &charge}) {
+    skip_blanks();
+    if (pos >= end) {
+      return false;
+    }
+    *integer = std::strtol(pos, &number_end, 10);
+    if (number_end == pos) {
+      return false;
+    }
+    pos = number_end;
+  }
+  return true;
 }
+}  // unnamed namespace
 
 /* console output on startup of List specific parameters */
 std::ostream &operator<<(std::ostream &out, const ListModus &m) {
@@ -231,31 +370,109 @@ void ListModus::try_create_particle(Particles &particles, PdgCode pdgcode,
 double ListModus::initial_conditions(Particles *particles,
                                      const ExperimentParameters &) {
   const auto &log = logger<LogArea::List>();
-  std::string particle_list = next_event_();
+  advance_to_next_event_();
+  const auto &range = event_offsets_[next_event_in_file_];
+  next_event_in_file_++;
+
+  if (current_file_is_binary_) {
+    const std::size_t record_size =
+        binary_record_size + (binary_extended_ ? binary_extended_extra : 0);
+    const char *pos = current_file_.begin() + range.first;
+    const std::size_t n_particles = (range.second - range.first) / record_size;
+    for (std::size_t i = 0; i < n_particles; i++) {
+      double value[9];
+      for (double &v : value) {
+        v = read_binary_value<double>(pos);
+      }
+      const int32_t pdg_decimal = read_binary_value<int32_t>(pos);
+      read_binary_value<int32_t>(pos);  // the particle id is not used
+      const int32_t charge = read_binary_value<int32_t>(pos);
+      if (binary_extended_) {
+        pos += binary_extended_extra;
+      }
+      /* The unchecked conversion skips the per-code validation, which
+       * adds up over multi-gigabyte list files. Malformed codes are still
+       * caught: they fail the charge consistency check below or the
+       * particle-type lookup in try_create_particle. */
+      const PdgCode pdgcode = PdgCode::from_decimal_unchecked(pdg_decimal);
+      log.debug("Particle ", pdgcode, " (x,y,z)= (", value[1], ", ", value[2],
+                ", ", value[3], ")");
+
+      // Charge consistency check
+      if (pdgcode.charge() != charge) {
+        log.error() << "Charge of pdg = " << pdgcode << " != " << charge;
+        throw std::invalid_argument("Inconsistent input (charge).");
+      }
+      try_create_particle(*particles, pdgcode, value[0], value[1], value[2],
+                          value[3], value[4], value[5], value[6], value[7],
+                          value[8]);
+    }
+    backpropagate_to_same_time(*particles);
+    event_id_++;
+
+    return start_time_;
+  }
 
-  for (const Line &line : line_parser(particle_list)) {
-    std::istringstream lineinput(line.text);
-    double t, x, y, z, mass, E, px, py, pz;
+  /* Parse the particle lines directly from the mapped file, without
+   * copying the event into a string and a stream first. */
+  const char *pos = current_file_.begin() + range.first;
+  const char *const event_end = current_file_.begin() + range.second;
+  int line_number = 0;
+  std::string pdg_string;
+  while (pos < event_end) {
+    const char *const newline =
+        static_cast<const char *>(std::memchr(pos, '\n', event_end - pos));
+    const char *const line_begin = pos;
+    const char *const line_end = newline ? newline : event_end;
+    pos = newline ? newline + 1 : event_end;
+    line_number++;
+    /* Everything from a comment sign on is ignored, as in line_parser. */
+    const char *parse_end = static_cast<const char *>(
+        std::memchr(line_begin, '#', line_end - line_begin));
+    if (parse_end == nullptr) {
+      parse_end = line_end;
+    }
+    const char *cursor = line_begin;
+    while (cursor < parse_end &&
+           (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+      ++cursor;
+    }
+    if (cursor == parse_end) {
+      // Only whitespace (or a comment) on this line. Next, please.
+      continue;
+    }
+    double value[9];
     int id, charge;
-    std::string pdg_string;
-    lineinput >> t >> x >> y >> z >> mass >> E >> px >> py >> pz >>
-        pdg_string >> id >> charge;
-    if (lineinput.fail()) {
-      throw LoadFailure(
-          build_error_string("While loading external particle lists data:\n"
-                             "Failed to convert the input string to the "
-                             "expected data types.",
-                             line));
+    bool converted;
+    if (parse_end == current_file_.end()) {
+      /* The mapping is not null-terminated, so the final line of a file
+       * that does not end in a newline must be parsed from a copy. */
+      const std::string tail(line_begin, parse_end);
+      converted = parse_particle_line(tail.c_str(), tail.c_str() + tail.size(),
+                                      value, pdg_string, id, charge);
+    } else {
+      converted = parse_particle_line(line_begin, parse_end, value, pdg_string,
+                                      id, charge);
+    }
+    if (!converted) {
+      throw LoadFailure(build_error_string(
+          "While loading external particle lists data:\n"
+          "Failed to convert the input string to the "
+          "expected data types.",
+          Line(line_number, std::string(line_begin, parse_end))));
     }
     PdgCode pdgcode(pdg_string);
-    log.debug("Particle ", pdgcode, " (x,y,z)= (", x, ", ", y, ", ", z, ")");
+    log.debug("Particle ", pdgcode, " (x,y,z)= (", value[1], ", ", value[2],
+              ", ", value[3], ")");
 
     // Charge consistency check
     if (pdgcode.charge() != charge) {
       log.error() << "Charge of pdg = " << pdgcode << " != " << charge;
       throw std::invalid_argument("Inconsistent input (charge).");
     }
-    try_create_particle(*particles, pdgcode, t, x, y, z, mass, E, px, py, pz);
+    try_create_particle(*particles, pdgcode, value[0], value[1], value[2],
+                        value[3], value[4], value[5], value[6], value[7],
+                        value[8]);
   }
   backpropagate_to_same_time(*particles);
   event_id_++;
@@ -290,77 +507,181 @@ bf::path ListModus::file_path_(const int file_id) {
   return fpath;
 }
 
-std::string ListModus::next_event_() {
-  const auto &log = logger<LogArea::List>();
-
-  const bf::path fpath = file_path_(file_id_);
-  bf::ifstream ifs{fpath};
-  ifs.seekg(last_read_position_);
-
-  if (!file_has_events_(fpath, last_read_position_)) {
-    // current file out of events. get next file and call this function
-    // recursively.
+void ListModus::advance_to_next_event_() {
+  while (next_event_in_file_ >= event_offsets_.size()) {
+    const bf::path fpath = file_path_(file_id_);
+    current_file_ = MappedFile(fpath);
+    load_or_build_index_(fpath);
     file_id_++;
-    last_read_position_ = 0;
-    ifs.close();
-    return next_event_();
+    next_event_in_file_ = 0;
+    if (events_to_skip_ >= static_cast<int>(event_offsets_.size())) {
+      /* The whole file is skipped; the loop continues with the next one. */
+      events_to_skip_ -= event_offsets_.size();
+      event_offsets_.clear();
+    } else {
+      next_event_in_file_ = events_to_skip_;
+      events_to_skip_ = 0;
+    }
   }
+}
 
-  // read one event. events marked by line # event end i in case of Oscar
-  // output. Assume one event per file for all other output formats
-  std::string event_string;
-  const std::string needle = "end";
-  std::string line;
-  while (getline(ifs, line)) {
-    if (line.find(needle) == std::string::npos) {
-      event_string += line + "\n";
-    } else {
-      break;
+void ListModus::load_or_build_index_(const bf::path &fpath) {
+  event_offsets_.clear();
+  bf::path index_path = fpath;
+  index_path += ".idx";
+  const uint64_t checksum = index_checksum(current_file_);
+
+  /* Binary particle lists are recognized by the magic number of the file
+   * header; everything else is read as text. The compressed binary format
+   * starts with the gzip magic instead and is not supported here. */
+  current_file_is_binary_ =
+      current_file_.size() >= 12 &&
+      std::memcmp(current_file_.begin(), "SMSH", 4) == 0;
+  std::size_t binary_header_size = 0;
+  if (current_file_is_binary_) {
+    const char *pos = current_file_.begin() + 4;
+    read_binary_value<uint16_t>(pos);  // format version
+    const uint16_t format_variant = read_binary_value<uint16_t>(pos);
+    const uint32_t version_length = read_binary_value<uint32_t>(pos);
+    binary_header_size = 12 + version_length;
+    if (format_variant > 1 || binary_header_size > current_file_.size()) {
+      throw LoadFailure("Corrupt binary particle list " + fpath.native());
     }
+    binary_extended_ = (format_variant == 1);
   }
 
-  if (!ifs.eof() && (ifs.fail() || ifs.bad())) {
-    log.fatal() << "Error while reading " << fpath.filename().native();
-    throw std::runtime_error("Error while reading external particle list");
+  {  // Try the sidecar index saved by an earlier run.
+    bf::ifstream index_file{index_path};
+    std::string magic_line;
+    if (index_file && std::getline(index_file, magic_line)) {
+      std::istringstream header(magic_line);
+      std::string hash_sign, name, word_list, word_index;
+      int version = 0;
+      std::size_t size = 0;
+      uint64_t stored_checksum = 0;
+      header >> hash_sign >> name >> word_list >> word_index >> version >>
+          size >> stored_checksum;
+      if (!header.fail() && hash_sign == "#" && name == "SMASH" &&
+          word_list == "list" && word_index == "index" && version == 1 &&
+          size == current_file_.size() && stored_checksum == checksum) {
+        std::size_t begin, end;
+        bool valid = true;
+        while (index_file >> begin >> end) {
+          if (begin > end || end > current_file_.size()) {
+            valid = false;
+            break;
+          }
+          event_offsets_.emplace_back(begin, end);
+        }
+        if (valid && index_file.eof()) {
+          return;
+        }
+        event_offsets_.clear();
+      }
+    }
   }
-  // save position for next event read
-  last_read_position_ = ifs.tellg();
-  ifs.close();
 
-  return event_string;
-}
+  if (current_file_is_binary_) {
+    /* Scan the block structure: every 'p' block is a particle snapshot and
+     * 'f' closes an event. The snapshot handed to the afterburner is the
+     * last one before the event end, which is the final state also for
+     * files written with Only_Final: False. */
+    const std::size_t record_size =
+        binary_record_size + (binary_extended_ ? binary_extended_extra : 0);
+    const char *const file_begin = current_file_.begin();
+    const char *const end_of_file = current_file_.end();
+    const char *position = file_begin + binary_header_size;
+    std::size_t block_begin = 0, block_end = 0;
+    while (position < end_of_file) {
+      const char tag = *position++;
+      if (tag == 'p') {
+        if (end_of_file - position < 4) {
+          throw LoadFailure("Corrupt binary particle list " + fpath.native());
+        }
+        const uint32_t n_particles = read_binary_value<uint32_t>(position);
+        if (static_cast<std::size_t>(end_of_file - position) <
+            n_particles * record_size) {
+          throw LoadFailure("Corrupt binary particle list " + fpath.native());
+        }
+        block_begin = position - file_begin;
+        position += n_particles * record_size;
+        block_end = position - file_begin;
+      } else if (tag == 'f') {
+        // the event number and the impact parameter are not used
+        if (end_of_file - position < 12) {
+          throw LoadFailure("Corrupt binary particle list " + fpath.native());
+        }
+        position += 12;
+        event_offsets_.emplace_back(block_begin, block_end);
+        block_begin = block_end = 0;
+      } else {
+        throw LoadFailure("Unsupported block '" + std::string(1, tag) +
+                          "' in binary particle list " + fpath.native());
+      }
+    }
+  } else {
+    scan_text_file_();
+  }
 
-bool ListModus::file_has_events_(bf::path filepath,
-                                 std::streampos last_position) {
-  const auto &log = logger<LogArea::List>();
-  bf::ifstream ifs{filepath};
-  std::string line;
+  save_index_(index_path, checksum);
+  return;
+}
 
-  // last event read read at end of file. we know this because errors are
-  // handled in next_event
-  if (last_position == -1) {
-    return false;
+void ListModus::scan_text_file_() {
+  /* Scan the mapped file. Every line containing "end" closes an event (the
+   * event markers of the Oscar formats); the content after the last marker
+   * - or the whole file when there is no marker at all, as for hydro output
+   * - forms one final event if it contains at least one data line. */
+  const char *const begin = current_file_.begin();
+  const char *const file_end = current_file_.end();
+  const char *pos = begin;
+  std::size_t event_begin = 0;
+  bool event_has_data = false;
+  static const char needle[] = "end";
+  while (pos < file_end) {
+    const char *const newline =
+        static_cast<const char *>(std::memchr(pos, '\n', file_end - pos));
+    const char *const line_begin = pos;
+    const char *const line_end = newline ? newline : file_end;
+    pos = newline ? newline + 1 : file_end;
+    if (std::search(line_begin, line_end, needle, needle + 3) != line_end) {
+      event_offsets_.emplace_back(event_begin, line_begin - begin);
+      event_begin = pos - begin;
+      event_has_data = false;
+    } else if (!event_has_data) {
+      const char *cursor = line_begin;
+      while (cursor < line_end &&
+             (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+        ++cursor;
+      }
+      event_has_data = (cursor != line_end && *cursor != '#');
+    }
   }
-  ifs.seekg(last_position);
-  // skip over comment lines, assume that a max. of four consecutive comment
-  // lines can occur
-  int skipped_lines = 0;
-  const int max_comment_lines = 4;
-  while (std::getline(ifs, line) && line[0] != '#' &&
-         skipped_lines++ < max_comment_lines) {
+  if (event_has_data) {
+    event_offsets_.emplace_back(event_begin, current_file_.size());
   }
+}
 
-  if (ifs.eof()) {
-    return false;
+void ListModus::save_index_(const bf::path &index_path,
+                            const uint64_t checksum) {
+  /* Saving the index can fail in a read-only directory, which is not an
+   * error - the next run will simply scan again. */
+  bf::path unfinished = index_path;
+  unfinished += ".unfinished";
+  FilePtr index_out = fopen(unfinished, "w");
+  if (!index_out) {
+    return;
   }
-
-  if (!ifs.good()) {
-    log.fatal() << "Error while reading " << filepath.filename().native();
-    throw std::runtime_error("Error while reading external particle list");
+  std::fprintf(index_out.get(), "%s %zu %" PRIu64 "\n", index_magic,
+               current_file_.size(), checksum);
+  for (const auto &range : event_offsets_) {
+    std::fprintf(index_out.get(), "%zu %zu\n", range.first, range.second);
   }
-
-  ifs.close();
-  return true;
+  index_out.reset();
+  /* The rename makes the index appear atomically, so a concurrent job never
+   * sees a partially written file. */
+  boost::system::error_code ec;
+  bf::rename(unfinished, index_path, ec);
 }
 
 }  // namespace smash
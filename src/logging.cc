@@ -29,10 +29,10 @@ void set_default_loglevel(einhard::LogLevel level) {
  * An array that stores all pre-configured Logger objects. The objects can be
  * accessed via the logger function.
  */
-static std::array<einhard::Logger<>, std::tuple_size<LogArea::AreaTuple>::value>
+static std::array<Logger, std::tuple_size<LogArea::AreaTuple>::value>
     global_logger_collection;
 
-einhard::Logger<> &retrieve_logger_impl(int id) {
+Logger &retrieve_logger_impl(int id) {
   return global_logger_collection[id];
 }
 
@@ -0,0 +1,102 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/memorypool.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace smash {
+namespace memory_pool {
+namespace {
+
+/// Size buckets are multiples of this (a cache line).
+constexpr std::size_t pool_granularity = 64;
+/// Number of size buckets; larger allocations fall back to the heap.
+constexpr std::size_t pool_num_buckets = 16;
+/// Every block starts with its bucket number, padded to keep alignment.
+constexpr std::size_t pool_header_size = alignof(std::max_align_t);
+/// Granularity of the allocations the pool requests from the system.
+constexpr std::size_t pool_chunk_size = 64 * 1024;
+
+/// A returned block, threaded onto the free list of its bucket.
+struct PoolFreeBlock {
+  /// The next free block of the same bucket.
+  PoolFreeBlock *next;
+};
+
+/// Guards pool_chunks.
+std::mutex pool_chunks_mutex;
+/// Owns the backing memory of all threads' free lists.
+std::vector<std::unique_ptr<char[]>> pool_chunks;
+
+/// The per-thread state of the pool.
+struct ThreadPoolState {
+  /// One free list per size bucket.
+  std::array<PoolFreeBlock *, pool_num_buckets> free_lists = {{}};
+  /// Start of the not yet carved-up part of the newest chunk.
+  char *unused_begin = nullptr;
+  /// Size of the not yet carved-up part of the newest chunk.
+  std::size_t unused_size = 0;
+};
+thread_local ThreadPoolState pool_state;
+
+}  // unnamed namespace
+
+void *allocate(std::size_t size) {
+  const std::size_t rounded =
+      (size + pool_granularity - 1) / pool_granularity * pool_granularity;
+  const std::size_t bucket = rounded / pool_granularity - 1;
+  char *memory;
+  if (bucket >= pool_num_buckets) {
+    // An unexpectedly large object. Leave it to the general-purpose heap.
+    memory = static_cast<char *>(::operator new(pool_header_size + size));
+    *reinterpret_cast<std::size_t *>(memory) = pool_num_buckets;
+    return memory + pool_header_size;
+  }
+  PoolFreeBlock *&free_list = pool_state.free_lists[bucket];
+  if (free_list != nullptr) {
+    memory = reinterpret_cast<char *>(free_list);
+    free_list = free_list->next;
+  } else {
+    const std::size_t bytes = pool_header_size + rounded;
+    if (pool_state.unused_size < bytes) {
+      std::unique_ptr<char[]> chunk(new char[pool_chunk_size]);
+      pool_state.unused_begin = chunk.get();
+      pool_state.unused_size = pool_chunk_size;
+      std::lock_guard<std::mutex> guard(pool_chunks_mutex);
+      pool_chunks.emplace_back(std::move(chunk));
+    }
+    memory = pool_state.unused_begin;
+    pool_state.unused_begin += bytes;
+    pool_state.unused_size -= bytes;
+  }
+  *reinterpret_cast<std::size_t *>(memory) = bucket;
+  return memory + pool_header_size;
+}
+
+void deallocate(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  char *memory = static_cast<char *>(ptr) - pool_header_size;
+  const std::size_t bucket = *reinterpret_cast<std::size_t *>(memory);
+  if (bucket >= pool_num_buckets) {
+    ::operator delete(memory);
+    return;
+  }
+  auto *block = reinterpret_cast<PoolFreeBlock *>(memory);
+  block->next = pool_state.free_lists[bucket];
+  pool_state.free_lists[bucket] = block;
+}
+
+}  // namespace memory_pool
+}  // namespace smash
@@ -0,0 +1,110 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/memorystats.h"
+
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "smash/logging.h"
+
+namespace smash {
+namespace {
+
+/// Number of accounted categories, see MemoryStats::Category.
+constexpr std::size_t num_categories = 5;
+
+/// The names the categories are reported under.
+const std::array<const char *, num_categories> category_names = {
+    {"particles", "actions", "lattices", "output buffers", "event arena"}};
+
+/// The usage accounting of one category.
+struct CategoryUsage {
+  /// Bytes currently allocated.
+  std::atomic<std::uint64_t> current{0};
+  /// Largest value of current since the last per-event report.
+  std::atomic<std::uint64_t> event_peak{0};
+  /// Largest value of current over the whole run.
+  std::atomic<std::uint64_t> run_peak{0};
+};
+
+/// The accounted usage per category.
+std::array<CategoryUsage, num_categories> usage;
+
+/**
+ * Raise \p peak to \p value if it is smaller.
+ *
+ * \param[in,out] peak The high-water mark to update.
+ * \param[in] value The usage just reached.
+ */
+void update_peak(std::atomic<std::uint64_t> &peak, std::uint64_t value) {
+  std::uint64_t seen = peak.load(std::memory_order_relaxed);
+  while (seen < value &&
+         !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+  }
+}
+
+/**
+ * \param[in] bytes A byte count.
+ * \return the byte count formatted as mebibytes with one decimal.
+ */
+std::string format_bytes(std::uint64_t bytes) {
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(1)
+         << static_cast<double>(bytes) / (1024. * 1024.) << " MiB";
+  return stream.str();
+}
+
+}  // unnamed namespace
+
+void MemoryStats::allocate(Category category, std::uint64_t bytes) {
+  CategoryUsage &u = usage[static_cast<int>(category)];
+  const std::uint64_t now =
+      u.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  update_peak(u.event_peak, now);
+  update_peak(u.run_peak, now);
+}
+
+void MemoryStats::deallocate(Category category, std::uint64_t bytes) {
+  usage[static_cast<int>(category)].current.fetch_sub(
+      bytes, std::memory_order_relaxed);
+}
+
+void MemoryStats::report_event(int event_number) {
+  const auto &log = logger<LogArea::Memory>();
+  std::ostringstream line;
+  line << "Memory after event " << event_number << ":";
+  for (std::size_t i = 0; i < num_categories; i++) {
+    const std::uint64_t current =
+        usage[i].current.load(std::memory_order_relaxed);
+    /* The per-event mark restarts at the current usage, not at zero: memory
+     * surviving into the next event is part of that event's peak. */
+    const std::uint64_t peak =
+        usage[i].event_peak.exchange(current, std::memory_order_relaxed);
+    line << (i == 0 ? " " : ", ") << category_names[i] << " "
+         << format_bytes(current) << " (peak " << format_bytes(peak) << ")";
+  }
+  log.info() << line.str();
+}
+
+void MemoryStats::report_final() {
+  const auto &log = logger<LogArea::Memory>();
+  std::ostringstream line;
+  line << "Memory high-water marks of the run:";
+  for (std::size_t i = 0; i < num_categories; i++) {
+    line << (i == 0 ? " " : ", ") << category_names[i] << " "
+         << format_bytes(usage[i].run_peak.load(std::memory_order_relaxed));
+  }
+  log.info() << line.str();
+}
+
+}  // namespace smash
@@ -93,124 +93,22 @@ double Nucleus::mass() const {
  *
  * \f[p(B) = \frac{B^2}{\exp(B-R) + 1}.\f]
  *
- * Splitting it up in two regimes
- * ------------------------------
- *
- * We shift the distribution so that \f$B-R\f$ is 0 at \f$t = 0\f$: \f$t
- * = B-R\f$:
- *
- * \f[p^{(1)}(t)= \frac{(t+R)^2}{\exp(t)+1}\f]
- *
- * and observe
- *
- * \f[\frac{1}{\exp(x)+1} = \frac{e^{-x}}{e^{-x}e^{x}+e^{-x}} =
- * \frac{e^{-x}}{e^{-x}+1}.\f]
- *
- * The distribution function can now be split into two cases. For
- * negative t (first case), \f$-|t| = t\f$, and for positive t (second
- * case), \f$-|t| = -t\f$:
- *
- * \f[p^{(1)}(t) = \frac{1}{e^{-|t|}+1} \cdot (t+R)^2 \cdot
- * \begin{cases}
- * 1 & -R \le t < 0 \\
- * e^{-t} & t \ge 0
- * \end{cases}.\f]
- *
- * Apart from the first term, all that remains here can easily and
- * exactly be generated from unrejected uniform random numbers (see
- * below). The first term itself - \f$(1+e^{-|t|})^{-1}\f$ - is a number
- * between 1/2 and 1.
- *
- * If we now have a variable \f$t\f$ distributed according to the
- * remainder, \f$p^{(2)}(t)\f$, and reject \f$t\f$ with a probability
- * \f$p^{(rej)}(t) = 1 - p^{(survive)}(t) = 1 - (1+e^{-|t|})^{-1}\f$,
- * the resulting distribution is \f$p^{(combined)}(t) = p^{(2)}(t) \cdot
- * p^{(survive)}(t)\f$. Hence, we need to generate \f$p^{(2)}(t)\f$,
- * which we can normalize to
- *
- * \f[\tilde{p}^{(2)}(t) = \frac{1}{1+3/R+6/R^2+6/R^3} \cdot \begin{cases}
- * \frac{3}{R^3} (t+R)^2 & -R \le t < 0 \\
- * e^{-t} \left( \frac{3}{R}+\frac{6}{R^2}t+\frac{6}{R^3}\frac{1}{2}t^2 \right)
- * & t \ge 0 \end{cases}.\f]
- *
- * (the tilde \f$\tilde{p}\f$ means that this is normalized).
- *
- * Four parts inside the rejection
- * -------------------------------
- *
- * Let \f$c_1 = 1+3/R+6/R^2+6/R^3\f$. The above means:
- *
- * \f[\mbox{Choose: } \begin{cases}
- * \tilde p^{({\rm I})} = \frac{3}{R^3}(t+R)^2 \Theta(-t) \Theta(t+R) \\
- * \tilde p^{({\rm II})}= e^{-t}\Theta(t) \\
- * \tilde p^{({\rm III})}=e^{-t}\Theta(t) t \\
- * \tilde p^{({\rm IV})} =e^{-t}\Theta(t) \frac{1}{2} t^2
- * \end{cases} \mbox{ with a probability of }\begin{cases}
- * \frac{1}{c_1} \cdot 1 \\
- * \frac{1}{c_1} \cdot \frac{3}{R} \\
- * \frac{1}{c_1} \cdot \frac{6}{R^2} \\
- * \frac{1}{c_1} \cdot \frac{6}{R^3}
- * \end{cases}.\f]
- *
- * Let us see how those are generated. \f$\chi_i\f$ are uniformly
- * distributed numbers between 0 and 1.
- *
- * \f[p(\chi_i) = \Theta(\chi_i)\Theta(1-\chi_i)\f]
- *
- * For simple distributions (only one \f$\chi\f$ involved), we invert
- * \f$t(\chi)\f$, derive it w.r.t. \f$t\f$ and normalize.
- *
- * ### Case I: \f$p^{({\rm I})}\f$
- *
- * Simply from one random number:
- *
- * \f[t = R\left( \sqrt[ 3 ]{\chi} - 1 \right)\f]
- * \f[\tilde p^{({\rm I})} = \frac{3}{R^3}(t+R)^2 \mbox{ for } -R \le t
- * \le 0\f]
- *
- * ### Case II: \f$p^{({\rm II})}\f$
- *
- * Again, from one only:
- *
- * \f[t = -\log(\chi)\f]
- * \f[p(t) = \frac{d\chi}{dt}\f]
- * \f[p^{({\rm II})} = e^{-t} \mbox{ for } t > 0\f]
- *
- * ### Case III: \f$p^{({\rm III})}\f$
- *
- * Here, we need two variables:
- *
- * \f[t = -\log{\chi_1} -\log{\chi_2}\f]
- *
- * \f$p^{({\rm III})}\f$ is now the folding of \f$p^{({\rm II})}\f$ with
- *itself[1]:
- *
- * \f[p^{({\rm III})} = \int_{-\infty}^{\infty} d\tau e^{-\tau} e^{-(t-\tau)}
- * \Theta(\tau) \Theta(t-\tau) = t e^{-t} \mbox{ for } t > 0\f]
- *
- * ### Case IV: \f$p^{({\rm IV})}\f$
- *
- * Three variables needed:
- *
- * \f[t = -\log{\chi_1} -\log{\chi_2} -\log{\chi_3}\f]
- *
- * \f$p^{({\rm IV})}\f$ is now the folding of \f$p^{({\rm II})}\f$ with
- * \f$p^{({\rm III})}\f$:
- *
- * \f[p^{({\rm IV})} = \int_{ - \infty}^{\infty} d\tau e^{- \tau} \left(
- * t - \tau \right) e^{ - (t - \tau)} \Theta(\tau) \Theta(t - \tau) =
- * \frac{1}{2} t^2 e^{ -t} \mbox{ for } t > 0\f]
- *
- * [1]: This is [the probability to find a \f$\tau\f$] times [the
- * probability to find the value \f$\tau_2 = t-\tau\f$ that added to
- * \f$\tau\f$ yields \f$t\f$], integrated over all possible combinations
- * that have that property.
- *
- * From the beginning
- * ------------------
- *
- *  So, the algorithm needs to do all this from the end:
- *
+ * Sampling via the tabulated inverse CDF
+ * --------------------------------------
+ *
+ * Instead of rejection sampling the radius per nucleon, the cumulative
+ * distribution of \f$p(B)\f$ is integrated once with the trapezoidal
+ * rule and the radii at equidistant quantiles are stored, see
+ * build_inverse_cdf(). Every nucleon then costs a single uniform random
+ * number and a linear interpolation in the quantile table, see
+ * interpolate_inverse_cdf(). The table is cut off at
+ * \f$r_0 + 12 d\f$, where the tail of the distribution carries a
+ * relative weight below \f$10^{-5}\f$.
+ *
+ * The table is built lazily on the first call and rebuilt whenever the
+ * radius or the diffusiveness was changed in the meantime, so the
+ * setters stay cheap and the sampling is always consistent with the
+ * current parameters.
  */
 ThreeVector Nucleus::distribute_nucleon() const {
   // Get the solid angle of the nucleon.
@@ -223,45 +121,70 @@ ThreeVector Nucleus::distribute_nucleon() const {
   if (almost_equal(nuclear_radius_, 0.)) {
     return smash::ThreeVector();
   }
-  double radius_scaled = nuclear_radius_ / diffusiveness_;
-  double prob_range1 = 1.0;
-  double prob_range2 = 3. / radius_scaled;
-  double prob_range3 = 2. * prob_range2 / radius_scaled;
-  double prob_range4 = 1. * prob_range3 / radius_scaled;
-  double ranges234 = prob_range2 + prob_range3 + prob_range4;
-  double t;
-  /// \li Decide which branch \f$\tilde p^{({\rm I - IV})}\f$ to go into
-  do {
-    double which_range = random::uniform(-prob_range1, ranges234);
-    if (which_range < 0.0) {
-      t = radius_scaled * (std::cbrt(random::canonical()) - 1.);
-    } else {
-      t = -std::log(random::canonical());
-      if (which_range >= prob_range2) {
-        t -= std::log(random::canonical());
-        if (which_range >= prob_range2 + prob_range3) {
-          t -= std::log(random::canonical());
-        }
-      }
-    }
-    /**
-     * \li Generate \f$t\f$ from the distribution in the respective
-     * branches
-     * \li \a Reject that number with a probability
-     * \f$1-(1+\exp(-|t|))^{-1}\f$ (the efficiency of this should be
-     * \f$\gg \frac{1}{2}\f$)
-     */
-  } while (random::canonical() > 1. / (1. + std::exp(-std::abs(t))));
-  /// \li Shift and rescale \f$t\f$ to \f$r = d\cdot t + r_0\f$
-  double position_scaled = t + radius_scaled;
-  double position = position_scaled * diffusiveness_;
-  return dir.threevec() * position;
+  if (inverse_cdf_radius_.empty() ||
+      tabulated_nuclear_radius_ != nuclear_radius_ ||
+      tabulated_diffusiveness_ != diffusiveness_) {
+    const double r_max = nuclear_radius_ + 12. * diffusiveness_;
+    inverse_cdf_radius_ = build_inverse_cdf(
+        [this](double r) { return woods_saxon(r); }, r_max,
+        sampling_quantiles_);
+    tabulated_nuclear_radius_ = nuclear_radius_;
+    tabulated_diffusiveness_ = diffusiveness_;
+  }
+  return dir.threevec() *
+         interpolate_inverse_cdf(inverse_cdf_radius_, random::canonical());
 }
 
-double Nucleus::woods_saxon(double r) {
+double Nucleus::woods_saxon(double r) const {
   return r * r / (std::exp((r - nuclear_radius_) / diffusiveness_) + 1);
 }
 
+constexpr size_t Nucleus::sampling_quantiles_;
+
+std::vector<double> Nucleus::build_inverse_cdf(
+    const std::function<double(double)> &density, double r_max,
+    size_t n_quantiles, double *norm) {
+  /* Integrate the density on a grid fine enough that the linear
+   * interpolation of the CDF inside one cell is exact for all practical
+   * purposes. */
+  const size_t n_grid = 16 * n_quantiles;
+  const double dr = r_max / n_grid;
+  std::vector<double> cdf(n_grid + 1);
+  cdf[0] = 0.;
+  double previous = density(0.);
+  for (size_t i = 1; i <= n_grid; ++i) {
+    const double current = density(i * dr);
+    cdf[i] = cdf[i - 1] + 0.5 * (previous + current) * dr;
+    previous = current;
+  }
+  if (norm) {
+    *norm = cdf[n_grid];
+  }
+  /* Walk through the CDF once and record the radius at every equidistant
+   * quantile. */
+  std::vector<double> table(n_quantiles + 1);
+  table[0] = 0.;
+  table[n_quantiles] = r_max;
+  size_t j = 1;
+  for (size_t i = 1; i < n_quantiles; ++i) {
+    const double target = cdf[n_grid] * static_cast<double>(i) / n_quantiles;
+    while (cdf[j] < target) {
+      ++j;
+    }
+    const double excess = (target - cdf[j - 1]) / (cdf[j] - cdf[j - 1]);
+    table[i] = (j - 1 + excess) * dr;
+  }
+  return table;
+}
+
+double Nucleus::interpolate_inverse_cdf(const std::vector<double> &table,
+                                        double u) {
+  const double position = u * (table.size() - 1);
+  const size_t i = static_cast<size_t>(position);
+  const double fraction = position - i;
+  return table[i] * (1. - fraction) + table[i + 1] * fraction;
+}
+
 void Nucleus::arrange_nucleons() {
   for (auto i = begin(); i != end(); i++) {
     // Initialize momentum
@@ -279,6 +202,47 @@ void Nucleus::arrange_nucleons() {
   rotate();
 }
 
+void Nucleus::sample_initial_ensemble(int n_configurations,
+                                      bool with_fermi_motion) {
+  ensemble_.clear();
+  ensemble_.reserve(n_configurations);
+  for (int i = 0; i < n_configurations; ++i) {
+    arrange_nucleons();
+    if (with_fermi_motion) {
+      generate_fermi_momenta();
+    }
+    EnsembleConfiguration configuration;
+    configuration.positions.reserve(particles_.size());
+    configuration.momenta.reserve(particles_.size());
+    for (const ParticleData &particle : particles_) {
+      configuration.positions.push_back(particle.position().threevec());
+      configuration.momenta.push_back(particle.momentum());
+    }
+    ensemble_.push_back(std::move(configuration));
+  }
+}
+
+void Nucleus::draw_from_ensemble() {
+  const EnsembleConfiguration &configuration = ensemble_[random::uniform_int(
+      size_t{0}, ensemble_.size() - 1)];
+  /* Three Euler angles with isotropic phi, cos(theta) and psi give a
+   * uniformly random rotation. */
+  Angles orientation;
+  orientation.distribute_isotropically();
+  const double psi = random::uniform(0., twopi);
+  size_t i = 0;
+  for (ParticleData &particle : particles_) {
+    ThreeVector position = configuration.positions[i];
+    position.rotate(orientation.phi(), orientation.theta(), psi);
+    particle.set_4position(FourVector(0.0, position));
+    ThreeVector momentum = configuration.momenta[i].threevec();
+    momentum.rotate(orientation.phi(), orientation.theta(), psi);
+    particle.set_4momentum(
+        FourVector(configuration.momenta[i].x0(), momentum));
+    ++i;
+  }
+}
+
 void Nucleus::set_parameters_automatic() {
   int A = Nucleus::number_of_particles();
   switch (A) {
@@ -339,6 +303,11 @@ void Nucleus::set_parameters_from_config(Configuration &config) {
       static_cast<double>(config.take({"Saturation_Density"})));
 }
 
+double Nucleus::nucleon_density(const ThreeVector &pos) const {
+  return nuclear_density /
+         (std::exp((pos.abs() - nuclear_radius_) / diffusiveness_) + 1.);
+}
+
 void Nucleus::generate_fermi_momenta() {
   const int N_n = std::count_if(begin(), end(), [](const ParticleData i) {
     return i.pdgcode() == pdg::n;
@@ -364,8 +333,8 @@ void Nucleus::generate_fermi_momenta() {
       continue;
     }
     const double r = (i->position() - nucleus_center).abs3();
-    double rho = nuclear_density /
-                 (std::exp((r - nuclear_radius_) / diffusiveness_) + 1.);
+    double rho =
+        nucleon_density(i->position().threevec() - nucleus_center.threevec());
     if (i->pdgcode() == pdg::p) {
       rho = rho * N_p / A;
     }
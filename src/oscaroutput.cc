@@ -8,6 +8,7 @@
  */
 #include "smash/oscaroutput.h"
 
+#include <cstdarg>
 #include <string>
 
 #include <boost/filesystem.hpp>
@@ -18,17 +19,22 @@
 #include "smash/configuration.h"
 #include "smash/cxx14compat.h"
 #include "smash/forwarddeclarations.h"
+#include "smash/memorystats.h"
 #include "smash/particles.h"
 
 namespace smash {
 
 template <OscarOutputFormat Format, int Contents>
 OscarOutput<Format, Contents>::OscarOutput(const bf::path &path,
-                                           const std::string &name)
+                                           const std::string &name,
+                                           const OutputParameters &out_par)
     : OutputInterface(name),
-      file_{path /
-                (name + ".oscar" + ((Format == OscarFormat1999) ? "1999" : "")),
-            "w"} {
+      file_{out_par.shard_path(
+                path,
+                name + ".oscar" + ((Format == OscarFormat1999) ? "1999" : "")),
+            "w"},
+      out_par_(out_par),
+      filtering_(!(Contents & OscarInteractions) && out_par.part_filtering) {
   /*!\Userguide
    * \page oscar_general_ OSCAR Block Structure
    * OSCAR outputs are a family of ASCII and binary formats that follow
@@ -113,32 +119,97 @@ OscarOutput<Format, Contents>::OscarOutput(const bf::path &path,
                  " impact_parameter\n");
     std::fprintf(file_.get(), "#\n");
   }
+  if (filtering_) {
+    /* Note the active content filters in the header, so the file documents
+     * that its particle blocks are not the complete particle list. */
+    std::fprintf(file_.get(),
+                 "# Content filter: %zu PDG codes (0 = all),"
+                 " y in [%g, %g], pT in [%g, %g] GeV\n",
+                 out_par_.part_pdg_filter.size(), out_par_.part_y_filter[0],
+                 out_par_.part_y_filter[1], out_par_.part_pt_filter[0],
+                 out_par_.part_pt_filter[1]);
+  }
+}
+
+template <OscarOutputFormat Format, int Contents>
+OscarOutput<Format, Contents>::~OscarOutput() {
+  MemoryStats::deallocate(MemoryStats::Category::OutputBuffers,
+                          buffer_.capacity());
+}
+
+template <OscarOutputFormat Format, int Contents>
+void OscarOutput<Format, Contents>::append(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  va_list args_copy;
+  va_copy(args_copy, args);
+  const int length = std::vsnprintf(nullptr, 0, format, args_copy);
+  va_end(args_copy);
+  const std::size_t old_size = buffer_.size();
+  const std::size_t old_capacity = buffer_.capacity();
+  // vsnprintf needs room for its terminating null, which is dropped again
+  buffer_.resize(old_size + length + 1);
+  std::vsnprintf(&buffer_[old_size], length + 1, format, args);
+  va_end(args);
+  buffer_.resize(old_size + length);
+  if (buffer_.capacity() != old_capacity) {
+    MemoryStats::allocate(MemoryStats::Category::OutputBuffers,
+                          buffer_.capacity() - old_capacity);
+  }
+}
+
+template <OscarOutputFormat Format, int Contents>
+void OscarOutput<Format, Contents>::flush_buffer() {
+  if (!buffer_.empty()) {
+    std::fwrite(buffer_.data(), 1, buffer_.size(), file_.get());
+    /* clear keeps the capacity, so after the first blocks no further
+     * allocations happen */
+    buffer_.clear();
+  }
 }
 
 template <OscarOutputFormat Format, int Contents>
 inline void OscarOutput<Format, Contents>::write(const Particles &particles) {
   for (const ParticleData &data : particles) {
+    if (filtering_ && !out_par_.passes_filter(data)) {
+      continue;
+    }
     write_particledata(data);
   }
 }
 
+template <OscarOutputFormat Format, int Contents>
+size_t OscarOutput<Format, Contents>::count_printed(
+    const Particles &particles) const {
+  if (!filtering_) {
+    return particles.size();
+  }
+  size_t count = 0;
+  for (const ParticleData &data : particles) {
+    if (out_par_.passes_filter(data)) {
+      count++;
+    }
+  }
+  return count;
+}
+
 template <OscarOutputFormat Format, int Contents>
 void OscarOutput<Format, Contents>::at_eventstart(const Particles &particles,
                                                   const int event_number) {
   current_event_ = event_number;
   if (Contents & OscarAtEventstart) {
+    const size_t printed = count_printed(particles);
     if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
-      std::fprintf(file_.get(), "# event %i in %zu\n", event_number + 1,
-                   particles.size());
+      append("# event %i in %zu\n", event_number + 1, printed);
     } else {
       /* OSCAR line prefix : initial particles; final particles; event id
        * First block of an event: initial = 0, final = number of particles
        */
       const size_t zero = 0;
-      std::fprintf(file_.get(), "%zu %zu %i\n", zero, particles.size(),
-                   event_number + 1);
+      append("%zu %zu %i\n", zero, printed, event_number + 1);
     }
     write(particles);
+    flush_buffer();
   }
 }
 
@@ -148,27 +219,27 @@ void OscarOutput<Format, Contents>::at_eventend(const Particles &particles,
                                                 double impact_parameter) {
   if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
     if (Contents & OscarParticlesAtEventend) {
-      std::fprintf(file_.get(), "# event %i out %zu\n", event_number + 1,
-                   particles.size());
+      append("# event %i out %zu\n", event_number + 1,
+             count_printed(particles));
       write(particles);
     }
     // Comment end of an event
-    std::fprintf(file_.get(), "# event %i end 0 impact %7.3f\n",
-                 event_number + 1, impact_parameter);
+    append("# event %i end 0 impact %7.3f\n", event_number + 1,
+           impact_parameter);
   } else {
     /* OSCAR line prefix : initial particles; final particles; event id
      * Last block of an event: initial = number of particles, final = 0
      * Block ends with null interaction. */
     const size_t zero = 0;
     if (Contents & OscarParticlesAtEventend) {
-      std::fprintf(file_.get(), "%zu %zu %i\n", particles.size(), zero,
-                   event_number + 1);
+      append("%zu %zu %i\n", count_printed(particles), zero, event_number + 1);
       write(particles);
     }
     // Null interaction marks the end of an event
-    std::fprintf(file_.get(), "%zu %zu %i %7.3f\n", zero, zero,
-                 event_number + 1, impact_parameter);
+    append("%zu %zu %i %7.3f\n", zero, zero, event_number + 1,
+           impact_parameter);
   }
+  flush_buffer();
   // Flush to disk
   std::fflush(file_.get());
 }
@@ -178,13 +249,13 @@ void OscarOutput<Format, Contents>::at_interaction(const Action &action,
                                                    const double density) {
   if (Contents & OscarInteractions) {
     if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
-      std::fprintf(file_.get(),
-                   "# interaction in %zu out %zu rho %12.7f weight %12.7g"
-                   " partial %12.7f type %5i\n",
-                   action.incoming_particles().size(),
-                   action.outgoing_particles().size(), density,
-                   action.get_total_weight(), action.get_partial_weight(),
-                   static_cast<int>(action.get_type()));
+      append(
+          "# interaction in %zu out %zu rho %12.7f weight %12.7g"
+          " partial %12.7f type %5i\n",
+          action.incoming_particles().size(),
+          action.outgoing_particles().size(), density,
+          action.get_total_weight(), action.get_partial_weight(),
+          static_cast<int>(action.get_type()));
     } else {
       /* OSCAR line prefix : initial final
        * particle creation: 0 1
@@ -192,11 +263,11 @@ void OscarOutput<Format, Contents>::at_interaction(const Action &action,
        * resonance formation: 2 1
        * resonance decay: 1 2
        * etc.*/
-      std::fprintf(file_.get(), "%zu %zu %12.7f %12.7f %12.7f %5i\n",
-                   action.incoming_particles().size(),
-                   action.outgoing_particles().size(), density,
-                   action.get_total_weight(), action.get_partial_weight(),
-                   static_cast<int>(action.get_type()));
+      append("%zu %zu %12.7f %12.7f %12.7f %5i\n",
+             action.incoming_particles().size(),
+             action.outgoing_particles().size(), density,
+             action.get_total_weight(), action.get_partial_weight(),
+             static_cast<int>(action.get_type()));
     }
     for (const auto &p : action.incoming_particles()) {
       write_particledata(p);
@@ -204,6 +275,7 @@ void OscarOutput<Format, Contents>::at_interaction(const Action &action,
     for (const auto &p : action.outgoing_particles()) {
       write_particledata(p);
     }
+    flush_buffer();
   }
 }
 
@@ -211,15 +283,15 @@ template <OscarOutputFormat Format, int Contents>
 void OscarOutput<Format, Contents>::at_intermediate_time(
     const Particles &particles, const Clock &, const DensityParameters &) {
   if (Contents & OscarTimesteps) {
+    const size_t printed = count_printed(particles);
     if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
-      std::fprintf(file_.get(), "# event %i out %zu\n", current_event_ + 1,
-                   particles.size());
+      append("# event %i out %zu\n", current_event_ + 1, printed);
     } else {
       const size_t zero = 0;
-      std::fprintf(file_.get(), "%zu %zu %i\n", particles.size(), zero,
-                   current_event_ + 1);
+      append("%zu %zu %i\n", printed, zero, current_event_ + 1);
     }
     write(particles);
+    flush_buffer();
   }
 }
 
@@ -669,15 +741,13 @@ void OscarOutput<Format, Contents>::write_particledata(
   const FourVector pos = data.position();
   const FourVector mom = data.momentum();
   if (Format == OscarFormat2013) {
-    std::fprintf(file_.get(), "%g %g %g %g %g %.9g %.9g %.9g %.9g %s %i %i\n",
-                 pos.x0(), pos.x1(), pos.x2(), pos.x3(), data.effective_mass(),
-                 mom.x0(), mom.x1(), mom.x2(), mom.x3(),
-                 data.pdgcode().string().c_str(), data.id(),
-                 data.type().charge());
+    append("%g %g %g %g %g %.9g %.9g %.9g %.9g %s %i %i\n", pos.x0(), pos.x1(),
+           pos.x2(), pos.x3(), data.effective_mass(), mom.x0(), mom.x1(),
+           mom.x2(), mom.x3(), data.pdgcode().string().c_str(), data.id(),
+           data.type().charge());
   } else if (Format == OscarFormat2013Extended) {
     const auto h = data.get_history();
-    std::fprintf(
-        file_.get(),
+    append(
         "%g %g %g %g %g %.9g %.9g %.9g"
         " %.9g %s %i %i %i %g %g %i %i %g %s %s\n",
         pos.x0(), pos.x1(), pos.x2(), pos.x3(), data.effective_mass(), mom.x0(),
@@ -687,10 +757,10 @@ void OscarOutput<Format, Contents>::write_particledata(
         static_cast<int>(h.process_type), h.time_last_collision,
         h.p1.string().c_str(), h.p2.string().c_str());
   } else {
-    std::fprintf(file_.get(), "%i %s %i %g %g %g %g %g %g %g %g %g\n",
-                 data.id(), data.pdgcode().string().c_str(), 0, mom.x1(),
-                 mom.x2(), mom.x3(), mom.x0(), data.effective_mass(), pos.x1(),
-                 pos.x2(), pos.x3(), pos.x0());
+    append("%i %s %i %g %g %g %g %g %g %g %g %g\n", data.id(),
+           data.pdgcode().string().c_str(), 0, mom.x1(), mom.x2(), mom.x3(),
+           mom.x0(), data.effective_mass(), pos.x1(), pos.x2(), pos.x3(),
+           pos.x0());
   }
 }
 
@@ -714,17 +784,20 @@ std::unique_ptr<OutputInterface> create_select_format(
   bool extended_format = (Contents & OscarInteractions) ? out_par.coll_extended
                                                         : out_par.part_extended;
   if (modern_format && extended_format) {
-    return make_unique<OscarOutput<OscarFormat2013Extended, Contents>>(path,
-                                                                       name);
+    return make_unique<OscarOutput<OscarFormat2013Extended, Contents>>(
+        path, name, out_par);
   } else if (modern_format && !extended_format) {
-    return make_unique<OscarOutput<OscarFormat2013, Contents>>(path, name);
+    return make_unique<OscarOutput<OscarFormat2013, Contents>>(path, name,
+                                                               out_par);
   } else if (!modern_format && !extended_format) {
-    return make_unique<OscarOutput<OscarFormat1999, Contents>>(path, name);
+    return make_unique<OscarOutput<OscarFormat1999, Contents>>(path, name,
+                                                               out_par);
   } else {
     // Only remaining possibility: (!modern_format && extended_format)
     log.warn() << "Creating Oscar output: "
                << "There is no extended Oscar1999 format.";
-    return make_unique<OscarOutput<OscarFormat1999, Contents>>(path, name);
+    return make_unique<OscarOutput<OscarFormat1999, Contents>>(path, name,
+                                                               out_par);
   }
 }
 }  // unnamed namespace
@@ -758,14 +831,14 @@ std::unique_ptr<OutputInterface> create_oscar_output(
   } else if (content == "Dileptons") {
     if (modern_format && out_par.dil_extended) {
       return make_unique<
-          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(path,
-                                                                   "Dileptons");
+          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(
+          path, "Dileptons", out_par);
     } else if (modern_format && !out_par.dil_extended) {
       return make_unique<OscarOutput<OscarFormat2013, OscarInteractions>>(
-          path, "Dileptons");
+          path, "Dileptons", out_par);
     } else if (!modern_format && !out_par.dil_extended) {
       return make_unique<OscarOutput<OscarFormat1999, OscarInteractions>>(
-          path, "Dileptons");
+          path, "Dileptons", out_par);
     } else if (!modern_format && out_par.dil_extended) {
       log.warn() << "Creating Oscar output: "
                  << "There is no extended Oscar1999 (dileptons) format.";
@@ -773,14 +846,14 @@ std::unique_ptr<OutputInterface> create_oscar_output(
   } else if (content == "Photons") {
     if (modern_format && !out_par.photons_extended) {
       return make_unique<OscarOutput<OscarFormat2013, OscarInteractions>>(
-          path, "Photons");
+          path, "Photons", out_par);
     } else if (modern_format && out_par.photons_extended) {
       return make_unique<
-          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(path,
-                                                                   "Photons");
+          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(
+          path, "Photons", out_par);
     } else if (!modern_format && !out_par.photons_extended) {
       return make_unique<OscarOutput<OscarFormat1999, OscarInteractions>>(
-          path, "Photons");
+          path, "Photons", out_par);
     } else if (!modern_format && out_par.photons_extended) {
       log.warn() << "Creating Oscar output: "
                  << "There is no extended Oscar1999 (photons) format.";
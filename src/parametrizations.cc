@@ -34,10 +34,11 @@ double xs_high_energy(double mandelstam_s, bool is_opposite_charge, double ma,
   const double eta1 = 0.4473;
   const double eta2 = 0.5486;
   const double s_sab = mandelstam_s / (ma + mb + M) / (ma + mb + M);
+  const double log_s_sab = std::log(s_sab);
+  const double xs_R2 = R2 * pow_from_log(log_s_sab, -eta2);
   double xs =
-      H * std::log(s_sab) * std::log(s_sab) + P + R1 * std::pow(s_sab, -eta1);
-  xs = is_opposite_charge ? xs + R2 * std::pow(s_sab, -eta2)
-                          : xs - R2 * std::pow(s_sab, -eta2);
+      H * log_s_sab * log_s_sab + P + R1 * pow_from_log(log_s_sab, -eta1);
+  xs = is_opposite_charge ? xs + xs_R2 : xs - xs_R2;
   return xs;
 }
 
@@ -124,7 +125,7 @@ double piplusp_elastic_high_energy(double mandelstam_s, double m1, double m2) {
   const double p_lab = (m1 > m2) ? plab_from_s(mandelstam_s, m2, m1)
                                  : plab_from_s(mandelstam_s, m1, m2);
   const auto logp = std::log(p_lab);
-  return 11.4 * std::pow(p_lab, -0.4) + 0.079 * logp * logp;
+  return 11.4 * pow_from_log(logp, -0.4) + 0.079 * logp * logp;
 }
 
 double piplusp_elastic_AQM(double mandelstam_s, double m1, double m2) {
@@ -144,7 +145,7 @@ double piplusp_elastic(double mandelstam_s) {
     sigma = really_small;
   } else if (mandelstam_s > 4.84) {
     const auto logp = std::log(p_lab);
-    sigma = 11.4 * std::pow(p_lab, -0.4) + 0.079 * logp * logp;
+    sigma = 11.4 * pow_from_log(logp, -0.4) + 0.079 * logp * logp;
   } else {
     sigma = piplusp_elastic_pdg(mandelstam_s);
   }
@@ -216,7 +217,7 @@ double piminusp_elastic(double mandelstam_s) {
   if (mandelstam_s < 1.69) {
     sigma = really_small;
   } else if (mandelstam_s > 4.84) {
-    sigma = 1.76 + 11.2 * std::pow(p_lab, -0.64) + 0.043 * logp * logp;
+    sigma = 1.76 + 11.2 * pow_from_log(logp, -0.64) + 0.043 * logp * logp;
   } else {
     sigma = piminusp_elastic_pdg(mandelstam_s);
   }
@@ -323,7 +324,7 @@ double pp_elastic(double mandelstam_s) {
     return 77 / (p_lab + 1.5);
   } else {
     const auto logp = std::log(p_lab);
-    return 11.9 + 26.9 * std::pow(p_lab, -1.21) + 0.169 * logp * logp -
+    return 11.9 + 26.9 * pow_from_log(logp, -1.21) + 0.169 * logp * logp -
            1.85 * logp;
   }
 }
@@ -332,7 +333,7 @@ double pp_elastic_high_energy(double mandelstam_s, double m1, double m2) {
   const double p_lab = (m1 > m2) ? plab_from_s(mandelstam_s, m2, m1)
                                  : plab_from_s(mandelstam_s, m1, m2);
   const auto logp = std::log(p_lab);
-  return 11.9 + 26.9 * std::pow(p_lab, -1.21) + 0.169 * logp * logp -
+  return 11.9 + 26.9 * pow_from_log(logp, -1.21) + 0.169 * logp * logp -
          1.85 * logp;
 }
 
@@ -359,14 +360,15 @@ double np_elastic(double mandelstam_s) {
                (mandelstam_s - 4 * nucleon_mass * nucleon_mass) -
            6.83;
   } else if (p_lab < 0.8) {
-    return 33 + 196 * std::pow(std::abs(p_lab - 0.95), 2.5);
+    const double dp = std::abs(p_lab - 0.95);
+    return 33 + 196 * pow_int(dp, 2) * std::sqrt(dp);
   } else if (p_lab < 2.0) {
     return 31 / std::sqrt(p_lab);
   } else if (p_lab < 2.776) {
     return 77 / (p_lab + 1.5);
   } else {
     const auto logp = std::log(p_lab);
-    return 11.9 + 26.9 * std::pow(p_lab, -1.21) + 0.169 * logp * logp -
+    return 11.9 + 26.9 * pow_from_log(logp, -1.21) + 0.169 * logp * logp -
            1.85 * logp;
   }
 }
@@ -375,9 +377,11 @@ double np_total(double mandelstam_s) {
   const double p_lab = plab_from_s(mandelstam_s);
   const auto logp = std::log(p_lab);
   if (p_lab < 0.4) {
-    return 6.3555 * std::pow(p_lab, -3.2481) * std::exp(-0.377 * logp * logp);
+    // the power law and the Gaussian share one exponential
+    return 6.3555 * std::exp(-3.2481 * logp - 0.377 * logp * logp);
   } else if (p_lab < 1.0) {
-    return 33 + 196 * std::pow(std::abs(p_lab - 0.95), 2.5);
+    const double dp = std::abs(p_lab - 0.95);
+    return 33 + 196 * pow_int(dp, 2) * std::sqrt(dp);
   } else if (p_lab < 2.0) {
     return 24.2 + 8.9 * p_lab;
   } else if (p_lab < 5.0) {
@@ -395,7 +399,7 @@ double ppbar_elastic(double mandelstam_s) {
     return 31.6 + 18.3 / p_lab - 1.1 / (p_lab * p_lab) - 3.8 * p_lab;
   } else {
     const auto logp = std::log(p_lab);
-    return 10.2 + 52.7 * std::pow(p_lab, -1.16) + 0.125 * logp * logp -
+    return 10.2 + 52.7 * pow_from_log(logp, -1.16) + 0.125 * logp * logp -
            1.28 * logp;
   }
 }
@@ -408,7 +412,7 @@ double ppbar_total(double mandelstam_s) {
     return 75.0 + 43.1 / p_lab + 2.6 / (p_lab * p_lab) - 3.9 * p_lab;
   } else {
     const auto logp = std::log(p_lab);
-    return 38.4 + 77.6 * std::pow(p_lab, -0.64) + 0.26 * logp * logp -
+    return 38.4 + 77.6 * pow_from_log(logp, -0.64) + 0.26 * logp * logp -
            1.2 * logp;
   }
 }
@@ -667,7 +671,7 @@ double KaonNucleonRatios::get_ratio(const ParticleType& a,
   return ratios_.at(key);
 }
 
-/*thread_local (see #3075)*/ KaonNucleonRatios kaon_nucleon_ratios;
+thread_local KaonNucleonRatios kaon_nucleon_ratios;
 
 double kminusp_kbar0n(double mandelstam_s) {
   constexpr double a0 = 100;   // mb GeV^2
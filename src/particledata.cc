@@ -31,6 +31,9 @@ double ParticleData::effective_mass() const {
 void ParticleData::set_history(int ncoll, uint32_t pid, ProcessType pt,
                                double time_last_coll,
                                const ParticleList &plist) {
+  if (!history_enabled_) {
+    return;
+  }
   if (pt != ProcessType::Wall) {
     history_.collisions_per_particle = ncoll;
     history_.time_last_collision = time_last_coll;
@@ -67,6 +70,12 @@ void ParticleData::set_history(int ncoll, uint32_t pid, ProcessType pt,
 }
 
 double ParticleData::xsec_scaling_factor(double delta_time) const {
+  if (initial_xsec_scaling_factor_ == 1.) {
+    /* Fully formed particles (and string products whose formation was
+     * completed by complete_formation) always scale with one; this is the
+     * common case in the pairwise collision search. */
+    return 1.;
+  }
   double time_of_interest = position_.x0() + delta_time;
   // cross section scaling factor at the time_of_interest
   double scaling_factor;
@@ -114,9 +123,13 @@ std::ostream &operator<<(std::ostream &out, const ParticleData &p) {
 }
 
 std::ostream &operator<<(std::ostream &out, const ParticleList &particle_list) {
+  return out << ParticleSlice(particle_list);
+}
+
+std::ostream &operator<<(std::ostream &out, const ParticleSlice &slice) {
   auto column = out.tellp();
   out << '[';
-  for (const auto &p : particle_list) {
+  for (const auto &p : slice) {
     if (out.tellp() - column >= 201) {
       out << '\n';
       column = out.tellp();
@@ -145,4 +158,6 @@ std::ostream &operator<<(std::ostream &out,
 
 double ParticleData::formation_power_ = 0.0;
 
+bool ParticleData::history_enabled_ = true;
+
 }  // namespace smash
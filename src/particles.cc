@@ -9,15 +9,75 @@
 
 #include "smash/particles.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "smash/largealloc.h"
+#include "smash/memorystats.h"
 
 namespace smash {
 
-Particles::Particles() : data_(new ParticleData[data_capacity_]) {
-  for (unsigned i = 0; i < data_capacity_; ++i) {
-    data_[i].index_ = i;
+void Particles::DataDeleter::operator()(ParticleData *ptr) const {
+  for (unsigned i = 0; i < capacity; ++i) {
+    ptr[i].~ParticleData();
   }
+  LargeAlloc::deallocate(ptr, capacity * sizeof(ParticleData));
+}
+
+std::unique_ptr<ParticleData[], Particles::DataDeleter>
+Particles::allocate_data(unsigned capacity) {
+  auto *memory = static_cast<ParticleData *>(
+      LargeAlloc::allocate(capacity * sizeof(ParticleData)));
+  for (unsigned i = 0; i < capacity; ++i) {
+    new (memory + i) ParticleData();
+    memory[i].index_ = i;
+  }
+  return std::unique_ptr<ParticleData[], DataDeleter>(memory,
+                                                      DataDeleter(capacity));
+}
+
+Particles::Particles() : data_(allocate_data(data_capacity_)) {
+  MemoryStats::allocate(MemoryStats::Category::Particles,
+                        data_capacity_ * sizeof(ParticleData));
+}
+
+Particles::~Particles() {
+  MemoryStats::deallocate(MemoryStats::Category::Particles,
+                          data_capacity_ * sizeof(ParticleData));
+}
+
+Particles::Particles(Particles &&other)
+    : id_max_(other.id_max_),
+      data_size_(other.data_size_),
+      data_capacity_(other.data_capacity_),
+      data_(std::move(other.data_)),
+      dirty_(std::move(other.dirty_)) {
+  /* Bring the moved-from object back into the state right after
+   * construction, so it can be reused. */
+  other.id_max_ = -1;
+  other.data_size_ = 0u;
+  other.data_capacity_ = 100u;
+  other.data_ = allocate_data(other.data_capacity_);
+  other.dirty_.clear();
+  MemoryStats::allocate(MemoryStats::Category::Particles,
+                        other.data_capacity_ * sizeof(ParticleData));
+}
+
+Particles &Particles::operator=(Particles &&other) {
+  /* Swapping the representations is enough: the other object takes the old
+   * state with it and cleans it up. */
+  std::swap(id_max_, other.id_max_);
+  std::swap(data_size_, other.data_size_);
+  std::swap(data_capacity_, other.data_capacity_);
+  std::swap(data_, other.data_);
+  std::swap(dirty_, other.dirty_);
+  return *this;
 }
 
 inline void Particles::ensure_capacity(unsigned to_add) {
@@ -27,26 +87,64 @@ inline void Particles::ensure_capacity(unsigned to_add) {
   }
 }
 
+void Particles::reserve(unsigned capacity) {
+  if (capacity > data_capacity_) {
+    increase_capacity(capacity);
+  }
+}
+
 void Particles::increase_capacity(unsigned new_capacity) {
   assert(new_capacity > data_capacity_);
+  if (capacity_locked_) {
+    throw std::runtime_error(
+        "The particle storage needs to grow to " +
+        std::to_string(new_capacity) +
+        " entries, but reallocation is forbidden (see "
+        "Guarantee_No_Reallocation). Set Expected_Maximum_Particles to at "
+        "least " +
+        std::to_string(new_capacity) + ".");
+  }
+  MemoryStats::allocate(MemoryStats::Category::Particles,
+                        (new_capacity - data_capacity_) * sizeof(ParticleData));
+  const unsigned old_capacity = data_capacity_;
   data_capacity_ = new_capacity;
-  std::unique_ptr<ParticleData[]> new_memory(new ParticleData[data_capacity_]);
+  auto new_memory = allocate_data(data_capacity_);
   unsigned i = 0;
   for (; i < data_size_; ++i) {
     new_memory[i] = data_[i];
-  }
-  for (; i < data_capacity_; ++i) {
     new_memory[i].index_ = i;
   }
+  /* Carry the generation counters of the unoccupied slots over, so that
+   * they stay monotonic when the slots are filled again and stale copies
+   * referring to them can never be revived. */
+  for (; i < old_capacity; ++i) {
+    new_memory[i].generation_ = data_[i].generation_;
+  }
   std::swap(data_, new_memory);
 }
 
 inline void Particles::copy_in(ParticleData &to, const ParticleData &from) {
   to.id_ = ++id_max_;
   to.type_ = from.type_;
+  ++to.generation_;
   from.copy_to(to);
 }
 
+const ParticleData &Particles::insert_with_id(const ParticleData &p) {
+  assert(dirty_.empty());
+  ensure_capacity(1);
+  ParticleData &in_vector = data_[data_size_];
+  in_vector.id_ = p.id();
+  in_vector.type_ = p.type_;
+  ++in_vector.generation_;
+  p.copy_to(in_vector);
+  if (p.id() > id_max_) {
+    id_max_ = p.id();
+  }
+  ++data_size_;
+  return in_vector;
+}
+
 const ParticleData &Particles::insert(const ParticleData &p) {
   if (likely(dirty_.empty())) {
     ensure_capacity(1);
@@ -71,6 +169,7 @@ void Particles::create(size_t number, PdgCode pdg) {
     pd.copy_to(data_[offset]);
     data_[offset].id_ = ++id_max_;
     data_[offset].type_ = pd.type_;
+    ++data_[offset].generation_;
     data_[offset].hole_ = false;
     --number;
   }
@@ -81,6 +180,7 @@ void Particles::create(size_t number, PdgCode pdg) {
       pd.copy_to(*ptr);
       ptr->id_ = ++id_max_;
       ptr->type_ = pd.type_;
+      ++ptr->generation_;
     }
     data_size_ += number;
   }
@@ -102,12 +202,16 @@ ParticleData &Particles::create(const PdgCode pdg) {
   pd.copy_to(*ptr);
   ptr->id_ = ++id_max_;
   ptr->type_ = pd.type_;
+  ++ptr->generation_;
   return *ptr;
 }
 
 void Particles::remove(const ParticleData &p) {
   assert(is_valid(p));
   const unsigned index = p.index_;
+  /* The bump invalidates all outstanding copies of the removed particle,
+   * also if the slot is reused later. */
+  ++data_[index].generation_;
   if (index == data_size_ - 1) {
     --data_size_;
   } else {
@@ -125,6 +229,7 @@ void Particles::replace(const ParticleList &to_remove, ParticleList &to_add) {
     copy_in(data_[index], to_add[i]);
     to_add[i].id_ = data_[index].id_;
     to_add[i].index_ = index;
+    to_add[i].generation_ = data_[index].generation_;
   }
   for (; i < to_remove.size(); ++i) {
     remove(to_remove[i]);
@@ -133,7 +238,71 @@ void Particles::replace(const ParticleList &to_remove, ParticleList &to_add) {
     const ParticleData &p = insert(to_add[i]);
     to_add[i].id_ = p.id_;
     to_add[i].index_ = p.index_;
+    to_add[i].generation_ = p.generation_;
+  }
+}
+
+const Particles::HotArrays &Particles::update_hot_arrays() const {
+  const std::size_t n = size();
+  hot_.x.resize(n);
+  hot_.y.resize(n);
+  hot_.z.resize(n);
+  hot_.p0.resize(n);
+  hot_.px.resize(n);
+  hot_.py.resize(n);
+  hot_.pz.resize(n);
+  hot_.xsec_scale.resize(n);
+  hot_.frozen.resize(n);
+  hot_.index.resize(n);
+  std::size_t i = 0;
+  for (const ParticleData &p : *this) {
+    const FourVector &position = p.position();
+    const FourVector &momentum = p.momentum();
+    hot_.x[i] = position.x1();
+    hot_.y[i] = position.x2();
+    hot_.z[i] = position.x3();
+    hot_.p0[i] = momentum.x0();
+    hot_.px[i] = momentum.x1();
+    hot_.py[i] = momentum.x2();
+    hot_.pz[i] = momentum.x3();
+    hot_.xsec_scale[i] = p.xsec_scaling_factor();
+    hot_.frozen[i] = p.frozen() ? 1 : 0;
+    hot_.index[i] = p.index_;
+    ++i;
+  }
+  return hot_;
+}
+
+void Particles::sort_by_position() {
+  if (data_size_ == 0) {
+    return;
+  }
+  ParticleList sorted = copy_to_vector();
+  std::sort(sorted.begin(), sorted.end(),
+            [](const ParticleData &a, const ParticleData &b) {
+              const FourVector &ra = a.position();
+              const FourVector &rb = b.position();
+              if (ra.x3() != rb.x3()) {
+                return ra.x3() < rb.x3();
+              }
+              if (ra.x2() != rb.x2()) {
+                return ra.x2() < rb.x2();
+              }
+              return ra.x1() < rb.x1();
+            });
+  unsigned i = 0;
+  for (ParticleData &p : sorted) {
+    /* The new occupant gets a generation beyond the previous one of the
+     * slot, so all copies made before the compaction become invalid. */
+    const uint32_t slot_generation = data_[i].generation_ + 1;
+    p.index_ = i;
+    p.hole_ = false;
+    data_[i] = std::move(p);
+    data_[i].generation_ = slot_generation;
+    ++i;
   }
+  data_size_ = i;
+  dirty_.clear();
 }
 
 void Particles::reset() {
@@ -145,6 +314,26 @@ void Particles::reset() {
   dirty_.clear();
 }
 
+const ParticleData *Particles::find_nonfinite_particle() const {
+  for (unsigned i = 0; i < data_size_; ++i) {
+    const ParticleData &data = data_[i];
+    if (data.hole_) {
+      continue;
+    }
+    /* A NaN or infinity in any component propagates into the sum, so a
+     * single finiteness check per particle suffices. Finite components
+     * cannot sum up to an infinity for any physically sensible magnitude. */
+    const FourVector &x = data.position();
+    const FourVector &p = data.momentum();
+    const double probe =
+        x.x0() + x.x1() + x.x2() + x.x3() + p.x0() + p.x1() + p.x2() + p.x3();
+    if (!std::isfinite(probe)) {
+      return &data;
+    }
+  }
+  return nullptr;
+}
+
 std::ostream &operator<<(std::ostream &out, const Particles &particles) {
   out << particles.size() << " Particles:\n";
   for (unsigned i = 0; i < particles.data_size_; ++i) {
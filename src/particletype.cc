@@ -11,7 +11,13 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <istream>
 #include <map>
+#include <ostream>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "smash/constants.h"
@@ -50,6 +56,136 @@ ParticleTypePtrList anti_deltas_list;
 ParticleTypePtrList baryon_resonances_list;
 /// Global pointer to the Particle Type list of light nuclei
 ParticleTypePtrList light_nuclei_list;
+/**
+ * Index from the PdgCode bit representation to the type, built once the
+ * type list is finalized. Lookups by PDG code happen per particle line of
+ * the list modus input and in several cross-section setup paths, so they
+ * are a single hash probe instead of a binary search over all types.
+ */
+std::unordered_map<std::uint32_t, ParticleTypePtr> pdg_index;
+
+/**
+ * Cache of the decay widths of one particle type, evaluated at one mass.
+ *
+ * The spectral function, the decay finder and the decay actions all query
+ * widths of the same type at the same mass in close succession; the cache
+ * makes sure the decay-mode formulas are only evaluated once per mass.
+ */
+struct WidthCache {
+  /// Mass at which the widths were evaluated (-1 if not evaluated yet).
+  double mass = -1.;
+  /// Total width at the cached mass (0 if below the width cutoff).
+  double total = 0.;
+  /// Whether the normalized spectral function at the cached mass is set.
+  bool spectral_valid = false;
+  /// Normalized spectral function at the cached mass.
+  double spectral = 0.;
+  /// Partial widths at the cached mass, aligned with the decay-mode list.
+  std::vector<double> partial;
+};
+
+/// Number of spectral-function evaluations served from the memo.
+std::atomic<uint64_t> spectral_cache_hits{0};
+/// Number of spectral-function evaluations that had to be computed.
+std::atomic<uint64_t> spectral_cache_misses{0};
+
+/**
+ * \return The width cache of the given particle type.
+ *
+ * The caches are thread-local, so concurrent width evaluations of the same
+ * type do not interfere.
+ */
+WidthCache &width_cache_of(const ParticleType &t) {
+  static thread_local std::vector<WidthCache> caches;
+  if (caches.size() != ParticleType::list_all().size()) {
+    caches.assign(ParticleType::list_all().size(), WidthCache{});
+  }
+  const auto offset = std::addressof(t) -
+                      std::addressof(ParticleType::list_all()[0]);
+  return caches[offset];
+}
+
+/// The positions of the dilepton decay modes in a decay-mode list.
+struct DileptonModes {
+  /// Whether the decay-mode list has been classified yet.
+  bool built = false;
+  /// Indices into the decay-mode list, in list order.
+  std::vector<int> indices;
+};
+
+/**
+ * \return The indices of the dilepton decay modes of the given type.
+ *
+ * The dilepton shining classifies the decay modes of every resonance in
+ * every time step; the PDG-code tests only depend on the decay-mode list,
+ * which is immutable after initialization, so the classification is done
+ * once per type.
+ */
+const std::vector<int> &dilepton_modes_of(const ParticleType &t) {
+  static thread_local std::vector<DileptonModes> caches;
+  if (caches.size() != ParticleType::list_all().size()) {
+    caches.assign(ParticleType::list_all().size(), DileptonModes{});
+  }
+  const auto offset = std::addressof(t) -
+                      std::addressof(ParticleType::list_all()[0]);
+  DileptonModes &cache = caches[offset];
+  if (!cache.built) {
+    const auto &decay_mode_list = t.decay_modes().decay_mode_list();
+    for (unsigned int i = 0; i < decay_mode_list.size(); i++) {
+      const auto &types = decay_mode_list[i]->type().particle_types();
+      switch (decay_mode_list[i]->type().particle_number()) {
+        case 2:
+          if (is_dilepton(types[0]->pdgcode(), types[1]->pdgcode())) {
+            cache.indices.push_back(i);
+          }
+          break;
+        case 3:
+          if (has_lepton_pair(types[0]->pdgcode(), types[1]->pdgcode(),
+                              types[2]->pdgcode())) {
+            cache.indices.push_back(i);
+          }
+          break;
+        default:
+          throw std::runtime_error("Problem in get_partial_widths_dilepton()");
+      }
+    }
+    cache.built = true;
+  }
+  return cache.indices;
+}
+
+/**
+ * Key of the rejection-envelope cache for resonance mass sampling:
+ * the resonance, the second resonance (nullptr for a stable partner), the
+ * mass of a stable partner, the orbital angular momentum and the sqrt(s)
+ * bin.
+ */
+using EnvelopeKey =
+    std::tuple<const ParticleType *, const ParticleType *, double, int, int>;
+
+/// Width of the sqrt(s) bins of the envelope cache [GeV].
+constexpr double envelope_sqrts_bin_width = 0.01;
+
+/**
+ * \return Reference to the cached rejection envelope for the given channel
+ *         and sqrt(s) (0 if it has not been determined yet).
+ *
+ * The envelope of the mass-sampling rejection loop depends strongly on
+ * sqrt(s): a single per-type maximum factor has to cover all energies at
+ * once and therefore overshoots the distribution near threshold by orders
+ * of magnitude, which is where the sampling used to need hundreds of
+ * iterations. Caching the envelope per channel and sqrt(s) bin keeps it
+ * tight everywhere. The caches are thread-local like the width caches.
+ */
+double &envelope_of(const ParticleType &res, const ParticleType *res2,
+                    const double mass_stable, const int L,
+                    const double cms_energy) {
+  static thread_local std::map<EnvelopeKey, double> envelopes;
+  const int bin = static_cast<int>(cms_energy / envelope_sqrts_bin_width);
+  // note that operator& of ParticleType is overloaded, hence addressof
+  return envelopes[EnvelopeKey(std::addressof(res), res2, mass_stable, L,
+                               bin)];
+}
 }  // unnamed namespace
 
 const ParticleTypeList &ParticleType::list_all() {
@@ -91,13 +227,11 @@ ParticleTypePtrList &ParticleType::list_light_nuclei() {
 }
 
 const ParticleTypePtr ParticleType::try_find(PdgCode pdgcode) {
-  const auto found = std::lower_bound(
-      all_particle_types->begin(), all_particle_types->end(), pdgcode,
-      [](const ParticleType &l, const PdgCode &r) { return l.pdgcode() < r; });
-  if (found == all_particle_types->end() || found->pdgcode() != pdgcode) {
+  const auto found = pdg_index.find(pdgcode.dump());
+  if (found == pdg_index.end()) {
     return {};  // The default constructor creates an invalid pointer.
   }
-  return &*found;
+  return found->second;
 }
 
 const ParticleType &ParticleType::find(PdgCode pdgcode) {
@@ -134,7 +268,11 @@ ParticleType::ParticleType(std::string n, double m, double w, Parity p,
       min_mass_spectral_(-1.),
       charge_(pdgcode_.charge()),
       isospin_(-1),
-      I3_(pdgcode_.isospin3()) {}
+      I3_(pdgcode_.isospin3()),
+      spin_(pdgcode_.spin()),
+      baryon_number_(pdgcode_.baryon_number()),
+      is_baryon_(pdgcode_.is_baryon()),
+      is_meson_(pdgcode_.is_meson()) {}
 
 /**
  * Construct an antiparticle name-string from the given name-string for the
@@ -290,7 +428,10 @@ void ParticleType::create_type_list(const std::string &input) {  // {{{
     }
   }
   type_list.shrink_to_fit();
+  finalize_type_list(type_list);
+} /*}}}*/
 
+void ParticleType::finalize_type_list(ParticleTypeList &type_list) {
   /* Sort the type list by PDG code. */
   std::sort(type_list.begin(), type_list.end());
 
@@ -311,6 +452,13 @@ void ParticleType::create_type_list(const std::string &input) {  // {{{
                                     // static and thus will live on until after
                                     // main().
 
+  /* Intern the PDG codes: all later code lookups go through the hash index
+   * instead of searching the sorted list. */
+  pdg_index.reserve(type_list.size());
+  for (const ParticleType &t : type_list) {
+    pdg_index.emplace(t.pdgcode().dump(), &t);
+  }
+
   // create all isospin multiplets
   for (const auto &t : type_list) {
     IsoParticleType::create_multiplet(t);
@@ -352,54 +500,110 @@ void ParticleType::create_type_list(const std::string &input) {  // {{{
       light_nuclei_list.push_back(&type);
     }
   }
-} /*}}}*/
+}
 
-double ParticleType::min_mass_kinematic() const {
-  if (unlikely(min_mass_kinematic_ < 0.)) {
-    /* If the particle is stable, min. mass is just the mass. */
-    min_mass_kinematic_ = mass_;
-    /* Otherwise, find the lowest mass value needed in any decay mode */
-    if (!is_stable()) {
-      for (const auto &mode : decay_modes().decay_mode_list()) {
-        min_mass_kinematic_ = std::min(min_mass_kinematic_, mode->threshold());
-      }
+void ParticleType::write_type_list_cache(std::ostream &output) {
+  const auto size = static_cast<uint32_t>(list_all().size());
+  output.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  for (const ParticleType &t : list_all()) {
+    const auto name_size = static_cast<uint32_t>(t.name().size());
+    output.write(reinterpret_cast<const char *>(&name_size),
+                 sizeof(name_size));
+    output.write(t.name().c_str(), name_size);
+    const double mass = t.mass();
+    const double width = t.width_at_pole();
+    output.write(reinterpret_cast<const char *>(&mass), sizeof(mass));
+    output.write(reinterpret_cast<const char *>(&width), sizeof(width));
+    const int8_t parity = (t.parity() == Parity::Pos) ? 1 : -1;
+    output.write(reinterpret_cast<const char *>(&parity), sizeof(parity));
+    const int32_t pdg = t.pdgcode().get_decimal();
+    output.write(reinterpret_cast<const char *>(&pdg), sizeof(pdg));
+  }
+}
+
+bool ParticleType::read_type_list_cache(std::istream &input) {
+  /* The cache stores the particle types after the parsing, the antiparticle
+   * expansion and the sorting of create_type_list, so reading back the
+   * entries and running the shared finalization rebuilds the identical
+   * list. */
+  static ParticleTypeList type_list;
+  type_list.clear();
+  uint32_t size;
+  input.read(reinterpret_cast<char *>(&size), sizeof(size));
+  if (input.fail()) {
+    return false;
+  }
+  type_list.reserve(size);
+  for (uint32_t i = 0; i < size; i++) {
+    uint32_t name_size;
+    input.read(reinterpret_cast<char *>(&name_size), sizeof(name_size));
+    if (input.fail()) {
+      type_list.clear();
+      return false;
+    }
+    std::string name(name_size, '\0');
+    input.read(&name[0], name_size);
+    double mass, width;
+    input.read(reinterpret_cast<char *>(&mass), sizeof(mass));
+    input.read(reinterpret_cast<char *>(&width), sizeof(width));
+    int8_t parity;
+    input.read(reinterpret_cast<char *>(&parity), sizeof(parity));
+    int32_t pdg;
+    input.read(reinterpret_cast<char *>(&pdg), sizeof(pdg));
+    if (input.fail()) {
+      type_list.clear();
+      return false;
+    }
+    type_list.emplace_back(name, mass, width,
+                           parity > 0 ? Parity::Pos : Parity::Neg,
+                           PdgCode::from_decimal(pdg));
+  }
+  finalize_type_list(type_list);
+  return true;
+}
+
+double ParticleType::min_mass_kinematic_compute() const {
+  /* If the particle is stable, min. mass is just the mass. */
+  min_mass_kinematic_ = mass_;
+  /* Otherwise, find the lowest mass value needed in any decay mode */
+  if (!is_stable()) {
+    for (const auto &mode : decay_modes().decay_mode_list()) {
+      min_mass_kinematic_ = std::min(min_mass_kinematic_, mode->threshold());
     }
   }
   return min_mass_kinematic_;
 }
 
-double ParticleType::min_mass_spectral() const {
-  if (unlikely(min_mass_spectral_ < 0.)) {
-    /* If the particle is stable or it has a non-zero spectral function value at
-     * the minimum mass that is allowed by kinematics, min_mass_spectral is just
-     * the min_mass_kinetic. */
-    min_mass_spectral_ = min_mass_kinematic();
-    /* Otherwise, find the lowest mass value where spectral function has a
-     * non-zero value by bisection.*/
-    if (!is_stable() &&
-        this->spectral_function(min_mass_kinematic()) < really_small) {
-      // find a right bound that has non-zero spectral function for bisection
-      const double m_step = 0.01;
-      double right_bound_bis;
-      for (unsigned int i = 0;; i++) {
-        right_bound_bis = min_mass_kinematic() + m_step * i;
-        if (this->spectral_function(right_bound_bis) > really_small) {
-          break;
-        }
+double ParticleType::min_mass_spectral_compute() const {
+  /* If the particle is stable or it has a non-zero spectral function value at
+   * the minimum mass that is allowed by kinematics, min_mass_spectral is just
+   * the min_mass_kinetic. */
+  min_mass_spectral_ = min_mass_kinematic();
+  /* Otherwise, find the lowest mass value where spectral function has a
+   * non-zero value by bisection.*/
+  if (!is_stable() &&
+      this->spectral_function(min_mass_kinematic()) < really_small) {
+    // find a right bound that has non-zero spectral function for bisection
+    const double m_step = 0.01;
+    double right_bound_bis;
+    for (unsigned int i = 0;; i++) {
+      right_bound_bis = min_mass_kinematic() + m_step * i;
+      if (this->spectral_function(right_bound_bis) > really_small) {
+        break;
       }
-      // bisection
-      const double precision = 1E-6;
-      double left_bound_bis = right_bound_bis - m_step;
-      while (right_bound_bis - left_bound_bis > precision) {
-        const double mid = (left_bound_bis + right_bound_bis) / 2.0;
-        if (this->spectral_function(mid) > really_small) {
-          right_bound_bis = mid;
-        } else {
-          left_bound_bis = mid;
-        }
+    }
+    // bisection
+    const double precision = 1E-6;
+    double left_bound_bis = right_bound_bis - m_step;
+    while (right_bound_bis - left_bound_bis > precision) {
+      const double mid = (left_bound_bis + right_bound_bis) / 2.0;
+      if (this->spectral_function(mid) > really_small) {
+        right_bound_bis = mid;
+      } else {
+        left_bound_bis = mid;
       }
-      min_mass_spectral_ = right_bound_bis;
     }
+    min_mass_spectral_ = right_bound_bis;
   }
   return min_mass_spectral_;
 }
@@ -429,20 +633,52 @@ const DecayModes &ParticleType::decay_modes() const {
   return modes;
 }
 
+const std::vector<double> &ParticleType::partial_widths(const double m) const {
+  WidthCache &cache = width_cache_of(*this);
+  if (cache.mass != m) {
+    /* Loop over decay modes, storing all partial widths and summing up the
+     * total width. */
+    const auto &modes = decay_modes().decay_mode_list();
+    cache.partial.resize(modes.size());
+    double w = 0.;
+    for (unsigned int i = 0; i < modes.size(); i++) {
+      cache.partial[i] = partial_width(m, modes[i].get());
+      w = w + cache.partial[i];
+    }
+    cache.total = (w < width_cutoff) ? 0. : w;
+    cache.spectral_valid = false;
+    cache.mass = m;
+  }
+  return cache.partial;
+}
+
 double ParticleType::total_width(const double m) const {
-  double w = 0.;
   if (is_stable()) {
-    return w;
+    return 0.;
   }
-  /* Loop over decay modes and sum up all partial widths. */
+  partial_widths(m);
+  return width_cache_of(*this).total;
+}
+
+std::vector<double> ParticleType::total_width(
+    const std::vector<double> &masses) const {
+  std::vector<double> widths(masses.size(), 0.);
+  if (is_stable()) {
+    return widths;
+  }
+  /* Loop over decay modes in the outer loop and over the masses in the
+   * inner one, so every mode dispatches once and runs a tight loop. */
   const auto &modes = decay_modes().decay_mode_list();
-  for (unsigned int i = 0; i < modes.size(); i++) {
-    w = w + partial_width(m, modes[i].get());
+  for (const auto &mode : modes) {
+    mode->type().add_width(mass(), width_at_pole() * mode->weight(), masses,
+                           widths);
   }
-  if (w < width_cutoff) {
-    return 0.;
+  for (double &w : widths) {
+    if (w < width_cutoff) {
+      w = 0.;
+    }
   }
-  return w;
+  return widths;
 }
 
 void ParticleType::check_consistency() {
@@ -459,19 +695,47 @@ DecayBranchList ParticleType::get_partial_widths(const double m) const {
   if (decay_mode_list.size() == 0) {
     return {};
   }
-  /* Loop over decay modes and calculate all partial widths. */
+  /* Build the branch list from the (possibly cached) partial widths. */
+  const std::vector<double> &widths = partial_widths(m);
   DecayBranchList partial;
   partial.reserve(decay_mode_list.size());
   for (unsigned int i = 0; i < decay_mode_list.size(); i++) {
-    const double w = partial_width(m, decay_mode_list[i].get());
-    if (w > 0.) {
+    if (widths[i] > 0.) {
       partial.push_back(
-          make_unique<DecayBranch>(decay_mode_list[i]->type(), w));
+          make_unique<DecayBranch>(decay_mode_list[i]->type(), widths[i]));
     }
   }
   return partial;
 }
 
+double ParticleType::total_hadronic_width(const double m) const {
+  if (is_stable()) {
+    return 0.;
+  }
+  const auto &decay_mode_list = decay_modes().decay_mode_list();
+  const std::vector<double> &widths = partial_widths(m);
+  double w = 0.;
+  for (unsigned int i = 0; i < decay_mode_list.size(); i++) {
+    const auto FinalTypes = decay_mode_list[i]->type().particle_types();
+    switch (decay_mode_list[i]->type().particle_number()) {
+      case 2:
+        if (!is_dilepton(FinalTypes[0]->pdgcode(), FinalTypes[1]->pdgcode())) {
+          w += widths[i];
+        }
+        break;
+      case 3:
+        if (!has_lepton_pair(FinalTypes[0]->pdgcode(), FinalTypes[1]->pdgcode(),
+                             FinalTypes[2]->pdgcode())) {
+          w += widths[i];
+        }
+        break;
+      default:
+        throw std::runtime_error("Problem in total_hadronic_width()");
+    }
+  }
+  return w;
+}
+
 DecayBranchList ParticleType::get_partial_widths_hadronic(
     const FourVector p, const ThreeVector x) const {
   if (is_stable()) {
@@ -539,44 +803,30 @@ DecayBranchList ParticleType::get_partial_widths_hadronic(
   return partial;
 }
 
+bool ParticleType::has_dilepton_decays() const {
+  return !dilepton_modes_of(*this).empty();
+}
+
 DecayBranchList ParticleType::get_partial_widths_dilepton(
     const double m) const {
   const auto &decay_mode_list = decay_modes().decay_mode_list();
   if (decay_mode_list.size() == 0) {
     return {};
   }
-  /* Loop over decay modes and calculate all partial widths. */
+  const std::vector<int> &dilepton_modes = dilepton_modes_of(*this);
+  if (dilepton_modes.empty()) {
+    return {};
+  }
+  /* The cached width view serves the dilepton modes too, so a particle
+   * whose mass was already evaluated (e.g. by the total width right before)
+   * does not recompute any width integral here. */
+  const std::vector<double> &widths = partial_widths(m);
   DecayBranchList partial;
-  partial.reserve(decay_mode_list.size());
-  for (unsigned int i = 0; i < decay_mode_list.size(); i++) {
-    switch (decay_mode_list[i]->type().particle_number()) {
-      case 2: {
-        if (is_dilepton(
-                decay_mode_list[i]->type().particle_types()[0]->pdgcode(),
-                decay_mode_list[i]->type().particle_types()[1]->pdgcode())) {
-          const double w = partial_width(m, decay_mode_list[i].get());
-          if (w > 0.) {
-            partial.push_back(
-                make_unique<DecayBranch>(decay_mode_list[i]->type(), w));
-          }
-        }
-        break;
-      }
-      case 3: {
-        if (has_lepton_pair(
-                decay_mode_list[i]->type().particle_types()[0]->pdgcode(),
-                decay_mode_list[i]->type().particle_types()[1]->pdgcode(),
-                decay_mode_list[i]->type().particle_types()[2]->pdgcode())) {
-          const double w = partial_width(m, decay_mode_list[i].get());
-          if (w > 0.) {
-            partial.push_back(
-                make_unique<DecayBranch>(decay_mode_list[i]->type(), w));
-          }
-        }
-        break;
-      }
-      default:
-        throw std::runtime_error("Problem in get_partial_widths_dilepton()");
+  partial.reserve(dilepton_modes.size());
+  for (const int i : dilepton_modes) {
+    if (widths[i] > 0.) {
+      partial.push_back(
+          make_unique<DecayBranch>(decay_mode_list[i]->type(), widths[i]));
     }
   }
   return partial;
@@ -622,7 +872,9 @@ double ParticleType::spectral_function(double m) const {
   if (norm_factor_ < 0.) {
     /* Initialize the normalization factor
      * by integrating over the unnormalized spectral function. */
-    static /*thread_local (see #3075)*/ Integrator integrate;
+    // The tan substitution below makes the integrand smooth, so the
+    // fixed-order rule applies.
+    static thread_local IntegratorGaussLegendre<32> integrate;
     const double width = width_at_pole();
     const double m_pole = mass();
     // We transform the integral using m = m_min + width_pole * tan(x), to
@@ -635,7 +887,44 @@ double ParticleType::spectral_function(double m) const {
                      return spectral_function_no_norm(m_x) * jacobian;
                    });
   }
-  return norm_factor_ * spectral_function_no_norm(m);
+  /* The channel loops of the cross-section evaluation query the spectral
+   * function of the same resonance at the same mass several times per
+   * incoming pair, so the value is memoized alongside the widths. */
+  WidthCache &cache = width_cache_of(*this);
+  if (cache.spectral_valid && cache.mass == m) {
+    spectral_cache_hits.fetch_add(1, std::memory_order_relaxed);
+    return cache.spectral;
+  }
+  spectral_cache_misses.fetch_add(1, std::memory_order_relaxed);
+  const double value = norm_factor_ * spectral_function_no_norm(m);
+  /* spectral_function_no_norm() evaluated the total width, which sets the
+   * cached mass (except for stable types, which are never memoized). */
+  if (cache.mass == m) {
+    cache.spectral = value;
+    cache.spectral_valid = true;
+  }
+  return value;
+}
+
+std::array<uint64_t, 2> ParticleType::spectral_cache_statistics() {
+  return {{spectral_cache_hits.exchange(0), spectral_cache_misses.exchange(0)}};
+}
+
+std::vector<double> ParticleType::spectral_function(
+    const std::vector<double> &masses) const {
+  if (norm_factor_ < 0.) {
+    // initialize the normalization factor via the scalar version
+    spectral_function(mass());
+  }
+  const double m_pole = mass();
+  std::vector<double> result = total_width(masses);
+  for (std::size_t i = 0; i < masses.size(); i++) {
+    const double resonance_width = result[i];
+    const double bw = breit_wigner(masses[i], m_pole, resonance_width);
+    result[i] =
+        (resonance_width < ParticleType::width_cutoff) ? 0. : norm_factor_ * bw;
+  }
+  return result;
 }
 
 double ParticleType::spectral_function_no_norm(double m) const {
@@ -669,45 +958,49 @@ double ParticleType::sample_resonance_mass(const double mass_stable,
   /* largest possible mass: Use 'nextafter' to make sure it is not above the
    * physical limit by numerical error. */
   const double max_mass = std::nextafter(cms_energy - mass_stable, 0.);
-  // largest possible cm momentum (from smallest mass)
-  const double pcm_max =
-      pCM(cms_energy, mass_stable, this->min_mass_spectral());
-  const double blw_max = pcm_max * blatt_weisskopf_sqr(pcm_max, L);
-  /* The maximum of the spectral-function ratio 'usually' happens at the
-   * largest mass. However, this is not always the case, therefore we need
-   * and additional fudge factor (determined automatically). Additionally,
-   * a heuristic knowledge is used that usually such mass exist that
-   * spectral_function(m) > spectral_function_simple(m). */
-  const double sf_ratio_max =
-      std::max(1., this->spectral_function(max_mass) /
-                       this->spectral_function_simple(max_mass));
+  const double min_mass = this->min_mass_spectral();
+  /* The sampled quantity: ratio of full to simple spectral function, times
+   * the Blatt-Weisskopf-weighted cm momentum. The simple spectral function
+   * itself is taken care of by the Cauchy proposal distribution. */
+  auto value = [&](double m) {
+    const double pcm = pCM(cms_energy, mass_stable, m);
+    const double blw = pcm * blatt_weisskopf_sqr(pcm, L);
+    return this->spectral_function(m) / this->spectral_function_simple(m) *
+           blw;
+  };
+  /* The rejection envelope is cached per channel and sqrt(s) bin. On first
+   * use it is determined from a coarse scan of the sampled quantity with a
+   * safety margin; should it ever be exceeded, it is increased
+   * automatically as before. */
+  double &envelope = envelope_of(*this, nullptr, mass_stable, L, cms_energy);
+  if (envelope <= 0.) {
+    constexpr int n_scan = 32;
+    double scan_max = 0.;
+    for (int i = 0; i <= n_scan; i++) {
+      const double m = min_mass + (max_mass - min_mass) * i / n_scan;
+      scan_max = std::max(scan_max, value(m));
+    }
+    envelope = 1.2 * scan_max;
+  }
 
   double mass_res, val;
   // outer loop: repeat if maximum is too small
   do {
-    const double q_max = sf_ratio_max * this->max_factor1_;
-    const double max = blw_max * q_max;  // maximum value for rejection sampling
     // inner loop: rejection sampling
     do {
       // sample mass from a simple Breit-Wigner (aka Cauchy) distribution
       mass_res = random::cauchy(this->mass(), this->width_at_pole() / 2.,
-                                this->min_mass_spectral(), max_mass);
-      // determine cm momentum for this case
-      const double pcm = pCM(cms_energy, mass_stable, mass_res);
-      const double blw = pcm * blatt_weisskopf_sqr(pcm, L);
-      // determine ratio of full to simple spectral function
-      const double q = this->spectral_function(mass_res) /
-                       this->spectral_function_simple(mass_res);
-      val = q * blw;
-    } while (val < random::uniform(0., max));
+                                min_mass, max_mass);
+      val = value(mass_res);
+    } while (val < random::uniform(0., envelope));
 
     // check that we are using the proper maximum value
-    if (val > max) {
+    if (val > envelope) {
       const auto &log = logger<LogArea::Resonances>();
       log.debug("maximum is being increased in sample_resonance_mass: ",
-                this->max_factor1_, " ", val / max, " ", this->pdgcode(), " ",
+                envelope, " ", val / envelope, " ", this->pdgcode(), " ",
                 mass_stable, " ", cms_energy, " ", mass_res);
-      this->max_factor1_ *= val / max;
+      envelope = val;
     } else {
       break;  // maximum ok, exit loop
     }
@@ -726,16 +1019,39 @@ std::pair<double, double> ParticleType::sample_resonance_masses(
       std::nextafter(cms_energy - t2.min_mass_spectral(), 0.);
   const double max_mass_2 =
       std::nextafter(cms_energy - t1.min_mass_spectral(), 0.);
-  // largest possible cm momentum (from smallest mass)
-  const double pcm_max =
-      pCM(cms_energy, t1.min_mass_spectral(), t2.min_mass_spectral());
-  const double blw_max = pcm_max * blatt_weisskopf_sqr(pcm_max, L);
+  /* The sampled quantity, see \ref sample_resonance_mass. */
+  auto value = [&](double m_1, double m_2) {
+    const double pcm = pCM(cms_energy, m_1, m_2);
+    const double blw = pcm * blatt_weisskopf_sqr(pcm, L);
+    const double q1 =
+        t1.spectral_function(m_1) / t1.spectral_function_simple(m_1);
+    const double q2 =
+        t2.spectral_function(m_2) / t2.spectral_function_simple(m_2);
+    return q1 * q2 * blw;
+  };
+  /* Rejection envelope, cached per channel and sqrt(s) bin and determined
+   * from a coarse scan on first use, cf. sample_resonance_mass. */
+  double &envelope = envelope_of(t1, std::addressof(t2), 0., L, cms_energy);
+  if (envelope <= 0.) {
+    constexpr int n_scan = 16;
+    double scan_max = 0.;
+    for (int i = 0; i <= n_scan; i++) {
+      const double m_1 = t1.min_mass_spectral() +
+                         (max_mass_1 - t1.min_mass_spectral()) * i / n_scan;
+      for (int j = 0; j <= n_scan; j++) {
+        const double m_2 = t2.min_mass_spectral() +
+                           (max_mass_2 - t2.min_mass_spectral()) * j / n_scan;
+        if (m_1 + m_2 < cms_energy) {
+          scan_max = std::max(scan_max, value(m_1, m_2));
+        }
+      }
+    }
+    envelope = 1.2 * scan_max;
+  }
 
   double mass_1, mass_2, val;
   // outer loop: repeat if maximum is too small
   do {
-    // maximum value for rejection sampling (determined automatically)
-    const double max = blw_max * t1.max_factor2_;
     // inner loop: rejection sampling
     do {
       // sample mass from a simple Breit-Wigner (aka Cauchy) distribution
@@ -743,23 +1059,15 @@ std::pair<double, double> ParticleType::sample_resonance_masses(
                               t1.min_mass_spectral(), max_mass_1);
       mass_2 = random::cauchy(t2.mass(), t2.width_at_pole() / 2.,
                               t2.min_mass_spectral(), max_mass_2);
-      // determine cm momentum for this case
-      const double pcm = pCM(cms_energy, mass_1, mass_2);
-      const double blw = pcm * blatt_weisskopf_sqr(pcm, L);
-      // determine ratios of full to simple spectral function
-      const double q1 =
-          t1.spectral_function(mass_1) / t1.spectral_function_simple(mass_1);
-      const double q2 =
-          t2.spectral_function(mass_2) / t2.spectral_function_simple(mass_2);
-      val = q1 * q2 * blw;
-    } while (val < random::uniform(0., max));
-
-    if (val > max) {
+      val = value(mass_1, mass_2);
+    } while (val < random::uniform(0., envelope));
+
+    if (val > envelope) {
       const auto &log = logger<LogArea::Resonances>();
       log.debug("maximum is being increased in sample_resonance_masses: ",
-                t1.max_factor2_, " ", val / max, " ", t1.pdgcode(), " ",
+                envelope, " ", val / envelope, " ", t1.pdgcode(), " ",
                 t2.pdgcode(), " ", cms_energy, " ", mass_1, " ", mass_2);
-      t1.max_factor2_ *= val / max;
+      envelope = val;
     } else {
       break;  // maximum ok, exit loop
     }
@@ -796,13 +1104,22 @@ void ParticleType::dump_width_and_spectral_function() const {
   // function decays at high mass, which is true for all known resonances.
   constexpr double spectral_function_threshold = 8.e-3;
   std::cout << std::fixed << std::setprecision(5);
-  for (unsigned int i = 0;; i++) {
-    const double m = m_min + m_step * i;
-    const double w = total_width(m), sf = spectral_function(m);
-    if (m > rightmost_pole * 2 && sf < spectral_function_threshold) {
-      break;
+  // Evaluate the width and spectral function batch-wise over the mass grid.
+  constexpr unsigned int chunk_size = 128;
+  std::vector<double> masses(chunk_size);
+  for (unsigned int i0 = 0;; i0 += chunk_size) {
+    for (unsigned int i = 0; i < chunk_size; i++) {
+      masses[i] = m_min + m_step * (i0 + i);
+    }
+    const std::vector<double> w = total_width(masses);
+    const std::vector<double> sf = spectral_function(masses);
+    for (unsigned int i = 0; i < chunk_size; i++) {
+      if (masses[i] > rightmost_pole * 2 &&
+          sf[i] < spectral_function_threshold) {
+        return;
+      }
+      std::cout << masses[i] << " " << w[i] << " " << sf[i] << std::endl;
     }
-    std::cout << m << " " << w << " " << sf << std::endl;
   }
 }
 
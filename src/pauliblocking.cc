@@ -8,6 +8,10 @@
  */
 
 #include "smash/pauliblocking.h"
+
+#include <algorithm>
+#include <limits>
+
 #include "smash/constants.h"
 #include "smash/logging.h"
 
@@ -19,7 +23,9 @@ PauliBlocker::PauliBlocker(Configuration conf,
       rc_(conf.take({"Gaussian_Cutoff"}, 2.2)),
       rr_(conf.take({"Spatial_Averaging_Radius"}, 1.86)),
       rp_(conf.take({"Momentum_Averaging_Radius"}, 0.08)),
-      ntest_(param.testparticles) {
+      /* All ensembles enter the phase-space density, which improves its
+       * statistics exactly like test particles do. */
+      ntest_(param.testparticles * param.n_ensembles) {
   /*!\Userguide
    * \page pauliblocker Pauli Blocking
    *
@@ -58,36 +64,81 @@ double PauliBlocker::phasespace_dens(const ThreeVector &r, const ThreeVector &p,
                                      const Particles &particles,
                                      const PdgCode pdg,
                                      const ParticleList &disregard) const {
-  double f = 0.0;
+  const double max_rdist_sqr = (rr_ + rc_) * (rr_ + rc_);
 
-  /* TODO(oliiny): looping over all particles is inefficient,
-   * I need only particles within rp_ radius in momentum and
-   * within rr_+rc_ in coordinate space. Some search algorithm might help. */
-  for (const auto &part : particles) {
-    // Only consider identical particles
-    if (part.pdgcode() != pdg) {
-      continue;
-    }
+  /* Collect the squared distances of the contributing particles first;
+   * the weight interpolation runs over them in a separate tight loop. */
+  rdist_sqr_buffer_.clear();
+  const auto collect = [&](const ParticleData &part) {
     // Only consider momenta in sphere of radius rp_ with center at p
     const double pdist_sqr = (part.momentum().threevec() - p).sqr();
     if (pdist_sqr > rp_ * rp_) {
-      continue;
+      return;
     }
     const double rdist_sqr = (part.position().threevec() - r).sqr();
     // Only consider coordinates in sphere of radius rr_+rc_ with center at r
-    if (rdist_sqr >= (rr_ + rc_) * (rr_ + rc_)) {
-      continue;
+    if (rdist_sqr >= max_rdist_sqr) {
+      return;
     }
     // Do not count particles that should be disregarded.
-    bool to_disregard = false;
     for (const auto &disregard_part : disregard) {
       if (part.id() == disregard_part.id()) {
-        to_disregard = true;
+        return;
       }
     }
-    if (to_disregard) {
-      continue;
+    rdist_sqr_buffer_.push_back(rdist_sqr);
+  };
+
+  if (index_built_) {
+    /* Visit only the cells overlapping the gathering sphere. The index
+     * holds the positions of the last build; the gathering radius
+     * includes the drift margin, so no particle that meanwhile moved
+     * into the averaging sphere is missed. */
+    std::array<int, 3> lo, hi;
+    for (int i = 0; i < 3; i++) {
+      lo[i] = std::max(
+          static_cast<int>(
+              std::floor((r[i] - index_radius_ - index_min_[i]) *
+                         index_factor_)),
+          0);
+      hi[i] = std::min(
+          static_cast<int>(
+              std::floor((r[i] + index_radius_ - index_min_[i]) *
+                         index_factor_)),
+          index_cells_[i] - 1);
+    }
+    for (int iz = lo[2]; iz <= hi[2]; iz++) {
+      for (int iy = lo[1]; iy <= hi[1]; iy++) {
+        for (int ix = lo[0]; ix <= hi[0]; ix++) {
+          const ParticleList &cell =
+              cells_[ix + index_cells_[0] * (iy + index_cells_[1] * iz)];
+          for (const auto &indexed : cell) {
+            // Only consider identical particles
+            if (indexed.pdgcode() != pdg) {
+              continue;
+            }
+            // Skip entries whose particle interacted since the build ...
+            if (!particles.is_valid(indexed)) {
+              continue;
+            }
+            // ... and take the current state of the surviving ones.
+            collect(particles.lookup(indexed));
+          }
+        }
+      }
+    }
+  } else {
+    for (const auto &part : particles) {
+      // Only consider identical particles
+      if (part.pdgcode() != pdg) {
+        continue;
+      }
+      collect(part);
     }
+  }
+
+  double f = 0.0;
+  for (const double rdist_sqr : rdist_sqr_buffer_) {
     // 1st order interpolation using tabulated values
     const double i_real = std::sqrt(rdist_sqr) / (rr_ + rc_) * weights_.size();
     const size_t i = std::floor(i_real);
@@ -96,7 +147,70 @@ double PauliBlocker::phasespace_dens(const ThreeVector &r, const ThreeVector &p,
       f += weights_[i] * rest + weights_[i + 1] * (1. - rest);
     }
   }
-  return f / ntest_;
+  return f;
+}
+
+void PauliBlocker::build_index(const Particles &particles,
+                               double drift_margin) {
+  index_radius_ = rr_ + rc_ + drift_margin;
+  index_built_ = true;
+  std::array<double, 3> min, max;
+  min.fill(std::numeric_limits<double>::max());
+  max.fill(-std::numeric_limits<double>::max());
+  size_t n_baryons = 0;
+  for (const auto &part : particles) {
+    if (!part.is_baryon()) {
+      continue;
+    }
+    n_baryons++;
+    const ThreeVector pos = part.position().threevec();
+    for (int i = 0; i < 3; i++) {
+      min[i] = std::min(min[i], pos[i]);
+      max[i] = std::max(max[i], pos[i]);
+    }
+  }
+  if (n_baryons == 0) {
+    index_min_ = {{0., 0., 0.}};
+    index_cells_ = {{1, 1, 1}};
+    index_factor_ = 1. / index_radius_;
+    cells_.resize(1);
+    cells_[0].clear();
+    return;
+  }
+  size_t n_cells = 1;
+  for (int i = 0; i < 3; i++) {
+    index_min_[i] = min[i];
+    index_cells_[i] =
+        static_cast<int>(std::floor((max[i] - min[i]) / index_radius_)) + 1;
+    n_cells *= index_cells_[i];
+  }
+  index_factor_ = 1. / index_radius_;
+  cells_.resize(n_cells);
+  for (auto &cell : cells_) {
+    cell.clear();
+  }
+  for (const auto &part : particles) {
+    if (part.is_baryon()) {
+      cells_[index_cell(part.position().threevec())].push_back(part);
+    }
+  }
+}
+
+void PauliBlocker::add_to_index(const ParticleData &p) {
+  if (!index_built_ || !p.is_baryon()) {
+    return;
+  }
+  cells_[index_cell(p.position().threevec())].push_back(p);
+}
+
+int PauliBlocker::index_cell(const ThreeVector &pos) const {
+  std::array<int, 3> c;
+  for (int i = 0; i < 3; i++) {
+    c[i] = static_cast<int>(
+        std::floor((pos[i] - index_min_[i]) * index_factor_));
+    c[i] = std::min(std::max(c[i], 0), index_cells_[i] - 1);
+  }
+  return c[0] + index_cells_[0] * (c[1] + index_cells_[1] * c[2]);
 }
 
 void PauliBlocker::init_weights_analytical() {
@@ -142,7 +256,9 @@ void PauliBlocker::init_weights_analytical() {
       integral *= sig_ * sig_;
     }
     integral *= 2 * pi / std::pow(2 * pi * sig_ * sig_, 1.5);
-    weights_[k] = integral / norm / phase_volume;
+    /* The test-particle factor is folded into the table, so summing the
+     * weights directly yields the phase-space density. */
+    weights_[k] = integral / norm / phase_volume / ntest_;
     log.debug("Analytical weights[", k, "] = ", weights_[k]);
   }
 }
@@ -11,10 +11,19 @@
 
 #include <limits>
 
+#include "smash/memorypool.h"
 #include "smash/particledata.h"
 
 namespace smash {
 
+void *ProcessBranch::operator new(std::size_t size) {
+  return memory_pool::allocate(size);
+}
+
+void ProcessBranch::operator delete(void *ptr) {
+  memory_pool::deallocate(ptr);
+}
+
 bool is_string_soft_process(ProcessType p) {
   return p == ProcessType::StringSoftSingleDiffractiveAX ||
          p == ProcessType::StringSoftSingleDiffractiveXB ||
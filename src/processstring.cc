@@ -13,9 +13,22 @@
 #include "smash/kinematics.h"
 #include "smash/processstring.h"
 #include "smash/random.h"
+#include "smash/startupprofiler.h"
+#include "smash/threadpool.h"
+#include "smash/tracerecorder.h"
 
 namespace smash {
 
+namespace {
+/// Possible species for a leading (anti)baryon with given conserved charges.
+struct LeadingBaryonCandidates {
+  /// PDG ids of the possible species.
+  std::vector<int> pdgid;
+  /// Cumulative sampling weights; weight_summed[i + 1] includes pdgid[i].
+  std::vector<double> weight_summed;
+};
+}  // namespace
+
 StringProcess::StringProcess(double string_tension, double time_formation,
                              double gluon_beta, double gluon_pmin,
                              double quark_alpha, double quark_beta,
@@ -38,7 +51,36 @@ StringProcess::StringProcess(double string_tension, double time_formation,
       soft_t_form_(factor_t_form),
       time_collision_(0.),
       use_yoyo_model_(use_yoyo_model),
-      prob_proton_to_d_uu_(prob_proton_to_d_uu) {
+      prob_proton_to_d_uu_(prob_proton_to_d_uu),
+      strange_supp_(strange_supp),
+      diquark_supp_(diquark_supp),
+      stringz_a_(stringz_a),
+      stringz_b_(stringz_b),
+      string_sigma_T_(string_sigma_T) {
+  /* The PYTHIA objects are not created here: their creation and
+   * initialization costs seconds of startup time and a sizable amount of
+   * memory, so it is deferred via require_pythia() until the first string
+   * process is actually requested. */
+  sqrt2_ = std::sqrt(2.);
+
+  for (int imu = 0; imu < 3; imu++) {
+    evecBasisAB_[imu] = ThreeVector(0., 0., 0.);
+  }
+
+  final_state_.clear();
+}
+
+void StringProcess::require_pythia() {
+  std::call_once(pythia_init_once_, &StringProcess::initialize_pythia, this);
+}
+
+void StringProcess::initialize_pythia() {
+  /* The initialization is deferred to the first string excitation, so with
+   * startup profiling it shows up as a deferred phase in the run log. */
+  StartupProfiler::Phase phase("PYTHIA initialization");
+  /* With tracing, the initialization stall shows up at its position in the
+   * timeline of the first event. */
+  TraceRecorder::Span trace_span("pythia_init");
   // setup and initialize pythia for hard string process
   pythia_parton_ = make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
   /* select only non-diffractive events
@@ -46,15 +88,15 @@ StringProcess::StringProcess(double string_tension, double time_formation,
   pythia_parton_->readString("SoftQCD:nonDiffractive = on");
   pythia_parton_->readString("MultipartonInteractions:pTmin = 1.5");
   pythia_parton_->readString("HadronLevel:all = off");
-  common_setup_pythia(pythia_parton_.get(), strange_supp, diquark_supp,
-                      stringz_a, stringz_b, string_sigma_T);
+  common_setup_pythia(pythia_parton_.get(), strange_supp_, diquark_supp_,
+                      stringz_a_, stringz_b_, string_sigma_T_);
 
   // setup and initialize pythia for fragmentation
   pythia_hadron_ = make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
   /* turn off all parton-level processes to implement only hadronization */
   pythia_hadron_->readString("ProcessLevel:all = off");
-  common_setup_pythia(pythia_hadron_.get(), strange_supp, diquark_supp,
-                      stringz_a, stringz_b, string_sigma_T);
+  common_setup_pythia(pythia_hadron_.get(), strange_supp_, diquark_supp_,
+                      stringz_a_, stringz_b_, string_sigma_T_);
 
   /* initialize PYTHIA */
   pythia_hadron_->init();
@@ -63,13 +105,27 @@ StringProcess::StringProcess(double string_tension, double time_formation,
   event_intermediate_.init("intermediate partons",
                            &pythia_hadron_->particleData);
 
-  sqrt2_ = std::sqrt(2.);
-
-  for (int imu = 0; imu < 3; imu++) {
-    evecBasisAB_[imu] = ThreeVector(0., 0., 0.);
+  /* The fragmentation instances are configured like pythia_hadron_ and
+   * created lazily, so a serial run initializes no more than one of them. */
+  ThreadPool *const pool = shared_pool();
+  const int pool_capacity = pool ? pool->num_threads() : 1;
+  pythia_hadron_pool_ = make_unique<PythiaPool>(
+      pool_capacity, [this](Pythia8::Pythia &pythia) {
+        /* turn off all parton-level processes to implement only
+         * hadronization */
+        pythia.readString("ProcessLevel:all = off");
+        common_setup_pythia(&pythia, strange_supp_, diquark_supp_, stringz_a_,
+                            stringz_b_, string_sigma_T_);
+      });
+
+  pythia_initialized_ = true;
+  if (pythia_seed_pending_) {
+    /* Apply the seed of the current event, which was drawn before the
+     * deferred initialization happened. */
+    pythia_hadron_->rndm.init(pythia_seed_);
+    pythia_hadron_pool_->seed(pythia_seed_);
+    pythia_seed_pending_ = false;
   }
-
-  final_state_.clear();
 }
 
 void StringProcess::common_setup_pythia(Pythia8::Pythia *pythia_in,
@@ -155,7 +211,10 @@ int StringProcess::append_final_state(ParticleList &intermediate_particles,
   assign_all_scaling_factors(bstring, intermediate_particles, evecLong,
                              additional_xsec_supp_);
 
-  std::vector<double> xvertex_pos, xvertex_neg;
+  /* Scratch buffers for the formation vertices, reused across calls so
+   * that converting a fragmented string does not allocate. Every entry is
+   * overwritten below. */
+  static thread_local std::vector<double> xvertex_pos, xvertex_neg;
   xvertex_pos.resize(nfrag + 1);
   xvertex_neg.resize(nfrag + 1);
   // x^{+} coordinates of the forward end
@@ -218,6 +277,7 @@ int StringProcess::append_final_state(ParticleList &intermediate_particles,
 }
 
 void StringProcess::init(const ParticleList &incoming, double tcoll) {
+  require_pythia();
   PDGcodes_[0] = incoming[0].pdgcode();
   PDGcodes_[1] = incoming[1].pdgcode();
   massA_ = incoming[0].effective_mass();
@@ -305,8 +365,10 @@ bool StringProcess::next_SDiff(bool is_AB_to_AX) {
   const FourVector pnull = FourVector(threeMomentum.abs(), threeMomentum);
   const FourVector prs = pnull.LorentzBoost(ustrXcom.velocity());
   ThreeVector evec = prs.threevec() / prs.threevec().abs();
-  // perform fragmentation and add particles to final_state.
-  ParticleList new_intermediate_particles;
+  /* perform fragmentation and add particles to final_state.
+   * The scratch buffer is reused across calls (fragment_string() clears it)
+   * to avoid reallocating the hadron list for every string. */
+  static thread_local ParticleList new_intermediate_particles;
   bool separate_fragment_baryon = false;
   int nfrag =
       fragment_string(idqX1, idqX2, massX, evec, true, separate_fragment_baryon,
@@ -376,7 +438,8 @@ bool StringProcess::make_final_state_2strings(
   const std::array<FourVector, 2> ustr_com = {pstr_com[0] / m_str[0],
                                               pstr_com[1] / m_str[1]};
   for (int i = 0; i < 2; i++) {
-    ParticleList new_intermediate_particles;
+    // scratch buffer reused across calls, cleared by fragment_string().
+    static thread_local ParticleList new_intermediate_particles;
 
     // determine direction in which string i is stretched.
     ThreeVector evec = evec_str[i];
@@ -606,8 +669,11 @@ bool StringProcess::next_NDiffHard() {
     return false;
   }
 
-  ParticleList new_intermediate_particles;
-  ParticleList new_non_hadron_particles;
+  /* Conversion scratch buffers, reused across calls so that the hadron
+   * lists do not reallocate for every hard event. */
+  static thread_local ParticleList new_intermediate_particles;
+  static thread_local ParticleList new_non_hadron_particles;
+  new_non_hadron_particles.clear();
 
   Pythia8::Vec4 pSum = 0.;
   event_intermediate_.reset();
@@ -1618,7 +1684,8 @@ bool StringProcess::next_BBbarAnn() {
   }
   // Fragment two strings
   for (int i = 0; i < 2; i++) {
-    ParticleList new_intermediate_particles;
+    // scratch buffer reused across calls, cleared by fragment_string().
+    static thread_local ParticleList new_intermediate_particles;
 
     ThreeVector evec = pcom_[i].threevec() / pcom_[i].threevec().abs();
     const int nfrag =
@@ -1767,7 +1834,11 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
                                    bool separate_fragment_baryon,
                                    ParticleList &intermediate_particles) {
   const auto &log = logger<LogArea::Pythia>();
-  pythia_hadron_->event.reset();
+  /* Check a pre-initialized instance out of the pool, so concurrent
+   * fragmentations each work on their own PYTHIA object. */
+  PythiaPool::Lease lease = pythia_hadron_pool_->acquire();
+  Pythia8::Pythia &pythia = *lease;
+  pythia.event.reset();
   intermediate_particles.clear();
 
   log.debug("initial quark content for fragment_string : ", idq1, ", ", idq2);
@@ -1782,9 +1853,9 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
 
   for (int i = 0; i < 2; i++) {
     // evaluate total baryon number of the string times 3
-    bstring += pythia_hadron_->particleData.baryonNumberType(idqIn[i]);
+    bstring += pythia.particleData.baryonNumberType(idqIn[i]);
 
-    m_const[i] = pythia_hadron_->particleData.m0(idqIn[i]);
+    m_const[i] = pythia.particleData.m0(idqIn[i]);
   }
   log.debug("baryon number of string times 3 : ", bstring);
 
@@ -1809,8 +1880,8 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
      * the leading baryon (antibaryon) is fragmented from the original string
      * with a gaussian fragmentation function.
      * It is then followed by fragmentation of the remaining mesonic string. */
-    const double ssbar_supp = pythia_hadron_->parm("StringFlav:probStoUD");
-    const double sigma_qt_frag = pythia_hadron_->parm("StringPT:sigma");
+    const double ssbar_supp = pythia.parm("StringFlav:probStoUD");
+    const double sigma_qt_frag = pythia.parm("StringPT:sigma");
     std::array<ThreeVector, 3> evec_basis;
     make_orthonormal_basis(evecLong, evec_basis);
 
@@ -1866,8 +1937,8 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
       for (int iq = 0; iq < 5; iq++) {
         frag_net_q[iq] =
             (bstring > 0 ? 1 : -1) *
-            (pythia_hadron_->particleData.nQuarksInCode(idnew_qqbar, iq + 1) +
-             pythia_hadron_->particleData.nQuarksInCode(id_diquark, iq + 1));
+            (pythia.particleData.nQuarksInCode(idnew_qqbar, iq + 1) +
+             pythia.particleData.nQuarksInCode(id_diquark, iq + 1));
       }
       const int frag_iso3 = frag_net_q[1] - frag_net_q[0];
       const int frag_strange = -frag_net_q[2];
@@ -1877,36 +1948,49 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
                 ", strangeness = ", frag_strange, ", charmness = ", frag_charm,
                 ", bottomness = ", frag_bottom);
 
-      std::vector<int> pdgid_possible;
-      std::vector<double> weight_possible;
-      std::vector<double> weight_summed;
-      /* loop over hadronic species
-       * Any hadron with the same valence quark contents is allowed and
-       * the probability goes like spin degeneracy over mass. */
-      for (auto &ptype : ParticleType::list_all()) {
-        const int pdgid =
-            (bstring > 0 ? 1 : -1) * std::abs(ptype.pdgcode().get_decimal());
-        if ((pythia_hadron_->particleData.isParticle(pdgid)) &&
-            (bstring == 3 * ptype.pdgcode().baryon_number()) &&
-            (frag_iso3 == ptype.pdgcode().isospin3()) &&
-            (frag_strange == ptype.pdgcode().strangeness()) &&
-            (frag_charm == ptype.pdgcode().charmness()) &&
-            (frag_bottom == ptype.pdgcode().bottomness())) {
-          const int spin_degeneracy = ptype.pdgcode().spin_degeneracy();
-          const double mass_pole = ptype.mass();
-          const double weight =
-              static_cast<double>(spin_degeneracy) / mass_pole;
-          pdgid_possible.push_back(pdgid);
-          weight_possible.push_back(weight);
-
-          log.debug("  PDG id ", pdgid, " is possible with weight ", weight);
+      /* The list of allowed species only depends on the conserved charges,
+       * so it is memoized instead of being rebuilt from a scan over all
+       * particle species in every rejection iteration. All pooled PYTHIA
+       * instances share the same particle database, hence one table per
+       * thread suffices. */
+      static thread_local std::map<std::array<int, 5>, LeadingBaryonCandidates>
+          candidate_cache;
+      const std::array<int, 5> frag_key = {bstring, frag_iso3, frag_strange,
+                                           frag_charm, frag_bottom};
+      auto cand_iter = candidate_cache.find(frag_key);
+      if (cand_iter == candidate_cache.end()) {
+        LeadingBaryonCandidates candidates;
+        candidates.weight_summed.push_back(0.);
+        /* loop over hadronic species
+         * Any hadron with the same valence quark contents is allowed and
+         * the probability goes like spin degeneracy over mass. */
+        for (auto &ptype : ParticleType::list_all()) {
+          const int pdgid =
+              (bstring > 0 ? 1 : -1) * std::abs(ptype.pdgcode().get_decimal());
+          if ((pythia.particleData.isParticle(pdgid)) &&
+              (bstring == 3 * ptype.pdgcode().baryon_number()) &&
+              (frag_iso3 == ptype.pdgcode().isospin3()) &&
+              (frag_strange == ptype.pdgcode().strangeness()) &&
+              (frag_charm == ptype.pdgcode().charmness()) &&
+              (frag_bottom == ptype.pdgcode().bottomness())) {
+            const int spin_degeneracy = ptype.pdgcode().spin_degeneracy();
+            const double mass_pole = ptype.mass();
+            const double weight =
+                static_cast<double>(spin_degeneracy) / mass_pole;
+            candidates.pdgid.push_back(pdgid);
+            candidates.weight_summed.push_back(
+                candidates.weight_summed.back() + weight);
+
+            log.debug("  PDG id ", pdgid, " is possible with weight ", weight);
+          }
         }
+        cand_iter =
+            candidate_cache.emplace(frag_key, std::move(candidates)).first;
       }
+      const std::vector<int> &pdgid_possible = cand_iter->second.pdgid;
+      const std::vector<double> &weight_summed =
+          cand_iter->second.weight_summed;
       const int n_possible = pdgid_possible.size();
-      weight_summed.push_back(0.);
-      for (int i = 0; i < n_possible; i++) {
-        weight_summed.push_back(weight_summed[i] + weight_possible[i]);
-      }
 
       /* Sample baryon (antibaryon) specie,
        * which is fragmented from the leading diquark (anti-diquark). */
@@ -1920,7 +2004,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
         }
       }
       // Sample mass.
-      const double mass_frag = pythia_hadron_->particleData.mSel(pdgid_frag);
+      const double mass_frag = pythia.particleData.mSel(pdgid_frag);
 
       // Sample transverse momentum carried by baryon (antibaryon).
       QTrx = random::normal(0., sigma_qt_frag / sqrt2_);
@@ -1974,7 +2058,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
        * different from those of the original string.
        * Therefore, the constituent masses have to be updated. */
       for (int i = 0; i < 2; i++) {
-        m_const[i] = pythia_hadron_->particleData.m0(idqIn[i]);
+        m_const[i] = pythia.particleData.m0(idqIn[i]);
       }
       if (bstring > 0) {  // in the case of baryonic string
         /* Quark is coming from the original string
@@ -2068,7 +2152,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
     }
     pquark = set_Vec4((ppos_parton[0] + pneg_parton[0]) / sqrt2_, three_mom);
     pSum += pquark;
-    pythia_hadron_->event.append(idqIn[0], status, color, anticolor, pquark,
+    pythia.event.append(idqIn[0], status, color, anticolor, pquark,
                                  m_const[0]);
 
     // antiquark end of the remaining (mesonic) string
@@ -2087,7 +2171,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
     }
     pquark = set_Vec4((ppos_parton[1] + pneg_parton[1]) / sqrt2_, three_mom);
     pSum += pquark;
-    pythia_hadron_->event.append(idqIn[1], status, color, anticolor, pquark,
+    pythia.event.append(idqIn[1], status, color, anticolor, pquark,
                                  m_const[1]);
   } else {
     /* diquark (anti-quark) with PDG id idq2 is going in the direction of
@@ -2112,33 +2196,33 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
     const int status1 = 1, color1 = 1, anticolor1 = 0;
     Pythia8::Vec4 pquark = set_Vec4(E1, -direction * pCMquark);
     pSum += pquark;
-    pythia_hadron_->event.append(idqIn[0], status1, color1, anticolor1, pquark,
+    pythia.event.append(idqIn[0], status1, color1, anticolor1, pquark,
                                  m_const[0]);
 
     const int status2 = 1, color2 = 0, anticolor2 = 1;
     pquark = set_Vec4(E2, direction * pCMquark);
     pSum += pquark;
-    pythia_hadron_->event.append(idqIn[1], status2, color2, anticolor2, pquark,
+    pythia.event.append(idqIn[1], status2, color2, anticolor2, pquark,
                                  m_const[1]);
   }
 
   log.debug("fragmenting a string with ", idqIn[0], ", ", idqIn[1]);
   // implement PYTHIA fragmentation
-  pythia_hadron_->event[0].p(pSum);
-  pythia_hadron_->event[0].m(pSum.mCalc());
-  const bool successful_hadronization = pythia_hadron_->next();
+  pythia.event[0].p(pSum);
+  pythia.event[0].m(pSum.mCalc());
+  const bool successful_hadronization = pythia.next();
   if (successful_hadronization) {
-    for (int ipyth = 0; ipyth < pythia_hadron_->event.size(); ipyth++) {
-      if (!pythia_hadron_->event[ipyth].isFinal()) {
+    for (int ipyth = 0; ipyth < pythia.event.size(); ipyth++) {
+      if (!pythia.event[ipyth].isFinal()) {
         continue;
       }
-      int pythia_id = pythia_hadron_->event[ipyth].id();
+      int pythia_id = pythia.event[ipyth].id();
       /* K_short and K_long need are converted to K0
        * since SMASH only knows K0 */
       convert_KaonLS(pythia_id);
       FourVector momentum(
-          pythia_hadron_->event[ipyth].e(), pythia_hadron_->event[ipyth].px(),
-          pythia_hadron_->event[ipyth].py(), pythia_hadron_->event[ipyth].pz());
+          pythia.event[ipyth].e(), pythia.event[ipyth].px(),
+          pythia.event[ipyth].py(), pythia.event[ipyth].pz());
       log.debug("appending the fragmented hadron ", pythia_id,
                 " to the intermediate particle list.");
       bool found_ptype =
@@ -9,6 +9,11 @@
 
 #include "smash/propagation.h"
 
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
 #include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
 #include "smash/listmodus.h"
@@ -42,45 +47,8 @@ double calc_hubble(double time, const ExpansionProperties &metric) {
 
 double propagate_straight_line(Particles *particles, double to_time,
                                const std::vector<FourVector> &beam_momentum) {
-  const auto &log = logger<LogArea::Propagation>();
-  bool negative_dt_error = false;
-  double dt = 0.0;
-  for (ParticleData &data : *particles) {
-    const double t0 = data.position().x0();
-    dt = to_time - t0;
-    if (dt < 0.0 && !negative_dt_error) {
-      // Print error message once, not for every particle
-      negative_dt_error = true;
-      log.error("propagate_straight_line - negative dt = ", dt);
-    }
-    assert(dt >= 0.0);
-    /* "Frozen Fermi motion": Fermi momenta are only used for collisions,
-     * but not for propagation. This is done to avoid nucleus flying apart
-     * even if potentials are off. Initial nucleons before the first collision
-     * are propagated only according to beam momentum.
-     * Initial nucleons are distinguished by data.id() < the size of
-     * beam_momentum, which is by default zero except for the collider modus
-     * with the fermi motion == frozen.
-     * todo(m. mayer): improve this condition (see comment #11 issue #4213)*/
-    assert(data.id() >= 0);
-    const bool avoid_fermi_motion =
-        (static_cast<uint64_t>(data.id()) <
-         static_cast<uint64_t>(beam_momentum.size())) &&
-        (data.get_history().collisions_per_particle == 0);
-    ThreeVector v;
-    if (avoid_fermi_motion) {
-      const FourVector vbeam = beam_momentum[data.id()];
-      v = vbeam.velocity();
-    } else {
-      v = data.velocity();
-    }
-    const FourVector distance = FourVector(0.0, v * dt);
-    log.debug("Particle ", data, " motion: ", distance);
-    FourVector position = data.position() + distance;
-    position.set_x0(to_time);
-    data.set_4position(position);
-  }
-  return dt;
+  return propagate_straight_line_fused(particles, to_time, beam_momentum,
+                                       [](const ParticleData &, double) {});
 }
 
 void expand_space_time(Particles *particles,
@@ -111,7 +79,10 @@ void expand_space_time(Particles *particles,
 void update_momenta(
     Particles *particles, double dt, const Potentials &pot,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat) {
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_core_lat,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_core_lat,
+    bool interpolate_forces) {
   // Copy particles before propagation to calculate potentials from them
   const ParticleList plist = particles->copy_to_vector();
 
@@ -119,23 +90,103 @@ void update_momenta(
   bool possibly_use_lattice =
       (pot.use_skyrme() ? (FB_lat != nullptr) : true) &&
       (pot.use_symmetry() ? (FI3_lat != nullptr) : true);
+  const bool possibly_use_core =
+      possibly_use_lattice &&
+      (pot.use_skyrme() ? (FB_core_lat != nullptr) : true) &&
+      (pot.use_symmetry() ? (FI3_core_lat != nullptr) : true) &&
+      (FB_core_lat != nullptr || FI3_core_lat != nullptr);
   std::pair<ThreeVector, ThreeVector> FB, FI3;
   double min_time_scale = std::numeric_limits<double>::infinity();
 
+  /* Sort the baryons by the lattice cell their position falls into, so
+   * that the forces of all particles sharing a cell are taken from a
+   * single pair of node reads and the pass streams through the lattice
+   * in memory order instead of jumping around it. The force lattices
+   * are created with identical geometry (see the lattice setup in
+   * ExperimentImplementation), so one of them can locate the cell for
+   * both. Particles inside the optional core refinement take their
+   * force from its finer lattice; its cells sort in front of the
+   * enclosing lattice's cells, which get an index offset of the core
+   * lattice size. Cell index -1 collects the baryons that are off the
+   * lattice and fall back to the direct potential evaluation. */
+  typedef std::pair<int, ParticleData *> CellOfParticle;
+  std::vector<CellOfParticle> baryons;
+  const auto *index_lat = pot.use_skyrme() ? FB_lat : FI3_lat;
+  const auto *core_index_lat = pot.use_skyrme() ? FB_core_lat : FI3_core_lat;
+  const int core_offset =
+      possibly_use_core ? static_cast<int>(core_index_lat->size()) : 0;
   for (ParticleData &data : *particles) {
     // Only baryons will be affected by the potentials
     if (!data.is_baryon()) {
       continue;
     }
+    int cell = -1;
+    if (possibly_use_lattice && index_lat != nullptr) {
+      const ThreeVector pos = data.position().threevec();
+      if (possibly_use_core) {
+        cell = core_index_lat->cell_index_at(pos);
+      }
+      if (cell < 0) {
+        const int coarse_cell = index_lat->cell_index_at(pos);
+        cell = coarse_cell >= 0 ? core_offset + coarse_cell : -1;
+      }
+    }
+    baryons.emplace_back(cell, &data);
+  }
+  std::sort(baryons.begin(), baryons.end(),
+            [](const CellOfParticle &a, const CellOfParticle &b) {
+              return a.first < b.first;
+            });
+
+  int loaded_cell = -1;
+  for (const CellOfParticle &entry : baryons) {
+    ParticleData &data = *entry.second;
     const auto scale = pot.force_scale(data.type());
     const ThreeVector r = data.position().threevec();
     /* Lattices can be used for calculation if 1-2 are fulfilled:
      * 1) Required lattices are not nullptr - possibly_use_lattice
      * 2) r is not out of required lattices */
-    const bool use_lattice =
-        possibly_use_lattice &&
-        (pot.use_skyrme() ? FB_lat->value_at(r, FB) : true) &&
-        (pot.use_symmetry() ? FI3_lat->value_at(r, FI3) : true);
+    const bool use_lattice = entry.first >= 0;
+    if (use_lattice && interpolate_forces) {
+      /* Average the forces of the eight nodes around the particle with
+       * trilinear weights, so the force varies smoothly between nodes
+       * instead of jumping when a cell boundary is crossed. The cell
+       * sort above still keeps the node reads of neighboring particles
+       * close together in memory. */
+      const bool in_core = entry.first < core_offset;
+      const auto *geometry = in_core ? core_index_lat : index_lat;
+      std::array<std::size_t, 8> nodes;
+      std::array<double, 8> weights;
+      if (geometry->interpolation_nodes(r, nodes, weights)) {
+        FB = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
+        FI3 = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
+        for (int c = 0; c < 8; c++) {
+          if (pot.use_skyrme()) {
+            const auto &node =
+                in_core ? (*FB_core_lat)[nodes[c]] : (*FB_lat)[nodes[c]];
+            FB.first += node.first * weights[c];
+            FB.second += node.second * weights[c];
+          }
+          if (pot.use_symmetry()) {
+            const auto &node =
+                in_core ? (*FI3_core_lat)[nodes[c]] : (*FI3_lat)[nodes[c]];
+            FI3.first += node.first * weights[c];
+            FI3.second += node.second * weights[c];
+          }
+        }
+        loaded_cell = -1;
+      }
+    } else if (use_lattice && entry.first != loaded_cell) {
+      loaded_cell = entry.first;
+      const bool in_core = loaded_cell < core_offset;
+      const int node = in_core ? loaded_cell : loaded_cell - core_offset;
+      if (pot.use_skyrme()) {
+        FB = in_core ? (*FB_core_lat)[node] : (*FB_lat)[node];
+      }
+      if (pot.use_symmetry()) {
+        FI3 = in_core ? (*FI3_core_lat)[node] : (*FI3_lat)[node];
+      }
+    }
     if (!pot.use_skyrme()) {
       FB = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
     }
@@ -0,0 +1,93 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/pythiapool.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "smash/constants.h"
+#include "smash/cxx14compat.h"
+#include "smash/threadpool.h"
+
+namespace smash {
+
+PythiaPool::PythiaPool(int capacity, Setup setup)
+    : capacity_(capacity), setup_(std::move(setup)) {
+  if (capacity < 1) {
+    throw std::invalid_argument("PythiaPool needs a positive capacity.");
+  }
+  instances_.reserve(capacity);
+}
+
+PythiaPool::Lease PythiaPool::acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (free_.empty()) {
+    if (static_cast<int>(instances_.size()) < capacity_) {
+      const int index = instances_.size();
+      auto pythia = make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
+      setup_(*pythia);
+      pythia->init();
+      /* Same seeding rule as in seed(), so the seed of an instance does not
+       * depend on when it was created. */
+      pythia->rndm.init((base_seed_ + index) % maximum_rndm_seed_in_pythia +
+                        1);
+      free_.push_back(pythia.get());
+      instances_.push_back(std::move(pythia));
+      break;
+    }
+    instance_available_.wait(lock);
+  }
+  Pythia8::Pythia *pythia = free_.back();
+  free_.pop_back();
+  return Lease(this, pythia);
+}
+
+std::future<void> PythiaPool::run_async(
+    std::function<void(Pythia8::Pythia &)> task) {
+  ThreadPool *const pool = shared_pool();
+  if (pool) {
+    auto shared_task =
+        std::make_shared<std::function<void(Pythia8::Pythia &)>>(
+            std::move(task));
+    return pool->submit([this, shared_task] {
+      Lease lease = acquire();
+      (*shared_task)(*lease);
+    });
+  }
+  std::promise<void> promise;
+  try {
+    Lease lease = acquire();
+    task(*lease);
+    promise.set_value();
+  } catch (...) {
+    promise.set_exception(std::current_exception());
+  }
+  return promise.get_future();
+}
+
+void PythiaPool::seed(int base_seed) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  base_seed_ = base_seed;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    instances_[i]->rndm.init((base_seed_ + static_cast<int>(i)) %
+                                 maximum_rndm_seed_in_pythia +
+                             1);
+  }
+}
+
+void PythiaPool::release(Pythia8::Pythia *pythia) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    free_.push_back(pythia);
+  }
+  instance_available_.notify_one();
+}
+
+}  // namespace smash
@@ -12,7 +12,74 @@
 #include "smash/logging.h"
 
 namespace smash {
-/*thread_local (see #3075)*/ random::Engine random::engine;
+thread_local random::Engine random::engine;
+
+namespace {
+
+/**
+ * Strip tables of the ziggurat method for the standard normal
+ * distribution, following Marsaglia and Tsang (2000) with 128 strips.
+ * The x values are the strip widths in decreasing order, the y values
+ * the density at those widths.
+ */
+struct ZigguratTables {
+  /// Strip widths, x[1] is the start of the tail.
+  double x[129];
+  /// Density values exp(-x*x/2) at the strip widths.
+  double y[129];
+  /// Build the tables of equal-area strips.
+  ZigguratTables() {
+    constexpr double r = 3.442619855899;       // tail start
+    constexpr double v = 9.91256303526217e-3;  // area of each strip
+    const auto f = [](double xx) { return std::exp(-0.5 * xx * xx); };
+    x[0] = v / f(r);  // base strip width, chosen to include the tail area
+    x[1] = r;
+    for (int i = 2; i < 128; i++) {
+      x[i] = std::sqrt(-2. * std::log(v / x[i - 1] + f(x[i - 1])));
+    }
+    x[128] = 0.;
+    for (int i = 0; i <= 128; i++) {
+      y[i] = f(x[i]);
+    }
+  }
+};
+
+/// The tables, built once at startup.
+const ZigguratTables ziggurat;
+
+}  // unnamed namespace
+
+double random::standard_normal() {
+  for (;;) {
+    /* One engine value provides the strip index (7 bits), the sign
+     * (1 bit) and a uniform double from the 53 most significant bits. */
+    const uint64_t bits = engine();
+    const int i = bits & 127;
+    const double sign = (bits & 128) ? -1. : 1.;
+    const double u = (bits >> 11) * (1. / 9007199254740992.);
+    const double x = u * ziggurat.x[i];
+    if (x < ziggurat.x[i + 1]) {
+      // Inside the strip: the overwhelmingly common case.
+      return sign * x;
+    }
+    if (i == 0) {
+      // Sample the tail beyond the last strip (Marsaglia, 1964).
+      constexpr double r = 3.442619855899;
+      double xx, yy;
+      do {
+        xx = -std::log(random::canonical_nonzero()) / r;
+        yy = -std::log(random::canonical_nonzero());
+      } while (yy + yy < xx * xx);
+      return sign * (r + xx);
+    }
+    // In the wedge between the strip and the density: accept by height.
+    if ((ziggurat.y[i + 1] - ziggurat.y[i]) * random::canonical() +
+            ziggurat.y[i] <
+        std::exp(-0.5 * x * x)) {
+      return sign * x;
+    }
+  }
+}
 
 random::BesselSampler::BesselSampler(const double poisson_mean1,
                                      const double poisson_mean2,
@@ -32,9 +32,11 @@ namespace smash {
  *
  * Producing ROOT output requires ROOT installed (see http://root.cern.ch).
  *
- * SMASH produces one ROOT file per run: \c smash_run.root. This file contains
- * a TTree called \c particles and a TTree called \c collisions, depending
- * on the required content (see \ref output_general_). The \c particles
+ * SMASH produces one ROOT file per output content: \c Particles.root with
+ * a TTree called \c particles and \c Collisions.root with a TTree called
+ * \c collisions, depending on the required content (see \ref
+ * output_general_). Keeping the trees in separate files avoids interleaved
+ * writes of the two contents. The \c particles
  * tree contains the same information as OSCAR particles output and the
  * \c collisions tree contains the same information as OSCAR collision output.
  *
@@ -42,6 +44,10 @@ namespace smash {
  * (see \ref input_dileptons), the file is called \c Dileptons.root and
  * only contains a \c collisions tree with all the dilepton decays.
  *
+ * The buffering of the trees can be tuned with the optional \key Root
+ * section of the output configuration, see
+ * \ref output_content_specific_options_ "content-specific output options".
+ *
  * Every physical quantity is in a separate TBranch.
  * One entry in the \c particles TTree is:
  * \code
@@ -79,12 +85,14 @@ namespace smash {
 RootOutput::RootOutput(const bf::path &path, const std::string &name,
                        const OutputParameters &out_par)
     : OutputInterface(name),
-      filename_(path / (name + ".root")),
+      filename_(out_par.shard_path(path, name + ".root")),
       write_collisions_(name == "Collisions" || name == "Dileptons" ||
                         name == "Photons"),
       write_particles_(name == "Particles"),
       particles_only_final_(out_par.part_only_final),
-      autosave_frequency_(1000) {
+      autosave_frequency_(out_par.root_autosave_frequency),
+      autoflush_(out_par.root_autoflush),
+      basket_size_(out_par.root_basket_size) {
   const auto &log = logger<LogArea::Output>();
   if (out_par.part_extended || out_par.coll_extended) {
     log.warn() << "Creating Root output: There is no extended Root format.";
@@ -93,6 +101,23 @@ RootOutput::RootOutput(const bf::path &path, const std::string &name,
   filename_unfinished_ += ".unfinished";
   root_out_file_ =
       make_unique<TFile>(filename_unfinished_.native().c_str(), "NEW");
+  /* The numerical values are the ROOT compression algorithm constants
+   * (kZLIB = 1, kLZMA = 2, kLZ4 = 4); they are stable across the supported
+   * ROOT versions. */
+  if (out_par.root_compression == "LZMA") {
+    root_out_file_->SetCompressionAlgorithm(2);
+  } else if (out_par.root_compression == "LZ4") {
+    root_out_file_->SetCompressionAlgorithm(4);
+  } else {
+    if (out_par.root_compression != "ZLIB") {
+      log.warn() << "Creating Root output: unknown compression algorithm \""
+                 << out_par.root_compression << "\", using ZLIB.";
+    }
+    root_out_file_->SetCompressionAlgorithm(1);
+  }
+  if (out_par.root_compression_level >= 0) {
+    root_out_file_->SetCompressionLevel(out_par.root_compression_level);
+  }
   init_trees();
 }
 
@@ -116,6 +141,13 @@ void RootOutput::init_trees() {
     particles_tree_->Branch("x", &x[0], "x[npart]/D");
     particles_tree_->Branch("y", &y[0], "y[npart]/D");
     particles_tree_->Branch("z", &z[0], "z[npart]/D");
+
+    if (autoflush_ != 0) {
+      particles_tree_->SetAutoFlush(autoflush_);
+    }
+    if (basket_size_ > 0) {
+      particles_tree_->SetBasketSize("*", basket_size_);
+    }
   }
 
   if (write_collisions_) {
@@ -139,6 +171,13 @@ void RootOutput::init_trees() {
     collisions_tree_->Branch("x", &x[0], "x[npart]/D");
     collisions_tree_->Branch("y", &y[0], "y[npart]/D");
     collisions_tree_->Branch("z", &z[0], "z[npart]/D");
+
+    if (autoflush_ != 0) {
+      collisions_tree_->SetAutoFlush(autoflush_);
+    }
+    if (basket_size_ > 0) {
+      collisions_tree_->SetBasketSize("*", basket_size_);
+    }
   }
 }
 
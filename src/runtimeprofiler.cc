@@ -0,0 +1,206 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/runtimeprofiler.h"
+
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "smash/action.h"
+
+namespace smash {
+
+namespace {
+
+/// Number of instrumented phases of the evolution loop.
+constexpr std::size_t num_phases = 4;
+
+/// Human- and machine-readable names of the phases, in enumerator order.
+constexpr std::array<const char *, num_phases> phase_names = {
+    {"collision_search", "propagation", "lattice_update", "output"}};
+
+/// Cycles and call counts of one accumulator.
+struct Account {
+  /// Accumulated CPU cycles.
+  uint64_t cycles = 0;
+  /// Number of accumulated measurements.
+  uint64_t calls = 0;
+};
+
+/// Whether run phase timings are collected.
+bool profiling_enabled = false;
+
+/// Accumulators of the evolution loop phases.
+std::array<Account, num_phases> phase_accounts;
+
+/// Accumulators of the performed actions, keyed by process type label.
+std::map<std::string, Account> action_accounts;
+
+/**
+ * \return a snake_case label for the given process type.
+ *
+ * Unlike the ostream printer of ProcessType this covers thermalization and
+ * never fails; the five soft string excitations are deliberately grouped,
+ * their cost is dominated by the common fragmentation machinery.
+ *
+ * \param[in] type The process type to name.
+ */
+const char *process_type_label(ProcessType type) {
+  switch (type) {
+    case ProcessType::None:
+      return "none";
+    case ProcessType::Elastic:
+      return "elastic";
+    case ProcessType::TwoToOne:
+      return "two_to_one";
+    case ProcessType::TwoToTwo:
+      return "two_to_two";
+    case ProcessType::Decay:
+      return "decay";
+    case ProcessType::Wall:
+      return "wall";
+    case ProcessType::Thermalization:
+      return "thermalization";
+    case ProcessType::StringSoftSingleDiffractiveAX:
+    case ProcessType::StringSoftSingleDiffractiveXB:
+    case ProcessType::StringSoftDoubleDiffractive:
+    case ProcessType::StringSoftAnnihilation:
+    case ProcessType::StringSoftNonDiffractive:
+      return "soft_string";
+    case ProcessType::StringHard:
+      return "hard_string";
+    default:
+      return "other";
+  }
+}
+
+/**
+ * Print one line of the run phase report.
+ *
+ * \param[in] name The accumulator name.
+ * \param[in] account The accumulated cycles and calls.
+ * \param[in] total_cycles Sum of all accounted cycles, for the percentage.
+ */
+void print_account(const std::string &name, const Account &account,
+                   const uint64_t total_cycles) {
+  const double percent =
+      total_cycles > 0 ? 100.0 * account.cycles / total_cycles : 0.0;
+  std::cout << "  " << std::left << std::setw(24) << name << std::right
+            << std::setw(12) << account.calls << " calls" << std::setw(18)
+            << account.cycles << " cycles" << std::setw(8) << std::fixed
+            << std::setprecision(1) << percent << " %" << std::endl;
+}
+
+}  // unnamed namespace
+
+void RuntimeProfiler::enable() { profiling_enabled = true; }
+
+bool RuntimeProfiler::is_enabled() { return profiling_enabled; }
+
+void RuntimeProfiler::account_action(ProcessType type, uint64_t cycles) {
+  Account &account = action_accounts[process_type_label(type)];
+  account.cycles += cycles;
+  account.calls++;
+}
+
+void RuntimeProfiler::report(const bf::path &output_file) {
+  if (!profiling_enabled) {
+    return;
+  }
+  uint64_t total_cycles = 0;
+  for (const Account &account : phase_accounts) {
+    total_cycles += account.cycles;
+  }
+  /* Action cycles are part of the propagation-to-propagation stretch of the
+   * evolution, not of the four phases, so they add to the total. */
+  for (const auto &entry : action_accounts) {
+    total_cycles += entry.second.cycles;
+  }
+
+  std::cout << "Run phase accounting (percentages of accounted cycles):"
+            << std::endl;
+  for (std::size_t i = 0; i < num_phases; i++) {
+    print_account(phase_names[i], phase_accounts[i], total_cycles);
+  }
+  for (const auto &entry : action_accounts) {
+    print_account("action:" + entry.first, entry.second, total_cycles);
+  }
+
+  bf::ofstream file{output_file};
+  file << "# kind\tname\tcalls\tcycles\n";
+  for (std::size_t i = 0; i < num_phases; i++) {
+    file << "phase\t" << phase_names[i] << "\t" << phase_accounts[i].calls
+         << "\t" << phase_accounts[i].cycles << "\n";
+  }
+  for (const auto &entry : action_accounts) {
+    file << "action\t" << entry.first << "\t" << entry.second.calls << "\t"
+         << entry.second.cycles << "\n";
+  }
+  std::cout << "Run phase accounting written to " << output_file.string()
+            << std::endl;
+
+  phase_accounts = {};
+  action_accounts.clear();
+}
+
+RuntimeProfiler::Guard::Guard(Phase phase) : phase_(phase) {
+#ifdef SMASH_PARTICLE_COPY_STATS
+  /* The phases map one to one onto the leading copy-counting scopes, see
+   * CopyStats::Scope. */
+  previous_scope_ =
+      CopyStats::enter_scope(static_cast<CopyStats::Scope>(phase));
+#endif
+  if (!profiling_enabled) {
+    return;
+  }
+  tsc_.start();
+}
+
+RuntimeProfiler::Guard::~Guard() {
+#ifdef SMASH_PARTICLE_COPY_STATS
+  CopyStats::enter_scope(previous_scope_);
+#endif
+  if (!profiling_enabled) {
+    return;
+  }
+  tsc_.stop();
+  Account &account = phase_accounts[static_cast<std::size_t>(phase_)];
+  account.cycles += tsc_.cycles();
+  account.calls++;
+}
+
+RuntimeProfiler::ActionGuard::ActionGuard(const Action &action)
+    : action_(action) {
+#ifdef SMASH_PARTICLE_COPY_STATS
+  previous_scope_ = CopyStats::enter_scope(CopyStats::Scope::PerformAction);
+#endif
+  if (!profiling_enabled) {
+    return;
+  }
+  tsc_.start();
+}
+
+RuntimeProfiler::ActionGuard::~ActionGuard() {
+#ifdef SMASH_PARTICLE_COPY_STATS
+  CopyStats::enter_scope(previous_scope_);
+#endif
+  if (!profiling_enabled) {
+    return;
+  }
+  tsc_.stop();
+  account_action(action_.get_type(), tsc_.cycles());
+}
+
+}  // namespace smash
@@ -93,10 +93,19 @@ void ScatterAction::generate_final_state() {
           ", PDGcode2=" + incoming_particles_[1].pdgcode().string() + ")");
   }
 
+  if (process_type_ == ProcessType::TwoToOne) {
+    /* The resonance already carries the exact total four-momentum in the
+     * computational frame, see resonance_formation(). */
+    outgoing_particles_[0].set_4position(middle_point);
+    return;
+  }
+
+  /* Boost to the computational frame; the boost factors are shared by
+   * all outgoing particles. */
+  const PrecomputedBoost boost_to_comp_frame(
+      -total_momentum_of_outgoing_particles().velocity());
   for (ParticleData &new_particle : outgoing_particles_) {
-    // Boost to the computational frame
-    new_particle.boost_momentum(
-        -total_momentum_of_outgoing_particles().velocity());
+    new_particle.boost_momentum(boost_to_comp_frame);
     /* Set positions of the outgoing particles */
     if (proc->get_type() != ProcessType::Elastic) {
       new_particle.set_4position(middle_point);
@@ -133,6 +142,21 @@ void ScatterAction::add_all_scatterings(
   }
 }
 
+void ScatterAction::add_elastic_scattering(double elastic_parameter,
+                                           bool use_AQM) {
+  if (elastic_parameter >= 0.) {
+    /* Constant elastic cross section from the config file: no need to
+     * construct the cross-section machinery at all. */
+    add_collision(make_unique<CollisionBranch>(
+        incoming_particles_[0].type(), incoming_particles_[1].type(),
+        elastic_parameter, ProcessType::Elastic));
+  } else {
+    CrossSections xs(incoming_particles_, sqrt_s(),
+                     get_potential_at_interaction_point());
+    add_collision(xs.elastic(elastic_parameter, use_AQM));
+  }
+}
+
 double ScatterAction::get_total_weight() const {
   return total_cross_section_ * incoming_particles_[0].xsec_scaling_factor() *
          incoming_particles_[1].xsec_scaling_factor();
@@ -166,31 +190,12 @@ double ScatterAction::cm_momentum_squared() const {
 }
 
 double ScatterAction::transverse_distance_sqr() const {
-  // local copy of particles (since we need to boost them)
-  ParticleData p_a = incoming_particles_[0];
-  ParticleData p_b = incoming_particles_[1];
-  /* Boost particles to center-of-momentum frame. */
-  const ThreeVector velocity = beta_cm();
-  p_a.boost(velocity);
-  p_b.boost(velocity);
-  const ThreeVector pos_diff =
-      p_a.position().threevec() - p_b.position().threevec();
-  const ThreeVector mom_diff =
-      p_a.momentum().threevec() - p_b.momentum().threevec();
-
-  const auto &log = logger<LogArea::ScatterAction>();
-  log.debug("Particle ", incoming_particles_,
-            " position difference [fm]: ", pos_diff,
-            ", momentum difference [GeV]: ", mom_diff);
-
-  const double dp2 = mom_diff.sqr();
-  const double dr2 = pos_diff.sqr();
-  /* Zero momentum leads to infite distance. */
-  if (dp2 < really_small) {
-    return dr2;
-  }
-  const double dpdr = pos_diff * mom_diff;
+  return transverse_distance_sqr(incoming_particles_[0],
+                                 incoming_particles_[1]);
+}
 
+double ScatterAction::transverse_distance_sqr(const ParticleData& in_part1,
+                                              const ParticleData& in_part2) {
   /** UrQMD squared distance criterion:
    * \iref{Bass:1998ca} (3.27): in center of momentum frame
    * position of particle a: x_a
@@ -198,7 +203,32 @@ double ScatterAction::transverse_distance_sqr() const {
    * momentum of particle a: p_a
    * momentum of particle b: p_b
    * d^2_{coll} = (x_a - x_b)^2 - ((x_a - x_b) . (p_a - p_b))^2 / (p_a - p_b)^2
+   *
+   * The criterion is evaluated covariantly: for any four-vector A the
+   * square of its spatial part in the center-of-momentum frame equals
+   * (A.P)^2/s - A.A, with P the total momentum and s = P.P. This avoids
+   * boosting copies of the particles (and the square root hidden inside
+   * the boost) for every prospective pair.
    */
+  const FourVector delta_x = in_part1.position() - in_part2.position();
+  const FourVector delta_p = in_part1.momentum() - in_part2.momentum();
+  const FourVector total_p = in_part1.momentum() + in_part2.momentum();
+  const double one_over_s = 1. / total_p.sqr();
+  const double xP = delta_x.Dot(total_p);
+  const double pP = delta_p.Dot(total_p);
+
+  const auto &log = logger<LogArea::ScatterAction>();
+  log.debug("Particles ", in_part1, ", ", in_part2,
+            " position difference [fm]: ", delta_x,
+            ", momentum difference [GeV]: ", delta_p);
+
+  const double dp2 = pP * pP * one_over_s - delta_p.sqr();
+  const double dr2 = xP * xP * one_over_s - delta_x.sqr();
+  /* Zero momentum leads to infite distance. */
+  if (dp2 < really_small) {
+    return dr2;
+  }
+  const double dpdr = xP * pP * one_over_s - delta_x.Dot(delta_p);
   return dr2 - dpdr * dpdr / dp2;
 }
 
@@ -274,13 +304,13 @@ void ScatterAction::sample_angles(std::pair<double, double> masses,
   const double mass_a = masses.first;
   const double mass_b = masses.second;
 
-  const std::array<double, 2> t_range = get_t_range<double>(
-      kinetic_energy_cm, mass_in_a, mass_in_b, mass_a, mass_b);
-  Angles phitheta;
+  ThreeVector pscatt;
   if (el_scattering && !isotropic_) {
     /** NN → NN: Choose angular distribution according to Cugnon
      * parametrization,
      * see \iref{Cugnon:1996kh}. */
+    const std::array<double, 2> t_range = get_t_range<double>(
+        kinetic_energy_cm, mass_in_a, mass_in_b, mass_a, mass_b);
     double mandelstam_s_new = 0.;
     if (nn_scattering) {
       mandelstam_s_new = mandelstam_s();
@@ -317,8 +347,9 @@ void ScatterAction::sample_angles(std::pair<double, double> masses,
       t = t_range[0] + t_range[1] - t;
     }
     // determine scattering angles in center-of-mass frame
-    phitheta = Angles(2. * M_PI * random::canonical(),
-                      1. - 2. * (t - t_range[0]) / (t_range[1] - t_range[0]));
+    pscatt = Angles(2. * M_PI * random::canonical(),
+                    1. - 2. * (t - t_range[0]) / (t_range[1] - t_range[0]))
+                 .threevec();
   } else if (nn_scattering && p_a->pdgcode().is_Delta() &&
              p_b->pdgcode().is_nucleon() &&
              p_a->pdgcode().antiparticle_sign() ==
@@ -327,17 +358,22 @@ void ScatterAction::sample_angles(std::pair<double, double> masses,
     /** NN → NΔ: Sample scattering angles in center-of-mass frame from an
      * anisotropic angular distribution, using the same distribution as for
      * elastic pp scattering, as suggested in \iref{Cugnon:1996kh}. */
+    const std::array<double, 2> t_range = get_t_range<double>(
+        kinetic_energy_cm, mass_in_a, mass_in_b, mass_a, mass_b);
     const double plab = plab_from_s(mandelstam_s());
     const double bb = std::max(Cugnon_bpp(plab), really_small);
     double t = random::expo(bb, t_range[0], t_range[1]);
     if (random::canonical() > 0.5) {
       t = t_range[0] + t_range[1] - t;  // symmetrize
     }
-    phitheta = Angles(2. * M_PI * random::canonical(),
-                      1. - 2. * (t - t_range[0]) / (t_range[1] - t_range[0]));
+    pscatt = Angles(2. * M_PI * random::canonical(),
+                    1. - 2. * (t - t_range[0]) / (t_range[1] - t_range[0]))
+                 .threevec();
   } else if (nn_scattering && p_b->pdgcode().is_nucleon() && !isotropic_ &&
              (p_a->type().is_Nstar() || p_a->type().is_Deltastar())) {
     /** NN → NR: Fit to HADES data, see \iref{Agakishiev:2014wqa}. */
+    const std::array<double, 2> t_range = get_t_range<double>(
+        kinetic_energy_cm, mass_in_a, mass_in_b, mass_a, mass_b);
     const std::array<double, 4> p{1.46434, 5.80311, -6.89358, 1.94302};
     const double a = p[0] + mass_a * (p[1] + mass_a * (p[2] + mass_a * p[3]));
     /*  If the resonance is so heavy that the index "a" exceeds 30,
@@ -350,14 +386,14 @@ void ScatterAction::sample_angles(std::pair<double, double> masses,
     if (random::canonical() > 0.5) {
       t = t_range[0] + t_range[1] - t;  // symmetrize
     }
-    phitheta = Angles(2. * M_PI * random::canonical(),
-                      1. - 2. * (t - t_range[0]) / (t_range[1] - t_range[0]));
+    pscatt = Angles(2. * M_PI * random::canonical(),
+                    1. - 2. * (t - t_range[0]) / (t_range[1] - t_range[0]))
+                 .threevec();
   } else {
-    /* isotropic angular distribution */
-    phitheta.distribute_isotropically();
+    /* isotropic angular distribution, sampled without trigonometry */
+    pscatt = random::isotropic_unit_vector();
   }
 
-  ThreeVector pscatt = phitheta.threevec();
   // 3-momentum of first incoming particle in center-of-mass frame
   ThreeVector pcm =
       incoming_particles_[0].momentum().LorentzBoost(beta_cm()).threevec();
@@ -369,8 +405,10 @@ void ScatterAction::sample_angles(std::pair<double, double> masses,
     log.warn("Particle: ", p_a->pdgcode(), " radial momentum: ", p_f);
     log.warn("Etot: ", kinetic_energy_cm, " m_a: ", mass_a, " m_b: ", mass_b);
   }
-  p_a->set_4momentum(mass_a, pscatt * p_f);
-  p_b->set_4momentum(mass_b, -pscatt * p_f);
+  const auto momenta = two_body_momenta(kinetic_energy_cm, mass_a,
+                                        pscatt * p_f);
+  p_a->set_4momentum(momenta.first);
+  p_b->set_4momentum(momenta.second);
 
   /* Debug message is printed before boost, so that p_a and p_b are
    * the momenta in the center of mass frame and thus opposite to
@@ -433,9 +471,11 @@ void ScatterAction::resonance_formation() {
     s += incoming_particles_[1].pdgcode().string() + ")";
     throw InvalidResonanceFormation(s);
   }
-  // Set the momentum of the formed resonance in its rest frame.
-  outgoing_particles_[0].set_4momentum(
-      total_momentum_of_outgoing_particles().abs(), 0., 0., 0.);
+  /* The resonance carries the total four-momentum of the process. Setting
+   * it directly is exact, whereas setting the rest-frame vector and
+   * boosting it back only reproduces the total momentum up to rounding
+   * errors (and costs a square root for the invariant mass). */
+  outgoing_particles_[0].set_4momentum(total_momentum_of_outgoing_particles());
   /* Set the formation time of the resonance to the larger formation time of the
    * incoming particles, if it is larger than the execution time; execution time
    * is otherwise taken to be the formation time */
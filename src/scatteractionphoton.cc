@@ -10,6 +10,7 @@
 #include "smash/scatteractionphoton.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "smash/angles.h"
 #include "smash/constants.h"
@@ -90,13 +91,43 @@ ScatterActionPhoton::ReactionType ScatterActionPhoton::photon_reaction_type(
 }
 
 void ScatterActionPhoton::perform_photons(const OutputsList &outputs) {
+  // filter the photon outputs once instead of once per fractional photon
+  std::vector<OutputInterface *> photon_outputs;
+  for (const auto &output : outputs) {
+    if (output->is_photon_output()) {
+      photon_outputs.push_back(output.get());
+    }
+  }
+  // we have only one reaction per incoming particle pair
+  if (collision_processes_photons_.size() != 1) {
+    const auto &log = logger<LogArea::ScatterAction>();
+    log.fatal() << "Problem in ScatterActionPhoton::perform_photons().\n";
+    throw std::runtime_error("");
+  }
+  auto *proc = collision_processes_photons_[0].get();
+  outgoing_particles_ = proc->particle_list();
+  process_type_ = proc->get_type();
+
+  const PhotonKinematics kin = prepare_photon_kinematics();
+
+  /* The fractional photons are independent and identically distributed, so
+   * all momentum transfers and azimuthal angles of the batch can be drawn
+   * up front (in the same order a per-photon loop would draw them). */
+  std::vector<double> t_samples(number_of_fractional_photons_);
+  std::vector<double> phi_samples(number_of_fractional_photons_);
   for (int i = 0; i < number_of_fractional_photons_; i++) {
-    generate_final_state();
-    for (const auto &output : outputs) {
-      if (output->is_photon_output()) {
-        // we do not care about the local density
-        output->at_interaction(*this, 0.0);
-      }
+    t_samples[i] = random::uniform(kin.t1, kin.t2);
+    phi_samples[i] = random::uniform(0.0, twopi);
+  }
+
+  for (int i = 0; i < number_of_fractional_photons_; i++) {
+    sample_fractional_photon(kin, t_samples[i], phi_samples[i]);
+    if (number_of_fractional_photons_ == 1) {
+      weight_ = proc->weight() / hadronic_cross_section();
+    }
+    for (OutputInterface *output : photon_outputs) {
+      // we do not care about the local density
+      output->at_interaction(*this, 0.0);
     }
   }
 }
@@ -197,8 +228,17 @@ void ScatterActionPhoton::generate_final_state() {
   outgoing_particles_ = proc->particle_list();
   process_type_ = proc->get_type();
 
-  FourVector middle_point = get_interaction_point();
+  const PhotonKinematics kin = prepare_photon_kinematics();
+  const double t = random::uniform(kin.t1, kin.t2);
+  sample_fractional_photon(kin, t, random::uniform(0.0, twopi));
 
+  if (number_of_fractional_photons_ == 1) {
+    weight_ = proc->weight() / hadronic_cross_section();
+  }
+}
+
+ScatterActionPhoton::PhotonKinematics
+ScatterActionPhoton::prepare_photon_kinematics() {
   // t is defined to be the momentum exchanged between the rho meson and the
   // photon in pi + rho -> pi + photon channel. Therefore,
   // get_t_range needs to be called with m2 being the rho mass instead of the
@@ -208,27 +248,39 @@ void ScatterActionPhoton::generate_final_state() {
     std::swap(incoming_particles_[0], incoming_particles_[1]);
   }
 
+  PhotonKinematics kin;
+  kin.middle_point = get_interaction_point();
+
   // 2->2 inelastic scattering
   // Sample the particle momenta in CM system
-  const double m1 = incoming_particles_[0].effective_mass();
-  const double m2 = incoming_particles_[1].effective_mass();
+  kin.m1 = incoming_particles_[0].effective_mass();
+  kin.m2 = incoming_particles_[1].effective_mass();
+
+  kin.s = mandelstam_s();
+  kin.sqrts = sqrt_s();
+  const std::array<double, 2> mandelstam_t =
+      get_t_range(kin.sqrts, kin.m1, kin.m2, hadron_out_mass_, 0.0);
+  kin.t1 = mandelstam_t[1];
+  kin.t2 = mandelstam_t[0];
+  kin.pcm_in = cm_momentum();
+  kin.pcm_out = pCM(kin.sqrts, hadron_out_mass_, 0.0);
+
+  // if rho in final state take already sampled mass (same as the outgoing
+  // hadron mass). If rho is incoming take the mass of the incoming particle
+  kin.m_rho = rho_mass();
+  kin.beta = beta_cm();
+  return kin;
+}
 
+void ScatterActionPhoton::sample_fractional_photon(const PhotonKinematics &kin,
+                                                   const double t,
+                                                   const double phi) {
   const double &m_out = hadron_out_mass_;
 
-  const double s = mandelstam_s();
-  const double sqrts = sqrt_s();
-  std::array<double, 2> mandelstam_t = get_t_range(sqrts, m1, m2, m_out, 0.0);
-  const double t1 = mandelstam_t[1];
-  const double t2 = mandelstam_t[0];
-  const double pcm_in = cm_momentum();
-  const double pcm_out = pCM(sqrts, m_out, 0.0);
-
-  const double t = random::uniform(t1, t2);
-
-  double costheta = (t - pow_int(m2, 2) +
-                     0.5 * (s + pow_int(m2, 2) - pow_int(m1, 2)) *
-                         (s - pow_int(m_out, 2)) / s) /
-                    (pcm_in * (s - pow_int(m_out, 2)) / sqrts);
+  double costheta = (t - pow_int(kin.m2, 2) +
+                     0.5 * (kin.s + pow_int(kin.m2, 2) - pow_int(kin.m1, 2)) *
+                         (kin.s - pow_int(m_out, 2)) / kin.s) /
+                    (kin.pcm_in * (kin.s - pow_int(m_out, 2)) / kin.sqrts);
 
   // on very rare occasions near the kinematic threshold numerical issues give
   // unphysical angles.
@@ -242,32 +294,26 @@ void ScatterActionPhoton::generate_final_state() {
     if (costheta < -1.0)
       costheta = -1.0;
   }
-  Angles phitheta(random::uniform(0.0, twopi), costheta);
+  Angles phitheta(phi, costheta);
   outgoing_particles_[0].set_4momentum(hadron_out_mass_,
-                                       phitheta.threevec() * pcm_out);
-  outgoing_particles_[1].set_4momentum(0.0, -phitheta.threevec() * pcm_out);
+                                       phitheta.threevec() * kin.pcm_out);
+  outgoing_particles_[1].set_4momentum(0.0, -phitheta.threevec() * kin.pcm_out);
 
   // Set positions & boost to computational frame.
   for (ParticleData &new_particle : outgoing_particles_) {
-    new_particle.set_4position(middle_point);
-    new_particle.boost_momentum(-beta_cm());
+    new_particle.set_4position(kin.middle_point);
   }
+  boost_momenta(outgoing_particles_, -kin.beta);
 
   const double E_Photon = outgoing_particles_[1].momentum()[0];
 
-  // if rho in final state take already sampled mass (same as m_out). If rho is
-  // incoming take the mass of the incoming particle
-  const double m_rho = rho_mass();
-
   // compute the differential cross section with form factor included
-  const double diff_xs = diff_cross_section_w_ff(t, m_rho, E_Photon);
+  const double diff_xs = diff_cross_section_w_ff(t, kin.m_rho, E_Photon);
 
   // Weighing of the fractional photons
   if (number_of_fractional_photons_ > 1) {
-    weight_ = diff_xs * (t2 - t1) /
+    weight_ = diff_xs * (kin.t2 - kin.t1) /
               (number_of_fractional_photons_ * hadronic_cross_section());
-  } else {
-    weight_ = proc->weight() / hadronic_cross_section();
   }
   // Photons are not really part of the normal processes, so we have to set a
   // constant arbitrary number.
@@ -495,17 +541,21 @@ double ScatterActionPhoton::diff_cross_section_w_ff(const double t,
     case ReactionType::pi_z_rho_p_pi_p: {
       if (default_mediator_ == MediatorType::SUM) {
         std::pair<double, double> FF = form_factor_single(E_photon);
-        std::pair<double, double> diff_xs = diff_cross_section_single(t, m_rho);
+        std::pair<double, double> diff_xs(
+            diff_cross_section_tabulated(t, m_rho, MediatorType::PION),
+            diff_cross_section_tabulated(t, m_rho, MediatorType::OMEGA));
         const double xs_ff = pow_int(FF.first, 4) * diff_xs.first +
                              pow_int(FF.second, 4) * diff_xs.second;
         return xs_ff;
       } else if (default_mediator_ == MediatorType::PION) {
         const double FF = form_factor_pion(E_photon);
-        const double diff_xs = diff_cross_section(t, m_rho);
+        const double diff_xs = diff_cross_section_tabulated(t, m_rho,
+                                                            default_mediator_);
         return pow_int(FF, 4) * diff_xs;
       } else if (default_mediator_ == MediatorType::OMEGA) {
         const double FF = form_factor_omega(E_photon);
-        const double diff_xs = diff_cross_section(t, m_rho);
+        const double diff_xs = diff_cross_section_tabulated(t, m_rho,
+                                                            default_mediator_);
         return pow_int(FF, 4) * diff_xs;
       }
       break;
@@ -516,14 +566,16 @@ double ScatterActionPhoton::diff_cross_section_w_ff(const double t,
     case ReactionType::pi_m_rho_z_pi_m:
     case ReactionType::pi_p_pi_m_rho_z: {
       const double FF = form_factor_pion(E_photon);
-      const double xs = diff_cross_section(t, m_rho);
+      const double xs = diff_cross_section_tabulated(t, m_rho,
+                                                     default_mediator_);
       const double xs_ff = pow_int(FF, 4) * xs;
       return xs_ff;
     }
 
     case ReactionType::pi_z_rho_z_pi_z: {
       const double FF = form_factor_omega(E_photon);
-      const double xs = diff_cross_section(t, m_rho);
+      const double xs = diff_cross_section_tabulated(t, m_rho,
+                                                     default_mediator_);
       const double xs_ff = pow_int(FF, 4) * xs;
       return xs_ff;
     }
@@ -535,6 +587,30 @@ double ScatterActionPhoton::diff_cross_section_w_ff(const double t,
   }
 }
 
+double ScatterActionPhoton::diff_cross_section_tabulated(
+    const double t, const double m_rho, MediatorType mediator) {
+  if (number_of_fractional_photons_ == 1) {
+    return diff_cross_section(t, m_rho, mediator);
+  }
+  std::unique_ptr<Tabulation> &table =
+      diff_xs_tables_[static_cast<int>(mediator)];
+  if (table == nullptr) {
+    /* The swap in generate_final_state already put the pion first, so the
+     * t range is the same one the sampling uses. */
+    const double m1 = incoming_particles_[0].effective_mass();
+    const double m2 = incoming_particles_[1].effective_mass();
+    const std::array<double, 2> t_range =
+        get_t_range(sqrt_s(), m1, m2, hadron_out_mass_, 0.0);
+    constexpr int num_intervals = 32;
+    table = make_unique<Tabulation>(
+        t_range[1], t_range[0] - t_range[1], num_intervals,
+        [&](double t_sample) {
+          return diff_cross_section(t_sample, m_rho, mediator);
+        });
+  }
+  return table->get_value_linear(t, Extrapolation::Const);
+}
+
 double ScatterActionPhoton::form_factor_pion(const double E_photon) const {
   const double Lambda = 1.0;
   const double Lambda2 = Lambda * Lambda;
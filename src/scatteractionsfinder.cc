@@ -10,7 +10,10 @@
 #include "smash/scatteractionsfinder.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "smash/configuration.h"
@@ -19,6 +22,7 @@
 #include "smash/cxx14compat.h"
 #include "smash/decaymodes.h"
 #include "smash/experimentparameters.h"
+#include "smash/file.h"
 #include "smash/isoparticletype.h"
 #include "smash/logging.h"
 #include "smash/macros.h"
@@ -26,6 +30,7 @@
 #include "smash/scatteraction.h"
 #include "smash/scatteractionphoton.h"
 #include "smash/stringfunctions.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 /*!\Userguide
@@ -38,6 +43,29 @@ namespace smash {
  * \key Isotropic (bool, optional, default = \key false) \n
  * Do all collisions isotropically.
  *
+ * \key Collision_Statistics (bool, optional, default = \key false) \n
+ * Collect counters of the collision search (cell and neighbor searches,
+ * pairs examined, pairs passing the distance criterion, actions created)
+ * and print them after every event. Useful for tuning testparticle numbers
+ * and the grid, at the cost of a few atomic increments per examined pair.
+ *
+ * \key Adaptive_Cell_Size (bool, optional, default = \key false) \n
+ * Tune the cell length of the collision-finding grid from timestep to
+ * timestep using the measured search counters: when the fixed per-cell
+ * overhead dominates (dilute halo) the cells are grown, when the examined
+ * candidate pairs dominate (dense core) they are shrunk again, never below
+ * the interaction length. Updates the same counters as
+ * \key Collision_Statistics.
+ *
+ * \key Cross_Section_Cache_File (string, optional, default = "") \n
+ * If given, the memoized total cross-section tables are persisted in this
+ * file: a cross-section dump (\key -s) saves the scanned totals after the
+ * scan and a normal run merges the file into its cache on startup, so a
+ * production run following a scan starts with warm tables instead of
+ * rediscovering them pair by pair. The file must stem from the same
+ * particles, decay modes and collision-term settings; files with a
+ * different binning or unknown species are ignored with a warning.
+ *
  * \key Elastic_NN_Cutoff_Sqrts (double, optional, default = 1.98): \n
  * The elastic collisions betwen two nucleons with sqrt_s below
  * Elastic_NN_Cutoff_Sqrts, in GeV, cannot happen. \n
@@ -194,7 +222,8 @@ ScatterActionsFinder::ScatterActionsFinder(
     const std::vector<bool>& nucleon_has_interacted, int N_tot, int N_proj)
     : elastic_parameter_(
           config.take({"Collision_Term", "Elastic_Cross_Section"}, -1.)),
-      testparticles_(parameters.testparticles),
+      xs_to_dist_sqr_(fm2_mb * M_1_PI /
+                      static_cast<double>(parameters.testparticles)),
       isotropic_(config.take({"Collision_Term", "Isotropic"}, false)),
       two_to_one_(parameters.two_to_one),
       incl_set_(parameters.included_2to2),
@@ -203,16 +232,47 @@ ScatterActionsFinder::ScatterActionsFinder(
       use_AQM_(parameters.use_AQM),
       strings_with_probability_(parameters.strings_with_probability),
       nnbar_treatment_(parameters.nnbar_treatment),
+      elastic_only_(parameters.included_2to2.count() == 1 &&
+                    parameters.included_2to2[IncludedReactions::Elastic] == 1 &&
+                    !parameters.two_to_one && !parameters.strings_switch &&
+                    parameters.nnbar_treatment ==
+                        NNbarTreatment::NoAnnihilation &&
+                    ParticleType::list_light_nuclei().empty()),
       nucleon_has_interacted_(nucleon_has_interacted),
       N_tot_(N_tot),
       N_proj_(N_proj),
+      n_ensembles_(parameters.n_ensembles),
       string_formation_time_(config.take(
-          {"Collision_Term", "String_Parameters", "Formation_Time"}, 1.)) {
+          {"Collision_Term", "String_Parameters", "Formation_Time"}, 1.)),
+      xs_cache_file_(config.take({"Collision_Term", "Cross_Section_Cache_File"},
+                                 std::string())),
+      collect_statistics_(
+          config.take({"Collision_Term", "Collision_Statistics"}, false)),
+      adaptive_cell_size_(
+          config.take({"Collision_Term", "Adaptive_Cell_Size"}, false)) {
   if (is_constant_elastic_isotropic()) {
     const auto& log = logger<LogArea::FindScatter>();
     log.info("Constant elastic isotropic cross-section mode:", " using ",
              elastic_parameter_, " mb as maximal cross-section.");
   }
+  const std::size_t n_types = ParticleType::list_all().size();
+  const std::size_t n_pairs = n_types * (n_types + 1) / 2;
+  max_xs_table_.reset(new std::atomic<double>[n_pairs]);
+  for (std::size_t i = 0; i < n_pairs; ++i) {
+    max_xs_table_[i].store(-1., std::memory_order_relaxed);
+  }
+  stats_ = make_unique<SearchStatistics>();
+  if (!xs_cache_file_.empty()) {
+    /* Warm start: merge the tables a previous run (typically a
+     * cross-section scan) left behind, so the collision search does not
+     * have to rediscover them. */
+    const std::size_t merged = xs_cache_.load(xs_cache_file_);
+    if (merged > 0) {
+      const auto& log = logger<LogArea::FindScatter>();
+      log.info("Loaded cached cross-section tables of ", merged,
+               " species pairs from ", xs_cache_file_);
+    }
+  }
   if (strings_switch_) {
     auto subconfig = config["Collision_Term"]["String_Parameters"];
     string_process_interface_ = make_unique<StringProcess>(
@@ -234,6 +294,212 @@ ScatterActionsFinder::ScatterActionsFinder(
   }
 }
 
+namespace {
+/// Width of one sqrt(s) bin of the cross-section cache [GeV].
+constexpr double cache_bin_width = 0.002;
+/// Number of sqrt(s) bins per species pair; higher energies are not cached.
+constexpr std::size_t cache_num_bins = 4096;
+/// Magic bytes identifying a cross-section cache file.
+constexpr char cache_file_magic[4] = {'S', 'X', 'S', 'C'};
+/// Version of the cross-section cache file format.
+constexpr uint16_t cache_file_version = 1;
+/// Largest CM momentum covered by the maximum cross-section scan [GeV].
+constexpr double max_xs_scan_momentum = 10.;
+/// Safety margin on the scanned maximum, for peaks between sample points.
+constexpr double max_xs_scan_margin = 1.1;
+/**
+ * Minimum number of particles in a cell for which the sort-and-sweep
+ * refinement of the pair search pays off; below this the plain pair loop
+ * is cheaper than sorting.
+ */
+constexpr std::size_t sweep_min_particles = 12;
+
+/**
+ * \return the flat index of the unordered species pair (\p type_a,
+ * \p type_b) into a triangular table.
+ *
+ * The ParticleType objects are entries of the global list, so their offsets
+ * in that list identify the species. (operator& is overloaded for
+ * ParticleType, hence addressof.)
+ */
+std::size_t species_pair_index(const ParticleType& type_a,
+                               const ParticleType& type_b) {
+  const ParticleType* base = ParticleType::list_all().data();
+  std::size_t index_a = std::addressof(type_a) - base;
+  std::size_t index_b = std::addressof(type_b) - base;
+  if (index_a > index_b) {
+    std::swap(index_a, index_b);
+  }
+  return index_b * (index_b + 1) / 2 + index_a;
+}
+}  // namespace
+
+CrossSectionCache::CrossSectionCache() {
+  const std::size_t n = ParticleType::list_all().size();
+  const std::size_t pairs = n * (n + 1) / 2;
+  tables_.reset(new std::atomic<std::atomic<double>*>[pairs]);
+  for (std::size_t i = 0; i < pairs; ++i) {
+    tables_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+CrossSectionCache::~CrossSectionCache() {
+  const std::size_t n = ParticleType::list_all().size();
+  const std::size_t pairs = n * (n + 1) / 2;
+  for (std::size_t i = 0; i < pairs; ++i) {
+    delete[] tables_[i].load(std::memory_order_relaxed);
+  }
+}
+
+std::size_t CrossSectionCache::pair_index(const ParticleType& type_a,
+                                          const ParticleType& type_b) const {
+  return species_pair_index(type_a, type_b);
+}
+
+double CrossSectionCache::get(const ParticleType& type_a,
+                              const ParticleType& type_b,
+                              double sqrts) const {
+  if (!type_a.is_stable() || !type_b.is_stable()) {
+    return -1.;
+  }
+  const std::size_t bin =
+      static_cast<std::size_t>(sqrts / cache_bin_width);
+  if (bin >= cache_num_bins) {
+    return -1.;
+  }
+  const std::atomic<double>* table =
+      tables_[pair_index(type_a, type_b)].load(std::memory_order_acquire);
+  if (table == nullptr) {
+    return -1.;
+  }
+  return table[bin].load(std::memory_order_relaxed);
+}
+
+void CrossSectionCache::store(const ParticleType& type_a,
+                              const ParticleType& type_b, double sqrts,
+                              double cross_section) {
+  if (!type_a.is_stable() || !type_b.is_stable()) {
+    return;
+  }
+  const std::size_t bin =
+      static_cast<std::size_t>(sqrts / cache_bin_width);
+  if (bin >= cache_num_bins) {
+    return;
+  }
+  std::atomic<std::atomic<double>*>& slot = tables_[pair_index(type_a, type_b)];
+  std::atomic<double>* table = slot.load(std::memory_order_acquire);
+  if (table == nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    table = slot.load(std::memory_order_relaxed);
+    if (table == nullptr) {
+      table = new std::atomic<double>[cache_num_bins];
+      for (std::size_t i = 0; i < cache_num_bins; ++i) {
+        table[i].store(-1., std::memory_order_relaxed);
+      }
+      slot.store(table, std::memory_order_release);
+    }
+  }
+  // keep the maximum of the bin, so the cache stays an upper bound
+  if (cross_section > table[bin].load(std::memory_order_relaxed)) {
+    table[bin].store(cross_section, std::memory_order_relaxed);
+  }
+}
+
+std::size_t CrossSectionCache::save(const bf::path& path) const {
+  FilePtr file = fopen(path, "wb");
+  if (!file) {
+    throw std::runtime_error("Could not open cross-section cache file " +
+                             path.native() + " for writing.");
+  }
+  std::fwrite(cache_file_magic, sizeof(cache_file_magic), 1, file.get());
+  std::fwrite(&cache_file_version, sizeof(cache_file_version), 1, file.get());
+  const double bin_width = cache_bin_width;
+  const uint64_t num_bins = cache_num_bins;
+  std::fwrite(&bin_width, sizeof(bin_width), 1, file.get());
+  std::fwrite(&num_bins, sizeof(num_bins), 1, file.get());
+  const ParticleTypeList& types = ParticleType::list_all();
+  std::size_t n_saved = 0;
+  std::vector<double> values(cache_num_bins);
+  for (std::size_t ib = 0; ib < types.size(); ++ib) {
+    for (std::size_t ia = 0; ia <= ib; ++ia) {
+      const std::atomic<double>* table =
+          tables_[ib * (ib + 1) / 2 + ia].load(std::memory_order_acquire);
+      if (table == nullptr) {
+        continue;
+      }
+      const int32_t pdg_a = types[ia].pdgcode().get_decimal();
+      const int32_t pdg_b = types[ib].pdgcode().get_decimal();
+      std::fwrite(&pdg_a, sizeof(pdg_a), 1, file.get());
+      std::fwrite(&pdg_b, sizeof(pdg_b), 1, file.get());
+      for (std::size_t i = 0; i < cache_num_bins; ++i) {
+        values[i] = table[i].load(std::memory_order_relaxed);
+      }
+      std::fwrite(values.data(), sizeof(double), values.size(), file.get());
+      ++n_saved;
+    }
+  }
+  return n_saved;
+}
+
+std::size_t CrossSectionCache::load(const bf::path& path) {
+  FilePtr file = fopen(path, "rb");
+  if (!file) {
+    // A missing file is not an error: the first scan has yet to create it.
+    return 0;
+  }
+  const auto& log = logger<LogArea::FindScatter>();
+  char magic[4];
+  uint16_t version = 0;
+  double bin_width = 0.;
+  uint64_t num_bins = 0;
+  if (std::fread(magic, sizeof(magic), 1, file.get()) != 1 ||
+      std::memcmp(magic, cache_file_magic, sizeof(magic)) != 0 ||
+      std::fread(&version, sizeof(version), 1, file.get()) != 1 ||
+      version != cache_file_version ||
+      std::fread(&bin_width, sizeof(bin_width), 1, file.get()) != 1 ||
+      std::fread(&num_bins, sizeof(num_bins), 1, file.get()) != 1 ||
+      bin_width != cache_bin_width || num_bins != cache_num_bins) {
+    log.warn("Ignoring the cross-section cache file ", path.native(),
+             ": unknown format or different binning.");
+    return 0;
+  }
+  std::size_t n_merged = 0;
+  std::vector<double> values(cache_num_bins);
+  for (;;) {
+    int32_t pdg_a = 0;
+    int32_t pdg_b = 0;
+    if (std::fread(&pdg_a, sizeof(pdg_a), 1, file.get()) != 1) {
+      break;  // regular end of file
+    }
+    if (std::fread(&pdg_b, sizeof(pdg_b), 1, file.get()) != 1 ||
+        std::fread(values.data(), sizeof(double), values.size(),
+                   file.get()) != values.size()) {
+      log.warn("The cross-section cache file ", path.native(),
+               " is truncated; merged the complete entries.");
+      break;
+    }
+    /* An unchecked conversion suffices: a garbage code is simply not found
+     * in the particle list and the entry is skipped. */
+    const ParticleTypePtr type_a =
+        ParticleType::try_find(PdgCode::from_decimal_unchecked(pdg_a));
+    const ParticleTypePtr type_b =
+        ParticleType::try_find(PdgCode::from_decimal_unchecked(pdg_b));
+    if (!type_a || !type_b) {
+      log.warn("The cross-section cache file ", path.native(),
+               " contains the species pair (", pdg_a, ", ", pdg_b,
+               "), which is unknown to the particle list; skipping it.");
+      continue;
+    }
+    for (std::size_t i = 0; i < cache_num_bins; ++i) {
+      if (values[i] >= 0.) {
+        store(*type_a, *type_b, (i + 0.5) * cache_bin_width, values[i]);
+      }
+    }
+    ++n_merged;
+  }
+  return n_merged;
+}
+
 ActionPtr ScatterActionsFinder::check_collision(const ParticleData& data_a,
                                                 const ParticleData& data_b,
                                                 double dt) const {
@@ -241,6 +507,15 @@ ActionPtr ScatterActionsFinder::check_collision(const ParticleData& data_a,
   const auto& log = logger<LogArea::FindScatter>();
 #endif
 
+  if (counting_enabled()) {
+    stats_->pairs_examined.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // particles of different parallel ensembles never interact
+  if (data_a.ensemble() != data_b.ensemble()) {
+    return nullptr;
+  }
+
   // just collided with this particle
   if (data_a.id_process() > 0 && data_a.id_process() == data_b.id_process()) {
 #ifndef NDEBUG
@@ -254,12 +529,15 @@ ActionPtr ScatterActionsFinder::check_collision(const ParticleData& data_a,
    * 1) belong to the two colliding nuclei
    * 2) are within the same nucleus
    * 3) both of them have never experienced any collisons,
-   * then the collision between them are banned. */
+   * then the collision between them are banned. The initial nucleons of
+   * ensemble e occupy the id block [e * N_tot_, (e+1) * N_tot_), with the
+   * projectile in the first N_proj_ entries of each block. */
   assert(data_a.id() >= 0);
   assert(data_b.id() >= 0);
-  if (data_a.id() < N_tot_ && data_b.id() < N_tot_ &&
-      ((data_a.id() < N_proj_ && data_b.id() < N_proj_) ||
-       (data_a.id() >= N_proj_ && data_b.id() >= N_proj_)) &&
+  if (data_a.id() < n_ensembles_ * N_tot_ &&
+      data_b.id() < n_ensembles_ * N_tot_ &&
+      ((data_a.id() % N_tot_ < N_proj_) ==
+       (data_b.id() % N_tot_ < N_proj_)) &&
       !(nucleon_has_interacted_[data_a.id()] ||
         nucleon_has_interacted_[data_b.id()])) {
     return nullptr;
@@ -272,32 +550,77 @@ ActionPtr ScatterActionsFinder::check_collision(const ParticleData& data_a,
   if (time_until_collision < 0. || time_until_collision >= dt) {
     return nullptr;
   }
+  if (counting_enabled()) {
+    stats_->pairs_approaching.fetch_add(1, std::memory_order_relaxed);
+  }
 
-  // Create ScatterAction object.
-  ScatterActionPtr act = make_unique<ScatterAction>(
-      data_a, data_b, time_until_collision, isotropic_, string_formation_time_);
-  if (strings_switch_) {
-    act->set_string_interface(string_process_interface_.get());
+  const double distance_squared =
+      ScatterAction::transverse_distance_sqr(data_a, data_b);
+
+  /* Don't calculate cross section if the particles are very far apart:
+   * the maximal cross section of this species pair is usually much smaller
+   * than the global bound, e.g. for pion pairs. */
+  const double sqrts = (data_a.momentum() + data_b.momentum()).abs();
+  const double max_xs = max_cross_section(data_a.type(), data_b.type(), sqrts);
+  if (distance_squared >= max_xs * xs_to_dist_sqr_) {
+    return nullptr;
+  }
+  if (counting_enabled()) {
+    stats_->pairs_within_distance.fetch_add(1, std::memory_order_relaxed);
   }
 
-  const double distance_squared = act->transverse_distance_sqr();
+  // Take cross section scaling factors into account
+  const double xsec_scale =
+      data_a.xsec_scaling_factor(time_until_collision) *
+      data_b.xsec_scaling_factor(time_until_collision);
 
-  // Don't calculate cross section if the particles are very far apart.
-  if (distance_squared >= max_transverse_distance_sqr(testparticles_)) {
+  /* Consult the memoized total cross section next: if the bin of this
+   * species pair is already populated, most pairs fail the distance
+   * criterion against the cached upper bound and can be rejected without
+   * running the full cross-section machinery. */
+  const double cached_xs = xs_cache_.get(data_a.type(), data_b.type(), sqrts);
+  if (cached_xs >= 0. &&
+      distance_squared >= cached_xs * xs_to_dist_sqr_ * xsec_scale) {
     return nullptr;
   }
+  if (counting_enabled()) {
+    stats_->xs_evaluations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /* Only now create the ScatterAction object; all pairs rejected above
+   * never pay for the allocation and the cross-section evaluation. */
+  ScatterActionPtr act = make_unique<ScatterAction>(
+      data_a, data_b, time_until_collision, isotropic_, string_formation_time_);
+  if (strings_switch_) {
+    act->set_string_interface(string_process_interface_.get());
+  }
 
   // Add various subprocesses.
-  act->add_all_scatterings(elastic_parameter_, two_to_one_, incl_set_,
-                           low_snn_cut_, strings_switch_, use_AQM_,
-                           strings_with_probability_, nnbar_treatment_);
+  if (elastic_only_) {
+    /* Fast path: the elastic process is the only possible one, so it is
+     * added directly without the full cross-section dispatch. Elastic
+     * collisions between two nucleons with sqrt_s below low_snn_cut_ can
+     * not happen; leaving the process list empty then makes the distance
+     * criterion below reject the pair. */
+    const ParticleType& t1 = data_a.type();
+    const ParticleType& t2 = data_b.type();
+    const bool reject_by_nucleon_elastic_cutoff =
+        t1.is_nucleon() && t2.is_nucleon() &&
+        t1.antiparticle_sign() == t2.antiparticle_sign() &&
+        sqrts < low_snn_cut_;
+    if (!reject_by_nucleon_elastic_cutoff) {
+      act->add_elastic_scattering(elastic_parameter_, use_AQM_);
+    }
+  } else {
+    act->add_all_scatterings(elastic_parameter_, two_to_one_, incl_set_,
+                             low_snn_cut_, strings_switch_, use_AQM_,
+                             strings_with_probability_, nnbar_treatment_);
+  }
+  xs_cache_.store(data_a.type(), data_b.type(), sqrts, act->cross_section());
 
   // Cross section for collision criterion
-  double cross_section_criterion = act->cross_section() * fm2_mb * M_1_PI /
-                                   static_cast<double>(testparticles_);
-  // Take cross section scaling factors into account
-  cross_section_criterion *= data_a.xsec_scaling_factor(time_until_collision);
-  cross_section_criterion *= data_b.xsec_scaling_factor(time_until_collision);
+  double cross_section_criterion =
+      act->cross_section() * xs_to_dist_sqr_ * xsec_scale;
 
   // distance criterion according to cross_section
   if (distance_squared >= cross_section_criterion) {
@@ -309,35 +632,185 @@ ActionPtr ScatterActionsFinder::check_collision(const ParticleData& data_a,
             "\n<-> ", data_b);
 #endif
 
+  if (counting_enabled()) {
+    stats_->actions_created.fetch_add(1, std::memory_order_relaxed);
+  }
+
   return std::move(act);
 }
 
+double ScatterActionsFinder::max_cross_section(const ParticleType& type_a,
+                                               const ParticleType& type_b,
+                                               double sqrts) const {
+  if (is_constant_elastic_isotropic()) {
+    return elastic_parameter_;
+  }
+  /* For resonances the cross section also depends on the off-shell masses,
+   * so no bound per species pair is available. */
+  if (!type_a.is_stable() || !type_b.is_stable()) {
+    return maximum_cross_section;
+  }
+  // the scan covers CM momenta up to max_xs_scan_momentum
+  const double scanned_up_to =
+      std::sqrt(type_a.mass() * type_a.mass() +
+                max_xs_scan_momentum * max_xs_scan_momentum) +
+      std::sqrt(type_b.mass() * type_b.mass() +
+                max_xs_scan_momentum * max_xs_scan_momentum);
+  if (sqrts >= scanned_up_to) {
+    return maximum_cross_section;
+  }
+  std::atomic<double>& entry = max_xs_table_[species_pair_index(type_a,
+                                                               type_b)];
+  double max_xs = entry.load(std::memory_order_relaxed);
+  if (max_xs < 0.) {
+    max_xs = scan_max_cross_section(type_a, type_b);
+    entry.store(max_xs, std::memory_order_relaxed);
+  }
+  return max_xs;
+}
+
+double ScatterActionsFinder::scan_max_cross_section(
+    const ParticleType& type_a, const ParticleType& type_b) const {
+  constexpr double time = 0.0;
+  ParticleData a{type_a}, b{type_b};
+  double max_xs = 0.;
+  /* Sample the total cross section on a CM momentum grid: fine steps at low
+   * momenta, where the resonance peaks sit, coarser steps in the smooth
+   * high-energy region. */
+  const auto probe = [&](double momentum) {
+    a.set_4momentum(type_a.mass(), momentum, 0., 0.);
+    b.set_4momentum(type_b.mass(), -momentum, 0., 0.);
+    ScatterActionPtr act = make_unique<ScatterAction>(
+        a, b, time, isotropic_, string_formation_time_);
+    if (strings_switch_) {
+      act->set_string_interface(string_process_interface_.get());
+    }
+    act->add_all_scatterings(elastic_parameter_, two_to_one_, incl_set_,
+                             low_snn_cut_, strings_switch_, use_AQM_,
+                             strings_with_probability_, nnbar_treatment_);
+    max_xs = std::max(max_xs, act->cross_section());
+  };
+  for (double momentum = 0.002; momentum < 2.; momentum += 0.002) {
+    probe(momentum);
+  }
+  for (double momentum = 2.; momentum < max_xs_scan_momentum;
+       momentum += 0.05) {
+    probe(momentum);
+  }
+  /* The margin absorbs peaks between the sample points; the global bound
+   * still applies, so the cut is never looser than without the table. */
+  return std::min(maximum_cross_section, max_xs_scan_margin * max_xs);
+}
+
 ActionList ScatterActionsFinder::find_actions_in_cell(
-    const ParticleList& search_list, double dt) const {
-  std::vector<ActionPtr> actions;
-  for (const ParticleData& p1 : search_list) {
-    for (const ParticleData& p2 : search_list) {
-      if (p1.id() < p2.id()) {
-        // Check if a collision is possible.
-        ActionPtr act = check_collision(p1, p2, dt);
-        if (act) {
-          actions.push_back(std::move(act));
+    const ParticleSlice& search_list, double dt) const {
+  if (counting_enabled()) {
+    stats_->cell_searches.fetch_add(1, std::memory_order_relaxed);
+  }
+  ActionList actions;
+  if (search_list.size() < sweep_min_particles) {
+    for (const ParticleData& p1 : search_list) {
+      for (const ParticleData& p2 : search_list) {
+        if (p1.id() < p2.id()) {
+          // Check if a collision is possible.
+          ActionPtr act = check_collision(p1, p2, dt);
+          if (act) {
+            actions.push_back(std::move(act));
+          }
         }
       }
     }
+    return actions;
+  }
+  /* Sort-and-sweep refinement for densely populated cells: after sorting
+   * along one axis, the inner loop can stop at the first partner whose
+   * axis separation already exceeds the sweep range, see
+   * \ref sweep_range. */
+  std::vector<const ParticleData*> sorted;
+  sorted.reserve(search_list.size());
+  for (const ParticleData& p : search_list) {
+    sorted.push_back(&p);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const ParticleData* a, const ParticleData* b) {
+              return a->position().x1() < b->position().x1();
+            });
+  const double range = sweep_range(dt);
+  for (std::size_t i = 0; i < sorted.size(); ++i) {
+    const ParticleData& p1 = *sorted[i];
+    const double x_max = p1.position().x1() + range;
+    for (std::size_t j = i + 1; j < sorted.size(); ++j) {
+      const ParticleData& p2 = *sorted[j];
+      if (p2.position().x1() > x_max) {
+        break;
+      }
+      // Check if a collision is possible, with the incoming particles
+      // ordered by id as in the plain pair loop.
+      ActionPtr act = p1.id() < p2.id() ? check_collision(p1, p2, dt)
+                                        : check_collision(p2, p1, dt);
+      if (act) {
+        actions.push_back(std::move(act));
+      }
+    }
   }
   return actions;
 }
 
 ActionList ScatterActionsFinder::find_actions_with_neighbors(
-    const ParticleList& search_list, const ParticleList& neighbors_list,
+    const ParticleSlice& search_list, const ParticleSlice& neighbors_list,
     double dt) const {
-  std::vector<ActionPtr> actions;
-  for (const ParticleData& p1 : search_list) {
-    for (const ParticleData& p2 : neighbors_list) {
-      assert(p1.id() != p2.id());
+  if (counting_enabled()) {
+    stats_->neighbor_searches.fetch_add(1, std::memory_order_relaxed);
+  }
+  ActionList actions;
+  if (search_list.size() < sweep_min_particles ||
+      neighbors_list.size() < sweep_min_particles) {
+    for (const ParticleData& p1 : search_list) {
+      for (const ParticleData& p2 : neighbors_list) {
+        assert(p1.id() != p2.id());
+        // Check if a collision is possible.
+        ActionPtr act = check_collision(p1, p2, dt);
+        if (act) {
+          actions.push_back(std::move(act));
+        }
+      }
+    }
+    return actions;
+  }
+  /* Sort-and-sweep refinement as in \ref find_actions_in_cell: both lists
+   * are sorted along one axis and for every particle of the search list
+   * only the window of neighbors within the sweep range is examined. */
+  std::vector<const ParticleData*> sorted_neighbors;
+  sorted_neighbors.reserve(neighbors_list.size());
+  for (const ParticleData& p : neighbors_list) {
+    sorted_neighbors.push_back(&p);
+  }
+  const auto compare_x = [](const ParticleData* a, const ParticleData* b) {
+    return a->position().x1() < b->position().x1();
+  };
+  std::sort(sorted_neighbors.begin(), sorted_neighbors.end(), compare_x);
+  std::vector<const ParticleData*> sorted_search;
+  sorted_search.reserve(search_list.size());
+  for (const ParticleData& p : search_list) {
+    sorted_search.push_back(&p);
+  }
+  std::sort(sorted_search.begin(), sorted_search.end(), compare_x);
+  const double range = sweep_range(dt);
+  std::size_t window_begin = 0;
+  for (const ParticleData* p1 : sorted_search) {
+    const double x = p1->position().x1();
+    while (window_begin < sorted_neighbors.size() &&
+           sorted_neighbors[window_begin]->position().x1() < x - range) {
+      ++window_begin;
+    }
+    for (std::size_t j = window_begin; j < sorted_neighbors.size(); ++j) {
+      const ParticleData& p2 = *sorted_neighbors[j];
+      if (p2.position().x1() > x + range) {
+        break;
+      }
+      assert(p1->id() != p2.id());
       // Check if a collision is possible.
-      ActionPtr act = check_collision(p1, p2, dt);
+      ActionPtr act = check_collision(*p1, p2, dt);
       if (act) {
         actions.push_back(std::move(act));
       }
@@ -347,9 +820,9 @@ ActionList ScatterActionsFinder::find_actions_with_neighbors(
 }
 
 ActionList ScatterActionsFinder::find_actions_with_surrounding_particles(
-    const ParticleList& search_list, const Particles& surrounding_list,
+    const ParticleList& search_list, const ParticleList& surrounding_list,
     double dt) const {
-  std::vector<ActionPtr> actions;
+  ActionList actions;
   for (const ParticleData& p2 : surrounding_list) {
     /* don't look for collisions if the particle from the surrounding list is
      * also in the search list */
@@ -370,6 +843,81 @@ ActionList ScatterActionsFinder::find_actions_with_surrounding_particles(
   return actions;
 }
 
+void ScatterActionsFinder::report_statistics() const {
+  if (!collect_statistics_) {
+    return;
+  }
+  const auto& log = logger<LogArea::FindScatter>();
+  const uint64_t cells = stats_->cell_searches.exchange(0);
+  const uint64_t neighbors = stats_->neighbor_searches.exchange(0);
+  const uint64_t pairs = stats_->pairs_examined.exchange(0);
+  const uint64_t approaching = stats_->pairs_approaching.exchange(0);
+  const uint64_t within = stats_->pairs_within_distance.exchange(0);
+  const uint64_t evaluated = stats_->xs_evaluations.exchange(0);
+  const uint64_t created = stats_->actions_created.exchange(0);
+  const std::array<uint64_t, 2> spectral =
+      ParticleType::spectral_cache_statistics();
+  /* The counters are ordered along the rejection cascade, so adjacent
+   * numbers give the rejection fraction of each layer. */
+  log.info() << "Collision search statistics: " << cells << " cell searches, "
+             << neighbors << " neighbor searches, " << pairs
+             << " pairs examined, " << approaching
+             << " approaching within the time step, " << within
+             << " within maximal cross-section distance, " << evaluated
+             << " cross-section evaluations, " << created
+             << " actions created. " << spectral[0] << " of "
+             << (spectral[0] + spectral[1])
+             << " spectral-function evaluations came from the memo.";
+}
+
+double ScatterActionsFinder::cell_length_scale(size_t particle_count) {
+  if (!adaptive_cell_size_ || particle_count == 0) {
+    return 1.0;
+  }
+  const uint64_t searches =
+      stats_->cell_searches.load(std::memory_order_relaxed) +
+      stats_->neighbor_searches.load(std::memory_order_relaxed);
+  const uint64_t pairs = stats_->pairs_examined.load(std::memory_order_relaxed);
+  CellSizeTuner& t = tuner_;
+  if (searches < t.last_searches || pairs < t.last_pairs) {
+    /* report_statistics() has reset the counters in between;
+     * resynchronize and skip one adjustment. */
+    t.last_searches = searches;
+    t.last_pairs = pairs;
+    t.last_cost = -1.;
+    return t.scale;
+  }
+  const uint64_t d_searches = searches - t.last_searches;
+  const uint64_t d_pairs = pairs - t.last_pairs;
+  t.last_searches = searches;
+  t.last_pairs = pairs;
+  if (d_searches == 0) {
+    // no search ran since the last call, nothing was measured
+    return t.scale;
+  }
+  /* Cost model: every visited cell combination has a fixed overhead and
+   * every examined pair costs a few times more (collision time, distance
+   * criterion). Normalizing per particle keeps the cost comparable between
+   * timesteps of a growing system. */
+  constexpr double pair_cost = 4.;
+  const double cost =
+      (d_searches + pair_cost * d_pairs) / static_cast<double>(particle_count);
+  if (t.last_cost >= 0. && cost > t.last_cost) {
+    // the previous adjustment made the search more expensive, turn around
+    t.growing = !t.growing;
+  }
+  t.last_cost = cost;
+  /* Small multiplicative steps: the optimum drifts slowly as the system
+   * expands and a 5% change stays well within the hysteresis of the cost
+   * measurement. The upper bound keeps the grid from collapsing into a
+   * handful of huge cells on a noisy measurement. */
+  constexpr double step = 1.05;
+  constexpr double max_scale = 4.0;
+  t.scale = t.growing ? std::min(t.scale * step, max_scale)
+                      : std::max(t.scale / step, 1.0);
+  return t.scale;
+}
+
 void ScatterActionsFinder::dump_reactions() const {
   constexpr double time = 0.0;
 
@@ -742,15 +1290,23 @@ void ScatterActionsFinder::dump_cross_sections(const ParticleType& a,
   std::map<std::string, xs_saver> xs_dump;
   std::map<std::string, double> outgoing_total_mass;
 
-  ParticleData a_data(a), b_data(b);
   constexpr int n_momentum_points = 200;
   constexpr double momentum_step = 0.02;
-  for (int i = 1; i < n_momentum_points + 1; i++) {
-    const double momentum = momentum_step * i;
+  /* The grid points are independent, so they can be evaluated on the shared
+   * pool in any order; each one fills its own slot and the slots are merged
+   * in grid order below, which reproduces the serial output exactly. The
+   * stateful Pythia object behind the string cross sections is shared and
+   * protected by a lock inside StringProcess, like in the collision search. */
+  std::vector<std::vector<FinalStateCrossSection>> grid(n_momentum_points);
+  std::vector<double> grid_sqrts(n_momentum_points);
+  const auto evaluate_point = [&](size_t slot) {
+    const double momentum = momentum_step * (slot + 1);
+    ParticleData a_data(a), b_data(b);
     a_data.set_4momentum(m_a, momentum, 0.0, 0.0);
     b_data.set_4momentum(m_b, -momentum, 0.0, 0.0);
     const double sqrts = (a_data.momentum() + b_data.momentum()).abs();
-    const ParticleList incoming = {a_data, b_data};
+    grid_sqrts[slot] = sqrts;
+    std::vector<FinalStateCrossSection>& channels = grid[slot];
     ScatterActionPtr act = make_unique<ScatterAction>(
         a_data, b_data, 0., isotropic_, string_formation_time_);
     if (strings_switch_) {
@@ -775,13 +1331,17 @@ void ScatterActionsFinder::dump_cross_sections(const ParticleType& a,
         for (const auto& ptype : process->particle_types()) {
           m_tot += ptype->mass();
         }
-        outgoing_total_mass[description] = m_tot;
-        if (!xs_dump[description].empty() &&
-            std::abs(xs_dump[description].back().first - sqrts) <
-                really_small) {
-          xs_dump[description].back().second += xs;
+        /* All entries of one grid point share one sqrts value, so channels
+         * appearing twice in the process list are summed right away. */
+        const auto previous = std::find_if(
+            channels.begin(), channels.end(),
+            [&description](const FinalStateCrossSection& entry) {
+              return entry.name_ == description;
+            });
+        if (previous != channels.end()) {
+          previous->cross_section_ += xs;
         } else {
-          xs_dump[description].push_back(std::make_pair(sqrts, xs));
+          channels.emplace_back(description, xs, m_tot);
         }
       } else {
         std::stringstream process_description_stream;
@@ -795,17 +1355,39 @@ void ScatterActionsFinder::dump_cross_sections(const ParticleType& a,
         decaytree::add_decays(process_node);
       }
     }
-    xs_dump["total"].push_back(std::make_pair(sqrts, act->cross_section()));
     // Total cross-section should be the first in the list -> negative mass
-    outgoing_total_mass["total"] = -1.0;
+    channels.emplace_back("total", act->cross_section(), -1.0);
+    /* Feed the scanned totals into the runtime cache, so the scan can be
+     * persisted for a subsequent production run (only stable species pairs
+     * are cacheable, see CrossSectionCache). */
+    xs_cache_.store(a, b, sqrts, act->cross_section());
     if (final_state) {
       // tree.print();
       auto final_state_xs = tree.final_state_cross_sections();
       deduplicate(final_state_xs);
-      for (const auto& p : final_state_xs) {
-        outgoing_total_mass[p.name_] = p.mass_;
-        xs_dump[p.name_].push_back(std::make_pair(sqrts, p.cross_section_));
-      }
+      channels.insert(channels.end(), final_state_xs.begin(),
+                      final_state_xs.end());
+    }
+  };
+  ThreadPool* pool = shared_pool();
+  if (pool) {
+    pool->parallel_range(n_momentum_points, evaluate_point);
+  } else {
+    for (int slot = 0; slot < n_momentum_points; slot++) {
+      evaluate_point(slot);
+    }
+  }
+  if (!xs_cache_file_.empty()) {
+    const std::size_t saved = xs_cache_.save(xs_cache_file_);
+    const auto& log = logger<LogArea::FindScatter>();
+    log.info("Saved cross-section cache tables of ", saved,
+             " species pairs to ", xs_cache_file_);
+  }
+  for (int i = 0; i < n_momentum_points; i++) {
+    for (const FinalStateCrossSection& channel : grid[i]) {
+      outgoing_total_mass[channel.name_] = channel.mass_;
+      xs_dump[channel.name_].push_back(
+          std::make_pair(grid_sqrts[i], channel.cross_section_));
     }
   }
 
@@ -833,10 +1415,7 @@ void ScatterActionsFinder::dump_cross_sections(const ParticleType& a,
 
   // Print out all partial cross-sections in mb
   for (int i = 1; i < n_momentum_points; i++) {
-    const double momentum = momentum_step * i;
-    a_data.set_4momentum(m_a, momentum, 0.0, 0.0);
-    b_data.set_4momentum(m_b, -momentum, 0.0, 0.0);
-    const double sqrts = (a_data.momentum() + b_data.momentum()).abs();
+    const double sqrts = grid_sqrts[i - 1];
     printf("%9.5f", sqrts);
     for (const auto channel : all_channels) {
       const xs_saver energy_and_xs = xs_dump[channel];
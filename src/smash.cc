@@ -7,24 +7,43 @@
  *
  */
 #include <getopt.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 
 #include <set>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include <boost/filesystem/fstream.hpp>
 
+#include "smash/asynclogsink.h"
 #include "smash/cxx14compat.h"
 #include "smash/decaymodes.h"
 #include "smash/experiment.h"
 #include "smash/filelock.h"
 #include "smash/inputfunctions.h"
+#include "smash/isoparticletype.h"
 #include "smash/random.h"
+#include "smash/runtimeprofiler.h"
 #include "smash/scatteractionsfinder.h"
+#include "smash/startupprofiler.h"
 #include "smash/stringfunctions.h"
+#include "smash/threadpool.h"
+#include "smash/tracerecorder.h"
 /* build dependent variables */
 #include "smash/config.h"
 
+#ifdef SMASH_USE_MPI
+#include <mpi.h>
+#endif
+
 namespace smash {
 
 namespace {
@@ -96,6 +115,16 @@ void usage(const int rc, const std::string &progname) {
    * <tr><td>`-r <pdg>` <td>`--resonance <pdg>`
    * <td> Dumps the width(m) and m * spectral function(m^2) versus resonance
    *     mass m.
+   * <tr><td>`-R <file>` <td>`--resume <file>`
+   * <td>Resume a preempted run from the given checkpoint file (see the
+   *     \key Checkpoint_Interval option). The configuration has to be the
+   *     one of the checkpointed run; the evolution continues bit-exactly at
+   *     the saved timestep, starting the output with the resumed event.
+   * <tr><td>`-y <n>` <td>`--replay-event <n>`
+   * <td>Compute only event number n of the configured run. Every event
+   *     draws from its own random stream derived from the seed and the
+   *     event number, so the replayed event is bit-identical to event n
+   *     of the full run (see the \key Replay_Event option).
    * <tr><td>`-s <pdg1>,<pdg2>[,mass1,mass2]`
    * <td>`--cross-sections <pdg1>,<pdg2>[,mass1,mass2]`
    * <td> Dumps all the partial cross-sections of pdg1 + pdg2 with
@@ -112,6 +141,21 @@ void usage(const int rc, const std::string &progname) {
    * <td>Forces overwriting files in the output directory. Normally, if you
    *     specifiy an output directory with `-o`, the directory must be empty.
    *     With `-f` this check is skipped.
+   * <tr><td>`-V` <td>`--verbose-startup`
+   * <td>Prints a report of the startup phases (table parsing,
+   *     spectral-integral tabulations, experiment setup, ...) with their
+   *     wall-clock times and CPU cycle counts. Useful to see which stage
+   *     of the startup regresses when particle tables are updated.
+   * <tr><td>`-P` <td>`--profile-run`
+   * <td>Accounts the CPU cycles of the evolution loop per phase (collision
+   *     search, propagation, lattice update, output) and per process type
+   *     of the performed actions. After the run, the accounting is printed
+   *     as a table and written to `run_phases.dat` in the output directory.
+   * <tr><td>`-T` <td>`--trace`
+   * <td>Records every collision search, propagation, lattice update and
+   *     output call as a span and writes `trace.json` in the output
+   *     directory, a Chrome trace-event timeline that chrome://tracing
+   *     can load. Useful for locating stalls instead of aggregates.
    * </table>
    */
   std::printf("\nUsage: %s [option]\n\n", progname.c_str());
@@ -135,6 +179,10 @@ void usage(const int rc, const std::string &progname) {
       "  -l, --list-2-to-n       list all possible 2->n reactions (with n>1)\n"
       "  -r, --resonance <pdg>   dump width(m) and m*spectral function(m^2)"
       " for resonance pdg\n"
+      "  -R, --resume <file>     resume a preempted run from the given "
+      "checkpoint file\n"
+      "  -y, --replay-event <n>  compute only event n of the run, "
+      "bit-identical to event n of the full run\n"
       "  -s, --cross-sections    <pdg1>,<pdg2>[,mass1,mass2] \n"
       "                          dump all partial cross-sections of "
       "pdg1 + pdg2 reactions versus sqrt(s).\n"
@@ -148,6 +196,11 @@ void usage(const int rc, const std::string &progname) {
       "  -f, --force             force overwriting files in the output "
       "directory"
       "\n"
+      "  -V, --verbose-startup   report timings of the startup phases\n"
+      "  -P, --profile-run       report per-phase and per-process-type "
+      "timings of the evolution\n"
+      "  -T, --trace             write a Chrome trace-event timeline of "
+      "the run\n"
       "  -v, --version\n\n");
   std::exit(rc);
 }
@@ -274,6 +327,305 @@ void ensure_path_is_valid(const bf::path &path) {
   }
 }
 
+/**
+ * Computes a hex FNV-1a digest of the given strings, used to key the
+ * tabulation cache on the particle and decay-mode content.
+ *
+ * \param[in] a The first string to hash.
+ * \param[in] b The second string to hash.
+ * \return the digest of the concatenation of both strings.
+ */
+std::string content_digest(const std::string &a, const std::string &b) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (const std::string *part : {&a, &b}) {
+    for (const char c : *part) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 0x100000001b3;
+    }
+  }
+  std::stringstream stream;
+  stream << std::hex << hash;
+  return stream.str();
+}
+
+/**
+ * Try to load the parsed particle and decay tables from the binary cache
+ * file \p file. The cache is versioned: a file written by a different SMASH
+ * version or an unreadable file is ignored and later rebuilt.
+ *
+ * \param[in] file Path of the cache file.
+ * \param[out] particles_loaded Whether the particle types were loaded.
+ * \param[out] decays_loaded Whether the decay modes were loaded.
+ */
+void load_tables_cache(const bf::path &file, bool &particles_loaded,
+                       bool &decays_loaded) {
+  particles_loaded = false;
+  decays_loaded = false;
+  if (!bf::exists(file)) {
+    return;
+  }
+  bf::ifstream stream(file, std::ios::binary);
+  char magic[4];
+  stream.read(magic, sizeof(magic));
+  uint16_t format_version, format_variant;
+  stream.read(reinterpret_cast<char *>(&format_version),
+              sizeof(format_version));
+  stream.read(reinterpret_cast<char *>(&format_variant),
+              sizeof(format_variant));
+  uint32_t version_size;
+  stream.read(reinterpret_cast<char *>(&version_size), sizeof(version_size));
+  if (stream.fail() || std::memcmp(magic, "SMSH", sizeof(magic)) != 0 ||
+      format_version != 0 || format_variant != 3 || version_size > 256) {
+    return;
+  }
+  std::string version(version_size, '\0');
+  stream.read(&version[0], version_size);
+  if (stream.fail() || version != VERSION_MAJOR) {
+    return;
+  }
+  particles_loaded = ParticleType::read_type_list_cache(stream);
+  if (particles_loaded) {
+    decays_loaded = DecayModes::read_decaymodes_cache(stream);
+  }
+}
+
+/**
+ * Write the parsed particle and decay tables to the binary cache file
+ * \p file, from which later runs with the same input load them back with a
+ * few bulk reads instead of re-parsing the input.
+ *
+ * \param[in] file Path of the cache file.
+ */
+void save_tables_cache(const bf::path &file) {
+  /* Write to a unique temporary file and rename it into place: the rename
+   * is atomic, so the many processes of a campaign can race on the cache
+   * without anyone ever reading a half-written file. */
+  const bf::path tmp = bf::unique_path(file.native() + ".%%%%-%%%%");
+  {
+    bf::ofstream stream(tmp, std::ios::binary);
+    stream.write("SMSH", 4);  // magic number
+    const uint16_t format_version = 0;
+    stream.write(reinterpret_cast<const char *>(&format_version),
+                 sizeof(format_version));
+    /* The binary particles and collisions outputs use the format variants
+     * 0 and 1 and the lattice output uses 2; the tables cache is 3. */
+    const uint16_t format_variant = 3;
+    stream.write(reinterpret_cast<const char *>(&format_variant),
+                 sizeof(format_variant));
+    const std::string version(VERSION_MAJOR);
+    const auto version_size = static_cast<uint32_t>(version.size());
+    stream.write(reinterpret_cast<const char *>(&version_size),
+                 sizeof(version_size));
+    stream.write(version.c_str(), version.size());
+    ParticleType::write_type_list_cache(stream);
+    DecayModes::write_decaymodes_cache(stream);
+  }
+  bf::rename(tmp, file);
+}
+
+#ifdef SMASH_USE_MPI
+/// Finalizes MPI; registered with atexit so direct std::exit calls are safe.
+void finalize_mpi() { MPI_Finalize(); }
+
+/**
+ * Loads the configuration on rank 0 and broadcasts it to all other ranks,
+ * so only one rank reads the input files.
+ *
+ * \param[in] input_path The path of the config.yaml file.
+ * \return The configuration, identical on every rank.
+ */
+Configuration load_configuration_shared(const bf::path &input_path) {
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  std::string yaml;
+  if (rank == 0) {
+    Configuration on_disk(input_path.parent_path(), input_path.filename());
+    yaml = on_disk.to_string();
+  }
+  unsigned long length = yaml.size();  // NOLINT(runtime/int): fixed MPI type
+  MPI_Bcast(&length, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+  yaml.resize(length);
+  MPI_Bcast(&yaml[0], length, MPI_CHAR, 0, MPI_COMM_WORLD);
+  return Configuration(yaml.c_str());
+}
+#endif
+
+/**
+ * Runs the requested number of events distributed over several experiments
+ * that execute concurrently on their own threads inside this process.
+ *
+ * All workers share the immutable particle and decay tables that were
+ * created before this function is called; every worker gets its own copy of
+ * the configuration, its own random seed and its own output subdirectory
+ * ("worker-0", "worker-1", ...) below \p output_path.
+ *
+ * \param[in] configuration The fully prepared configuration, used as a
+ *            template for the per-worker configurations.
+ * \param[in] output_path The directory where the output files are written.
+ * \param[in] num_workers Number of concurrently running experiments.
+ * \throw runtime_error if potentials are enabled (the potential lattices
+ *        are shared through global pointers and cannot be used by several
+ *        experiments at once) or if a worker configuration contains unused
+ *        values.
+ */
+void run_parallel_events(Configuration configuration,
+                         const bf::path &output_path, int num_workers) {
+  const auto &log = logger<LogArea::Main>();
+  if (configuration.has_value({"Potentials"})) {
+    throw std::runtime_error(
+        "Event_Parallelism > 1 cannot be combined with potentials, because "
+        "the potential lattices are shared through global pointers.");
+  }
+  const int nevents = configuration.read({"General", "Nevents"});
+  const int64_t seed = configuration.read({"General", "Randomseed"});
+  if (num_workers > nevents) {
+    num_workers = nevents;
+  }
+  log.info() << "Running " << nevents << " events on " << num_workers
+             << " concurrent experiments.";
+  const std::string config_string = configuration.to_string();
+
+  std::vector<ExperimentPtr> experiments;
+  experiments.reserve(num_workers);
+  for (int i = 0; i < num_workers; ++i) {
+    Configuration worker_config(config_string.c_str());
+    /* Distribute the events as evenly as possible. Every worker draws from
+     * its own thread-local random engine, seeded with consecutive seeds, so
+     * results are reproducible for a fixed seed and a fixed number of
+     * workers. */
+    const int worker_events =
+        nevents / num_workers + (i < nevents % num_workers ? 1 : 0);
+    worker_config["General"]["Nevents"] = worker_events;
+    worker_config["General"]["Randomseed"] = seed + i;
+    const bf::path worker_path =
+        output_path / ("worker-" + std::to_string(i));
+    ensure_path_is_valid(worker_path);
+    experiments.push_back(ExperimentBase::create(worker_config, worker_path));
+    if (i == 0) {
+      /* All workers get identical copies, checking the first one for unused
+       * values is enough. */
+      worker_config.take({"Version"});
+      const std::string report = worker_config.unused_values_report();
+      if (report != "{}") {
+        throw std::runtime_error(
+            "The following configuration values were not used:\n" + report);
+      }
+    }
+    // No YAML lookups are allowed once the worker starts computing.
+    worker_config.freeze();
+  }
+
+  std::vector<std::exception_ptr> errors(num_workers);
+  std::vector<std::thread> threads;
+  threads.reserve(num_workers);
+  for (int i = 0; i < num_workers; ++i) {
+    threads.emplace_back([&experiments, &errors, i]() {
+      try {
+        experiments[i]->run();
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+/**
+ * Compute the events in several forked child processes.
+ *
+ * The parent performs all expensive, read-only initialization (particle and
+ * decay tables, spectral-integral tabulations) before this function is
+ * called; the children inherit it via copy-on-write and only pay for their
+ * own experiment setup. That amortizes the startup cost over a whole batch,
+ * which matters for small systems where an event takes milliseconds but the
+ * initialization takes tens of seconds. The batches run concurrently; every
+ * batch writes into its own output subdirectory ("batch-0", "batch-1", ...)
+ * and draws from its own random stream, like the threaded workers of
+ * run_parallel_events().
+ *
+ * \param[in] configuration The fully prepared configuration, used as a
+ *            template for the per-batch configurations.
+ * \param[in] output_path The directory where the output files are written.
+ * \param[in] num_batches Number of forked child processes.
+ * \throw runtime_error if forking fails, a batch configuration contains
+ *        unused values or a child exits unsuccessfully.
+ */
+void run_forked_batches(Configuration configuration,
+                        const bf::path &output_path, int num_batches) {
+  const auto &log = logger<LogArea::Main>();
+  const int nevents = configuration.read({"General", "Nevents"});
+  const int64_t seed = configuration.read({"General", "Randomseed"});
+  if (num_batches > nevents) {
+    num_batches = nevents;
+  }
+  log.info() << "Running " << nevents << " events in " << num_batches
+             << " forked batches.";
+  const std::string config_string = configuration.to_string();
+  std::vector<pid_t> children;
+  children.reserve(num_batches);
+  for (int i = 0; i < num_batches; ++i) {
+    const pid_t pid = fork();
+    if (pid < 0) {
+      throw std::runtime_error(std::string("fork failed: ") +
+                               std::strerror(errno));
+    }
+    if (pid == 0) {
+      // Child process: compute one batch of events, then exit.
+      try {
+        drop_shared_pool_after_fork();
+        AsyncLogSink::drop_after_fork();
+        Configuration batch_config(config_string.c_str());
+        const int batch_events =
+            nevents / num_batches + (i < nevents % num_batches ? 1 : 0);
+        batch_config["General"]["Nevents"] = batch_events;
+        batch_config["General"]["Randomseed"] = seed + i;
+        const bf::path batch_path =
+            output_path / ("batch-" + std::to_string(i));
+        ensure_path_is_valid(batch_path);
+        auto experiment = ExperimentBase::create(batch_config, batch_path);
+        if (i == 0) {
+          /* All batches get identical copies, checking the first one for
+           * unused values is enough. */
+          batch_config.take({"Version"});
+          const std::string report = batch_config.unused_values_report();
+          if (report != "{}") {
+            throw std::runtime_error(
+                "The following configuration values were not used:\n" +
+                report);
+          }
+        }
+        batch_config.freeze();
+        experiment->run();
+      } catch (std::exception &e) {
+        log.fatal() << "Batch " << i
+                    << " failed with the following error:\n" << e.what();
+        std::_Exit(EXIT_FAILURE);
+      }
+      std::_Exit(EXIT_SUCCESS);
+    }
+    children.push_back(pid);
+  }
+
+  bool failed = false;
+  for (const pid_t child : children) {
+    int status = 0;
+    if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != EXIT_SUCCESS) {
+      failed = true;
+    }
+  }
+  if (failed) {
+    throw std::runtime_error("At least one forked event batch failed.");
+  }
+}
+
 /**
  * Prepares ActionsFinder for cross-section and reaction dumps.
  *
@@ -331,6 +683,10 @@ void check_config_version_is_compatible(Configuration configuration) {
  * \return Either 0 or EXIT_FAILURE.
  */
 int main(int argc, char *argv[]) {
+#ifdef SMASH_USE_MPI
+  MPI_Init(&argc, &argv);
+  std::atexit(smash::finalize_mpi);
+#endif
   using namespace smash;  // NOLINT(build/namespaces)
 
   const auto &log = logger<LogArea::Main>();
@@ -345,10 +701,15 @@ int main(int argc, char *argv[]) {
       {"modus", required_argument, 0, 'm'},
       {"particles", required_argument, 0, 'p'},
       {"output", required_argument, 0, 'o'},
+      {"profile-run", no_argument, 0, 'P'},
       {"list-2-to-n", no_argument, 0, 'l'},
       {"resonance", required_argument, 0, 'r'},
+      {"replay-event", required_argument, 0, 'y'},
+      {"resume", required_argument, 0, 'R'},
       {"cross-sections", required_argument, 0, 's'},
       {"cross-sections-fs", required_argument, 0, 'S'},
+      {"trace", no_argument, 0, 'T'},
+      {"verbose-startup", no_argument, 0, 'V'},
       {"version", no_argument, 0, 'v'},
       {nullptr, 0, 0, 0}};
 
@@ -360,7 +721,8 @@ int main(int argc, char *argv[]) {
     bf::path output_path = default_output_path(), input_path("./config.yaml");
     std::vector<std::string> extra_config;
     char *particles = nullptr, *decaymodes = nullptr, *modus = nullptr,
-         *end_time = nullptr, *pdg_string = nullptr, *cs_string = nullptr;
+         *end_time = nullptr, *pdg_string = nullptr, *cs_string = nullptr,
+         *resume_checkpoint = nullptr, *replay_event = nullptr;
     bool list2n_activated = false;
     bool resonance_dump_activated = false;
     bool cross_section_dump_activated = false;
@@ -369,7 +731,8 @@ int main(int argc, char *argv[]) {
     // parse command-line arguments
     int opt;
     bool suppress_disclaimer = false;
-    while ((opt = getopt_long(argc, argv, "c:d:e:fhi:m:p:o:lr:s:S:v", longopts,
+    while ((opt = getopt_long(argc, argv, "c:d:e:fhi:m:p:o:lPr:R:s:S:Tvy:V",
+                              longopts,
                               nullptr)) != -1) {
       switch (opt) {
         case 'c':
@@ -408,6 +771,12 @@ int main(int argc, char *argv[]) {
           pdg_string = optarg;
           suppress_disclaimer = true;
           break;
+        case 'R':
+          resume_checkpoint = optarg;
+          break;
+        case 'y':
+          replay_event = optarg;
+          break;
         case 'S':
           final_state_cross_sections = true;
           // fallthrough
@@ -416,6 +785,15 @@ int main(int argc, char *argv[]) {
           cs_string = optarg;
           suppress_disclaimer = true;
           break;
+        case 'P':
+          RuntimeProfiler::enable();
+          break;
+        case 'T':
+          TraceRecorder::enable();
+          break;
+        case 'V':
+          StartupProfiler::enable();
+          break;
         case 'v':
           std::printf(
               "%s\n"
@@ -443,8 +821,14 @@ int main(int argc, char *argv[]) {
     setup_default_float_traps();
 
     // Read in config file
+#ifdef SMASH_USE_MPI
+    /* Under MPI only rank 0 reads the file, all other ranks receive the
+     * parsed configuration via a broadcast. */
+    Configuration configuration = load_configuration_shared(input_path);
+#else
     Configuration configuration(input_path.parent_path(),
                                 input_path.filename());
+#endif
     for (const auto &config : extra_config) {
       configuration.merge_yaml(config);
     }
@@ -532,6 +916,10 @@ int main(int argc, char *argv[]) {
         std::cout << "Warning: pole mass is used for stable particle "
                   << b.name() << " instead of " << args[3] << std::endl;
       }
+      /* The scan evaluates the energy grid on the shared pool, so the
+       * Parallelism setting speeds up the dump like a normal run. */
+      initialize_shared_pool(
+          configuration.take({"General", "Parallelism"}, 1));
       auto scat_finder = actions_finder_for_dump(configuration);
       scat_finder.dump_cross_sections(a, b, ma, mb, final_state_cross_sections);
       std::exit(EXIT_SUCCESS);
@@ -542,10 +930,21 @@ int main(int argc, char *argv[]) {
     if (end_time) {
       configuration["General"]["End_Time"] = std::abs(std::atof(end_time));
     }
+    if (resume_checkpoint) {
+      configuration["General"]["Resume_From"] =
+          std::string(resume_checkpoint);
+    }
+    if (replay_event) {
+      configuration["General"]["Replay_Event"] = std::atoi(replay_event);
+    }
 
     // Set up logging
     set_default_loglevel(
         configuration.take({"Logging", "default"}, einhard::ALL));
+    if (configuration.take({"Logging", "Async"}, false)) {
+      AsyncLogSink::install(
+          configuration.take({"Logging", "Structured"}, false));
+    }
     create_all_loggers(configuration["Logging"]);
 
     int64_t seed = configuration.read({"General", "Randomseed"});
@@ -560,10 +959,44 @@ int main(int argc, char *argv[]) {
       seed = static_cast<int64_t>(unsigned_seed >> 1);
       configuration["General"]["Randomseed"] = seed;
     }
+    AsyncLogSink::set_run_id(seed);
+#ifdef SMASH_USE_MPI
+    /* All ranks must agree on the seed, otherwise a negative Randomseed
+     * would give every rank an unrelated one from its own random_device. */
+    MPI_Bcast(&seed, 1, MPI_INT64_T, 0, MPI_COMM_WORLD);
+    configuration["General"]["Randomseed"] = seed;
+
+    int mpi_rank = 0, mpi_size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    if (mpi_size > 1) {
+      /* Farm the events over the ranks: every rank knows its share and seed
+       * deterministically from its rank number, and writes into its own
+       * sharded output directory so no rank ever blocks on another one. */
+      const int nevents = configuration.read({"General", "Nevents"});
+      const int rank_events =
+          nevents / mpi_size + (mpi_rank < nevents % mpi_size ? 1 : 0);
+      configuration["General"]["Nevents"] = rank_events;
+      configuration["General"]["Randomseed"] = seed + mpi_rank;
+      output_path /= "rank-" + std::to_string(mpi_rank);
+      log.info() << "MPI rank " << mpi_rank << " of " << mpi_size
+                 << " computes " << rank_events << " events.";
+    }
+#endif
 
     // Check output path
     ensure_path_is_valid(output_path);
-    const bf::path lock_path = output_path / "smash.lock";
+    /* Sharded instances (see the Shard_Suffix output option) deliberately
+     * share the output directory, so the lock file and the configuration
+     * copy are scoped by the suffix: instances with different suffixes
+     * coexist, two instances with the same suffix are still caught. */
+    std::string shard;
+    if (configuration.has_value({"Output", "Shard_Suffix"})) {
+      const std::string suffix =
+          configuration.read({"Output", "Shard_Suffix"});
+      shard = "." + suffix;
+    }
+    const bf::path lock_path = output_path / ("smash" + shard + ".lock");
     FileLock lock(lock_path);
     if (!lock.acquire()) {
       throw std::runtime_error(
@@ -572,7 +1005,8 @@ int main(int argc, char *argv[]) {
           lock_path.native() + "\".");
     }
     log.debug("output path: ", output_path);
-    if (!force_overwrite && bf::exists(output_path / "config.yaml")) {
+    if (!force_overwrite &&
+        bf::exists(output_path / ("config" + shard + ".yaml"))) {
       throw std::runtime_error(
           "Output directory would get overwritten. Select a different output "
           "directory, clean up, or tell SMASH to ignore existing files.");
@@ -580,7 +1014,7 @@ int main(int argc, char *argv[]) {
 
     /* Keep a copy of the configuration that was used in the output directory
      * also save information about SMASH build as a comment */
-    bf::ofstream(output_path / "config.yaml")
+    bf::ofstream(output_path / ("config" + shard + ".yaml"))
         << "# " << VERSION_MAJOR << '\n'
         << "# Branch   : " << GIT_BRANCH << '\n'
         << "# System   : " << CMAKE_SYSTEM << '\n'
@@ -591,32 +1025,108 @@ int main(int argc, char *argv[]) {
         << configuration.to_string() << '\n';
 
     log.trace(source_location, " create ParticleType and DecayModes");
-    ParticleType::create_type_list(configuration.take({"particles"}));
-    DecayModes::load_decaymodes(configuration.take({"decaymodes"}));
-    ParticleType::check_consistency();
-
-    // Create an experiment
-    log.trace(source_location, " create Experiment");
-    auto experiment = ExperimentBase::create(configuration, output_path);
-    //
-    // version value is not used in experiment. Get rid of it to prevent
-    // warning.
-    configuration.take({"Version"});
-    const std::string report = configuration.unused_values_report();
-
-    if (report != "{}") {
+    {
+      StartupProfiler::Phase phase("Particle and decay tables");
+      const std::string particle_string = configuration.take({"particles"});
+      const std::string decay_string = configuration.take({"decaymodes"});
+
+      const std::string tabulation_cache_path = configuration.take(
+          {"General", "Tabulation_Cache_Path"}, std::string());
+      bf::path tables_cache_file;
+      if (!tabulation_cache_path.empty()) {
+        /* The tabulations and the parsed tables only depend on the particle
+         * and decay-mode content, so the cache is keyed on a digest of both:
+         * a changed input gets a fresh subdirectory and can never pick up
+         * stale tables. */
+        const std::string key = content_digest(particle_string, decay_string);
+        IsoParticleType::set_tabulation_cache(tabulation_cache_path, key);
+        tables_cache_file =
+            bf::path(tabulation_cache_path) / key / "tables.bin";
+      }
+      bool particles_loaded = false, decays_loaded = false;
+      if (!tables_cache_file.empty()) {
+        load_tables_cache(tables_cache_file, particles_loaded, decays_loaded);
+      }
+      if (!particles_loaded) {
+        ParticleType::create_type_list(particle_string);
+      }
+      if (!decays_loaded) {
+        DecayModes::load_decaymodes(decay_string);
+      }
+      ParticleType::check_consistency();
+      if (!tables_cache_file.empty() && !(particles_loaded && decays_loaded)) {
+        save_tables_cache(tables_cache_file);
+      }
+    }
+
+    /* Create the shared thread pool before any experiment is set up, so all
+     * subsystems find it in place. */
+    const int parallelism = configuration.take({"General", "Parallelism"}, 1);
+    initialize_shared_pool(parallelism);
+    if (parallelism > 1) {
+      log.info() << "Shared thread pool uses " << parallelism << " threads.";
+    }
+    /* With the pool in place the spectral-integral tabulations can be built
+     * on all cores instead of lazily at the first collision of each kind. */
+    {
+      StartupProfiler::Phase phase("Spectral-integral tabulations");
+      IsoParticleType::tabulate_integrals();
+    }
+
+    const int fork_batches = configuration.take({"General", "Fork_Batches"}, 1);
+    const int event_parallelism =
+        configuration.take({"General", "Event_Parallelism"}, 1);
+    if (fork_batches > 1 && event_parallelism > 1) {
       throw std::runtime_error(
-          "The following configuration values were not used:\n" + report);
+          "Fork_Batches cannot be combined with Event_Parallelism.");
     }
+    if (fork_batches > 1) {
+      // Compute the events in forked child processes
+      log.trace(source_location, " run forked event batches");
+      StartupProfiler::report();
+      run_forked_batches(std::move(configuration), output_path, fork_batches);
+    } else if (event_parallelism > 1) {
+      // Run several experiments concurrently within this process
+      log.trace(source_location, " run concurrent Experiments");
+      StartupProfiler::report();
+      run_parallel_events(std::move(configuration), output_path,
+                          event_parallelism);
+    } else {
+      // Create an experiment
+      log.trace(source_location, " create Experiment");
+      std::unique_ptr<ExperimentBase> experiment;
+      {
+        StartupProfiler::Phase phase("Experiment setup");
+        experiment = ExperimentBase::create(configuration, output_path);
+      }
+      //
+      // version value is not used in experiment. Get rid of it to prevent
+      // warning.
+      configuration.take({"Version"});
+      const std::string report = configuration.unused_values_report();
 
-    // Run the experiment
-    log.trace(source_location, " run the Experiment");
-    experiment->run();
+      if (report != "{}") {
+        throw std::runtime_error(
+            "The following configuration values were not used:\n" + report);
+      }
+
+      /* All parameters are resolved into typed structures by now; any YAML
+       * lookup from running code is a bug and throws from here on. */
+      configuration.freeze();
+
+      StartupProfiler::report();
+
+      // Run the experiment
+      log.trace(source_location, " run the Experiment");
+      experiment->run();
+    }
   } catch (std::exception &e) {
     log.fatal() << "SMASH failed with the following error:\n" << e.what();
+    AsyncLogSink::shutdown();
     return EXIT_FAILURE;
   }
 
   log.trace() << source_location << " about to return from main";
+  AsyncLogSink::shutdown();
   return 0;
 }
@@ -0,0 +1,97 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/spatialindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "smash/fourvector.h"
+#include "smash/particledata.h"
+#include "smash/threevector.h"
+
+namespace smash {
+
+SpatialIndex::SpatialIndex(const Particles &particles, double min_cell_length) {
+  if (particles.size() == 0) {
+    min_ = {{0., 0., 0.}};
+    index_factor_ = 1. / min_cell_length;
+    number_of_cells_ = {1, 1, 1};
+    cells_.resize(1);
+    return;
+  }
+
+  const auto min_and_length = find_min_and_length(particles);
+  min_ = min_and_length.first;
+  const auto &length = min_and_length.second;
+
+  /* Cells of exactly min_cell_length, rounding down: the remainder is
+   * merged into the last cell of each direction via the clamping in
+   * cell_coordinate, which only makes that cell larger. */
+  index_factor_ = 1. / min_cell_length;
+  for (std::size_t i = 0; i < number_of_cells_.size(); ++i) {
+    number_of_cells_[i] = std::max(
+        SizeType(1), static_cast<SizeType>(std::floor(length[i] *
+                                                      index_factor_)));
+  }
+  cells_.resize(number_of_cells_[0] * number_of_cells_[1] *
+                number_of_cells_[2]);
+
+  for (const ParticleData &p : particles) {
+    insert(p);
+  }
+}
+
+SpatialIndex::SizeType SpatialIndex::cell_coordinate(double x,
+                                                     std::size_t dim) const {
+  const SizeType i =
+      static_cast<SizeType>(std::floor((x - min_[dim]) * index_factor_));
+  return std::min(number_of_cells_[dim] - 1, std::max(SizeType(0), i));
+}
+
+void SpatialIndex::insert(const ParticleData &p) {
+  const ThreeVector pos = p.position().threevec();
+  const SizeType cx = cell_coordinate(pos.x1(), 0);
+  const SizeType cy = cell_coordinate(pos.x2(), 1);
+  const SizeType cz = cell_coordinate(pos.x3(), 2);
+  cells_[(cz * number_of_cells_[1] + cy) * number_of_cells_[0] + cx].push_back(
+      p);
+}
+
+ParticleList SpatialIndex::neighborhood(const ParticleData &p,
+                                        const Particles &particles) const {
+  ParticleList result;
+  const ThreeVector pos = p.position().threevec();
+  const SizeType cx = cell_coordinate(pos.x1(), 0);
+  const SizeType cy = cell_coordinate(pos.x2(), 1);
+  const SizeType cz = cell_coordinate(pos.x3(), 2);
+  for (SizeType z = std::max(SizeType(0), cz - 1);
+       z <= std::min(number_of_cells_[2] - 1, cz + 1); ++z) {
+    for (SizeType y = std::max(SizeType(0), cy - 1);
+         y <= std::min(number_of_cells_[1] - 1, cy + 1); ++y) {
+      for (SizeType x = std::max(SizeType(0), cx - 1);
+           x <= std::min(number_of_cells_[0] - 1, cx + 1); ++x) {
+        const auto &cell =
+            cells_[(z * number_of_cells_[1] + y) * number_of_cells_[0] + x];
+        for (const ParticleData &entry : cell) {
+          /* Lazy removal: the entry is stale if the particle interacted or
+           * was removed since it was indexed. */
+          if (!particles.is_valid(entry)) {
+            continue;
+          }
+          // return the current state, the indexed position has aged
+          result.push_back(particles.lookup(entry));
+        }
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace smash
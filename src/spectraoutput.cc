@@ -0,0 +1,200 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/spectraoutput.h"
+
+#include <cinttypes>
+#include <cmath>
+
+#include <boost/filesystem.hpp>
+
+#include "smash/config.h"
+#include "smash/particles.h"
+
+namespace smash {
+namespace {
+
+/**
+ * \param[in] name Axis name from the configuration.
+ * \return The corresponding axis.
+ * \throw std::invalid_argument for an unknown axis name.
+ */
+SpectraOutput::Axis axis_from_string(const std::string &name) {
+  if (name == "pT") {
+    return SpectraOutput::Axis::PT;
+  } else if (name == "y") {
+    return SpectraOutput::Axis::Y;
+  } else if (name == "mT") {
+    return SpectraOutput::Axis::MT;
+  } else if (name == "phi") {
+    return SpectraOutput::Axis::PHI;
+  }
+  throw std::invalid_argument("Spectra output: unknown axis \"" + name +
+                              "\", valid axes are pT, y, mT and phi.");
+}
+
+/**
+ * \param[in] axis The histogram axis.
+ * \return The axis name used in the configuration and the output file.
+ */
+const char *axis_name(SpectraOutput::Axis axis) {
+  switch (axis) {
+    case SpectraOutput::Axis::PT:
+      return "pT";
+    case SpectraOutput::Axis::Y:
+      return "y";
+    case SpectraOutput::Axis::MT:
+      return "mT";
+    case SpectraOutput::Axis::PHI:
+    default:
+      return "phi";
+  }
+}
+
+}  // unnamed namespace
+
+/*!\Userguide
+ * \page spectra_output_user_guide_ ASCII Spectra Output
+ *
+ * The spectra output (spectra.dat) histograms the final particle lists of
+ * all events in-process instead of writing the particles out: for every
+ * configured species and every configured kinematic variable one
+ * histogram is accumulated over the whole run and written once at its
+ * end. For analyses that only need spectra this replaces the entire
+ * particle output.
+ *
+ * The file starts with the header
+ * \code
+ * # **smash_version** spectra output
+ * # **n_events** events
+ * \endcode
+ * followed by one block per species and axis. Each block has a header
+ * line naming the PDG code, the axis, its range and the number of bins,
+ * and one line per bin with the bin center and the per-event yield
+ * \f$ dN/dx \f$ (the bin content divided by the number of events and the
+ * bin width):
+ * \code
+ * # pdg 211 axis pT range 0 4 bins 50
+ * 0.04 1.2345e+01
+ * ...
+ * \endcode
+ *
+ * The axes are the transverse momentum \key pT [GeV], the rapidity
+ * \key y, the transverse mass minus the pole mass \key mT [GeV] and the
+ * azimuthal angle \key phi [rad]. The \f$p_T\f$ yield is not divided by
+ * \f$p_T\f$. Particles outside the histogram range are dropped.
+ */
+
+SpectraOutput::SpectraOutput(const bf::path &path, const std::string &name,
+                             const OutputParameters &out_par)
+    : OutputInterface(name),
+      file_{out_par.shard_path(path, "spectra.dat"), "w"},
+      pdgs_(out_par.spectra_pdgs),
+      bins_(out_par.spectra_bins),
+      pt_max_(out_par.spectra_pt_max),
+      y_max_(out_par.spectra_y_max) {
+  for (const std::string &axis : out_par.spectra_axes) {
+    axes_.push_back(axis_from_string(axis));
+  }
+  counts_.resize(pdgs_.size() * axes_.size());
+  for (auto &histogram : counts_) {
+    histogram.assign(bins_, 0.);
+  }
+}
+
+double SpectraOutput::lower_edge(Axis axis) const {
+  switch (axis) {
+    case Axis::Y:
+      return -y_max_;
+    case Axis::PHI:
+      return -M_PI;
+    default:
+      return 0.;
+  }
+}
+
+double SpectraOutput::upper_edge(Axis axis) const {
+  switch (axis) {
+    case Axis::Y:
+      return y_max_;
+    case Axis::PHI:
+      return M_PI;
+    default:
+      return pt_max_;
+  }
+}
+
+SpectraOutput::~SpectraOutput() {
+  std::fprintf(file_.get(), "# %s spectra output\n", VERSION_MAJOR);
+  std::fprintf(file_.get(), "# %" PRIu64 " events\n", events_);
+  for (size_t s = 0; s < pdgs_.size(); s++) {
+    for (size_t a = 0; a < axes_.size(); a++) {
+      const Axis axis = axes_[a];
+      const double lo = lower_edge(axis);
+      const double width = (upper_edge(axis) - lo) / bins_;
+      std::fprintf(file_.get(), "# pdg %s axis %s range %g %g bins %d\n",
+                   pdgs_[s].string().c_str(), axis_name(axis), lo,
+                   upper_edge(axis), bins_);
+      const std::vector<double> &histogram = counts_[s * axes_.size() + a];
+      for (int b = 0; b < bins_; b++) {
+        const double yield =
+            events_ > 0 ? histogram[b] / (events_ * width) : 0.;
+        std::fprintf(file_.get(), "%g %g\n", lo + (b + 0.5) * width, yield);
+      }
+    }
+  }
+}
+
+void SpectraOutput::at_eventstart(const Particles &, const int) {}
+
+void SpectraOutput::at_eventend(const Particles &particles, const int,
+                                double) {
+  for (const ParticleData &p : particles) {
+    size_t s = 0;
+    while (s < pdgs_.size() && pdgs_[s] != p.pdgcode()) {
+      s++;
+    }
+    if (s == pdgs_.size()) {
+      continue;
+    }
+    const FourVector mom = p.momentum();
+    const double pt =
+        std::sqrt(mom.x1() * mom.x1() + mom.x2() * mom.x2());
+    for (size_t a = 0; a < axes_.size(); a++) {
+      const Axis axis = axes_[a];
+      double value;
+      switch (axis) {
+        case Axis::PT:
+          value = pt;
+          break;
+        case Axis::Y:
+          value = 0.5 * std::log((mom.x0() + mom.x3()) /
+                                 (mom.x0() - mom.x3()));
+          break;
+        case Axis::MT:
+          value = std::sqrt(p.type().mass() * p.type().mass() + pt * pt) -
+                  p.type().mass();
+          break;
+        case Axis::PHI:
+        default:
+          value = std::atan2(mom.x2(), mom.x1());
+          break;
+      }
+      const double lo = lower_edge(axis);
+      const double width = (upper_edge(axis) - lo) / bins_;
+      const int bin = static_cast<int>(std::floor((value - lo) / width));
+      if (bin >= 0 && bin < bins_) {
+        counts_[s * axes_.size() + a][bin] += 1.;
+      }
+    }
+  }
+  events_++;
+}
+
+}  // namespace smash
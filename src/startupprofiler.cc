@@ -0,0 +1,99 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/startupprofiler.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace smash {
+
+namespace {
+
+/// One finished startup phase.
+struct PhaseRecord {
+  /// The name the phase is reported under.
+  std::string name;
+  /// Wall-clock duration of the phase [ms].
+  double wall_ms;
+  /// CPU cycles spent in the phase.
+  uint64_t cycles;
+};
+
+/// Whether startup phase timings are collected.
+bool profiling_enabled = false;
+
+/// Whether the startup report was already printed.
+bool report_printed = false;
+
+/// Phases finished before the report.
+std::vector<PhaseRecord> records;
+
+/**
+ * Print one line of the startup report.
+ *
+ * \param[in] record The phase to print.
+ */
+void print_record(const PhaseRecord &record) {
+  std::cout << "  " << std::left << std::setw(36) << record.name << std::right
+            << std::setw(12) << std::fixed << std::setprecision(1)
+            << record.wall_ms << " ms" << std::setw(16) << record.cycles
+            << " cycles" << std::endl;
+}
+
+}  // unnamed namespace
+
+void StartupProfiler::enable() { profiling_enabled = true; }
+
+bool StartupProfiler::is_enabled() { return profiling_enabled; }
+
+void StartupProfiler::report() {
+  if (!profiling_enabled) {
+    return;
+  }
+  std::cout << "Startup phase timings:" << std::endl;
+  for (const PhaseRecord &record : records) {
+    print_record(record);
+  }
+  records.clear();
+  report_printed = true;
+}
+
+StartupProfiler::Phase::Phase(const std::string &name) : name_(name) {
+  if (!profiling_enabled) {
+    return;
+  }
+  wall_start_ = std::chrono::steady_clock::now();
+  tsc_.start();
+}
+
+StartupProfiler::Phase::~Phase() {
+  if (!profiling_enabled) {
+    return;
+  }
+  tsc_.stop();
+  const double wall_ms =
+      std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(
+          std::chrono::steady_clock::now() - wall_start_)
+          .count();
+  PhaseRecord record{name_, wall_ms, tsc_.cycles()};
+  if (report_printed) {
+    /* Deferred phases run after the startup report; print them right away
+     * so their cost is not lost. */
+    std::cout << "Deferred startup phase:" << std::endl;
+    print_record(record);
+  } else {
+    records.push_back(std::move(record));
+  }
+}
+
+}  // namespace smash
@@ -7,6 +7,16 @@
 
 #include "smash/tabulation.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <utility>
+
 namespace smash {
 
 Tabulation::Tabulation(double x_min, double range, int num,
@@ -17,37 +27,108 @@ Tabulation::Tabulation(double x_min, double range, int num,
   for (int i = 0; i <= num; i++) {
     values_[i] = f(x_min_ + i * dx);
   }
+  data_ = values_.data();
+  num_values_ = values_.size();
+}
+
+Tabulation::Tabulation(
+    double x_min, double range, int num,
+    const std::function<std::vector<double>(const std::vector<double>&)>& f)
+    : x_min_(x_min), x_max_(x_min + range), inv_dx_(num / range) {
+  const double dx = range / num;
+  std::vector<double> grid(num + 1);
+  for (int i = 0; i <= num; i++) {
+    grid[i] = x_min_ + i * dx;
+  }
+  values_ = f(grid);
+  assert(values_.size() == grid.size());
+  data_ = values_.data();
+  num_values_ = values_.size();
+}
+
+Tabulation::Tabulation(double x_min, double range, std::vector<double> values)
+    : values_(std::move(values)),
+      x_min_(x_min),
+      x_max_(x_min + range),
+      inv_dx_((values_.size() - 1) / range) {
+  data_ = values_.data();
+  num_values_ = values_.size();
+}
+
+Tabulation::Tabulation(double x_min, double range, const double* values,
+                       std::size_t num)
+    : x_min_(x_min), x_max_(x_min + range), inv_dx_((num - 1) / range) {
+  data_ = values;
+  num_values_ = num;
+}
+
+Tabulation::~Tabulation() {
+  if (map_addr_ != nullptr) {
+    munmap(map_addr_, map_size_);
+  }
+}
+
+void Tabulation::write(std::ostream& stream) const {
+  const uint64_t n = num_values_;
+  stream.write(reinterpret_cast<const char*>(&x_min_), sizeof(x_min_));
+  stream.write(reinterpret_cast<const char*>(&x_max_), sizeof(x_max_));
+  stream.write(reinterpret_cast<const char*>(&n), sizeof(n));
+  stream.write(reinterpret_cast<const char*>(data_), n * sizeof(double));
 }
 
-double Tabulation::get_value_step(double x) const {
-  if (x < x_min_) {
-    return 0.;
+std::unique_ptr<Tabulation> Tabulation::from_stream(std::istream& stream) {
+  double x_min = 0., x_max = 0.;
+  uint64_t n = 0;
+  stream.read(reinterpret_cast<char*>(&x_min), sizeof(x_min));
+  stream.read(reinterpret_cast<char*>(&x_max), sizeof(x_max));
+  stream.read(reinterpret_cast<char*>(&n), sizeof(n));
+  if (!stream || n < 2 || !(x_max > x_min)) {
+    return nullptr;
   }
-  // this rounds correctly because double -> int conversion truncates
-  const unsigned int n = (x - x_min_) * inv_dx_ + 0.5;
-  if (n >= values_.size()) {
-    return values_.back();
-  } else {
-    return values_[n];
+  std::vector<double> values(n);
+  stream.read(reinterpret_cast<char*>(values.data()), n * sizeof(double));
+  if (!stream) {
+    return nullptr;
   }
+  return make_unique<Tabulation>(x_min, x_max - x_min, std::move(values));
 }
 
-double Tabulation::get_value_linear(double x, Extrapolation extrapol) const {
-  if (x < x_min_) {
-    return 0.;
+std::unique_ptr<Tabulation> Tabulation::map_file(const std::string& filename) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
   }
-  if (extrapol == Extrapolation::Zero && x > x_max_) {
-    return 0.0;
+  /* The header layout of \ref write: the bounds followed by the value
+   * count, with the values directly behind (and thus 8-byte aligned). */
+  struct {
+    double x_min;
+    double x_max;
+    uint64_t n;
+  } header;
+  struct stat file_stat;
+  if (read(fd, &header, sizeof(header)) !=
+          static_cast<ssize_t>(sizeof(header)) ||
+      header.n < 2 || !(header.x_max > header.x_min) ||
+      fstat(fd, &file_stat) != 0 ||
+      static_cast<uint64_t>(file_stat.st_size) !=
+          sizeof(header) + header.n * sizeof(double)) {
+    close(fd);
+    return nullptr;
   }
-  if (extrapol == Extrapolation::Const && x > x_max_) {
-    return values_.back();
+  void* addr = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after closing the descriptor.
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return nullptr;
   }
-  const double index_double = (x - x_min_) * inv_dx_;
-  // here n is the lower index
-  const size_t n =
-      std::min(static_cast<size_t>(index_double), values_.size() - 2);
-  const double r = index_double - n;
-  return values_[n] + (values_[n + 1] - values_[n]) * r;
+  auto table = make_unique<Tabulation>(
+      header.x_min, header.x_max - header.x_min,
+      reinterpret_cast<const double*>(static_cast<const char*>(addr) +
+                                      sizeof(header)),
+      header.n);
+  table->map_addr_ = addr;
+  table->map_size_ = file_stat.st_size;
+  return table;
 }
 
 }  // namespace smash
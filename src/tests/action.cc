@@ -54,3 +54,29 @@ TEST(finite_momenta) {
   ScatterAction act(a, b, 0.);
   VERIFY(act.transverse_distance_sqr() >= 0.);
 }
+
+// exercise the memory pool behind Action::operator new/delete: allocate many
+// actions, release them in mixed order and allocate again to hit the reuse
+// path of the free lists
+TEST(memory_pool) {
+  const auto a =
+      Test::smashon(Position{1., 1., 1., 1.}, Momentum{0.1, 0.3, -0.1, 0.2});
+  const auto b =
+      Test::smashon(Position{2., 2., 2., 2.}, Momentum{0.1, 0., 0., 0.});
+  for (int round = 0; round < 3; ++round) {
+    ActionList actions;
+    for (int i = 0; i < 1000; ++i) {
+      actions.emplace_back(make_unique<ScatterAction>(a, b, 0.));
+    }
+    // free every second action, then fill the holes again
+    for (std::size_t i = 0; i < actions.size(); i += 2) {
+      actions[i].reset();
+    }
+    for (std::size_t i = 0; i < actions.size(); i += 2) {
+      actions[i] = make_unique<ScatterAction>(a, b, 0.);
+    }
+    for (const auto &action : actions) {
+      COMPARE(action->incoming_particles().size(), 2u);
+    }
+  }
+}
@@ -65,3 +65,84 @@ TEST(construct_and_insert) {
 
   VERIFY(actions.is_empty());
 }
+
+TEST(insert_bulk) {
+  // use different times for different actions
+  constexpr double time_1 = 1.;
+  constexpr double time_2 = 2.;
+  constexpr double time_3 = 3.;
+  constexpr double time_4 = 4.;
+
+  constexpr double current_time = 10.5;
+
+  // create arbitrary particle
+  ParticleData testparticle =
+      Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                    Test::Position{current_time, 1., .9, 1.});
+
+  Actions actions;
+  actions.insert(make_unique<DecayAction>(testparticle, time_2));
+
+  // bulk-insert a batch out of order, as the collision search produces it
+  ActionList batch;
+  batch.push_back(make_unique<DecayAction>(testparticle, time_4));
+  batch.push_back(make_unique<DecayAction>(testparticle, time_1));
+  batch.push_back(make_unique<DecayAction>(testparticle, time_3));
+  actions.insert_bulk(std::move(batch));
+  COMPARE(actions.size(), 4u);
+
+  // verify that the actions come out in time order
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_1);
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_2);
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_3);
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_4);
+
+  VERIFY(actions.is_empty());
+}
+
+TEST(calendar_queue) {
+  // use different times for different actions
+  constexpr double time_1 = 1.;
+  constexpr double time_2 = 2.;
+  constexpr double time_3 = 3.;
+  constexpr double time_4 = 4.;
+  constexpr double time_5 = 5.;
+  constexpr double time_6 = 6.;
+
+  constexpr double current_time = 10.5;
+
+  // create arbitrary particle
+  ParticleData testparticle =
+      Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                    Test::Position{current_time, 1., .9, 1.});
+
+  Actions actions;
+  actions.use_calendar_queue(current_time, current_time + 20.);
+  VERIFY(actions.is_empty());
+
+  // insert actions out of order
+  ActionList action_vec;
+  action_vec.push_back(make_unique<DecayAction>(testparticle, time_4));
+  action_vec.push_back(make_unique<DecayAction>(testparticle, time_1));
+  action_vec.push_back(make_unique<DecayAction>(testparticle, time_6));
+  actions.insert(std::move(action_vec));
+  COMPARE(actions.size(), 3u);
+
+  // pop the earliest action, then insert more (as the timestepless evolution
+  // does after performing an action)
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_1);
+  ActionList new_actions;
+  new_actions.push_back(make_unique<DecayAction>(testparticle, time_5));
+  new_actions.push_back(make_unique<DecayAction>(testparticle, time_2));
+  new_actions.push_back(make_unique<DecayAction>(testparticle, time_3));
+  actions.insert(std::move(new_actions));
+
+  // verify that the remaining actions come out in time order
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_2);
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_3);
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_4);
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_5);
+  COMPARE(actions.pop()->time_of_execution(), current_time + time_6);
+
+  VERIFY(actions.is_empty());
+}
@@ -191,3 +191,12 @@ TEST_CATCH(set_invalid_theta, Angles::InvalidTheta) { dir.set_costheta(2.); }
 TEST_CATCH(set_theta_too_far, Angles::InvalidTheta) {
   dir.add_to_theta(M_PI * 1.1);
 }
+
+TEST(isotropic_unit_vector_is_normalized) {
+  for (int i = 0; i < 1000; i++) {
+    const ThreeVector v = random::isotropic_unit_vector();
+    COMPARE_ABSOLUTE_ERROR(v.sqr(), 1., accuracy)
+        << " (draw number " << i << ")";
+    VERIFY(v.x3() >= -1. && v.x3() <= 1.) << " (draw number " << i << ")";
+  }
+}
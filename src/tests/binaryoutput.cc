@@ -13,6 +13,7 @@
 
 #include <smash/config.h>
 #include <array>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
@@ -244,6 +245,84 @@ TEST(fullhistory_format) {
   VERIFY(bf::remove(collisionsoutputfilepath));
 }
 
+TEST(interaction_filters) {
+  /* create two smashon particles */
+  Particles particles;
+  const ParticleData p1 = particles.insert(Test::smashon_random());
+  const ParticleData p2 = particles.insert(Test::smashon_random());
+
+  /* Create elastic interaction (smashon + smashon). */
+  const int event_id = 0;
+  const double impact_parameter = 2.34;
+  ScatterActionPtr action = make_unique<ScatterAction>(p1, p2, 0.);
+  action->add_all_scatterings(10., true, Test::all_reactions_included(), 0.,
+                              true, false, false,
+                              NNbarTreatment::NoAnnihilation);
+  action->generate_final_state();
+  ParticleList final_particles = action->outgoing_particles();
+  const double rho = 0.123;
+
+  const bf::path collisionsoutputfilepath =
+      testoutputpath / "collisions_binary.bin";
+  {
+    /* Keep only every second elastic scattering. */
+    OutputParameters output_par = OutputParameters();
+    output_par.coll_elastic_prescale = 2;
+    auto bin_output = make_unique<BinaryOutputCollisions>(
+        testoutputpath, "Collisions", output_par);
+    bin_output->at_interaction(*action, rho);
+    bin_output->at_interaction(*action, rho);
+    bin_output->at_eventend(particles, event_id, impact_parameter);
+  }
+  {
+    FilePtr binF = fopen(collisionsoutputfilepath.native(), "rb");
+    VERIFY(binF.get());
+    // Header
+    std::vector<char> buf(4);
+    std::string magic, smash_version;
+    int format_version_number;
+    COMPARE(std::fread(&buf[0], 1, 4, binF.get()), 4u);  // magic number
+    magic.assign(&buf[0], 4);
+    read_binary(format_version_number, binF);  // format version number
+    read_binary(smash_version, binF);          // smash version
+
+    // Only the first of the two elastic scatterings was written.
+    VERIFY(compare_interaction_block_header(2, 2, *action, rho, binF));
+    VERIFY(compare_particle(p1, binF));
+    VERIFY(compare_particle(p2, binF));
+    VERIFY(compare_particle(final_particles[0], binF));
+    VERIFY(compare_particle(final_particles[1], binF));
+    VERIFY(compare_final_block_header(event_id, impact_parameter, binF));
+  }
+  VERIFY(bf::remove(collisionsoutputfilepath));
+
+  {
+    /* A process-type filter that does not match drops the interaction. */
+    OutputParameters output_par = OutputParameters();
+    output_par.coll_process_filter.insert(
+        static_cast<int>(ProcessType::Decay));
+    auto bin_output = make_unique<BinaryOutputCollisions>(
+        testoutputpath, "Collisions", output_par);
+    bin_output->at_interaction(*action, rho);
+    bin_output->at_eventend(particles, event_id, impact_parameter);
+  }
+  {
+    FilePtr binF = fopen(collisionsoutputfilepath.native(), "rb");
+    VERIFY(binF.get());
+    // Header
+    std::vector<char> buf(4);
+    std::string magic, smash_version;
+    int format_version_number;
+    COMPARE(std::fread(&buf[0], 1, 4, binF.get()), 4u);  // magic number
+    magic.assign(&buf[0], 4);
+    read_binary(format_version_number, binF);  // format version number
+    read_binary(smash_version, binF);          // smash version
+
+    VERIFY(compare_final_block_header(event_id, impact_parameter, binF));
+  }
+  VERIFY(bf::remove(collisionsoutputfilepath));
+}
+
 TEST(particles_format) {
   /* create two smashon particles */
   const auto particles =
@@ -421,3 +500,146 @@ TEST(extended) {
 
   VERIFY(bf::remove(collisionsoutputfilepath));
 }
+
+/* Reads one varint from the provenance output. */
+static uint64_t read_varint(const FilePtr &file) {
+  uint64_t x = 0;
+  int shift = 0;
+  uint8_t byte;
+  do {
+    COMPARE(std::fread(&byte, 1, 1, file.get()), 1u);
+    x |= static_cast<uint64_t>(byte & 0x7fu) << shift;
+    shift += 7;
+  } while (byte & 0x80u);
+  return x;
+}
+
+/* Undoes the zigzag mapping of the provenance output. */
+static int64_t unzigzag(uint64_t x) {
+  return static_cast<int64_t>(x >> 1) ^ -static_cast<int64_t>(x & 1u);
+}
+
+TEST(provenance_format) {
+  /* create two smashon particles */
+  Particles particles;
+  const ParticleData p1 = particles.insert(Test::smashon_random());
+  const ParticleData p2 = particles.insert(Test::smashon_random());
+
+  /* Create elastic interaction (smashon + smashon). */
+  const int event_id = 0;
+  const double impact_parameter = 1.473;
+  const uint32_t id_process = 5;
+  ScatterActionPtr action = make_unique<ScatterAction>(p1, p2, 0.);
+  action->add_all_scatterings(10., true, Test::all_reactions_included(), 0.,
+                              true, false, false,
+                              NNbarTreatment::NoAnnihilation);
+  action->generate_final_state();
+  /* The provenance output reads the process id from the history, which is
+   * set when the action is performed. */
+  action->perform(&particles, id_process);
+  const ParticleList final_particles = action->outgoing_particles();
+  const double rho = 0.123;
+
+  const bf::path provenanceoutputfilepath = testoutputpath / "provenance.bin";
+  {
+    OutputParameters output_par = OutputParameters();
+    auto bin_output = make_unique<BinaryOutputProvenance>(
+        testoutputpath, "Collisions", output_par);
+    VERIFY(bin_output->requires_history());
+    bin_output->at_eventstart(particles, event_id);
+    bin_output->at_interaction(*action, rho);
+    bin_output->at_eventend(particles, event_id, impact_parameter);
+  }
+  VERIFY(bf::exists(provenanceoutputfilepath));
+
+  {
+    FilePtr binF = fopen(provenanceoutputfilepath.native(), "rb");
+    VERIFY(binF.get());
+    // Header
+    std::vector<char> buf(4);
+    std::string magic, smash_version;
+    int format_version_number;
+    COMPARE(std::fread(&buf[0], 1, 4, binF.get()), 4u);  // magic number
+    magic.assign(&buf[0], 4);
+    read_binary(format_version_number, binF);  // format version number
+    read_binary(smash_version, binF);          // smash version
+    COMPARE(magic, "SMSH");
+    COMPARE(smash_version, VERSION_MAJOR);
+
+    // one 'v' block with a single node: the performed elastic scattering
+    char c_read;
+    std::int32_t n_nodes;
+    COMPARE(std::fread(&c_read, sizeof(char), 1, binF.get()), 1u);
+    COMPARE(c_read, 'v');
+    read_binary(n_nodes, binF);
+    COMPARE(n_nodes, 1);
+    COMPARE(unzigzag(read_varint(binF)), static_cast<int64_t>(id_process));
+    COMPARE(read_varint(binF),
+            static_cast<uint64_t>(action->get_type()));
+    const int64_t quantized_time =
+        std::llround(action->time_of_execution() * 1e3);
+    COMPARE(unzigzag(read_varint(binF)), quantized_time);
+    COMPARE(read_varint(binF), 2u);  // nin
+    COMPARE(read_varint(binF), 2u);  // nout
+    // incoming edges: initial-state particles, i.e. origin id 0
+    COMPARE(read_varint(binF), static_cast<uint64_t>(p1.id()));
+    COMPARE(unzigzag(read_varint(binF)), static_cast<int64_t>(id_process));
+    COMPARE(read_varint(binF), static_cast<uint64_t>(p2.id()));
+    COMPARE(unzigzag(read_varint(binF)), static_cast<int64_t>(id_process));
+    // outgoing particle ids
+    COMPARE(read_varint(binF),
+            static_cast<uint64_t>(final_particles[0].id()));
+    COMPARE(read_varint(binF),
+            static_cast<uint64_t>(final_particles[1].id()));
+
+    // event end line
+    VERIFY(compare_final_block_header(event_id, impact_parameter, binF));
+  }
+  VERIFY(bf::remove(provenanceoutputfilepath));
+}
+
+#ifdef SMASH_USE_ZLIB
+TEST(compressed_particles_format) {
+  const auto particles =
+      Test::create_particles(2, [] { return Test::smashon_random(); });
+  const int event_id = 0;
+  const double impact_parameter = 1.473;
+
+  const bf::path outputpath = testoutputpath / "particles_binary.bin.gz";
+  {
+    OutputParameters output_par = OutputParameters();
+    output_par.part_extended = false;
+    output_par.part_only_final = false;
+    auto bin_output = make_unique<BinaryOutputParticles>(
+        testoutputpath, "Particles", output_par, true);
+    VERIFY(bool(bin_output));
+    bin_output->at_eventstart(*particles, event_id);
+    bin_output->at_eventend(*particles, event_id, impact_parameter);
+  }
+  VERIFY(bf::exists(outputpath));
+
+  // the file is a gzip container ...
+  {
+    FilePtr binF = fopen(outputpath.native(), "rb");
+    VERIFY(binF.get());
+    unsigned char magic[2] = {0, 0};
+    COMPARE(std::fread(magic, 1, 2, binF.get()), 2u);
+    COMPARE(int(magic[0]), 0x1f);
+    COMPARE(int(magic[1]), 0x8b);
+  }
+
+  // ... that unpacks to the usual header with the bumped format version
+  {
+    gzFile gzF = gzopen(outputpath.native().c_str(), "rb");
+    VERIFY(gzF != nullptr);
+    char magic[5] = {};
+    COMPARE(gzread(gzF, magic, 4), 4);
+    COMPARE(std::strcmp(magic, "SMSH"), 0);
+    uint16_t format_version = 0;
+    COMPARE(gzread(gzF, &format_version, sizeof(format_version)),
+            int(sizeof(format_version)));
+    COMPARE(format_version, uint16_t(7));
+    gzclose(gzF);
+  }
+}
+#endif  // SMASH_USE_ZLIB
@@ -0,0 +1,90 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "unittest.h"  // This include has to be first
+
+#include "setup.h"
+
+#include "../include/smash/callbackoutput.h"
+#include "../include/smash/clock.h"
+#include "../include/smash/particles.h"
+#include "../include/smash/scatteraction.h"
+
+using namespace smash;
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+TEST(no_callbacks_is_noop) {
+  /* An output without any registered callbacks must silently ignore all
+   * calls. */
+  CallbackOutput output("Callbacks");
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  Clock clock(0., 1.);
+  const DensityParameters dens_par(Test::default_parameters());
+  output.at_eventstart(particles, 0);
+  output.at_intermediate_time(particles, clock, dens_par);
+  output.at_eventend(particles, 0, 1.5);
+}
+
+TEST(callbacks_receive_data) {
+  Particles particles;
+  const ParticleData p1 = particles.insert(Test::smashon_random());
+  const ParticleData p2 = particles.insert(Test::smashon_random());
+  ScatterActionPtr action = make_unique<ScatterAction>(p1, p2, 0.);
+  action->add_all_scatterings(10., true, Test::all_reactions_included(), 0.,
+                              true, false, false,
+                              NNbarTreatment::NoAnnihilation);
+  action->generate_final_state();
+
+  int eventstart_calls = 0;
+  int eventend_calls = 0;
+  int interaction_calls = 0;
+  int intermediate_calls = 0;
+
+  CallbackOutput output("Callbacks");
+  output.set_eventstart_callback(
+      [&](const Particles &plist, const int event_number) {
+        COMPARE(plist.size(), 2u);
+        COMPARE(event_number, 7);
+        eventstart_calls++;
+      });
+  output.set_eventend_callback([&](const Particles &plist,
+                                   const int event_number,
+                                   const double impact_parameter) {
+    COMPARE(plist.size(), 2u);
+    COMPARE(event_number, 7);
+    COMPARE(impact_parameter, 1.783);
+    eventend_calls++;
+  });
+  output.set_interaction_callback([&](const Action &a, const double density) {
+    COMPARE(a.incoming_particles().size(), 2u);
+    COMPARE(density, 0.5);
+    interaction_calls++;
+  });
+  output.set_intermediate_callback(
+      [&](const Particles &plist, const Clock &clock) {
+        COMPARE(plist.size(), 2u);
+        COMPARE(clock.current_time(), 0.);
+        intermediate_calls++;
+      });
+
+  Clock clock(0., 1.);
+  const DensityParameters dens_par(Test::default_parameters());
+  output.at_eventstart(particles, 7);
+  output.at_interaction(*action, 0.5);
+  output.at_intermediate_time(particles, clock, dens_par);
+  action->perform(&particles, 1);
+  output.at_eventend(particles, 7, 1.783);
+
+  COMPARE(eventstart_calls, 1);
+  COMPARE(interaction_calls, 1);
+  COMPARE(intermediate_calls, 1);
+  COMPARE(eventend_calls, 1);
+}
@@ -0,0 +1,142 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "unittest.h"  // This include has to be first
+
+#include "setup.h"
+
+#include <boost/filesystem.hpp>
+
+#include "../include/smash/checkpoint.h"
+#include "../include/smash/clock.h"
+#include "../include/smash/random.h"
+
+using namespace smash;
+
+static const bf::path testfilepath =
+    bf::absolute(SMASH_TEST_OUTPUT_PATH) / "checkpoint.bin";
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+TEST(engine_state_roundtrip) {
+  random::engine.seed(17);
+  random::engine.discard(5);
+  const random::Engine::State saved = random::engine.state();
+  const uint64_t expected = random::engine();
+  random::engine();
+  random::engine.restore_state(saved);
+  COMPARE(random::engine(), expected);
+}
+
+TEST(clock_state_roundtrip) {
+  Clock clock(0.3, 0.1);
+  ++clock;
+  ++clock;
+  const Clock::State saved = clock.state();
+  Clock restored;
+  restored.restore_state(saved);
+  COMPARE(restored.current_time(), clock.current_time());
+  COMPARE(restored.next_time(), clock.next_time());
+  COMPARE(restored.timestep_duration(), clock.timestep_duration());
+}
+
+TEST(file_roundtrip) {
+  CheckpointState state;
+  state.event_number = 3;
+  Clock labclock(0.0, 0.1);
+  ++labclock;
+  ++labclock;
+  state.labclock = labclock.state();
+  state.outputclock = Clock(0.0, 1.0).state();
+  random::engine.seed(42);
+  random::engine.discard(7);
+  state.engine = random::engine.state();
+  state.interactions_total = 1234567890123ull;
+  state.previous_interactions_total = 1234567890000ull;
+  state.wall_actions_total = 98765ull;
+  state.previous_wall_actions_total = 98000ull;
+  state.total_pauli_blocked = 11ull;
+  state.intermediate_output_count = 7ull;
+  state.density_triggers_fired = 2ull;
+  state.conserved_initial =
+      QuantumNumbers(FourVector(10., 1., 2., 3.), 1, 2, 3, 4, 5, 6);
+  ParticleData particle = Test::smashon(
+      Test::Position{1.2, 2.3, 3.4, 4.5}, Test::Momentum{1.1, 0.1, 0.2, 0.3},
+      5);
+  particle.set_slow_formation_times(0.5, 1.5);
+  particle.set_cross_section_scaling_factor(0.25);
+  HistoryData history;
+  history.collisions_per_particle = 4;
+  history.id_process = 17u;
+  history.process_type = ProcessType::Elastic;
+  history.time_last_collision = 0.75;
+  particle.set_history(history);
+  state.particles.push_back(particle);
+  state.beam_momentum.emplace_back(4., 0., 0., 3.9);
+  state.nucleon_has_interacted = {true, false, true};
+
+  write_checkpoint(testfilepath, state);
+  VERIFY(bf::exists(testfilepath));
+  const CheckpointState restored = read_checkpoint(testfilepath);
+
+  COMPARE(restored.event_number, 3);
+  COMPARE(restored.labclock.counter, state.labclock.counter);
+  COMPARE(restored.labclock.reset_time, state.labclock.reset_time);
+  COMPARE(restored.labclock.timestep_duration,
+          state.labclock.timestep_duration);
+  COMPARE(restored.outputclock.timestep_duration,
+          state.outputclock.timestep_duration);
+  /* The restored engine has to continue with exactly the same values as the
+   * saved one. */
+  random::Engine continued;
+  continued.restore_state(restored.engine);
+  random::Engine original;
+  original.restore_state(state.engine);
+  COMPARE(continued(), original());
+  COMPARE(continued(), original());
+  COMPARE(restored.interactions_total, state.interactions_total);
+  COMPARE(restored.previous_interactions_total,
+          state.previous_interactions_total);
+  COMPARE(restored.wall_actions_total, state.wall_actions_total);
+  COMPARE(restored.previous_wall_actions_total,
+          state.previous_wall_actions_total);
+  COMPARE(restored.total_pauli_blocked, state.total_pauli_blocked);
+  COMPARE(restored.intermediate_output_count,
+          state.intermediate_output_count);
+  COMPARE(restored.density_triggers_fired, state.density_triggers_fired);
+  COMPARE(restored.conserved_initial.momentum(),
+          state.conserved_initial.momentum());
+  COMPARE(restored.conserved_initial.charge(),
+          state.conserved_initial.charge());
+  COMPARE(restored.conserved_initial.baryon_number(),
+          state.conserved_initial.baryon_number());
+
+  COMPARE(restored.particles.size(), 1u);
+  const ParticleData &p = restored.particles.front();
+  COMPARE(p.id(), 5);
+  COMPARE(p.pdgcode(), particle.pdgcode());
+  COMPARE(p.momentum(), particle.momentum());
+  COMPARE(p.position(), particle.position());
+  COMPARE(p.begin_formation_time(), 0.5);
+  COMPARE(p.formation_time(), 1.5);
+  COMPARE(p.initial_xsec_scaling_factor(), 0.25);
+  COMPARE(p.get_history().collisions_per_particle, 4);
+  COMPARE(p.get_history().id_process, 17u);
+  VERIFY(p.get_history().process_type == ProcessType::Elastic);
+  COMPARE(p.get_history().time_last_collision, 0.75);
+
+  COMPARE(restored.beam_momentum.size(), 1u);
+  COMPARE(restored.beam_momentum.front(), state.beam_momentum.front());
+  COMPARE(restored.nucleon_has_interacted.size(), 3u);
+  VERIFY(restored.nucleon_has_interacted[0]);
+  VERIFY(!restored.nucleon_has_interacted[1]);
+  VERIFY(restored.nucleon_has_interacted[2]);
+
+  bf::remove(testfilepath);
+}
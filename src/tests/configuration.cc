@@ -229,6 +229,25 @@ TEST(test_sub_config_objects) {
   COMPARE(double(box.read({"Meccas"})), 10.);
 }
 
+TEST_CATCH(take_after_freeze, std::logic_error) {
+  Configuration conf = make_test_configuration();
+  conf.freeze();
+  conf.take({"fireballs", "classify"});
+}
+
+TEST(freeze_propagates_to_subobjects) {
+  Configuration conf = make_test_configuration();
+  Configuration general = conf["fireballs"];
+  VERIFY(!general.is_frozen());
+  conf.freeze();
+  VERIFY(general.is_frozen());
+  try {
+    general.read({"classify"});
+    VERIFY(false) << "read on a frozen configuration did not throw";
+  } catch (std::logic_error &) {
+  }
+}
+
 TEST(check_setting_new_value) {
   Configuration conf = make_test_configuration();
   VERIFY(!conf.has_value({"Test"}));
@@ -21,6 +21,7 @@
 #include "../include/smash/configuration.h"
 #include "../include/smash/cxx14compat.h"
 #include "../include/smash/density.h"
+#include "../include/smash/energymomentumtensor.h"
 #include "../include/smash/experiment.h"
 #include "../include/smash/modusdefault.h"
 #include "../include/smash/nucleus.h"
@@ -182,6 +183,302 @@ TEST(smearing_factor_rcut_correction) {
   FUZZY_COMPARE(smearing_factor_rcut_correction(4.0), 0.99886601571021467);
 }
 
+TEST(parallel_lattice_update_matches_serial) {
+  // Periodic lattice, so the parallel path also has to get the
+  // wrap-around of the smearing spheres right.
+  const std::array<double, 3> l = {10., 10., 10.};
+  const std::array<int, 3> n = {20, 20, 20};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  bool periodicity = true;
+  auto lat_serial = make_unique<DensityLattice>(l, n, origin, periodicity,
+                                                LatticeUpdate::EveryTimestep);
+  auto lat_parallel = make_unique<DensityLattice>(l, n, origin, periodicity,
+                                                  LatticeUpdate::EveryTimestep);
+  auto conf = Test::configuration();
+  conf["Modus"] = "Box";
+  conf["Modi"]["Box"]["Init_Multiplicities"]["2212"] = 20;
+  conf["Modi"]["Box"]["Length"] = 10.;
+  conf["Modi"]["Box"]["Initial_Condition"] = "thermal momenta";
+  conf["Modi"]["Box"]["Temperature"] = 0.2;
+  conf["Modi"]["Box"]["Start_Time"] = 0.0;
+  const ExperimentParameters par = smash::Test::default_parameters();
+  const DensityParameters dens_par = DensityParameters(par);
+  std::unique_ptr<BoxModus> b = make_unique<BoxModus>(conf["Modi"], par);
+  Particles P;
+  b->initial_conditions(&P, par);
+  // Without the shared pool the update runs serially ...
+  VERIFY(shared_pool() == nullptr);
+  update_lattice(lat_serial.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P, true);
+  // ... with it the z-slabs are filled in parallel.
+  initialize_shared_pool(3);
+  VERIFY(shared_pool() != nullptr);
+  update_lattice(lat_parallel.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P, true);
+  for (size_t i = 0; i < lat_serial->size(); i++) {
+    FUZZY_COMPARE((*lat_parallel)[i].density(), (*lat_serial)[i].density())
+        << "node " << i;
+  }
+}
+
+/* Filling a density and an energy-momentum tensor lattice in one fused
+   pass has to give the same nodes as two separate passes. */
+TEST(fused_lattice_update_matches_separate) {
+  const std::array<double, 3> l = {10., 10., 10.};
+  const std::array<int, 3> n = {20, 20, 20};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  bool periodicity = true;
+  auto jmu_fused = make_unique<DensityLattice>(l, n, origin, periodicity,
+                                               LatticeUpdate::EveryTimestep);
+  auto jmu_separate = make_unique<DensityLattice>(
+      l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+  auto tmn_fused = make_unique<RectangularLattice<EnergyMomentumTensor>>(
+      l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+  auto tmn_separate = make_unique<RectangularLattice<EnergyMomentumTensor>>(
+      l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+  auto conf = Test::configuration();
+  conf["Modus"] = "Box";
+  conf["Modi"]["Box"]["Init_Multiplicities"]["2212"] = 20;
+  conf["Modi"]["Box"]["Length"] = 10.;
+  conf["Modi"]["Box"]["Initial_Condition"] = "thermal momenta";
+  conf["Modi"]["Box"]["Temperature"] = 0.2;
+  conf["Modi"]["Box"]["Start_Time"] = 0.0;
+  const ExperimentParameters par = smash::Test::default_parameters();
+  const DensityParameters dens_par = DensityParameters(par);
+  std::unique_ptr<BoxModus> b = make_unique<BoxModus>(conf["Modi"], par);
+  Particles P;
+  b->initial_conditions(&P, par);
+  update_lattice(jmu_separate.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P);
+  update_lattice(tmn_separate.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P);
+  update_lattice(jmu_fused.get(), tmn_fused.get(),
+                 LatticeUpdate::EveryTimestep, DensityType::Baryon, dens_par,
+                 P);
+  for (size_t i = 0; i < jmu_fused->size(); i++) {
+    FUZZY_COMPARE((*jmu_fused)[i].density(), (*jmu_separate)[i].density())
+        << "node " << i;
+    for (size_t k = 0; k < 10; k++) {
+      FUZZY_COMPARE((*tmn_fused)[i][k], (*tmn_separate)[i][k])
+          << "node " << i << " component " << k;
+    }
+  }
+}
+
+TEST(incremental_lattice_update_matches_full) {
+  const std::array<double, 3> l = {10., 10., 10.};
+  const std::array<int, 3> n = {20, 20, 20};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  bool periodicity = true;
+  auto lat_full = make_unique<DensityLattice>(l, n, origin, periodicity,
+                                              LatticeUpdate::EveryTimestep);
+  auto lat_incr = make_unique<DensityLattice>(l, n, origin, periodicity,
+                                              LatticeUpdate::EveryTimestep);
+  auto conf = Test::configuration();
+  conf["Modus"] = "Box";
+  conf["Modi"]["Box"]["Init_Multiplicities"]["2212"] = 20;
+  conf["Modi"]["Box"]["Length"] = 10.;
+  conf["Modi"]["Box"]["Initial_Condition"] = "thermal momenta";
+  conf["Modi"]["Box"]["Temperature"] = 0.2;
+  conf["Modi"]["Box"]["Start_Time"] = 0.0;
+  const ExperimentParameters par = smash::Test::default_parameters();
+  const DensityParameters dens_par = DensityParameters(par);
+  std::unique_ptr<BoxModus> b = make_unique<BoxModus>(conf["Modi"], par);
+  Particles P;
+  b->initial_conditions(&P, par);
+  const double tolerance = 0.1;
+  IncrementalDensityUpdater updater(tolerance);
+  // The first call recomputes from scratch and has to agree exactly.
+  updater.update(lat_incr.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P, true);
+  update_lattice(lat_full.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P, true);
+  VERIFY(updater.all_nodes_dirty());
+  for (size_t i = 0; i < lat_full->size(); i++) {
+    FUZZY_COMPARE((*lat_incr)[i].density(), (*lat_full)[i].density())
+        << "node " << i;
+  }
+  // Moves below the tolerance must leave the lattice untouched.
+  for (ParticleData &data : P) {
+    data.set_4position(data.position() +
+                       FourVector(0., 0.2 * tolerance, 0., 0.));
+  }
+  updater.update(lat_incr.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P, true);
+  // ... and has to mark no node as dirty.
+  VERIFY(!updater.all_nodes_dirty());
+  for (const char flag : updater.dirty_nodes()) {
+    COMPARE(static_cast<int>(flag), 0);
+  }
+  for (size_t i = 0; i < lat_full->size(); i++) {
+    FUZZY_COMPARE((*lat_incr)[i].density(), (*lat_full)[i].density())
+        << "node " << i;
+  }
+  /* Move every particle beyond the tolerance and remove one; the
+   * incremental update then has to match a full recomputation up to the
+   * round-off of the subtract/re-deposit cycle. */
+  for (ParticleData &data : P) {
+    data.set_4position(data.position() + FourVector(0., 0.3, -0.2, 0.1));
+  }
+  P.remove(P.front());
+  std::vector<double> density_before(lat_incr->size());
+  for (size_t i = 0; i < lat_incr->size(); i++) {
+    density_before[i] = (*lat_incr)[i].density();
+  }
+  updater.update(lat_incr.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P, true);
+  // Every node whose density changed has to carry the dirty flag.
+  VERIFY(!updater.all_nodes_dirty());
+  for (size_t i = 0; i < lat_incr->size(); i++) {
+    if (!updater.dirty_nodes()[i]) {
+      FUZZY_COMPARE((*lat_incr)[i].density(), density_before[i]) << "node "
+                                                                 << i;
+    }
+  }
+  update_lattice(lat_full.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, P, true);
+  for (size_t i = 0; i < lat_full->size(); i++) {
+    COMPARE_ABSOLUTE_ERROR((*lat_incr)[i].density(), (*lat_full)[i].density(),
+                           1.e-12)
+        << "node " << i;
+    const ThreeVector grad_incr = (*lat_incr)[i].grad_rho();
+    const ThreeVector grad_full = (*lat_full)[i].grad_rho();
+    for (int k = 0; k < 3; k++) {
+      COMPARE_ABSOLUTE_ERROR(grad_incr[k], grad_full[k], 1.e-12)
+          << "node " << i << " component " << k;
+    }
+  }
+}
+
+TEST(finite_difference_gradients) {
+  // Fill a lattice with a current linear in the position; the central
+  // differences then recover the slopes exactly at the interior nodes.
+  const std::array<double, 3> l = {4., 4., 4.};
+  const std::array<int, 3> n = {8, 8, 8};
+  const std::array<double, 3> origin = {-2., -2., -2.};
+  auto lat = make_unique<DensityLattice>(l, n, origin, false,
+                                         LatticeUpdate::EveryTimestep);
+  const ThreeVector slope(0.2, -0.1, 0.3);
+  auto fill = [&](double t) {
+    lat->reset();
+    const auto dims = lat->dimensions();
+    for (int iz = 0; iz < dims[2]; iz++) {
+      for (int iy = 0; iy < dims[1]; iy++) {
+        for (int ix = 0; ix < dims[0]; ix++) {
+          const ThreeVector c = lat->cell_center(ix, iy, iz);
+          const double rho = 5.0 + slope * c + 0.5 * t;
+          lat->node(ix, iy, iz)
+              .add_flow(FourVector(rho, 0.4 * rho, 0., 0.), 1.0, 1.0);
+        }
+      }
+    }
+  };
+  std::vector<FourVector> jmu_old;
+  fill(0.);
+  compute_gradients_finite_difference(lat.get(), jmu_old, 0.);
+  auto node = lat->node(3, 4, 5);
+  ThreeVector grad = node.grad_rho();
+  COMPARE_ABSOLUTE_ERROR(grad.x1(), slope.x1(), 1.e-12);
+  COMPARE_ABSOLUTE_ERROR(grad.x2(), slope.x2(), 1.e-12);
+  COMPARE_ABSOLUTE_ERROR(grad.x3(), slope.x3(), 1.e-12);
+  // Without a previous field the time derivative vanishes ...
+  COMPARE(node.dj_dt().x1(), 0.);
+  // ... and the curl of a current parallel to grad rho follows from it.
+  COMPARE_ABSOLUTE_ERROR(node.rot_j().x2(), 0.4 * slope.x3(), 1.e-12);
+  COMPARE_ABSOLUTE_ERROR(node.rot_j().x3(), -0.4 * slope.x2(), 1.e-12);
+  // A second update yields the backward time difference of the current.
+  fill(1.);
+  compute_gradients_finite_difference(lat.get(), jmu_old, 1.);
+  node = lat->node(3, 4, 5);
+  COMPARE_ABSOLUTE_ERROR(node.dj_dt().x1(), 0.4 * 0.5, 1.e-12);
+  grad = node.grad_rho();
+  COMPARE_ABSOLUTE_ERROR(grad.x1(), slope.x1(), 1.e-12);
+}
+
+TEST(rigid_snapshot_fill) {
+  /* A snapshot with a current linear in z is translated rigidly; at the
+   * interior nodes the trilinear interpolation reproduces the linear
+   * field at the shifted position exactly. */
+  const std::array<double, 3> l = {4., 4., 8.};
+  const std::array<int, 3> n = {4, 4, 16};
+  const std::array<double, 3> origin = {-2., -2., -4.};
+  auto snap_proj = make_unique<DensityLattice>(l, n, origin, false,
+                                               LatticeUpdate::EveryTimestep);
+  auto snap_targ = make_unique<DensityLattice>(l, n, origin, false,
+                                               LatticeUpdate::EveryTimestep);
+  auto lat = make_unique<DensityLattice>(l, n, origin, false,
+                                         LatticeUpdate::EveryTimestep);
+  const auto dims = lat->dimensions();
+  const FourVector deriv_z(0.3, 0.12, 0., 0.);
+  for (int iz = 0; iz < dims[2]; iz++) {
+    for (int iy = 0; iy < dims[1]; iy++) {
+      for (int ix = 0; ix < dims[0]; ix++) {
+        const double z = lat->cell_center(ix, iy, iz).x3();
+        // positive projectile contribution, linear in z
+        snap_proj->node(ix, iy, iz)
+            .add_flow(FourVector(2.0 + 0.3 * z, 0.12 * z, 0., 0.), 1.0, 1.0);
+        snap_proj->node(ix, iy, iz)
+            .overwrite_djmu_dx(FourVector(), FourVector(), FourVector(),
+                               deriv_z);
+        // negative target contribution, also linear in z
+        snap_targ->node(ix, iy, iz)
+            .add_flow(FourVector(1.0 + 0.1 * z, 0., 0., 0.), 1.0, -1.0);
+      }
+    }
+  }
+  const double shift_proj = 0.7;
+  const double shift_targ = -0.3;
+  fill_lattice_from_rigid_snapshots(lat.get(), *snap_proj, shift_proj,
+                                    *snap_targ, shift_targ);
+  auto node = lat->node(2, 1, 8);
+  const double z = lat->cell_center(2, 1, 8).x3();
+  // net density is the positive bucket minus the negative one, each
+  // evaluated at its own shifted position
+  const double rho_proj = 2.0 + 0.3 * (z - shift_proj);
+  const double rho_targ = 1.0 + 0.1 * (z - shift_targ);
+  COMPARE_ABSOLUTE_ERROR(node.jmu_pos().x0(), rho_proj, 1.e-12);
+  COMPARE_ABSOLUTE_ERROR(node.jmu_neg().x0(), -rho_targ, 1.e-12);
+  COMPARE_ABSOLUTE_ERROR(node.density(), rho_proj - rho_targ, 1.e-12);
+  COMPARE_ABSOLUTE_ERROR(node.jmu_net().x1(), 0.12 * (z - shift_proj),
+                         1.e-12);
+  // the constant derivatives of the snapshot are carried along
+  COMPARE_ABSOLUTE_ERROR(node.grad_rho().x3(), deriv_z.x0(), 1.e-12);
+  // a node whose shifted position left the snapshot stays empty
+  auto empty_lat = make_unique<DensityLattice>(l, n, origin, false,
+                                               LatticeUpdate::EveryTimestep);
+  fill_lattice_from_rigid_snapshots(empty_lat.get(), *snap_proj, 100.,
+                                    *snap_targ, 100.);
+  COMPARE(empty_lat->node(2, 1, 8).jmu_net().x0(), 0.);
+}
+
+/* The batched multi-point evaluation has to reproduce the pointwise one
+   bit by bit, also with the shared pool initialized above. */
+TEST(batched_eckart_matches_pointwise) {
+  ParticleList P;
+  for (int i = 0; i < 12; i++) {
+    ParticleData part = (i % 3 == 0) ? create_antiproton() : create_proton();
+    part.set_4position(
+        FourVector(0., -2.0 + 0.4 * i, 0.3 * i - 1.5, 0.1 * i));
+    part.set_4momentum(FourVector(1.0, 0.2 * (i % 4), -0.1 * (i % 5), 0.1));
+    P.push_back(part);
+  }
+  const ExperimentParameters exp_par = smash::Test::default_parameters();
+  const DensityParameters par(exp_par);
+  std::vector<ThreeVector> points;
+  for (int i = 0; i <= 30; i++) {
+    points.push_back(ThreeVector(-3.0 + 0.2 * i, 0.1 * i - 1.0, 0.05 * i));
+  }
+  const std::vector<double> rho =
+      rho_eckart_batch(points, P, par, DensityType::Baryon);
+  COMPARE(rho.size(), points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    FUZZY_COMPARE(
+        rho[i],
+        std::get<0>(rho_eckart(points[i], P, par, DensityType::Baryon, false)))
+        << "point " << i;
+  }
+}
+
 /*
 // check that analytical and numerical results for gradient of density coincide
 TEST(density_gradient) {
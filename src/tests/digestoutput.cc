@@ -0,0 +1,144 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "unittest.h"  // This include has to be first
+
+#include "setup.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <string>
+#include <vector>
+
+#include "../include/smash/digestoutput.h"
+#include "../include/smash/outputinterface.h"
+#include "../include/smash/particles.h"
+#include "../include/smash/scatteraction.h"
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  bf::create_directories(testoutputpath);
+  VERIFY(bf::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+/// One parsed line of the digest file.
+struct DigestLine {
+  int event;
+  std::size_t n_particles;
+  std::string particles_digest;
+  std::uint64_t n_actions;
+  std::string actions_digest;
+};
+
+/// Read the digest file, skipping the two header lines.
+static std::vector<DigestLine> read_digest_file(const bf::path &path) {
+  bf::fstream file;
+  file.open(path, std::ios_base::in);
+  VERIFY(file.good());
+  std::string header;
+  std::getline(file, header);
+  COMPARE(header.substr(0, 1), "#");
+  std::getline(file, header);
+  COMPARE(header, "# event n_particles particles_digest n_actions"
+                  " actions_digest");
+  std::vector<DigestLine> lines;
+  DigestLine line;
+  while (file >> line.event >> line.n_particles >> line.particles_digest >>
+         line.n_actions >> line.actions_digest) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+TEST(particle_digest_is_order_independent) {
+  /* The same five particles inserted in two different orders (and therefore
+   * with different ids) have to produce the same digest; a changed particle
+   * has to produce a different one. */
+  std::vector<ParticleData> source;
+  for (int i = 0; i < 5; i++) {
+    source.push_back(Test::smashon_random());
+  }
+  Particles forward;
+  for (const ParticleData &p : source) {
+    forward.insert(p);
+  }
+  Particles backward;
+  for (auto it = source.rbegin(); it != source.rend(); ++it) {
+    backward.insert(*it);
+  }
+  Particles changed;
+  changed.insert(Test::smashon_random());
+  for (std::size_t i = 1; i < source.size(); i++) {
+    changed.insert(source[i]);
+  }
+
+  const bf::path outputfilepath = testoutputpath / "digest.dat";
+  bf::path outputfilepath_unfinished = outputfilepath;
+  outputfilepath_unfinished += ".unfinished";
+  {
+    const OutputParameters out_par = OutputParameters();
+    DigestOutput digest(testoutputpath, "Digest", out_par);
+    VERIFY(bf::exists(outputfilepath_unfinished));
+    digest.at_eventstart(forward, 0);
+    digest.at_eventend(forward, 0, 0.);
+    digest.at_eventstart(backward, 1);
+    digest.at_eventend(backward, 1, 0.);
+    digest.at_eventstart(changed, 2);
+    digest.at_eventend(changed, 2, 0.);
+  }
+  VERIFY(!bf::exists(outputfilepath_unfinished));
+  VERIFY(bf::exists(outputfilepath));
+
+  const std::vector<DigestLine> lines = read_digest_file(outputfilepath);
+  COMPARE(lines.size(), 3u);
+  COMPARE(lines[0].event, 0);
+  COMPARE(lines[0].n_particles, 5u);
+  COMPARE(lines[1].n_particles, 5u);
+  COMPARE(lines[0].particles_digest, lines[1].particles_digest);
+  VERIFY(lines[0].particles_digest != lines[2].particles_digest);
+  // interactions are not hashed by default
+  COMPARE(lines[0].n_actions, 0u);
+  COMPARE(lines[0].actions_digest, std::string(16, '0'));
+  VERIFY(bf::remove(outputfilepath));
+}
+
+TEST(action_digest_is_order_independent) {
+  /* The same interaction reported with swapped incoming particles has to
+   * produce the same digest. */
+  Particles particles;
+  const ParticleData p1 = particles.insert(Test::smashon_random());
+  const ParticleData p2 = particles.insert(Test::smashon_random());
+  ScatterAction action_12(p1, p2, 0.);
+  ScatterAction action_21(p2, p1, 0.);
+
+  const bf::path outputfilepath = testoutputpath / "digest.dat";
+  {
+    OutputParameters out_par = OutputParameters();
+    out_par.digest_collisions = true;
+    DigestOutput digest(testoutputpath, "Digest", out_par);
+    digest.at_eventstart(particles, 0);
+    digest.at_interaction(action_12, 0.);
+    digest.at_eventend(particles, 0, 0.);
+    digest.at_eventstart(particles, 1);
+    digest.at_interaction(action_21, 0.);
+    digest.at_eventend(particles, 1, 0.);
+  }
+  const std::vector<DigestLine> lines = read_digest_file(outputfilepath);
+  COMPARE(lines.size(), 2u);
+  COMPARE(lines[0].n_actions, 1u);
+  COMPARE(lines[1].n_actions, 1u);
+  VERIFY(lines[0].actions_digest != std::string(16, '0'));
+  COMPARE(lines[0].actions_digest, lines[1].actions_digest);
+  VERIFY(bf::remove(outputfilepath));
+}
@@ -0,0 +1,69 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "unittest.h"  // This include has to be first
+
+#include <vector>
+
+#include "../include/smash/eventarena.h"
+
+using namespace smash;
+
+TEST(lifo_rewind_reuses_memory) {
+  void *first = EventArena::allocate(64);
+  EventArena::deallocate(first, 64);
+  // the most recent allocation was returned, so the next one reuses it
+  void *second = EventArena::allocate(64);
+  COMPARE(second, first);
+  EventArena::deallocate(second, 64);
+}
+
+TEST(out_of_order_free_is_leaked_until_reset) {
+  void *first = EventArena::allocate(64);
+  void *second = EventArena::allocate(64);
+  EventArena::deallocate(first, 64);  // not the most recent: no rewind
+  void *third = EventArena::allocate(64);
+  VERIFY(third != first);
+  EventArena::deallocate(third, 64);
+  EventArena::deallocate(second, 64);
+}
+
+TEST(reset_rewinds_to_the_first_chunk) {
+  EventArena::reset();
+  void *first = EventArena::allocate(128);
+  EventArena::allocate(32);
+  EventArena::reset();
+  // after the reset the retained memory is handed out from the start again
+  COMPARE(EventArena::allocate(16), first);
+  EventArena::reset();
+}
+
+TEST(allocator_in_vector) {
+  EventArena::reset();
+  std::vector<int, EventArenaAllocator<int>> v;
+  for (int i = 0; i < 1000; i++) {
+    v.push_back(i);
+  }
+  for (int i = 0; i < 1000; i++) {
+    COMPARE(v[i], i);
+  }
+  VERIFY(EventArenaAllocator<int>() == EventArenaAllocator<double>());
+}
+
+TEST(oversized_allocation) {
+  // larger than one chunk: gets a dedicated chunk, still arena-managed
+  constexpr std::size_t big = 4 * 1024 * 1024;
+  char *memory = static_cast<char *>(EventArena::allocate(big));
+  memory[0] = 1;
+  memory[big - 1] = 2;
+  COMPARE(memory[0], 1);
+  COMPARE(memory[big - 1], 2);
+  EventArena::deallocate(memory, big);
+  EventArena::reset();
+}
@@ -58,7 +58,7 @@ TEST(rest_frame_transformation) {
   BoxModus b = create_box_for_tests();
   b.initial_conditions(&P, par);
 
-  HadronGasEos eos = HadronGasEos(false);
+  HadronGasEos eos(false);
   ThermLatticeNode node = ThermLatticeNode();
   const ThreeVector v_boost(0.1, 0.2, 0.8);
   const double L = b.length();
@@ -112,3 +112,37 @@ TEST(thermalization_action) {
   ThermalizationAction th_act(*thermalizer, 0.0);
   // If all this did not crash - the test is passed.
 }
+
+TEST(region_pre_screening) {
+  Particles P;
+  BoxModus b = create_box_for_tests();
+  const ExperimentParameters par = smash::Test::default_parameters();
+  b.initial_conditions(&P, par);
+  const DensityParameters dens_par = DensityParameters(par);
+
+  Configuration th_conf = Test::configuration();
+  std::vector<int> cell_n = {1, 1, 1};
+  th_conf["Cell_Number"] = cell_n;
+  th_conf["Critical_Edens"] = 0.01;
+  th_conf["Algorithm"] = "biased BF";
+  th_conf["Start_Time"] = 0.0;
+  th_conf["Timestep"] = 1.0;
+  auto thermalizer = b.create_grandcan_thermalizer(th_conf);
+  // The box is dense enough to thermalize, so candidates have to exist ...
+  VERIFY(thermalizer->regions_to_thermalize_exist(P, dens_par));
+  /* ... and the conservative candidate list has to cover the cells that
+   * the subsequent thermalization actually finds above the threshold. */
+  thermalizer->update_thermalizer_lattice(P, dens_par, true);
+  thermalizer->thermalize(P, 0.0, par.testparticles);
+  VERIFY(thermalizer->particles_to_remove().size() > 30);
+
+  // An unreachable threshold has to be screened out.
+  Configuration th_conf_high = Test::configuration();
+  th_conf_high["Cell_Number"] = cell_n;
+  th_conf_high["Critical_Edens"] = 1.e6;
+  th_conf_high["Algorithm"] = "biased BF";
+  th_conf_high["Start_Time"] = 0.0;
+  th_conf_high["Timestep"] = 1.0;
+  auto thermalizer_high = b.create_grandcan_thermalizer(th_conf_high);
+  VERIFY(!thermalizer_high->regions_to_thermalize_exist(P, dens_par));
+}
@@ -149,7 +149,7 @@ TEST(grid_construction) {
       auto idsIt = param.ids.begin();
       auto neighbors = param.neighbors;
       grid.iterate_cells(
-          [&](const ParticleList &search) {
+          [&](const ParticleSlice &search) {
             auto ids = *idsIt++;
             for (const auto &p : search) {
               COMPARE(ids.erase(p.id()), 1u)
@@ -157,7 +157,7 @@ TEST(grid_construction) {
             }
             COMPARE(ids.size(), 0u);
           },
-          [&](const ParticleList &search, const ParticleList &n) {
+          [&](const ParticleSlice &search, const ParticleSlice &n) {
             for (const auto &p : search) {
               for (const auto &p2 : n) {
                 COMPARE(neighbors.erase({std::min(p.id(), p2.id()),
@@ -214,7 +214,7 @@ TEST(periodic_grid) {
       std::vector<std::pair<ParticleData, ParticleData>> neighbor_pairs;
 
       grid.iterate_cells(
-          [&](const ParticleList &search) {
+          [&](const ParticleSlice &search) {
             for (const ParticleData &p : search) {
               {
                 const auto it = find(list, p);
@@ -241,7 +241,7 @@ TEST(periodic_grid) {
               }
             }
           },
-          [&](const ParticleList &search, const ParticleList &neighbors) {
+          [&](const ParticleSlice &search, const ParticleSlice &neighbors) {
             // for each particle in neighbors, find the same particle in list
             for (const ParticleData &p : neighbors) {
               const auto it = find(list, p);
@@ -458,3 +458,91 @@ TEST(max_positions_normal_grid) {
   // still generates an out-of-bounds cell index.
   Grid<GridOptions::Normal> grid2(list, testparticles);
 }
+
+TEST(frozen_particles_are_skipped) {
+  constexpr int testparticles = 1;
+  const double min_cell_length = minimal_cell_length(testparticles);
+  using Test::Position;
+  // Spread the particles over several cells along x, so the regular gridded
+  // code path is taken, and freeze every second one.
+  Particles list;
+  for (int i = 0; i < 8; ++i) {
+    list.insert(Test::smashon(Position{0., i * min_cell_length, 0., 0.}));
+  }
+  int n = 0;
+  for (ParticleData &p : list) {
+    if (n++ % 2 == 0) {
+      p.set_frozen(true);
+    }
+  }
+  std::size_t visited = 0;
+  Grid<GridOptions::Normal> grid(list, min_cell_length);
+  grid.iterate_cells(
+      [&](const ParticleSlice &cell) {
+        for (const ParticleData &p : cell) {
+          VERIFY(!p.frozen());
+          ++visited;
+        }
+      },
+      [](const ParticleSlice &, const ParticleSlice &) {});
+  COMPARE(visited, 4u);
+
+  // The dilute limit falls back to a single cell and has to filter the
+  // frozen particles as well.
+  Particles dilute;
+  for (int i = 0; i < 4; ++i) {
+    dilute.insert(Test::smashon(Position{0., 0.1 * i, 0., 0.}));
+  }
+  for (ParticleData &p : dilute) {
+    p.set_frozen(true);
+  }
+  std::size_t count = 0;
+  Grid<GridOptions::Normal> grid2(dilute, min_cell_length);
+  grid2.iterate_cells(
+      [&](const ParticleSlice &cell) { count += cell.size(); },
+      [](const ParticleSlice &, const ParticleSlice &) {});
+  COMPARE(count, 0u);
+}
+
+TEST(refresh_updates_cell_copies) {
+  constexpr int testparticles = 1;
+  const double min_cell_length = minimal_cell_length(testparticles);
+  using Test::Position;
+  // Spread the particles over several cells along x, so the regular gridded
+  // code path is taken.
+  Particles list;
+  for (int i = 0; i < 8; ++i) {
+    list.insert(Test::smashon(Position{0., i * min_cell_length, 0., 0.}));
+  }
+  Grid<GridOptions::Normal> grid(list, min_cell_length);
+  VERIFY(grid.refreshable());
+
+  // Move every particle a little (staying well within its cell) and check
+  // that a refresh picks up the new positions without re-binning.
+  for (ParticleData &p : list) {
+    const FourVector r = p.position();
+    p.set_4position(FourVector(r.x0() + 0.1, r.x1() + 0.01, r.x2(), r.x3()));
+  }
+  grid.refresh(list);
+  std::size_t visited = 0;
+  grid.iterate_cells(
+      [&](const ParticleSlice &cell) {
+        for (const ParticleData &p : cell) {
+          COMPARE(p.position(), list.lookup(p).position());
+          ++visited;
+        }
+      },
+      [](const ParticleSlice &, const ParticleSlice &) {});
+  COMPARE(visited, 8u);
+
+  // A particle that cannot interact yet may start to interact while the
+  // grid is being reused, so such a grid must not report itself as
+  // refreshable.
+  Particles unformed;
+  for (int i = 0; i < 8; ++i) {
+    unformed.insert(Test::smashon(Position{0., i * min_cell_length, 0., 0.}));
+  }
+  unformed.begin()->set_cross_section_scaling_factor(0.);
+  Grid<GridOptions::Normal> grid2(unformed, min_cell_length);
+  VERIFY(!grid2.refreshable());
+}
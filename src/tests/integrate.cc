@@ -53,6 +53,31 @@ TEST(one_dim_result_conversion_to_value) {
   }
 }
 
+TEST(one_dim_gauss_legendre) {
+  constexpr double eps = std::numeric_limits<double>::epsilon() * 5;
+  smash::IntegratorGaussLegendre<32> integrate;
+  // A rule of order n is exact for polynomials up to degree 2n - 1.
+  for (int i = 0; i < 10; ++i) {
+    const auto result = integrate(0, i, [](double x) { return x * x * x; });
+    COMPARE_ABSOLUTE_ERROR(result.value(), i * i * i * i * 0.25,
+                           result.error() + i * i * i * i * eps)
+        << "i = " << i;
+  }
+  // A smooth transcendental integrand converges well below the tolerance.
+  const auto smooth = integrate(0., 1., [](double x) { return std::exp(x); });
+  COMPARE_ABSOLUTE_ERROR(smooth.value(), std::exp(1.) - 1., smooth.error());
+  /* A sharply peaked integrand misses the embedded error estimate and is
+   * handed to the adaptive fallback, which still gets it right. */
+  const double width = 1e-4;
+  const auto peaked = integrate(-1., 1., [width](double x) {
+    return width / (x * x + width * width);
+  });
+  COMPARE_ABSOLUTE_ERROR(peaked.value(), 2. * std::atan(1. / width),
+                         peaked.error() + eps);
+  // An empty interval integrates to zero.
+  COMPARE(integrate(1., 1., [](double x) { return x; }).value(), 0.);
+}
+
 // test two-dimensional Monte-Carlo integration
 
 TEST(two_dim) {
@@ -91,3 +91,16 @@ TEST(interpolate_data_spline_unsorted) {
   COMPARE(f(0), 1.0);
   COMPARE(f(10), 9.0);
 }
+
+TEST(interpolate_data_linear_nonuniform) {
+  // A non-equidistant grid has to take the binary-search path and give
+  // the same piecewise linear results as before.
+  std::vector<double> x = {0, 1, 3, 7};
+  std::vector<double> y = {0, 2, 2, 10};
+  InterpolateDataLinear<double> f(x, y);
+  COMPARE(f(0.5), 1.0);
+  COMPARE(f(2), 2.0);
+  COMPARE(f(5), 6.0);
+  COMPARE(f(-1), -2.0);
+  COMPARE(f(9), 14.0);
+}
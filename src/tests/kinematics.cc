@@ -50,6 +50,21 @@ TEST(pCM) {
   COMPARE(pCM_from_s(srts * srts, ma, mb), pcm);
 }
 
+TEST(two_body_momenta) {
+  const double srts = 2.9;
+  const double ma = 0.6;
+  const double mb = 1.2;
+  const double pcm = pCM(srts, ma, mb);
+  const ThreeVector direction(0.36, 0.8, 0.48);  // unit vector
+  const auto momenta = two_body_momenta(srts, ma, direction * pcm);
+  // back to back, with the requested masses and exact total energy
+  COMPARE(momenta.first.threevec(), -momenta.second.threevec());
+  COMPARE(momenta.first.x0() + momenta.second.x0(), srts);
+  FUZZY_COMPARE(momenta.first.sqr(), ma * ma);
+  UnitTest::setFuzzyness<double>(8);
+  FUZZY_COMPARE(momenta.second.sqr(), mb * mb);
+}
+
 TEST(plab_from_s_NN) {
   const double s = 2.9 * 2.9;
   const double mN = 0.938;
@@ -86,6 +86,80 @@ TEST(cell_center) {
   VERIFY(r1 == r2);
 }
 
+TEST(cell_index_at) {
+  // On a non-periodic lattice the index matches the node value_at reads
+  // and positions off the lattice map to -1.
+  auto lattice = create_lattice(false);
+  lattice->node(1, 3, 2) = FourVector(1., 2., 3., 4.);
+  const ThreeVector inside = lattice->cell_center(1, 3, 2);
+  const int index = lattice->cell_index_at(inside);
+  VERIFY(index >= 0);
+  FourVector value;
+  VERIFY(lattice->value_at(inside, value));
+  COMPARE((*lattice)[index], value);
+  COMPARE(lattice->cell_index_at(ThreeVector(-1., 3., 1.)), -1);
+  COMPARE(lattice->cell_index_at(ThreeVector(11., 3., 1.)), -1);
+  // On a periodic lattice positions outside wrap back onto it.
+  auto lattice2 = create_lattice(true);
+  const ThreeVector wrapped = inside + ThreeVector(10., -6., 2.);
+  COMPARE(lattice2->cell_index_at(wrapped), lattice2->cell_index_at(inside));
+}
+
+TEST(interpolation_nodes) {
+  auto lattice = create_lattice(false);
+  // Fill the nodes with a field linear in the position, which trilinear
+  // interpolation reproduces exactly.
+  const ThreeVector slope(0.3, -0.7, 1.1);
+  const auto dims = lattice->dimensions();
+  for (int iz = 0; iz < dims[2]; iz++) {
+    for (int iy = 0; iy < dims[1]; iy++) {
+      for (int ix = 0; ix < dims[0]; ix++) {
+        const ThreeVector c = lattice->cell_center(ix, iy, iz);
+        lattice->node(ix, iy, iz) = FourVector(2.0 + slope * c, 0., 0., 0.);
+      }
+    }
+  }
+  std::array<std::size_t, 8> nodes;
+  std::array<double, 8> weights;
+  // A point in the interior, not on any node
+  const ThreeVector r(3.1, 2.2, 0.9);
+  VERIFY(lattice->interpolation_nodes(r, nodes, weights));
+  double weight_sum = 0.0, interpolated = 0.0;
+  for (int c = 0; c < 8; c++) {
+    weight_sum += weights[c];
+    interpolated += weights[c] * (*lattice)[nodes[c]].x0();
+  }
+  FUZZY_COMPARE(weight_sum, 1.);
+  COMPARE_ABSOLUTE_ERROR(interpolated, 2.0 + slope * r, 1.e-12);
+  // Within half a cell of a face the stencil is clamped onto the lattice,
+  // but the weights still sum to one.
+  const ThreeVector near_face(0.1, 0.1, 0.05);
+  VERIFY(lattice->interpolation_nodes(near_face, nodes, weights));
+  weight_sum = 0.0;
+  for (int c = 0; c < 8; c++) {
+    weight_sum += weights[c];
+  }
+  FUZZY_COMPARE(weight_sum, 1.);
+  // Positions off a non-periodic lattice have no interpolation nodes
+  VERIFY(!lattice->interpolation_nodes(ThreeVector(-1., 3., 1.), nodes,
+                                       weights));
+  // On a periodic lattice the stencil wraps around: interpolating the
+  // node values at a node position returns that node's value.
+  auto periodic = create_lattice(true);
+  for (std::size_t i = 0; i < periodic->size(); i++) {
+    (*periodic)[i] = FourVector(static_cast<double>(i), 0., 0., 0.);
+  }
+  const ThreeVector corner = periodic->cell_center(0, 0, 0);
+  VERIFY(periodic->interpolation_nodes(corner, nodes, weights));
+  interpolated = 0.0;
+  for (int c = 0; c < 8; c++) {
+    interpolated += weights[c] * (*periodic)[nodes[c]].x0();
+  }
+  const int corner_index = periodic->cell_index_at(corner);
+  COMPARE_ABSOLUTE_ERROR(interpolated, static_cast<double>(corner_index),
+                         1.e-12);
+}
+
 TEST(iterators) {
   auto lattice = create_lattice(false);
   // 1) Check that lattice size is as expected
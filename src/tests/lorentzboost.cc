@@ -90,3 +90,21 @@ TEST(back_and_forth) {
     }
   }
 }
+
+// The precomputed boost has to agree with LorentzBoost exactly: both
+// evaluate the same expressions, only the gamma factor is reused.
+TEST(precomputed_boost) {
+  for (int i = 0; i < 1000; i++) {
+    ThreeVector velocity = random_velocity();
+    const PrecomputedBoost boost(velocity);
+    for (int j = 0; j < 1000; j++) {
+      FourVector a(cos_like(), cos_like(), cos_like(), cos_like());
+      const FourVector reference = a.LorentzBoost(velocity);
+      const FourVector precomputed = boost(a);
+      COMPARE(precomputed.x0(), reference.x0()) << " at loop " << i << "*" << j;
+      COMPARE(precomputed.x1(), reference.x1()) << " at loop " << i << "*" << j;
+      COMPARE(precomputed.x2(), reference.x2()) << " at loop " << i << "*" << j;
+      COMPARE(precomputed.x3(), reference.x3()) << " at loop " << i << "*" << j;
+    }
+  }
+}
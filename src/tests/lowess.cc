@@ -54,6 +54,48 @@ TEST(smooth_range) {
   }
 }
 
+TEST(smooth_append_matches_full_fit) {
+  std::vector<double> x, y;
+  for (size_t i = 0; i < 160; i++) {
+    x.push_back(0.01 * i);
+    y.push_back(std::sin(0.05 * i) + 0.01 * (i % 7));
+  }
+  constexpr size_t n_start = 120;
+  std::vector<double> ys =
+      smash::smooth(std::vector<double>(x.begin(), x.begin() + n_start),
+                    std::vector<double>(y.begin(), y.begin() + n_start), 0.25,
+                    size_t{0}, 0.);
+  // growing the table point by point gives the same fit as starting over
+  for (size_t n = n_start + 1; n <= x.size(); n++) {
+    const std::vector<double> xn(x.begin(), x.begin() + n);
+    const std::vector<double> yn(y.begin(), y.begin() + n);
+    smash::smooth_append(xn, yn, ys, 0.25, size_t{0}, 0.);
+    const auto full = smash::smooth(xn, yn, 0.25, size_t{0}, 0.);
+    COMPARE(ys.size(), full.size());
+    for (size_t i = 0; i < n; i++) {
+      COMPARE(ys[i], full[i]) << "n = " << n << ", i = " << i;
+    }
+  }
+}
+
+TEST(smooth_append_with_robustness_refits) {
+  // with robustness iterations the append falls back to a full fit
+  std::vector<double> x, y;
+  for (size_t i = 0; i < 40; i++) {
+    x.push_back(0.1 * i);
+    y.push_back(std::cos(0.2 * i));
+  }
+  std::vector<double> ys =
+      smash::smooth(std::vector<double>(x.begin(), x.begin() + 30),
+                    std::vector<double>(y.begin(), y.begin() + 30), 0.4,
+                    size_t{3}, 0.);
+  smash::smooth_append(x, y, ys, 0.4, size_t{3}, 0.);
+  const auto full = smash::smooth(x, y, 0.4, size_t{3}, 0.);
+  for (size_t i = 0; i < x.size(); i++) {
+    COMPARE(ys[i], full[i]) << "i = " << i;
+  }
+}
+
 TEST(smooth_simple) {
   std::vector<double> x = {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,
                            10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
@@ -73,3 +115,18 @@ TEST(smooth_simple) {
     COMPARE_ABSOLUTE_ERROR(result[i], smoothed_y[i], 1e-7);
   }
 }
+
+TEST(smooth_parallel_matches_serial) {
+  // large enough that the fitting pass runs on the thread pool
+  std::vector<double> x, y;
+  for (size_t i = 0; i < 4096; i++) {
+    x.push_back(0.001 * i);
+    y.push_back(std::sin(0.01 * i) + 0.05 * (i % 11));
+  }
+  const auto serial = smash::smooth(x, y, 0.07, size_t{2}, 0.);
+  smash::initialize_shared_pool(3);
+  const auto parallel = smash::smooth(x, y, 0.07, size_t{2}, 0.);
+  for (size_t i = 0; i < x.size(); i++) {
+    COMPARE(serial[i], parallel[i]) << "i = " << i;
+  }
+}
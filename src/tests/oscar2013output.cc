@@ -296,6 +296,85 @@ TEST(final2013_format) {
   VERIFY(bf::remove(outputfilepath));
 }
 
+TEST(final_particle_output_filtered) {
+  /* Create 2 particles */
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  particles.insert(Test::smashon_random());
+  const int event_id = 0;
+  const double impact_parameter = 1.5;
+
+  const bf::path outputfilename = "particle_lists.oscar";
+  const bf::path outputfilepath = testoutputpath / outputfilename;
+  {
+    OutputParameters out_par = OutputParameters();
+    out_par.part_only_final = true;
+    /* A filter no smashon passes: write only pions */
+    out_par.part_pdg_filter.insert(PdgCode("111"));
+    out_par.part_filtering = true;
+
+    std::unique_ptr<OutputInterface> osc2013final =
+        create_oscar_output("Oscar2013", "Particles", testoutputpath, out_par);
+    VERIFY(bool(osc2013final));
+    osc2013final->at_eventend(particles, event_id, impact_parameter);
+  }
+  VERIFY(bf::exists(outputfilepath));
+
+  {
+    bf::fstream outputfile;
+    outputfile.open(outputfilepath, std::ios_base::in);
+    VERIFY(outputfile.good());
+    std::string line;
+    /* Skip the header and check the filter note */
+    for (int i = 0; i < 3; i++) {
+      std::getline(outputfile, line);
+    }
+    std::getline(outputfile, line);
+    COMPARE(line.compare(0, 17, "# Content filter:"), 0) << line;
+    /* The particle block has to be empty: no particle passed the filter */
+    std::getline(outputfile, line);
+    COMPARE(line, "# event " + std::to_string(event_id + 1) + " out 0");
+    std::getline(outputfile, line);
+    COMPARE(line, "# event " + std::to_string(event_id + 1) +
+                      " end 0 impact   1.500");
+  }
+  VERIFY(bf::remove(outputfilepath));
+}
+
+TEST(shard_suffix) {
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  const int event_id = 0;
+  const double impact_parameter = 1.5;
+
+  const bf::path outputfilepath = testoutputpath / "particle_lists.part3.oscar";
+  const bf::path manifestpath = testoutputpath / "shards.part3.manifest";
+  {
+    OutputParameters out_par = OutputParameters();
+    out_par.part_only_final = true;
+    out_par.shard_suffix = "part3";
+
+    std::unique_ptr<OutputInterface> osc2013final =
+        create_oscar_output("Oscar2013", "Particles", testoutputpath, out_par);
+    VERIFY(bool(osc2013final));
+    osc2013final->at_eventend(particles, event_id, impact_parameter);
+  }
+  /* The shard suffix goes in front of the extension and the shard is
+   * listed in the manifest of this instance. */
+  VERIFY(bf::exists(outputfilepath));
+  VERIFY(bf::exists(manifestpath));
+  {
+    bf::fstream manifest;
+    manifest.open(manifestpath, std::ios_base::in);
+    VERIFY(manifest.good());
+    std::string line;
+    std::getline(manifest, line);
+    COMPARE(line, "particle_lists.part3.oscar");
+  }
+  VERIFY(bf::remove(outputfilepath));
+  VERIFY(bf::remove(manifestpath));
+}
+
 TEST(full_extended_oscar) {
   const bf::path outputfilename = "full_event_history.oscar";
   const bf::path outputfilepath = testoutputpath / outputfilename;
@@ -13,6 +13,7 @@
 
 #include "../include/smash/clebschgordan.h"
 #include "../include/smash/parametrizations.h"
+#include "../include/smash/pow.h"
 
 using namespace smash;
 
@@ -30,3 +31,19 @@ TEST(clebsch_kaon_charge_exchange) {
   // We assume they are same in crosssections.cc.
   COMPARE_ABSOLUTE_ERROR(cg1, cg2, tolerance);
 }
+
+TEST(power_law_rewrites_match_pow) {
+  /* The parametrizations rewrite pow(x, a) as pow_from_log(log(x), a)
+   * where the logarithm is needed anyway, and half-integer powers as
+   * pow_int/sqrt chains. Both have to reproduce std::pow to well below
+   * 1e-12 relative error over the momentum range of the fits. */
+  for (double x = 0.05; x < 50.; x *= 1.17) {
+    for (const double a : {-3.2481, -1.21, -0.64, -0.4473, -0.4}) {
+      const double exact = std::pow(x, a);
+      COMPARE_ABSOLUTE_ERROR(pow_from_log(std::log(x), a), exact,
+                             1e-12 * exact);
+    }
+    const double exact = std::pow(x, 2.5);
+    COMPARE_ABSOLUTE_ERROR(pow_int(x, 2) * std::sqrt(x), exact, 1e-12 * exact);
+  }
+}
@@ -9,11 +9,17 @@
 
 #include "unittest.h"  // This include has to be first
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "setup.h"
 
 #include "../include/smash/particledata.h"
 #include "../include/smash/particles.h"
 #include "../include/smash/pdgcode.h"
+#include "../include/smash/threevector.h"
 
 using namespace smash;
 
@@ -340,3 +346,167 @@ TEST(update) {
   COMPARE(p.front().position(), FourVector(3, 3, 3, 3));
   COMPARE(p.front().id_process(), 2u);
 }
+
+TEST(complete_formation) {
+  Particles p;
+  auto pd =
+      Test::smashon(Test::Momentum{1, 1, 1, 1}, Test::Position{1, 1, 1, 1});
+  pd.set_formation_time(3.);
+  pd.set_cross_section_scaling_factor(0.25);
+  p.insert(pd);
+  COMPARE(p.front().xsec_scaling_factor(), 0.25);
+  // the formation time has not passed yet
+  p.complete_formation(2.);
+  COMPARE(p.front().initial_xsec_scaling_factor(), 0.25);
+  p.complete_formation(3.);
+  COMPARE(p.front().initial_xsec_scaling_factor(), 1.);
+  COMPARE(p.front().xsec_scaling_factor(), 1.);
+}
+
+TEST(move) {
+  Particles p;
+  p.create(5, 0x661);
+  Particles q = std::move(p);
+  COMPARE(q.size(), 5u);
+  // the moved-from object is empty and reusable
+  COMPARE(p.size(), 0u);
+  p.create(2, 0x661);
+  COMPARE(p.size(), 2u);
+  COMPARE(p.front().id(), 0);
+  // ids survive the move
+  int n = 0;
+  for (auto &&x : q) {
+    COMPARE(x.id(), n);
+    ++n;
+  }
+  p = std::move(q);
+  COMPARE(p.size(), 5u);
+}
+
+TEST(hot_arrays) {
+  Particles p;
+  for (int i = 0; i < 4; ++i) {
+    p.insert(Test::smashon(Test::Position{0., 1. + i, 2. + i, 3. + i},
+                           Test::Momentum{4. + i, 5. + i, 6. + i, 7. + i}));
+  }
+  const Particles::HotArrays &hot = p.update_hot_arrays();
+  COMPARE(hot.size(), 4u);
+  std::size_t slot = 0;
+  for (auto &&pd : p) {
+    COMPARE(hot.x[slot], pd.position().x1());
+    COMPARE(hot.y[slot], pd.position().x2());
+    COMPARE(hot.z[slot], pd.position().x3());
+    COMPARE(hot.p0[slot], pd.momentum().x0());
+    COMPARE(hot.px[slot], pd.momentum().x1());
+    COMPARE(hot.py[slot], pd.momentum().x2());
+    COMPARE(hot.pz[slot], pd.momentum().x3());
+    COMPARE(hot.xsec_scale[slot], pd.xsec_scaling_factor());
+    ++slot;
+  }
+
+  // the mirror skips holes and picks up modifications after a refresh
+  p.remove(p.front());
+  const Particles::HotArrays &refreshed = p.update_hot_arrays();
+  COMPARE(refreshed.size(), 3u);
+  COMPARE(refreshed.x[0], p.front().position().x1());
+  COMPARE(refreshed.index[0], 1u);
+}
+
+TEST(find_nonfinite_particle) {
+  Particles p;
+  for (int i = 0; i < 4; ++i) {
+    p.insert(Test::smashon_random());
+  }
+  VERIFY(p.find_nonfinite_particle() == nullptr);
+
+  ParticleData corrupted = *(++p.begin());
+  corrupted.set_3momentum(
+      ThreeVector(1., std::numeric_limits<double>::quiet_NaN(), 3.));
+  p.update_particle(*(++p.begin()), corrupted);
+  const ParticleData *found = p.find_nonfinite_particle();
+  VERIFY(found != nullptr);
+  COMPARE(found->id(), (++p.begin())->id());
+
+  // holes left by removed particles are not scanned
+  p.remove(*found);
+  VERIFY(p.find_nonfinite_particle() == nullptr);
+}
+
+TEST(sort_by_position) {
+  Particles p;
+  // insert with descending z so the initial storage order is reversed
+  for (int i = 0; i < 6; ++i) {
+    p.insert(Test::smashon(Test::Position{0., 1. * i, 2. * i, 10. - i},
+                           Test::Momentum{4., 0., 0., 0.}));
+  }
+  // punch holes into the storage
+  p.remove(*(++p.begin()));
+  p.remove(p.back());
+  COMPARE(p.size(), 4u);
+
+  std::vector<int> ids_before;
+  for (auto &&pd : p) {
+    ids_before.push_back(pd.id());
+  }
+  const ParticleData stale_copy = p.front();
+
+  p.sort_by_position();
+
+  // same particles, no holes, in ascending z order
+  COMPARE(p.size(), 4u);
+  double previous_z = -std::numeric_limits<double>::infinity();
+  std::vector<int> ids_after;
+  for (auto &&pd : p) {
+    VERIFY(p.is_valid(pd));
+    VERIFY(pd.position().x3() > previous_z);
+    previous_z = pd.position().x3();
+    ids_after.push_back(pd.id());
+  }
+  std::sort(ids_before.begin(), ids_before.end());
+  std::sort(ids_after.begin(), ids_after.end());
+  VERIFY(ids_after == ids_before);
+
+  // copies from before the compaction carry stale indices
+  VERIFY(!p.is_valid(stale_copy));
+
+  // the list stays fully usable afterwards
+  p.create(0x211);
+  COMPARE(p.size(), 5u);
+}
+
+TEST(reserve_and_lock_capacity) {
+  Particles p;
+  // well above the default capacity of 100, so insertions cannot trigger
+  // a reallocation after the reserve
+  p.reserve(1000);
+  p.create(500, 0x211);
+  const ParticleData *first = &p.front();
+  p.create(400, -0x211);
+  COMPARE(&p.front(), first);
+  COMPARE(p.size(), 900u);
+}
+
+TEST_CATCH(locked_capacity_exceeded, std::runtime_error) {
+  Particles p;
+  p.lock_capacity();
+  // the default capacity is 100, so this must fail loudly instead of
+  // silently reallocating
+  p.create(200, 0x211);
+}
+
+TEST(update_invalidates_copies) {
+  Particles p;
+  p.insert(Test::smashon(Test::Momentum{4., 1., 0., 0.},
+                         Test::Position{0., 0., 0., 0.}));
+  const ParticleData copy = p.front();
+  VERIFY(p.is_valid(copy));
+
+  ParticleData new_state = copy;
+  new_state.set_4momentum(FourVector(4., 0., 1., 0.));
+  p.update_particle(p.front(), new_state);
+
+  /* The id and the process id are unchanged (as in an elastic update with
+   * disabled history), but the generation counter of the slot is not. */
+  VERIFY(!p.is_valid(copy));
+  VERIFY(p.is_valid(p.front()));
+}
@@ -116,3 +116,59 @@ TEST(phase_space_density_nucleus) {
     std::cout << 0.5 / 100 * i << "  " << f << std::endl;
   }
 }
+
+/* The cell index has to reproduce the full scan, also for disregarded
+   and for newly added particles. */
+TEST(indexed_phase_space_density_matches_scan) {
+  Configuration conf = Test::configuration();
+  conf["Collision_Term"]["Pauli_Blocking"]["Spatial_Averaging_Radius"] = 1.86;
+  conf["Collision_Term"]["Pauli_Blocking"]["Momentum_Averaging_Radius"] = 0.08;
+  conf["Collision_Term"]["Pauli_Blocking"]["Gaussian_Cutoff"] = 2.2;
+
+  std::map<PdgCode, int> list = {{0x2212, 79}, {0x2112, 118}};
+  int Ntest = 20;
+  Nucleus Au(list, Ntest);
+  Au.set_parameters_automatic();
+  Au.arrange_nucleons();
+  Au.generate_fermi_momenta();
+  Particles part_Au;
+  Au.copy_particles(&part_Au);
+
+  ExperimentParameters param = smash::Test::default_parameters(Ntest);
+  std::unique_ptr<PauliBlocker> pb_scan = make_unique<PauliBlocker>(
+      conf["Collision_Term"]["Pauli_Blocking"], param);
+  conf["Collision_Term"]["Pauli_Blocking"]["Spatial_Averaging_Radius"] = 1.86;
+  conf["Collision_Term"]["Pauli_Blocking"]["Momentum_Averaging_Radius"] = 0.08;
+  conf["Collision_Term"]["Pauli_Blocking"]["Gaussian_Cutoff"] = 2.2;
+  std::unique_ptr<PauliBlocker> pb_index = make_unique<PauliBlocker>(
+      conf["Collision_Term"]["Pauli_Blocking"], param);
+  pb_index->build_index(part_Au, 0.5);
+
+  const PdgCode pdg = 0x2212;
+  ParticleList disregard;
+  disregard.push_back(part_Au.front());
+  for (int i = 1; i < 50; i++) {
+    const ThreeVector r(0.3 * i - 7.5, 0.1 * i, 0.0);
+    const ThreeVector p(0.0, 0.0, 0.5 / 50 * i);
+    const double f_scan =
+        pb_scan->phasespace_dens(r, p, part_Au, pdg, disregard);
+    const double f_index =
+        pb_index->phasespace_dens(r, p, part_Au, pdg, disregard);
+    COMPARE_ABSOLUTE_ERROR(f_index, f_scan, 1.e-12) << "point " << i;
+  }
+
+  // A newly produced particle enters via add_to_index.
+  ParticleData fresh{ParticleType::find(pdg)};
+  fresh.set_4position(FourVector(0.0, 1.0, 0.5, 0.0));
+  fresh.set_4momentum(0.938, 0.0, 0.0, 0.1);
+  const ParticleData &inserted = part_Au.insert(fresh);
+  pb_index->add_to_index(inserted);
+  const ThreeVector r_new(1.0, 0.5, 0.0);
+  const ThreeVector p_new(0.0, 0.0, 0.1);
+  const double f_scan =
+      pb_scan->phasespace_dens(r_new, p_new, part_Au, pdg, disregard);
+  const double f_index =
+      pb_index->phasespace_dens(r_new, p_new, part_Au, pdg, disregard);
+  COMPARE_ABSOLUTE_ERROR(f_index, f_scan, 1.e-12);
+  VERIFY(f_index > 0.);
+}
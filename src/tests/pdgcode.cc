@@ -641,6 +641,45 @@ TEST(decimal_from_decimal_consistency) {
   }
 }
 
+TEST(from_decimal_unchecked) {
+  // The fast path agrees with the validating conversion for valid codes.
+  COMPARE(pion, PdgCode::from_decimal_unchecked(211));
+  COMPARE(Kminus, PdgCode::from_decimal_unchecked(-321));
+  COMPARE(antixi, PdgCode::from_decimal_unchecked(-103312));
+  COMPARE(deutron, PdgCode::from_decimal_unchecked(1000010020));
+  COMPARE(antideutron, PdgCode::from_decimal_unchecked(-1000010020));
+  COMPARE(PdgCode("12112"), PdgCode::from_decimal_unchecked(12112));
+  // eight digits: the leading digit adds to the spin degeneracy
+  COMPARE(PdgCode("10002119"), PdgCode::from_decimal_unchecked(10002119));
+  for (const ParticleType& t : ParticleType::list_all()) {
+    const int dec = t.pdgcode().get_decimal();
+    COMPARE(t.pdgcode(), PdgCode::from_decimal_unchecked(dec));
+  }
+  /* Validation is deferred: a code with an invalid quark digit
+   * constructs without throwing and is flagged by test_code. */
+  const PdgCode invalid_quark = PdgCode::from_decimal_unchecked(979);
+  VERIFY(invalid_quark.test_code() != 0);
+  COMPARE(invalid_quark.get_decimal(), 979);
+}
+
+TEST(from_decimal_bulk) {
+  const std::array<std::int32_t, 5> decimals = {
+      {211, -321, 2112, 1000010020, -103312}};
+  std::array<PdgCode, 5> codes;
+  PdgCode::from_decimal_bulk(decimals.data(), decimals.size(), codes.data());
+  for (size_t i = 0; i < decimals.size(); i++) {
+    COMPARE(codes[i], PdgCode::from_decimal(decimals[i]));
+  }
+}
+
+TEST_CATCH(from_decimal_nine_digits, PdgCode::InvalidPdgCode) {
+  PdgCode::from_decimal(123456789);
+}
+
+TEST_CATCH(from_decimal_bad_nucleus_prefix, PdgCode::InvalidPdgCode) {
+  PdgCode::from_decimal(2000010020);
+}
+
 TEST(antiparticles) {
   COMPARE(pion.has_antiparticle(), true);
   COMPARE(pinull.has_antiparticle(), false);
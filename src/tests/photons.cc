@@ -9,6 +9,16 @@
 
 #include "setup.h"
 
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "../include/smash/binaryoutput.h"
+#include "../include/smash/file.h"
+#include "../include/smash/outputparameters.h"
 #include "../include/smash/scatteractionphoton.h"
 
 using namespace smash;
@@ -65,3 +75,85 @@ TEST(photon_reaction_type_function) {
   VERIFY(ScatterActionPhoton::photon_reaction_type(l4) ==
          ScatterActionPhoton::ReactionType::no_reaction);
 }
+
+TEST(compact_binary_output) {
+  const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+  bf::create_directories(testoutputpath);
+  const bf::path outputfilepath = testoutputpath / "photons_compact.bin";
+
+  // set up a π+ ρ0 collision producing fractional photons
+  const ParticleType &type_pi = ParticleType::find(0x211);
+  ParticleData pi{type_pi};
+  pi.set_4momentum(type_pi.mass(), ThreeVector(0., 0., 2.));
+  const ParticleType &type_rho0 = ParticleType::find(0x113);
+  ParticleData rho0{type_rho0};
+  rho0.set_4momentum(type_rho0.mass(), ThreeVector(0., 0., -2.));
+  constexpr int n_fractions = 50;
+  ParticleList in{pi, rho0};
+  const auto act = make_unique<ScatterActionPhoton>(in, 0.05, n_fractions, 5.0);
+  act->add_single_process();
+
+  const Particles dummy;
+  const int event_id = 7;
+  const double impact_parameter = 1.25;
+  {
+    OutputsList outputs;
+    outputs.emplace_back(make_unique<BinaryOutputPhotons>(
+        testoutputpath, "Photons", OutputParameters()));
+    outputs[0]->at_eventstart(dummy, event_id);
+    act->perform_photons(outputs);
+    outputs[0]->at_eventend(dummy, event_id, impact_parameter);
+  }
+  VERIFY(bf::exists(outputfilepath));
+
+  FilePtr binF = fopen(outputfilepath.native(), "rb");
+  VERIFY(binF.get());
+  // Header: magic, format version and variant, SMASH version string
+  char magic[4];
+  COMPARE(std::fread(magic, 1, 4, binF.get()), 4u);
+  COMPARE(std::string(magic, 4), std::string("SMSH"));
+  uint16_t format_version, format_variant;
+  COMPARE(std::fread(&format_version, sizeof(uint16_t), 1, binF.get()), 1u);
+  COMPARE(std::fread(&format_variant, sizeof(uint16_t), 1, binF.get()), 1u);
+  COMPARE(static_cast<int>(format_variant), 0);
+  uint32_t len;
+  COMPARE(std::fread(&len, sizeof(uint32_t), 1, binF.get()), 1u);
+  std::vector<char> version_buf(len);
+  COMPARE(std::fread(version_buf.data(), 1, len, binF.get()),
+          static_cast<size_t>(len));
+
+  // One 'g' block with the compacted photon records of the event
+  char block;
+  COMPARE(std::fread(&block, sizeof(char), 1, binF.get()), 1u);
+  COMPARE(block, 'g');
+  uint32_t n_photons;
+  COMPARE(std::fread(&n_photons, sizeof(uint32_t), 1, binF.get()), 1u);
+  VERIFY(n_photons >= 1u && n_photons <= uint32_t{n_fractions});
+  std::array<double, 8> previous_key{};
+  for (uint32_t i = 0; i < n_photons; i++) {
+    double weight;
+    std::array<double, 8> key;  // production point and momentum
+    COMPARE(std::fread(&weight, sizeof(double), 1, binF.get()), 1u);
+    COMPARE(std::fread(key.data(), sizeof(double), 8, binF.get()), 8u);
+    VERIFY(weight > 0.);
+    // on-shell photon: p0 = |p|
+    const double msqr = key[4] * key[4] - key[5] * key[5] - key[6] * key[6] -
+                        key[7] * key[7];
+    COMPARE_ABSOLUTE_ERROR(msqr, 0., 1.e-9);
+    // compacted records are sorted and unique in their kinematics
+    if (i > 0) {
+      VERIFY(previous_key < key);
+    }
+    previous_key = key;
+  }
+
+  // Event end line
+  COMPARE(std::fread(&block, sizeof(char), 1, binF.get()), 1u);
+  COMPARE(block, 'f');
+  int32_t read_event;
+  double read_impact;
+  COMPARE(std::fread(&read_event, sizeof(int32_t), 1, binF.get()), 1u);
+  COMPARE(std::fread(&read_impact, sizeof(double), 1, binF.get()), 1u);
+  COMPARE(read_event, event_id);
+  COMPARE(read_impact, impact_parameter);
+}
@@ -45,6 +45,59 @@ static ParticleData create_pion(int id = -1) {
 }
 */
 
+/* Checks that with a refined core lattice configured, particles inside
+   the core region take their force from the fine lattice and particles
+   outside it from the enclosing coarse one. */
+TEST(core_lattice_force_lookup) {
+  Configuration conf = Test::configuration();
+  conf["Potentials"]["Skyrme"]["Skyrme_A"] = -209.2;
+  conf["Potentials"]["Skyrme"]["Skyrme_B"] = 156.4;
+  conf["Potentials"]["Skyrme"]["Skyrme_Tau"] = 1.35;
+  ExperimentParameters param = smash::Test::default_parameters();
+  Potentials pot = Potentials(conf["Potentials"], param);
+
+  // Coarse lattice spanning [-5, 5] fm, fine core spanning [-1, 1] fm
+  typedef RectangularLattice<std::pair<ThreeVector, ThreeVector>> ForceLattice;
+  auto FB_lat = make_unique<ForceLattice>(
+      std::array<double, 3>{10., 10., 10.}, std::array<int, 3>{5, 5, 5},
+      std::array<double, 3>{-5., -5., -5.}, false,
+      LatticeUpdate::EveryTimestep);
+  auto FB_core_lat = make_unique<ForceLattice>(
+      std::array<double, 3>{2., 2., 2.}, std::array<int, 3>{4, 4, 4},
+      std::array<double, 3>{-1., -1., -1.}, false,
+      LatticeUpdate::EveryTimestep);
+  const ThreeVector E_coarse(0.1, 0., 0.), E_core(0.2, 0., 0.);
+  for (auto &node : *FB_lat) {
+    node = std::make_pair(E_coarse, ThreeVector(0., 0., 0.));
+  }
+  for (auto &node : *FB_core_lat) {
+    node = std::make_pair(E_core, ThreeVector(0., 0., 0.));
+  }
+
+  Particles P;
+  ParticleData in_core{ParticleType::find(0x2212)};
+  in_core.set_4position(FourVector(0., 0.5, 0., 0.));
+  in_core.set_4momentum(0.938, 0., 0., 0.);
+  const int id_in = P.insert(in_core).id();
+  ParticleData in_halo{ParticleType::find(0x2112)};
+  in_halo.set_4position(FourVector(0., 4., 4., 4.));
+  in_halo.set_4momentum(0.938, 0., 0., 0.);
+  const int id_out = P.insert(in_halo).id();
+
+  const double dt = 0.1;
+  update_momenta(&P, dt, pot, FB_lat.get(), nullptr, FB_core_lat.get(),
+                 nullptr);
+  const auto scale = pot.force_scale(ParticleType::find(0x2212));
+  for (const ParticleData &data : P) {
+    const double expected =
+        (data.id() == id_in ? E_core.x1() : E_coarse.x1()) * scale.first * dt;
+    COMPARE_ABSOLUTE_ERROR(data.momentum().x1(), expected, 1.e-12)
+        << "particle " << data.id() << " (in core: " << (data.id() == id_in)
+        << ")";
+    VERIFY(data.id() == id_in || data.id() == id_out);
+  }
+}
+
 // Create nuclear potential profile in XY plane
 TEST(nucleus_potential_profile) {
   // Create a nucleus
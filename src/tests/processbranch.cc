@@ -81,3 +81,26 @@ TEST(weights) {
   branch.set_weight(0.33);
   COMPARE(branch.weight(), 0.33);
 }
+
+// exercise the memory pool behind ProcessBranch::operator new/delete:
+// allocate many branches, release them in mixed order and allocate again to
+// hit the reuse path of the free lists
+TEST(memory_pool) {
+  for (int round = 0; round < 3; ++round) {
+    CollisionBranchList branches;
+    for (int i = 0; i < 1000; ++i) {
+      branches.emplace_back(
+          make_unique<CollisionBranch>(0.5, ProcessType::Elastic));
+    }
+    // free every second branch, then fill the holes again
+    for (std::size_t i = 0; i < branches.size(); i += 2) {
+      branches[i].reset();
+    }
+    for (std::size_t i = 0; i < branches.size(); i += 2) {
+      branches[i] = make_unique<CollisionBranch>(0.5, ProcessType::Elastic);
+    }
+    for (const auto &branch : branches) {
+      COMPARE(branch->weight(), 0.5);
+    }
+  }
+}
@@ -92,6 +92,17 @@ TEST(difference) {
   COMPARE(diff, A - H);
 }
 
+TEST(sum) {
+  FourVector P(1, 2, 3, 4);
+  FourVector Q(2, 3, 4, 4);
+  QuantumNumbers A(P, 5, 6, 7, 8, 9, 0);
+  QuantumNumbers H(Q, 5, 6, 1, -8, 12358, -15);
+  QuantumNumbers sum(P + Q, 10, 12, 8, 0, 12367, -15);
+  COMPARE(sum, A + H);
+  // Adding a difference back has to restore the original value.
+  COMPARE(A, H + (A - H));
+}
+
 TEST(report_deviations) {
   FourVector P(1, 2, 3, 4);
   FourVector Q(2, 3, 4, 4);
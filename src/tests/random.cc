@@ -9,6 +9,8 @@
 
 #include "unittest.h"  // This include has to be first
 
+#include <vector>
+
 #include "histogram.h"
 
 #include "../include/smash/random.h"
@@ -67,6 +69,11 @@ TEST(exponential) {
                     [](double x) { return exp(-x); });
 }
 
+TEST(normal) {
+  test_distribution(N_TEST, 0.05, []() { return random::normal(0., 1.); },
+                    [](double x) { return exp(-0.5 * x * x); });
+}
+
 TEST(x_exponential) {
   test_distribution(
       N_TEST, 0.05,
@@ -117,3 +124,63 @@ TEST(beta_a0) {
   test_distribution(N_TEST, 0.001, [&]() { return random::beta_a0(xmin, b); },
                     [&](double x) { return std::pow(1.0 - x, b) / x; });
 }
+
+TEST(philox_streams_are_deterministic) {
+  // The same (seed, event, stream) triple must always give the same values,
+  // no matter what was drawn before.
+  random::Engine a(42);
+  a.set_stream(123, 7, 2);
+  std::vector<uint64_t> first;
+  for (int i = 0; i < 16; ++i) {
+    first.push_back(a());
+  }
+  random::Engine b(999);
+  b.discard(1000);
+  b.set_stream(123, 7, 2);
+  for (int i = 0; i < 16; ++i) {
+    COMPARE(b(), first[i]);
+  }
+}
+
+TEST(philox_streams_differ) {
+  // Streams for different seeds, events or stream ids must not collide.
+  random::Engine a, b, c, d;
+  a.set_stream(123, 7, 2);
+  b.set_stream(124, 7, 2);
+  c.set_stream(123, 8, 2);
+  d.set_stream(123, 7, 3);
+  int equal_ab = 0, equal_ac = 0, equal_ad = 0;
+  for (int i = 0; i < 64; ++i) {
+    const uint64_t va = a();
+    equal_ab += (va == b());
+    equal_ac += (va == c());
+    equal_ad += (va == d());
+  }
+  COMPARE(equal_ab, 0);
+  COMPARE(equal_ac, 0);
+  COMPARE(equal_ad, 0);
+}
+
+TEST(discrete_dist_alias_table) {
+  // frequencies of the drawn indices have to match the given weights
+  const std::vector<double> weights = {0.1, 0., 4.2, 1.0, 0.7};
+  const double sum = 6.0;
+  random::discrete_dist<double> dist(weights);
+  constexpr int n_draws = 1000000;
+  std::vector<int> counts(weights.size(), 0);
+  for (int i = 0; i < n_draws; i++) {
+    const int j = dist();
+    VERIFY(j >= 0 && j < static_cast<int>(weights.size()));
+    counts[j]++;
+  }
+  for (std::size_t j = 0; j < weights.size(); j++) {
+    COMPARE_ABSOLUTE_ERROR(static_cast<double>(counts[j]) / n_draws,
+                           weights[j] / sum, 5e-3)
+        << " (index " << j << ")";
+  }
+  // the degenerate default always draws 0
+  random::discrete_dist<double> trivial;
+  for (int i = 0; i < 100; i++) {
+    COMPARE(trivial(), 0);
+  }
+}
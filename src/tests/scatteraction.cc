@@ -115,6 +115,34 @@ TEST(elastic_collision) {
          (in[0] == particles.back() && in[1] == particles.front()));
 }
 
+TEST(elastic_only_fast_path) {
+  // create two colliding pions
+  ParticleData a{ParticleType::find(0x211)};  // pi+
+  a.set_4position(pos_a);
+  a.set_4momentum(Momentum{1.1, 1.0, 0., 0.});
+  ParticleData b{ParticleType::find(0x211)};  // pi+
+  b.set_4position(pos_b);
+  b.set_4momentum(Momentum{1.1, -1.0, 0., 0.});
+
+  constexpr double time = 1.;
+  constexpr NNbarTreatment nnbar_treatment = NNbarTreatment::NoAnnihilation;
+  ReactionsBitSet elastic_only;
+  elastic_only.set(IncludedReactions::Elastic);
+
+  for (const double sigma : {10., -1.}) {
+    // the fast path has to reproduce the full dispatch
+    ScatterAction act_full(a, b, time);
+    act_full.add_all_scatterings(sigma, false, elastic_only, 0., false, false,
+                                 false, nnbar_treatment);
+    ScatterAction act_fast(a, b, time);
+    act_fast.add_elastic_scattering(sigma, false);
+    COMPARE(act_fast.cross_section(), act_full.cross_section());
+    if (sigma > 0.) {
+      COMPARE(act_fast.cross_section(), sigma);
+    }
+  }
+}
+
 TEST(outgoing_valid) {
   // create a proton and a pion
   ParticleData p1{ParticleType::find(0x2212)};
@@ -212,13 +212,13 @@ TEST(find_next_action) {
   // prepare list of particles that will be checked for possible actions
   ParticleList particle_list = particles.copy_to_vector();
   ActionList action_list = finder.find_actions_with_surrounding_particles(
-      particle_list, particles, 10000.);
+      particle_list, particles.copy_to_vector(), 10000.);
   // we expect to find no actions because there are no surrounding particles
   COMPARE(action_list.size(), 0u);
   // remove one particle from the list so that the interaction can be found
   particle_list.pop_back();
   action_list = finder.find_actions_with_surrounding_particles(
-      particle_list, particles, 10000.);
+      particle_list, particles.copy_to_vector(), 10000.);
   // we expect to find one collision between the two particles
   COMPARE(action_list.size(), 1u);
   ActionPtr action = std::move(action_list[0]);
@@ -258,10 +258,128 @@ TEST(increasing_scaling_factors) {
   ExperimentParameters exp_par = Test::default_parameters();
   const std::vector<bool> has_interacted = {};
   ScatterActionsFinder finder(config, exp_par, has_interacted, 0, 0);
-  COMPARE(finder.find_actions_in_cell({p_a, p_b}, 2. * delta_t_coll).size(),
+  COMPARE(finder.find_actions_in_cell(ParticleList{p_a, p_b}, 2. * delta_t_coll).size(),
           1u);
   // For a Power smaller than alpha, the particles should not collide.
   ParticleData::formation_power_ = alpha + 0.1;
-  COMPARE(finder.find_actions_in_cell({p_a, p_b}, 2. * delta_t_coll).size(),
+  COMPARE(finder.find_actions_in_cell(ParticleList{p_a, p_b}, 2. * delta_t_coll).size(),
           0u);
 }
+
+TEST(cross_section_cache) {
+  const ParticleType &type = ParticleType::find(0x661);
+  CrossSectionCache cache;
+
+  // an empty bin reports a negative value
+  VERIFY(cache.get(type, type, 1.) < 0.);
+
+  cache.store(type, type, 1., 5.);
+  COMPARE(cache.get(type, type, 1.), 5.);
+
+  // the cache keeps the maximum of a bin, so it stays an upper bound
+  cache.store(type, type, 1., 3.);
+  COMPARE(cache.get(type, type, 1.), 5.);
+  cache.store(type, type, 1., 7.);
+  COMPARE(cache.get(type, type, 1.), 7.);
+
+  // other bins are unaffected
+  VERIFY(cache.get(type, type, 2.) < 0.);
+}
+
+TEST(cross_section_cache_save_load) {
+  const ParticleType &type = ParticleType::find(0x661);
+  const bf::path path = bf::unique_path("cache_file_%%%%.bin");
+
+  CrossSectionCache cache;
+  cache.store(type, type, 1., 5.);
+  cache.store(type, type, 2., 3.);
+  COMPARE(cache.save(path), 1u);
+
+  CrossSectionCache loaded;
+  loaded.store(type, type, 2., 7.);
+  COMPARE(loaded.load(path), 1u);
+  // the saved values are merged in, keeping the maximum of a bin
+  COMPARE(loaded.get(type, type, 1.), 5.);
+  COMPARE(loaded.get(type, type, 2.), 7.);
+  VERIFY(loaded.get(type, type, 3.) < 0.);
+
+  // a missing file is not an error, nothing is merged
+  bf::remove(path);
+  CrossSectionCache empty;
+  COMPARE(empty.load(path), 0u);
+  VERIFY(empty.get(type, type, 1.) < 0.);
+}
+
+TEST(max_cross_section_bound) {
+  const ParticleType &type = ParticleType::find(0x661);
+  constexpr double elastic_parameter = 10.;  // mb
+  ExperimentParameters exp_par = Test::default_parameters();
+  Configuration config =
+      Test::configuration("Collision_Term: {Elastic_Cross_Section: 10.0}");
+  const std::vector<bool> has_interacted = {};
+  ScatterActionsFinder finder(config, exp_par, has_interacted, 0, 0);
+
+  const double max_xs = finder.max_cross_section(type, type, 1.);
+  // the per-pair bound must cover the constant elastic cross section ...
+  VERIFY(max_xs >= elastic_parameter);
+  // ... while improving on the global bound
+  VERIFY(max_xs < maximum_cross_section);
+}
+
+TEST(sweep_finds_same_actions) {
+  // Fill one cell densely enough that the sort-and-sweep refinement is
+  // taken and compare against a brute-force pair-by-pair search, which
+  // goes through the plain pair loops.
+  constexpr double radius = 0.11;                                    // in fm
+  const double elastic_parameter = radius * radius * M_PI / fm2_mb;  // in mb
+  ExperimentParameters exp_par = Test::default_parameters();
+  Configuration config =
+      Test::configuration("Collision_Term: {Elastic_Cross_Section: " +
+                          std::to_string(elastic_parameter) + "}");
+  const std::vector<bool> has_interacted = {};
+  ScatterActionsFinder finder(config, exp_par, has_interacted, 0, 0);
+  const double dt = 0.9;  // fm/c
+
+  // neighboring particles approach each other pairwise along x
+  constexpr int n_particles = 20;
+  ParticleList search_list;
+  for (int i = 0; i < n_particles; i++) {
+    const double direction = (i % 2 == 0) ? 1. : -1.;
+    search_list.push_back(
+        Test::smashon(Test::Momentum{0.11, direction * 0.1, 0., 0.},
+                      Test::Position{0., 0.15 * i, 1., 1.}, i));
+  }
+
+  std::size_t expected = 0;
+  for (int i = 0; i < n_particles; i++) {
+    for (int j = i + 1; j < n_particles; j++) {
+      ParticleList pair = {search_list[i], search_list[j]};
+      expected += finder.find_actions_in_cell(pair, dt).size();
+    }
+  }
+  VERIFY(expected > 0u);
+  COMPARE(finder.find_actions_in_cell(search_list, dt).size(), expected);
+
+  // the same for the neighbor search, with wider spacing so that the
+  // sweep window actually excludes part of the neighbor list
+  ParticleList cell, neighbors;
+  for (int i = 0; i < n_particles; i++) {
+    cell.push_back(Test::smashon(Test::Momentum{0.11, 0.1, 0., 0.},
+                                 Test::Position{0., 0.4 * i, 1., 1.}, i));
+    neighbors.push_back(
+        Test::smashon(Test::Momentum{0.11, -0.1, 0., 0.},
+                      Test::Position{0., 0.4 * i + 0.15, 1., 1.},
+                      n_particles + i));
+  }
+  expected = 0;
+  for (int i = 0; i < n_particles; i++) {
+    for (int j = 0; j < n_particles; j++) {
+      ParticleList a = {cell[i]};
+      ParticleList b = {neighbors[j]};
+      expected += finder.find_actions_with_neighbors(a, b, dt).size();
+    }
+  }
+  VERIFY(expected > 0u);
+  COMPARE(finder.find_actions_with_neighbors(cell, neighbors, dt).size(),
+          expected);
+}
@@ -244,6 +244,7 @@ inline ExperimentParameters default_parameters(int testparticles = 1,
   return ExperimentParameters{{0., dt},
                               {0., 1.},
                               testparticles,
+                              1,
                               1.0,
                               4.0,
                               true,
@@ -0,0 +1,228 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "setup.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/smash/crosssections.h"
+#include "../include/smash/density.h"
+#include "../include/smash/grid.h"
+#include "../include/smash/kinematics.h"
+#include "../include/smash/oscaroutput.h"
+#include "../include/smash/outputparameters.h"
+#include "../include/smash/scatteractionsfinder.h"
+#include "../include/smash/tabulation.h"
+
+/* Microbenchmarks for the hot kernels of a SMASH run. Unlike the whole-run
+ * scenarios in bin/benchmarks, each benchmark here times one kernel in
+ * isolation and reports nanoseconds per operation, so that regressions can
+ * be attributed to a single function. The numbers are meant to be compared
+ * across commits on the same machine; they are not pass/fail criteria, so
+ * this is a plain executable and not a unit test. */
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+/// Accumulator that keeps the compiler from optimizing benchmark bodies away.
+static volatile double sink = 0.0;
+
+/**
+ * Time \p body and print the average cost of one operation.
+ *
+ * \param name label printed in front of the timing
+ * \param iterations how often \p body is invoked after one warm-up call
+ * \param ops_per_iteration how many operations one invocation performs
+ * \param body the benchmark body
+ */
+static void benchmark(const std::string &name, const int iterations,
+                      const int ops_per_iteration,
+                      const std::function<void()> &body) {
+  body();  // warm up caches and lazy initializations
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    body();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  const double ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+          .count();
+  std::printf("%-40s %12.1f ns/op\n", name.c_str(),
+              ns / (static_cast<double>(iterations) * ops_per_iteration));
+}
+
+/// A particle of the given type at a random position in a (10 fm)³ box.
+static ParticleData random_particle(const ParticleType &type) {
+  ParticleData p{type};
+  p.set_4momentum(type.mass(),
+                  ThreeVector(random::uniform(-0.2, 0.2),
+                              random::uniform(-0.2, 0.2),
+                              random::uniform(-0.2, 0.2)));
+  p.set_4position(FourVector(0., random::uniform(-5., 5.),
+                             random::uniform(-5., 5.),
+                             random::uniform(-5., 5.)));
+  return p;
+}
+
+/// Two particles colliding head-on along z with the given CM energy.
+static ParticleList cm_pair(const ParticleType &a, const ParticleType &b,
+                            const double sqrts) {
+  const double p_cm = pCM(sqrts, a.mass(), b.mass());
+  ParticleData p1{a}, p2{b};
+  p1.set_4momentum(a.mass(), 0., 0., p_cm);
+  p2.set_4momentum(b.mass(), 0., 0., -p_cm);
+  return {p1, p2};
+}
+
+static void benchmark_grid_and_finder() {
+  const ParticleType &proton = ParticleType::find(0x2212);
+  const ParticleType &pi_plus = ParticleType::find(0x211);
+  Particles particles;
+  constexpr int n_particles = 200;
+  for (int i = 0; i < n_particles; i++) {
+    particles.insert(random_particle(i % 2 ? proton : pi_plus));
+  }
+
+  constexpr double min_cell_length = 2.0;
+  benchmark("grid build (200 particles)", 200, 1, [&]() {
+    Grid<GridOptions::Normal> grid(particles, min_cell_length);
+    grid.iterate_cells(
+        [&](const ParticleSlice &search) {
+          sink += static_cast<double>(search.size());
+        },
+        [](const ParticleSlice &, const ParticleSlice &) {});
+  });
+
+  const std::vector<bool> has_interacted = {};
+  ExperimentParameters exp_par = Test::default_parameters();
+  Configuration config =
+      Test::configuration("Collision_Term: {Elastic_Cross_Section: 10.0}");
+  ScatterActionsFinder finder(config, exp_par, has_interacted, 0, 0);
+  const ParticleList search_list = particles.copy_to_vector();
+  benchmark("find_actions_in_cell (200 particles)", 50, 1, [&]() {
+    const auto actions = finder.find_actions_in_cell(search_list, 1.0);
+    sink += static_cast<double>(actions.size());
+  });
+}
+
+static void benchmark_cross_sections() {
+  const ParticleType &proton = ParticleType::find(0x2212);
+  const ParticleType &pi_plus = ParticleType::find(0x211);
+  const ParticleType &pi_minus = ParticleType::find(-0x211);
+  const std::vector<std::pair<ParticleTypePtr, ParticleTypePtr>> pairs = {
+      {&proton, &proton}, {&pi_plus, &proton}, {&pi_plus, &pi_minus}};
+  constexpr int n_energies = 20;
+  std::vector<ParticleList> matrix;
+  for (const auto &pair : pairs) {
+    const double threshold = pair.first->mass() + pair.second->mass();
+    for (int i = 0; i < n_energies; i++) {
+      const double sqrts = threshold + 0.1 + 0.15 * i;
+      matrix.push_back(cm_pair(*pair.first, *pair.second, sqrts));
+    }
+  }
+  benchmark("CrossSections::two_to_two", 20,
+            static_cast<int>(matrix.size()), [&]() {
+              for (const ParticleList &incoming : matrix) {
+                const double sqrts =
+                    (incoming[0].momentum() + incoming[1].momentum()).abs();
+                CrossSections xs(incoming, sqrts,
+                                 std::make_pair(FourVector(), FourVector()));
+                for (const auto &proc :
+                     xs.two_to_two(Test::all_reactions_included())) {
+                  sink += proc->weight();
+                }
+              }
+            });
+}
+
+static void benchmark_smearing_factor() {
+  const DensityParameters par(Test::default_parameters());
+  const FourVector p(std::sqrt(1.0 + 0.938 * 0.938), 0.6, 0.0, 0.8);
+  const double m_inv = 1.0 / p.abs();
+  constexpr int n_offsets = 1000;
+  std::vector<ThreeVector> offsets;
+  offsets.reserve(n_offsets);
+  for (int i = 0; i < n_offsets; i++) {
+    offsets.emplace_back(random::uniform(-3., 3.), random::uniform(-3., 3.),
+                         random::uniform(-3., 3.));
+  }
+  benchmark("unnormalized_smearing_factor", 1000, n_offsets, [&]() {
+    for (const ThreeVector &r : offsets) {
+      sink += unnormalized_smearing_factor(r, p, m_inv, par, false).first;
+    }
+  });
+}
+
+static void benchmark_tabulation() {
+  const Tabulation tab(0., 10., 512,
+                       [](double x) { return x * std::exp(-x); });
+  constexpr int n_queries = 1000;
+  std::vector<double> queries;
+  queries.reserve(n_queries);
+  for (int i = 0; i < n_queries; i++) {
+    queries.push_back(random::uniform(-1., 11.));
+  }
+  benchmark("Tabulation::get_value_linear", 10000, n_queries, [&]() {
+    for (const double x : queries) {
+      sink += tab.get_value_linear(x);
+    }
+  });
+}
+
+static void benchmark_resonance_mass_sampling() {
+  const ParticleType &delta = ParticleType::find(0x2214);
+  const double mass_stable = ParticleType::find(0x2212).mass();
+  benchmark("sample_resonance_mass (Δ⁺)", 10000, 1, [&]() {
+    sink += delta.sample_resonance_mass(mass_stable, 2.5, 1);
+  });
+}
+
+static void benchmark_oscar_output() {
+  const ParticleType &proton = ParticleType::find(0x2212);
+  Particles particles;
+  constexpr int n_particles = 100;
+  for (int i = 0; i < n_particles; i++) {
+    particles.insert(random_particle(proton));
+  }
+  bf::create_directories(testoutputpath);
+  const OutputParameters out_par = OutputParameters();
+  std::unique_ptr<OutputInterface> oscar =
+      create_oscar_output("Oscar2013", "Particles", testoutputpath, out_par);
+  int event = 0;
+  benchmark("Oscar2013 particle line formatting", 100, n_particles, [&]() {
+    oscar->at_eventstart(particles, event);
+    oscar->at_eventend(particles, event, 0.);
+    event++;
+  });
+  oscar.reset();
+  bf::remove(testoutputpath / "particle_lists.oscar");
+}
+
+int main() {
+  Test::create_actual_particletypes();
+  Test::create_actual_decaymodes();
+  random::set_seed(20180101);
+
+  benchmark_grid_and_finder();
+  benchmark_cross_sections();
+  benchmark_smearing_factor();
+  benchmark_tabulation();
+  benchmark_resonance_mass_sampling();
+  benchmark_oscar_output();
+
+  // Keep the accumulated results observable so nothing is optimized away.
+  std::fprintf(stderr, "# checksum %g\n", sink);
+  return 0;
+}
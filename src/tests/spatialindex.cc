@@ -0,0 +1,83 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "unittest.h"  // This include has to be first
+
+#include "setup.h"
+
+#include <algorithm>
+
+#include "../include/smash/spatialindex.h"
+
+using namespace smash;
+
+static bool contains_id(const ParticleList &list, int id) {
+  return std::find_if(list.begin(), list.end(), [id](const ParticleData &p) {
+           return p.id() == id;
+         }) != list.end();
+}
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(neighborhood) {
+  Particles particles;
+  const ParticleData a =
+      particles.insert(Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                                     Test::Position{0., 1., 1., 1.}));
+  const ParticleData b =
+      particles.insert(Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                                     Test::Position{0., 1.5, 1., 1.}));
+  const ParticleData far_away =
+      particles.insert(Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                                     Test::Position{0., 9., 9., 9.}));
+
+  SpatialIndex index(particles, 2.);
+
+  // the neighborhood of a contains a itself and b, but not the far particle
+  ParticleList neighbors = index.neighborhood(a, particles);
+  COMPARE(neighbors.size(), 2u);
+  VERIFY(contains_id(neighbors, a.id()));
+  VERIFY(contains_id(neighbors, b.id()));
+  VERIFY(!contains_id(neighbors, far_away.id()));
+
+  // and vice versa
+  neighbors = index.neighborhood(far_away, particles);
+  COMPARE(neighbors.size(), 1u);
+  VERIFY(contains_id(neighbors, far_away.id()));
+}
+
+TEST(incremental_updates) {
+  Particles particles;
+  const ParticleData a =
+      particles.insert(Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                                     Test::Position{0., 1., 1., 1.}));
+  const ParticleData b =
+      particles.insert(Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                                     Test::Position{0., 1.5, 1., 1.}));
+  particles.insert(Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                                 Test::Position{0., 9., 9., 9.}));
+
+  SpatialIndex index(particles, 2.);
+
+  // removed particles are skipped lazily, without touching the index
+  particles.remove(b);
+  ParticleList neighbors = index.neighborhood(a, particles);
+  COMPARE(neighbors.size(), 1u);
+  VERIFY(contains_id(neighbors, a.id()));
+
+  // newly produced particles show up after they are inserted into the index
+  const ParticleData c =
+      particles.insert(Test::smashon(Test::Momentum{0.2, 0., .1, 0.},
+                                     Test::Position{0., 1.2, 1., 1.}));
+  index.insert(c);
+  neighbors = index.neighborhood(a, particles);
+  COMPARE(neighbors.size(), 2u);
+  VERIFY(contains_id(neighbors, a.id()));
+  VERIFY(contains_id(neighbors, c.id()));
+}
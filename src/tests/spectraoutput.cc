@@ -0,0 +1,91 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "unittest.h"  // This include has to be first
+
+#include "setup.h"
+
+#include <array>
+#include <cmath>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "../include/smash/outputparameters.h"
+#include "../include/smash/particles.h"
+#include "../include/smash/spectraoutput.h"
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  bf::create_directories(testoutputpath);
+  VERIFY(bf::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+TEST(histograms_are_accumulated) {
+  const bf::path outputfilepath = testoutputpath / "spectra.dat";
+  OutputParameters out_par;
+  out_par.spectra_pdgs = {PdgCode(0x661)};
+  out_par.spectra_axes = {"pT", "y"};
+  out_par.spectra_bins = 4;
+  out_par.spectra_pt_max = 4.;
+  out_par.spectra_y_max = 2.;
+  /* Two particles with vanishing longitudinal momentum: their transverse
+   * momenta land in the first and third pT bin and both have rapidity 0. */
+  const double m = Test::smashon_mass;
+  Particles particles;
+  particles.insert(Test::smashon(
+      Test::Momentum{std::sqrt(m * m + 0.5 * 0.5), 0.5, 0., 0.}));
+  particles.insert(Test::smashon(
+      Test::Momentum{std::sqrt(m * m + 2.5 * 2.5), 2.5, 0., 0.}));
+  {
+    SpectraOutput output(testoutputpath, "Spectra", out_par);
+    output.at_eventstart(particles, 0);
+    output.at_eventend(particles, 0, 0.);
+    output.at_eventstart(particles, 1);
+    output.at_eventend(particles, 1, 0.);
+  }
+  VERIFY(bf::exists(outputfilepath));
+
+  bf::fstream file;
+  file.open(outputfilepath, std::ios_base::in);
+  VERIFY(file.good());
+  std::string line;
+  std::getline(file, line);
+  COMPARE(line.substr(0, 1), "#");
+  std::getline(file, line);
+  COMPARE(line, "# 2 events");
+  // the per-event pT yield of the identical events is 1/bin for the two
+  // filled bins
+  std::getline(file, line);
+  COMPARE(line, "# pdg 661 axis pT range 0 4 bins 4");
+  const std::array<double, 4> pt_yields = {1., 0., 1., 0.};
+  for (int b = 0; b < 4; b++) {
+    double center, yield;
+    file >> center >> yield;
+    COMPARE(center, 0.5 + b);
+    COMPARE(yield, pt_yields[b]);
+  }
+  std::getline(file, line);  // rest of the last bin line
+  // both particles of both events fall into the y bin around 0
+  std::getline(file, line);
+  COMPARE(line, "# pdg 661 axis y range -2 2 bins 4");
+  const std::array<double, 4> y_yields = {0., 0., 2., 0.};
+  for (int b = 0; b < 4; b++) {
+    double center, yield;
+    file >> center >> yield;
+    COMPARE(center, -1.5 + b);
+    COMPARE(yield, y_yields[b]);
+  }
+}
@@ -9,6 +9,11 @@
 
 #include "unittest.h"  // This include has to be first
 
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
 #include "../include/smash/tabulation.h"
 
 using namespace smash;
@@ -84,3 +89,55 @@ TEST(quadratic) {
   // check extrapolated values
   COMPARE_ABSOLUTE_ERROR(tab.get_value_linear(3.), 7.8, error);
 }
+
+TEST(batch_construction) {
+  // a batched function gives the same tabulation as the pointwise one
+  const Tabulation scalar(-2., 4., 20, [](double x) { return x * x; });
+  const Tabulation batch(
+      -2., 4., 20, [](const std::vector<double> &xs) {
+        std::vector<double> values(xs.size());
+        for (size_t i = 0; i < xs.size(); i++) {
+          values[i] = xs[i] * xs[i];
+        }
+        return values;
+      });
+  for (double x = -3.; x <= 3.; x += 0.1) {
+    FUZZY_COMPARE(batch.get_value_linear(x), scalar.get_value_linear(x));
+  }
+}
+
+TEST(serialization_roundtrip) {
+  const Tabulation tab(-2., 4., 20, [](double x) { return x * x; });
+  std::stringstream stream;
+  tab.write(stream);
+  const auto read_back = Tabulation::from_stream(stream);
+  VERIFY(read_back != nullptr);
+  // the read-back tabulation reproduces the original values exactly
+  for (double x = -3.; x <= 3.; x += 0.1) {
+    FUZZY_COMPARE(read_back->get_value_linear(x), tab.get_value_linear(x));
+  }
+}
+
+TEST(serialization_truncated) {
+  const Tabulation tab(0., 10., 10, [](double) { return 1.; });
+  std::stringstream stream;
+  tab.write(stream);
+  std::stringstream truncated(stream.str().substr(0, 20));
+  VERIFY(Tabulation::from_stream(truncated) == nullptr);
+}
+
+TEST(map_file_roundtrip) {
+  const Tabulation tab(-2., 4., 20, [](double x) { return x * x; });
+  const bf::path file = bf::unique_path("tabulation_map_test_%%%%.tab");
+  {
+    bf::ofstream stream(file, std::ios::binary);
+    tab.write(stream);
+  }
+  const auto mapped = Tabulation::map_file(file.native());
+  VERIFY(mapped != nullptr);
+  // the mapped tabulation reproduces the original values exactly
+  for (double x = -3.; x <= 3.; x += 0.1) {
+    FUZZY_COMPARE(mapped->get_value_linear(x), tab.get_value_linear(x));
+  }
+  bf::remove(file);
+}
@@ -0,0 +1,108 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "unittest.h"  // This include has to be first
+
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/smash/threadpool.h"
+
+using namespace smash;
+
+TEST(empty_range) {
+  ThreadPool pool(2);
+  COMPARE(pool.num_threads(), 2);
+  bool called = false;
+  pool.parallel_range(0, [&](size_t) { called = true; });
+  VERIFY(!called);
+}
+
+TEST(every_index_exactly_once) {
+  constexpr size_t n = 1000;
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> counts(n);
+  for (auto &c : counts) {
+    c.store(0);
+  }
+  pool.parallel_range(n, [&](size_t i) { counts[i].fetch_add(1); });
+  for (size_t i = 0; i < n; ++i) {
+    COMPARE(counts[i].load(), 1) << "index " << i;
+  }
+}
+
+TEST(more_threads_than_tasks) {
+  ThreadPool pool(8);
+  std::atomic<size_t> sum{0};
+  pool.parallel_range(3, [&](size_t i) { sum.fetch_add(i + 1); });
+  COMPARE(sum.load(), 6u);
+}
+
+TEST(reuse_for_several_regions) {
+  ThreadPool pool(3);
+  std::atomic<size_t> sum{0};
+  for (int round = 0; round < 100; ++round) {
+    pool.parallel_range(17, [&](size_t i) { sum.fetch_add(i); });
+  }
+  COMPARE(sum.load(), 100u * (17u * 16u / 2u));
+}
+
+TEST(unbalanced_tasks_are_stolen) {
+  // One very slow task at the front must not keep the other threads from
+  // finishing the rest of the range.
+  ThreadPool pool(4);
+  constexpr size_t n = 64;
+  std::vector<int> done(n, 0);
+  pool.parallel_range(n, [&](size_t i) {
+    if (i == 0) {
+      // simulate a heavy cell
+      volatile double x = 0.;
+      for (int k = 0; k < 1000000; ++k) {
+        x = x + 1e-9;
+      }
+    }
+    done[i] = 1;
+  });
+  COMPARE(std::accumulate(done.begin(), done.end(), 0), static_cast<int>(n));
+}
+
+TEST(submitted_tasks_run_and_complete) {
+  ThreadPool pool(3);
+  std::atomic<int> sum{0};
+  std::vector<std::future<void>> futures;
+  for (int i = 1; i <= 50; ++i) {
+    futures.push_back(pool.submit([&sum, i] { sum.fetch_add(i); }));
+  }
+  for (auto &f : futures) {
+    f.wait();
+  }
+  COMPARE(sum.load(), 50 * 51 / 2);
+}
+
+TEST(submit_propagates_exceptions) {
+  ThreadPool pool(2);
+  auto future = pool.submit([] { throw std::runtime_error("task failed"); });
+  try {
+    future.get();
+    FAIL() << "expected an exception from the task";
+  } catch (std::runtime_error &e) {
+    COMPARE(std::string(e.what()), "task failed");
+  }
+}
+
+TEST(serial_operation_has_no_shared_pool) {
+  VERIFY(shared_pool() == nullptr);
+  initialize_shared_pool(1);
+  VERIFY(shared_pool() == nullptr);
+}
+
+TEST_CATCH(invalid_thread_count, std::invalid_argument) { ThreadPool pool(0); }
@@ -12,7 +12,10 @@
 #include "setup.h"
 
 #include <smash/config.h>
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <iostream>
@@ -224,3 +227,60 @@ TEST(vtkoutputfile) {
   VERIFY(bf::remove(outputfilepath));
   VERIFY(bf::remove(outputfile2path));
 }
+
+static double read_big_endian_double(std::istream &file) {
+  char bytes[sizeof(double)];
+  file.read(bytes, sizeof(bytes));
+  const uint16_t endianness_test = 1;
+  if (*reinterpret_cast<const char *>(&endianness_test) == 1) {
+    std::reverse(std::begin(bytes), std::end(bytes));
+  }
+  double value;
+  std::memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+TEST(vtkoutputfile_binary) {
+  Particles particles;
+  const int number_of_particles = 5;
+  for (int i = 0; i < number_of_particles; i++) {
+    particles.insert(Test::smashon_random());
+  }
+
+  OutputParameters out_par = OutputParameters();
+  out_par.part_vtk_binary = true;
+
+  std::unique_ptr<VtkOutput> vtkop =
+      make_unique<VtkOutput>(testoutputpath, "Particles", out_par);
+  vtkop->at_eventstart(particles, 0);
+  const bf::path outputfilepath = testoutputpath / "pos_ev00000_tstep00000.vtk";
+  VERIFY(bf::exists(outputfilepath));
+
+  {
+    bf::ifstream outputfile(outputfilepath, std::ios_base::binary);
+    VERIFY(outputfile.good());
+    std::string line;
+    /* Check header */
+    std::getline(outputfile, line);
+    COMPARE(line, "# vtk DataFile Version 2.0");
+    std::getline(outputfile, line);
+    std::getline(outputfile, line);
+    COMPARE(line, "BINARY");
+    std::getline(outputfile, line);
+    COMPARE(line, "DATASET UNSTRUCTURED_GRID");
+    std::getline(outputfile, line);
+    COMPARE(line, "POINTS " + std::to_string(particles.size()) + " double");
+    /* Check that positions round-trip exactly through the binary encoding */
+    for (const auto &pd : particles) {
+      COMPARE(read_big_endian_double(outputfile), pd.position().x1());
+      COMPARE(read_big_endian_double(outputfile), pd.position().x2());
+      COMPARE(read_big_endian_double(outputfile), pd.position().x3());
+    }
+    std::getline(outputfile, line);
+    COMPARE(line, "");
+    std::getline(outputfile, line);
+    COMPARE(line, "CELLS " + std::to_string(particles.size()) + " " +
+                      std::to_string(particles.size() * 2));
+  }
+  VERIFY(bf::remove(outputfilepath));
+}
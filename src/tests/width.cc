@@ -53,6 +53,66 @@ TEST(width_Roper) {
   }
 }
 
+TEST(width_batch) {
+  // The batched evaluations have to agree with the scalar ones.
+  for (const int pdg : {0x2214, 0x12212}) {
+    const ParticleType &t = ParticleType::find(pdg);
+    std::vector<double> masses(100);
+    for (size_t i = 0; i < masses.size(); i++) {
+      masses[i] = 1. + i * 0.01;
+    }
+    const std::vector<double> w = t.total_width(masses);
+    const std::vector<double> sf = t.spectral_function(masses);
+    COMPARE(w.size(), masses.size());
+    COMPARE(sf.size(), masses.size());
+    for (size_t i = 0; i < masses.size(); i++) {
+      COMPARE_RELATIVE_ERROR(w[i], t.total_width(masses[i]), 1.e-12);
+      COMPARE_RELATIVE_ERROR(sf[i], t.spectral_function(masses[i]), 1.e-12);
+    }
+  }
+}
+
+TEST(width_cache) {
+  /* The cached partial-width view has to agree with the branch lists and
+   * with the total widths. */
+  for (const int pdg : {0x2214, 0x12212}) {
+    const ParticleType &t = ParticleType::find(pdg);
+    for (int i = 0; i < 100; i++) {
+      const double m = 1. + i * 0.01;
+      const std::vector<double> &widths = t.partial_widths(m);
+      COMPARE(widths.size(), t.decay_modes().decay_mode_list().size());
+      const double sum = std::accumulate(widths.begin(), widths.end(), 0.);
+      const double w_tot = t.total_width(m);
+      if (w_tot > 0.) {
+        COMPARE_RELATIVE_ERROR(sum, w_tot, 1.e-12);
+      }
+      ProcessBranchList<DecayBranch> partial = t.get_partial_widths(m);
+      const size_t n_positive = std::count_if(
+          widths.begin(), widths.end(), [](const double w) { return w > 0.; });
+      COMPARE(partial.size(), n_positive);
+      /* Neither Delta(1232) nor N(1440) has dilepton decay modes, so the
+       * hadronic width is the full width. */
+      COMPARE_RELATIVE_ERROR(t.total_hadronic_width(m), sum, 1.e-12);
+      VERIFY(!t.has_dilepton_decays());
+      COMPARE(t.get_partial_widths_dilepton(m).size(), 0u);
+    }
+  }
+}
+
+TEST(spectral_memo) {
+  const ParticleType &t = ParticleType::find(0x2214);
+  // discard the counts accumulated by the previous tests
+  ParticleType::spectral_cache_statistics();
+  const double first = t.spectral_function(1.232);
+  const double second = t.spectral_function(1.232);
+  COMPARE(first, second);
+  const std::array<uint64_t, 2> stats =
+      ParticleType::spectral_cache_statistics();
+  // the repeated evaluation has to be served from the memo
+  VERIFY(stats[0] >= 1u);
+  VERIFY(stats[1] >= 1u);
+}
+
 /* Compare the out-width vs the integrated in-width,
  * according to equ. (2.60) in Effenberger's thesis,
  * for a given resonance type, decay branch and resonance mass. */
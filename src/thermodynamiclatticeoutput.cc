@@ -0,0 +1,138 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/thermodynamiclatticeoutput.h"
+
+#include <cstdint>
+#include <cstdio>
+
+#include <boost/filesystem.hpp>
+
+#include "smash/clock.h"
+#include "smash/config.h"
+
+namespace smash {
+
+/*!\Userguide
+ * \page thermodyn_lattice_binary_ Binary lattice thermodynamics output
+ *
+ * The binary thermodynamics output writes the Eckart rest frame density on
+ * the lattice to a single streaming file, \c thermodynamics_lattice.bin.
+ * In contrast to the VTK lattice output, which writes one ASCII file per
+ * output moment, one compact float32 frame is appended per output moment,
+ * which makes per-timestep captures of the density evolution feasible. The
+ * output requires a lattice, see \ref input_lattice_.
+ *
+ * The file layout is:
+ * - \c 4*char magic number "SMSH"
+ * - \c uint16_t file format version number
+ * - \c uint16_t format variant, 2 for the lattice format
+ * - \c len*char SMASH version string, preceded by its \c uint32_t length
+ * - \c int32_t thermodynamic quantity (0 = Eckart density)
+ * - \c int32_t density type, see \ref input_output_options_
+ * - \c 3*int32_t lattice dimensions \f$(n_x, n_y, n_z)\f$
+ * - \c 3*double lattice cell sizes [fm]
+ * - \c 3*double lattice origin [fm]
+ *
+ * followed by one frame per output moment:
+ * - \c int32_t event number
+ * - \c double output time [fm/c]
+ * - \c nx*ny*nz*float node values, with the x index changing fastest
+ *
+ * Only the Eckart density is supported; the energy-momentum tensor
+ * quantities are available in the VTK lattice output, see
+ * \ref output_vtk_lattice_.
+ */
+ThermodynamicLatticeOutput::ThermodynamicLatticeOutput(
+    const bf::path &path, const std::string &name,
+    const OutputParameters &out_par)
+    : OutputInterface(name),
+      file_{out_par.shard_path(path, "thermodynamics_lattice.bin"), "wb"} {
+  if (out_par.td_tmn || out_par.td_tmn_landau || out_par.td_v_landau) {
+    const auto &log = logger<LogArea::Output>();
+    log.warn(
+        "Binary thermodynamics output supports only the Eckart density "
+        "lattice; use the VTK format for the energy-momentum tensor "
+        "quantities.");
+  }
+}
+
+ThermodynamicLatticeOutput::~ThermodynamicLatticeOutput() {}
+
+void ThermodynamicLatticeOutput::at_eventstart(const Particles & /*particles*/,
+                                               const int event_number) {
+  current_event_ = event_number;
+}
+
+void ThermodynamicLatticeOutput::at_eventend(const Particles & /*particles*/,
+                                             const int /*event_number*/,
+                                             double /*impact_parameter*/) {
+  std::fflush(file_.get());
+}
+
+void ThermodynamicLatticeOutput::at_intermediate_time(
+    const Particles & /*particles*/, const Clock &clock,
+    const DensityParameters & /*dens_param*/) {
+  current_time_ = clock.current_time();
+}
+
+void ThermodynamicLatticeOutput::write_header(
+    const DensityType dens_type,
+    const RectangularLattice<DensityOnLattice> &lattice) {
+  std::fwrite("SMSH", 4, 1, file_.get());  // magic number
+  const std::uint16_t format_version = 0;
+  std::fwrite(&format_version, sizeof(format_version), 1, file_.get());
+  /* The binary particles and collisions outputs use the format variants
+   * 0 and 1; the lattice format is variant 2. */
+  const std::uint16_t format_variant = 2;
+  std::fwrite(&format_variant, sizeof(format_variant), 1, file_.get());
+  const std::string version(VERSION_MAJOR);
+  const auto version_size = static_cast<std::uint32_t>(version.size());
+  std::fwrite(&version_size, sizeof(version_size), 1, file_.get());
+  std::fwrite(version.c_str(), version.size(), 1, file_.get());
+  const std::int32_t quantity =
+      static_cast<std::int32_t>(ThermodynamicQuantity::EckartDensity);
+  std::fwrite(&quantity, sizeof(quantity), 1, file_.get());
+  const auto type = static_cast<std::int32_t>(dens_type);
+  std::fwrite(&type, sizeof(type), 1, file_.get());
+  const auto &dim = lattice.dimensions();
+  for (int i = 0; i < 3; i++) {
+    const auto n = static_cast<std::int32_t>(dim[i]);
+    std::fwrite(&n, sizeof(n), 1, file_.get());
+  }
+  std::fwrite(lattice.cell_sizes().data(), sizeof(double), 3, file_.get());
+  std::fwrite(lattice.origin().data(), sizeof(double), 3, file_.get());
+  buffer_.resize(static_cast<size_t>(dim[0]) * dim[1] * dim[2]);
+  header_written_ = true;
+}
+
+void ThermodynamicLatticeOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dens_type,
+    RectangularLattice<DensityOnLattice> &lattice) {
+  if (tq != ThermodynamicQuantity::EckartDensity) {
+    return;
+  }
+  if (!header_written_) {
+    write_header(dens_type, lattice);
+  }
+  const auto event = static_cast<std::int32_t>(current_event_);
+  std::fwrite(&event, sizeof(event), 1, file_.get());
+  std::fwrite(&current_time_, sizeof(current_time_), 1, file_.get());
+  /* Pack the lattice into the reusable buffer, so the frame goes out in a
+   * single write call. The lattice is stored with the x index changing
+   * fastest, which is the order the nodes are visited in here. */
+  size_t i = 0;
+  for (auto &node : lattice) {
+    buffer_[i] = static_cast<float>(node.density());
+    i++;
+  }
+  std::fwrite(buffer_.data(), sizeof(float), buffer_.size(), file_.get());
+}
+
+}  // namespace smash
@@ -11,6 +11,7 @@
 
 #include <fstream>
 #include <memory>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
@@ -110,7 +111,7 @@ ThermodynamicOutput::ThermodynamicOutput(const bf::path &path,
                                          const std::string &name,
                                          const OutputParameters &out_par)
     : OutputInterface(name),
-      file_{path / "thermodynamics.dat", "w"},
+      file_{out_par.shard_path(path, "thermodynamics.dat"), "w"},
       out_par_(out_par) {
   std::fprintf(file_.get(), "# %s thermodynamics output\n", VERSION_MAJOR);
   const ThreeVector r = out_par.td_position;
@@ -221,16 +222,22 @@ void ThermodynamicOutput::density_along_line(
     const char *file_name, const ParticleList &plist,
     const DensityParameters &param, DensityType dens_type,
     const ThreeVector &line_start, const ThreeVector &line_end, int n_points) {
-  ThreeVector r;
   std::ofstream a_file;
   a_file.open(file_name, std::ios::out);
-  const bool compute_gradient = false;
 
+  /* All points are evaluated in one pass over the particle list instead
+   * of scanning it once per point. */
+  std::vector<ThreeVector> points;
+  points.reserve(n_points + 1);
   for (int i = 0; i <= n_points; i++) {
-    r = line_start + (line_end - line_start) * (1.0 * i / n_points);
-    double rho_eck =
-        std::get<0>(rho_eckart(r, plist, param, dens_type, compute_gradient));
-    a_file << r.x1() << " " << r.x2() << " " << r.x3() << " " << rho_eck
+    points.push_back(line_start +
+                     (line_end - line_start) * (1.0 * i / n_points));
+  }
+  const std::vector<double> rho =
+      rho_eckart_batch(points, plist, param, dens_type);
+  for (int i = 0; i <= n_points; i++) {
+    const ThreeVector &r = points[i];
+    a_file << r.x1() << " " << r.x2() << " " << r.x3() << " " << rho[i]
            << "\n";
   }
 }
@@ -0,0 +1,169 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/threadpool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "smash/cxx14compat.h"
+
+namespace smash {
+
+ThreadPool::ThreadPool(int num_threads) {
+  if (num_threads < 1) {
+    throw std::invalid_argument(
+        "ThreadPool needs a positive number of threads.");
+  }
+  queues_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    queues_.emplace_back(new WorkQueue());
+  }
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  work_ready_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::parallel_range(size_t n,
+                                const std::function<void(size_t)> &task) {
+  if (n == 0) {
+    return;
+  }
+  const size_t num_queues = queues_.size();
+  pending_.store(n, std::memory_order_release);
+  /* Distribute contiguous blocks of indices over the queues. Contiguous
+   * blocks keep neighboring cells on the same thread, stealing takes care
+   * of any resulting imbalance. Each enqueued closure performs one index
+   * and counts down the region; the last one wakes the caller. */
+  const size_t block = (n + num_queues - 1) / num_queues;
+  for (size_t q = 0; q < num_queues; ++q) {
+    const size_t begin = q * block;
+    const size_t end = std::min(n, begin + block);
+    if (begin >= end) {
+      break;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      enqueue(q, [this, &task, i] {
+        task(i);
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          /* Last task of the region: wake the caller. The lock guarantees
+           * the caller is inside wait() and does not miss the
+           * notification. */
+          std::unique_lock<std::mutex> lock(mutex_);
+          work_done_.notify_all();
+        }
+      });
+    }
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_done_.wait(
+      lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+  /* std::function requires a copyable callable, so the packaged_task is held
+   * by a shared_ptr. */
+  auto packaged =
+      std::make_shared<std::packaged_task<void()>>(std::move(task));
+  std::future<void> result = packaged->get_future();
+  const size_t q =
+      next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+  enqueue(q, [packaged] { (*packaged)(); });
+  return result;
+}
+
+void ThreadPool::enqueue(size_t queue_index, std::function<void()> &&task) {
+  {
+    std::lock_guard<std::mutex> guard(queues_[queue_index]->mutex);
+    queues_[queue_index]->tasks.push_back(std::move(task));
+  }
+  queued_.fetch_add(1, std::memory_order_release);
+  work_ready_.notify_one();
+}
+
+bool ThreadPool::pop_own(int id, std::function<void()> &task) {
+  WorkQueue &queue = *queues_[id];
+  std::lock_guard<std::mutex> guard(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = std::move(queue.tasks.front());
+  queue.tasks.pop_front();
+  return true;
+}
+
+bool ThreadPool::steal(int id, std::function<void()> &task) {
+  const int num_queues = static_cast<int>(queues_.size());
+  for (int offset = 1; offset < num_queues; ++offset) {
+    WorkQueue &queue = *queues_[(id + offset) % num_queues];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::worker_loop(int id) {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_ready_.wait(lock, [this] {
+        return shutdown_ || queued_.load(std::memory_order_acquire) > 0;
+      });
+      if (shutdown_ && queued_.load(std::memory_order_acquire) == 0) {
+        return;
+      }
+    }
+    std::function<void()> task;
+    while (pop_own(id, task) || steal(id, task)) {
+      queued_.fetch_sub(1, std::memory_order_acq_rel);
+      task();
+    }
+  }
+}
+
+/// The shared pool created by initialize_shared_pool(), if any.
+static std::unique_ptr<ThreadPool> shared_pool_instance;
+
+void initialize_shared_pool(int num_threads) {
+  if (shared_pool_instance) {
+    throw std::logic_error("The shared thread pool was already created.");
+  }
+  if (num_threads > 1) {
+    shared_pool_instance = make_unique<ThreadPool>(num_threads);
+  }
+}
+
+ThreadPool *shared_pool() { return shared_pool_instance.get(); }
+
+void drop_shared_pool_after_fork() {
+  /* fork() clones only the calling thread, so in the child the pool's worker
+   * threads do not exist. Running the destructor would join them and block
+   * forever; the object is leaked instead and all users fall back to their
+   * serial code paths. */
+  shared_pool_instance.release();
+}
+
+}  // namespace smash
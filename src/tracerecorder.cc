@@ -0,0 +1,133 @@
+/*
+ *
+ *    Copyright (c) 2018
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/tracerecorder.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "smash/tsc.h"
+
+namespace smash {
+
+namespace {
+
+/// One recorded span.
+struct SpanRecord {
+  /// The name shown in the timeline.
+  const char *name;
+  /// Cycle count at the begin of the span.
+  uint64_t begin_cycles;
+  /// Cycle count at the end of the span.
+  uint64_t end_cycles;
+  /// Small integer identifying the recording thread.
+  int tid;
+};
+
+/// Whether spans are recorded.
+bool recording_enabled = false;
+
+/**
+ * Counter started at enable(); all span timestamps are cycle counts
+ * relative to its start.
+ */
+TimeStampCounter epoch;
+
+/// Steady-clock time of enable(), for the cycle-to-time calibration.
+std::chrono::steady_clock::time_point epoch_wall;
+
+/// Protects the record list and the thread id map.
+std::mutex mutex;
+
+/// All recorded spans.
+std::vector<SpanRecord> records;
+
+/// Small integer ids of the recording threads, in order of appearance.
+std::map<std::thread::id, int> thread_ids;
+
+/**
+ * \return cycles elapsed since enable().
+ *
+ * Copies the epoch counter and stops the copy, so the difference to the
+ * common start is read without any synchronization.
+ */
+uint64_t cycles_since_epoch() {
+  TimeStampCounter now = epoch;
+  now.stop();
+  return now.cycles();
+}
+
+}  // unnamed namespace
+
+void TraceRecorder::enable() {
+  recording_enabled = true;
+  records.reserve(1 << 16);
+  epoch_wall = std::chrono::steady_clock::now();
+  epoch.start();
+}
+
+bool TraceRecorder::is_enabled() { return recording_enabled; }
+
+void TraceRecorder::write(const bf::path &output_file) {
+  if (!recording_enabled) {
+    return;
+  }
+  /* Calibrate the cycle counter against the steady clock over the whole
+   * recording, so the reported times are microseconds. */
+  const double elapsed_us =
+      std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(
+          std::chrono::steady_clock::now() - epoch_wall)
+          .count();
+  const double cycles_per_us = cycles_since_epoch() / elapsed_us;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  bf::ofstream file{output_file};
+  file << "{\"traceEvents\":[";
+  bool first = true;
+  for (const SpanRecord &record : records) {
+    if (!first) {
+      file << ",";
+    }
+    first = false;
+    const double ts = record.begin_cycles / cycles_per_us;
+    const double dur = (record.end_cycles - record.begin_cycles) /
+                       cycles_per_us;
+    file << "\n{\"name\":\"" << record.name << "\",\"ph\":\"X\",\"ts\":" << ts
+         << ",\"dur\":" << dur << ",\"pid\":0,\"tid\":" << record.tid << "}";
+  }
+  file << "\n]}\n";
+  records.clear();
+  thread_ids.clear();
+}
+
+TraceRecorder::Span::Span(const char *name) : name_(name), begin_cycles_(0) {
+  if (!recording_enabled) {
+    return;
+  }
+  begin_cycles_ = cycles_since_epoch();
+}
+
+TraceRecorder::Span::~Span() {
+  if (!recording_enabled) {
+    return;
+  }
+  const uint64_t end_cycles = cycles_since_epoch();
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto id = thread_ids.emplace(std::this_thread::get_id(),
+                                     static_cast<int>(thread_ids.size()));
+  records.push_back({name_, begin_cycles_, end_cycles, id.first->second});
+}
+
+}  // namespace smash
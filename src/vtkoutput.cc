@@ -7,8 +7,14 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <limits>
 #include <memory>
+#include <vector>
 
 #include "smash/clock.h"
 #include "smash/config.h"
@@ -19,11 +25,50 @@
 
 namespace smash {
 
+namespace {
+
+/**
+ * Writes one value in the raw big-endian encoding that the binary variant
+ * of the legacy VTK format requires.
+ *
+ * \param[in] file The output file.
+ * \param[in] value The value to write.
+ */
+template <typename T>
+void write_big_endian(std::FILE *file, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  const uint16_t probe = 1;
+  if (*reinterpret_cast<const char *>(&probe) == 1) {
+    std::reverse(std::begin(bytes), std::end(bytes));
+  }
+  std::fwrite(bytes, sizeof(T), 1, file);
+}
+
+/// \copydoc write_big_endian(std::FILE*,T)
+template <typename T>
+void write_big_endian(std::ofstream &file, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  const uint16_t probe = 1;
+  if (*reinterpret_cast<const char *>(&probe) == 1) {
+    std::reverse(std::begin(bytes), std::end(bytes));
+  }
+  file.write(bytes, sizeof(T));
+}
+
+}  // unnamed namespace
+
 VtkOutput::VtkOutput(const bf::path &path, const std::string &name,
                      const OutputParameters &out_par)
     : OutputInterface(name),
       base_path_(std::move(path)),
-      is_thermodynamics_output_(name == "Thermodynamics") {
+      is_thermodynamics_output_(name == "Thermodynamics"),
+      vtk_binary_(is_thermodynamics_output_ ? out_par.td_vtk_binary
+                                            : out_par.part_vtk_binary),
+      td_region_min_(out_par.td_region_min),
+      td_region_max_(out_par.td_region_max),
+      td_stride_(out_par.td_stride) {
   const auto &log = logger<LogArea::Output>();
   if (out_par.part_extended) {
     log.warn() << "Creating VTK output: There is no extended VTK format.";
@@ -94,52 +139,101 @@ void VtkOutput::write(const Particles &particles) {
   std::fprintf(file_.get(), "# vtk DataFile Version 2.0\n");
   std::fprintf(file_.get(), "Generated from molecular-offset data %s\n",
                VERSION_MAJOR);
-  std::fprintf(file_.get(), "ASCII\n");
+  std::fprintf(file_.get(), vtk_binary_ ? "BINARY\n" : "ASCII\n");
 
   /* Unstructured data sets are composed of points, lines, polygons, .. */
   std::fprintf(file_.get(), "DATASET UNSTRUCTURED_GRID\n");
   std::fprintf(file_.get(), "POINTS %zu double\n", particles.size());
   for (const auto &p : particles) {
-    std::fprintf(file_.get(), "%g %g %g\n", p.position().x1(),
-                 p.position().x2(), p.position().x3());
+    if (vtk_binary_) {
+      write_big_endian(file_.get(), p.position().x1());
+      write_big_endian(file_.get(), p.position().x2());
+      write_big_endian(file_.get(), p.position().x3());
+    } else {
+      std::fprintf(file_.get(), "%g %g %g\n", p.position().x1(),
+                   p.position().x2(), p.position().x3());
+    }
   }
-  std::fprintf(file_.get(), "CELLS %zu %zu\n", particles.size(),
-               particles.size() * 2);
+  std::fprintf(file_.get(), "%sCELLS %zu %zu\n", vtk_binary_ ? "\n" : "",
+               particles.size(), particles.size() * 2);
   for (size_t point_index = 0; point_index < particles.size(); point_index++) {
-    std::fprintf(file_.get(), "1 %zu\n", point_index);
+    if (vtk_binary_) {
+      write_big_endian(file_.get(), std::int32_t(1));
+      write_big_endian(file_.get(), static_cast<std::int32_t>(point_index));
+    } else {
+      std::fprintf(file_.get(), "1 %zu\n", point_index);
+    }
   }
-  std::fprintf(file_.get(), "CELL_TYPES %zu\n", particles.size());
+  std::fprintf(file_.get(), "%sCELL_TYPES %zu\n", vtk_binary_ ? "\n" : "",
+               particles.size());
   for (size_t point_index = 0; point_index < particles.size(); point_index++) {
-    std::fprintf(file_.get(), "1\n");
+    if (vtk_binary_) {
+      write_big_endian(file_.get(), std::int32_t(1));
+    } else {
+      std::fprintf(file_.get(), "1\n");
+    }
   }
-  std::fprintf(file_.get(), "POINT_DATA %zu\n", particles.size());
+  std::fprintf(file_.get(), "%sPOINT_DATA %zu\n", vtk_binary_ ? "\n" : "",
+               particles.size());
   std::fprintf(file_.get(), "SCALARS pdg_codes int 1\n");
   std::fprintf(file_.get(), "LOOKUP_TABLE default\n");
   for (const auto &p : particles) {
-    std::fprintf(file_.get(), "%s\n", p.pdgcode().string().c_str());
+    if (vtk_binary_) {
+      write_big_endian(file_.get(),
+                       static_cast<std::int32_t>(p.pdgcode().get_decimal()));
+    } else {
+      std::fprintf(file_.get(), "%s\n", p.pdgcode().string().c_str());
+    }
   }
-  std::fprintf(file_.get(), "SCALARS is_formed int 1\n");
+  std::fprintf(file_.get(), "%sSCALARS is_formed int 1\n",
+               vtk_binary_ ? "\n" : "");
   std::fprintf(file_.get(), "LOOKUP_TABLE default\n");
   double current_time = particles.time();
   for (const auto &p : particles) {
-    std::fprintf(file_.get(), "%s\n",
-                 (p.formation_time() > current_time) ? "0" : "1");
+    if (vtk_binary_) {
+      write_big_endian(
+          file_.get(),
+          std::int32_t((p.formation_time() > current_time) ? 0 : 1));
+    } else {
+      std::fprintf(file_.get(), "%s\n",
+                   (p.formation_time() > current_time) ? "0" : "1");
+    }
   }
-  std::fprintf(file_.get(), "SCALARS cross_section_scaling_factor double 1\n");
+  std::fprintf(file_.get(), "%sSCALARS cross_section_scaling_factor double 1\n",
+               vtk_binary_ ? "\n" : "");
   std::fprintf(file_.get(), "LOOKUP_TABLE default\n");
   for (const auto &p : particles) {
-    std::fprintf(file_.get(), "%g\n", p.xsec_scaling_factor());
+    if (vtk_binary_) {
+      write_big_endian(file_.get(), p.xsec_scaling_factor());
+    } else {
+      std::fprintf(file_.get(), "%g\n", p.xsec_scaling_factor());
+    }
   }
-  std::fprintf(file_.get(), "SCALARS mass double 1\n");
+  std::fprintf(file_.get(), "%sSCALARS mass double 1\n",
+               vtk_binary_ ? "\n" : "");
   std::fprintf(file_.get(), "LOOKUP_TABLE default\n");
   for (const auto &p : particles) {
-    std::fprintf(file_.get(), "%g\n", p.effective_mass());
+    if (vtk_binary_) {
+      write_big_endian(file_.get(), p.effective_mass());
+    } else {
+      std::fprintf(file_.get(), "%g\n", p.effective_mass());
+    }
   }
 
-  std::fprintf(file_.get(), "VECTORS momentum double\n");
+  std::fprintf(file_.get(), "%sVECTORS momentum double\n",
+               vtk_binary_ ? "\n" : "");
   for (const auto &p : particles) {
-    std::fprintf(file_.get(), "%g %g %g\n", p.momentum().x1(),
-                 p.momentum().x2(), p.momentum().x3());
+    if (vtk_binary_) {
+      write_big_endian(file_.get(), p.momentum().x1());
+      write_big_endian(file_.get(), p.momentum().x2());
+      write_big_endian(file_.get(), p.momentum().x3());
+    } else {
+      std::fprintf(file_.get(), "%g %g %g\n", p.momentum().x1(),
+                   p.momentum().x2(), p.momentum().x3());
+    }
+  }
+  if (vtk_binary_) {
+    std::fprintf(file_.get(), "\n");
   }
 }
 
@@ -150,55 +244,183 @@ void VtkOutput::write(const Particles &particles) {
  * The name format is
  * \<density_name\>_\<event_number\>_tstep\<number_of_output_moment\>.vtk,
  * Files can be opened directly with ParaView (http://paraview.org).
+ *
+ * The written grid can be restricted to a region of interest and
+ * downsampled by a stride (averaging blocks of nodes), see the
+ * \key Region_Min, \key Region_Max and \key Stride keys of the
+ * \ref output_content_specific_options_ "content-specific output options".
  */
 
+template <typename T>
+VtkOutput::LatticeWindow VtkOutput::make_window(
+    RectangularLattice<T> &lattice) const {
+  const auto dim = lattice.dimensions();
+  const auto cs = lattice.cell_sizes();
+  const auto orig = lattice.origin();
+  LatticeWindow win;
+  for (int i = 0; i < 3; i++) {
+    /* Node index j sits at orig + j * cs, consistent with the origin and
+     * spacing written to the VTK header. */
+    int lo = 0;
+    int hi = dim[i];
+    if (td_region_min_[i] > -std::numeric_limits<double>::infinity()) {
+      lo = std::max(
+          0, static_cast<int>(std::ceil((td_region_min_[i] - orig[i]) /
+                                        cs[i])));
+    }
+    if (td_region_max_[i] < std::numeric_limits<double>::infinity()) {
+      hi = std::min(dim[i],
+                    static_cast<int>(std::floor((td_region_max_[i] - orig[i]) /
+                                                cs[i])) +
+                        1);
+    }
+    if (hi < lo) {
+      hi = lo;
+    }
+    win.begin[i] = lo;
+    win.end[i] = hi;
+    win.dim_out[i] = (hi - lo + td_stride_ - 1) / td_stride_;
+  }
+  return win;
+}
+
 template <typename T>
 void VtkOutput::write_vtk_header(std::ofstream &file,
                                  RectangularLattice<T> &lattice,
+                                 const LatticeWindow &win,
                                  const std::string &description) {
-  const auto dim = lattice.dimensions();
   const auto cs = lattice.cell_sizes();
   const auto orig = lattice.origin();
+  /* A written node averages a block of stride^3 lattice nodes, so it is
+   * placed at the mean position of its block. */
+  const double off = 0.5 * (td_stride_ - 1);
   file << "# vtk DataFile Version 2.0\n"
        << description << "\n"
-       << "ASCII\n"
+       << (vtk_binary_ ? "BINARY\n" : "ASCII\n")
        << "DATASET STRUCTURED_POINTS\n"
-       << "DIMENSIONS " << dim[0] << " " << dim[1] << " " << dim[2] << "\n"
-       << "SPACING " << cs[0] << " " << cs[1] << " " << cs[2] << "\n"
-       << "ORIGIN " << orig[0] << " " << orig[1] << " " << orig[2] << "\n"
-       << "POINT_DATA " << lattice.size() << "\n";
+       << "DIMENSIONS " << win.dim_out[0] << " " << win.dim_out[1] << " "
+       << win.dim_out[2] << "\n"
+       << "SPACING " << cs[0] * td_stride_ << " " << cs[1] * td_stride_ << " "
+       << cs[2] * td_stride_ << "\n"
+       << "ORIGIN " << orig[0] + (win.begin[0] + off) * cs[0] << " "
+       << orig[1] + (win.begin[1] + off) * cs[1] << " "
+       << orig[2] + (win.begin[2] + off) * cs[2] << "\n"
+       << "POINT_DATA "
+       << win.dim_out[0] * win.dim_out[1] * win.dim_out[2] << "\n";
 }
 
 template <typename T, typename F>
 void VtkOutput::write_vtk_scalar(std::ofstream &file,
                                  RectangularLattice<T> &lattice,
+                                 const LatticeWindow &win,
                                  const std::string &varname, F &&get_quantity) {
   file << "SCALARS " << varname << " double 1\n"
        << "LOOKUP_TABLE default\n";
-  file << std::setprecision(3);
-  file << std::fixed;
-  const auto dim = lattice.dimensions();
-  lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int ix, int, int) {
-    const double f_from_node = get_quantity(node);
-    file << f_from_node << " ";
-    if (ix == dim[0] - 1) {
+  if (!vtk_binary_) {
+    file << std::setprecision(3);
+    file << std::fixed;
+  }
+  if (td_stride_ == 1) {
+    lattice.iterate_sublattice(win.begin, win.end,
+                               [&](T &node, int ix, int, int) {
+                                 const double f_from_node = get_quantity(node);
+                                 if (vtk_binary_) {
+                                   write_big_endian(file, f_from_node);
+                                 } else {
+                                   file << f_from_node << " ";
+                                   if (ix == win.end[0] - 1) {
+                                     file << "\n";
+                                   }
+                                 }
+                               });
+    if (vtk_binary_) {
       file << "\n";
     }
-  });
+    return;
+  }
+  /* Average every block of stride^3 nodes in a single pass over the
+   * lattice storage; blocks at the upper window edges may hold fewer
+   * nodes, hence the per-block counts. */
+  const std::size_t out_size = static_cast<std::size_t>(win.dim_out[0]) *
+                               win.dim_out[1] * win.dim_out[2];
+  std::vector<double> sum(out_size, 0.);
+  std::vector<int> count(out_size, 0);
+  lattice.iterate_sublattice(win.begin, win.end,
+                             [&](T &node, int ix, int iy, int iz) {
+                               const std::size_t i =
+                                   block_index(win, ix, iy, iz);
+                               sum[i] += get_quantity(node);
+                               count[i]++;
+                             });
+  for (std::size_t i = 0; i < out_size; i++) {
+    const double average = sum[i] / count[i];
+    if (vtk_binary_) {
+      write_big_endian(file, average);
+    } else {
+      file << average << " ";
+      if ((i + 1) % win.dim_out[0] == 0) {
+        file << "\n";
+      }
+    }
+  }
+  if (vtk_binary_) {
+    file << "\n";
+  }
 }
 
 template <typename T, typename F>
 void VtkOutput::write_vtk_vector(std::ofstream &file,
                                  RectangularLattice<T> &lattice,
+                                 const LatticeWindow &win,
                                  const std::string &varname, F &&get_quantity) {
   file << "VECTORS " << varname << " double\n";
-  file << std::setprecision(3);
-  file << std::fixed;
-  const auto dim = lattice.dimensions();
-  lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int, int, int) {
-    const ThreeVector v = get_quantity(node);
-    file << v.x1() << " " << v.x2() << " " << v.x3() << "\n";
-  });
+  if (!vtk_binary_) {
+    file << std::setprecision(3);
+    file << std::fixed;
+  }
+  if (td_stride_ == 1) {
+    lattice.iterate_sublattice(win.begin, win.end,
+                               [&](T &node, int, int, int) {
+                                 const ThreeVector v = get_quantity(node);
+                                 if (vtk_binary_) {
+                                   write_big_endian(file, v.x1());
+                                   write_big_endian(file, v.x2());
+                                   write_big_endian(file, v.x3());
+                                 } else {
+                                   file << v.x1() << " " << v.x2() << " "
+                                        << v.x3() << "\n";
+                                 }
+                               });
+    if (vtk_binary_) {
+      file << "\n";
+    }
+    return;
+  }
+  const std::size_t out_size = static_cast<std::size_t>(win.dim_out[0]) *
+                               win.dim_out[1] * win.dim_out[2];
+  std::vector<ThreeVector> sum(out_size, ThreeVector());
+  std::vector<int> count(out_size, 0);
+  lattice.iterate_sublattice(win.begin, win.end,
+                             [&](T &node, int ix, int iy, int iz) {
+                               const std::size_t i =
+                                   block_index(win, ix, iy, iz);
+                               sum[i] += get_quantity(node);
+                               count[i]++;
+                             });
+  for (std::size_t i = 0; i < out_size; i++) {
+    const ThreeVector average = sum[i] / count[i];
+    if (vtk_binary_) {
+      write_big_endian(file, average.x1());
+      write_big_endian(file, average.x2());
+      write_big_endian(file, average.x3());
+    } else {
+      file << average.x1() << " " << average.x2() << " " << average.x3()
+           << "\n";
+    }
+  }
+  if (vtk_binary_) {
+    file << "\n";
+  }
 }
 
 std::string VtkOutput::make_filename(const std::string &descr, int counter) {
@@ -223,8 +445,9 @@ void VtkOutput::thermodynamics_output(
   std::ofstream file;
   const std::string varname = make_varname(tq, dens_type);
   file.open(make_filename(varname, vtk_density_output_counter_), std::ios::out);
-  write_vtk_header(file, lattice, varname);
-  write_vtk_scalar(file, lattice, varname,
+  const LatticeWindow win = make_window(lattice);
+  write_vtk_header(file, lattice, win, varname);
+  write_vtk_scalar(file, lattice, win, varname,
                    [&](DensityOnLattice &node) { return node.density(); });
   vtk_density_output_counter_++;
 }
@@ -253,13 +476,14 @@ void VtkOutput::thermodynamics_output(
   }
   std::ofstream file;
   const std::string varname = make_varname(tq, dens_type);
+  const LatticeWindow win = make_window(Tmn_lattice);
 
   if (tq == ThermodynamicQuantity::Tmn) {
     file.open(make_filename(varname, vtk_tmn_output_counter_++), std::ios::out);
-    write_vtk_header(file, Tmn_lattice, varname);
+    write_vtk_header(file, Tmn_lattice, win, varname);
     for (int i = 0; i < 4; i++) {
       for (int j = i; j < 4; j++) {
-        write_vtk_scalar(file, Tmn_lattice,
+        write_vtk_scalar(file, Tmn_lattice, win,
                          varname + std::to_string(i) + std::to_string(j),
                          [&](EnergyMomentumTensor &node) {
                            return node[EnergyMomentumTensor::tmn_index(i, j)];
@@ -269,10 +493,10 @@ void VtkOutput::thermodynamics_output(
   } else if (tq == ThermodynamicQuantity::TmnLandau) {
     file.open(make_filename(varname, vtk_tmn_landau_output_counter_++),
               std::ios::out);
-    write_vtk_header(file, Tmn_lattice, varname);
+    write_vtk_header(file, Tmn_lattice, win, varname);
     for (int i = 0; i < 4; i++) {
       for (int j = i; j < 4; j++) {
-        write_vtk_scalar(file, Tmn_lattice,
+        write_vtk_scalar(file, Tmn_lattice, win,
                          varname + std::to_string(i) + std::to_string(j),
                          [&](EnergyMomentumTensor &node) {
                            const FourVector u = node.landau_frame_4velocity();
@@ -284,8 +508,8 @@ void VtkOutput::thermodynamics_output(
   } else {
     file.open(make_filename(varname, vtk_v_landau_output_counter_++),
               std::ios::out);
-    write_vtk_header(file, Tmn_lattice, varname);
-    write_vtk_vector(file, Tmn_lattice, varname,
+    write_vtk_header(file, Tmn_lattice, win, varname);
+    write_vtk_vector(file, Tmn_lattice, win, varname,
                      [&](EnergyMomentumTensor &node) {
                        const FourVector u = node.landau_frame_4velocity();
                        return -u.threevec();
@@ -300,18 +524,19 @@ void VtkOutput::thermodynamics_output(const GrandCanThermalizer &gct) {
   std::ofstream file;
   file.open(make_filename("fluidization_td", vtk_fluidization_counter_++),
             std::ios::out);
-  write_vtk_header(file, gct.lattice(), "fluidization_td");
-  write_vtk_scalar(file, gct.lattice(), "e",
+  const LatticeWindow win = make_window(gct.lattice());
+  write_vtk_header(file, gct.lattice(), win, "fluidization_td");
+  write_vtk_scalar(file, gct.lattice(), win, "e",
                    [&](ThermLatticeNode &node) { return node.e(); });
-  write_vtk_scalar(file, gct.lattice(), "p",
+  write_vtk_scalar(file, gct.lattice(), win, "p",
                    [&](ThermLatticeNode &node) { return node.p(); });
-  write_vtk_vector(file, gct.lattice(), "v",
+  write_vtk_vector(file, gct.lattice(), win, "v",
                    [&](ThermLatticeNode &node) { return node.v(); });
-  write_vtk_scalar(file, gct.lattice(), "T",
+  write_vtk_scalar(file, gct.lattice(), win, "T",
                    [&](ThermLatticeNode &node) { return node.T(); });
-  write_vtk_scalar(file, gct.lattice(), "mub",
+  write_vtk_scalar(file, gct.lattice(), win, "mub",
                    [&](ThermLatticeNode &node) { return node.mub(); });
-  write_vtk_scalar(file, gct.lattice(), "mus",
+  write_vtk_scalar(file, gct.lattice(), win, "mus",
                    [&](ThermLatticeNode &node) { return node.mus(); });
 }
 
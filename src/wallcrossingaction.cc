@@ -9,43 +9,96 @@
 
 #include "smash/wallcrossingaction.h"
 
+#include <limits>
+
 namespace smash {
 
+bool WallCrossActionsFinder::next_crossing_(const ParticleData& p,
+                                            double* time_until,
+                                            ParticleData* out) const {
+  const ThreeVector& r = p.position().threevec();
+  const ThreeVector& v = p.velocity();
+  double earliest = std::numeric_limits<double>::infinity();
+  int i_cross = -1;
+  for (int i = 0; i < 3; i++) {
+    double t = earliest;
+    if (v[i] > really_small) {
+      t = (l_[i] - r[i]) / v[i];
+    } else if (v[i] < -really_small) {
+      t = -r[i] / v[i];
+    }
+    if (t < earliest) {
+      earliest = t;
+      i_cross = i;
+    }
+  }
+  // No crossing
+  if (i_cross == -1) {
+    return false;
+  }
+  FourVector crossing_point(p.position().x0() + earliest, r + v * earliest);
+  crossing_point[i_cross + 1] = ((v[i_cross] > 0.0) ? 0.0 : l_[i_cross]);
+
+  *out = p;
+  out->set_4position(crossing_point);
+  *time_until = earliest;
+  return true;
+}
+
 ActionList WallCrossActionsFinder::find_actions_in_cell(
-    const ParticleList& plist, double t_max) const {
-  std::vector<ActionPtr> actions;
+    const ParticleSlice& plist, double t_max) const {
+  ActionList actions;
   for (const ParticleData& p : plist) {
-    const ThreeVector& r = p.position().threevec();
-    const ThreeVector& v = p.velocity();
-    double time_until_crossing = t_max;
-    int i_cross = -1;
-    for (int i = 0; i < 3; i++) {
-      double t = t_max + 1.;
-      if (v[i] > really_small) {
-        t = (l_[i] - r[i]) / v[i];
-      } else if (v[i] < -really_small) {
-        t = -r[i] / v[i];
-      }
-      if (t < time_until_crossing) {
-        time_until_crossing = t;
-        i_cross = i;
-      }
-    }
-    // No crossing
-    if (i_cross == -1) {
+    double time_until_crossing;
+    ParticleData outgoing_particle(p);
+    if (!next_crossing_(p, &time_until_crossing, &outgoing_particle)) {
       continue;
     }
-    FourVector crossing_point(p.position().x0() + time_until_crossing,
-                              r + v * time_until_crossing);
-    crossing_point[i_cross + 1] = ((v[i_cross] > 0.0) ? 0.0 : l_[i_cross]);
+    if (time_until_crossing < t_max) {
+      actions.emplace_back(make_unique<WallcrossingAction>(
+          p, outgoing_particle, time_until_crossing));
+    } else if (analytic_schedule_) {
+      /* The crossing is not due yet; keep it for the following timesteps
+       * instead of recomputing it every step. */
+      schedule_.push({p.position().x0() + time_until_crossing, p,
+                      std::move(outgoing_particle)});
+    }
+  }
+  return actions;
+}
 
-    ParticleData outgoing_particle(p);
-    outgoing_particle.set_4position(crossing_point);
-    ActionPtr action = make_unique<WallcrossingAction>(p, outgoing_particle,
-                                                       time_until_crossing);
-    actions.emplace_back(std::move(action));
+ActionList WallCrossActionsFinder::find_scheduled_crossings(
+    const Particles& particles, const double now, const double t_max) {
+  if (!schedule_initialized_) {
+    for (const ParticleData& p : particles) {
+      double time_until_crossing;
+      ParticleData outgoing_particle(p);
+      if (next_crossing_(p, &time_until_crossing, &outgoing_particle)) {
+        schedule_.push({p.position().x0() + time_until_crossing, p,
+                        std::move(outgoing_particle)});
+      }
+    }
+    schedule_initialized_ = true;
+  }
+  ActionList actions;
+  while (!schedule_.empty() && schedule_.top().time < now + t_max) {
+    const ScheduledCrossing& crossing = schedule_.top();
+    /* Stale crossings are dropped silently: the momentum change that
+     * invalidated them also scheduled their replacement. */
+    if (particles.is_valid(crossing.incoming)) {
+      const double time_until_crossing =
+          crossing.time - crossing.incoming.position().x0();
+      actions.emplace_back(make_unique<WallcrossingAction>(
+          crossing.incoming, crossing.outgoing, time_until_crossing));
+    }
+    schedule_.pop();
   }
   return actions;
 }
 
+void WallCrossActionsFinder::reset_scheduling() {
+  schedule_ = decltype(schedule_){};
+  schedule_initialized_ = false;
+}
+
 }  // namespace smash